@@ -5,8 +5,10 @@
  ******************************************************************************/
 
 #include "status_led.h"
+#include "../MCAL/soft_timer.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
 
 /* TivaWare Includes */
 #include "inc/hw_memmap.h"
@@ -17,6 +19,36 @@
 #define LED_GREEN   GPIO_PIN_3
 #define LED_ALL     (LED_RED | LED_GREEN)
 
+/*===========================================================================
+ * Pattern Player
+ *
+ * Blink requests are queued and stepped by a periodic soft timer every
+ * LED_STEP_MS, one on or off phase per step, so callers never wait for
+ * the LED. Producer and consumer both run in main loop context.
+ *===========================================================================*/
+#define LED_STEP_MS         50
+#define LED_QUEUE_DEPTH     4       /* Power of two */
+#define LED_QUEUE_MASK      (LED_QUEUE_DEPTH - 1)
+
+typedef struct {
+    uint8_t pin;
+    uint8_t blinks;
+} led_pattern_t;
+
+static led_pattern_t led_queue[LED_QUEUE_DEPTH];
+static uint8_t led_head = 0;
+static uint8_t led_tail = 0;
+static SoftTimer_t led_timer;
+
+/* Pattern currently playing */
+static uint8_t cur_pin = 0;
+static uint8_t cur_step = 0;
+static uint8_t cur_steps = 0;
+
+static void LED_PatternStep(void);
+static void LED_OnStep(void *arg);
+static void LED_PlayPattern(uint8_t pin, uint8_t times);
+
 void LED_Init(void)
 {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
@@ -25,6 +57,12 @@ void LED_Init(void)
     /* Configure PF1 (Red) and PF3 (Green) as outputs */
     GPIOPinTypeGPIOOutput(GPIO_PORTF_BASE, LED_ALL);
     GPIOPinWrite(GPIO_PORTF_BASE, LED_ALL, 0);
+    
+    /* Pattern player is paced by a soft timer (SoftTimer_Init first) */
+    SoftTimer_Cancel(&led_timer);
+    led_head = 0;
+    led_tail = 0;
+    cur_steps = 0;
 }
 
 void LED_Off(void)
@@ -44,28 +82,81 @@ void LED_RedOn(void)
 
 void LED_BlinkGreen(uint8_t times)
 {
-    for (uint8_t i = 0; i < times; i++)
+    LED_PlayPattern(LED_GREEN, times);
+}
+
+void LED_BlinkRed(uint8_t times)
+{
+    LED_PlayPattern(LED_RED, times);
+}
+
+bool LED_IsPatternActive(void)
+{
+    return SoftTimer_IsActive(&led_timer);
+}
+
+/*===========================================================================
+ * Private Functions
+ *===========================================================================*/
+
+/*
+ * Queue a blink pattern and start the player if it is idle.
+ * Requests are dropped if the queue is full - the LEDs are best effort.
+ */
+static void LED_PlayPattern(uint8_t pin, uint8_t times)
+{
+    uint8_t next = (uint8_t)((led_head + 1) & LED_QUEUE_MASK);
+    
+    if (times == 0 || next == led_tail)
     {
-        LED_GreenOn();
-        SysCtlDelay(SysCtlClockGet() / 20);  /* 50ms on */
-        LED_Off();
-        if (i < times - 1)
-        {
-            SysCtlDelay(SysCtlClockGet() / 20);  /* 50ms off */
-        }
+        return;
+    }
+    
+    led_queue[led_head].pin = pin;
+    led_queue[led_head].blinks = times;
+    led_head = next;
+    
+    /* Player stops itself only after finding the queue empty, so if it is
+     * still running here it is guaranteed to pick this pattern up. */
+    if (!SoftTimer_IsActive(&led_timer))
+    {
+        SoftTimer_StartPeriodic(&led_timer, LED_STEP_MS, LED_OnStep, NULL);
+        LED_PatternStep();
     }
 }
 
-void LED_BlinkRed(uint8_t times)
+/*
+ * Advance one on/off phase, loading the next queued pattern when the
+ * current one is finished. Each blink is an on phase followed by an off
+ * phase, so consecutive patterns stay visually separate.
+ */
+static void LED_PatternStep(void)
 {
-    for (uint8_t i = 0; i < times; i++)
+    if (cur_step >= cur_steps)
     {
-        LED_RedOn();
-        SysCtlDelay(SysCtlClockGet() / 20);  /* 50ms on */
-        LED_Off();
-        if (i < times - 1)
+        if (led_tail == led_head)
         {
-            SysCtlDelay(SysCtlClockGet() / 20);  /* 50ms off */
+            GPIOPinWrite(GPIO_PORTF_BASE, LED_ALL, 0);
+            cur_steps = 0;
+            SoftTimer_Cancel(&led_timer);
+            return;
         }
+        
+        cur_pin = led_queue[led_tail].pin;
+        cur_steps = (uint8_t)(led_queue[led_tail].blinks * 2);
+        cur_step = 0;
+        led_tail = (uint8_t)((led_tail + 1) & LED_QUEUE_MASK);
     }
+    
+    GPIOPinWrite(GPIO_PORTF_BASE, LED_ALL, ((cur_step & 1) == 0) ? cur_pin : 0);
+    cur_step++;
+}
+
+/*
+ * Soft timer callback - steps the pattern player every LED_STEP_MS.
+ */
+static void LED_OnStep(void *arg)
+{
+    (void)arg;
+    LED_PatternStep();
 }
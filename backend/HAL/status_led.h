@@ -8,6 +8,7 @@
 #define STATUS_LED_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /**
  * @brief Initialize status LEDs (PF1=Red, PF3=Green)
@@ -30,15 +31,21 @@ void LED_GreenOn(void);
 void LED_RedOn(void);
 
 /**
- * @brief Blink green LED
+ * @brief Blink green LED (non-blocking, queued behind earlier patterns)
  * @param times Number of blinks
  */
 void LED_BlinkGreen(uint8_t times);
 
 /**
- * @brief Blink red LED
+ * @brief Blink red LED (non-blocking, queued behind earlier patterns)
  * @param times Number of blinks
  */
 void LED_BlinkRed(uint8_t times);
 
+/**
+ * @brief Check if a blink pattern is playing or queued
+ * @return true while the pattern player owns the LEDs
+ */
+bool LED_IsPatternActive(void);
+
 #endif /* STATUS_LED_H */
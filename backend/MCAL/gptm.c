@@ -15,20 +15,20 @@
 #include <stdbool.h>
 
 /******************************************************************************
- *          Timer0 Implementation (Full 32-bit - Buzzer)                     *
+ *          Timer0 Implementation (Full 32-bit periodic - Soft Timer tick)   *
  * Note: Uses both A and B in concatenated mode, but only A generates IRQ    *
  ******************************************************************************/
 
-// Timer0 (buzzer) - uses both A and B subtimers concatenated
+// Timer0 (soft timer wheel tick) - uses both A and B subtimers concatenated
 static volatile bool timer0_running = false;
 
-void Timer0_Init_OneShot(void)
+void Timer0_Init_Periodic(void)
 {
     SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
     while(!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER0)) {}
     
-    /* Configure as full-width (32-bit concatenated) one-shot timer */
-    TimerConfigure(TIMER0_BASE, TIMER_CFG_ONE_SHOT);
+    /* Configure as full-width (32-bit concatenated) periodic timer */
+    TimerConfigure(TIMER0_BASE, TIMER_CFG_PERIODIC);
     
     /* Enable interrupt for Timer A only (in full-width mode, only A generates IRQ) */
     TimerIntEnable(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
@@ -37,7 +37,7 @@ void Timer0_Init_OneShot(void)
     timer0_running = false;
 }
 
-void Timer0_Start_OneShot(uint32_t ticks)
+void Timer0_Start_Periodic(uint32_t ticks)
 {
     TimerDisable(TIMER0_BASE, TIMER_BOTH);
     TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT | TIMER_TIMB_TIMEOUT);
@@ -57,47 +57,3 @@ bool Timer0_IsRunning(void)
 {
     return timer0_running;
 }
-
-/******************************************************************************
- *          Timer1 Implementation (Full 32-bit - Motor/Door)                 *
- * Note: Uses both A and B in concatenated mode, but only A generates IRQ    *
- ******************************************************************************/
-
-// Timer1 (motor/door) - uses both A and B subtimers concatenated
-static volatile bool timer1_running = false;
-
-void Timer1_Init_OneShot(void)
-{
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
-    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_TIMER1)) {}
-    
-    /* Configure as full-width (32-bit concatenated) one-shot timer */
-    TimerConfigure(TIMER1_BASE, TIMER_CFG_ONE_SHOT);
-    
-    /* Enable interrupt for Timer A only (in full-width mode, only A generates IRQ) */
-    TimerIntEnable(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
-    IntEnable(INT_TIMER1A);
-    
-    timer1_running = false;
-}
-
-void Timer1_Start_OneShot(uint32_t ticks)
-{
-    TimerDisable(TIMER1_BASE, TIMER_BOTH);
-    TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT | TIMER_TIMB_TIMEOUT);
-    TimerLoadSet(TIMER1_BASE, TIMER_A, ticks - 1);
-    TimerEnable(TIMER1_BASE, TIMER_BOTH);
-    timer1_running = true;
-}
-
-void Timer1_Stop(void)
-{
-    TimerDisable(TIMER1_BASE, TIMER_BOTH);
-    TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT | TIMER_TIMB_TIMEOUT);
-    timer1_running = false;
-}
-
-bool Timer1_IsRunning(void)
-{
-    return timer1_running;
-}
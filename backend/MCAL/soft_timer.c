@@ -0,0 +1,206 @@
+/******************************************************************************
+ * File: soft_timer.c
+ * Module: Software Timer Service (MCAL Layer)
+ * Description: Hashed timer wheel multiplexing all backend timeouts onto
+ *              a single periodic GPTM (Timer0)
+ ******************************************************************************/
+
+#include "soft_timer.h"
+#include "gptm.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "inc/hw_memmap.h"
+#include <stddef.h>
+
+/******************************************************************************
+ *                           Private Definitions                               *
+ ******************************************************************************/
+
+#define WHEEL_MASK      (SOFT_TIMER_WHEEL_SIZE - 1)
+
+#if (SOFT_TIMER_WHEEL_SIZE & WHEEL_MASK) != 0
+#error "SOFT_TIMER_WHEEL_SIZE must be a power of two"
+#endif
+
+/******************************************************************************
+ *                           Private Variables                                 *
+ ******************************************************************************/
+
+/* Each slot heads an unsorted doubly-linked list of timers */
+static SoftTimer_t *wheel[SOFT_TIMER_WHEEL_SIZE];
+
+/* Timers that expired on the tick being processed, awaiting dispatch */
+static SoftTimer_t *expired = NULL;
+
+/* Written only by Timer0A_Handler */
+static volatile uint32_t tick_count = 0;
+
+/* Last tick whose slot has been processed (main loop only) */
+static uint32_t processed_tick = 0;
+
+/******************************************************************************
+ *                      Private Function Prototypes                            *
+ ******************************************************************************/
+
+static void SoftTimer_Link(SoftTimer_t **head, SoftTimer_t *timer);
+static void SoftTimer_Unlink(SoftTimer_t *timer);
+static uint32_t SoftTimer_MsToTicks(uint32_t ms);
+
+/******************************************************************************
+ *                          Function Definitions                               *
+ ******************************************************************************/
+
+/*
+ * SoftTimer_Init
+ * Clears the wheel and starts Timer0 ticking every SOFT_TIMER_TICK_MS.
+ */
+void SoftTimer_Init(void)
+{
+    for (uint32_t i = 0; i < SOFT_TIMER_WHEEL_SIZE; i++)
+    {
+        wheel[i] = NULL;
+    }
+    expired = NULL;
+    tick_count = 0;
+    processed_tick = 0;
+    
+    Timer0_Init_Periodic();
+    Timer0_Start_Periodic((SysCtlClockGet() / 1000) * SOFT_TIMER_TICK_MS);
+    
+    /* NOTE: Timer0A_Handler must be registered in the EWARM */
+    /* interrupt vector table (startup_ewarm.c) */
+}
+
+void SoftTimer_Start(SoftTimer_t *timer, uint32_t ms,
+                     SoftTimer_Callback_t callback, void *arg)
+{
+    SoftTimer_Unlink(timer);
+    
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->period = 0;
+    
+    /* Relative to the ISR tick so a lagging main loop does not shorten it;
+     * always > processed_tick, so the slot is visited before it is due. */
+    timer->expiry = tick_count + SoftTimer_MsToTicks(ms);
+    SoftTimer_Link(&wheel[timer->expiry & WHEEL_MASK], timer);
+}
+
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t period_ms,
+                             SoftTimer_Callback_t callback, void *arg)
+{
+    SoftTimer_Start(timer, period_ms, callback, arg);
+    timer->period = SoftTimer_MsToTicks(period_ms);
+}
+
+void SoftTimer_Cancel(SoftTimer_t *timer)
+{
+    SoftTimer_Unlink(timer);
+}
+
+bool SoftTimer_IsActive(const SoftTimer_t *timer)
+{
+    return timer->pprev != NULL;
+}
+
+uint32_t SoftTimer_GetTicks(void)
+{
+    return tick_count;
+}
+
+void SoftTimer_Process(void)
+{
+    uint32_t now = tick_count;
+    
+    while (processed_tick != now)
+    {
+        processed_tick++;
+        
+        /* Move everything due on this tick out of the slot first, so
+         * callbacks may freely start or cancel any timer */
+        SoftTimer_t *t = wheel[processed_tick & WHEEL_MASK];
+        while (t != NULL)
+        {
+            SoftTimer_t *next = t->next;
+            if (t->expiry == processed_tick)
+            {
+                SoftTimer_Unlink(t);
+                SoftTimer_Link(&expired, t);
+            }
+            t = next;
+        }
+        
+        while (expired != NULL)
+        {
+            t = expired;
+            SoftTimer_Unlink(t);
+            
+            /* Re-arm periodic timers before the callback so it can cancel */
+            if (t->period != 0)
+            {
+                t->expiry += t->period;
+                if ((int32_t)(t->expiry - processed_tick) <= 0)
+                {
+                    t->expiry = processed_tick + 1;  /* Missed deadline, don't burst */
+                }
+                SoftTimer_Link(&wheel[t->expiry & WHEEL_MASK], t);
+            }
+            
+            t->callback(t->arg);
+        }
+    }
+}
+
+/******************************************************************************
+ *                         Private Functions                                   *
+ ******************************************************************************/
+
+static void SoftTimer_Link(SoftTimer_t **head, SoftTimer_t *timer)
+{
+    timer->next = *head;
+    if (*head != NULL)
+    {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void SoftTimer_Unlink(SoftTimer_t *timer)
+{
+    if (timer->pprev == NULL)
+    {
+        return;
+    }
+    
+    *timer->pprev = timer->next;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+static uint32_t SoftTimer_MsToTicks(uint32_t ms)
+{
+    uint32_t ticks = (ms + SOFT_TIMER_TICK_MS - 1) / SOFT_TIMER_TICK_MS;
+    return (ticks == 0) ? 1 : ticks;
+}
+
+/******************************************************************************
+ *                         Interrupt Handler                                   *
+ ******************************************************************************/
+
+/*
+ * Timer0A_Handler
+ * ISR for Timer0 - only advances the tick counter; expiry and callbacks
+ * are handled by SoftTimer_Process() in the main loop.
+ * Note: Timer0 is configured in full 32-bit mode (A+B concatenated).
+ * This handler must be registered in EWARM interrupt vector table.
+ */
+void Timer0A_Handler(void)
+{
+    TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
+    tick_count++;
+}
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * File: soft_timer.h
+ * Module: Software Timer Service (MCAL Layer)
+ * Description: Hashed timer wheel multiplexing all backend timeouts onto
+ *              a single periodic GPTM (Timer0)
+ ******************************************************************************/
+
+#ifndef SOFT_TIMER_H_
+#define SOFT_TIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ *                              Definitions                                    *
+ ******************************************************************************/
+
+/* Tick period of the hardware timer driving the wheel */
+#define SOFT_TIMER_TICK_MS      1
+
+/* Number of wheel slots (power of two). Timers hash into slot
+ * (expiry & (SIZE - 1)); longer timeouts simply stay in their slot for
+ * several revolutions. */
+#define SOFT_TIMER_WHEEL_SIZE   256
+
+/******************************************************************************
+ *                           Type Definitions                                  *
+ ******************************************************************************/
+
+/* Callback run from SoftTimer_Process() (main loop context, never ISR) */
+typedef void (*SoftTimer_Callback_t)(void *arg);
+
+/*
+ * Timer control block. Owned by the caller (usually a static in the
+ * service module); the fields are private to soft_timer.c.
+ */
+typedef struct SoftTimer {
+    struct SoftTimer  *next;
+    struct SoftTimer **pprev;       /* NULL when not linked (inactive) */
+    uint32_t           expiry;      /* Absolute tick of next expiry */
+    uint32_t           period;      /* Ticks between expiries, 0 = one-shot */
+    SoftTimer_Callback_t callback;
+    void              *arg;
+} SoftTimer_t;
+
+/******************************************************************************
+ *                        Function Prototypes                                  *
+ ******************************************************************************/
+
+/*
+ * SoftTimer_Init
+ * Clears the wheel and starts Timer0 as the periodic tick source.
+ * Must be called before any service that uses software timers.
+ */
+void SoftTimer_Init(void);
+
+/*
+ * SoftTimer_Start
+ * Arms a one-shot timer, restarting it if it is already active. O(1).
+ *
+ * Parameters:
+ *   timer    - Caller-owned control block
+ *   ms       - Delay in milliseconds (rounded up to at least one tick)
+ *   callback - Function to run when the timer expires
+ *   arg      - Passed to callback
+ */
+void SoftTimer_Start(SoftTimer_t *timer, uint32_t ms,
+                     SoftTimer_Callback_t callback, void *arg);
+
+/*
+ * SoftTimer_StartPeriodic
+ * Arms a periodic timer that first expires after period_ms and then every
+ * period_ms without accumulating drift. O(1).
+ */
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t period_ms,
+                             SoftTimer_Callback_t callback, void *arg);
+
+/*
+ * SoftTimer_Cancel
+ * Stops a timer. Safe on inactive timers and from inside callbacks. O(1).
+ */
+void SoftTimer_Cancel(SoftTimer_t *timer);
+
+/*
+ * SoftTimer_IsActive
+ * Returns true if the timer is armed (or expired and awaiting dispatch).
+ */
+bool SoftTimer_IsActive(const SoftTimer_t *timer);
+
+/*
+ * SoftTimer_GetTicks
+ * Returns the monotonic tick counter (SOFT_TIMER_TICK_MS per tick).
+ */
+uint32_t SoftTimer_GetTicks(void);
+
+/*
+ * SoftTimer_Process
+ * Advances the wheel to the current tick and runs expired callbacks.
+ * Call from the main loop. Start/Cancel must also be called from main loop
+ * context (including callbacks), never from an ISR.
+ */
+void SoftTimer_Process(void);
+
+/******************************************************************************
+ *                     Timer Interrupt Handler (Public)                       *
+ * Must be registered in the EWARM interrupt vector table                     *
+ * Note: Timer0 uses full 32-bit mode (A+B) but only A generates interrupt    *
+ ******************************************************************************/
+
+/* Timer0A interrupt handler - register in startup_ewarm.c */
+void Timer0A_Handler(void);
+
+#endif /* SOFT_TIMER_H_ */
@@ -5,6 +5,7 @@
  ******************************************************************************/
 
 #include "uart.h"
+#include "soft_timer.h"
 #include <stdbool.h>
 
 /* TivaWare Includes */
@@ -18,25 +19,300 @@
 
 /* Protocol Constants */
 #define UART_SOF_RX      0x7E
+#define UART_SOF_TX      0xFE
+#define UART_COBS_DELIM  0x00
+
+#if UART_FRAMING_COBS && (UART_MAX_LEN >= 254)
+#error "COBS encoder assumes frames shorter than one 254-byte block"
+#endif
 
 /*===========================================================================
  * RX State Machine
  *===========================================================================*/
 typedef enum {
+#if UART_FRAMING_COBS
+    RX_COBS_CODE = 0,       /* Next byte is a COBS block code */
+    RX_COBS_DATA,           /* Inside a block */
+    RX_COBS_DISCARD         /* Bad frame - skip to the next delimiter */
+#else
     RX_WAIT_SOF = 0,
     RX_READ_LEN,
     RX_READ_BODY
+#endif
 } rx_state_t;
 
-static volatile rx_state_t rx_state = RX_WAIT_SOF;
+#if UART_FRAMING_COBS
+#define RX_STATE_IDLE    RX_COBS_CODE
+#else
+#define RX_STATE_IDLE    RX_WAIT_SOF
+#endif
+
+static volatile rx_state_t rx_state = RX_STATE_IDLE;
 static volatile uint8_t rx_len = 0;
 static volatile uint8_t rx_index = 0;
-static uint8_t rx_buf[UART_MAX_LEN];
+static volatile uint32_t rx_last_tick = 0;     /* Tick of the last RX byte */
+#if UART_FRAMING_COBS
+static volatile uint8_t rx_block = 0;          /* Bytes left in this block */
+static volatile bool rx_zero_pending = false;  /* Block ended in a zero */
+#endif
+
+/*===========================================================================
+ * RX Frame Queue (single producer = ISR, single consumer = main loop)
+ *
+ * The ISR assembles the body directly into the slot at rx_head, which the
+ * consumer cannot see until rx_head is advanced, so no copy is needed.
+ * rx_head is only written by the ISR, rx_tail only by the consumer.
+ *===========================================================================*/
+#define RX_QUEUE_MASK    (UART_RX_QUEUE_DEPTH - 1)
+
+#if (UART_RX_QUEUE_DEPTH & RX_QUEUE_MASK) != 0
+#error "UART_RX_QUEUE_DEPTH must be a power of two"
+#endif
+
+typedef struct {
+    uint8_t len;
+    uint8_t data[UART_MAX_LEN];
+} rx_frame_t;
+
+static rx_frame_t rx_queue[UART_RX_QUEUE_DEPTH];
+static volatile uint8_t rx_head = 0;
+static volatile uint8_t rx_tail = 0;
+
+/*===========================================================================
+ * TX Ring (producer = main loop, consumer = UART1 TX interrupt)
+ *
+ * Bytes are queued here and moved into the 16-byte hardware FIFO by
+ * UART_Driver_PrimeTx(), either directly from the caller or from the ISR
+ * when the FIFO drains below its trigger level.
+ *===========================================================================*/
+#define TX_RING_MASK     (UART_TX_BUF_SIZE - 1)
+
+#if (UART_TX_BUF_SIZE & TX_RING_MASK) != 0
+#error "UART_TX_BUF_SIZE must be a power of two"
+#endif
+
+static uint8_t tx_ring[UART_TX_BUF_SIZE];
+static volatile uint8_t tx_head = 0;
+static volatile uint8_t tx_tail = 0;
+
+/* Statistics */
+static volatile uint32_t rx_frames = 0;
+static volatile uint32_t rx_overflows = 0;
+static volatile uint32_t rx_line_errors = 0;
+static volatile uint32_t rx_discarded = 0;
+static volatile uint32_t rx_aborted = 0;
+static volatile uint8_t rx_high_water = 0;
+
+/*===========================================================================
+ * Private Functions
+ *===========================================================================*/
+
+/*
+ * Move queued bytes into the hardware FIFO until it is full or the ring is
+ * empty. Caller must ensure the TX interrupt cannot run concurrently.
+ */
+static void UART_Driver_PrimeTx(void)
+{
+    while ((tx_tail != tx_head) && UARTSpaceAvail(UART1_BASE))
+    {
+        UARTCharPutNonBlocking(UART1_BASE, tx_ring[tx_tail]);
+        tx_tail = (uint8_t)((tx_tail + 1) & TX_RING_MASK);
+    }
+}
+
+/* Kick the FIFO ourselves; the ISR takes over for the remainder */
+static void UART_Driver_StartTx(void)
+{
+    UARTIntDisable(UART1_BASE, UART_INT_TX);
+    UART_Driver_PrimeTx();
+    if (tx_tail != tx_head)
+    {
+        UARTIntEnable(UART1_BASE, UART_INT_TX);
+    }
+}
+
+static void UART_Driver_Enqueue(uint8_t b)
+{
+    uint8_t next = (uint8_t)((tx_head + 1) & TX_RING_MASK);
+    
+    /* Ring full - start the FIFO draining so a send longer than the ring
+     * cannot wait on an interrupt that is not enabled yet */
+    while (next == tx_tail)
+    {
+        UART_Driver_StartTx();
+    }
+    
+    tx_ring[tx_head] = b;
+    tx_head = next;
+}
 
-/* Packet buffer for main loop processing */
-static volatile bool packet_ready = false;
-static uint8_t packet_buf[UART_MAX_LEN];
-static uint8_t packet_len = 0;
+/*
+ * Hand the frame assembled in the head slot to the consumer (ISR only).
+ */
+static void UART_Driver_PublishFrame(uint8_t len)
+{
+    uint8_t head = rx_head;
+    uint8_t next = (uint8_t)((head + 1) & RX_QUEUE_MASK);
+    
+    if (next != rx_tail)
+    {
+        rx_queue[head].len = len;
+        rx_head = next;  /* Publish frame to consumer */
+        rx_frames++;
+        
+        uint8_t depth = (uint8_t)((next - rx_tail) & RX_QUEUE_MASK);
+        if (depth > rx_high_water)
+        {
+            rx_high_water = depth;
+        }
+    }
+    else
+    {
+        /* Queue full - drop frame, slot is reused */
+        rx_overflows++;
+    }
+}
+
+/*
+ * Drop a partly received frame if the line went quiet in the middle of it.
+ * Checked when the next byte arrives, before that byte is parsed, so a new
+ * frame that follows a truncated one is accepted from its first byte.
+ */
+static void UART_Driver_CheckGap(void)
+{
+    uint32_t now = SoftTimer_GetTicks();
+    uint32_t idle = now - rx_last_tick;
+    
+    rx_last_tick = now;
+    if (idle < UART_RX_GAP_TICKS)
+    {
+        return;
+    }
+
+#if UART_FRAMING_COBS
+    if (rx_state == RX_COBS_DISCARD)
+    {
+        rx_discarded++;     /* Already bad, delimiter never came */
+    }
+    else if (rx_state != RX_COBS_CODE || rx_index > 0 || rx_zero_pending)
+    {
+        rx_aborted++;
+    }
+    rx_index = 0;
+    rx_zero_pending = false;
+#else
+    if (rx_state != RX_WAIT_SOF)
+    {
+        rx_aborted++;
+    }
+#endif
+    rx_state = RX_STATE_IDLE;
+}
+
+#if UART_FRAMING_COBS
+/*
+ * Incremental COBS decoder, one byte at a time straight into the head
+ * slot. Each block is [code][code-1 data bytes] and stands for the data
+ * followed by a zero, except that the zero is dropped for 0xFF blocks and
+ * for the last block of the frame.
+ */
+static void UART_Driver_RxByte(uint8_t byte)
+{
+    if (byte == UART_COBS_DELIM)
+    {
+        if (rx_state == RX_COBS_CODE && rx_index > 0)
+        {
+            UART_Driver_PublishFrame(rx_index);
+        }
+        else if (rx_state != RX_COBS_CODE || rx_index > 0)
+        {
+            rx_discarded++;     /* Truncated block or oversized frame */
+        }
+        rx_state = RX_COBS_CODE;
+        rx_index = 0;
+        rx_zero_pending = false;
+        return;
+    }
+    
+    switch (rx_state)
+    {
+        case RX_COBS_CODE:
+            if (rx_zero_pending)
+            {
+                if (rx_index >= UART_MAX_LEN)
+                {
+                    rx_state = RX_COBS_DISCARD;
+                    break;
+                }
+                rx_queue[rx_head].data[rx_index++] = 0x00;
+            }
+            rx_block = (uint8_t)(byte - 1);
+            rx_zero_pending = (byte != 0xFF);
+            rx_state = (rx_block > 0) ? RX_COBS_DATA : RX_COBS_CODE;
+            break;
+        
+        case RX_COBS_DATA:
+            if (rx_index >= UART_MAX_LEN)
+            {
+                rx_state = RX_COBS_DISCARD;
+                break;
+            }
+            rx_queue[rx_head].data[rx_index++] = byte;
+            if (--rx_block == 0)
+            {
+                rx_state = RX_COBS_CODE;
+            }
+            break;
+        
+        default:
+            /* RX_COBS_DISCARD - wait for the delimiter */
+            break;
+    }
+}
+#else
+/*
+ * SOF/LEN state machine, assembling the body straight into the head slot.
+ */
+static void UART_Driver_RxByte(uint8_t byte)
+{
+    switch (rx_state)
+    {
+        case RX_WAIT_SOF:
+            if (byte == UART_SOF_RX)
+            {
+                rx_state = RX_READ_LEN;
+            }
+            break;
+        
+        case RX_READ_LEN:
+            if (byte > 0 && byte <= UART_MAX_LEN)
+            {
+                rx_len = byte;
+                rx_index = 0;
+                rx_state = RX_READ_BODY;
+            }
+            else
+            {
+                rx_discarded++;
+                rx_state = RX_WAIT_SOF;
+            }
+            break;
+        
+        case RX_READ_BODY:
+            rx_queue[rx_head].data[rx_index++] = byte;
+            if (rx_index >= rx_len)
+            {
+                UART_Driver_PublishFrame(rx_len);
+                rx_state = RX_WAIT_SOF;
+            }
+            break;
+        
+        default:
+            rx_state = RX_WAIT_SOF;
+            break;
+    }
+}
+#endif
 
 /*===========================================================================
  * Public Functions
@@ -65,6 +341,7 @@ void UART_Driver_Init(void)
     /* Enable FIFO */
     UARTFIFOEnable(UART1_BASE);
     UARTFIFOLevelSet(UART1_BASE, UART_FIFO_TX1_8, UART_FIFO_RX1_8);
+    UARTTxIntModeSet(UART1_BASE, UART_TXINT_MODE_FIFO);
     
     /* Clear any pending errors */
     UARTRxErrorClear(UART1_BASE);
@@ -73,7 +350,7 @@ void UART_Driver_Init(void)
     UARTIntDisable(UART1_BASE, 0xFFFFFFFF);
     UARTIntClear(UART1_BASE, 0xFFFFFFFF);
     UARTIntRegister(UART1_BASE, UART1IntHandler);
-    UARTIntEnable(UART1_BASE, UART_INT_RX | UART_INT_RT);
+    UARTIntEnable(UART1_BASE, UART_INT_RX | UART_INT_RT);  /* TX enabled on demand */
     
     /* Enable UART */
     UARTEnable(UART1_BASE);
@@ -82,100 +359,156 @@ void UART_Driver_Init(void)
     IntMasterEnable();
     
     /* Initialize state */
-    rx_state = RX_WAIT_SOF;
-    packet_ready = false;
+    rx_state = RX_STATE_IDLE;
+    rx_index = 0;
+    rx_last_tick = SoftTimer_GetTicks();
+    rx_head = 0;
+    rx_tail = 0;
+    tx_head = 0;
+    tx_tail = 0;
+    UART_Driver_ResetStats();
 }
 
 void UART_Driver_SendByte(uint8_t b)
 {
-    while (UARTBusy(UART1_BASE)) {}
-    UARTCharPut(UART1_BASE, b);
+    UART_Driver_Send(&b, 1);
+}
+
+void UART_Driver_Send(const uint8_t *data, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        UART_Driver_Enqueue(data[i]);
+    }
+    UART_Driver_StartTx();
+}
+
+void UART_Driver_SendFrame(const uint8_t *body, uint8_t len)
+{
+#if UART_FRAMING_COBS
+    /* One block per zero-terminated run; the final block has no zero */
+    uint8_t i = 0;
+    for (;;)
+    {
+        uint8_t j = i;
+        while (j < len && body[j] != 0x00)
+        {
+            j++;
+        }
+        UART_Driver_Enqueue((uint8_t)(j - i + 1));
+        for (; i < j; i++)
+        {
+            UART_Driver_Enqueue(body[i]);
+        }
+        if (j >= len)
+        {
+            break;
+        }
+        i = (uint8_t)(j + 1);
+    }
+    UART_Driver_Enqueue(UART_COBS_DELIM);
+#else
+    UART_Driver_Enqueue(UART_SOF_TX);
+    UART_Driver_Enqueue(len);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        UART_Driver_Enqueue(body[i]);
+    }
+#endif
+    UART_Driver_StartTx();
+}
+
+bool UART_Driver_IsTxIdle(void)
+{
+    return (tx_tail == tx_head) && !UARTBusy(UART1_BASE);
 }
 
 void UART_Driver_WaitTxDone(void)
 {
-    while (UARTBusy(UART1_BASE)) {}
-    SysCtlDelay(1000);
+    while (!UART_Driver_IsTxIdle()) {}
 }
 
 bool UART_Driver_IsPacketReady(void)
 {
-    return packet_ready;
+    return rx_head != rx_tail;
 }
 
-void UART_Driver_GetPacket(uint8_t *buf, uint8_t *len)
+bool UART_Driver_GetPacket(uint8_t *buf, uint8_t *len)
 {
-    for (uint8_t i = 0; i < packet_len; i++)
+    uint8_t tail = rx_tail;
+    
+    if (tail == rx_head)
     {
-        buf[i] = packet_buf[i];
+        *len = 0;
+        return false;
     }
-    *len = packet_len;
-    packet_ready = false;
+    
+    const rx_frame_t *frame = &rx_queue[tail];
+    for (uint8_t i = 0; i < frame->len; i++)
+    {
+        buf[i] = frame->data[i];
+    }
+    *len = frame->len;
+    
+    /* Release the slot only after it has been copied out */
+    rx_tail = (uint8_t)((tail + 1) & RX_QUEUE_MASK);
+    return true;
+}
+
+void UART_Driver_GetStats(UART_RxStats_t *stats)
+{
+    stats->frames_received = rx_frames;
+    stats->frames_dropped = rx_overflows;
+    stats->line_errors = rx_line_errors;
+    stats->frames_discarded = rx_discarded;
+    stats->frames_aborted = rx_aborted;
+    stats->queue_high_water = rx_high_water;
+}
+
+void UART_Driver_ResetStats(void)
+{
+    rx_frames = 0;
+    rx_overflows = 0;
+    rx_line_errors = 0;
+    rx_discarded = 0;
+    rx_aborted = 0;
+    rx_high_water = 0;
 }
 
 /*===========================================================================
- * UART ISR - Only collects bytes, doesn't process commands
+ * UART ISR - Collects RX bytes and refills the TX FIFO, no command handling
  *===========================================================================*/
 void UART1IntHandler(void)
 {
     uint32_t int_status = UARTIntStatus(UART1_BASE, true);
     UARTIntClear(UART1_BASE, int_status);
     
-    /* Clear any RX errors */
+    /* TX FIFO drained below trigger level - refill from the ring */
+    if (int_status & UART_INT_TX)
+    {
+        UART_Driver_PrimeTx();
+        if (tx_tail == tx_head)
+        {
+            UARTIntDisable(UART1_BASE, UART_INT_TX);
+        }
+    }
+    
+    /* Clear any RX errors; the frame in progress is lost */
     if (UARTRxErrorGet(UART1_BASE))
     {
         UARTRxErrorClear(UART1_BASE);
+        rx_line_errors++;
+#if UART_FRAMING_COBS
+        rx_state = RX_COBS_DISCARD;
+#else
         rx_state = RX_WAIT_SOF;
+#endif
     }
     
     /* Process received bytes */
     while (UARTCharsAvail(UART1_BASE))
     {
-        uint8_t byte = (uint8_t)UARTCharGetNonBlocking(UART1_BASE);
-        
-        switch (rx_state)
-        {
-            case RX_WAIT_SOF:
-                if (byte == UART_SOF_RX)
-                {
-                    rx_state = RX_READ_LEN;
-                }
-                break;
-                
-            case RX_READ_LEN:
-                if (byte > 0 && byte <= UART_MAX_LEN)
-                {
-                    rx_len = byte;
-                    rx_index = 0;
-                    rx_state = RX_READ_BODY;
-                }
-                else
-                {
-                    rx_state = RX_WAIT_SOF;
-                }
-                break;
-                
-            case RX_READ_BODY:
-                rx_buf[rx_index++] = byte;
-                if (rx_index >= rx_len)
-                {
-                    /* Copy to packet buffer for main loop processing */
-                    if (!packet_ready)  /* Don't overwrite unprocessed packet */
-                    {
-                        for (uint8_t i = 0; i < rx_len; i++)
-                        {
-                            packet_buf[i] = rx_buf[i];
-                        }
-                        packet_len = rx_len;
-                        packet_ready = true;
-                    }
-                    rx_state = RX_WAIT_SOF;
-                }
-                break;
-                
-            default:
-                rx_state = RX_WAIT_SOF;
-                break;
-        }
+        UART_Driver_CheckGap();
+        UART_Driver_RxByte((uint8_t)UARTCharGetNonBlocking(UART1_BASE));
     }
 }
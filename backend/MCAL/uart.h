@@ -12,34 +12,102 @@
 
 #define UART_MAX_LEN     32
 
+/* Wire framing, must match the frontend build:
+ *   0 - [SOF][LEN][body...]
+ *   1 - COBS-encoded body followed by a 0x00 delimiter. The body never
+ *       contains 0x00 on the wire, so a receiver that loses sync always
+ *       recovers at the next delimiter whatever the payload holds. */
+#ifndef UART_FRAMING_COBS
+#define UART_FRAMING_COBS    0
+#endif
+
+/* Number of complete frames buffered between ISR and main loop.
+ * Must be a power of two; one slot is kept free to tell full from empty. */
+#define UART_RX_QUEUE_DEPTH  8
+
+/* A silence of this many soft timer ticks (1 ms) inside a frame aborts
+ * it, so a truncated frame cannot swallow the start of the next one.
+ * 2 ticks = 1..2 ms, over 11 byte times at 115200 baud. */
+#define UART_RX_GAP_TICKS    2
+
+/* Size of the TX ring drained by the UART1 TX interrupt (power of two) */
+#define UART_TX_BUF_SIZE     64
+
+/* RX statistics */
+typedef struct {
+    uint32_t frames_received;   /* Frames queued for the main loop */
+    uint32_t frames_dropped;    /* Frames lost because the queue was full */
+    uint32_t line_errors;       /* Framing/parity/overrun/break events */
+    uint32_t frames_discarded;  /* Malformed or oversized frames */
+    uint32_t frames_aborted;    /* Frames cut short by an inter-byte gap */
+    uint8_t  queue_high_water;  /* Deepest queue occupancy seen */
+} UART_RxStats_t;
+
 /**
  * @brief Initialize UART1 hardware (PB0=RX, PB1=TX) at 115200 baud
  */
 void UART_Driver_Init(void);
 
 /**
- * @brief Send a single byte (blocking)
+ * @brief Queue a single byte for transmission
  * @param b Byte to send
+ * @note Returns immediately unless the TX ring is full
  */
 void UART_Driver_SendByte(uint8_t b);
 
 /**
- * @brief Wait for TX to complete
+ * @brief Queue a buffer for transmission (interrupt-driven)
+ * @param data Bytes to send
+ * @param len Number of bytes
+ * @note Returns as soon as the bytes are queued; only waits if the
+ *       TX ring is full
+ */
+void UART_Driver_Send(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Queue a response frame, adding the wire framing
+ * @param body Frame body (everything after LEN in SOF framing)
+ * @param len Body length (1..UART_MAX_LEN)
+ * @note SOF framing sends [0xFE][len][body]; COBS framing encodes the
+ *       body straight into the TX ring and appends the 0x00 delimiter
+ */
+void UART_Driver_SendFrame(const uint8_t *body, uint8_t len);
+
+/**
+ * @brief Check whether all queued bytes have left the shift register
+ * @return true if TX ring, FIFO and shifter are empty
+ */
+bool UART_Driver_IsTxIdle(void);
+
+/**
+ * @brief Block until all queued bytes have been transmitted
  */
 void UART_Driver_WaitTxDone(void);
 
 /**
- * @brief Check if a complete packet is ready
- * @return true if packet is ready
+ * @brief Check if at least one complete packet is queued
+ * @return true if a packet is ready
  */
 bool UART_Driver_IsPacketReady(void);
 
 /**
- * @brief Get the received packet
- * @param buf Buffer to copy packet into
- * @param len Pointer to store packet length
+ * @brief Pop the oldest queued packet
+ * @param buf Buffer to copy packet into (at least UART_MAX_LEN bytes)
+ * @param len Pointer to store packet length (0 if queue was empty)
+ * @return true if a packet was copied, false if the queue was empty
+ */
+bool UART_Driver_GetPacket(uint8_t *buf, uint8_t *len);
+
+/**
+ * @brief Read RX statistics
+ * @param stats Destination for the counters
+ */
+void UART_Driver_GetStats(UART_RxStats_t *stats);
+
+/**
+ * @brief Clear RX statistics
  */
-void UART_Driver_GetPacket(uint8_t *buf, uint8_t *len);
+void UART_Driver_ResetStats(void);
 
 /**
  * @brief UART1 Interrupt Handler (must be registered in startup)
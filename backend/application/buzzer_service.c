@@ -8,22 +8,21 @@
 
 #include "buzzer_service.h"
 #include "../HAL/buzzer.h"
-#include "../MCAL/gptm.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/timer.h"
-#include "inc/hw_memmap.h"
+#include "../MCAL/soft_timer.h"
+#include <stddef.h>
 
 /******************************************************************************
  *                           Private Variables                                 *
  ******************************************************************************/
 
 static volatile bool buzzer_active = false;
+static SoftTimer_t buzzer_timer;
 
 /******************************************************************************
  *                      Private Function Prototypes                            *
  ******************************************************************************/
 
-static void BuzzerService_StartTimer(uint32_t seconds);
+static void BuzzerService_OnTimeout(void *arg);
 
 /******************************************************************************
  *                          Function Definitions                               *
@@ -31,21 +30,17 @@ static void BuzzerService_StartTimer(uint32_t seconds);
 
 /*
  * BuzzerService_Init
- * Initializes buzzer GPIO and Timer0 for timeout control.
+ * Initializes buzzer GPIO. Timeouts use the soft timer service, which
+ * must already be initialized (SoftTimer_Init).
  */
 void BuzzerService_Init(void)
 {
     /* Initialize buzzer GPIO */
     buzzer_init();
     
-    /* Initialize Timer0 in full 32-bit one-shot mode */
-    Timer0_Init_OneShot();
-    
     /* Start with buzzer off */
+    SoftTimer_Cancel(&buzzer_timer);
     buzzer_active = false;
-    
-    /* NOTE: Timer0A_Handler must be registered in the EWARM */
-    /* interrupt vector table (startup_ewarm.c) */
 }
 
 /*
@@ -59,7 +54,7 @@ void BuzzerService_Activate(uint32_t seconds)
     buzzer_active = true;
     
     /* Start timer to automatically turn off buzzer */
-    BuzzerService_StartTimer(seconds);
+    SoftTimer_Start(&buzzer_timer, seconds * 1000, BuzzerService_OnTimeout, NULL);
 }
 
 /*
@@ -69,7 +64,7 @@ void BuzzerService_Activate(uint32_t seconds)
 void BuzzerService_Cancel(void)
 {
     buzzer_off();
-    Timer0_Stop();
+    SoftTimer_Cancel(&buzzer_timer);
     buzzer_active = false;
 }
 
@@ -87,32 +82,13 @@ bool BuzzerService_IsActive(void)
  ******************************************************************************/
 
 /*
- * BuzzerService_StartTimer
- * Starts Timer0 for the specified number of seconds.
- */
-static void BuzzerService_StartTimer(uint32_t seconds)
-{
-    uint32_t systemClock = SysCtlClockGet();
-    uint32_t ticks = systemClock * seconds;
-    
-    Timer0_Start_OneShot(ticks);
-}
-
-/******************************************************************************
- *                         Interrupt Handler                                   *
- ******************************************************************************/
-
-/*
- * Timer0A_Handler
- * ISR for Timer0 - automatically turns off the buzzer when timer expires.
- * Note: Timer0 is configured in full 32-bit mode (A+B concatenated).
- * Only Timer A generates the timeout interrupt in this configuration.
- * This handler must be registered in EWARM interrupt vector table.
+ * BuzzerService_OnTimeout
+ * Soft timer callback - automatically turns off the buzzer when the
+ * timeout expires. Runs from SoftTimer_Process() in the main loop.
  */
-void Timer0A_Handler(void)
+static void BuzzerService_OnTimeout(void *arg)
 {
-    /* Clear the timer interrupt flag */
-    TimerIntClear(TIMER0_BASE, TIMER_TIMA_TIMEOUT);
+    (void)arg;
     
     /* Turn off the buzzer */
     buzzer_off();
@@ -18,15 +18,16 @@
 
 /*
  * BuzzerService_Init
- * Initializes the buzzer service, buzzer GPIO, and Timer0.
- * Must be called before using other buzzer service functions.
+ * Initializes the buzzer service and buzzer GPIO.
+ * Must be called after SoftTimer_Init() and before using other buzzer
+ * service functions.
  */
 void BuzzerService_Init(void);
 
 /*
  * BuzzerService_Activate
  * Activates the buzzer for a specified duration.
- * The buzzer will automatically turn off when the timer expires.
+ * The buzzer will automatically turn off when the soft timer expires.
  * 
  * Parameters:
  *   seconds - Duration in seconds for the buzzer to stay on
@@ -48,13 +49,4 @@ void BuzzerService_Cancel(void);
  */
 bool BuzzerService_IsActive(void);
 
-/******************************************************************************
- *                     Timer Interrupt Handler (Public)                       *
- * Must be registered in the EWARM interrupt vector table                     *
- * Note: Timer0 uses full 32-bit mode (A+B) but only A generates interrupt    *
- ******************************************************************************/
-
-/* Timer0A interrupt handler - register in startup_ewarm.c */
-void Timer0A_Handler(void);
-
 #endif /* BUZZER_SERVICE_H_ */
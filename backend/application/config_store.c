@@ -0,0 +1,482 @@
+/******************************************************************************
+ * File: config_store.c
+ * Module: Configuration Store (Application Layer)
+ * Description: Wear-leveled, append-only key/value log in the on-chip EEPROM
+ ******************************************************************************/
+
+#include "config_store.h"
+#include "crc16.h"
+
+/* TivaWare includes */
+#include "inc/hw_types.h"
+#include "driverlib/eeprom.h"
+
+/******************************************************************************
+ *                          Private Definitions                                *
+ ******************************************************************************/
+
+#define ERASED_WORD         0xFFFFFFFFUL
+
+/* Byte address of a log block */
+#define BLOCK_ADDR(b)       (((uint32_t)CONFIG_STORE_FIRST_BLOCK + (b)) * \
+                             CONFIG_STORE_BLOCK_WORDS * 4)
+#define NEXT_BLOCK(b)       ((uint8_t)(((b) + 1) % CONFIG_STORE_BLOCKS))
+
+/* Steps a forced compaction may take before giving up on the EEPROM */
+#define COMPACT_MAX_STEPS   (4 * CONFIG_STORE_BLOCK_WORDS)
+
+/* Newest record of a key */
+typedef struct {
+    uint16_t addr;      /* Byte address of the header, 0 = no record */
+    uint8_t  words;     /* Value length */
+} IndexEntry_t;
+
+/******************************************************************************
+ *                           Private Variables                                 *
+ ******************************************************************************/
+
+static IndexEntry_t keyIndex[CONFIG_STORE_MAX_KEYS];
+
+/* Ring of used blocks, oldest (tail) to newest (head) */
+static uint8_t tail = 0;
+static uint8_t head = CONFIG_STORE_BLOCKS - 1;
+static uint8_t used = 0;
+static uint8_t headPos = CONFIG_STORE_BLOCK_WORDS;
+static uint32_t headSeq = 0;
+
+/* Compaction of the tail block in progress */
+static bool compacting = false;
+static uint32_t victim[CONFIG_STORE_BLOCK_WORDS];
+static uint8_t scanPos;
+static uint8_t erasePos;
+
+static ConfigStore_Info_t counters;
+
+/******************************************************************************
+ *                          Private Functions                                  *
+ ******************************************************************************/
+
+static uint32_t RecordHeader(uint8_t key, uint8_t words)
+{
+    return ((uint32_t)key << 16) | ((uint32_t)words << 8) | CONFIG_STORE_MARK;
+}
+
+/* Commit word for a header followed by its value */
+static uint32_t RecordCommit(const uint32_t *record, uint8_t words)
+{
+    uint16_t crc = CRC16_Update(CRC16_INIT, (const uint8_t *)record,
+                                (uint8_t)((words + 1) * 4));
+    return ((uint32_t)crc << 16) | (uint16_t)~crc;
+}
+
+/* Total length of the record starting with this header, 0 if it is not one */
+static uint8_t RecordLength(uint32_t header)
+{
+    uint8_t words = (uint8_t)(header >> 8);
+    
+    if ((header & 0xFF) != CONFIG_STORE_MARK || (header >> 16) >= CONFIG_STORE_MAX_KEYS ||
+        words == 0 || words > CONFIG_STORE_MAX_WORDS)
+    {
+        return 0;
+    }
+    return (uint8_t)(words + 2);
+}
+
+/* Index the records of one block, oldest first; returns the first free
+ * word. Anything that does not parse ends the block. */
+static uint8_t IndexBlock(uint8_t block, const uint32_t *buf)
+{
+    uint8_t pos = 1;
+    
+    while (pos < CONFIG_STORE_BLOCK_WORDS && buf[pos] != ERASED_WORD)
+    {
+        uint8_t len = RecordLength(buf[pos]);
+        
+        if (len == 0 || pos + len > CONFIG_STORE_BLOCK_WORDS)
+        {
+            return CONFIG_STORE_BLOCK_WORDS;
+        }
+        if (buf[pos + len - 1] == RecordCommit(&buf[pos], len - 2))
+        {
+            IndexEntry_t *entry = &keyIndex[buf[pos] >> 16];
+            entry->addr = (uint16_t)(BLOCK_ADDR(block) + pos * 4);
+            entry->words = len - 2;
+        }
+        else
+        {
+            counters.torn_records++;
+        }
+        pos += len;
+    }
+    return pos;
+}
+
+/* Start a new head block. The last free block is kept for compaction. */
+static int OpenBlock(bool useReserve)
+{
+    uint32_t buf[CONFIG_STORE_BLOCK_WORDS];
+    uint8_t next = NEXT_BLOCK(head);
+    uint8_t freeBlocks = CONFIG_STORE_BLOCKS - used;
+    uint32_t seq = headSeq + 1;
+    
+    if (freeBlocks == 0 || (freeBlocks == 1 && !useReserve))
+    {
+        return CONFIG_STORE_FULL;
+    }
+    
+    /* Normally already erased; clear anything a reset left behind */
+    EEPROMRead(buf, BLOCK_ADDR(next), sizeof(buf));
+    for (uint8_t i = CONFIG_STORE_BLOCK_WORDS - 1; i > 0; i--)
+    {
+        if (buf[i] != ERASED_WORD)
+        {
+            uint32_t erased = ERASED_WORD;
+            if (EEPROMProgram(&erased, BLOCK_ADDR(next) + i * 4, 4) != 0)
+            {
+                return CONFIG_STORE_ERROR;
+            }
+        }
+    }
+    /* A wrong sequence number would misplace the block in the ring at
+     * boot, so a header that does not read back is wiped again */
+    if (EEPROMProgram(&seq, BLOCK_ADDR(next), 4) != 0)
+    {
+        return CONFIG_STORE_ERROR;
+    }
+    EEPROMRead(buf, BLOCK_ADDR(next), 4);
+    if (buf[0] != seq)
+    {
+        buf[0] = ERASED_WORD;
+        EEPROMProgram(buf, BLOCK_ADDR(next), 4);
+        return CONFIG_STORE_ERROR;
+    }
+    
+    if (used == 0)
+    {
+        tail = next;
+    }
+    head = next;
+    headSeq = seq;
+    headPos = 1;
+    used++;
+    return CONFIG_STORE_OK;
+}
+
+/* Write one record at the head and read it back */
+static int Append(uint8_t key, const uint32_t *value, uint8_t words, bool useReserve)
+{
+    uint32_t record[CONFIG_STORE_MAX_WORDS + 2];
+    uint32_t check[CONFIG_STORE_MAX_WORDS + 2];
+    uint8_t len = words + 2;
+    uint32_t addr;
+    
+    if (used == 0 || headPos + len > CONFIG_STORE_BLOCK_WORDS)
+    {
+        int status = OpenBlock(useReserve);
+        if (status != CONFIG_STORE_OK)
+        {
+            return status;
+        }
+    }
+    
+    record[0] = RecordHeader(key, words);
+    for (uint8_t i = 0; i < words; i++)
+    {
+        record[i + 1] = value[i];
+    }
+    record[len - 1] = RecordCommit(record, words);
+    addr = BLOCK_ADDR(head) + headPos * 4;
+    
+    /* After a failure the block's contents are uncertain past this point,
+     * so later records go to a fresh block where boot will find them */
+    if (EEPROMProgram(record, addr, len * 4) != 0)
+    {
+        headPos = CONFIG_STORE_BLOCK_WORDS;
+        return CONFIG_STORE_ERROR;
+    }
+    headPos += len;
+    
+    EEPROMRead(check, addr, len * 4);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (check[i] != record[i])
+        {
+            headPos = CONFIG_STORE_BLOCK_WORDS;
+            return CONFIG_STORE_ERROR;
+        }
+    }
+    
+    keyIndex[key].addr = (uint16_t)addr;
+    keyIndex[key].words = words;
+    return CONFIG_STORE_OK;
+}
+
+/* Begin reclaiming the tail block */
+static bool StartCompaction(void)
+{
+    if (used < 2)
+    {
+        return false;   /* The tail is the head */
+    }
+    EEPROMRead(victim, BLOCK_ADDR(tail), sizeof(victim));
+    scanPos = 1;
+    erasePos = CONFIG_STORE_BLOCK_WORDS;
+    compacting = true;
+    return true;
+}
+
+/* Copy one live record out of the tail block, or erase one of its words.
+ * Words are erased last to first, so a reset mid-way leaves a block whose
+ * remaining records are whole or visibly torn. Returns false if the live
+ * records have nowhere to go. */
+static bool CompactStep(void)
+{
+    while (scanPos < CONFIG_STORE_BLOCK_WORDS)
+    {
+        uint32_t header = victim[scanPos];
+        uint8_t len = RecordLength(header);
+        uint32_t addr = BLOCK_ADDR(tail) + scanPos * 4;
+        int status;
+        
+        if (header == ERASED_WORD || len == 0 || scanPos + len > CONFIG_STORE_BLOCK_WORDS)
+        {
+            scanPos = CONFIG_STORE_BLOCK_WORDS;
+            break;
+        }
+        if (keyIndex[header >> 16].addr != addr)
+        {
+            scanPos += len;     /* Superseded */
+            continue;
+        }
+        
+        status = Append((uint8_t)(header >> 16), &victim[scanPos + 1], len - 2, true);
+        if (status == CONFIG_STORE_FULL)
+        {
+            return false;
+        }
+        if (status == CONFIG_STORE_OK)
+        {
+            scanPos += len;
+            counters.copied_records++;
+        }
+        return true;
+    }
+    
+    while (erasePos > 0)
+    {
+        erasePos--;
+        if (victim[erasePos] != ERASED_WORD)
+        {
+            uint32_t erased = ERASED_WORD;
+            if (EEPROMProgram(&erased, BLOCK_ADDR(tail) + erasePos * 4, 4) != 0)
+            {
+                erasePos++;     /* Retry next step */
+            }
+            return true;
+        }
+    }
+    
+    tail = NEXT_BLOCK(tail);
+    used--;
+    counters.compactions++;
+    compacting = false;
+    return true;
+}
+
+/* Reclaim a block now (a write found no free block) */
+static bool Compact(void)
+{
+    uint8_t steps = 0;
+    
+    if (!compacting && !StartCompaction())
+    {
+        return false;
+    }
+    while (compacting)
+    {
+        if (!CompactStep() || ++steps > COMPACT_MAX_STEPS)
+        {
+            compacting = false;
+            return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ *                          Public Functions                                   *
+ ******************************************************************************/
+
+void ConfigStore_Init(void)
+{
+    uint32_t seq[CONFIG_STORE_BLOCKS];
+    uint32_t buf[CONFIG_STORE_BLOCK_WORDS];
+    bool found = false;
+    
+    for (uint8_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++)
+    {
+        keyIndex[k].addr = 0;
+        keyIndex[k].words = 0;
+    }
+    counters.torn_records = 0;
+    counters.compactions = 0;
+    counters.copied_records = 0;
+    compacting = false;
+    tail = 0;
+    head = CONFIG_STORE_BLOCKS - 1;
+    used = 0;
+    headPos = CONFIG_STORE_BLOCK_WORDS;
+    headSeq = 0;
+    
+    /* Oldest and newest block by sequence number */
+    for (uint8_t b = 0; b < CONFIG_STORE_BLOCKS; b++)
+    {
+        EEPROMRead(&seq[b], BLOCK_ADDR(b), 4);
+        if (seq[b] == ERASED_WORD)
+        {
+            continue;
+        }
+        if (!found || seq[b] < seq[tail])
+        {
+            tail = b;
+        }
+        if (!found || seq[b] > headSeq)
+        {
+            head = b;
+            headSeq = seq[b];
+        }
+        found = true;
+    }
+    if (!found)
+    {
+        return;
+    }
+    
+    /* Replay the ring oldest to newest so the index ends on the newest
+     * record of every key */
+    used = (uint8_t)((head + CONFIG_STORE_BLOCKS - tail) % CONFIG_STORE_BLOCKS + 1);
+    for (uint8_t i = 0, b = tail; i < used; i++, b = NEXT_BLOCK(b))
+    {
+        if (seq[b] == ERASED_WORD)
+        {
+            continue;
+        }
+        EEPROMRead(buf, BLOCK_ADDR(b), sizeof(buf));
+        headPos = IndexBlock(b, buf);
+    }
+}
+
+uint8_t ConfigStore_Read(uint8_t key, uint32_t *value, uint8_t maxWords)
+{
+    uint8_t words;
+    
+    if (key >= CONFIG_STORE_MAX_KEYS || keyIndex[key].addr == 0)
+    {
+        return 0;
+    }
+    words = keyIndex[key].words < maxWords ? keyIndex[key].words : maxWords;
+    EEPROMRead(value, keyIndex[key].addr + 4, words * 4);
+    return words;
+}
+
+int ConfigStore_Write(uint8_t key, const uint32_t *value, uint8_t words)
+{
+    if (key >= CONFIG_STORE_MAX_KEYS || words == 0 || words > CONFIG_STORE_MAX_WORDS)
+    {
+        return CONFIG_STORE_ERROR;
+    }
+    
+    for (uint8_t tries = 0; tries < CONFIG_STORE_BLOCKS; tries++)
+    {
+        int status = Append(key, value, words, false);
+        if (status != CONFIG_STORE_FULL)
+        {
+            return status;
+        }
+        if (!Compact())
+        {
+            break;
+        }
+    }
+    return CONFIG_STORE_FULL;
+}
+
+uint8_t ConfigStore_Wipe(uint8_t key)
+{
+    uint32_t buf[CONFIG_STORE_BLOCK_WORDS];
+    uint32_t zeros[CONFIG_STORE_MAX_WORDS + 1] = {0};
+    uint8_t wiped = 0;
+    
+    if (key >= CONFIG_STORE_MAX_KEYS)
+    {
+        return 0;
+    }
+    
+    for (uint8_t i = 0, b = tail; i < used; i++, b = NEXT_BLOCK(b))
+    {
+        uint8_t pos = 1;
+        
+        EEPROMRead(buf, BLOCK_ADDR(b), sizeof(buf));
+        while (pos < CONFIG_STORE_BLOCK_WORDS && buf[pos] != ERASED_WORD)
+        {
+            uint8_t len = RecordLength(buf[pos]);
+            bool nonzero = false;
+            
+            if (len == 0 || pos + len > CONFIG_STORE_BLOCK_WORDS)
+            {
+                break;
+            }
+            /* Value and commit word: a zero commit word never matches, so
+             * the record is dead even if its value was already zero */
+            for (uint8_t w = 1; w < len; w++)
+            {
+                nonzero |= (buf[pos + w] != 0);
+            }
+            if ((buf[pos] >> 16) == key && nonzero &&
+                EEPROMProgram(zeros, BLOCK_ADDR(b) + (pos + 1) * 4, (uint32_t)(len - 1) * 4) == 0)
+            {
+                wiped++;
+            }
+            pos += len;
+        }
+    }
+    
+    keyIndex[key].addr = 0;
+    keyIndex[key].words = 0;
+    return wiped;
+}
+
+bool ConfigStore_Process(void)
+{
+    if (!compacting)
+    {
+        if (CONFIG_STORE_BLOCKS - used >= CONFIG_STORE_SPARE_BLOCKS || !StartCompaction())
+        {
+            return false;
+        }
+    }
+    if (!CompactStep())
+    {
+        compacting = false;
+        return false;
+    }
+    return true;
+}
+
+void ConfigStore_GetInfo(ConfigStore_Info_t *info)
+{
+    *info = counters;
+    info->used_blocks = used;
+    info->free_blocks = CONFIG_STORE_BLOCKS - used;
+    info->live_keys = 0;
+    for (uint8_t k = 0; k < CONFIG_STORE_MAX_KEYS; k++)
+    {
+        if (keyIndex[k].addr != 0)
+        {
+            info->live_keys++;
+        }
+    }
+    info->head_block = head;
+    info->head_pos = headPos;
+    info->head_seq = headSeq;
+}
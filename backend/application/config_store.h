@@ -0,0 +1,123 @@
+/******************************************************************************
+ * File: config_store.h
+ * Module: Configuration Store (Application Layer)
+ * Description: Wear-leveled, append-only key/value log in the on-chip EEPROM
+ ******************************************************************************/
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ *                              Definitions                                    *
+ ******************************************************************************/
+
+/*
+ * Layout. The log owns EEPROM blocks FIRST_BLOCK..FIRST_BLOCK+BLOCKS-1;
+ * block 0 keeps the old fixed-offset words so they can be migrated and
+ * blocks 16-31 hold the credential table (credentials.h).
+ *
+ * Block:  word 0 = sequence number (0xFFFFFFFF = erased), then records.
+ * Record: header  = key << 16 | value words << 8 | CONFIG_STORE_MARK
+ *         value   = 1..CONFIG_STORE_MAX_WORDS words
+ *         commit  = crc16(header, value) << 16 | ~crc16
+ * A record whose commit word is missing or wrong was torn by a reset and
+ * is ignored. Blocks are filled in a ring; the oldest block is compacted
+ * (its live records copied to the head, then erased) as the ring fills.
+ */
+#define CONFIG_STORE_FIRST_BLOCK    1
+#define CONFIG_STORE_BLOCKS         15
+#define CONFIG_STORE_BLOCK_WORDS    16
+
+#define CONFIG_STORE_MAX_KEYS       16      /* Keys 0..15, direct-indexed */
+#define CONFIG_STORE_MAX_WORDS      8       /* Longest value */
+#define CONFIG_STORE_MARK           0x5A
+
+/* ConfigStore_Process starts compacting below this many free blocks;
+ * writes themselves never take the last free block */
+#define CONFIG_STORE_SPARE_BLOCKS   3
+
+/* Return codes */
+#define CONFIG_STORE_OK             0
+#define CONFIG_STORE_ERROR          1       /* Program failed or did not verify */
+#define CONFIG_STORE_FULL           2       /* Live data fills the log */
+
+/******************************************************************************
+ *                           Type Definitions                                  *
+ ******************************************************************************/
+
+typedef struct {
+    uint8_t  used_blocks;       /* Blocks holding records (tail..head) */
+    uint8_t  free_blocks;       /* Erased blocks ready for the head */
+    uint8_t  live_keys;         /* Keys with a current record */
+    uint8_t  head_block;        /* Log block being filled */
+    uint8_t  head_pos;          /* Next free word in the head block */
+    uint32_t head_seq;          /* Sequence number of the head block */
+    uint32_t torn_records;      /* Records skipped at boot (bad commit) */
+    uint32_t compactions;       /* Blocks reclaimed since boot */
+    uint32_t copied_records;    /* Live records moved by compaction */
+} ConfigStore_Info_t;
+
+/******************************************************************************
+ *                        Function Prototypes                                  *
+ ******************************************************************************/
+
+/*
+ * ConfigStore_Init
+ * Scans the log once and builds the RAM index (key -> newest record).
+ * Call after EEPROMInit().
+ */
+void ConfigStore_Init(void);
+
+/*
+ * ConfigStore_Read
+ * Copies the current value of a key. O(1): one EEPROMRead at the indexed
+ * address.
+ *
+ * Return:
+ *   Number of words copied (at most maxWords), 0 if the key has no record
+ */
+uint8_t ConfigStore_Read(uint8_t key, uint32_t *value, uint8_t maxWords);
+
+/*
+ * ConfigStore_Write
+ * Appends a new record for the key, reads it back and only then points
+ * the index at it. Compacts on the spot if no block is free.
+ *
+ * Return:
+ *   CONFIG_STORE_OK, CONFIG_STORE_ERROR or CONFIG_STORE_FULL
+ */
+int ConfigStore_Write(uint8_t key, const uint32_t *value, uint8_t words);
+
+/*
+ * ConfigStore_Wipe
+ * Deletes a key by zeroing the value and commit words of all its
+ * records, older ones included, for values that must not stay readable in
+ * the EEPROM. A zero commit word never checks, so boot skips the records
+ * like torn ones whatever their value was. If a reset interrupts the wipe, a record that was not
+ * reached yet can be current again at the next boot.
+ *
+ * Return:
+ *   Number of records zeroed
+ */
+uint8_t ConfigStore_Wipe(uint8_t key);
+
+/*
+ * ConfigStore_Process
+ * Background compaction, one EEPROM program per call. Call from the main
+ * loop.
+ *
+ * Return:
+ *   true if it did any work
+ */
+bool ConfigStore_Process(void);
+
+/*
+ * ConfigStore_GetInfo
+ * Snapshot of the log state, for tests and diagnostics.
+ */
+void ConfigStore_GetInfo(ConfigStore_Info_t *info);
+
+#endif /* CONFIG_STORE_H_ */
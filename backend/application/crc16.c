@@ -0,0 +1,24 @@
+/******************************************************************************
+ * File: crc16.c
+ * Module: CRC-16 (Application Layer)
+ * Description: CRC-16/CCITT-FALSE used by UART protocol v2 frames
+ ******************************************************************************/
+
+#include "crc16.h"
+
+/* Nibble table: 32 bytes of flash, two lookups per byte */
+static const uint16_t crc16_nibble[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crc16_nibble[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
@@ -0,0 +1,383 @@
+/******************************************************************************
+ * File: credentials.c
+ * Module: Credentials (Application Layer)
+ * Description: Multi-user PIN table in EEPROM with a RAM lookup index
+ ******************************************************************************/
+
+#include "credentials.h"
+#include "crc16.h"
+#include "../MCAL/soft_timer.h"
+#include <stddef.h>
+
+/* TivaWare includes */
+#include "inc/hw_types.h"
+#include "driverlib/eeprom.h"
+
+/******************************************************************************
+ *                          Private Definitions                                *
+ ******************************************************************************/
+
+#define ERASED_WORD         0xFFFFFFFFUL
+#define SECONDS_PER_DAY     86400UL
+
+/* Byte address of a slot */
+#define SLOT_ADDR(s)        ((uint32_t)CREDENTIALS_FIRST_BLOCK * CREDENTIALS_BLOCK_WORDS * 4 + \
+                             (uint32_t)(s) * CREDENTIALS_SLOT_WORDS * 4)
+
+/******************************************************************************
+ *                           Private Variables                                 *
+ ******************************************************************************/
+
+/*
+ * Lookup index: PIN hashes in ascending order with the slot holding each,
+ * searched by bisection. PINs are unique, so a hash names one user.
+ */
+static uint32_t indexHash[CREDENTIALS_MAX_USERS];
+static uint16_t indexSlot[CREDENTIALS_MAX_USERS];
+static uint16_t userCount = 0;
+
+/* User id per slot (CREDENTIALS_NO_USER = free), for remove and list */
+static uint16_t slotUser[CREDENTIALS_MAX_USERS];
+
+/* Next slot to try when adding, so writes rotate through the table */
+static uint16_t nextSlot = 0;
+
+/* Wall clock for validity windows, 0 = unset */
+static uint32_t clockSeconds = 0;
+static SoftTimer_t clockTimer;
+
+static Credentials_Info_t counters;
+
+/******************************************************************************
+ *                          Private Functions                                  *
+ ******************************************************************************/
+
+/* Commit word over the data words and the user id */
+static uint32_t SlotCommit(uint16_t userId, const uint32_t *data)
+{
+    uint16_t crc = CRC16_Update(CRC16_INIT, (const uint8_t *)data,
+                                (CREDENTIALS_SLOT_WORDS - 1) * 4);
+    uint8_t id[2] = {(uint8_t)(userId >> 8), (uint8_t)userId};
+    
+    crc = CRC16_Update(crc, id, sizeof(id));
+    return ((uint32_t)userId << 16) | crc;
+}
+
+/* User id of a slot's contents, CREDENTIALS_NO_USER if not a valid entry */
+static uint16_t SlotUser(const uint32_t *slot)
+{
+    uint16_t userId = (uint16_t)(slot[0] >> 16);
+    
+    if (userId == CREDENTIALS_NO_USER || slot[0] != SlotCommit(userId, &slot[1]))
+    {
+        return CREDENTIALS_NO_USER;
+    }
+    return userId;
+}
+
+/* First index position whose hash is >= hash */
+static uint16_t LowerBound(uint32_t hash)
+{
+    uint16_t lo = 0;
+    uint16_t hi = userCount;
+    
+    while (lo < hi)
+    {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        if (indexHash[mid] < hash)
+        {
+            lo = (uint16_t)(mid + 1);
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void IndexInsert(uint32_t hash, uint16_t slot)
+{
+    uint16_t pos = LowerBound(hash);
+    
+    for (uint16_t i = userCount; i > pos; i--)
+    {
+        indexHash[i] = indexHash[i - 1];
+        indexSlot[i] = indexSlot[i - 1];
+    }
+    indexHash[pos] = hash;
+    indexSlot[pos] = slot;
+    userCount++;
+}
+
+static void IndexRemove(uint16_t slot)
+{
+    uint16_t pos = 0;
+    
+    while (pos < userCount && indexSlot[pos] != slot)
+    {
+        pos++;
+    }
+    if (pos == userCount)
+    {
+        return;
+    }
+    userCount--;
+    for (uint16_t i = pos; i < userCount; i++)
+    {
+        indexHash[i] = indexHash[i + 1];
+        indexSlot[i] = indexSlot[i + 1];
+    }
+}
+
+static uint16_t FindUser(uint16_t userId)
+{
+    for (uint16_t s = 0; s < CREDENTIALS_MAX_USERS; s++)
+    {
+        if (slotUser[s] == userId)
+        {
+            return s;
+        }
+    }
+    return CREDENTIALS_MAX_USERS;
+}
+
+/* Erase a slot's commit word; the rest is left for the next add */
+static int FreeSlot(uint16_t slot)
+{
+    uint32_t word = ERASED_WORD;
+    
+    if (EEPROMProgram(&word, SLOT_ADDR(slot), 4) != 0)
+    {
+        return CREDENTIALS_ERROR;
+    }
+    EEPROMRead(&word, SLOT_ADDR(slot), 4);
+    if (word != ERASED_WORD)
+    {
+        return CREDENTIALS_ERROR;
+    }
+    IndexRemove(slot);
+    slotUser[slot] = CREDENTIALS_NO_USER;
+    return CREDENTIALS_OK;
+}
+
+static void ClockTick(void *arg)
+{
+    (void)arg;
+    clockSeconds++;
+}
+
+/******************************************************************************
+ *                          Public Functions                                   *
+ ******************************************************************************/
+
+void Credentials_Init(void)
+{
+    uint32_t block[CREDENTIALS_BLOCK_WORDS];
+    
+    userCount = 0;
+    nextSlot = 0;
+    counters.bad_slots = 0;
+    counters.duplicates = 0;
+    
+    /* One EEPROMRead per block */
+    for (uint16_t s = 0; s < CREDENTIALS_MAX_USERS; s++)
+    {
+        const uint32_t *slot = &block[(s * CREDENTIALS_SLOT_WORDS) % CREDENTIALS_BLOCK_WORDS];
+        uint16_t userId;
+        
+        if (slot == block)
+        {
+            EEPROMRead(block, SLOT_ADDR(s), sizeof(block));
+        }
+        slotUser[s] = CREDENTIALS_NO_USER;
+        userId = SlotUser(slot);
+        if (userId == CREDENTIALS_NO_USER)
+        {
+            if (slot[0] != ERASED_WORD)
+            {
+                counters.bad_slots++;
+            }
+            continue;
+        }
+        
+        /* A reset between writing a replacement and freeing the old entry
+         * leaves two whole copies; either is valid, keep the first */
+        if (FindUser(userId) != CREDENTIALS_MAX_USERS)
+        {
+            counters.duplicates++;
+            FreeSlot(s);
+            continue;
+        }
+        slotUser[s] = userId;
+        IndexInsert(slot[1], s);
+        nextSlot = (uint16_t)((s + 1) % CREDENTIALS_MAX_USERS);
+    }
+}
+
+int Credentials_Add(const Credentials_User_t *user, uint32_t hash)
+{
+    uint32_t slot[CREDENTIALS_SLOT_WORDS];
+    uint32_t check[CREDENTIALS_SLOT_WORDS];
+    uint16_t old = FindUser(user->user_id);
+    uint16_t pos = LowerBound(hash);
+    uint16_t s = nextSlot;
+    
+    if (user->user_id == CREDENTIALS_NO_USER)
+    {
+        return CREDENTIALS_ERROR;
+    }
+    if (pos < userCount && indexHash[pos] == hash && indexSlot[pos] != old)
+    {
+        return CREDENTIALS_PIN_IN_USE;
+    }
+    
+    /* Free slot at or after the cursor */
+    for (uint16_t n = 0; n < CREDENTIALS_MAX_USERS && slotUser[s] != CREDENTIALS_NO_USER; n++)
+    {
+        s = (uint16_t)((s + 1) % CREDENTIALS_MAX_USERS);
+    }
+    if (slotUser[s] != CREDENTIALS_NO_USER)
+    {
+        return CREDENTIALS_FULL;
+    }
+    
+    slot[1] = hash;
+    slot[2] = ((uint32_t)user->valid_from << 16) | user->valid_until;
+    slot[3] = user->flags;
+    slot[0] = SlotCommit(user->user_id, &slot[1]);
+    
+    /* Data first, commit word last, then read the whole slot back */
+    if (EEPROMProgram(&slot[1], SLOT_ADDR(s) + 4, (CREDENTIALS_SLOT_WORDS - 1) * 4) != 0 ||
+        EEPROMProgram(&slot[0], SLOT_ADDR(s), 4) != 0)
+    {
+        FreeSlot(s);
+        return CREDENTIALS_ERROR;
+    }
+    EEPROMRead(check, SLOT_ADDR(s), sizeof(check));
+    for (uint8_t i = 0; i < CREDENTIALS_SLOT_WORDS; i++)
+    {
+        if (check[i] != slot[i])
+        {
+            FreeSlot(s);
+            return CREDENTIALS_ERROR;
+        }
+    }
+    
+    slotUser[s] = user->user_id;
+    IndexInsert(hash, s);
+    nextSlot = (uint16_t)((s + 1) % CREDENTIALS_MAX_USERS);
+    
+    /* If this fails both copies stay valid and boot drops one */
+    if (old != CREDENTIALS_MAX_USERS)
+    {
+        FreeSlot(old);
+    }
+    return CREDENTIALS_OK;
+}
+
+int Credentials_Remove(uint16_t userId)
+{
+    uint16_t s = FindUser(userId);
+    
+    if (userId == CREDENTIALS_NO_USER || s == CREDENTIALS_MAX_USERS)
+    {
+        return CREDENTIALS_NOT_FOUND;
+    }
+    return FreeSlot(s);
+}
+
+int Credentials_Authenticate(uint32_t hash, uint16_t *userId, uint8_t *flags)
+{
+    uint32_t slot[CREDENTIALS_SLOT_WORDS];
+    uint16_t pos = LowerBound(hash);
+    uint16_t today;
+    uint16_t from;
+    uint16_t until;
+    
+    if (pos == userCount || indexHash[pos] != hash)
+    {
+        return CREDENTIALS_NOT_FOUND;
+    }
+    
+    /* The slot decides: it must still hold this entry */
+    EEPROMRead(slot, SLOT_ADDR(indexSlot[pos]), sizeof(slot));
+    if (SlotUser(slot) != slotUser[indexSlot[pos]] || slot[1] != hash)
+    {
+        return CREDENTIALS_NOT_FOUND;
+    }
+    if (slot[3] & CREDENTIALS_FLAG_DISABLED)
+    {
+        return CREDENTIALS_DENIED;
+    }
+    
+    today = Credentials_Today();
+    from = (uint16_t)(slot[2] >> 16);
+    until = (uint16_t)slot[2];
+    if ((from != 0 || until != 0) &&
+        (today == 0 || (from != 0 && today < from) || (until != 0 && today > until)))
+    {
+        return CREDENTIALS_DENIED;
+    }
+    
+    *userId = slotUser[indexSlot[pos]];
+    if (flags != NULL)
+    {
+        *flags = (uint8_t)slot[3];
+    }
+    return CREDENTIALS_OK;
+}
+
+uint16_t Credentials_List(uint16_t firstId, Credentials_User_t *users, uint16_t maxUsers)
+{
+    uint32_t slot[CREDENTIALS_SLOT_WORDS];
+    uint16_t count = 0;
+    uint32_t from = firstId;
+    
+    /* Smallest id >= from, repeatedly; listing is rare and pages are short */
+    while (count < maxUsers)
+    {
+        uint16_t best = CREDENTIALS_MAX_USERS;
+        
+        for (uint16_t s = 0; s < CREDENTIALS_MAX_USERS; s++)
+        {
+            if (slotUser[s] != CREDENTIALS_NO_USER && slotUser[s] >= from &&
+                (best == CREDENTIALS_MAX_USERS || slotUser[s] < slotUser[best]))
+            {
+                best = s;
+            }
+        }
+        if (best == CREDENTIALS_MAX_USERS)
+        {
+            break;
+        }
+        
+        EEPROMRead(slot, SLOT_ADDR(best), sizeof(slot));
+        users[count].user_id = slotUser[best];
+        users[count].flags = (uint8_t)slot[3];
+        users[count].valid_from = (uint16_t)(slot[2] >> 16);
+        users[count].valid_until = (uint16_t)slot[2];
+        count++;
+        from = (uint32_t)slotUser[best] + 1;
+    }
+    return count;
+}
+
+void Credentials_SetClock(uint32_t seconds)
+{
+    clockSeconds = seconds;
+    SoftTimer_StartPeriodic(&clockTimer, 1000, ClockTick, NULL);
+}
+
+uint16_t Credentials_Today(void)
+{
+    return (uint16_t)(clockSeconds / SECONDS_PER_DAY);
+}
+
+void Credentials_GetInfo(Credentials_Info_t *info)
+{
+    *info = counters;
+    info->users = userCount;
+    info->capacity = CREDENTIALS_MAX_USERS;
+    info->index_bytes = sizeof(indexHash) + sizeof(indexSlot) + sizeof(slotUser);
+}
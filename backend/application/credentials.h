@@ -0,0 +1,150 @@
+/******************************************************************************
+ * File: credentials.h
+ * Module: Credentials (Application Layer)
+ * Description: Multi-user PIN table in EEPROM with a RAM lookup index
+ ******************************************************************************/
+
+#ifndef CREDENTIALS_H_
+#define CREDENTIALS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ *                              Definitions                                    *
+ ******************************************************************************/
+
+/*
+ * Layout. The table owns EEPROM blocks FIRST_BLOCK..FIRST_BLOCK+BLOCKS-1,
+ * after the config store, as fixed slots of CREDENTIALS_SLOT_WORDS:
+ *   word 0 = user id << 16 | crc16(words 1..3, user id)   (commit word)
+ *   word 1 = PIN hash (PinHash_Hash, salted and device-wide)
+ *   word 2 = valid from day << 16 | valid until day
+ *   word 3 = flags
+ * A slot is in use when word 0 checks out. Words 1..3 are programmed
+ * before word 0, so a reset mid-write leaves the slot free; freeing a
+ * slot erases word 0 only.
+ */
+#ifndef CREDENTIALS_FIRST_BLOCK
+#define CREDENTIALS_FIRST_BLOCK     16
+#endif
+#ifndef CREDENTIALS_BLOCKS
+#define CREDENTIALS_BLOCKS          16
+#endif
+#define CREDENTIALS_BLOCK_WORDS     16
+#define CREDENTIALS_SLOT_WORDS      4
+
+/* 64 users in the 16 blocks of the TM4C123 EEPROM */
+#define CREDENTIALS_MAX_USERS       (CREDENTIALS_BLOCKS * CREDENTIALS_BLOCK_WORDS / \
+                                     CREDENTIALS_SLOT_WORDS)
+
+/* User ids 0..0xFFFE; 0xFFFF marks a free slot */
+#define CREDENTIALS_NO_USER         0xFFFF
+
+/* Flags */
+#define CREDENTIALS_FLAG_DISABLED   0x01    /* Kept in the table, never admitted */
+#define CREDENTIALS_FLAG_ADMIN      0x02    /* May use the menu (check-only AUTH) */
+
+/* Return codes */
+#define CREDENTIALS_OK              0
+#define CREDENTIALS_ERROR           1       /* Program failed or did not verify */
+#define CREDENTIALS_FULL            2       /* No free slot */
+#define CREDENTIALS_NOT_FOUND       3       /* No such PIN or user */
+#define CREDENTIALS_DENIED          4       /* Disabled or outside its window */
+#define CREDENTIALS_PIN_IN_USE      5       /* Another user has this PIN */
+
+/******************************************************************************
+ *                           Type Definitions                                  *
+ ******************************************************************************/
+
+/*
+ * Validity window in days since 1970-01-01, both ends inclusive; 0 leaves
+ * that end open. A user with a window is refused while the clock is unset.
+ */
+typedef struct {
+    uint16_t user_id;
+    uint8_t  flags;
+    uint16_t valid_from;
+    uint16_t valid_until;
+} Credentials_User_t;
+
+typedef struct {
+    uint16_t users;             /* Slots in use */
+    uint16_t capacity;          /* CREDENTIALS_MAX_USERS */
+    uint32_t index_bytes;       /* RAM taken by the lookup index */
+    uint32_t bad_slots;         /* Non-erased slots that failed the check at boot */
+    uint32_t duplicates;        /* Second copies of a user freed at boot */
+} Credentials_Info_t;
+
+/******************************************************************************
+ *                        Function Prototypes                                  *
+ ******************************************************************************/
+
+/*
+ * Credentials_Init
+ * Reads the table once and builds the RAM index (PIN hash -> slot, sorted).
+ * Call after EEPROMInit(). Only Credentials_SetClock needs SoftTimer_Init().
+ */
+void Credentials_Init(void);
+
+/*
+ * Credentials_Add
+ * Adds a user, or replaces the entry of an existing user id. The new entry
+ * goes to a free slot and is read back before the old one is freed. The
+ * table only sees PIN hashes; callers hash with PinHash_Hash.
+ *
+ * Return:
+ *   CREDENTIALS_OK, CREDENTIALS_ERROR, CREDENTIALS_FULL or
+ *   CREDENTIALS_PIN_IN_USE
+ */
+int Credentials_Add(const Credentials_User_t *user, uint32_t pinHash);
+
+/*
+ * Credentials_Remove
+ *
+ * Return:
+ *   CREDENTIALS_OK, CREDENTIALS_ERROR or CREDENTIALS_NOT_FOUND
+ */
+int Credentials_Remove(uint16_t userId);
+
+/*
+ * Credentials_Authenticate
+ * Binary search of the index for the PIN hash, then one EEPROMRead of the
+ * matching slot to check flags and validity window. flags may be NULL.
+ *
+ * Return:
+ *   CREDENTIALS_OK (userId and flags set), CREDENTIALS_NOT_FOUND or
+ *   CREDENTIALS_DENIED
+ */
+int Credentials_Authenticate(uint32_t pinHash, uint16_t *userId, uint8_t *flags);
+
+/*
+ * Credentials_List
+ * Copies up to maxUsers entries with user_id >= firstId, in id order.
+ *
+ * Return:
+ *   Number of entries copied
+ */
+uint16_t Credentials_List(uint16_t firstId, Credentials_User_t *users, uint16_t maxUsers);
+
+/*
+ * Credentials_SetClock
+ * Sets the wall clock (seconds since 1970-01-01) used for validity windows.
+ * It then advances once a second from a software timer, so call it only
+ * after SoftTimer_Init().
+ */
+void Credentials_SetClock(uint32_t seconds);
+
+/*
+ * Credentials_Today
+ * Current day number, 0 while the clock is unset.
+ */
+uint16_t Credentials_Today(void);
+
+/*
+ * Credentials_GetInfo
+ * Table and index statistics, for tests and diagnostics.
+ */
+void Credentials_GetInfo(Credentials_Info_t *info);
+
+#endif /* CREDENTIALS_H_ */
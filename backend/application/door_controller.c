@@ -8,10 +8,8 @@
 
 #include "door_controller.h"
 #include "../HAL/motor.h"
-#include "../MCAL/gptm.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/timer.h"
-#include "inc/hw_memmap.h"
+#include "../MCAL/soft_timer.h"
+#include <stddef.h>
 
 /******************************************************************************
  *                           Timing Constants                                  *
@@ -24,12 +22,14 @@
  ******************************************************************************/
 
 static volatile DoorState_t doorState = DOOR_IDLE;
+static SoftTimer_t doorTimer;
 
 /******************************************************************************
  *                      Private Function Prototypes                            *
  ******************************************************************************/
 
 static void DoorController_StartTimer(uint32_t seconds);
+static void DoorController_OnTimeout(void *arg);
 
 /******************************************************************************
  *                          Function Definitions                               *
@@ -37,21 +37,17 @@ static void DoorController_StartTimer(uint32_t seconds);
 
 /*
  * DoorController_Init
- * Initializes motor and Timer1A for door sequence control.
+ * Initializes motor GPIO. Sequence timing uses the soft timer service,
+ * which must already be initialized (SoftTimer_Init).
  */
 void DoorController_Init(void)
 {
     /* Initialize motor GPIO */
     Motor_Init();
     
-    /* Initialize Timer1 in full 32-bit one-shot mode */
-    Timer1_Init_OneShot();
-    
     /* Start in IDLE state */
+    SoftTimer_Cancel(&doorTimer);
     doorState = DOOR_IDLE;
-    
-    /* NOTE: Timer1A_Handler must be registered in the EWARM */
-    /* interrupt vector table (startup_ewarm.c) */
 }
 
 /*
@@ -88,7 +84,7 @@ DoorState_t DoorController_GetState(void)
 void DoorController_Stop(void)
 {
     Motor_Stop();
-    Timer1_Stop();
+    SoftTimer_Cancel(&doorTimer);
     doorState = DOOR_IDLE;
 }
 
@@ -98,27 +94,21 @@ void DoorController_Stop(void)
 
 /*
  * DoorController_StartTimer
- * Starts Timer1A for the specified number of seconds.
+ * Arms the door soft timer for the specified number of seconds.
  */
 static void DoorController_StartTimer(uint32_t seconds)
 {
-    uint32_t systemClock = SysCtlClockGet();
-    uint32_t ticks = systemClock * seconds;
-    
-    Timer1_Start_OneShot(ticks);
+    SoftTimer_Start(&doorTimer, seconds * 1000, DoorController_OnTimeout, NULL);
 }
 
 /*
- * Timer1A_Handler
- * ISR for Timer1 - handles state transitions in door sequence.
- * Note: Timer1 is configured in full 32-bit mode (A+B concatenated).
- * Only Timer A generates the timeout interrupt in this configuration.
- * This handler must be registered in EWARM interrupt vector table.
+ * DoorController_OnTimeout
+ * Soft timer callback - handles state transitions in door sequence.
+ * Runs from SoftTimer_Process() in the main loop.
  */
-void Timer1A_Handler(void)
+static void DoorController_OnTimeout(void *arg)
 {
-    /* Clear the timer interrupt flag */
-    TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+    (void)arg;
     
     switch (doorState)
     {
@@ -29,8 +29,9 @@ typedef enum {
 
 /*
  * DoorController_Init
- * Initializes the door controller, motor, and required timers.
- * Must be called before using other door controller functions.
+ * Initializes the door controller and motor.
+ * Must be called after SoftTimer_Init() and before using other door
+ * controller functions.
  */
 void DoorController_Init(void);
 
@@ -62,13 +63,4 @@ DoorState_t DoorController_GetState(void);
  */
 void DoorController_Stop(void);
 
-/******************************************************************************
- *                     Timer Interrupt Handler (Public)                       *
- * Must be registered in the EWARM interrupt vector table                     *
- * Note: Timer1 uses full 32-bit mode (A+B) but only A generates interrupt    *
- ******************************************************************************/
-
-/* Timer1A interrupt handler - register in startup_ewarm.c */
-void Timer1A_Handler(void);
-
 #endif /* DOOR_CONTROLLER_H_ */
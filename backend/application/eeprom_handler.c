@@ -1,4 +1,8 @@
 #include "eeprom_handler.h"
+#include "config_store.h"
+#include "credentials.h"
+#include "pin_hash.h"
+#include <stddef.h>
 
 // TivaWare includes
 #include "inc/hw_types.h"
@@ -8,68 +12,318 @@
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 
-// Initialize password in EEPROM
-int initialize_password(uint32_t new_password)
+// RAM mirror of the configuration, indexed by CONFIG_KEY_*. Loaded once;
+// every read is served from here and the store is only written when a
+// value really changes.
+static uint32_t config[CONFIG_WORDS];
+static bool config_loaded = false;
+
+// Write-behind state: keys whose mirror value is not in the store yet (one
+// bit per CONFIG_KEY_*), failed attempts per key, and who to tell when a
+// commit finishes.
+static uint8_t dirty = 0;
+static uint8_t commit_failures[CONFIG_WORDS];
+
+typedef struct
 {
-    uint32_t data[1];
-    data[0] = new_password;
+    commit_callback_t cb;       // NULL = free slot
+    uint8_t key;
+    uint32_t tag;
+} commit_waiter_t;
+
+static commit_waiter_t waiters[COMMIT_WAITERS];
+
+// Load the hash salt and cost, or make them on first boot. Stored hashes
+// only verify with the cost they were made with, so a new calibration is
+// taken only while there are none.
+static void setup_pin_hash(void)
+{
+    uint32_t stored[3];
+    PinHash_Params_t params;
+    Credentials_Info_t users;
+    uint32_t calibrated = PinHash_Calibrate(PIN_HASH_BUDGET_US);
+    uint32_t off;
+    
+    if (ConfigStore_Read(CONFIG_KEY_PIN_HASH, stored, 3) == 3)
+    {
+        params.salt[0] = stored[0];
+        params.salt[1] = stored[1];
+        params.iterations = stored[2];
+    }
+    else
+    {
+        PinHash_NewSalt(params.salt);
+        params.iterations = 0;
+    }
     
-    // Program the new password into EEPROM
-    if (EEPROMProgram(data, PASSWORD_OFFSET, sizeof(data)) != 0)
+    Credentials_GetInfo(&users);
+    off = calibrated > params.iterations ? calibrated - params.iterations
+                                         : params.iterations - calibrated;
+    if (params.iterations == 0 ||
+        (config[CONFIG_KEY_PASSWORD_HASH] == 0xFFFFFFFF && users.users == 0 &&
+         off > params.iterations / PIN_HASH_RETUNE_DIV))
     {
-        return STATUS_ERROR;
+        params.iterations = calibrated;
+        stored[0] = params.salt[0];
+        stored[1] = params.salt[1];
+        stored[2] = params.iterations;
+        ConfigStore_Write(CONFIG_KEY_PIN_HASH, stored, 3);
     }
+    PinHash_Setup(&params);
+}
+
+// Older firmware kept the password in clear, in the old fixed word and in
+// the store. Store its hash, then wipe both copies. Every step can run
+// again, so a reset part way through is finished at the next boot.
+static void hash_legacy_password(void)
+{
+    uint32_t word;
+    
+    if (config[CONFIG_KEY_PASSWORD] == 0xFFFFFFFF)
+    {
+        return;
+    }
+    if (config[CONFIG_KEY_PASSWORD_HASH] == 0xFFFFFFFF)
+    {
+        config[CONFIG_KEY_PASSWORD_HASH] = PinHash_Hash(config[CONFIG_KEY_PASSWORD]);
+        if (ConfigStore_Write(CONFIG_KEY_PASSWORD_HASH, &config[CONFIG_KEY_PASSWORD_HASH], 1)
+            != CONFIG_STORE_OK)
+        {
+            return;  // Keep the cleartext until the hash is durable
+        }
+    }
+    
+    EEPROMRead(&word, PASSWORD_OFFSET, sizeof(word));
+    if (word != 0xFFFFFFFF)
+    {
+        word = 0xFFFFFFFF;
+        EEPROMProgram(&word, PASSWORD_OFFSET, sizeof(word));
+    }
+    ConfigStore_Wipe(CONFIG_KEY_PASSWORD);
+    config[CONFIG_KEY_PASSWORD] = 0xFFFFFFFF;
+}
+
+// Build the store index and load the configuration into RAM. Values not
+// in the store yet come from the old fixed-offset words and are moved in.
+int eeprom_handler_init(void)
+{
+    uint32_t legacy[LEGACY_WORDS];
+    bool legacy_read = false;
+    
+    dirty = 0;
+    for (uint8_t i = 0; i < COMMIT_WAITERS; i++)
+    {
+        waiters[i].cb = NULL;
+    }
+    ConfigStore_Init();
+    Credentials_Init();
+    for (uint8_t key = 0; key < CONFIG_WORDS; key++)
+    {
+        if (ConfigStore_Read(key, &config[key], 1) == 1)
+        {
+            continue;
+        }
+        config[key] = 0xFFFFFFFF;
+        if (key >= LEGACY_WORDS)
+        {
+            continue;
+        }
+        if (!legacy_read)
+        {
+            EEPROMRead(legacy, CONFIG_OFFSET, sizeof(legacy));
+            legacy_read = true;
+        }
+        config[key] = legacy[key];
+        // The password is not copied in clear; hash_legacy_password stores its hash
+        if (legacy[key] != 0xFFFFFFFF && key != CONFIG_KEY_PASSWORD)
+        {
+            ConfigStore_Write(key, &legacy[key], 1);
+        }
+    }
+    setup_pin_hash();
+    hash_legacy_password();
+    config_loaded = true;
+    return STATUS_OK;
+}
+
+// Callers that skipped eeprom_handler_init still get the stored values
+static void ensure_loaded(void)
+{
+    if (!config_loaded)
+    {
+        eeprom_handler_init();
+    }
+}
+
+// Update the mirror and queue the commit. Nothing is programmed here; a
+// value changed again before its commit costs no extra record.
+static int write_word(uint8_t key, uint32_t value)
+{
+    ensure_loaded();
+    if (config[key] == value)
+    {
+        return STATUS_OK;  // Unchanged - nothing to program
+    }
+    
+    config[key] = value;
+    dirty |= (uint8_t)(1u << key);
+    commit_failures[key] = 0;
     return STATUS_OK;
 }
 
-// Authenticate the candidate password with the stored password
+// Run the callbacks waiting on a key. Each slot is freed before its
+// callback runs so the callback may register again.
+static void notify_waiters(uint8_t key, int status)
+{
+    for (uint8_t i = 0; i < COMMIT_WAITERS; i++)
+    {
+        commit_callback_t cb = waiters[i].cb;
+        if (cb != NULL && waiters[i].key == key)
+        {
+            waiters[i].cb = NULL;
+            cb(status, waiters[i].tag);
+        }
+    }
+}
+
+// Append one record for a dirty key. The store reads the record back, so
+// STATUS_OK means durable. Returns STATUS_PENDING if it should be retried
+// and STATUS_ERROR once the change has been dropped.
+static int commit_key(uint8_t key)
+{
+    uint32_t value = config[key];
+    
+    if (ConfigStore_Write(key, &value, 1) == CONFIG_STORE_OK)
+    {
+        dirty &= (uint8_t)~(1u << key);
+        notify_waiters(key, STATUS_OK);
+        return STATUS_OK;
+    }
+    if (++commit_failures[key] < COMMIT_RETRIES)
+    {
+        return STATUS_PENDING;
+    }
+    
+    // Give up: the mirror goes back to what a reboot would load
+    dirty &= (uint8_t)~(1u << key);
+    if (ConfigStore_Read(key, &config[key], 1) != 1)
+    {
+        config[key] = 0xFFFFFFFF;
+    }
+    notify_waiters(key, STATUS_ERROR);
+    return STATUS_ERROR;
+}
+
+// Lowest dirty key; only called with dirty != 0
+static uint8_t next_dirty_key(void)
+{
+    uint8_t key = 0;
+    while ((dirty & (1u << key)) == 0)
+    {
+        key++;
+    }
+    return key;
+}
+
+// One record per call keeps each main loop pass short
+bool eeprom_handler_process(void)
+{
+    if (dirty == 0)
+    {
+        return false;
+    }
+    commit_key(next_dirty_key());
+    return true;
+}
+
+int eeprom_handler_flush(void)
+{
+    int result = STATUS_OK;
+    
+    while (dirty != 0)
+    {
+        if (commit_key(next_dirty_key()) == STATUS_ERROR)
+        {
+            result = STATUS_ERROR;
+        }
+    }
+    return result;
+}
+
+int notify_when_durable(uint8_t key, commit_callback_t cb, uint32_t tag)
+{
+    if ((dirty & (1u << key)) == 0)
+    {
+        return STATUS_OK;
+    }
+    for (uint8_t i = 0; i < COMMIT_WAITERS; i++)
+    {
+        if (waiters[i].cb == NULL)
+        {
+            waiters[i].cb = cb;
+            waiters[i].key = key;
+            waiters[i].tag = tag;
+            return STATUS_PENDING;
+        }
+    }
+    return STATUS_ERROR;
+}
+
+// Initialize password in EEPROM (as its hash)
+int initialize_password(uint32_t new_password)
+{
+    ensure_loaded();
+    return write_word(CONFIG_KEY_PASSWORD_HASH, PinHash_Hash(new_password));
+}
+
+// Authenticate the candidate password with the stored password, then with
+// the user table
 // NOTE: Does NOT open door - caller must handle that after sending UART response
-int authenticate(uint32_t candidate_password)
+int authenticate(uint32_t candidate_password, uint8_t* flags)
 {
-    uint32_t stored_password[1];
+    uint32_t hash;
+    uint16_t user;
+    uint8_t user_flags = 0;
     
-    // Read the stored password from EEPROM
-    EEPROMRead(stored_password, PASSWORD_OFFSET, sizeof(stored_password));
+    ensure_loaded();
+    hash = PinHash_Hash(candidate_password);  // The slow part, same cost for every candidate
     
-    // Compare candidate password with the stored password
-    if (stored_password[0] == candidate_password)
+    // Compare the hash with the stored one without an early exit
+    if (config[CONFIG_KEY_PASSWORD_HASH] != 0xFFFFFFFF &&
+        PinHash_Equal(config[CONFIG_KEY_PASSWORD_HASH], hash))
+    {
+        user_flags = CREDENTIALS_FLAG_ADMIN;  // The master password may use the menu
+    }
+    else if (Credentials_Authenticate(hash, &user, &user_flags) != CREDENTIALS_OK)
     {
-        return STATUS_OK;  // Password matches
+        return STATUS_AUTH_FAIL;  // Password does not match
     }
-    return STATUS_AUTH_FAIL;  // Password does not match
+    if (flags != NULL)
+    {
+        *flags = user_flags;
+    }
+    return STATUS_OK;  // The master password, or a user's PIN enabled and in its window
 }
 
 // Change password in EEPROM
 int change_password(uint32_t new_password)
-{  
+{
     // Set the new password
     return initialize_password(new_password);
 }
 
-// Get auto timeout value from EEPROM
+// Get auto timeout value
 int get_auto_timeout(uint32_t* timeout)
 {
-    uint32_t data[1];
-    
-    // Read the timeout value from EEPROM
-    EEPROMRead(data, TIMEOUT_OFFSET, sizeof(data));
-    
-    *timeout = data[0];  // Return the timeout value
+    ensure_loaded();
+    *timeout = config[CONFIG_KEY_TIMEOUT];  // Return the timeout value
     return STATUS_OK;
 }
 
 // Change auto timeout value in EEPROM
 int change_auto_timeout(uint32_t new_timeout)
 {
-    uint32_t data[1];
-    data[0] = new_timeout;
-    
-    // Program the new timeout value into EEPROM
-    if (EEPROMProgram(data, TIMEOUT_OFFSET, sizeof(data)) != 0)
-    {
-        return STATUS_ERROR;
-    }
-    return STATUS_OK;
+    return write_word(CONFIG_KEY_TIMEOUT, new_timeout);
 }
 
 // Set default auto timeout if no value is present
@@ -81,7 +335,7 @@ int set_default_auto_timeout()
     int result = get_auto_timeout(&timeout);
     
     // If reading was OK AND the value is valid (not erased/uninitialized), keep it
-    if (result == STATUS_OK && timeout != 0 && timeout != 0xFFFFFFFF) 
+    if (result == STATUS_OK && timeout != 0 && timeout != 0xFFFFFFFF)
     {
         return STATUS_OK;
     }
@@ -90,28 +344,16 @@ int set_default_auto_timeout()
     return change_auto_timeout(DEFAULT_TIMEOUT);
 }
 
-// Get potentiometer value from EEPROM
+// Get potentiometer value
 int get_potentiometer_value(uint32_t* value)
 {
-    uint32_t data[1];
-    
-    // Read the potentiometer value from EEPROM
-    EEPROMRead(data, POTENTIOMETER_OFFSET, sizeof(data));
-    
-    *value = data[0];  // Return the potentiometer value
+    ensure_loaded();
+    *value = config[CONFIG_KEY_POTENTIOMETER];  // Return the potentiometer value
     return STATUS_OK;
 }
 
 // Set potentiometer value in EEPROM
 int set_potentiometer_value(uint32_t value)
 {
-    uint32_t data[1];
-    data[0] = value;
-    
-    // Program the new potentiometer value into EEPROM
-    if (EEPROMProgram(data, POTENTIOMETER_OFFSET, sizeof(data)) != 0)
-    {
-        return STATUS_ERROR;
-    }
-    return STATUS_OK;
-}
\ No newline at end of file
+    return write_word(CONFIG_KEY_POTENTIOMETER, value);
+}
@@ -4,43 +4,120 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-// --- EEPROM Offsets (Aligned to 4 bytes) ---
+// --- Old fixed EEPROM layout, read once to migrate into the config store ---
 #define PASSWORD_OFFSET 0x00    // Offset for the password in EEPROM
 #define TIMEOUT_OFFSET 0x04     // Offset for the timeout in EEPROM
 #define POTENTIOMETER_OFFSET 0x08 // Offset for the potentiometer value in EEPROM
 #define DEFAULT_TIMEOUT 11      // Default timeout value (seconds)
 
+#define CONFIG_OFFSET 0x00
+#define LEGACY_WORDS 3          // Words in the old layout
+#define CONFIG_WORDS 4          // Keys mirrored in RAM (0..CONFIG_WORDS-1)
+
+// --- Config store keys (same order as the old layout) ---
+#define CONFIG_KEY_PASSWORD 0   // Old cleartext password, wiped once hashed
+#define CONFIG_KEY_TIMEOUT 1
+#define CONFIG_KEY_POTENTIOMETER 2
+#define CONFIG_KEY_PASSWORD_HASH 3  // PinHash_Hash of the password
+#define CONFIG_KEY_PIN_HASH 4   // Salt and iterations (3 words, not mirrored)
+
+// A device with no hashes stored takes a new calibration once it is off
+// from the stored cost by more than 1/PIN_HASH_RETUNE_DIV
+#define PIN_HASH_RETUNE_DIV 4
+
 // --- Status Codes for function results ---
 #define STATUS_OK 0
 #define STATUS_ERROR 1
 #define STATUS_AUTH_FAIL 2
+#define STATUS_PENDING 3        // Commit queued, callback follows
+
+// --- Write-behind commits ---
+#define COMMIT_RETRIES 3        // Store attempts before a change is dropped
+#define COMMIT_WAITERS 4        // Outstanding notify_when_durable requests
+
+// Called once a key's pending change is in the store (STATUS_OK) or has
+// been dropped and the old value restored (STATUS_ERROR)
+typedef void (*commit_callback_t)(int status, uint32_t tag);
+
+/**
+ * @brief Load the configuration into the RAM mirror.
+ *
+ * Call once at boot after EEPROMInit(). Builds the config store index,
+ * migrating values from the old fixed layout on first boot. Reads are then
+ * served from RAM; writes append to the store only when the value changes.
+ * Also builds the user table index (Credentials_Init), calibrates the PIN
+ * hash cost and sets up the salt (PinHash_Setup), and replaces a cleartext
+ * password left by older firmware with its hash.
+ * @return int STATUS_OK.
+ */
+int eeprom_handler_init(void);
+
+/**
+ * @brief Commit one pending change to the config store.
+ *
+ * Setters only update the RAM mirror and mark the key dirty; this writes
+ * the newest value of one dirty key (one record, blocking for its program
+ * time) and notifies its waiters. A change that fails COMMIT_RETRIES times
+ * is dropped and the mirror goes back to the stored value. Call from the
+ * main loop.
+ * @return bool true if it did any work.
+ */
+bool eeprom_handler_process(void);
+
+/**
+ * @brief Commit every pending change now.
+ *
+ * @return int STATUS_OK if all of them reached the store, STATUS_ERROR if
+ *         any was dropped.
+ */
+int eeprom_handler_flush(void);
+
+/**
+ * @brief Ask to be told when the current value of a key is durable.
+ *
+ * @param key CONFIG_KEY_* of the value just set.
+ * @param cb Called from eeprom_handler_process/flush with the outcome.
+ * @param tag Passed back to cb unchanged.
+ * @return int STATUS_OK if nothing is pending (cb is not called),
+ *         STATUS_PENDING if cb will be called, STATUS_ERROR if all
+ *         COMMIT_WAITERS slots are taken.
+ */
+int notify_when_durable(uint8_t key, commit_callback_t cb, uint32_t tag);
 
 /**
  * @brief Initialize password in EEPROM.
- * * @param new_password The 32-bit password to store.
- * @return int STATUS_OK on success, STATUS_ERROR on EEPROM failure.
+ *
+ * Stores PinHash_Hash of the password, never the password itself. Updates
+ * the RAM mirror; the store is written by eeprom_handler_process.
+ * @param new_password The 32-bit password to store.
+ * @return int STATUS_OK (accepted). See notify_when_durable for the commit.
  */
 int initialize_password(uint32_t new_password);
 
 /**
  * @brief Authenticate the candidate password with the stored password.
  *
+ * Hashes the candidate once (PIN_HASH_BUDGET_US) and compares the hash
+ * with the stored one in constant time. Falls back to the user table
+ * (Credentials_Authenticate), so any enabled user PIN inside its validity
+ * window is accepted as well.
  * @param candidate_password The 32-bit password to check.
- * @param mode Operation mode: 0x0 = authenticate only, 0x1 = authenticate and open door.
+ * @param flags If not NULL, set on a match to the user's CREDENTIALS_FLAG_*
+ *              bits; the master password counts as CREDENTIALS_FLAG_ADMIN.
  * @return int STATUS_OK if match, STATUS_AUTH_FAIL if no match.
  */
-int authenticate(uint32_t candidate_password);
+int authenticate(uint32_t candidate_password, uint8_t* flags);
 
 /**
  * @brief Change password in EEPROM after authenticating the old one.
  * * @param old_password The current 32-bit password.
  * @param new_password The new 32-bit password to store.
- * @return int STATUS_OK on success, STATUS_AUTH_FAIL on authentication failure, STATUS_ERROR on EEPROM failure.
+ * @return int STATUS_OK (accepted; committed by eeprom_handler_process).
  */
 int change_password(uint32_t new_password);
 
 /**
- * @brief Get auto timeout value from EEPROM.
+ * @brief Get auto timeout value (from the RAM mirror).
  *
  * @param timeout Pointer to store the read 32-bit timeout value.
  * @return int STATUS_OK.
@@ -51,19 +128,19 @@ int get_auto_timeout(uint32_t* timeout);
  * @brief Change auto timeout value in EEPROM.
  *
  * @param new_timeout The new 32-bit timeout value (seconds) to store.
- * @return int STATUS_OK on success, STATUS_ERROR on EEPROM failure.
+ * @return int STATUS_OK (accepted; committed by eeprom_handler_process).
  */
 int change_auto_timeout(uint32_t new_timeout);
 
 /**
  * @brief Set default auto timeout if no value is present (value is 0).
  *
- * @return int STATUS_OK on success or if already set, STATUS_ERROR on EEPROM failure.
+ * @return int STATUS_OK (set now or already set).
  */
 int set_default_auto_timeout();
 
 /**
- * @brief Get potentiometer value from EEPROM.
+ * @brief Get potentiometer value (from the RAM mirror).
  *
  * @param value Pointer to store the read 32-bit potentiometer value.
  * @return int STATUS_OK on success.
@@ -74,7 +151,7 @@ int get_potentiometer_value(uint32_t* value);
  * @brief Set potentiometer value in EEPROM.
  *
  * @param value The 32-bit potentiometer value to store.
- * @return int STATUS_OK on success, STATUS_ERROR on EEPROM failure.
+ * @return int STATUS_OK (accepted; committed by eeprom_handler_process).
  */
 int set_potentiometer_value(uint32_t value);
 
@@ -0,0 +1,248 @@
+/******************************************************************************
+ * File: pin_hash.c
+ * Module: PIN Hash (Application Layer)
+ * Description: Salted PIN hash with a calibrated cost (PBKDF2-HMAC-SHA256)
+ ******************************************************************************/
+
+#include "pin_hash.h"
+
+/* TivaWare includes */
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/adc.h"
+
+/******************************************************************************
+ *                          Private Definitions                                *
+ ******************************************************************************/
+
+#define ERASED_WORD         0xFFFFFFFFUL
+
+#define HMAC_IPAD           0x36363636UL
+#define HMAC_OPAD           0x5C5C5C5CUL
+
+/* Bit length of a digest hashed after one key block */
+#define DIGEST_MSG_BITS     ((64 + 32) * 8)
+
+/* SysTick runs over its full 24-bit range while timing */
+#define SYSTICK_RANGE       0x1000000UL
+
+#define SALT_ADC_SEQUENCER  3
+#define SALT_BLOCKS         4       /* 64 temperature readings */
+
+/******************************************************************************
+ *                           Private Variables                                 *
+ ******************************************************************************/
+
+static PinHash_Params_t params = {{0, 0}, PIN_HASH_MIN_ITERATIONS};
+
+/******************************************************************************
+ *                          Private Functions                                  *
+ ******************************************************************************/
+
+/* OR bytes into a zeroed block of big-endian words, starting at byte pos */
+static void PackBytes(uint32_t *words, uint8_t pos, const uint8_t *data, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++, pos++)
+    {
+        words[pos / 4] |= (uint32_t)data[i] << (24 - 8 * (pos % 4));
+    }
+}
+
+/* Chaining state after the HMAC key block XOR pad */
+static void KeyState(uint32_t state[SHA256_STATE_WORDS],
+                     const uint32_t key[SHA256_BLOCK_WORDS], uint32_t pad)
+{
+    uint32_t block[SHA256_BLOCK_WORDS];
+    
+    for (uint8_t i = 0; i < SHA256_BLOCK_WORDS; i++)
+    {
+        block[i] = key[i] ^ pad;
+    }
+    SHA256_Init(state);
+    SHA256_Compress(state, block);
+}
+
+/* One HMAC from the precomputed key states: two compressions */
+static void Hmac(uint32_t out[SHA256_STATE_WORDS], const uint32_t inner[SHA256_STATE_WORDS],
+                 const uint32_t outer[SHA256_STATE_WORDS], const uint32_t block[SHA256_BLOCK_WORDS])
+{
+    uint32_t state[SHA256_STATE_WORDS];
+    uint32_t msg[SHA256_BLOCK_WORDS] = {0};
+    
+    for (uint8_t i = 0; i < SHA256_STATE_WORDS; i++)
+    {
+        state[i] = inner[i];
+        out[i] = outer[i];
+    }
+    SHA256_Compress(state, block);
+    
+    for (uint8_t i = 0; i < SHA256_STATE_WORDS; i++)
+    {
+        msg[i] = state[i];
+    }
+    msg[8] = 0x80000000UL;
+    msg[15] = DIGEST_MSG_BITS;
+    SHA256_Compress(out, msg);
+}
+
+/******************************************************************************
+ *                          Public Functions                                   *
+ ******************************************************************************/
+
+void PinHash_Setup(const PinHash_Params_t *newParams)
+{
+    params = *newParams;
+}
+
+void PinHash_GetParams(PinHash_Params_t *out)
+{
+    *out = params;
+}
+
+void PinHash_Pbkdf2(const uint8_t *password, uint8_t passwordLen,
+                    const uint8_t *salt, uint8_t saltLen,
+                    uint32_t iterations, uint32_t digest[SHA256_STATE_WORDS])
+{
+    static const uint8_t blockIndex[4] = {0, 0, 0, 1};
+    static const uint8_t padByte = 0x80;
+    uint32_t key[SHA256_BLOCK_WORDS] = {0};
+    uint32_t msg[SHA256_BLOCK_WORDS] = {0};
+    uint32_t inner[SHA256_STATE_WORDS];
+    uint32_t outer[SHA256_STATE_WORDS];
+    uint32_t u[SHA256_STATE_WORDS];
+    
+    PackBytes(key, 0, password, passwordLen);
+    KeyState(inner, key, HMAC_IPAD);
+    KeyState(outer, key, HMAC_OPAD);
+    
+    /* U1 = HMAC(P, S || INT(1)) */
+    PackBytes(msg, 0, salt, saltLen);
+    PackBytes(msg, saltLen, blockIndex, sizeof(blockIndex));
+    PackBytes(msg, (uint8_t)(saltLen + sizeof(blockIndex)), &padByte, 1);
+    msg[15] = (64UL + saltLen + sizeof(blockIndex)) * 8;
+    Hmac(u, inner, outer, msg);
+    
+    for (uint8_t i = 0; i < SHA256_STATE_WORDS; i++)
+    {
+        digest[i] = u[i];
+    }
+    
+    /* Un = HMAC(P, Un-1); the message block is U plus fixed padding */
+    for (uint8_t i = SHA256_STATE_WORDS; i < SHA256_BLOCK_WORDS; i++)
+    {
+        msg[i] = 0;
+    }
+    msg[8] = 0x80000000UL;
+    msg[15] = DIGEST_MSG_BITS;
+    for (uint32_t n = 1; n < iterations; n++)
+    {
+        for (uint8_t i = 0; i < SHA256_STATE_WORDS; i++)
+        {
+            msg[i] = u[i];
+        }
+        Hmac(u, inner, outer, msg);
+        for (uint8_t i = 0; i < SHA256_STATE_WORDS; i++)
+        {
+            digest[i] ^= u[i];
+        }
+    }
+}
+
+uint32_t PinHash_Hash(uint32_t pin)
+{
+    uint8_t password[4];
+    uint8_t salt[PIN_HASH_SALT_WORDS * 4];
+    uint32_t digest[SHA256_STATE_WORDS];
+    
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        password[i] = (uint8_t)(pin >> (24 - 8 * i));
+    }
+    for (uint8_t i = 0; i < sizeof(salt); i++)
+    {
+        salt[i] = (uint8_t)(params.salt[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    PinHash_Pbkdf2(password, sizeof(password), salt, sizeof(salt), params.iterations, digest);
+    return digest[0] == ERASED_WORD ? 0 : digest[0];
+}
+
+bool PinHash_Equal(uint32_t a, uint32_t b)
+{
+    uint32_t diff = a ^ b;
+    
+    /* Top bit of (diff | -diff) is set for any nonzero diff */
+    return ((diff | (0UL - diff)) >> 31) == 0;
+}
+
+uint32_t PinHash_Calibrate(uint32_t budgetUs)
+{
+    static const uint8_t password[4] = {0};
+    static const uint8_t salt[PIN_HASH_SALT_WORDS * 4] = {0};
+    uint32_t digest[SHA256_STATE_WORDS];
+    uint32_t start;
+    uint32_t ticks;
+    uint64_t iterations;
+    
+    SysTickPeriodSet(SYSTICK_RANGE);
+    SysTickEnable();
+    start = SysTickValueGet();
+    PinHash_Pbkdf2(password, sizeof(password), salt, sizeof(salt),
+                   PIN_HASH_CALIBRATION_ITERATIONS, digest);
+    ticks = (start - SysTickValueGet()) & (SYSTICK_RANGE - 1);
+    SysTickDisable();
+    
+    /* The fixed part (key setup and U1) is counted as iterations too,
+     * which errs on the cheap side by a few percent */
+    iterations = (uint64_t)budgetUs * (SysCtlClockGet() / 1000000UL) *
+                 PIN_HASH_CALIBRATION_ITERATIONS / (ticks != 0 ? ticks : 1);
+    if (iterations < PIN_HASH_MIN_ITERATIONS)
+    {
+        return PIN_HASH_MIN_ITERATIONS;
+    }
+    if (iterations > PIN_HASH_MAX_ITERATIONS)
+    {
+        return PIN_HASH_MAX_ITERATIONS;
+    }
+    return (uint32_t)iterations;
+}
+
+void PinHash_NewSalt(uint32_t salt[PIN_HASH_SALT_WORDS])
+{
+    uint32_t state[SHA256_STATE_WORDS];
+    uint32_t block[SHA256_BLOCK_WORDS];
+    uint32_t sample;
+    
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_ADC0)) {}
+    ADCSequenceConfigure(ADC0_BASE, SALT_ADC_SEQUENCER, ADC_TRIGGER_PROCESSOR, 0);
+    ADCSequenceStepConfigure(ADC0_BASE, SALT_ADC_SEQUENCER, 0,
+                             ADC_CTL_TS | ADC_CTL_IE | ADC_CTL_END);
+    ADCSequenceEnable(ADC0_BASE, SALT_ADC_SEQUENCER);
+    SysTickPeriodSet(SYSTICK_RANGE);
+    SysTickEnable();
+    
+    /* A few noisy low bits per reading, and the conversion time jitter
+     * shows up in the timestamp */
+    SHA256_Init(state);
+    for (uint8_t b = 0; b < SALT_BLOCKS; b++)
+    {
+        for (uint8_t i = 0; i < SHA256_BLOCK_WORDS; i++)
+        {
+            ADCIntClear(ADC0_BASE, SALT_ADC_SEQUENCER);
+            ADCProcessorTrigger(ADC0_BASE, SALT_ADC_SEQUENCER);
+            while (!ADCIntStatus(ADC0_BASE, SALT_ADC_SEQUENCER, false)) {}
+            ADCSequenceDataGet(ADC0_BASE, SALT_ADC_SEQUENCER, &sample);
+            block[i] = (sample << 24) ^ SysTickValueGet();
+        }
+        SHA256_Compress(state, block);
+    }
+    
+    SysTickDisable();
+    ADCSequenceDisable(ADC0_BASE, SALT_ADC_SEQUENCER);
+    for (uint8_t i = 0; i < PIN_HASH_SALT_WORDS; i++)
+    {
+        salt[i] = state[i];
+    }
+}
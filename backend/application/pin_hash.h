@@ -0,0 +1,104 @@
+/******************************************************************************
+ * File: pin_hash.h
+ * Module: PIN Hash (Application Layer)
+ * Description: Salted PIN hash with a calibrated cost (PBKDF2-HMAC-SHA256)
+ ******************************************************************************/
+
+#ifndef PIN_HASH_H_
+#define PIN_HASH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sha256.h"
+
+/******************************************************************************
+ *                              Definitions                                    *
+ ******************************************************************************/
+
+/*
+ * Time one hash should take. PinHash_Calibrate turns this into an
+ * iteration count on the running clock. AUTH, INIT_PASSWORD,
+ * CHANGE_PASSWORD and ADD_USER each hash once and block the main loop for
+ * that long.
+ */
+#ifndef PIN_HASH_BUDGET_US
+#define PIN_HASH_BUDGET_US          100000UL
+#endif
+
+/* Iteration count limits, whatever the calibration measures */
+#ifndef PIN_HASH_MIN_ITERATIONS
+#define PIN_HASH_MIN_ITERATIONS     64UL
+#endif
+#define PIN_HASH_MAX_ITERATIONS     1048576UL
+
+/* Iterations timed by PinHash_Calibrate (about 8 ms at 16 MHz) */
+#define PIN_HASH_CALIBRATION_ITERATIONS 32
+
+#define PIN_HASH_SALT_WORDS         2
+
+/******************************************************************************
+ *                           Type Definitions                                  *
+ ******************************************************************************/
+
+/* Device-wide: every stored hash depends on both values */
+typedef struct {
+    uint32_t salt[PIN_HASH_SALT_WORDS];
+    uint32_t iterations;
+} PinHash_Params_t;
+
+/******************************************************************************
+ *                        Function Prototypes                                  *
+ ******************************************************************************/
+
+/*
+ * PinHash_Setup
+ * Sets the salt and iteration count used by PinHash_Hash. Until it is
+ * called they are zero and PIN_HASH_MIN_ITERATIONS.
+ */
+void PinHash_Setup(const PinHash_Params_t *params);
+
+void PinHash_GetParams(PinHash_Params_t *params);
+
+/*
+ * PinHash_Hash
+ * First word of PBKDF2-HMAC-SHA256(PIN as 4 bytes big-endian, salt as 8
+ * bytes big-endian, iterations). The result is never 0xFFFFFFFF, which is
+ * the erased value.
+ */
+uint32_t PinHash_Hash(uint32_t pin);
+
+/*
+ * PinHash_Equal
+ * Compares two hashes without branching on their bits.
+ */
+bool PinHash_Equal(uint32_t a, uint32_t b);
+
+/*
+ * PinHash_Calibrate
+ * Times PIN_HASH_CALIBRATION_ITERATIONS with SysTick and scales the result
+ * to budgetUs at SysCtlClockGet(). Run it at boot before interrupts are
+ * enabled, so that nothing else is timed with it.
+ *
+ * Return:
+ *   Iteration count, clamped to PIN_HASH_MIN/MAX_ITERATIONS
+ */
+uint32_t PinHash_Calibrate(uint32_t budgetUs);
+
+/*
+ * PinHash_NewSalt
+ * Hashes temperature sensor readings (ADC0, sequencer 3) and SysTick
+ * timestamps into a fresh salt. The salt only has to differ between
+ * devices. It does not have to be secret.
+ */
+void PinHash_NewSalt(uint32_t salt[PIN_HASH_SALT_WORDS]);
+
+/*
+ * PinHash_Pbkdf2
+ * PBKDF2-HMAC-SHA256, first output block only. passwordLen is at most 64
+ * and saltLen at most 51, which keeps every HMAC input to one block.
+ */
+void PinHash_Pbkdf2(const uint8_t *password, uint8_t passwordLen,
+                    const uint8_t *salt, uint8_t saltLen,
+                    uint32_t iterations, uint32_t digest[SHA256_STATE_WORDS]);
+
+#endif /* PIN_HASH_H_ */
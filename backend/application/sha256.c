@@ -0,0 +1,83 @@
+/******************************************************************************
+ * File: sha256.c
+ * Module: SHA-256 (Application Layer)
+ * Description: SHA-256 compression function for the PIN hash
+ ******************************************************************************/
+
+#include "sha256.h"
+
+#define ROTR(x, n)      (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const uint32_t sha256_k[64] =
+{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+void SHA256_Init(uint32_t state[SHA256_STATE_WORDS])
+{
+    state[0] = 0x6A09E667;
+    state[1] = 0xBB67AE85;
+    state[2] = 0x3C6EF372;
+    state[3] = 0xA54FF53A;
+    state[4] = 0x510E527F;
+    state[5] = 0x9B05688C;
+    state[6] = 0x1F83D9AB;
+    state[7] = 0x5BE0CD19;
+}
+
+/* The message schedule is kept as a 16-word ring, so the whole
+ * compression needs 64 bytes of stack for it instead of 256 */
+void SHA256_Compress(uint32_t state[SHA256_STATE_WORDS],
+                     const uint32_t block[SHA256_BLOCK_WORDS])
+{
+    uint32_t w[SHA256_BLOCK_WORDS];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (uint8_t i = 0; i < 64; i++)
+    {
+        uint32_t t1;
+        uint32_t t2;
+        
+        if (i < 16)
+        {
+            w[i] = block[i];
+        }
+        else
+        {
+            uint32_t w15 = w[(i - 15) & 15];
+            uint32_t w2 = w[(i - 2) & 15];
+            w[i & 15] += (ROTR(w15, 7) ^ ROTR(w15, 18) ^ (w15 >> 3)) +
+                         w[(i - 7) & 15] +
+                         (ROTR(w2, 17) ^ ROTR(w2, 19) ^ (w2 >> 10));
+        }
+        
+        t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) +
+             sha256_k[i] + w[i & 15];
+        t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
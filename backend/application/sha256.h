@@ -0,0 +1,30 @@
+/******************************************************************************
+ * File: sha256.h
+ * Module: SHA-256 (Application Layer)
+ * Description: SHA-256 compression function for the PIN hash
+ ******************************************************************************/
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+
+#define SHA256_STATE_WORDS  8
+#define SHA256_BLOCK_WORDS  16
+
+/**
+ * @brief Load the SHA-256 initial hash value
+ * @param state Chaining state to reset
+ */
+void SHA256_Init(uint32_t state[SHA256_STATE_WORDS]);
+
+/**
+ * @brief Fold one 64-byte block into the state
+ * @param state Chaining state
+ * @param block Message block as 16 big-endian words; the caller does the
+ *              padding, so short fixed-size messages need no byte buffer
+ */
+void SHA256_Compress(uint32_t state[SHA256_STATE_WORDS],
+                     const uint32_t block[SHA256_BLOCK_WORDS]);
+
+#endif /* SHA256_H */
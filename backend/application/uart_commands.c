@@ -7,10 +7,16 @@
 #include "uart_commands.h"
 #include "uart_protocol.h"
 #include "eeprom_handler.h"
+#include "credentials.h"
+#include "pin_hash.h"
 #include "buzzer_service.h"
 #include "door_controller.h"
+#include "../MCAL/uart.h"
 #include <stddef.h>
 
+/* Entries per CMD_LIST_USERS response: as many as fit a v2 frame */
+#define UART_LIST_MAX_USERS   ((UART_MAX_LEN - UART_V2_RSP_OVERHEAD) / CMD_LIST_ENTRY_LEN)
+
 /*===========================================================================
  * Helper: Convert 5 ASCII digits to uint32
  *===========================================================================*/
@@ -26,6 +32,58 @@ static uint32_t ascii_to_u32(const uint8_t *p, uint8_t len)
     return v;
 }
 
+static bool all_digits(const uint8_t *p, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+    }
+    return true;
+}
+
+/*===========================================================================
+ * Configuration Write Responses
+ *===========================================================================*/
+static uint8_t commit_mode = CMD_COMMIT_MODE_DEFAULT;
+
+void CMD_SetCommitMode(uint8_t mode)
+{
+    commit_mode = mode;
+}
+
+/* Commit finished for a held response; tag = CMD << 16 | request tag */
+static void on_committed(int result, uint32_t tag)
+{
+    UART_Protocol_SendResponseTo((UART_ReqTag_t)tag, (uint8_t)(tag >> 16),
+                                 (result == STATUS_OK) ? UART_STATUS_OK : UART_STATUS_ERROR,
+                                 NULL, 0);
+}
+
+/* Answer a write of a configuration key. In durable mode the response is
+ * held until eeprom_handler_process has committed the key; with no waiter
+ * slot free the commit runs here instead. */
+static void respond_after_write(uint8_t cmd, uint8_t key, int result)
+{
+    if (result == STATUS_OK && commit_mode == CMD_COMMIT_DURABLE)
+    {
+        uint32_t tag = ((uint32_t)cmd << 16) | UART_Protocol_CurrentRequest();
+        
+        result = notify_when_durable(key, on_committed, tag);
+        if (result == STATUS_PENDING)
+        {
+            return;
+        }
+        if (result != STATUS_OK)
+        {
+            result = eeprom_handler_flush();
+        }
+    }
+    
+    UART_Protocol_SendResponse(cmd, (result == STATUS_OK) ? UART_STATUS_OK : UART_STATUS_ERROR,
+                               NULL, 0);
+}
+
 /*===========================================================================
  * Command Handlers
  *===========================================================================*/
@@ -33,18 +91,15 @@ static uint32_t ascii_to_u32(const uint8_t *p, uint8_t len)
  /* CMD 0x01: Initialize Password */
 void CMD_InitPassword(uint8_t *buf, uint8_t len)
 {
-    uint8_t status = UART_STATUS_ERROR;
+    int result = STATUS_ERROR;
     
     if (len == 6)  /* CMD(1) + 5 digits */
     {
         uint32_t pw = ascii_to_u32(&buf[1], 5);
-        if (initialize_password(pw) == STATUS_OK)
-        {
-            status = UART_STATUS_OK;
-        }
+        result = initialize_password(pw);
     }
     
-    UART_Protocol_SendResponse(CMD_INIT_PASSWORD, status, NULL, 0);
+    respond_after_write(CMD_INIT_PASSWORD, CONFIG_KEY_PASSWORD_HASH, result);
 }
 
 /* CMD 0x02: Authenticate */
@@ -56,8 +111,15 @@ void CMD_Auth(uint8_t *buf, uint8_t len)
     {
         uint8_t mode = buf[1];
         uint32_t pw = ascii_to_u32(&buf[2], 5);
+        uint8_t flags = 0;
+        
+        int result = authenticate(pw, &flags);
         
-        int result = authenticate(pw);
+        /* A check-only auth gates the menu: users need the admin flag */
+        if (result == STATUS_OK && mode != 0x01 && !(flags & CREDENTIALS_FLAG_ADMIN))
+        {
+            result = STATUS_AUTH_FAIL;
+        }
         
         if (result == STATUS_OK)
         {
@@ -90,7 +152,7 @@ void CMD_Auth(uint8_t *buf, uint8_t len)
 /* CMD 0x03: Set Timeout */
 void CMD_SetTimeout(uint8_t *buf, uint8_t len)
 {
-    uint8_t status = UART_STATUS_ERROR;
+    int result = STATUS_ERROR;
     
     if (len == 2)  /* CMD(1) + SECONDS(1) */
     {
@@ -99,31 +161,25 @@ void CMD_SetTimeout(uint8_t *buf, uint8_t len)
         /* Validate range 5-30 */
         if (seconds >= 5 && seconds <= 30)
         {
-            if (change_auto_timeout(seconds) == STATUS_OK)
-            {
-                status = UART_STATUS_OK;
-            }
+            result = change_auto_timeout(seconds);
         }
     }
     
-    UART_Protocol_SendResponse(CMD_SET_TIMEOUT, status, NULL, 0);
+    respond_after_write(CMD_SET_TIMEOUT, CONFIG_KEY_TIMEOUT, result);
 }
 
 /* CMD 0x04: Change Password */
 void CMD_ChangePassword(uint8_t *buf, uint8_t len)
 {
-    uint8_t status = UART_STATUS_ERROR;
+    int result = STATUS_ERROR;
     
     if (len == 6)  /* CMD(1) + 5 digits */
     {
         uint32_t new_pw = ascii_to_u32(&buf[1], 5);
-        if (change_password(new_pw) == STATUS_OK)
-        {
-            status = UART_STATUS_OK;
-        }
+        result = change_password(new_pw);
     }
     
-    UART_Protocol_SendResponse(CMD_CHANGE_PASSWORD, status, NULL, 0);
+    respond_after_write(CMD_CHANGE_PASSWORD, CONFIG_KEY_PASSWORD_HASH, result);
 }
 
 /* CMD 0x05: Get Timeout 
@@ -150,3 +206,113 @@ void CMD_GetTimeout(uint8_t *buf, uint8_t len)
     UART_Protocol_SendResponse(CMD_GET_TIMEOUT, status, &timeout_val, 
                                (status == UART_STATUS_OK) ? 1 : 0);
 }
+
+/*===========================================================================
+ * User Table Commands
+ *===========================================================================*/
+
+static uint16_t be16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/* Send OK, or an error carrying the CREDENTIALS_* code */
+static void respond_credentials(uint8_t cmd, int result)
+{
+    uint8_t code = (uint8_t)result;
+    
+    if (result == CREDENTIALS_OK)
+    {
+        UART_Protocol_SendResponse(cmd, UART_STATUS_OK, NULL, 0);
+    }
+    else
+    {
+        UART_Protocol_SendResponse(cmd, UART_STATUS_ERROR, &code, 1);
+    }
+}
+
+/* CMD 0x07: Set Clock */
+void CMD_SetClock(uint8_t *buf, uint8_t len)
+{
+    uint8_t status = UART_STATUS_ERROR;
+    
+    if (len == 5)  /* CMD(1) + SECONDS(4) */
+    {
+        Credentials_SetClock(((uint32_t)be16(&buf[1]) << 16) | be16(&buf[3]));
+        status = UART_STATUS_OK;
+    }
+    
+    UART_Protocol_SendResponse(CMD_SET_CLOCK, status, NULL, 0);
+}
+
+/* CMD 0x08: Add User */
+void CMD_AddUser(uint8_t *buf, uint8_t len)
+{
+    Credentials_User_t user;
+    
+    if ((len != 9 && len != 13) ||  /* CMD(1) + ID(2) + FLAGS(1) + 5 digits [+ WINDOW(4)] */
+        !all_digits(&buf[4], 5))     /* Not read as PIN 00000 */
+    {
+        respond_credentials(CMD_ADD_USER, CREDENTIALS_ERROR);
+        return;
+    }
+    
+    user.user_id = be16(&buf[1]);
+    user.flags = buf[3];
+    user.valid_from = (len == 13) ? be16(&buf[9]) : 0;
+    user.valid_until = (len == 13) ? be16(&buf[11]) : 0;
+    respond_credentials(CMD_ADD_USER, Credentials_Add(&user, PinHash_Hash(ascii_to_u32(&buf[4], 5))));
+}
+
+/* CMD 0x09: Remove User */
+void CMD_RemoveUser(uint8_t *buf, uint8_t len)
+{
+    if (len != 3)  /* CMD(1) + ID(2) */
+    {
+        respond_credentials(CMD_REMOVE_USER, CREDENTIALS_ERROR);
+        return;
+    }
+    respond_credentials(CMD_REMOVE_USER, Credentials_Remove(be16(&buf[1])));
+}
+
+/* CMD 0x0A: List Users */
+void CMD_ListUsers(uint8_t *buf, uint8_t len)
+{
+    Credentials_User_t users[UART_LIST_MAX_USERS];
+    uint8_t data[UART_LIST_MAX_USERS * CMD_LIST_ENTRY_LEN];
+    uint8_t pos = 0;
+    uint16_t count;
+    
+    if (len != 3)  /* CMD(1) + ID(2) */
+    {
+        UART_Protocol_SendResponse(CMD_LIST_USERS, UART_STATUS_ERROR, NULL, 0);
+        return;
+    }
+    
+    count = Credentials_List(be16(&buf[1]), users, UART_LIST_MAX_USERS);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        data[pos++] = (uint8_t)(users[i].user_id >> 8);
+        data[pos++] = (uint8_t)users[i].user_id;
+        data[pos++] = users[i].flags;
+        data[pos++] = (uint8_t)(users[i].valid_from >> 8);
+        data[pos++] = (uint8_t)users[i].valid_from;
+        data[pos++] = (uint8_t)(users[i].valid_until >> 8);
+        data[pos++] = (uint8_t)users[i].valid_until;
+    }
+    UART_Protocol_SendResponse(CMD_LIST_USERS, UART_STATUS_OK, data, pos);
+}
+
+/* CMD 0x0B: Set Commit Mode */
+void CMD_CommitMode(uint8_t *buf, uint8_t len)
+{
+    uint8_t status = UART_STATUS_ERROR;
+    
+    if (len == 2 && (buf[1] == CMD_COMMIT_ACCEPTED || buf[1] == CMD_COMMIT_DURABLE))
+    {
+        CMD_SetCommitMode(buf[1]);
+        status = UART_STATUS_OK;
+    }
+    
+    UART_Protocol_SendResponse(CMD_COMMIT_MODE, status, NULL, 0);
+}
@@ -15,6 +15,33 @@
 #define CMD_SET_TIMEOUT       0x03
 #define CMD_CHANGE_PASSWORD   0x04
 #define CMD_GET_TIMEOUT       0x05
+#define CMD_SET_CLOCK         0x07
+#define CMD_ADD_USER          0x08
+#define CMD_REMOVE_USER       0x09
+#define CMD_LIST_USERS        0x0A
+#define CMD_COMMIT_MODE       0x0B
+
+/* Bytes per entry in a CMD_LIST_USERS response:
+ * [ID_H][ID_L][FLAGS][FROM_H][FROM_L][UNTIL_H][UNTIL_L] */
+#define CMD_LIST_ENTRY_LEN    7
+
+/* When a configuration write (0x01, 0x03, 0x04) is answered:
+ *   ACCEPTED - as soon as the RAM copy is updated; the EEPROM commit runs
+ *              later from the main loop and a reset before it loses the change
+ *   DURABLE  - once the record is committed and verified in EEPROM
+ * Selected with CMD_COMMIT_MODE; back to CMD_COMMIT_MODE_DEFAULT at reset */
+#define CMD_COMMIT_ACCEPTED   0
+#define CMD_COMMIT_DURABLE    1
+
+#ifndef CMD_COMMIT_MODE_DEFAULT
+#define CMD_COMMIT_MODE_DEFAULT CMD_COMMIT_ACCEPTED
+#endif
+
+/**
+ * @brief Select when configuration writes are answered
+ * @param mode CMD_COMMIT_ACCEPTED or CMD_COMMIT_DURABLE
+ */
+void CMD_SetCommitMode(uint8_t mode);
 
 /**
  * @brief CMD 0x01: Initialize Password
@@ -41,4 +68,40 @@ void CMD_ChangePassword(uint8_t *buf, uint8_t len);
  */
 void CMD_GetTimeout(uint8_t *buf, uint8_t len);
 
+/**
+ * @brief CMD 0x07: Set Clock
+ * @note [CMD][SECONDS since 1970, 4 bytes big-endian]; drives the user
+ *       validity windows
+ */
+void CMD_SetClock(uint8_t *buf, uint8_t len);
+
+/**
+ * @brief CMD 0x08: Add (or replace) User
+ * @note [CMD][ID_H][ID_L][FLAGS][5 digits] with an optional
+ *       [FROM_H][FROM_L][UNTIL_H][UNTIL_L] validity window in days.
+ *       Answered once the entry is in EEPROM; an error carries the
+ *       CREDENTIALS_* code as its data byte.
+ */
+void CMD_AddUser(uint8_t *buf, uint8_t len);
+
+/**
+ * @brief CMD 0x09: Remove User
+ * @note [CMD][ID_H][ID_L]
+ */
+void CMD_RemoveUser(uint8_t *buf, uint8_t len);
+
+/**
+ * @brief CMD 0x0A: List Users
+ * @note [CMD][ID_H][ID_L] answers with the users whose id is at least ID,
+ *       in id order, CMD_LIST_ENTRY_LEN bytes each, as many as fit in one
+ *       frame. Page on with the last id + 1; no data means the end.
+ */
+void CMD_ListUsers(uint8_t *buf, uint8_t len);
+
+/**
+ * @brief CMD 0x0B: Set Commit Mode
+ * @note [CMD][MODE], MODE = CMD_COMMIT_ACCEPTED or CMD_COMMIT_DURABLE
+ */
+void CMD_CommitMode(uint8_t *buf, uint8_t len);
+
 #endif /* UART_COMMANDS_H */
@@ -27,13 +27,9 @@ void UART_Handler_Init(void)
 
 void UART_ProcessPending(void)
 {
-    /* Check if a packet is ready */
-    if (UART_Driver_IsPacketReady())
+    /* Drain every queued packet so bursts are handled back-to-back */
+    while (UART_Driver_GetPacket(packet_buf, &packet_len))
     {
-        /* Get the packet */
-        UART_Driver_GetPacket(packet_buf, &packet_len);
-        
-        /* Process it */
         UART_Protocol_HandlePacket(packet_buf, packet_len);
     }
 }
@@ -15,7 +15,7 @@
 void UART_Handler_Init(void);
 
 /**
- * @brief Process pending UART packets (call from main loop)
+ * @brief Process all queued UART packets (call from main loop)
  */
 void UART_ProcessPending(void);
 
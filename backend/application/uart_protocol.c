@@ -6,27 +6,95 @@
 
 #include "uart_protocol.h"
 #include "uart_commands.h"
+#include "crc16.h"
 #include "../MCAL/uart.h"
 #include "../HAL/status_led.h"
+#include <stdbool.h>
 #include <stddef.h>
 
+/*===========================================================================
+ * Request Context
+ *
+ * Command handlers only know [CMD][PAYLOAD]; the framing of the request
+ * being handled is kept here so SendResponse can answer in kind.
+ *===========================================================================*/
+static uint8_t req_version = 1;
+static uint8_t req_seq = 0;
+
+/* Set by the v2 hello. From then on bare v1 packets are ignored: a v2
+ * frame that lost its SOF can resynchronize on a 0x7E inside it, and the
+ * fragment would otherwise run as an unchecked v1 command. */
+static bool v2_peer = false;
+
+/*===========================================================================
+ * Duplicate Response Cache (v2 only)
+ *
+ * A request gets its entry when it is dispatched, with len = RSP_PENDING
+ * until its response is sent. A response can be held back (durable-mode
+ * writes), and a retransmission in that time must not run the command
+ * again.
+ *===========================================================================*/
+#define RSP_PENDING     0
+
+typedef struct {
+    bool    valid;
+    uint8_t seq;
+    uint8_t cmd;
+    uint8_t len;            /* RSP_PENDING while the response is outstanding */
+    uint8_t body[UART_MAX_LEN];
+} rsp_cache_t;
+
+static rsp_cache_t rsp_cache[UART_V2_CACHE_DEPTH];
+static uint8_t rsp_cache_newest = 0;     /* Most advanced SEQ cached */
+
+static UART_ProtoStats_t proto_stats;
+
+static void UART_Protocol_Dispatch(uint8_t *buf, uint8_t len);
+static bool UART_Protocol_ReplayCached(uint8_t seq, uint8_t cmd);
+static rsp_cache_t *UART_Protocol_CacheSlot(uint8_t seq, uint8_t cmd);
+static void UART_Protocol_CacheResponse(const uint8_t *body, uint8_t len);
+static void UART_Protocol_ClearCache(uint8_t seq);
+
 void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len)
 {
-    uint8_t len = 2 + data_len;  /* CMD + STATUS + data */
+    uint8_t body[UART_MAX_LEN];
+    uint8_t pos = 0;
+    uint8_t max_data = (req_version == 2) ? (UART_MAX_LEN - UART_V2_RSP_OVERHEAD)
+                                          : (UART_MAX_LEN - 2);
     
-    UART_Driver_SendByte(UART_SOF_TX);   /* 0xFE */
-    UART_Driver_SendByte(len);
-    UART_Driver_SendByte(cmd);
-    UART_Driver_SendByte(status);
+    if (data_len > max_data)
+    {
+        data_len = max_data;
+    }
+    
+    if (req_version == 2)
+    {
+        body[pos++] = UART_V2_MARKER;
+        body[pos++] = req_seq;
+    }
+    body[pos++] = cmd;
+    body[pos++] = status;
     
     for (uint8_t i = 0; i < data_len; i++)
     {
-        UART_Driver_SendByte(data[i]);
+        body[pos++] = data[i];
     }
     
-    UART_Driver_WaitTxDone();
+    if (req_version == 2)
+    {
+        uint8_t len = (uint8_t)(pos + 2);   /* LEN as sent, incl. the CRC */
+        uint16_t crc = CRC16_Update(CRC16_INIT, &len, 1);
+        crc = CRC16_Update(crc, body, pos);
+        body[pos++] = (uint8_t)(crc >> 8);
+        body[pos++] = (uint8_t)(crc & 0xFF);
+        UART_Protocol_CacheResponse(body, pos);
+    }
     
-    /* Blink to show response sent */
+    /* Framed by the driver and queued for the TX interrupt - returns
+     * without waiting for the wire */
+    UART_Driver_SendFrame(body, pos);
+    
+    /* Blink to show response sent (queued, does not block) */
     if (status == UART_STATUS_OK)
     {
         LED_BlinkGreen(2);  /* Green = OK */
@@ -37,41 +105,238 @@ void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint
     }
 }
 
+UART_ReqTag_t UART_Protocol_CurrentRequest(void)
+{
+    return (UART_ReqTag_t)((req_version << 8) | req_seq);
+}
+
+void UART_Protocol_SendResponseTo(UART_ReqTag_t req, uint8_t cmd, uint8_t status,
+                                  uint8_t *data, uint8_t data_len)
+{
+    uint8_t version = req_version;
+    uint8_t seq = req_seq;
+    
+    req_version = (uint8_t)(req >> 8);
+    req_seq = (uint8_t)req;
+    UART_Protocol_SendResponse(cmd, status, data, data_len);
+    req_version = version;
+    req_seq = seq;
+}
+
 void UART_Protocol_HandlePacket(uint8_t *buf, uint8_t len)
 {
     if (len == 0) return;
     
+    if (buf[0] != UART_V2_MARKER)
+    {
+        if (v2_peer)
+        {
+            proto_stats.v1_ignored++;
+            return;
+        }
+        proto_stats.v1_frames++;
+        req_version = 1;
+        UART_Protocol_Dispatch(buf, len);
+        return;
+    }
+    
+    /* v2: [MARKER][SEQ][CMD][PAYLOAD...][CRC_H][CRC_L], CRC from LEN on */
+    if (len < UART_V2_REQ_OVERHEAD)
+    {
+        proto_stats.crc_errors++;
+        return;
+    }
+    
+    uint16_t crc = CRC16_Update(CRC16_INIT, &len, 1);
+    crc = CRC16_Update(crc, buf, (uint8_t)(len - 2));
+    if (crc != (uint16_t)((buf[len - 2] << 8) | buf[len - 1]))
+    {
+        /* Drop silently - the frontend retransmits on timeout */
+        proto_stats.crc_errors++;
+        return;
+    }
+    
+    proto_stats.v2_frames++;
+    req_version = 2;
+    req_seq = buf[1];
+    
+    if (buf[2] == UART_CMD_HELLO)
+    {
+        uint8_t version = UART_PROTOCOL_VERSION;
+        v2_peer = true;
+        UART_Protocol_ClearCache(req_seq);
+        UART_Protocol_SendResponse(UART_CMD_HELLO, UART_STATUS_OK, &version, 1);
+    }
+    else if (!UART_Protocol_ReplayCached(req_seq, buf[2]))
+    {
+        rsp_cache_t *e = UART_Protocol_CacheSlot(req_seq, buf[2]);
+        e->len = RSP_PENDING;
+        UART_Protocol_Dispatch(&buf[2], (uint8_t)(len - UART_V2_REQ_OVERHEAD + 1));
+    }
+    
+    req_version = 1;
+}
+
+void UART_Protocol_GetStats(UART_ProtoStats_t *stats)
+{
+    *stats = proto_stats;
+}
+
+/*===========================================================================
+ * Private Functions
+ *===========================================================================*/
+
+/* Run a command handler on [CMD][PAYLOAD...] */
+static void UART_Protocol_Dispatch(uint8_t *buf, uint8_t len)
+{
     uint8_t cmd = buf[0];
     
-    LED_GreenOn();  /* Green LED on while processing */
+    /* Green LED on while processing, unless a blink is still playing */
+    if (!LED_IsPatternActive())
+    {
+        LED_GreenOn();
+    }
     
     switch (cmd)
     {
         case CMD_INIT_PASSWORD:
             CMD_InitPassword(buf, len);
             break;
-            
+        
         case CMD_AUTH:
             CMD_Auth(buf, len);
             break;
-            
+        
         case CMD_SET_TIMEOUT:
             CMD_SetTimeout(buf, len);
             break;
-            
+        
         case CMD_CHANGE_PASSWORD:
             CMD_ChangePassword(buf, len);
             break;
-            
+        
         case CMD_GET_TIMEOUT:
             CMD_GetTimeout(buf, len);
             break;
-            
+        
+        case CMD_SET_CLOCK:
+            CMD_SetClock(buf, len);
+            break;
+        
+        case CMD_ADD_USER:
+            CMD_AddUser(buf, len);
+            break;
+        
+        case CMD_REMOVE_USER:
+            CMD_RemoveUser(buf, len);
+            break;
+        
+        case CMD_LIST_USERS:
+            CMD_ListUsers(buf, len);
+            break;
+        
+        case CMD_COMMIT_MODE:
+            CMD_CommitMode(buf, len);
+            break;
+        
         default:
             /* Unknown command - send error response */
             UART_Protocol_SendResponse(cmd, UART_STATUS_ERROR, NULL, 0);
             break;
     }
     
-    LED_Off();
+    /* Every path above sends a response, now or (configuration writes in
+     * durable commit mode) once the EEPROM commit finished. The response's
+     * blink pattern turns the LED off when it finishes */
+}
+
+/*
+ * Resend the cached response for a retransmitted request. The frontend
+ * retries with the same SEQ when a response is lost, and commands such as
+ * CMD_CHANGE_PASSWORD or CMD_AUTH (door open) must not run twice. While
+ * the response is still outstanding the duplicate is dropped; the response
+ * answers both when it is sent.
+ */
+static bool UART_Protocol_ReplayCached(uint8_t seq, uint8_t cmd)
+{
+    for (uint8_t i = 0; i < UART_V2_CACHE_DEPTH; i++)
+    {
+        rsp_cache_t *e = &rsp_cache[i];
+        if (e->valid && e->seq == seq && e->cmd == cmd)
+        {
+            proto_stats.duplicates++;
+            if (e->len != RSP_PENDING)
+            {
+                UART_Driver_SendFrame(e->body, e->len);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Entry for (seq, cmd): its own if it has one, else the entry furthest
+ * behind the most advanced SEQ. A retransmission can make an older SEQ
+ * execute after newer ones, so plain FIFO order could evict a response the
+ * frontend is still waiting for.
+ */
+static rsp_cache_t *UART_Protocol_CacheSlot(uint8_t seq, uint8_t cmd)
+{
+    rsp_cache_t *e = &rsp_cache[0];
+    uint8_t oldest = 0;
+    
+    if ((uint8_t)(seq - rsp_cache_newest) < 0x80)
+    {
+        rsp_cache_newest = seq;
+    }
+    
+    for (uint8_t i = 0; i < UART_V2_CACHE_DEPTH; i++)
+    {
+        if (rsp_cache[i].valid && rsp_cache[i].seq == seq && rsp_cache[i].cmd == cmd)
+        {
+            return &rsp_cache[i];
+        }
+    }
+    
+    for (uint8_t i = 0; i < UART_V2_CACHE_DEPTH; i++)
+    {
+        uint8_t age = (uint8_t)(rsp_cache_newest - rsp_cache[i].seq);
+        if (!rsp_cache[i].valid)
+        {
+            e = &rsp_cache[i];
+            break;
+        }
+        if (age >= oldest)
+        {
+            oldest = age;
+            e = &rsp_cache[i];
+        }
+    }
+    
+    e->valid = true;
+    e->seq = seq;
+    e->cmd = cmd;
+    return e;
+}
+
+static void UART_Protocol_CacheResponse(const uint8_t *body, uint8_t len)
+{
+    rsp_cache_t *e = UART_Protocol_CacheSlot(body[1], body[2]);
+    
+    e->len = len;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        e->body[i] = body[i];
+    }
+}
+
+/* Forget all responses; SEQ numbering restarts at seq */
+static void UART_Protocol_ClearCache(uint8_t seq)
+{
+    for (uint8_t i = 0; i < UART_V2_CACHE_DEPTH; i++)
+    {
+        rsp_cache[i].valid = false;
+    }
+    rsp_cache_newest = seq;
 }
@@ -18,8 +18,47 @@
 #define UART_STATUS_ERROR     0x01
 #define UART_STATUS_AUTH_FAIL 0x02
 
+/*
+ * Protocol v2 framing (v1 frames are still accepted and answered in v1):
+ *   Request:  [0x7E][LEN][0xA5][SEQ][CMD][PAYLOAD...][CRC_H][CRC_L]
+ *   Response: [0xFE][LEN][0xA5][SEQ][CMD][STATUS][DATA...][CRC_H][CRC_L]
+ * LEN counts the bytes after itself; the CRC-16 covers LEN up to the byte
+ * before the CRC. SEQ is echoed so the frontend can keep several requests
+ * in flight and match responses out of order. A v1 command byte is never
+ * 0xA5, and a v1 backend answers the marker as an unknown command, which
+ * is how the frontend falls back.
+ */
+#define UART_PROTOCOL_VERSION   2
+#define UART_V2_MARKER          0xA5
+#define UART_V2_REQ_OVERHEAD    5       /* marker + seq + cmd + crc16 */
+#define UART_V2_RSP_OVERHEAD    6       /* marker + seq + cmd + status + crc16 */
+
+/* Version negotiation: v2-framed, answered OK with [UART_PROTOCOL_VERSION].
+ * Also clears the duplicate-response cache (frontend restarted its SEQ)
+ * and stops v1 frames from being accepted until the next reset. */
+#define UART_CMD_HELLO          0x06
+
+/* Responses remembered so a retransmitted request (same SEQ and CMD) is
+ * answered again without re-running the command. Must be at least the
+ * frontend's UART_WINDOW_SIZE. */
+#define UART_V2_CACHE_DEPTH     4
+
+/* Protocol statistics */
+typedef struct {
+    uint32_t v1_frames;         /* Legacy frames handled */
+    uint32_t v1_ignored;        /* v1 frames dropped after a v2 hello */
+    uint32_t v2_frames;         /* v2 frames handled (CRC OK) */
+    uint32_t crc_errors;        /* v2 frames dropped for bad CRC/length */
+    uint32_t duplicates;        /* Retransmissions answered from the cache */
+} UART_ProtoStats_t;
+
+/* Identifies a request (framing version << 8 | SEQ) so its response can be
+ * sent after the handler has returned */
+typedef uint16_t UART_ReqTag_t;
+
 /**
  * @brief Send a response packet
+ * @note Framed as v1 or v2 to match the request being handled
  * @param cmd Command ID
  * @param status Status code
  * @param data Response data (can be NULL)
@@ -27,11 +66,38 @@
  */
 void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len);
 
+/**
+ * @brief Get the tag of the request being handled
+ * @note Only meaningful inside a command handler
+ * @return Tag to pass to UART_Protocol_SendResponseTo later
+ */
+UART_ReqTag_t UART_Protocol_CurrentRequest(void);
+
+/**
+ * @brief Send a deferred response to an earlier request
+ * @note Framed and cached as if sent from that request's handler
+ * @param req Tag from UART_Protocol_CurrentRequest
+ * @param cmd Command ID
+ * @param status Status code
+ * @param data Response data (can be NULL)
+ * @param data_len Length of response data
+ */
+void UART_Protocol_SendResponseTo(UART_ReqTag_t req, uint8_t cmd, uint8_t status,
+                                  uint8_t *data, uint8_t data_len);
+
 /**
  * @brief Process a received packet (dispatches to command handlers)
+ * @note v2 frames are CRC-checked and unwrapped, so handlers always see
+ *       [CMD][PAYLOAD...] regardless of the framing version
  * @param buf Packet buffer
  * @param len Packet length
  */
 void UART_Protocol_HandlePacket(uint8_t *buf, uint8_t len);
 
+/**
+ * @brief Get protocol statistics
+ * @param stats Destination for a snapshot of the counters
+ */
+void UART_Protocol_GetStats(UART_ProtoStats_t *stats);
+
 #endif /* UART_PROTOCOL_H */
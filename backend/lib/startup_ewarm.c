@@ -45,7 +45,6 @@ static void FaultISR(void);
 static void IntDefaultHandler(void);
 extern void SystickHandler(void);
 extern void Timer0A_Handler(void);
-extern void Timer1A_Handler(void);
 
 //*****************************************************************************
 //
@@ -119,10 +118,10 @@ __root const uVectorEntry __vector_table[] @ ".intvec" =
     IntDefaultHandler,                      // ADC Sequence 2
     IntDefaultHandler,                      // ADC Sequence 3
     IntDefaultHandler,                      // Watchdog timer
-    Timer0A_Handler,                        // Timer 0 subtimer A (Buzzer Service - full 32-bit)
+    Timer0A_Handler,                        // Timer 0 subtimer A (Soft timer tick - full 32-bit)
     IntDefaultHandler,                      // Timer 0 subtimer B (not used in full-width mode)
-    Timer1A_Handler,                        // Timer 1 subtimer A (Door Controller - full 32-bit)
-    IntDefaultHandler,                      // Timer 1 subtimer B (not used in full-width mode)
+    IntDefaultHandler,                      // Timer 1 subtimer A
+    IntDefaultHandler,                      // Timer 1 subtimer B
     IntDefaultHandler,                      // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
     IntDefaultHandler,                      // Analog Comparator 0
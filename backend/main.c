@@ -2,9 +2,11 @@
 #include <stdbool.h>
 #include "application/uart_handler.h"
 #include "application/eeprom_handler.h"
+#include "application/config_store.h"
 #include "application/buzzer_service.h"
 #include "application/door_controller.h"
 #include "HAL/motor.h"
+#include "MCAL/soft_timer.h"
 
 /* TivaWare includes */
 #include "inc/hw_memmap.h"
@@ -52,7 +54,9 @@ int main(void)
         while (1) {}
     }
     
+    eeprom_handler_init();
     set_default_auto_timeout();
+    SoftTimer_Init();
     BuzzerService_Init();
     DoorController_Init();
     UART_Handler_Init();
@@ -60,6 +64,9 @@ int main(void)
     while (1)
     {
         UART_ProcessPending();
+        SoftTimer_Process();
+        eeprom_handler_process();
+        ConfigStore_Process();
     }
 #endif
 }
@@ -1,6 +1,6 @@
 /*****************************************************************************
  * 4x4 Keypad 
- * Rows: PC4-PC7 (J4, inputs with pull-up)
+ * Rows: PC4-PC7 (J4, inputs with pull-up, falling-edge interrupts)
  * Column pins - outputs
  *    Col 0 = PB6
  *    Col 1 = PA4
@@ -8,7 +8,10 @@
  *    Col 3 = PA2
  *****************************************************************************/
 #include "keypad.h"
+#include <intrinsics.h>
 #include "../MCAL/dio.h"
+#include "../MCAL/gptimer.h"
+#include "../MCAL/systick.h"
 
 const char keypad_codes[4][4] = {
     {'1', '2', '3', 'A'},
@@ -18,8 +21,24 @@ const char keypad_codes[4][4] = {
 };
 
 #define KEYPAD_ROW_PORT  PORTC
+#define KEYPAD_ROW_MASK  0xF0   /* PC4-PC7 */
 static const uint8_t row_pins[4] = {PIN4, PIN5, PIN6, PIN7};
 
+/* The rows follow a column through the pull-ups in well under this */
+#define KEYPAD_SETTLE_US    2
+
+#define KEYPAD_QUEUE_MASK   (KEYPAD_QUEUE_SIZE - 1)
+#define KEYPAD_KEYS         16
+
+/* Whole scans covering ms, rounded up */
+#define MS_TO_SCANS(ms)     (((uint32_t)(ms) * 1000U + KEYPAD_SCAN_US - 1) / KEYPAD_SCAN_US)
+
+/* Per-key debounce states */
+#define KEY_UP              0
+#define KEY_BOUNCE_DOWN     1   /* Reads down, not yet for long enough */
+#define KEY_DOWN            2
+#define KEY_BOUNCE_UP       3   /* Reads up, not yet for long enough */
+
 typedef struct { 
     uint8_t port;
     uint8_t pin;
@@ -32,6 +51,204 @@ static const ColPin_t col_pins[4] = {
     {PORTA, PIN2}   /* Col 3 = PA2 */
 };
 
+static const Keypad_Timing_t defaultTiming = {
+    KEYPAD_DEBOUNCE_MS, KEYPAD_LONG_PRESS_MS, KEYPAD_REPEAT_DELAY_MS, KEYPAD_REPEAT_MS
+};
+
+/* Event ring: head written by the scan ISR, tail by the reader */
+static volatile Keypad_Event_t eventQueue[KEYPAD_QUEUE_SIZE];
+static volatile uint8_t eventHead = 0;
+static volatile uint8_t eventTail = 0;
+
+/* Debounce state machines, index row * 4 + col; ISR context only */
+static uint8_t keyState[KEYPAD_KEYS];
+static uint8_t keyCount[KEYPAD_KEYS];       /* Samples in a bounce state */
+static uint16_t keyHeld[KEYPAD_KEYS];       /* Scans since the press was accepted */
+static uint8_t keysActive = 0;              /* Keys not in KEY_UP */
+static bool rolloverSeen = false;
+
+/* Timing in scans */
+static uint8_t stableScans = 1;             /* Samples that must agree */
+static uint16_t longScans = 0;
+static uint16_t repeatDelayScans = 0;
+static uint16_t repeatScans = 0;
+
+static void ScanTick(void);
+
+static void SetColumns(uint8_t level)
+{
+    for (uint8_t c = 0; c < 4; c++) {
+        DIO_WritePin(col_pins[c].port, col_pins[c].pin, level);
+    }
+}
+
+/* Drive one column low at a time and read all four rows at once */
+static uint16_t ScanMatrix(void)
+{
+    uint16_t down = 0;
+    uint8_t rows;
+
+    SetColumns(HIGH);
+    for (uint8_t col = 0; col < 4; col++) {
+        DIO_WritePin(col_pins[col].port, col_pins[col].pin, LOW);
+        DelayUs(KEYPAD_SETTLE_US);
+        rows = (uint8_t)~DIO_ReadPort(KEYPAD_ROW_PORT);
+        DIO_WritePin(col_pins[col].port, col_pins[col].pin, HIGH);
+
+        for (uint8_t row = 0; row < 4; row++) {
+            if (rows & (1U << row_pins[row])) {
+                down |= (uint16_t)(1U << (row * 4 + col));
+            }
+        }
+    }
+    return down;
+}
+
+static void PushEvent(char key, uint8_t type, uint32_t timeMs)
+{
+    uint8_t next = (eventHead + 1) & KEYPAD_QUEUE_MASK;
+
+    if (next == eventTail) return;      /* Queue full - drop */
+    eventQueue[eventHead].key = key;
+    eventQueue[eventHead].type = type;
+    eventQueue[eventHead].timeMs = timeMs;
+    eventHead = next;
+}
+
+/* Idle: columns low, timer off, any row falling wakes us. A key that went
+ * down after the last scan but before the rows were unmasked left no
+ * edge, so check the levels once armed. */
+static void ArmRows(void)
+{
+    GPTimer_Stop();
+    SetColumns(LOW);
+    DelayUs(KEYPAD_SETTLE_US);
+    DIO_EnableInterrupt(KEYPAD_ROW_PORT, KEYPAD_ROW_MASK);
+
+    if ((DIO_ReadPort(KEYPAD_ROW_PORT) & KEYPAD_ROW_MASK) != KEYPAD_ROW_MASK) {
+        DIO_DisableInterrupt(KEYPAD_ROW_PORT, KEYPAD_ROW_MASK);
+        GPTimer_Start(KEYPAD_SCAN_US, ScanTick);
+    }
+}
+
+/* Two rows that share two columns could be a real rectangle of keys or
+ * three keys and a ghost; the scan cannot tell */
+static bool Ambiguous(uint16_t down)
+{
+    for (uint8_t r1 = 0; r1 < 3; r1++) {
+        for (uint8_t r2 = r1 + 1; r2 < 4; r2++) {
+            uint8_t shared = (uint8_t)((down >> (r1 * 4)) & (down >> (r2 * 4)) & 0x0F);
+            if (shared & (shared - 1)) return true;
+        }
+    }
+    return false;
+}
+
+/* Held key: long-press once, then repeats */
+static void HeldTick(uint8_t i, uint32_t now)
+{
+    char key = keypad_codes[i / 4][i % 4];
+    uint16_t held;
+
+    if (keyHeld[i] < UINT16_MAX) keyHeld[i]++;
+    held = keyHeld[i];
+
+    if (longScans != 0 && held == longScans) {
+        PushEvent(key, KEYPAD_EVENT_LONG_PRESS, now);
+    }
+    if (repeatScans != 0 && held >= repeatDelayScans &&
+        (held - repeatDelayScans) % repeatScans == 0 && held != UINT16_MAX) {
+        PushEvent(key, KEYPAD_EVENT_REPEAT, now);
+    }
+}
+
+/* One sample of one key */
+static void DebounceKey(uint8_t i, bool down, uint32_t now)
+{
+    char key = keypad_codes[i / 4][i % 4];
+
+    switch (keyState[i]) {
+        case KEY_UP:
+            if (!down) return;
+            keyState[i] = KEY_BOUNCE_DOWN;
+            keyCount[i] = 0;
+            keysActive++;
+            /* fall through */
+        case KEY_BOUNCE_DOWN:
+            if (!down) {
+                keyState[i] = KEY_UP;
+                keysActive--;
+            } else if (++keyCount[i] >= stableScans) {
+                keyState[i] = KEY_DOWN;
+                keyHeld[i] = 0;
+                PushEvent(key, KEYPAD_EVENT_PRESS, now);
+            }
+            break;
+
+        case KEY_DOWN:
+            if (down) {
+                HeldTick(i, now);
+                return;
+            }
+            keyState[i] = KEY_BOUNCE_UP;
+            keyCount[i] = 0;
+            /* fall through */
+        case KEY_BOUNCE_UP:
+            if (down) {
+                keyState[i] = KEY_DOWN;
+                HeldTick(i, now);
+            } else if (++keyCount[i] >= stableScans) {
+                keyState[i] = KEY_UP;
+                keysActive--;
+                PushEvent(key, KEYPAD_EVENT_RELEASE, now);
+            }
+            break;
+
+        default:
+            keyState[i] = KEY_UP;
+            break;
+    }
+}
+
+/* Timer1A (and first edge) context: feed every key one sample */
+static void ScanTick(void)
+{
+    uint16_t down = ScanMatrix();
+    uint32_t now = SysTick_GetMs();
+
+    if (Ambiguous(down)) {
+        /* Keys already down stay down; nothing new is believed */
+        if (!rolloverSeen) {
+            rolloverSeen = true;
+            PushEvent(0, KEYPAD_EVENT_ROLLOVER, now);
+        }
+        for (uint8_t i = 0; i < KEYPAD_KEYS; i++) {
+            if (keyState[i] == KEY_DOWN) HeldTick(i, now);
+        }
+        return;
+    }
+    rolloverSeen = false;
+
+    for (uint8_t i = 0; i < KEYPAD_KEYS; i++) {
+        if (keyState[i] != KEY_UP || (down & (1U << i))) {
+            DebounceKey(i, (down & (1U << i)) != 0, now);
+        }
+    }
+
+    if (keysActive == 0) {
+        ArmRows();
+    }
+}
+
+/* Row edge: hand over to the timer, scanning right away for latency */
+static void OnRowEdge(uint8_t pins)
+{
+    (void)pins;
+    DIO_DisableInterrupt(KEYPAD_ROW_PORT, KEYPAD_ROW_MASK);
+    GPTimer_Start(KEYPAD_SCAN_US, ScanTick);
+    ScanTick();
+}
+
 void Keypad_Init(void)
 {
     /* Configure rows (PC4-PC7) as inputs with pull-up */
@@ -40,34 +257,54 @@ void Keypad_Init(void)
         DIO_SetPUR(KEYPAD_ROW_PORT, row_pins[i], ENABLE);
     }
 
-    /* Configure columns as outputs, set HIGH */
+    /* Configure columns as outputs */
     for (uint8_t i = 0; i < 4; i++) {
         DIO_Init(col_pins[i].port, col_pins[i].pin, OUTPUT);
-        DIO_WritePin(col_pins[i].port, col_pins[i].pin, HIGH);
     }
+
+    eventHead = 0;
+    eventTail = 0;
+    for (uint8_t i = 0; i < KEYPAD_KEYS; i++) {
+        keyState[i] = KEY_UP;
+    }
+    keysActive = 0;
+    rolloverSeen = false;
+    Keypad_SetTiming(&defaultTiming);
+    GPTimer_Init();
+    DIO_SetInterrupt(KEYPAD_ROW_PORT, KEYPAD_ROW_MASK, EDGE_FALLING, OnRowEdge);
+    ArmRows();
 }
 
-char Keypad_GetKey(void)
+void Keypad_SetTiming(const Keypad_Timing_t *timing)
 {
-    uint8_t col, row, c;
+    __istate_t state = __get_interrupt_state();
+    
+    __disable_interrupt();
+    stableScans = (uint8_t)(MS_TO_SCANS(timing->debounceMs) + 1);
+    longScans = (uint16_t)MS_TO_SCANS(timing->longPressMs);
+    repeatDelayScans = (uint16_t)MS_TO_SCANS(timing->repeatDelayMs);
+    repeatScans = (uint16_t)MS_TO_SCANS(timing->repeatMs);
+    __set_interrupt_state(state);
+}
 
-    for (col = 0; col < 4; col++) {
-        /* Set all columns HIGH */
-        for (c = 0; c < 4; c++) {
-            DIO_WritePin(col_pins[c].port, col_pins[c].pin, HIGH);
-        }
+bool Keypad_GetEvent(Keypad_Event_t *event)
+{
+    if (eventTail == eventHead) return false;
 
-        /* Set current column LOW */
-        DIO_WritePin(col_pins[col].port, col_pins[col].pin, LOW);
+    event->key = eventQueue[eventTail].key;
+    event->type = eventQueue[eventTail].type;
+    event->timeMs = eventQueue[eventTail].timeMs;
+    eventTail = (eventTail + 1) & KEYPAD_QUEUE_MASK;
+    return true;
+}
 
-        /* Check each row */
-        for (row = 0; row < 4; row++) {
-            if (DIO_ReadPin(KEYPAD_ROW_PORT, row_pins[row]) == LOW) {
-                /* Wait for key release */
-                while (DIO_ReadPin(KEYPAD_ROW_PORT, row_pins[row]) == LOW);
-                
-                return keypad_codes[row][col];
-            }
+char Keypad_GetKey(void)
+{
+    Keypad_Event_t event;
+
+    while (Keypad_GetEvent(&event)) {
+        if (event.type == KEYPAD_EVENT_PRESS) {
+            return event.key;
         }
     }
     return 0;  /* No key pressed */
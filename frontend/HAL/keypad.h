@@ -8,18 +8,70 @@
  *   [4] [5] [6] [B]
  *   [7] [8] [9] [C]
  *   [*] [0] [#] [D]
+ *
+ * Interrupt driven: while idle every column is driven low and a falling
+ * edge on any row wakes the driver. It then scans the matrix on Timer1A
+ * every KEYPAD_SCAN_US until all keys are up again. Each key has its own
+ * debounce state machine fed one sample per scan; a key must read the
+ * same for the debounce time before its press or release is queued, and
+ * held keys give long-press and auto-repeat events. Three keys on the
+ * corners of a rectangle make the fourth read as pressed too (there are
+ * no diodes); such scans are not trusted and queue one rollover event.
  *****************************************************************************/
 #ifndef KEYPAD_H
 #define KEYPAD_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+/* Scan period (debounce tick) while a key is down */
+#define KEYPAD_SCAN_US      2000
+
+/* Default timing (Keypad_SetTiming changes it) */
+#define KEYPAD_DEBOUNCE_MS      10      /* Contact bounce of membrane keypads */
+#define KEYPAD_LONG_PRESS_MS    1000
+#define KEYPAD_REPEAT_DELAY_MS  500
+#define KEYPAD_REPEAT_MS        100
+
+/* Events buffered between the scan ISR and the reader (power of two, one
+ * slot kept free) */
+#define KEYPAD_QUEUE_SIZE   16
+
+/* Event types */
+#define KEYPAD_EVENT_PRESS      0
+#define KEYPAD_EVENT_RELEASE    1
+#define KEYPAD_EVENT_LONG_PRESS 2       /* Held for the long-press time */
+#define KEYPAD_EVENT_REPEAT     3       /* Held past the repeat delay, every repeat period */
+#define KEYPAD_EVENT_ROLLOVER   4       /* key = 0: too many keys down to tell which */
+
+typedef struct {
+    char     key;           /* keypad_codes entry */
+    uint8_t  type;          /* KEYPAD_EVENT_xxx */
+    uint32_t timeMs;        /* SysTick_GetMs() at the scan that saw it */
+} Keypad_Event_t;
+
+/* Times in milliseconds, rounded up to whole scans; 0 turns long-press or
+ * repeat off, a debounce of 0 takes every scan as it reads */
+typedef struct {
+    uint16_t debounceMs;
+    uint16_t longPressMs;
+    uint16_t repeatDelayMs;
+    uint16_t repeatMs;
+} Keypad_Timing_t;
 
 extern const char keypad_codes[4][4];
 
-/* Initialize keypad GPIO pins */
+/* Initialize keypad GPIO pins, the row interrupts and the scan timer */
 void Keypad_Init(void);
 
-/* Get pressed key (blocking with debounce), returns 0 if no key */
+/* Replace the timing; keys already down keep their state */
+void Keypad_SetTiming(const Keypad_Timing_t *timing);
+
+/* Take the oldest queued event; false if there is none */
+bool Keypad_GetEvent(Keypad_Event_t *event);
+
+/* Next key pressed (other events are skipped), returns 0 if no key; does
+ * not block */
 char Keypad_GetKey(void);
 
-#endif /* KEYPAD_H */
\ No newline at end of file
+#endif /* KEYPAD_H */
@@ -4,6 +4,8 @@
  * Note: Uses I2C MCAL for low-level I2C operations
  *****************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include "../MCAL/systick.h"
 #include "../MCAL/i2c.h"
 #include "lcd.h"
@@ -12,11 +14,21 @@
  *                          Private Definitions                                *
  ******************************************************************************/
 
-/* PCF8574 I2C Address (typical: 0x27 or 0x3F) */
-#define LCD_I2C_ADDR    0x27
+/* PCF8574 I2C addresses LCD_Init probes: 0x27 (PCF8574, A0-A2 open) and
+ * 0x3F (PCF8574A) */
+#define LCD_I2C_ADDR        0x27
+#define LCD_I2C_ADDR_ALT    0x3F
 
-/* I2C Module Used for LCD */
-#define LCD_I2C_MODULE  I2C_MODULE_0
+/* I2C Module Used for LCD. Fast mode is tried first: the PCF8574 is only
+ * specified for 100 kHz, but most backpacks keep up at 400 kHz. A part
+ * can ACK its address and still corrupt data bytes, so fast mode is only
+ * kept once a test pattern reads back from the port unchanged; otherwise
+ * LCD_Init falls back to standard mode. */
+#define LCD_I2C_MODULE      I2C_MODULE_0
+#ifndef LCD_I2C_SPEED
+#define LCD_I2C_SPEED       I2C_SPEED_400K
+#endif
+#define LCD_I2C_SPEED_SAFE  I2C_SPEED_100K
 
 /* PCF8574 Pin Mapping for LCD */
 #define LCD_RS      0x01    /* P0: Register Select (0=Command, 1=Data) */
@@ -24,45 +36,357 @@
 #define LCD_EN      0x04    /* P2: Enable */
 #define LCD_BL      0x08    /* P3: Backlight */
 
+/* HD44780 timing. Execution times are the datasheet's 270 kHz figures
+ * scaled to the slowest oscillator it allows (190 kHz). */
+#define LCD_EXEC_US         53      /* Most instructions and data: 37 us nominal */
+#define LCD_CLEAR_US        2160    /* Clear display / return home: 1.52 ms nominal */
+#define LCD_POWER_UP_MS     50      /* > 40 ms after Vcc rises to 2.7 V */
+#define LCD_INIT_WAIT1_US   4100    /* After the first 8-bit function set */
+#define LCD_INIT_WAIT2_US   100     /* After the second */
+
+/* A byte sent to the LCD is 4 PCF8574 writes: EN high/low per nibble */
+#define LCD_BYTES_PER_WRITE 4
+
+/* Inside a burst, the next write's first nibble latches two bus bytes
+ * after this one's last (9 bit times each). When that is shorter than the
+ * instruction's execution time, repeat the idle pins to stretch the gap:
+ * after most writes none at 100 kHz and one at 400 kHz; after a Clear, 22
+ * and 94. The speed is only known once LCD_Init has probed the bus, so
+ * the counts are worked out then (padBytes, clearPadBytes); buffers are
+ * sized for LCD_I2C_SPEED, the fastest it tries. */
+#define LCD_BUS_BYTE_NS(speed)      (9000000000ULL / (speed))
+#define LCD_GAP_BYTES(us, speed)    (((us) * 1000ULL + LCD_BUS_BYTE_NS(speed) - 1) / LCD_BUS_BYTE_NS(speed))
+#define LCD_IDLE_BYTES(us, speed)   ((LCD_GAP_BYTES(us, speed) > 2) ? (LCD_GAP_BYTES(us, speed) - 2) : 0)
+#define LCD_MAX_PAD_BYTES           LCD_IDLE_BYTES(LCD_EXEC_US, LCD_I2C_SPEED)
+#define LCD_MAX_CLEAR_PAD_BYTES     LCD_IDLE_BYTES(LCD_CLEAR_US, LCD_I2C_SPEED)
+
+/* One row of text per burst (the address byte is sent once for all) */
+#define LCD_BURST_SIZE      (LCD_COLS * (LCD_BYTES_PER_WRITE + LCD_MAX_PAD_BYTES))
+
+/* A flushed row: at most a Set DDRAM address and 16 characters */
+#define LCD_ROW_BURST_SIZE  ((LCD_COLS + 1) * (LCD_BYTES_PER_WRITE + LCD_MAX_PAD_BYTES))
+
+/* DDRAM addresses in 2-line mode: row 0 is 0x00-0x27, row 1 0x40-0x67 */
+#define LCD_ROW1_ADDR       0x40
+#define LCD_ROW_LENGTH      0x28
+
+/* Row 0 of a flush may start with a Clear and the idle bytes that wait
+ * it out */
+#define LCD_FLUSH_BURST_SIZE (LCD_ROW_BURST_SIZE + LCD_BYTES_PER_WRITE + LCD_MAX_CLEAR_PAD_BYTES)
+
+/******************************************************************************
+ *                          Private Variables                                  *
+ ******************************************************************************/
+
+/* SysTick_GetUs() at which the controller finishes the last instruction.
+ * Reading the busy flag through the PCF8574 takes four I2C transfers,
+ * far longer than the wait itself, so the driver keeps time instead. */
+static uint64_t readyUs = 0;
+
+/* Backpack address and idle bytes for the bus speed LCD_Init settled on */
+static uint8_t lcdAddr = LCD_I2C_ADDR;
+static uint8_t padBytes = LCD_IDLE_BYTES(LCD_EXEC_US, LCD_I2C_SPEED_SAFE);
+static uint8_t clearPadBytes = LCD_IDLE_BYTES(LCD_CLEAR_US, LCD_I2C_SPEED_SAFE);
+
+/* What the panel shows, kept up to date by every write, and the DDRAM
+ * address its cursor is at (entry mode is always increment) */
+static char shown[LCD_ROWS][LCD_COLS];
+static uint8_t cursorAddr = 0;
+
+/* What LCD_Flush should make it show */
+static char shadow[LCD_ROWS][LCD_COLS];
+
+/* Bursts LCD_Flush leaves to the I2C0 interrupt, one per row. The next
+ * call into the driver waits for them (LCD_Sync). */
+static uint8_t flushBuf[LCD_ROWS][LCD_FLUSH_BURST_SIZE];
+static I2C_Transfer_t flushXfer[LCD_ROWS];
+
 /******************************************************************************
  *                         Private Function Prototypes                         *
  ******************************************************************************/
 
+static void LCD_Probe(void);
+static bool LCD_PortEchoes(uint8_t addr);
 static void LCD_WriteNibble(uint8_t nibble, uint8_t rs);
-static void LCD_WriteByte(uint8_t data, uint8_t rs);
+static void LCD_WaitReady(void);
+static uint8_t LCD_Encode(uint8_t *buf, uint8_t data, uint8_t rs);
+static void LCD_Send(const uint8_t *buf, uint8_t length, uint32_t execUs);
+static void LCD_WriteByte(uint8_t data, uint8_t rs, uint32_t execUs);
+static void LCD_Sync(void);
+static void LCD_FlushDone(I2C_Transfer_t *xfer);
+static void LCD_Track(char c);
+static void LCD_TrackCommand(uint8_t cmd);
+static uint8_t LCD_Plan(uint8_t *buf, uint8_t row, uint8_t *addr, bool fromBlank);
+static uint16_t LCD_BurstCost(uint8_t length);
 
 /******************************************************************************
  *                         Private Functions                                   *
  ******************************************************************************/
 
 /*
- * Description: Send a 4-bit nibble to LCD via I2C
+ * Description: Find the backpack: try each address at LCD_I2C_SPEED, then
+ *              at standard mode, and keep the first that ACKs. Above
+ *              standard mode the port must also echo a test pattern.
+ * Note: Probing writes LCD_BL alone (EN low), which the HD44780 ignores.
+ *       If nothing answers, the driver stays at 0x27 and 100 kHz and its
+ *       writes fail without blocking.
+ */
+static void LCD_Probe(void)
+{
+    static const uint32_t speeds[] = {LCD_I2C_SPEED, LCD_I2C_SPEED_SAFE};
+    static const uint8_t addrs[] = {LCD_I2C_ADDR, LCD_I2C_ADDR_ALT};
+    
+    for (uint8_t s = 0; s < sizeof(speeds) / sizeof(speeds[0]); s++) {
+        I2C_Init(LCD_I2C_MODULE, speeds[s]);
+        
+        for (uint8_t a = 0; a < sizeof(addrs) / sizeof(addrs[0]); a++) {
+            if (I2C_WriteByte(LCD_I2C_MODULE, addrs[a], LCD_BL) == I2C_SUCCESS) {
+                if (speeds[s] > LCD_I2C_SPEED_SAFE && !LCD_PortEchoes(addrs[a])) {
+                    break;  /* Found, but not reliable at this speed */
+                }
+                lcdAddr = addrs[a];
+                padBytes = (uint8_t)LCD_IDLE_BYTES(LCD_EXEC_US, speeds[s]);
+                clearPadBytes = (uint8_t)LCD_IDLE_BYTES(LCD_CLEAR_US, speeds[s]);
+                return;
+            }
+        }
+    }
+    
+    lcdAddr = LCD_I2C_ADDR;
+    padBytes = LCD_IDLE_BYTES(LCD_EXEC_US, LCD_I2C_SPEED_SAFE);
+    clearPadBytes = LCD_IDLE_BYTES(LCD_CLEAR_US, LCD_I2C_SPEED_SAFE);
+}
+
+/*
+ * Description: Write test patterns to the backpack and read them back
+ * Parameters:
+ *   - addr: Backpack address, already known to ACK
+ * Returns: true if every pattern read back unchanged
+ * Note: A PCF8574 read returns its pin levels, which follow the last
+ *       write while nothing pulls them low. The patterns set every pin
+ *       but EN and RW in turn, so the HD44780 ignores them, and the port
+ *       is left at LCD_BL alone.
+ */
+static bool LCD_PortEchoes(uint8_t addr)
+{
+    static const uint8_t patterns[] = {0xA0 | LCD_BL | LCD_RS, 0x50 | LCD_BL};
+    bool echoed = true;
+    uint8_t port;
+    
+    for (uint8_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]) && echoed; p++) {
+        echoed = I2C_WriteByte(LCD_I2C_MODULE, addr, patterns[p]) == I2C_SUCCESS &&
+                 I2C_ReadByte(LCD_I2C_MODULE, addr, &port) == I2C_SUCCESS &&
+                 port == patterns[p];
+    }
+    I2C_WriteByte(LCD_I2C_MODULE, addr, LCD_BL);
+    return echoed;
+}
+
+/*
+ * Description: Send a single 4-bit nibble to LCD via I2C (power-on
+ *              sequence, while the controller is still in 8-bit mode)
  * Parameters:
  *   - nibble: 4-bit data in upper nibble (bits 7-4)
  *   - rs: Register Select (0=command, 1=data)
+ * Note: No delays needed here or in LCD_Encode: the PCF8574 changes its
+ *       outputs once per bus byte, so EN stays high for at least 9 bit
+ *       times (22 us at 400 kHz), far above the 450 ns minimum pulse
+ *       width, and the data is latched on the falling edge.
  */
 static void LCD_WriteNibble(uint8_t nibble, uint8_t rs)
 {
     uint8_t data = (nibble & 0xF0) | LCD_BL;  /* Keep backlight on */
+    uint8_t pulse[2];
     if (rs) data |= LCD_RS;  /* Set RS bit if writing data */
     
-    /* Enable pulse: high -> low */
-    I2C_WriteByte(LCD_I2C_MODULE, LCD_I2C_ADDR, data | LCD_EN);  /* EN high */
-    DelayMs(1);
-    I2C_WriteByte(LCD_I2C_MODULE, LCD_I2C_ADDR, data);           /* EN low */
-    DelayMs(1);
+    /* Enable pulse: high -> low, in one transfer */
+    pulse[0] = data | LCD_EN;
+    pulse[1] = data;
+    I2C_WriteMultipleBytes(LCD_I2C_MODULE, lcdAddr, pulse, 2);
 }
 
 /*
- * Description: Send a full byte to LCD in 4-bit mode (two nibbles)
+ * Description: Wait until the previous instruction has finished executing
+ * Note: Usually a no-op: the I2C transfers in between already take longer
+ *       than LCD_EXEC_US, so only Clear/Home really wait.
+ */
+static void LCD_WaitReady(void)
+{
+    uint64_t now = SysTick_GetUs();
+    
+    if (now < readyUs) {
+        DelayUs((uint32_t)(readyUs - now));
+    }
+}
+
+/*
+ * Description: Append the PCF8574 writes for one byte in 4-bit mode
+ *              (two nibbles, EN high then low), plus padBytes of idle
+ *              pins
+ * Parameters:
+ *   - buf: Burst buffer, at least LCD_BYTES_PER_WRITE + padBytes free
+ *   - data: 8-bit data to send
+ *   - rs: Register Select (0=command, 1=data)
+ * Returns: Number of bytes appended
+ */
+static uint8_t LCD_Encode(uint8_t *buf, uint8_t data, uint8_t rs)
+{
+    uint8_t pins = rs ? (LCD_BL | LCD_RS) : LCD_BL;
+    uint8_t high = (data & 0xF0) | pins;
+    uint8_t low = (uint8_t)(data << 4) | pins;
+    uint8_t n = 0;
+    
+    buf[n++] = high | LCD_EN;
+    buf[n++] = high;
+    buf[n++] = low | LCD_EN;
+    buf[n++] = low;
+    for (uint8_t i = 0; i < padBytes; i++) {
+        buf[n++] = low;
+    }
+    return n;
+}
+
+/*
+ * Description: Send a burst once the controller is free
+ * Parameters:
+ *   - buf, length: Encoded writes; trailing padding is not sent
+ *   - execUs: Execution time of the last instruction in the burst
+ */
+static void LCD_Send(const uint8_t *buf, uint8_t length, uint32_t execUs)
+{
+    LCD_Sync();
+    LCD_WaitReady();
+    I2C_WriteMultipleBytes(LCD_I2C_MODULE, lcdAddr, buf, length - padBytes);
+    readyUs = SysTick_GetUs() + execUs;
+}
+
+/*
+ * Description: Send a full byte to LCD in 4-bit mode as one I2C transfer
  * Parameters:
  *   - data: 8-bit data to send
  *   - rs: Register Select (0=command, 1=data)
+ *   - execUs: Execution time of this instruction
+ */
+static void LCD_WriteByte(uint8_t data, uint8_t rs, uint32_t execUs)
+{
+    uint8_t buf[LCD_BYTES_PER_WRITE + LCD_MAX_PAD_BYTES];
+    
+    LCD_Send(buf, LCD_Encode(buf, data, rs), execUs);
+}
+
+/*
+ * Description: Wait until the bursts of the last LCD_Flush are on the LCD
+ */
+static void LCD_Sync(void)
+{
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        I2C_Wait(&flushXfer[row]);
+    }
+}
+
+/*
+ * Description: Completion of a flushed row (I2C0 interrupt)
+ * Note: If a burst failed, nothing is known about the panel any more, so
+ *       the next flush redraws every cell and sets the address first.
  */
-static void LCD_WriteByte(uint8_t data, uint8_t rs)
+static void LCD_FlushDone(I2C_Transfer_t *xfer)
 {
-    LCD_WriteNibble(data & 0xF0, rs);        /* High nibble */
-    LCD_WriteNibble((data << 4) & 0xF0, rs); /* Low nibble */
+    readyUs = SysTick_GetUs() + LCD_EXEC_US;
+    
+    if (xfer->status != I2C_SUCCESS) {
+        for (uint8_t row = 0; row < LCD_ROWS; row++) {
+            for (uint8_t col = 0; col < LCD_COLS; col++) {
+                shown[row][col] = '\0';
+            }
+        }
+        cursorAddr = 0xFF;
+    }
+}
+
+/*
+ * Description: Record a character written at the cursor and advance it
+ *              the way the controller does (0x27 -> 0x40 -> 0x67 -> 0x00)
+ */
+static void LCD_Track(char c)
+{
+    uint8_t row = (cursorAddr >= LCD_ROW1_ADDR) ? 1 : 0;
+    uint8_t col = (uint8_t)(cursorAddr - (row ? LCD_ROW1_ADDR : 0));
+    
+    if (col < LCD_COLS) shown[row][col] = c;
+    
+    cursorAddr++;
+    if (cursorAddr == LCD_ROW_LENGTH) {
+        cursorAddr = LCD_ROW1_ADDR;
+    } else if (cursorAddr == LCD_ROW1_ADDR + LCD_ROW_LENGTH) {
+        cursorAddr = 0;
+    }
+}
+
+/*
+ * Description: Follow what a command does to the panel and cursor
+ */
+static void LCD_TrackCommand(uint8_t cmd)
+{
+    if (cmd == LCD_CMD_CLEAR) {
+        for (uint8_t row = 0; row < LCD_ROWS; row++) {
+            for (uint8_t col = 0; col < LCD_COLS; col++) {
+                shown[row][col] = ' ';
+            }
+        }
+        cursorAddr = 0;
+    } else if ((cmd & 0xFE) == LCD_CMD_HOME) {
+        cursorAddr = 0;
+    } else if (cmd & LCD_CMD_SET_DDRAM) {
+        cursorAddr = cmd & 0x7F;
+    }
+}
+
+/*
+ * Description: Encode the writes that bring one row of the panel to the
+ *              shadow buffer: a Set DDRAM address before each run of
+ *              changed cells, unless the cursor is already there
+ * Parameters:
+ *   - buf: At least LCD_ROW_BURST_SIZE bytes
+ *   - row: Row to bring up to date
+ *   - addr: Cursor address before the row; updated to the one after
+ *   - fromBlank: Compare against a cleared panel instead of shown[]
+ * Returns: Number of bytes encoded (0 if the row is already up to date)
+ * Note: A single unchanged cell between two runs is sent again rather
+ *       than skipped: it costs the same 4 writes as the address would.
+ */
+static uint8_t LCD_Plan(uint8_t *buf, uint8_t row, uint8_t *addr, bool fromBlank)
+{
+    uint8_t base = row ? LCD_ROW1_ADDR : 0;
+    uint8_t length = 0;
+    bool dirty[LCD_COLS];
+    
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+        dirty[col] = shadow[row][col] != (fromBlank ? ' ' : shown[row][col]);
+    }
+    
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+        uint8_t target = (uint8_t)(base + col);
+        bool bridge = (*addr == target) && (col + 1 < LCD_COLS) && dirty[col + 1];
+        
+        if (!dirty[col] && !bridge) continue;
+        
+        if (*addr != target) {
+            length += LCD_Encode(&buf[length], LCD_CMD_SET_DDRAM | target, 0);
+        }
+        length += LCD_Encode(&buf[length], (uint8_t)shadow[row][col], 1);
+        *addr = (uint8_t)(target + 1);
+    }
+    return length;
+}
+
+/*
+ * Description: Bytes on the bus for a burst of the given encoded length,
+ *              counting the address byte and STOP as one each
+ */
+static uint16_t LCD_BurstCost(uint8_t length)
+{
+    if (length == 0) return 0;
+    return (uint16_t)(length - padBytes + 2);
 }
 
 /******************************************************************************
@@ -71,53 +395,67 @@ static void LCD_WriteByte(uint8_t data, uint8_t rs)
 
 void LCD_WriteChar(char c)
 {
-    LCD_WriteByte((uint8_t)c, 1);  /* RS=1 for data */
+    LCD_WriteByte((uint8_t)c, 1, LCD_EXEC_US);  /* RS=1 for data */
+    LCD_Track(c);
 }
 
 void LCD_WriteString(const char *str)
 {
+    uint8_t buf[LCD_BURST_SIZE];
+    uint8_t length;
+    uint8_t count;
+    
+    LCD_Sync();                 /* LCD_Track below races a failing flush */
+    
+    /* Up to a row of characters per I2C transfer */
     while (*str) {
-        LCD_WriteChar(*str++);
+        length = 0;
+        for (count = 0; *str && count < LCD_COLS; count++) {
+            LCD_Track(*str);
+            length += LCD_Encode(&buf[length], (uint8_t)*str++, 1);
+        }
+        LCD_Send(buf, length, LCD_EXEC_US);
     }
 }
 
 void LCD_Command(uint8_t cmd)
 {
-    LCD_WriteByte(cmd, 0);  /* RS=0 for command */
-    
-    /* Clear and Home commands require longer delay */
-    if (cmd == LCD_CMD_CLEAR || cmd == LCD_CMD_HOME) {
-        DelayMs(2);
+    /* Clear and Home (0x02/0x03) take much longer than the rest */
+    if (cmd == LCD_CMD_CLEAR || (cmd & 0xFE) == LCD_CMD_HOME) {
+        LCD_WriteByte(cmd, 0, LCD_CLEAR_US);   /* RS=0 for command */
+    } else {
+        LCD_WriteByte(cmd, 0, LCD_EXEC_US);
     }
+    LCD_TrackCommand(cmd);
 }
 
 void LCD_Init(void)
 {
-    /* Initialize I2C MCAL driver */
-    I2C_Init(LCD_I2C_MODULE, I2C_SPEED_100K);
-    DelayMs(50);  /* Wait for LCD power-up */
+    /* Initialize I2C MCAL driver at the fastest speed the backpack takes */
+    LCD_Probe();
+    DelayMs(LCD_POWER_UP_MS);  /* Wait for LCD power-up */
     
     /* HD44780 initialization sequence for 4-bit mode */
     LCD_WriteNibble(0x30, 0);  /* Function set: 8-bit mode (initial) */
-    DelayMs(5);
+    DelayUs(LCD_INIT_WAIT1_US);
     LCD_WriteNibble(0x30, 0);  /* Function set: 8-bit mode (repeat) */
-    DelayMs(1);
+    DelayUs(LCD_INIT_WAIT2_US);
     LCD_WriteNibble(0x30, 0);  /* Function set: 8-bit mode (repeat) */
-    DelayMs(1);
+    DelayUs(LCD_EXEC_US);
     LCD_WriteNibble(0x20, 0);  /* Function set: Switch to 4-bit mode */
-    DelayMs(1);
+    readyUs = SysTick_GetUs() + LCD_EXEC_US;
     
     /* Configure LCD in 4-bit mode */
     LCD_Command(LCD_CMD_FUNCTION_SET);  /* 4-bit, 2 lines, 5x8 font */
     LCD_Command(LCD_CMD_DISPLAY_ON);    /* Display on, cursor off */
     LCD_Clear();                        /* Clear display */
     LCD_Command(LCD_CMD_ENTRY_MODE);    /* Entry mode: increment, no shift */
+    LCD_BufferClear();                  /* Shadow matches the blank panel */
 }
 
 void LCD_Clear(void)
 {
-    LCD_Command(LCD_CMD_CLEAR);
-    DelayMs(2);  /* Clear command requires ~2ms */
+    LCD_Command(LCD_CMD_CLEAR);  /* Next write waits out the ~2 ms */
 }
 
 void LCD_SetCursor(uint8_t row, uint8_t col)
@@ -128,9 +466,96 @@ void LCD_SetCursor(uint8_t row, uint8_t col)
     if (row == 0) {
         addr = col;              /* Row 0: 0x00-0x0F */
     } else {
-        addr = 0x40 + col;       /* Row 1: 0x40-0x4F */
+        addr = LCD_ROW1_ADDR + col;  /* Row 1: 0x40-0x4F */
     }
     
     /* Send Set DDRAM Address command */
     LCD_Command(LCD_CMD_SET_DDRAM | addr);
 }
+
+void LCD_BufferClear(void)
+{
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        for (uint8_t col = 0; col < LCD_COLS; col++) {
+            shadow[row][col] = ' ';
+        }
+    }
+}
+
+void LCD_BufferPutChar(uint8_t row, uint8_t col, char c)
+{
+    if (row < LCD_ROWS && col < LCD_COLS) {
+        shadow[row][col] = c;
+    }
+}
+
+void LCD_BufferWrite(uint8_t row, uint8_t col, const char *str)
+{
+    if (row >= LCD_ROWS) return;
+    
+    while (*str && col < LCD_COLS) {
+        shadow[row][col++] = *str++;
+    }
+}
+
+void LCD_Flush(void)
+{
+    uint16_t keepCost = 0;
+    uint16_t clearCost = LCD_BYTES_PER_WRITE + clearPadBytes;
+    uint8_t addr;
+    uint8_t lengths[LCD_ROWS];
+    uint8_t length = 0;
+    uint8_t idle;
+    
+    /* The buffers of the previous flush are reused */
+    LCD_Sync();
+    
+    /* Price both ways of getting there: patch the changed cells, or clear
+     * and redraw every non-blank cell */
+    addr = cursorAddr;
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        keepCost += LCD_BurstCost(LCD_Plan(flushBuf[row], row, &addr, false));
+    }
+    if (keepCost == 0) return;
+    
+    addr = 0;
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        clearCost += LCD_BurstCost(LCD_Plan(flushBuf[row], row, &addr, true));
+    }
+    
+    /* The bursts run unattended, so the last direct write must be done */
+    LCD_WaitReady();
+    
+    if (clearCost < keepCost) {
+        length = LCD_Encode(flushBuf[0], LCD_CMD_CLEAR, 0);
+        idle = flushBuf[0][LCD_BYTES_PER_WRITE - 1];
+        while (length < LCD_BYTES_PER_WRITE + clearPadBytes) {
+            flushBuf[0][length++] = idle;
+        }
+        LCD_TrackCommand(LCD_CMD_CLEAR);
+    }
+    
+    /* One I2C transfer per row that changed. All bookkeeping is done
+     * before the first is queued, as a failing one resets it. */
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        length += LCD_Plan(&flushBuf[row][length], row, &cursorAddr, false);
+        lengths[row] = length;
+        length = 0;
+        
+        for (uint8_t col = 0; col < LCD_COLS; col++) {
+            shown[row][col] = shadow[row][col];
+        }
+    }
+    
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        if (lengths[row] == 0) continue;
+        
+        flushXfer[row].slaveAddr = lcdAddr;
+        flushXfer[row].txData = flushBuf[row];
+        flushXfer[row].txLength = (uint8_t)(lengths[row] - padBytes);
+        flushXfer[row].rxData = NULL;
+        flushXfer[row].rxLength = 0;
+        flushXfer[row].callback = LCD_FlushDone;
+        I2C_Submit(&flushXfer[row]);
+    }
+}
@@ -34,6 +34,10 @@
  * Description: Initialize LCD display via I2C
  * Parameters: None
  * Returns: None
+ * Note: Instruction timing runs on SysTick_GetUs, so SysTick must already
+ *       run in SYSTICK_INT mode. Finds the backpack at 0x27 or 0x3F and
+ *       runs the bus at 400 kHz if a test pattern written there reads
+ *       back unchanged, else at 100 kHz.
  */
 void LCD_Init(void);
 
@@ -78,4 +82,47 @@ void LCD_WriteString(const char *str);
  */
 void LCD_Command(uint8_t cmd);
 
+/*
+ * Description: Fill the shadow buffer with spaces
+ * Parameters: None
+ * Returns: None
+ * Note: The shadow buffer is the screen the next LCD_Flush shows; nothing
+ *       is sent to the LCD until then
+ */
+void LCD_BufferClear(void);
+
+/*
+ * Description: Put a character into the shadow buffer
+ * Parameters:
+ *   - row: Row number (0 or 1)
+ *   - col: Column number (0-15)
+ *   - c: Character to display
+ * Returns: None
+ * Note: Positions off the screen are ignored
+ */
+void LCD_BufferPutChar(uint8_t row, uint8_t col, char c);
+
+/*
+ * Description: Write a null-terminated string into the shadow buffer
+ * Parameters:
+ *   - row: Row number (0 or 1)
+ *   - col: First column (0-15)
+ *   - str: Pointer to string; cut off at the end of the row
+ * Returns: None
+ */
+void LCD_BufferWrite(uint8_t row, uint8_t col, const char *str);
+
+/*
+ * Description: Make the LCD show the shadow buffer
+ * Parameters: None
+ * Returns: None
+ * Note: Sends only the cells that differ from what the LCD shows, as a
+ *       DDRAM address plus the changed characters, one I2C transfer per
+ *       row; clears first when redrawing is cheaper. Direct writes with
+ *       LCD_WriteChar/LCD_WriteString are tracked, so mixing is safe.
+ *       Returns once the transfers are queued; they run from the I2C
+ *       interrupt, and the next LCD call waits for them.
+ */
+void LCD_Flush(void);
+
 #endif /* LCD_H */
@@ -4,6 +4,7 @@
  * Note: Uses ADC MCAL for hardware communication
  *****************************************************************************/
 #include <stdint.h>
+#include <stdbool.h>
 #include "potentiometer.h"
 #include "../MCAL/adc.h"
 
@@ -15,6 +16,85 @@
 /* Potentiometer ADC Channel (PB5 = AIN11) */
 #define POTENTIOMETER_ADC_CHANNEL   ADC_CHANNEL_11
 
+/* 100 samples/s, each the mean of 64 conversions */
+#define POT_SAMPLE_US               10000
+#define POT_AVERAGE                 ADC_AVERAGE_64
+
+#define POT_SPAN_SEC    (POTENTIOMETER_TIMEOUT_MAX_SEC - POTENTIOMETER_TIMEOUT_MIN_SEC)
+
+static Potentiometer_Filter_t filter = {
+    POTENTIOMETER_FILTER_SHIFT, POTENTIOMETER_HYSTERESIS
+};
+
+/* Last three samples for the median, newest first */
+static uint16_t history[3];
+static uint32_t smoothed = 0;       /* Average scaled by 2^shift */
+static uint32_t timeout = 0;        /* 0 = no step picked yet */
+static uint32_t seenOverruns = 0;
+static bool seeded = false;         /* history and smoothed hold a sample */
+
+/* Median of three drops a single-sample spike (wiper losing contact) */
+static uint16_t Median3(uint16_t a, uint16_t b, uint16_t c)
+{
+    if (a > b) {
+        uint16_t t = a; a = b; b = t;
+    }
+    if (b > c) {
+        b = c;
+    }
+    return (a > b) ? a : b;
+}
+
+/* Restart the filter at one sample, forgetting everything before it */
+static void Seed(uint16_t sample)
+{
+    history[0] = history[1] = history[2] = sample;
+    smoothed = (uint32_t)sample << filter.shift;
+    seeded = true;
+}
+
+/* Fold the queued samples into the filter; if the queue overflowed (no
+ * one read it for a while) its contents are stale, so start over from
+ * the newest sample */
+static void Drain(void)
+{
+    uint16_t sample;
+    uint32_t dropped = ADC_Overruns();
+    
+    if (dropped != seenOverruns) {
+        seenOverruns = dropped;
+        while (ADC_GetSample(&sample));
+        Seed(ADC_LastSample());
+        return;
+    }
+    
+    while (ADC_GetSample(&sample)) {
+        if (!seeded) {
+            Seed(sample);
+            continue;
+        }
+        history[2] = history[1];
+        history[1] = history[0];
+        history[0] = sample;
+        sample = Median3(history[0], history[1], history[2]);
+        
+        /* Exponential average, weight 1 / 2^shift */
+        smoothed = smoothed - (smoothed >> filter.shift) + sample;
+    }
+}
+
+/* Nearest whole second for a filtered reading */
+static uint32_t ToSeconds(int32_t value)
+{
+    if (value < 0) {
+        value = 0;
+    } else if (value > ADC_MAX_VALUE) {
+        value = ADC_MAX_VALUE;
+    }
+    return ((uint32_t)value * POT_SPAN_SEC + ADC_MAX_VALUE / 2) / ADC_MAX_VALUE +
+           POTENTIOMETER_TIMEOUT_MIN_SEC;
+}
+
 /******************************************************************************
  *                          Public Functions                                   *
  ******************************************************************************/
@@ -24,23 +104,49 @@ void Potentiometer_Init(void)
 {
     /* Initialize ADC for potentiometer on PB5 (AIN11) */
     ADC_Init(POTENTIOMETER_ADC_CHANNEL);
+    ADC_StartSampling(POT_SAMPLE_US, POT_AVERAGE);
+    
+    seeded = false;
+    smoothed = 0;
+    timeout = 0;
+    seenOverruns = 0;
 }
 
+void Potentiometer_SetFilter(const Potentiometer_Filter_t *config)
+{
+    uint16_t value = (uint16_t)Potentiometer_Read();
+    
+    filter = *config;
+    if (filter.shift > POTENTIOMETER_FILTER_SHIFT_MAX) {
+        filter.shift = POTENTIOMETER_FILTER_SHIFT_MAX;
+    }
+    Seed(value);
+}
 
 uint32_t Potentiometer_Read(void)
 {
-    /* Read and return ADC value (0-4095) */
-    return ADC_Read();
+    Drain();
+    
+    /* Filtered ADC value (0-4095), rounded */
+    if (filter.shift == 0) {
+        return smoothed;
+    }
+    return (smoothed + (1UL << (filter.shift - 1))) >> filter.shift;
 }
 
 uint32_t Potentiometer_GetTimeout(void)
 {
-    uint32_t rawValue = Potentiometer_Read();
-    uint32_t scaledValue;
-    
-    /* Scale raw ADC value (0-4095) to timeout range (5-30 seconds) */
-    scaledValue = (rawValue * (POTENTIOMETER_TIMEOUT_MAX_SEC - POTENTIOMETER_TIMEOUT_MIN_SEC)
-                   / ADC_MAX_VALUE) + POTENTIOMETER_TIMEOUT_MIN_SEC;
+    int32_t value = (int32_t)Potentiometer_Read();
+    int32_t margin = (int32_t)filter.hysteresis;
     
-    return scaledValue;
+    /* Move to a new step only once the reading is past its edge by the
+     * hysteresis margin, so noise on an edge cannot flip the display */
+    if (timeout == 0) {
+        timeout = ToSeconds(value);
+    } else if (ToSeconds(value - margin) > timeout) {
+        timeout = ToSeconds(value - margin);
+    } else if (ToSeconds(value + margin) < timeout) {
+        timeout = ToSeconds(value + margin);
+    }
+    return timeout;
 }
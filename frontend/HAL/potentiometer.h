@@ -17,26 +17,53 @@
 #define POTENTIOMETER_TIMEOUT_MIN_SEC   5
 #define POTENTIOMETER_TIMEOUT_MAX_SEC   30
 
+/* Default filter: exponential average of weight 1/2^shift over the 100 Hz
+ * samples, and a hysteresis of a quarter of one second's ADC span
+ * (4095 / 25 counts) around each step edge */
+#define POTENTIOMETER_FILTER_SHIFT      2
+#define POTENTIOMETER_FILTER_SHIFT_MAX  8
+#define POTENTIOMETER_HYSTERESIS        40
+
+/* Filter settings, see Potentiometer_SetFilter */
+typedef struct {
+    uint8_t shift;              /* Average weight 1/2^shift, 0 = off */
+    uint16_t hysteresis;        /* ADC counts past a step edge to move */
+} Potentiometer_Filter_t;
+
 /******************************************************************************
  * Function Prototypes
  ******************************************************************************/
 
 /*
- * Description: Initialize potentiometer ADC interface
+ * Description: Initialize potentiometer ADC interface and start sampling
+ *              it in the background (Timer0A-paced, hardware averaged)
  * Parameters: None
  * Returns: None
  */
 void Potentiometer_Init(void);
 
 /*
- * Description: Read raw potentiometer ADC value
+ * Description: Change the filter settings (tuning and tests); restarts
+ *              the average at the current reading
+ * Parameters:
+ *   - config: New settings, copied
+ * Returns: None
+ */
+void Potentiometer_SetFilter(const Potentiometer_Filter_t *config);
+
+/*
+ * Description: Read the filtered potentiometer ADC value; folds in the
+ *              samples taken since the last call (median of three, then
+ *              the exponential average)
  * Parameters: None
- * Returns: Raw ADC value (0-4095)
+ * Returns: Filtered ADC value (0-4095)
  */
 uint32_t Potentiometer_Read(void);
 
 /*
- * Description: Get scaled timeout value from potentiometer
+ * Description: Get scaled timeout value from potentiometer, holding the
+ *              current value until the reading is clearly past the edge
+ *              of the next step
  * Parameters: None
  * Returns: Timeout value in seconds (5-30)
  */
@@ -7,7 +7,73 @@
  ******************************************************************************/
 
 #include "adc.h"
-#include "tm4c123gh6pm.h"
+#include "../lib/tm4c123gh6pm.h"
+
+/******************************************************************************
+ *                          Private Definitions                                *
+ ******************************************************************************/
+
+/* NVIC line of the ADC0 Sequencer 3 interrupt */
+#define ADC0SS3_IRQ         17
+
+/* Timer0 counts the system clock */
+#define CYCLES_PER_US       16UL
+
+#define ADC_QUEUE_MASK      (ADC_QUEUE_SIZE - 1)
+
+/* Pin behind each analog input, AIN0-AIN11 */
+typedef struct {
+    char port;
+    uint8_t pin;
+} AinPin_t;
+
+static const AinPin_t ainPins[12] = {
+    {'E', 3}, {'E', 2}, {'E', 1}, {'E', 0},
+    {'D', 3}, {'D', 2}, {'D', 1}, {'D', 0},
+    {'E', 5}, {'E', 4}, {'B', 4}, {'B', 5}
+};
+
+/* Sample ring: head written by the SS3 ISR, tail by the reader */
+static volatile uint16_t sampleQueue[ADC_QUEUE_SIZE];
+static volatile uint8_t sampleHead = 0;
+static volatile uint8_t sampleTail = 0;
+static volatile uint16_t lastSample = 0;
+static volatile uint32_t overruns = 0;
+
+/* Clock the port and hand the pin to the analog mux */
+static void ConfigureAnalogPin(uint8_t channel)
+{
+    volatile uint32_t delay;
+    uint32_t mask = 1UL << ainPins[channel].pin;
+    
+    switch (ainPins[channel].port) {
+        case 'B':
+            SYSCTL_RCGCGPIO_R |= 0x02;
+            delay = SYSCTL_RCGCGPIO_R;
+            GPIO_PORTB_DIR_R &= ~mask;
+            GPIO_PORTB_AFSEL_R |= mask;
+            GPIO_PORTB_DEN_R &= ~mask;
+            GPIO_PORTB_AMSEL_R |= mask;
+            break;
+        case 'D':
+            SYSCTL_RCGCGPIO_R |= 0x08;
+            delay = SYSCTL_RCGCGPIO_R;
+            GPIO_PORTD_DIR_R &= ~mask;
+            GPIO_PORTD_AFSEL_R |= mask;
+            GPIO_PORTD_DEN_R &= ~mask;
+            GPIO_PORTD_AMSEL_R |= mask;
+            break;
+        default:
+            SYSCTL_RCGCGPIO_R |= 0x10;
+            delay = SYSCTL_RCGCGPIO_R;
+            GPIO_PORTE_DIR_R &= ~mask;
+            GPIO_PORTE_AFSEL_R |= mask;
+            GPIO_PORTE_DEN_R &= ~mask;
+            GPIO_PORTE_AMSEL_R |= mask;
+            break;
+    }
+    (void)delay;
+}
 
 /******************************************************************************
  *                         Function Definitions                                *
@@ -18,40 +84,37 @@
  * Parameters:
  *   - channel: ADC input channel (0-11)
  * Returns: None
- * Note: PE3 corresponds to AIN0 (channel 0)
+ * Note: Configures the channel's pin as an analog input
  */
 void ADC_Init(uint8_t channel)
 {
-    volatile uint32_t delay;
+    if (channel > ADC_CHANNEL_11) {
+        channel = ADC_CHANNEL_0;
+    }
     
     /* Enable ADC0 clock */
-    SYSCTL_RCGCADC_R |= 0x01;           /* Enable ADC0 clock */
-    delay = SYSCTL_RCGCADC_R;           /* Allow time for clock to stabilize */
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R0;
+    while ((SYSCTL_PRADC_R & SYSCTL_PRADC_R0) == 0);
     
-    /* Enable GPIO Port E clock */
-    SYSCTL_RCGCGPIO_R |= 0x10;          /* Enable Port E clock */
-    delay = SYSCTL_RCGCGPIO_R;          /* Allow time for clock to stabilize */
-    
-    /* Configure PE3 as analog input */
-    GPIO_PORTE_DIR_R &= ~0x08;          /* Set PE3 as input */
-    GPIO_PORTE_AFSEL_R |= 0x08;         /* Enable alternate function on PE3 */
-    GPIO_PORTE_DEN_R &= ~0x08;          /* Disable digital I/O on PE3 */
-    GPIO_PORTE_AMSEL_R |= 0x08;         /* Enable analog function on PE3 */
+    ConfigureAnalogPin(channel);
     
     /* Configure ADC0 */
-    ADC0_ACTSS_R &= ~0x08;              /* Disable Sample Sequencer 3 during configuration */
-    ADC0_EMUX_R &= ~0xF000;             /* Software trigger for SS3 */
-    ADC0_SSMUX3_R = (channel & 0x0F);   /* Set channel for SS3 */
-    ADC0_SSCTL3_R = 0x06;               /* Set control bits: END0 and IE0 */
-    ADC0_SAC_R = 0x00;                  /* Disable hardware averaging */
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN3;   /* Disable Sample Sequencer 3 during configuration */
+    ADC0_PC_R = ADC_PC_SR_125K;         /* Longest sample time: pot wipers are high impedance */
+    ADC0_EMUX_R &= ~ADC_EMUX_EM3_M;     /* Software trigger for SS3 */
+    ADC0_SSMUX3_R = channel;            /* Set channel for SS3 */
+    ADC0_SSCTL3_R = ADC_SSCTL3_END0 | ADC_SSCTL3_IE0;
+    ADC0_SAC_R = ADC_SAC_AVG_OFF;       /* Disable hardware averaging */
+    ADC0_IM_R &= ~ADC_IM_MASK3;         /* Polled until ADC_StartSampling */
     ADC0_CTL_R &= ~0x01;                /* Clear VREF bit to use internal 3.3V reference */
-    ADC0_ACTSS_R |= 0x08;               /* Enable Sample Sequencer 3 */
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN3;    /* Enable Sample Sequencer 3 */
 }
 
 /*
  * Description: Reads a single sample from the ADC
  * Parameters: None
  * Returns: 12-bit ADC conversion result (0-4095)
+ * Note: Software trigger; only while ADC_StartSampling is not running
  */
 uint16_t ADC_Read(void)
 {
@@ -69,6 +132,112 @@ uint16_t ADC_Read(void)
     return result;
 }
 
+/*
+ * Description: Samples the channel every periodUs from Timer0A
+ * Parameters:
+ *   - periodUs: Sample period in microseconds
+ *   - average: ADC_AVERAGE_xxx conversions averaged per sample
+ * Returns: None
+ * Note: The timer's output trigger starts the sequencer, which averages
+ *       in hardware and interrupts once per sample
+ */
+void ADC_StartSampling(uint32_t periodUs, uint8_t average)
+{
+    /* Timer0A: periodic, no interrupt of its own, only the ADC trigger */
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0;
+    while ((SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R0) == 0);
+    TIMER0_CTL_R = 0;
+    TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER0_TAILR_R = periodUs * CYCLES_PER_US - 1;
+    TIMER0_IMR_R = 0;
+    
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN3;
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM3_M) | ADC_EMUX_EM3_TIMER;
+    ADC0_SAC_R = average & ADC_SAC_AVG_M;
+    ADC0_ISC_R = ADC_ISC_IN3;
+    
+    sampleHead = 0;
+    sampleTail = 0;
+    overruns = 0;
+    
+    ADC0_IM_R |= ADC_IM_MASK3;
+    NVIC_EN0_R = 1UL << ADC0SS3_IRQ;
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN3;
+    TIMER0_CTL_R = TIMER_CTL_TAOTE | TIMER_CTL_TAEN;
+}
+
+/*
+ * Description: Stops the trigger timer; queued samples stay readable
+ * Parameters: None
+ * Returns: None
+ */
+void ADC_StopSampling(void)
+{
+    TIMER0_CTL_R = 0;
+}
+
+/*
+ * Description: Takes the oldest queued sample
+ * Parameters:
+ *   - sample: Receives the 12-bit result
+ * Returns: false if the queue is empty
+ */
+bool ADC_GetSample(uint16_t *sample)
+{
+    if (sampleTail == sampleHead) {
+        return false;
+    }
+    *sample = sampleQueue[sampleTail];
+    sampleTail = (sampleTail + 1) & ADC_QUEUE_MASK;
+    return true;
+}
+
+/*
+ * Description: Most recent sample, whether or not the queue had room
+ * Parameters: None
+ * Returns: 12-bit result (0 before the first sample)
+ */
+uint16_t ADC_LastSample(void)
+{
+    return lastSample;
+}
+
+/*
+ * Description: Samples dropped because the queue was full
+ * Parameters: None
+ * Returns: Count since ADC_StartSampling
+ */
+uint32_t ADC_Overruns(void)
+{
+    return overruns;
+}
+
+/*
+ * Description: ADC0 Sequencer 3 ISR: queue the finished sample
+ * Parameters: None
+ * Returns: None
+ */
+void ADC0SS3Handler(void)
+{
+    uint16_t sample;
+    uint8_t next;
+    
+    ADC0_ISC_R = ADC_ISC_IN3;
+    while ((ADC0_SSFSTAT3_R & ADC_SSFSTAT3_EMPTY) == 0) {
+        sample = (uint16_t)(ADC0_SSFIFO3_R & ADC_SSFIFO3_DATA_M);
+        lastSample = sample;
+        
+        next = (sampleHead + 1) & ADC_QUEUE_MASK;
+        if (next == sampleTail) {
+            overruns++;             /* Queue full - drop */
+            continue;
+        }
+        sampleQueue[sampleHead] = sample;
+        sampleHead = next;
+    }
+}
+
 /*
  * Description: Converts ADC value to millivolts (assuming 3.3V reference)
  * Parameters:
@@ -10,6 +10,7 @@
 #define ADC_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /******************************************************************************
  *                              Definitions                                    *
@@ -30,11 +31,11 @@
 #define ADC_SS3             3
 
 /*
- * ADC Channel Definitions (for PE3, we use AIN0)
- * PE3 = AIN0
- * PE2 = AIN1
- * PE1 = AIN2
- * PE0 = AIN3
+ * ADC Channel Definitions (ADC_Init sets up the matching pin)
+ * PE3 = AIN0    PD3 = AIN4    PE5 = AIN8
+ * PE2 = AIN1    PD2 = AIN5    PE4 = AIN9
+ * PE1 = AIN2    PD1 = AIN6    PB4 = AIN10
+ * PE0 = AIN3    PD0 = AIN7    PB5 = AIN11
  */
 #define ADC_CHANNEL_0       0
 #define ADC_CHANNEL_1       1
@@ -54,6 +55,22 @@
  */
 #define ADC_MAX_VALUE       4095
 
+/*
+ * Hardware averaging: each sample is the mean of 2^n conversions
+ */
+#define ADC_AVERAGE_OFF     0
+#define ADC_AVERAGE_2       1
+#define ADC_AVERAGE_4       2
+#define ADC_AVERAGE_8       3
+#define ADC_AVERAGE_16      4
+#define ADC_AVERAGE_32      5
+#define ADC_AVERAGE_64      6
+
+/*
+ * Samples buffered between ADC_GetSample calls (power of two)
+ */
+#define ADC_QUEUE_SIZE      16
+
 /******************************************************************************
  *                         Function Prototypes                                 *
  ******************************************************************************/
@@ -63,7 +80,7 @@
  * Parameters:
  *   - channel: ADC input channel (0-11)
  * Returns: None
- * Note: PE3 corresponds to AIN0 (channel 0)
+ * Note: Configures the channel's pin as an analog input
  */
 void ADC_Init(uint8_t channel);
 
@@ -71,9 +88,57 @@ void ADC_Init(uint8_t channel);
  * Description: Reads a single sample from the ADC
  * Parameters: None
  * Returns: 12-bit ADC conversion result (0-4095)
+ * Note: Software trigger; only while ADC_StartSampling is not running
  */
 uint16_t ADC_Read(void);
 
+/*
+ * Description: Samples the channel given to ADC_Init every periodUs,
+ *              paced by Timer0A with no CPU involvement; the SS3
+ *              interrupt moves each result into a queue
+ * Parameters:
+ *   - periodUs: Sample period in microseconds
+ *   - average: ADC_AVERAGE_xxx conversions averaged per sample
+ * Returns: None
+ */
+void ADC_StartSampling(uint32_t periodUs, uint8_t average);
+
+/*
+ * Description: Stops the trigger timer; queued samples stay readable
+ * Parameters: None
+ * Returns: None
+ */
+void ADC_StopSampling(void);
+
+/*
+ * Description: Takes the oldest queued sample
+ * Parameters:
+ *   - sample: Receives the 12-bit result
+ * Returns: false if the queue is empty
+ */
+bool ADC_GetSample(uint16_t *sample);
+
+/*
+ * Description: Most recent sample, whether or not the queue had room
+ * Parameters: None
+ * Returns: 12-bit result (0 before the first sample)
+ */
+uint16_t ADC_LastSample(void);
+
+/*
+ * Description: Samples dropped because the queue was full
+ * Parameters: None
+ * Returns: Count since ADC_StartSampling
+ */
+uint32_t ADC_Overruns(void);
+
+/*
+ * Description: ADC0 Sequencer 3 ISR (vector table entry)
+ * Parameters: None
+ * Returns: None
+ */
+void ADC0SS3Handler(void);
+
 /*
  * Description: Converts ADC value to millivolts (assuming 3.3V reference)
  * Parameters:
@@ -5,6 +5,7 @@
  ******************************************************************************/
 
 #include "dio.h"
+#include <stddef.h>
 #include "../lib/tm4c123gh6pm.h"
 
 /******************************************************************************
@@ -12,6 +13,7 @@
  ******************************************************************************/
 
 #define GPIO_LOCK_KEY           0x4C4F434B
+#define DIO_PORT_COUNT          6
 
 /* Helper macros to get register address based on port (0-5) */
 #define GET_GPIO_DATA(port)   ((port) == 0 ? &GPIO_PORTA_DATA_R : \
@@ -70,6 +72,57 @@
                                (port) == 4 ? &GPIO_PORTE_CR_R : \
                                &GPIO_PORTF_CR_R)
 
+#define GET_GPIO_IS(port)     ((port) == 0 ? &GPIO_PORTA_IS_R : \
+                               (port) == 1 ? &GPIO_PORTB_IS_R : \
+                               (port) == 2 ? &GPIO_PORTC_IS_R : \
+                               (port) == 3 ? &GPIO_PORTD_IS_R : \
+                               (port) == 4 ? &GPIO_PORTE_IS_R : \
+                               &GPIO_PORTF_IS_R)
+
+#define GET_GPIO_IBE(port)    ((port) == 0 ? &GPIO_PORTA_IBE_R : \
+                               (port) == 1 ? &GPIO_PORTB_IBE_R : \
+                               (port) == 2 ? &GPIO_PORTC_IBE_R : \
+                               (port) == 3 ? &GPIO_PORTD_IBE_R : \
+                               (port) == 4 ? &GPIO_PORTE_IBE_R : \
+                               &GPIO_PORTF_IBE_R)
+
+#define GET_GPIO_IEV(port)    ((port) == 0 ? &GPIO_PORTA_IEV_R : \
+                               (port) == 1 ? &GPIO_PORTB_IEV_R : \
+                               (port) == 2 ? &GPIO_PORTC_IEV_R : \
+                               (port) == 3 ? &GPIO_PORTD_IEV_R : \
+                               (port) == 4 ? &GPIO_PORTE_IEV_R : \
+                               &GPIO_PORTF_IEV_R)
+
+#define GET_GPIO_IM(port)     ((port) == 0 ? &GPIO_PORTA_IM_R : \
+                               (port) == 1 ? &GPIO_PORTB_IM_R : \
+                               (port) == 2 ? &GPIO_PORTC_IM_R : \
+                               (port) == 3 ? &GPIO_PORTD_IM_R : \
+                               (port) == 4 ? &GPIO_PORTE_IM_R : \
+                               &GPIO_PORTF_IM_R)
+
+#define GET_GPIO_MIS(port)    ((port) == 0 ? &GPIO_PORTA_MIS_R : \
+                               (port) == 1 ? &GPIO_PORTB_MIS_R : \
+                               (port) == 2 ? &GPIO_PORTC_MIS_R : \
+                               (port) == 3 ? &GPIO_PORTD_MIS_R : \
+                               (port) == 4 ? &GPIO_PORTE_MIS_R : \
+                               &GPIO_PORTF_MIS_R)
+
+#define GET_GPIO_ICR(port)    ((port) == 0 ? &GPIO_PORTA_ICR_R : \
+                               (port) == 1 ? &GPIO_PORTB_ICR_R : \
+                               (port) == 2 ? &GPIO_PORTC_ICR_R : \
+                               (port) == 3 ? &GPIO_PORTD_ICR_R : \
+                               (port) == 4 ? &GPIO_PORTE_ICR_R : \
+                               &GPIO_PORTF_ICR_R)
+
+/******************************************************************************
+ * Private Data
+ ******************************************************************************/
+
+/* NVIC lines of the port interrupts (port F sits apart from A-E) */
+static const uint8_t portIrq[DIO_PORT_COUNT] = {0, 1, 2, 3, 4, 30};
+
+static volatile DIO_Callback_t portCallback[DIO_PORT_COUNT];
+
 /******************************************************************************
  * Function Implementations
  ******************************************************************************/
@@ -79,7 +132,8 @@ void DIO_Init(uint8_t port, uint8_t pin, uint8_t direction) {
     SYSCTL_RCGCGPIO_R |= (1 << port);
     delay = SYSCTL_RCGCGPIO_R;
     delay = SYSCTL_RCGCGPIO_R;
-
+    (void)delay;
+    
     *GET_GPIO_LOCK(port) = GPIO_LOCK_KEY;
     *GET_GPIO_CR(port) |= (1 << pin);
     *GET_GPIO_AFSEL(port) &= ~(1 << pin);
@@ -132,3 +186,57 @@ void DIO_SetPDR(uint8_t port, uint8_t pin, uint8_t enable) {
         *GET_GPIO_PDR(port) &= ~(1 << pin);
     }
 }
+
+uint8_t DIO_ReadPort(uint8_t port) {
+    return (uint8_t)(*GET_GPIO_DATA(port) & 0xFF);
+}
+
+/******************************************************************************
+ * Edge Interrupts
+ ******************************************************************************/
+
+void DIO_SetInterrupt(uint8_t port, uint8_t pinMask, uint8_t edge, DIO_Callback_t callback) {
+    *GET_GPIO_IM(port) &= ~pinMask;             /* Masked while reconfigured */
+    *GET_GPIO_IS(port) &= ~pinMask;             /* Edge, not level */
+    
+    if (edge == EDGE_BOTH) {
+        *GET_GPIO_IBE(port) |= pinMask;
+    } else {
+        *GET_GPIO_IBE(port) &= ~pinMask;
+        if (edge == EDGE_RISING) {
+            *GET_GPIO_IEV(port) |= pinMask;
+        } else {
+            *GET_GPIO_IEV(port) &= ~pinMask;
+        }
+    }
+    
+    *GET_GPIO_ICR(port) = pinMask;
+    portCallback[port] = callback;
+    NVIC_EN0_R = 1UL << portIrq[port];
+}
+
+void DIO_EnableInterrupt(uint8_t port, uint8_t pinMask) {
+    *GET_GPIO_ICR(port) = pinMask;
+    *GET_GPIO_IM(port) |= pinMask;
+}
+
+void DIO_DisableInterrupt(uint8_t port, uint8_t pinMask) {
+    *GET_GPIO_IM(port) &= ~pinMask;
+}
+
+/* Acknowledge the pins that fired, then hand them to the port's callback */
+static void DIO_Dispatch(uint8_t port) {
+    uint8_t pins = (uint8_t)(*GET_GPIO_MIS(port) & 0xFF);
+    
+    *GET_GPIO_ICR(port) = pins;
+    if (portCallback[port] != NULL) {
+        portCallback[port](pins);
+    }
+}
+
+void GPIOPortAHandler(void) { DIO_Dispatch(PORTA); }
+void GPIOPortBHandler(void) { DIO_Dispatch(PORTB); }
+void GPIOPortCHandler(void) { DIO_Dispatch(PORTC); }
+void GPIOPortDHandler(void) { DIO_Dispatch(PORTD); }
+void GPIOPortEHandler(void) { DIO_Dispatch(PORTE); }
+void GPIOPortFHandler(void) { DIO_Dispatch(PORTF); }
@@ -43,6 +43,14 @@
 #define ENABLE      1
 #define DISABLE     0
 
+/* Interrupt Edge Definitions */
+#define EDGE_FALLING    0
+#define EDGE_RISING     1
+#define EDGE_BOTH       2
+
+/* Port interrupt callback (ISR context); pins is the mask that fired */
+typedef void (*DIO_Callback_t)(uint8_t pins);
+
 /******************************************************************************
  * Function Prototypes
  ******************************************************************************/
@@ -53,5 +61,22 @@ uint8_t DIO_ReadPin(uint8_t port, uint8_t pin);
 void DIO_TogglePin(uint8_t port, uint8_t pin);
 void DIO_SetPUR(uint8_t port, uint8_t pin, uint8_t enable);
 void DIO_SetPDR(uint8_t port, uint8_t pin, uint8_t enable);
+uint8_t DIO_ReadPort(uint8_t port);
+
+/* Edge interrupts. DIO_SetInterrupt configures the pins (left masked) and
+ * enables the port in the NVIC; one callback per port. DIO_EnableInterrupt
+ * clears edges latched while masked before unmasking, so callers that
+ * must not miss one re-check the pin level afterwards. */
+void DIO_SetInterrupt(uint8_t port, uint8_t pinMask, uint8_t edge, DIO_Callback_t callback);
+void DIO_EnableInterrupt(uint8_t port, uint8_t pinMask);
+void DIO_DisableInterrupt(uint8_t port, uint8_t pinMask);
+
+/* Port ISRs (vector table entries) */
+void GPIOPortAHandler(void);
+void GPIOPortBHandler(void);
+void GPIOPortCHandler(void);
+void GPIOPortDHandler(void);
+void GPIOPortEHandler(void);
+void GPIOPortFHandler(void);
 
 #endif /* DIO_H_ */
@@ -0,0 +1,70 @@
+/******************************************************************************
+ * File: gptimer.c
+ * Module: General-Purpose Timer (MCAL Layer)
+ * Description: Timer1A periodic interrupt for TM4C123GH6PM
+ ******************************************************************************/
+
+#include "gptimer.h"
+#include <stddef.h>
+#include "../lib/tm4c123gh6pm.h"
+
+/* NVIC line of the Timer1A interrupt */
+#define TIMER1A_IRQ         21
+
+/* Timer1 counts the system clock */
+#define CYCLES_PER_US       16UL
+
+static volatile GPTimer_Callback_t timerCallback = NULL;
+
+/******************************************************************************
+ * Initialize Timer1A
+ ******************************************************************************/
+void GPTimer_Init(void)
+{
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;
+    while ((SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R1) == 0);
+    
+    TIMER1_CTL_R = 0;                           /* Stopped while configuring */
+    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;     /* Down-counting, reloads */
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER1_IMR_R = TIMER_IMR_TATOIM;
+    timerCallback = NULL;
+    NVIC_EN0_R = 1UL << TIMER1A_IRQ;
+}
+
+/******************************************************************************
+ * Start / stop
+ ******************************************************************************/
+void GPTimer_Start(uint32_t periodUs, GPTimer_Callback_t callback)
+{
+    TIMER1_CTL_R = 0;
+    timerCallback = callback;
+    TIMER1_TAILR_R = periodUs * CYCLES_PER_US - 1;
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER1_CTL_R = TIMER_CTL_TAEN;
+}
+
+void GPTimer_Stop(void)
+{
+    TIMER1_CTL_R = 0;
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+}
+
+bool GPTimer_IsRunning(void)
+{
+    return (TIMER1_CTL_R & TIMER_CTL_TAEN) != 0;
+}
+
+/******************************************************************************
+ * Timer1A ISR
+ ******************************************************************************/
+void Timer1AHandler(void)
+{
+    GPTimer_Callback_t callback = timerCallback;
+    
+    TIMER1_ICR_R = TIMER_ICR_TATOCINT;
+    if (callback != NULL) {
+        callback();
+    }
+}
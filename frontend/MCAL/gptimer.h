@@ -0,0 +1,47 @@
+/******************************************************************************
+ * File: gptimer.h
+ * Module: General-Purpose Timer (MCAL Layer)
+ * Description: Periodic microsecond-resolution interrupt on Timer1A, for
+ *              drivers that need a tick finer or more exact than SysTick
+ ******************************************************************************/
+
+#ifndef GPTIMER_H
+#define GPTIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Called from Timer1AHandler (ISR context) on every period */
+typedef void (*GPTimer_Callback_t)(void);
+
+/**
+ * @brief Clock Timer1 and configure Timer A as a stopped 32-bit periodic
+ *        timer with its time-out interrupt enabled in the NVIC
+ */
+void GPTimer_Init(void);
+
+/**
+ * @brief Start (or restart) the timer; the first callback comes one
+ *        period from now
+ * @param periodUs Period in microseconds (at least 1)
+ * @param callback Run from the ISR on every time-out
+ */
+void GPTimer_Start(uint32_t periodUs, GPTimer_Callback_t callback);
+
+/**
+ * @brief Stop the timer and drop a time-out that is already pending;
+ *        safe from the callback itself
+ */
+void GPTimer_Stop(void);
+
+/**
+ * @brief true between GPTimer_Start and GPTimer_Stop
+ */
+bool GPTimer_IsRunning(void);
+
+/**
+ * @brief Timer1A time-out ISR (vector table entry)
+ */
+void Timer1AHandler(void);
+
+#endif /* GPTIMER_H */
@@ -5,27 +5,17 @@
  ******************************************************************************/
 
 #include "i2c.h"
+#include <stddef.h>
+#include <intrinsics.h>
+#include "systick.h"
 #include "../lib/tm4c123gh6pm.h"
 
 /******************************************************************************
  *                              Macros                                         *
  ******************************************************************************/
 
-/* I2C Master Control/Status Register Bits */
-#define I2C_MCS_BUSY    0x01  /* I2C Busy */
-#define I2C_MCS_ERROR   0x02  /* Error */
-#define I2C_MCS_ADRACK  0x04  /* Acknowledge Address */
-#define I2C_MCS_DATACK  0x08  /* Acknowledge Data */
-#define I2C_MCS_ARBLST  0x10  /* Arbitration Lost */
-#define I2C_MCS_IDLE    0x20  /* I2C Idle */
-#define I2C_MCS_BUSBSY  0x40  /* Bus Busy */
-#define I2C_MCS_CLKTO   0x80  /* Clock Timeout Error */
-
-/* I2C Master Control/Status Commands */
-#define I2C_MCS_RUN     0x01  /* I2C Master Enable */
-#define I2C_MCS_START   0x02  /* Generate START */
-#define I2C_MCS_STOP    0x04  /* Generate STOP */
-#define I2C_MCS_ACK     0x08  /* Data Acknowledge Enable */
+/* I2C_MCS_xxx status bits and commands, I2C_MIMR_IM and I2C_MICR_IC come
+ * from tm4c123gh6pm.h */
 
 /* Combined commands for common operations */
 #define I2C_MASTER_CMD_SINGLE_SEND      (I2C_MCS_RUN | I2C_MCS_START | I2C_MCS_STOP)
@@ -34,30 +24,84 @@
 #define I2C_MASTER_CMD_BURST_SEND_CONT  (I2C_MCS_RUN)
 #define I2C_MASTER_CMD_BURST_SEND_FINISH (I2C_MCS_RUN | I2C_MCS_STOP)
 
+/* NVIC line of the I2C0 interrupt */
+#define I2C0_IRQ        8
+
 /* System Clock Frequency (Hz) */
 #define SYSTEM_CLOCK_FREQ   16000000UL
 
 /* GPIO Configuration */
 #define GPIO_LOCK_KEY       0x4C4F434B
 
+/* I2C0 pins on port B */
+#define I2C0_SCL_PIN        (1U << 2)   /* PB2 */
+#define I2C0_SDA_PIN        (1U << 3)   /* PB3 */
+
+/* A byte takes under 0.1 ms even at 100 kHz, so no interrupt (or BUSY
+ * still set) this long after the last one means the bus is stuck */
+#define I2C_STALL_MS        10
+
+/* Bus recovery clocks SCL by hand at about 100 kHz: a slave left mid-byte
+ * lets go of SDA within 9 clocks */
+#define I2C_RECOVERY_CLOCKS     9
+#define I2C_RECOVERY_HALF_US    5
+
 /******************************************************************************
  *                         Private Function Prototypes                         *
  ******************************************************************************/
 
-static void I2C_WaitBusy(uint8_t module);
+static uint8_t I2C_WaitBusy(uint8_t module);
 static volatile uint32_t* I2C_GetMCRReg(uint8_t module);
 static volatile uint32_t* I2C_GetMTPRReg(uint8_t module);
 static volatile uint32_t* I2C_GetMSAReg(uint8_t module);
 static volatile uint32_t* I2C_GetMDRReg(uint8_t module);
 static volatile uint32_t* I2C_GetMCSReg(uint8_t module);
+static void I2C0_Command(uint8_t cmd);
+static void I2C0_SendNext(uint8_t start);
+static void I2C0_ReceiveNext(uint8_t start);
+static void I2C0_Start(I2C_Transfer_t *xfer);
+static void I2C0_Finish(uint8_t status);
+static uint8_t I2C0_RecoverBus(void);
+static void I2C0_Reset(void);
+static uint8_t I2C0_Transfer(uint8_t slaveAddr, const uint8_t *txData, uint8_t txLength,
+                             uint8_t *rxData, uint8_t rxLength);
+
+/******************************************************************************
+ *                         Private Variables                                   *
+ ******************************************************************************/
+
+/* I2C0 transfer queue: the head is on the bus. Changed by the ISR or with
+ * interrupts masked. */
+static I2C_Transfer_t *volatile queueHead = NULL;
+static I2C_Transfer_t *volatile queueTail = NULL;
+
+/* Progress of the head transfer */
+static uint8_t txIndex = 0;        /* Bytes handed to the master */
+static uint8_t rxIndex = 0;        /* Bytes received */
+static uint8_t lastCmd = 0;        /* Last MCS command written */
+static uint8_t receiving = 0;      /* Last command reads a byte */
+static uint8_t stopping = 0;       /* STOP after an error is in progress */
+
+/* SysTick_GetMs() of the last progress on the bus, for I2C_Wait */
+static volatile uint32_t progressMs = 0;
+
+/* MTPR value, restored after a module reset */
+static uint32_t i2c0Tpr = 0;
 
 /******************************************************************************
  *                         Private Functions                                   *
  ******************************************************************************/
 
-static void I2C_WaitBusy(uint8_t module) {
+/* Returns I2C_ERROR if the master is still busy after I2C_STALL_MS
+ * (needs SysTick running in SYSTICK_INT mode to time out) */
+static uint8_t I2C_WaitBusy(uint8_t module) {
     volatile uint32_t *mcsReg = I2C_GetMCSReg(module);
-    while (*mcsReg & I2C_MCS_BUSY);
+    uint32_t start = SysTick_GetMs();
+    
+    while (*mcsReg & I2C_MCS_BUSY) {
+        if (SysTick_GetMs() - start >= I2C_STALL_MS) return I2C_ERROR;
+    }
+    return I2C_SUCCESS;
 }
 
 static volatile uint32_t* I2C_GetMCRReg(uint8_t module) {
@@ -110,6 +154,163 @@ static volatile uint32_t* I2C_GetMCSReg(uint8_t module) {
     }
 }
 
+/*
+ * I2C0 queue. Every MCS command moves one byte (plus START/address or
+ * STOP as asked) and raises the master interrupt when it is done, which
+ * issues the next one.
+ */
+static void I2C0_Command(uint8_t cmd) {
+    lastCmd = cmd;
+    I2C0_MCS_R = cmd;
+}
+
+static void I2C0_SendNext(uint8_t start) {
+    I2C_Transfer_t *xfer = queueHead;
+    uint8_t cmd = I2C_MCS_RUN | start;
+    
+    I2C0_MDR_R = xfer->txData[txIndex++];
+    if (txIndex == xfer->txLength && xfer->rxLength == 0) {
+        cmd |= I2C_MCS_STOP;
+    }
+    receiving = 0;
+    I2C0_Command(cmd);
+}
+
+static void I2C0_ReceiveNext(uint8_t start) {
+    I2C_Transfer_t *xfer = queueHead;
+    uint8_t cmd = I2C_MCS_RUN | start;
+    
+    if (start) {
+        I2C0_MSA_R = (xfer->slaveAddr << 1) | 0x01;
+    }
+    /* ACK every byte but the last, which ends with STOP */
+    cmd |= (rxIndex == xfer->rxLength - 1) ? I2C_MCS_STOP : I2C_MCS_ACK;
+    receiving = 1;
+    I2C0_Command(cmd);
+}
+
+static void I2C0_Start(I2C_Transfer_t *xfer) {
+    progressMs = SysTick_GetMs();
+    txIndex = 0;
+    rxIndex = 0;
+    stopping = 0;
+    
+    if (xfer->txLength > 0) {
+        I2C0_MSA_R = (xfer->slaveAddr << 1) & 0xFE;
+        I2C0_SendNext(I2C_MCS_START);
+    } else {
+        I2C0_ReceiveNext(I2C_MCS_START);
+    }
+}
+
+/* Pop the head transfer, start the next one, then report */
+static void I2C0_Finish(uint8_t status) {
+    I2C_Transfer_t *xfer = queueHead;
+    
+    queueHead = xfer->next;
+    if (queueHead == NULL) {
+        queueTail = NULL;
+    } else {
+        I2C0_Start(queueHead);
+    }
+    
+    xfer->status = status;
+    if (xfer->callback != NULL) {
+        xfer->callback(xfer);
+    }
+}
+
+/*
+ * Free a bus a slave holds: if SDA is low (the MCU reset in the middle of
+ * a read, say), take the pins as GPIO and clock SCL until the slave lets
+ * go, then send a STOP so every device is idle again. SDA stays an input
+ * except while the STOP pulls it low, as an output reads back what was
+ * written rather than the line. Returns I2C_ERROR if SDA or SCL is still
+ * low afterwards.
+ */
+static uint8_t I2C0_RecoverBus(void) {
+    uint8_t clocks = 0;
+    uint8_t result;
+    
+    /* SCL an open-drain output, released (high); SDA an input. The
+     * pins only leave the I2C function once that is set up. */
+    GPIO_PORTB_ODR_R |= I2C0_SCL_PIN | I2C0_SDA_PIN;
+    GPIO_PORTB_DIR_R |= I2C0_SCL_PIN;
+    GPIO_PORTB_DIR_R &= ~I2C0_SDA_PIN;
+    GPIO_PORTB_DATA_R |= I2C0_SCL_PIN;
+    GPIO_PORTB_AFSEL_R &= ~(I2C0_SCL_PIN | I2C0_SDA_PIN);
+    DelayUs(I2C_RECOVERY_HALF_US);
+    
+    if ((GPIO_PORTB_DATA_R & I2C0_SDA_PIN) == 0) {
+        while (clocks < I2C_RECOVERY_CLOCKS && (GPIO_PORTB_DATA_R & I2C0_SDA_PIN) == 0) {
+            GPIO_PORTB_DATA_R &= ~I2C0_SCL_PIN;
+            DelayUs(I2C_RECOVERY_HALF_US);
+            GPIO_PORTB_DATA_R |= I2C0_SCL_PIN;
+            DelayUs(I2C_RECOVERY_HALF_US);
+            clocks++;
+        }
+        
+        /* STOP: pull SDA low while SCL is low, raise SCL, release SDA */
+        GPIO_PORTB_DATA_R &= ~(I2C0_SCL_PIN | I2C0_SDA_PIN);
+        GPIO_PORTB_DIR_R |= I2C0_SDA_PIN;
+        DelayUs(I2C_RECOVERY_HALF_US);
+        GPIO_PORTB_DATA_R |= I2C0_SCL_PIN;
+        DelayUs(I2C_RECOVERY_HALF_US);
+        GPIO_PORTB_DIR_R &= ~I2C0_SDA_PIN;
+        DelayUs(I2C_RECOVERY_HALF_US);
+    }
+    
+    /* Both as inputs to read the lines */
+    GPIO_PORTB_DIR_R &= ~I2C0_SCL_PIN;
+    result = ((GPIO_PORTB_DATA_R & (I2C0_SCL_PIN | I2C0_SDA_PIN)) ==
+              (I2C0_SCL_PIN | I2C0_SDA_PIN)) ? I2C_SUCCESS : I2C_ERROR;
+    
+    /* Back to the I2C function (SCL is push-pull there) */
+    GPIO_PORTB_ODR_R &= ~I2C0_SCL_PIN;
+    GPIO_PORTB_AFSEL_R |= I2C0_SCL_PIN | I2C0_SDA_PIN;
+    
+    return result;
+}
+
+/*
+ * Give up on the transfer on the bus: reset the I2C0 module, which is the
+ * only way to get the master out of a command that never ends, free the
+ * bus and fail the transfer. The queue carries on with the next one.
+ * Called with interrupts masked.
+ */
+static void I2C0_Reset(void) {
+    SYSCTL_SRI2C_R |= SYSCTL_SRI2C_R0;
+    I2C0_RecoverBus();
+    SYSCTL_SRI2C_R &= ~SYSCTL_SRI2C_R0;
+    while ((SYSCTL_PRI2C_R & SYSCTL_PRI2C_R0) == 0);
+    
+    I2C0_MCR_R = I2C_MCR_MFE;
+    I2C0_MTPR_R = i2c0Tpr;
+    I2C0_MICR_R = I2C_MICR_IC;
+    I2C0_MIMR_R = I2C_MIMR_IM;
+    
+    if (queueHead != NULL) {
+        queueHead->error = I2C_ERR_TIMEOUT;
+        I2C0_Finish(I2C_ERROR);
+    }
+}
+
+/* Blocking I2C0 access: queued behind any background transfers */
+static uint8_t I2C0_Transfer(uint8_t slaveAddr, const uint8_t *txData, uint8_t txLength,
+                             uint8_t *rxData, uint8_t rxLength) {
+    I2C_Transfer_t xfer;
+    
+    xfer.slaveAddr = slaveAddr;
+    xfer.txData = txData;
+    xfer.txLength = txLength;
+    xfer.rxData = rxData;
+    xfer.rxLength = rxLength;
+    xfer.callback = NULL;
+    
+    if (I2C_Submit(&xfer) != I2C_SUCCESS) return I2C_ERROR;
+    return I2C_Wait(&xfer);
+}
+
 /******************************************************************************
  *                         Public Functions                                    *
  ******************************************************************************/
@@ -152,6 +353,7 @@ void I2C_Init(uint8_t module, uint32_t speed) {
     /* Enable GPIO clock for the corresponding port */
     SYSCTL_RCGCGPIO_R |= (1 << port);
     delay = SYSCTL_RCGCGPIO_R;
+    (void)delay;
     
     /* Wait for peripheral to be ready */
     while ((SYSCTL_PRGPIO_R & (1 << port)) == 0);
@@ -194,7 +396,7 @@ void I2C_Init(uint8_t module, uint32_t speed) {
     volatile uint32_t *mcrReg = I2C_GetMCRReg(module);
     volatile uint32_t *mtprReg = I2C_GetMTPRReg(module);
     
-    *mcrReg = 0x10; /* Enable I2C Master function */
+    *mcrReg = I2C_MCR_MFE; /* Enable I2C Master function */
     
     /* Calculate and set Timer Period
      * TPR = (System Clock / (2 * SCL_LP * SCL_CLOCK)) - 1
@@ -202,6 +404,18 @@ void I2C_Init(uint8_t module, uint32_t speed) {
      */
     uint32_t tpr = (SYSTEM_CLOCK_FREQ / (2 * 10 * speed)) - 1;
     *mtprReg = tpr;
+    
+    /* I2C0 runs its transfers from the master interrupt, on a bus freed
+     * from whatever a reset left it in */
+    if (module == I2C_MODULE_0) {
+        i2c0Tpr = tpr;
+        I2C0_RecoverBus();
+        queueHead = NULL;
+        queueTail = NULL;
+        I2C0_MICR_R = I2C_MICR_IC;
+        I2C0_MIMR_R = I2C_MIMR_IM;
+        NVIC_EN0_R = 1UL << I2C0_IRQ;
+    }
 }
 
 uint8_t I2C_WriteByte(uint8_t module, uint8_t slaveAddr, uint8_t data) {
@@ -209,8 +423,10 @@ uint8_t I2C_WriteByte(uint8_t module, uint8_t slaveAddr, uint8_t data) {
     volatile uint32_t *mdrReg = I2C_GetMDRReg(module);
     volatile uint32_t *mcsReg = I2C_GetMCSReg(module);
     
+    if (module == I2C_MODULE_0) return I2C0_Transfer(slaveAddr, &data, 1, NULL, 0);
+    
     /* Wait for I2C to be idle */
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     /* Set slave address for write operation */
     *msaReg = (slaveAddr << 1) & 0xFE; /* Clear R/S bit for write */
@@ -222,7 +438,7 @@ uint8_t I2C_WriteByte(uint8_t module, uint8_t slaveAddr, uint8_t data) {
     *mcsReg = I2C_MASTER_CMD_SINGLE_SEND;
     
     /* Wait for transmission to complete */
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     /* Check for errors */
     if (*mcsReg & I2C_MCS_ERROR) {
@@ -241,9 +457,11 @@ uint8_t I2C_WriteMultipleBytes(uint8_t module, uint8_t slaveAddr,
     uint8_t i;
     
     if (length == 0) return I2C_ERROR;
+    if (module == I2C_MODULE_0) return I2C0_Transfer(slaveAddr, data, length, NULL, 0);
+    if (length == 1) return I2C_WriteByte(module, slaveAddr, data[0]);
     
     /* Wait for I2C to be idle */
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     /* Set slave address for write operation */
     *msaReg = (slaveAddr << 1) & 0xFE;
@@ -251,7 +469,7 @@ uint8_t I2C_WriteMultipleBytes(uint8_t module, uint8_t slaveAddr,
     /* Send first byte with START condition */
     *mdrReg = data[0];
     *mcsReg = I2C_MASTER_CMD_BURST_SEND_START;
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     if (*mcsReg & I2C_MCS_ERROR) {
         *mcsReg = I2C_MCS_STOP;
@@ -262,7 +480,7 @@ uint8_t I2C_WriteMultipleBytes(uint8_t module, uint8_t slaveAddr,
     for (i = 1; i < length - 1; i++) {
         *mdrReg = data[i];
         *mcsReg = I2C_MASTER_CMD_BURST_SEND_CONT;
-        I2C_WaitBusy(module);
+        if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
         
         if (*mcsReg & I2C_MCS_ERROR) {
             *mcsReg = I2C_MCS_STOP;
@@ -273,7 +491,7 @@ uint8_t I2C_WriteMultipleBytes(uint8_t module, uint8_t slaveAddr,
     /* Send last byte with STOP condition */
     *mdrReg = data[length - 1];
     *mcsReg = I2C_MASTER_CMD_BURST_SEND_FINISH;
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     if (*mcsReg & I2C_MCS_ERROR) {
         *mcsReg = I2C_MCS_STOP;
@@ -288,8 +506,10 @@ uint8_t I2C_ReadByte(uint8_t module, uint8_t slaveAddr, uint8_t *data) {
     volatile uint32_t *mdrReg = I2C_GetMDRReg(module);
     volatile uint32_t *mcsReg = I2C_GetMCSReg(module);
     
+    if (module == I2C_MODULE_0) return I2C0_Transfer(slaveAddr, NULL, 0, data, 1);
+    
     /* Wait for I2C to be idle */
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     /* Set slave address for read operation */
     *msaReg = (slaveAddr << 1) | 0x01; /* Set R/S bit for read */
@@ -298,7 +518,7 @@ uint8_t I2C_ReadByte(uint8_t module, uint8_t slaveAddr, uint8_t *data) {
     *mcsReg = I2C_MASTER_CMD_SINGLE_RECEIVE;
     
     /* Wait for reception to complete */
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     /* Check for errors */
     if (*mcsReg & I2C_MCS_ERROR) {
@@ -320,16 +540,17 @@ uint8_t I2C_ReadMultipleBytes(uint8_t module, uint8_t slaveAddr,
     uint8_t i;
     
     if (length == 0) return I2C_ERROR;
+    if (module == I2C_MODULE_0) return I2C0_Transfer(slaveAddr, NULL, 0, data, length);
     
     /* Wait for I2C to be idle */
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     /* Set slave address for read operation */
     *msaReg = (slaveAddr << 1) | 0x01;
     
     /* Receive first byte with START and ACK */
     *mcsReg = (I2C_MCS_RUN | I2C_MCS_START | I2C_MCS_ACK);
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     if (*mcsReg & I2C_MCS_ERROR) {
         *mcsReg = I2C_MCS_STOP;
@@ -341,7 +562,7 @@ uint8_t I2C_ReadMultipleBytes(uint8_t module, uint8_t slaveAddr,
     /* Receive middle bytes with ACK */
     for (i = 1; i < length - 1; i++) {
         *mcsReg = (I2C_MCS_RUN | I2C_MCS_ACK);
-        I2C_WaitBusy(module);
+        if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
         
         if (*mcsReg & I2C_MCS_ERROR) {
             *mcsReg = I2C_MCS_STOP;
@@ -353,7 +574,7 @@ uint8_t I2C_ReadMultipleBytes(uint8_t module, uint8_t slaveAddr,
     
     /* Receive last byte with STOP (no ACK) */
     *mcsReg = (I2C_MCS_RUN | I2C_MCS_STOP);
-    I2C_WaitBusy(module);
+    if (I2C_WaitBusy(module) != I2C_SUCCESS) return I2C_ERROR;
     
     if (*mcsReg & I2C_MCS_ERROR) {
         *mcsReg = I2C_MCS_STOP;
@@ -367,5 +588,114 @@ uint8_t I2C_ReadMultipleBytes(uint8_t module, uint8_t slaveAddr,
 
 uint8_t I2C_IsBusy(uint8_t module) {
     volatile uint32_t *mcsReg = I2C_GetMCSReg(module);
+    if (module == I2C_MODULE_0 && queueHead != NULL) return 1;
     return (*mcsReg & I2C_MCS_BUSY) ? 1 : 0;
 }
+
+uint8_t I2C_Submit(I2C_Transfer_t *xfer) {
+    __istate_t state;
+    
+    if (xfer->txLength == 0 && xfer->rxLength == 0) {
+        xfer->status = I2C_ERROR;
+        return I2C_ERROR;
+    }
+    
+    xfer->next = NULL;
+    xfer->status = I2C_BUSY;
+    xfer->error = 0;
+    
+    /* Restored, not unmasked: callbacks submit from the ISR and from
+     * I2C0_Reset in I2C_Wait */
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    if (queueTail == NULL) {
+        queueHead = xfer;
+        queueTail = xfer;
+        I2C0_Start(xfer);
+    } else {
+        queueTail->next = xfer;
+        queueTail = xfer;
+    }
+    __set_interrupt_state(state);
+    
+    return I2C_SUCCESS;
+}
+
+uint8_t I2C_Wait(I2C_Transfer_t *xfer) {
+    __istate_t state;
+    
+    while (xfer->status == I2C_BUSY) {
+        /* Masked so the completing interrupt cannot slip in between the
+         * check and WFI; it runs once the caller's state is restored. The
+         * SysTick interrupt wakes us to check for a stuck bus. */
+        state = __get_interrupt_state();
+        __disable_interrupt();
+        if (xfer->status == I2C_BUSY) {
+            if (SysTick_GetMs() - progressMs >= I2C_STALL_MS) {
+                I2C0_Reset();
+            } else {
+                __WFI();
+            }
+        }
+        __set_interrupt_state(state);
+    }
+    return xfer->status;
+}
+
+/******************************************************************************
+ *                         I2C0 ISR                                            *
+ ******************************************************************************/
+
+void I2C0Handler(void) {
+    I2C_Transfer_t *xfer = queueHead;
+    uint32_t mcs;
+    
+    I2C0_MICR_R = I2C_MICR_IC;
+    if (xfer == NULL) return;
+    
+    progressMs = SysTick_GetMs();
+    mcs = I2C0_MCS_R;
+    if (stopping) {
+        /* The STOP that ends a failed transfer has gone out */
+        I2C0_Finish(I2C_ERROR);
+        return;
+    }
+    
+    if (mcs & I2C_MCS_ERROR) {
+        if (mcs & I2C_MCS_ARBLST) {
+            xfer->error = I2C_ERR_ARB_LOST;
+        } else if (mcs & I2C_MCS_ADRACK) {
+            xfer->error = I2C_ERR_ADDR_NACK;
+        } else {
+            xfer->error = I2C_ERR_DATA_NACK;
+        }
+        
+        /* The master only releases the bus itself if the command asked for
+         * STOP or it lost arbitration; otherwise send one first. There is
+         * no other master on this bus, so a lost arbitration means a
+         * slave is holding SDA low: free it before the next transfer. */
+        if (mcs & I2C_MCS_ARBLST) {
+            I2C0_RecoverBus();
+            I2C0_Finish(I2C_ERROR);
+        } else if (lastCmd & I2C_MCS_STOP) {
+            I2C0_Finish(I2C_ERROR);
+        } else {
+            stopping = 1;
+            I2C0_Command(I2C_MCS_STOP);
+        }
+        return;
+    }
+    
+    if (receiving) {
+        xfer->rxData[rxIndex++] = (uint8_t)(I2C0_MDR_R & 0xFF);
+    }
+    
+    if (txIndex < xfer->txLength) {
+        I2C0_SendNext(0);
+    } else if (rxIndex < xfer->rxLength) {
+        /* Repeated START turns the bus around after the write part */
+        I2C0_ReceiveNext(rxIndex == 0 ? I2C_MCS_START : 0);
+    } else {
+        I2C0_Finish(I2C_SUCCESS);
+    }
+}
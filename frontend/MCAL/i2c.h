@@ -28,12 +28,37 @@
 #define I2C_ERROR       1
 #define I2C_BUSY        2
 
+/* Error flags of a failed transfer (I2C_Transfer_t.error) */
+#define I2C_ERR_ADDR_NACK   0x01    /* No device answered the address */
+#define I2C_ERR_DATA_NACK   0x02    /* Device refused a data byte */
+#define I2C_ERR_ARB_LOST    0x04    /* Lost SDA: a slave held it low (bus recovered) */
+#define I2C_ERR_TIMEOUT     0x08    /* Bus stuck for 10 ms (module reset) */
+
 /* Port/Pin Configuration for I2C Modules */
 /* I2C0: PB2 (SCL), PB3 (SDA) */
 /* I2C1: PA6 (SCL), PA7 (SDA) */
 /* I2C2: PE4 (SCL), PE5 (SDA) */
 /* I2C3: PD0 (SCL), PD1 (SDA) */
 
+/* Queued transfer on I2C0: write txLength bytes, then (after a repeated
+ * START) read rxLength bytes. Either length may be 0, not both. */
+typedef struct I2C_Transfer I2C_Transfer_t;
+
+typedef void (*I2C_Callback_t)(I2C_Transfer_t *xfer);
+
+struct I2C_Transfer {
+    I2C_Transfer_t *next;           /* Queue link, owned by the driver */
+    uint8_t slaveAddr;              /* 7-bit address */
+    const uint8_t *txData;
+    uint8_t txLength;
+    uint8_t *rxData;
+    uint8_t rxLength;
+    volatile uint8_t status;        /* I2C_BUSY until done, then I2C_SUCCESS/I2C_ERROR */
+    uint8_t error;                  /* I2C_ERR_xxx when status is I2C_ERROR */
+    I2C_Callback_t callback;        /* Called from the I2C0 ISR when done, or NULL */
+    void *arg;                      /* For the callback */
+};
+
 /******************************************************************************
  * Function Prototypes
  ******************************************************************************/
@@ -43,6 +68,9 @@
  * Parameters:
  *   - module: I2C module number (0-3)
  *   - speed: I2C bus speed in Hz (e.g., I2C_SPEED_100K)
+ * Note: On I2C0, a bus left held by a slave (SDA low) is recovered first
+ *       by clocking SCL and sending a STOP. May be called again to change
+ *       speed while no transfer is queued.
  */
 void I2C_Init(uint8_t module, uint32_t speed);
 
@@ -98,4 +126,33 @@ uint8_t I2C_ReadMultipleBytes(uint8_t module, uint8_t slaveAddr,
  */
 uint8_t I2C_IsBusy(uint8_t module);
 
+/*
+ * Description: Queue a transfer on I2C0 and return at once; the I2C0
+ *              interrupt runs the queue in order
+ * Parameters:
+ *   - xfer: Filled-in transfer; it and its buffers must stay valid and
+ *           untouched until status leaves I2C_BUSY
+ * Returns: I2C_SUCCESS if queued, I2C_ERROR if it has nothing to transfer
+ * Note: The blocking functions above queue on I2C0 as well, so they wait
+ *       for earlier transfers. Callbacks may queue further transfers.
+ */
+uint8_t I2C_Submit(I2C_Transfer_t *xfer);
+
+/*
+ * Description: Sleep until a queued transfer has finished
+ * Parameters:
+ *   - xfer: Transfer passed to I2C_Submit
+ * Returns: I2C_SUCCESS or I2C_ERROR
+ * Note: Not from interrupt context (the I2C0 interrupt must be able to run)
+ *       If the bus makes no progress for 10 ms (SCL held low, say), the
+ *       module is reset and the transfer on it fails with I2C_ERR_TIMEOUT;
+ *       this needs SysTick running in SYSTICK_INT mode.
+ */
+uint8_t I2C_Wait(I2C_Transfer_t *xfer);
+
+/*
+ * Description: I2C0 master interrupt handler (vector table)
+ */
+void I2C0Handler(void);
+
 #endif /* I2C_H_ */
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * File: soft_timer.c
+ * Module: Software Timers (MCAL Layer)
+ * Description: One-shot and periodic callback timers on the SysTick
+ *              millisecond clock
+ ******************************************************************************/
+
+#include "soft_timer.h"
+#include "systick.h"
+#include <stddef.h>
+
+/* Armed timers, earliest expiry first */
+static SoftTimer_t *armed = NULL;
+
+static void Unlink(SoftTimer_t *timer)
+{
+    SoftTimer_t **link = &armed;
+    
+    if (!timer->active) return;
+    while (*link != NULL && *link != timer) {
+        link = &(*link)->next;
+    }
+    if (*link != NULL) *link = timer->next;
+    timer->next = NULL;
+    timer->active = false;
+}
+
+/* After any timer with the same expiry, so equal deadlines keep FIFO order */
+static void Link(SoftTimer_t *timer)
+{
+    SoftTimer_t **link = &armed;
+    
+    while (*link != NULL && (*link)->expiryMs <= timer->expiryMs) {
+        link = &(*link)->next;
+    }
+    timer->next = *link;
+    *link = timer;
+    timer->active = true;
+}
+
+static void Arm(SoftTimer_t *timer, uint32_t ms, uint32_t periodMs,
+                SoftTimer_Callback_t callback, void *arg)
+{
+    Unlink(timer);
+    if (ms == 0) ms = 1;
+    timer->expiryMs = SysTick_GetMs64() + ms;
+    timer->periodMs = periodMs;
+    timer->callback = callback;
+    timer->arg = arg;
+    Link(timer);
+}
+
+void SoftTimer_Init(void)
+{
+    while (armed != NULL) {
+        Unlink(armed);
+    }
+}
+
+void SoftTimer_Start(SoftTimer_t *timer, uint32_t ms,
+                     SoftTimer_Callback_t callback, void *arg)
+{
+    Arm(timer, ms, 0, callback, arg);
+}
+
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t periodMs,
+                             SoftTimer_Callback_t callback, void *arg)
+{
+    if (periodMs == 0) periodMs = 1;
+    Arm(timer, periodMs, periodMs, callback, arg);
+}
+
+void SoftTimer_Cancel(SoftTimer_t *timer)
+{
+    Unlink(timer);
+}
+
+bool SoftTimer_IsActive(const SoftTimer_t *timer)
+{
+    return timer->active;
+}
+
+uint32_t SoftTimer_MsUntilNext(void)
+{
+    uint64_t now = SysTick_GetMs64();
+    uint64_t wait;
+    
+    if (armed == NULL) return UINT32_MAX;
+    if (armed->expiryMs <= now) return 0;
+    wait = armed->expiryMs - now;
+    return (wait < UINT32_MAX) ? (uint32_t)wait : UINT32_MAX - 1;
+}
+
+void SoftTimer_Process(void)
+{
+    uint64_t now = SysTick_GetMs64();
+    SoftTimer_t *timer;
+    
+    while (armed != NULL && armed->expiryMs <= now) {
+        timer = armed;
+        Unlink(timer);
+        
+        /* Re-arm before the callback, so it may cancel or restart it */
+        if (timer->periodMs > 0) {
+            timer->expiryMs += timer->periodMs;
+            Link(timer);
+        }
+        timer->callback(timer->arg);
+    }
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * File: soft_timer.h
+ * Module: Software Timers (MCAL Layer)
+ * Description: One-shot and periodic callback timers on the SysTick
+ *              millisecond clock
+ ******************************************************************************/
+
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Callback run from SoftTimer_Process() (main loop context, never ISR) */
+typedef void (*SoftTimer_Callback_t)(void *arg);
+
+/*
+ * Timer control block, owned by the caller. Armed timers sit on one list
+ * sorted by expiry; the frontend only ever has a handful, so a linear
+ * insert beats the backend's timer wheel here. Fields are private to
+ * soft_timer.c.
+ */
+typedef struct SoftTimer {
+    struct SoftTimer    *next;
+    uint64_t             expiryMs;  /* SysTick_GetMs64() of next expiry */
+    uint32_t             periodMs;  /* 0 = one-shot */
+    bool                 active;
+    SoftTimer_Callback_t callback;
+    void                *arg;
+} SoftTimer_t;
+
+/**
+ * @brief Forget every armed timer
+ * @note SysTick must run in SYSTICK_INT mode with a 1 ms reload
+ */
+void SoftTimer_Init(void);
+
+/**
+ * @brief Arm a one-shot timer, restarting it if it is already armed
+ * @param ms Delay in milliseconds (at least 1)
+ */
+void SoftTimer_Start(SoftTimer_t *timer, uint32_t ms,
+                     SoftTimer_Callback_t callback, void *arg);
+
+/**
+ * @brief Arm a timer that expires every periodMs, measured from the
+ *        previous expiry so it does not drift
+ * @note After a stall the missed expiries are all delivered
+ */
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t periodMs,
+                             SoftTimer_Callback_t callback, void *arg);
+
+/**
+ * @brief Disarm a timer; safe on idle timers and from callbacks
+ */
+void SoftTimer_Cancel(SoftTimer_t *timer);
+
+/**
+ * @brief true while the timer is armed
+ */
+bool SoftTimer_IsActive(const SoftTimer_t *timer);
+
+/**
+ * @brief Milliseconds until the earliest armed timer expires
+ * @return 0 if one is already due, UINT32_MAX if none is armed
+ */
+uint32_t SoftTimer_MsUntilNext(void);
+
+/**
+ * @brief Run the callbacks of every timer that has expired, in expiry
+ *        order (timers due on the same millisecond run in start order)
+ * @note Call from the main loop. Start/Cancel are main-loop only too.
+ */
+void SoftTimer_Process(void);
+
+#endif /* SOFT_TIMER_H */
@@ -1,16 +1,18 @@
 /******************************************************************************
  * File: systick.c
  * Module: SysTick Timer
- * Description: SysTick delay functions for TM4C123GH6PM
+ * Description: SysTick delay functions and monotonic clock for TM4C123GH6PM
  ******************************************************************************/
 
 #include <stdint.h>
+#include <intrinsics.h>
 #include "../lib/tm4c123gh6pm.h"
 #include "systick.h"
-#include "dio.h"
 
-volatile uint32_t msTicks = 0;
+/* 64 bits, so the clock never wraps; the ISR is the only writer */
+static volatile uint64_t msTicks = 0;
 static uint8_t interruptMode = 0;
+static uint32_t cyclesPerUs = 16;
 
 /******************************************************************************
  * Initialize SysTick Timer
@@ -18,11 +20,13 @@ static uint8_t interruptMode = 0;
 void SysTick_Init(uint32_t reload, uint8_t mode)
 {
     interruptMode = mode;
-
+    msTicks = 0;
+    cyclesPerUs = (reload >= 1000) ? reload / 1000 : 1;
+    
     NVIC_ST_CTRL_R = 0;               /* Disable SysTick */
     NVIC_ST_RELOAD_R = reload - 1;    /* Set reload value */
     NVIC_ST_CURRENT_R = 0;            /* Clear current */
-
+    
     if (mode == SYSTICK_INT) {
         NVIC_ST_CTRL_R = 0x07;        /* ENABLE | TICKINT | CLK_SRC */
     } else {
@@ -40,13 +44,71 @@ void DelayMs(uint32_t ms)
             while ((NVIC_ST_CTRL_R & (1 << 16)) == 0);
             NVIC_ST_CURRENT_R = 0;
         }
+    } else {
+        /* Sleep between ticks; any interrupt wakes the core early */
+        uint64_t start = SysTick_GetMs64();
+        while ((SysTick_GetMs64() - start) < ms) {
+            __WFI();
+        }
     }
 }
 
+/******************************************************************************
+ * Delay in microseconds
+ ******************************************************************************/
+void DelayUs(uint32_t us)
+{
+    uint32_t period = NVIC_ST_RELOAD_R + 1;
+    uint64_t wait = (uint64_t)us * cyclesPerUs;
+    uint64_t elapsed = 0;
+    uint32_t last = NVIC_ST_CURRENT_R;
+    uint32_t now;
+    
+    /* The counter runs down and reloads; sum the cycles between reads */
+    while (elapsed < wait) {
+        now = NVIC_ST_CURRENT_R;
+        elapsed += (now <= last) ? (last - now) : (last + period - now);
+        last = now;
+    }
+}
+
+/******************************************************************************
+ * Millisecond clock
+ ******************************************************************************/
+uint32_t SysTick_GetMs(void)
+{
+    return (uint32_t)SysTick_GetMs64();
+}
+
+uint64_t SysTick_GetMs64(void)
+{
+    uint64_t ms;
+    
+    /* Two 32-bit loads: read again if the tick interrupt split them */
+    do {
+        ms = msTicks;
+    } while (ms != msTicks);
+    return ms;
+}
+
+uint64_t SysTick_GetUs(void)
+{
+    uint64_t ms;
+    uint32_t current;
+    
+    /* The counter reloads as the tick fires; if msTicks moved while we
+     * sampled the counter, the pair is inconsistent, so take it again */
+    do {
+        ms = msTicks;
+        current = NVIC_ST_CURRENT_R;
+    } while (ms != msTicks);
+    return ms * 1000 + (NVIC_ST_RELOAD_R - current) / cyclesPerUs;
+}
+
 /******************************************************************************
  * SysTick Interrupt Handler
  ******************************************************************************/
 void SystickHandler(void)
 {
-    DIO_TogglePin(PORTF, PIN3);
+    msTicks++;
 }
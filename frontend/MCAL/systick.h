@@ -1,7 +1,8 @@
 /******************************************************************************
  * File: systick.h
  * Module: SysTick Timer
- * Description: Header file for SysTick delay functions
+ * Description: Header file for SysTick delay functions and the monotonic
+ *              millisecond/microsecond clock
  ******************************************************************************/
 
 #ifndef SYSTICK_H
@@ -12,7 +13,42 @@
 #define SYSTICK_NOINT   0
 #define SYSTICK_INT     1
 
+/**
+ * @brief Start SysTick on the system clock
+ * @param reload Cycles per tick; the clocks below assume 1 ms (16000 at
+ *        16 MHz)
+ * @param mode SYSTICK_INT keeps the clock running from the tick interrupt,
+ *        SYSTICK_NOINT only supports busy-wait DelayMs
+ */
 void SysTick_Init(uint32_t reload, uint8_t mode);
 void DelayMs(uint32_t ms);
 
+/**
+ * @brief Busy-wait for at least us microseconds
+ * @note Counts SysTick down-counter cycles, so it works in either mode and
+ *       with interrupts masked. For waits of a millisecond or more prefer
+ *       DelayMs, which sleeps.
+ */
+void DelayUs(uint32_t us);
+
+/**
+ * @brief Milliseconds since SysTick_Init (wraps after ~49 days)
+ * @note Only advances in SYSTICK_INT mode with a 1 ms reload
+ */
+uint32_t SysTick_GetMs(void);
+
+/**
+ * @brief Milliseconds since SysTick_Init, never wraps
+ * @note Only advances in SYSTICK_INT mode with a 1 ms reload
+ */
+uint64_t SysTick_GetMs64(void);
+
+/**
+ * @brief Microseconds since SysTick_Init, from the tick count plus the
+ *        SysTick down-counter
+ * @note Needs SYSTICK_INT mode with interrupts enabled, so a tick that
+ *       lands between the two reads is seen and the read retried
+ */
+uint64_t SysTick_GetUs(void);
+
 #endif /* SYSTICK_H */
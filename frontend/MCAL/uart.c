@@ -5,10 +5,45 @@
  ******************************************************************************/
 
 #include "uart.h"
+#include <intrinsics.h>
 #include "../lib/tm4c123gh6pm.h"
 #include "systick.h"
 
-#define UART_TIMEOUT_LOOPS   2000000
+#define UART_TX_TIMEOUT_MS   10
+#define UART_RX_RING_MASK    (UART_RX_RING_SIZE - 1)
+#define UART_DR_ERRORS       0xF00   /* OE | BE | PE | FE */
+#define UART_INT_RX          (UART_IM_RXIM | UART_IM_RTIM)
+#define UART1_IRQ            6
+
+/* RX ring: head written by the ISR (or with interrupts masked), tail by
+ * the reader */
+static volatile uint8_t rxRing[UART_RX_RING_SIZE];
+static volatile uint8_t rxHead = 0;
+static volatile uint8_t rxTail = 0;
+
+/* Move the RX FIFO into the ring. ISR context or interrupts masked. */
+static void DrainRxFifo(void)
+{
+    uint32_t dr;
+    uint8_t next;
+    
+    while ((UART1_FR_R & UART_FR_RXFE) == 0) {
+        dr = UART1_DR_R;
+        if (dr & UART_DR_ERRORS) {
+            UART1_ECR_R = 0xFF;
+            continue;                   /* Drop the damaged byte */
+        }
+        next = (rxHead + 1) & UART_RX_RING_MASK;
+        if (next == rxTail) continue;   /* Ring full - drop */
+        rxRing[rxHead] = (uint8_t)dr;
+        rxHead = next;
+    }
+}
+
+static uint8_t DeadlinePassed(uint32_t deadlineMs)
+{
+    return (int32_t)(SysTick_GetMs() - deadlineMs) >= 0;
+}
 
 void UART_Driver_Init(void)
 {
@@ -27,10 +62,15 @@ void UART_Driver_Init(void)
     UART1_IBRD_R = 8;
     UART1_FBRD_R = 44;
     UART1_LCRH_R = 0x70;
+    UART1_IFLS_R = UART_IFLS_RX1_8;     /* Interrupt at 2 bytes, RT for the rest */
     UART1_ECR_R = 0xFF;
     UART1_CTL_R = 0x301;
     
     UART_Driver_FlushRx();
+    
+    UART1_ICR_R = UART_INT_RX;
+    UART1_IM_R |= UART_INT_RX;
+    NVIC_EN0_R = 1UL << UART1_IRQ;
 }
 
 void UART_Driver_Reinit(void)
@@ -42,26 +82,29 @@ void UART_Driver_Reinit(void)
     UART1_FBRD_R = 44;
     UART1_LCRH_R = 0x70;
     UART1_CTL_R = 0x301;
-    while ((UART1_FR_R & 0x10) == 0) {
-        (void)UART1_DR_R;
-    }
+    UART_Driver_FlushRx();
     DelayMs(1);
 }
 
 void UART_Driver_FlushRx(void)
 {
-    while ((UART1_FR_R & 0x10) == 0) {
+    __istate_t state = __get_interrupt_state();
+    
+    __disable_interrupt();
+    while ((UART1_FR_R & UART_FR_RXFE) == 0) {
         (void)UART1_DR_R;
     }
     UART1_ECR_R = 0xFF;
+    rxTail = rxHead;
+    __set_interrupt_state(state);
 }
 
 uint8_t UART_Driver_SendByte(uint8_t data)
 {
-    uint32_t timeout = UART_TIMEOUT_LOOPS;
-    while ((UART1_FR_R & 0x20) != 0) {
-        timeout--;
-        if (timeout == 0) return 0;
+    uint32_t start = SysTick_GetMs();
+    
+    while ((UART1_FR_R & UART_FR_TXFF) != 0) {
+        if ((SysTick_GetMs() - start) > UART_TX_TIMEOUT_MS) return 0;
     }
     UART1_DR_R = data;
     return 1;
@@ -69,32 +112,62 @@ uint8_t UART_Driver_SendByte(uint8_t data)
 
 void UART_Driver_WaitTxComplete(void)
 {
-    uint32_t timeout = UART_TIMEOUT_LOOPS;
-    while ((UART1_FR_R & 0x08) != 0 && timeout > 0) {
-        timeout--;
-    }
-    timeout = UART_TIMEOUT_LOOPS;
-    while ((UART1_FR_R & 0x80) == 0 && timeout > 0) {
-        timeout--;
+    uint32_t start = SysTick_GetMs();
+    
+    while ((UART1_FR_R & (UART_FR_BUSY | UART_FR_TXFE)) != UART_FR_TXFE) {
+        if ((SysTick_GetMs() - start) > UART_TX_TIMEOUT_MS) return;
     }
 }
 
-uint8_t UART_Driver_ReceiveByte(uint8_t *data)
+uint8_t UART_Driver_TryReceiveByte(uint8_t *data)
 {
-    uint32_t timeout = UART_TIMEOUT_LOOPS;
-    uint32_t dr;
-    
-    while ((UART1_FR_R & 0x10) != 0) {
-        timeout--;
-        if (timeout == 0) return 0;
+    if (rxTail == rxHead) {
+        /* Bytes below the FIFO trigger level only raise the receive
+         * timeout interrupt 32 bit times later; collect them now */
+        __istate_t state = __get_interrupt_state();
+        
+        __disable_interrupt();
+        DrainRxFifo();
+        __set_interrupt_state(state);
+        if (rxTail == rxHead) return 0;
     }
     
-    dr = UART1_DR_R;
-    if (dr & 0xF00) {
-        UART1_ECR_R = 0xFF;
-        return 0;
-    }
+    *data = rxRing[rxTail];
+    rxTail = (rxTail + 1) & UART_RX_RING_MASK;
+    return 1;
+}
+
+uint8_t UART_Driver_WaitRx(uint32_t deadlineMs)
+{
+    __istate_t state;
     
-    *data = (uint8_t)(dr & 0xFF);
+    while (rxTail == rxHead) {
+        if (DeadlinePassed(deadlineMs)) return 0;
+        
+        /* Masked so an RX interrupt between the check and WFI still wakes
+         * the core; the handler runs once interrupts are unmasked */
+        state = __get_interrupt_state();
+        __disable_interrupt();
+        if (rxTail == rxHead && (UART1_FR_R & UART_FR_RXFE) != 0) {
+            __WFI();
+        }
+        DrainRxFifo();
+        __set_interrupt_state(state);
+    }
     return 1;
 }
+
+uint8_t UART_Driver_ReceiveByteUntil(uint8_t *data, uint32_t deadlineMs)
+{
+    if (!UART_Driver_WaitRx(deadlineMs)) return 0;
+    return UART_Driver_TryReceiveByte(data);
+}
+
+/*===========================================================================
+ * UART1 ISR - RX FIFO at 1/8 or receive timeout
+ *===========================================================================*/
+void UART1Handler(void)
+{
+    UART1_ICR_R = UART_INT_RX;
+    DrainRxFifo();
+}
@@ -9,8 +9,14 @@
 
 #include <stdint.h>
 
+/* Bytes buffered between the UART1 RX interrupt and the reader (power of
+ * two, one slot kept free) */
+#define UART_RX_RING_SIZE   64
+
 /**
- * @brief Initialize UART1 (PB0=Rx, PB1=Tx) at 115200 baud
+ * @brief Initialize UART1 (PB0=Rx, PB1=Tx) at 115200 baud with the RX
+ *        interrupt feeding a ring buffer
+ * @note Timeouts use SysTick_GetMs, so SysTick must run in SYSTICK_INT mode
  */
 void UART_Driver_Init(void);
 
@@ -20,7 +26,7 @@ void UART_Driver_Init(void);
 void UART_Driver_Reinit(void);
 
 /**
- * @brief Flush the RX FIFO
+ * @brief Discard everything received so far (FIFO and ring)
  */
 void UART_Driver_FlushRx(void);
 
@@ -37,10 +43,31 @@ uint8_t UART_Driver_SendByte(uint8_t data);
 void UART_Driver_WaitTxComplete(void);
 
 /**
- * @brief Receive a single byte with timeout
+ * @brief Read a byte if one is waiting (non-blocking)
+ * @param data Pointer to store received byte
+ * @return 1 if a byte was read, 0 if nothing has been received
+ */
+uint8_t UART_Driver_TryReceiveByte(uint8_t *data);
+
+/**
+ * @brief Sleep (WFI) until received data is waiting or a deadline passes
+ * @param deadlineMs SysTick_GetMs() value to give up at
+ * @return 1 if data is waiting, 0 on timeout
+ */
+uint8_t UART_Driver_WaitRx(uint32_t deadlineMs);
+
+/**
+ * @brief Receive a single byte, sleeping until it arrives
  * @param data Pointer to store received byte
- * @return 1 on success, 0 on timeout/error
+ * @param deadlineMs SysTick_GetMs() value to give up at
+ * @return 1 on success, 0 on timeout
+ */
+uint8_t UART_Driver_ReceiveByteUntil(uint8_t *data, uint32_t deadlineMs);
+
+/**
+ * @brief UART1 interrupt handler (RX FIFO level and receive timeout)
+ * @note Must be registered in the vector table (startup_ewarm.c)
  */
-uint8_t UART_Driver_ReceiveByte(uint8_t *data);
+void UART1Handler(void);
 
 #endif /* UART_H */
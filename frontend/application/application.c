@@ -7,21 +7,114 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "application.h"
+#include "scheduler.h"
 #include "uart_commands.h"
+#include "ui_display.h"
 #include "../HAL/lcd.h"
 #include "../HAL/keypad.h"
 #include "../HAL/potentiometer.h"
 #include "../HAL/led.h"
 #include "auth_handlers.h"
 #include "menu_handlers.h"
+#include "input_handler.h"
 
 /* State machine variables */
 static Frontend_State_t currentState = STATE_WELCOME;
 static uint8_t attemptCount = 0;
 static bool isFirstTime = true;
 
-void Frontend_Start(void)
+/*===========================================================================
+ * Event Sources
+ *===========================================================================*/
+
+/*
+ * '#' is both backspace/cancel (tap) and clear (hold), so it is only known
+ * to be a tap once it is released without a long-press. Acting on the
+ * press would cancel an empty entry before the clear arrives.
+ */
+static void KeypadTask(void)
+{
+    static bool hashLongPressed = false;
+    Keypad_Event_t key;
+    
+    while (Keypad_GetEvent(&key)) {
+        if (key.key == '#') {
+            if (key.type == KEYPAD_EVENT_PRESS) {
+                hashLongPressed = false;
+            } else if (key.type == KEYPAD_EVENT_LONG_PRESS) {
+                hashLongPressed = true;
+                Scheduler_Post(EVENT_KEY, (uint8_t)KEY_CLEAR);
+            } else if (key.type == KEYPAD_EVENT_RELEASE && !hashLongPressed) {
+                Scheduler_Post(EVENT_KEY, (uint8_t)'#');
+            }
+        } else if (key.type == KEYPAD_EVENT_PRESS) {
+            Scheduler_Post(EVENT_KEY, (uint8_t)key.key);
+        }
+    }
+}
+
+static void UartTask(void)
+{
+    UART_Protocol_Poll(0);
+}
+
+void Frontend_OnReply(UART_Request_t *req)
+{
+    Scheduler_Post(EVENT_UART_DONE, req->status);
+}
+
+/*===========================================================================
+ * Dispatch
+ *===========================================================================*/
+
+static void HandleEvent(const Event_t *event)
+{
+    switch (currentState) {
+        case STATE_WELCOME:         handleWelcome(event, &currentState, &isFirstTime); break;
+        case STATE_SIGNUP:          handleSignup(event, &currentState, &isFirstTime); break;
+        case STATE_MAIN_MENU:       handleMainMenu(event, &currentState); break;
+        case STATE_SIGNIN:          handleSignin(event, &currentState, &attemptCount); break;
+        case STATE_CHANGE_PASSWORD: handleChangePassword(event, &currentState, &attemptCount); break;
+        case STATE_SET_TIMEOUT:     handleSetTimeout(event, &currentState, &attemptCount); break;
+        case STATE_LOCKOUT:         handleLockout(event, &currentState, &attemptCount); break;
+        default:                    currentState = STATE_MAIN_MENU; break;
+    }
+}
+
+static void Dispatch(const Event_t *event)
+{
+    Frontend_State_t previous = currentState;
+    Event_t entry;
+    
+    if (event->type == EVENT_TIMER && event->arg == TIMER_ANIM) {
+        stepAnimation();
+        return;
+    }
+    if (event->type == EVENT_UART_DONE) {
+        stopAnimation();
+    }
+    HandleEvent(event);
+    
+    /* Entry actions run right away, before anything queued for the old state */
+    while (currentState != previous) {
+        previous = currentState;
+        Scheduler_StopTimer(TIMER_STATE);
+        stopAnimation();
+        entry.type = EVENT_ENTRY;
+        entry.arg = 0;
+        entry.timeMs = event->timeMs;
+        HandleEvent(&entry);
+    }
+}
+
+/*===========================================================================
+ * Public API
+ *===========================================================================*/
+
+void Frontend_Init(void)
 {
+    Event_t entry = {EVENT_ENTRY, 0, 0};
+    
     /* Initialize all peripherals */
     LCD_Init();
     Keypad_Init();
@@ -34,17 +127,22 @@ void Frontend_Start(void)
     attemptCount = 0;
     isFirstTime = true;
     
-    /* Main state machine loop */
-    while (1) {
-        switch (currentState) {
-            case STATE_WELCOME:         handleWelcome(&currentState, &isFirstTime); break;
-            case STATE_SIGNUP:          handleSignup(&currentState, &isFirstTime); break;
-            case STATE_MAIN_MENU:       handleMainMenu(&currentState); break;
-            case STATE_SIGNIN:          handleSignin(&currentState, &attemptCount); break;
-            case STATE_CHANGE_PASSWORD: handleChangePassword(&currentState, &attemptCount); break;
-            case STATE_SET_TIMEOUT:     handleSetTimeout(&currentState, &attemptCount); break;
-            case STATE_LOCKOUT:         handleLockout(&currentState, &attemptCount); break;
-            default:                    currentState = STATE_MAIN_MENU; break;
-        }
-    }
+    Scheduler_Init(Dispatch);
+    Scheduler_AddTask(UartTask, 0);
+    Scheduler_AddTask(KeypadTask, KEY_POLL_MS);
+    
+    Dispatch(&entry);
+}
+
+void Frontend_Start(void)
+{
+    Frontend_Init();
+    
+    /* Main event loop */
+    Scheduler_Run();
+}
+
+Frontend_State_t Frontend_GetState(void)
+{
+    return currentState;
 }
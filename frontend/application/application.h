@@ -9,6 +9,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "scheduler.h"
+#include "uart_protocol.h"
 
 /* Frontend state machine states */
 typedef enum {
@@ -21,11 +23,36 @@ typedef enum {
     STATE_LOCKOUT
 } Frontend_State_t;
 
+/* Scheduler timers. Both are stopped on every state change. */
+#define TIMER_STATE         0       /* Owned by the current state handler */
+#define TIMER_ANIM          1       /* Progress dots / LED blink (ui_display) */
+
+/* Keypad event queue drain period; the matrix itself is scanned from its
+ * row interrupts and Timer1A, so this only bounds key-to-event latency */
+#define KEY_POLL_MS         1
+
+/**
+ * @brief Initialize all peripherals and enter the welcome state
+ * Events are then handled by Scheduler_RunOnce/Scheduler_Run.
+ */
+void Frontend_Init(void);
+
 /**
  * @brief Start the frontend application
- * Initializes all peripherals and runs the main state machine loop.
+ * Calls Frontend_Init and runs the scheduler loop.
  * This function never returns.
  */
 void Frontend_Start(void);
 
+/**
+ * @brief Current state, for diagnostics and tests
+ */
+Frontend_State_t Frontend_GetState(void);
+
+/**
+ * @brief UART_Request_t completion callback for the command a handler
+ *        started; posts EVENT_UART_DONE with the final status
+ */
+void Frontend_OnReply(UART_Request_t *req);
+
 #endif /* APPLICATION_H */
@@ -8,258 +8,376 @@
 #include "ui_display.h"
 #include "input_handler.h"
 #include "uart_commands.h"
-#include "../HAL/lcd.h"
 #include "../HAL/led.h"
-#include "../MCAL/systick.h"
 #include <stdio.h>
 
+#define MESSAGE_MS          1500    /* How long result messages stay up */
+#define PROMPT_GAP_MS       300     /* Pause between two password prompts */
+#define DOOR_CLOSING_MS     2000
+#define LOCKOUT_RETRIES     5
+#define LOCKOUT_RETRY_MS    300
+#define LOCKOUT_REFETCH_MS  500
+#define LOCKOUT_BLINK_MS    500
+
+/* Step within the current state; every state starts at STEP_ENTER */
+typedef enum {
+    STEP_ENTER,             /* Typing the (first/old) password */
+    STEP_GAP,               /* Pause before the next prompt */
+    STEP_NEW,               /* Typing the new password */
+    STEP_GAP_CONFIRM,
+    STEP_CONFIRM,           /* Typing it again */
+    STEP_VERIFY,            /* Waiting for the auth reply */
+    STEP_SAVE,              /* Waiting for the save reply */
+    STEP_DOOR_OPEN,         /* Countdown, 1 s per tick */
+    STEP_DOOR_CLOSING,
+    STEP_FETCH,             /* Lockout: asking for the lockout time */
+    STEP_COUNTDOWN,         /* Lockout: 500 ms per tick */
+    STEP_RESTART,           /* Message up, then back to STEP_ENTER */
+    STEP_DONE               /* Message up, then go to nextState */
+} Auth_Step_t;
+
 /* Local buffers for password entry */
 static char passwordBuffer[PASSWORD_LENGTH + 1];
 static char confirmBuffer[PASSWORD_LENGTH + 1];
+static PasswordEntry_t entry;
+
+/* Command in flight while the LCD shows progress */
+static UART_Pending_t pendingCmd;
+
+static Auth_Step_t step;
+static Frontend_State_t nextState;
+static uint8_t remaining;           /* Countdown seconds */
+static uint8_t retryCount;
+static bool ledOn;
+
+/* Show a result and move to state after MESSAGE_MS (LED_Off first) */
+static void FinishWith(const char *line1, const char *line2, Frontend_State_t state)
+{
+    showMessage(line1, line2);
+    nextState = state;
+    step = STEP_DONE;
+    Scheduler_StartTimer(TIMER_STATE, MESSAGE_MS, 0);
+}
+
+static void ShowCommError(void)
+{
+    blinkLed(LED_RED, 3, 200);
+    FinishWith("Comm Error!", "Try Again", STATE_MAIN_MENU);
+}
+
+static void PromptAfterGap(Auth_Step_t gapStep)
+{
+    step = gapStep;
+    Scheduler_StartTimer(TIMER_STATE, PROMPT_GAP_MS, 0);
+}
 
-void handleSignup(Frontend_State_t *currentState, bool *isFirstTime)
+static void SendRequest(const char *label)
 {
-    bool done = false;
+    pendingCmd.req.onDone = Frontend_OnReply;
+    showProgress(label);
+}
+
+void handleSignup(const Event_t *event, Frontend_State_t *currentState, bool *isFirstTime)
+{
+    Entry_Result_t result;
     
-    while (!done) {
-        showMessage("Create Password:", "");
-        LCD_SetCursor(1, 0);
-        if (!getPasswordFromKeypad(passwordBuffer)) continue;
+    switch (event->type) {
+        case EVENT_ENTRY:
+            step = STEP_ENTER;
+            startPasswordEntry(&entry, passwordBuffer, "Create Password:");
+            break;
         
-        DelayMs(300);
-        
-        showMessage("Confirm Password", "");
-        LCD_SetCursor(1, 0);
-        if (!getPasswordFromKeypad(confirmBuffer)) continue;
+        case EVENT_KEY:
+            if (step != STEP_ENTER && step != STEP_CONFIRM) break;
+            result = passwordEntryKey(&entry, (char)event->arg);
+            if (result == ENTRY_CANCELLED) {
+                step = STEP_ENTER;
+                startPasswordEntry(&entry, passwordBuffer, "Create Password:");
+            } else if (result == ENTRY_DONE && step == STEP_ENTER) {
+                PromptAfterGap(STEP_GAP_CONFIRM);
+            } else if (result == ENTRY_DONE) {
+                if (stringsMatch(passwordBuffer, confirmBuffer, PASSWORD_LENGTH)) {
+                    step = STEP_SAVE;
+                    SendRequest("Saving");
+                    UART_InitPasswordStart(&pendingCmd, passwordBuffer);
+                } else {
+                    LED_Red();
+                    showMessage("Mismatch!", "Try Again");
+                    step = STEP_RESTART;
+                    Scheduler_StartTimer(TIMER_STATE, MESSAGE_MS, 0);
+                }
+            }
+            break;
         
-        if (stringsMatch(passwordBuffer, confirmBuffer, PASSWORD_LENGTH)) {
-            showMessage("Saving...", "");
-            
-            uint8_t status = UART_InitPassword(passwordBuffer);
-            
-            if (status == STATUS_OK) {
+        case EVENT_UART_DONE:
+            if (event->arg == STATUS_OK) {
                 LED_Green();
-                showMessage("Password Saved!", "");
-                DelayMs(1500);
-                LED_Off();
                 *isFirstTime = false;
-                done = true;
-                *currentState = STATE_MAIN_MENU;
+                FinishWith("Password Saved!", "", STATE_MAIN_MENU);
             } else {
                 LED_Red();
                 showMessage("Save Failed!", "Try Again");
-                DelayMs(1500);
+                step = STEP_RESTART;
+                Scheduler_StartTimer(TIMER_STATE, MESSAGE_MS, 0);
+            }
+            break;
+        
+        case EVENT_TIMER:
+            if (step == STEP_GAP_CONFIRM) {
+                step = STEP_CONFIRM;
+                startPasswordEntry(&entry, confirmBuffer, "Confirm Password");
+            } else if (step == STEP_RESTART) {
                 LED_Off();
+                step = STEP_ENTER;
+                startPasswordEntry(&entry, passwordBuffer, "Create Password:");
+            } else if (step == STEP_DONE) {
+                LED_Off();
+                *currentState = nextState;
             }
-        } else {
-            LED_Red();
-            showMessage("Mismatch!", "Try Again");
-            DelayMs(1500);
-            LED_Off();
-        }
+            break;
+        
+        default:
+            break;
     }
 }
 
-void handleSignin(Frontend_State_t *currentState, uint8_t *attemptCount)
+static void ShowDoorCountdown(void)
 {
     char buffer[17];
     
-    showMessage("Enter Password:", "");
-    LCD_SetCursor(1, 0);
-    
-    if (!getPasswordFromKeypad(passwordBuffer)) {
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    showMessage("Verifying...", "");
-    
-    uint8_t timeout = 0;
-    uint8_t status = UART_Authenticate(passwordBuffer, AUTH_MODE_OPEN_DOOR, &timeout);
-    
-    if (status == STATUS_OK) {
-        *attemptCount = 0;
-        LED_Green();
+    snprintf(buffer, sizeof(buffer), "Closing in: %2d s", remaining);
+    showLine(1, buffer);
+}
 
-        /* Use received timeout for countdown (default to 10 if invalid) */
-        if (timeout < 5 || timeout > 30) timeout = 10;
+void handleSignin(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount)
+{
+    char buffer[17];
+    Entry_Result_t result;
+    
+    switch (event->type) {
+        case EVENT_ENTRY:
+            step = STEP_ENTER;
+            startPasswordEntry(&entry, passwordBuffer, "Enter Password:");
+            break;
         
-        /* Show countdown while door is open */
-        showMessage("Door Open", "");
-        while (timeout > 0) {
-            LCD_SetCursor(1, 0);
-            snprintf(buffer, sizeof(buffer), "Closing in: %2d s", timeout);
-            LCD_WriteString(buffer);
-            DelayMs(1000);
-            timeout--;
-        }
+        case EVENT_KEY:
+            if (step != STEP_ENTER) break;
+            result = passwordEntryKey(&entry, (char)event->arg);
+            if (result == ENTRY_CANCELLED) {
+                *currentState = STATE_MAIN_MENU;
+            } else if (result == ENTRY_DONE) {
+                step = STEP_VERIFY;
+                SendRequest("Verifying");
+                UART_AuthenticateStart(&pendingCmd, passwordBuffer, AUTH_MODE_OPEN_DOOR);
+            }
+            break;
         
-        /* Door closing */
-        LED_Off();
-        showMessage("Door Closing...", "Please Wait");
-        DelayMs(2000);
+        case EVENT_UART_DONE:
+            if (event->arg == STATUS_OK) {
+                *attemptCount = 0;
+                LED_Green();
+                
+                /* Use received timeout for countdown (default to 10 if invalid) */
+                remaining = UART_GetReplyTimeout(&pendingCmd);
+                if (remaining < 5 || remaining > 30) remaining = 10;
+                
+                /* Show countdown while door is open */
+                showMessage("Door Open", "");
+                ShowDoorCountdown();
+                step = STEP_DOOR_OPEN;
+                Scheduler_StartTimer(TIMER_STATE, 1000, 1000);
+            }
+            else if (event->arg == STATUS_UNKNOWN_CMD) {
+                ShowCommError();
+            }
+            else {
+                (*attemptCount)++;
+                LED_Red();
+                
+                if (*attemptCount >= MAX_ATTEMPTS) {
+                    FinishWith("Too many tries!", "Locking out...", STATE_LOCKOUT);
+                } else {
+                    snprintf(buffer, sizeof(buffer), "%d tries left", MAX_ATTEMPTS - *attemptCount);
+                    FinishWith("Wrong Password!", buffer, STATE_MAIN_MENU);
+                }
+            }
+            break;
         
-        LED_Off();
-        showMessage("Door Locked", "");
-        DelayMs(1500);
-        *currentState = STATE_MAIN_MENU;
-    } 
-    else if (status == STATUS_UNKNOWN_CMD) {
-        LED_Blink(LED_RED, 3, 200);
-        showMessage("Comm Error!", "Try Again");
-        DelayMs(1500);
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-    }
-    else {
-        (*attemptCount)++;
-        LED_Red();
+        case EVENT_TIMER:
+            if (step == STEP_DOOR_OPEN) {
+                remaining--;
+                if (remaining > 0) {
+                    ShowDoorCountdown();
+                } else {
+                    /* Door closing */
+                    LED_Off();
+                    showMessage("Door Closing...", "Please Wait");
+                    step = STEP_DOOR_CLOSING;
+                    Scheduler_StartTimer(TIMER_STATE, DOOR_CLOSING_MS, 0);
+                }
+            } else if (step == STEP_DOOR_CLOSING) {
+                LED_Off();
+                FinishWith("Door Locked", "", STATE_MAIN_MENU);
+            } else if (step == STEP_DONE) {
+                /* Lockout keeps the red LED on */
+                if (nextState != STATE_LOCKOUT) LED_Off();
+                *currentState = nextState;
+            }
+            break;
         
-        if (*attemptCount >= MAX_ATTEMPTS) {
-            showMessage("Too many tries!", "Locking out...");
-            DelayMs(1500);
-            *currentState = STATE_LOCKOUT;
-        } else {
-            char buffer[17];
-            snprintf(buffer, sizeof(buffer), "%d tries left", MAX_ATTEMPTS - *attemptCount);
-            showMessage("Wrong Password!", buffer);
-            DelayMs(1500);
-            LED_Off();
-            *currentState = STATE_MAIN_MENU;
-        }
+        default:
+            break;
     }
 }
 
-
-void handleChangePassword(Frontend_State_t *currentState, uint8_t *attemptCount)
+void handleChangePassword(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount)
 {
-    showMessage("Old Password:", "");
-    LCD_SetCursor(1, 0);
-    
-    if (!getPasswordFromKeypad(passwordBuffer)) {
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    showMessage("Verifying...", "");
-    
-    uint8_t status = UART_Authenticate(passwordBuffer, AUTH_MODE_CHECK_ONLY, NULL);
+    Entry_Result_t result;
     
-    if (status == STATUS_UNKNOWN_CMD) {
-        LED_Blink(LED_RED, 3, 200);
-        showMessage("Comm Error!", "Try Again");
-        DelayMs(1500);
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    if (status != STATUS_OK) {
-        (*attemptCount)++;
-        LED_Red();
-        if (*attemptCount >= MAX_ATTEMPTS) {
-            *currentState = STATE_LOCKOUT;
-            return;
-        }
-        showMessage("Wrong Password!", "");
-        DelayMs(1500);
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    *attemptCount = 0;
-    DelayMs(300);
-    
-    showMessage("New Password:", "");
-    LCD_SetCursor(1, 0);
-    if (!getPasswordFromKeypad(passwordBuffer)) {
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    DelayMs(300);
-    
-    showMessage("Confirm New Pwd:", "");
-    LCD_SetCursor(1, 0);
-    if (!getPasswordFromKeypad(confirmBuffer)) {
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    if (!stringsMatch(passwordBuffer, confirmBuffer, PASSWORD_LENGTH)) {
-        LED_Red();
-        showMessage("Mismatch!", "Not Changed");
-        DelayMs(1500);
-        LED_Off();
-        *currentState = STATE_MAIN_MENU;
-        return;
-    }
-    
-    showMessage("Saving...", "");
-    
-    status = UART_ChangePassword(passwordBuffer);
-    
-    if (status == STATUS_OK) {
-        LED_Green();
-        showMessage("Password Changed", "");
-    } else {
-        LED_Red();
-        showMessage("Change Failed!", "");
+    switch (event->type) {
+        case EVENT_ENTRY:
+            step = STEP_ENTER;
+            startPasswordEntry(&entry, passwordBuffer, "Old Password:");
+            break;
+        
+        case EVENT_KEY:
+            if (step != STEP_ENTER && step != STEP_NEW && step != STEP_CONFIRM) break;
+            result = passwordEntryKey(&entry, (char)event->arg);
+            if (result == ENTRY_CANCELLED) {
+                LED_Off();
+                *currentState = STATE_MAIN_MENU;
+            } else if (result != ENTRY_DONE) {
+                break;
+            } else if (step == STEP_ENTER) {
+                step = STEP_VERIFY;
+                SendRequest("Verifying");
+                UART_AuthenticateStart(&pendingCmd, passwordBuffer, AUTH_MODE_CHECK_ONLY);
+            } else if (step == STEP_NEW) {
+                PromptAfterGap(STEP_GAP_CONFIRM);
+            } else if (!stringsMatch(passwordBuffer, confirmBuffer, PASSWORD_LENGTH)) {
+                LED_Red();
+                FinishWith("Mismatch!", "Not Changed", STATE_MAIN_MENU);
+            } else {
+                step = STEP_SAVE;
+                SendRequest("Saving");
+                UART_ChangePasswordStart(&pendingCmd, passwordBuffer);
+            }
+            break;
+        
+        case EVENT_UART_DONE:
+            if (step == STEP_SAVE) {
+                if (event->arg == STATUS_OK) {
+                    LED_Green();
+                    FinishWith("Password Changed", "", STATE_MAIN_MENU);
+                } else {
+                    LED_Red();
+                    FinishWith("Change Failed!", "", STATE_MAIN_MENU);
+                }
+            }
+            else if (event->arg == STATUS_UNKNOWN_CMD) {
+                ShowCommError();
+            }
+            else if (event->arg != STATUS_OK) {
+                (*attemptCount)++;
+                LED_Red();
+                if (*attemptCount >= MAX_ATTEMPTS) {
+                    *currentState = STATE_LOCKOUT;
+                } else {
+                    FinishWith("Wrong Password!", "", STATE_MAIN_MENU);
+                }
+            }
+            else {
+                *attemptCount = 0;
+                PromptAfterGap(STEP_GAP);
+            }
+            break;
+        
+        case EVENT_TIMER:
+            if (step == STEP_GAP) {
+                step = STEP_NEW;
+                startPasswordEntry(&entry, passwordBuffer, "New Password:");
+            } else if (step == STEP_GAP_CONFIRM) {
+                step = STEP_CONFIRM;
+                startPasswordEntry(&entry, confirmBuffer, "Confirm New Pwd:");
+            } else if (step == STEP_DONE) {
+                LED_Off();
+                *currentState = nextState;
+            }
+            break;
+        
+        default:
+            break;
     }
-    DelayMs(1500);
-    LED_Off();
-    *currentState = STATE_MAIN_MENU;
 }
 
-void handleLockout(Frontend_State_t *currentState, uint8_t *attemptCount)
+static void ShowLockoutCountdown(void)
 {
     char buffer[17];
-    uint8_t lockoutTime = 0;
-    uint8_t status;
-    uint8_t retryCount = 0;
-    
-    LED_Red();
-    showMessage("!! LOCKED OUT !!", "Buzzer Active");
-    DelayMs(300);
     
-    while (retryCount < 5) {
-        status = UART_GetTimeout(&lockoutTime);
-        if (status == STATUS_OK && lockoutTime >= 5 && lockoutTime <= 30) break;
-        retryCount++;
-        snprintf(buffer, sizeof(buffer), "Retry %d/5...", retryCount);
-        LCD_SetCursor(1, 0);
-        LCD_WriteString(buffer);
-        DelayMs(300);
-    }
-    
-    while (lockoutTime < 5 || lockoutTime > 30) {
-        showMessage("!! LOCKED OUT !!", "Getting time...");
-        DelayMs(500);
-        status = UART_GetTimeout(&lockoutTime);
-        if (status == STATUS_OK && lockoutTime >= 5 && lockoutTime <= 30) break;
-    }
-    
-    showMessage("!! LOCKED OUT !!", "");
+    snprintf(buffer, sizeof(buffer), "Wait: %2d seconds", remaining);
+    showLine(1, buffer);
+}
+
+void handleLockout(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount)
+{
+    char buffer[17];
+    uint8_t lockoutTime;
     
-    while (lockoutTime > 0) {
-        LCD_SetCursor(1, 0);
-        snprintf(buffer, sizeof(buffer), "Wait: %2d seconds", lockoutTime);
-        LCD_WriteString(buffer);
-        LED_Red();
-        DelayMs(500);
-        LED_Off();
-        DelayMs(500);
-        lockoutTime--;
+    switch (event->type) {
+        case EVENT_ENTRY:
+            LED_Red();
+            showMessage("!! LOCKED OUT !!", "Buzzer Active");
+            retryCount = 0;
+            step = STEP_FETCH;
+            Scheduler_StartTimer(TIMER_STATE, LOCKOUT_RETRY_MS, 0);
+            break;
+        
+        case EVENT_UART_DONE:
+            lockoutTime = UART_GetReplyTimeout(&pendingCmd);
+            if (lockoutTime >= 5 && lockoutTime <= 30) {
+                /* Red for the first half of every second */
+                remaining = lockoutTime;
+                showMessage("!! LOCKED OUT !!", "");
+                ShowLockoutCountdown();
+                LED_Red();
+                ledOn = true;
+                step = STEP_COUNTDOWN;
+                Scheduler_StartTimer(TIMER_STATE, LOCKOUT_BLINK_MS, LOCKOUT_BLINK_MS);
+            } else if (retryCount < LOCKOUT_RETRIES) {
+                retryCount++;
+                snprintf(buffer, sizeof(buffer), "Retry %d/5...", retryCount);
+                showLine(1, buffer);
+                Scheduler_StartTimer(TIMER_STATE, LOCKOUT_RETRY_MS, 0);
+            } else {
+                showMessage("!! LOCKED OUT !!", "Getting time...");
+                Scheduler_StartTimer(TIMER_STATE, LOCKOUT_REFETCH_MS, 0);
+            }
+            break;
+        
+        case EVENT_TIMER:
+            if (step == STEP_FETCH) {
+                pendingCmd.req.onDone = Frontend_OnReply;
+                UART_GetTimeoutStart(&pendingCmd);
+            } else if (step == STEP_COUNTDOWN) {
+                if (ledOn) {
+                    LED_Off();
+                    ledOn = false;
+                } else if (--remaining > 0) {
+                    ShowLockoutCountdown();
+                    LED_Red();
+                    ledOn = true;
+                } else {
+                    *attemptCount = 0;
+                    LED_Green();
+                    FinishWith("Lockout Over", "", STATE_MAIN_MENU);
+                }
+            } else if (step == STEP_DONE) {
+                LED_Off();
+                *currentState = nextState;
+            }
+            break;
+        
+        default:
+            break;
     }
-    
-    *attemptCount = 0;
-    LED_Green();
-    showMessage("Lockout Over", "");
-    DelayMs(1500);
-    LED_Off();
-    *currentState = STATE_MAIN_MENU;
 }
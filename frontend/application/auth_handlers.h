@@ -10,23 +10,23 @@
 #include "application.h"
 
 /**
- * @brief Handle signup (password creation) state
+ * @brief Handle an event in the signup (password creation) state
  */
-void handleSignup(Frontend_State_t *currentState, bool *isFirstTime);
+void handleSignup(const Event_t *event, Frontend_State_t *currentState, bool *isFirstTime);
 
 /**
- * @brief Handle signin (door open) state
+ * @brief Handle an event in the signin (door open) state
  */
-void handleSignin(Frontend_State_t *currentState, uint8_t *attemptCount);
+void handleSignin(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount);
 
 /**
- * @brief Handle change password state
+ * @brief Handle an event in the change password state
  */
-void handleChangePassword(Frontend_State_t *currentState, uint8_t *attemptCount);
+void handleChangePassword(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount);
 
 /**
- * @brief Handle lockout state
+ * @brief Handle an event in the lockout state
  */
-void handleLockout(Frontend_State_t *currentState, uint8_t *attemptCount);
+void handleLockout(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount);
 
 #endif /* AUTH_HANDLERS_H */
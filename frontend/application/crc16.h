@@ -0,0 +1,24 @@
+/******************************************************************************
+ * File: crc16.h
+ * Module: CRC-16 (Application Layer)
+ * Description: CRC-16/CCITT-FALSE used by UART protocol v2 frames
+ ******************************************************************************/
+
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stdint.h>
+
+/* CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, no reflection, no xorout */
+#define CRC16_INIT      0xFFFF
+
+/**
+ * @brief Fold a buffer into a running CRC
+ * @param crc CRC so far (CRC16_INIT for a new frame)
+ * @param data Bytes to add
+ * @param len Number of bytes
+ * @return Updated CRC
+ */
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint8_t len);
+
+#endif /* CRC16_H */
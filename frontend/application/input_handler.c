@@ -1,4 +1,3 @@
-
 /******************************************************************************
  * File: input_handler.c
  * Module: Input Handler (Application Layer)
@@ -6,44 +5,38 @@
  ******************************************************************************/
 
 #include "input_handler.h"
-#include "../HAL/keypad.h"
-#include "../HAL/lcd.h"
+#include "ui_display.h"
 
-char waitForKey(void)
+void startPasswordEntry(PasswordEntry_t *entry, char *buffer, const char *prompt)
 {
-    char key = 0;
-    while (key == 0) {
-        key = Keypad_GetKey();
-    }
-    return key;
+    entry->buffer = buffer;
+    entry->length = 0;
+    showMessage(prompt, "");
 }
 
-bool getPasswordFromKeypad(char *buffer)
+Entry_Result_t passwordEntryKey(PasswordEntry_t *entry, char key)
 {
-    uint8_t i = 0;
-    char key;
-    
-    while (i < PASSWORD_LENGTH) {
-        key = Keypad_GetKey();
-        
-        if (key == '#') {
-            if (i > 0) {
-                i--;
-                LCD_SetCursor(1, i);
-                LCD_WriteChar(' ');
-                LCD_SetCursor(1, i);
-            } else {
-                return false;
-            }
+    if (key == KEY_CLEAR) {
+        while (entry->length > 0) {
+            entry->length--;
+            showCharAt(1, entry->length, ' ');
         }
-        else if (key >= '0' && key <= '9') {
-            buffer[i] = key;
-            LCD_WriteChar('*');
-            i++;
+    }
+    else if (key == '#') {
+        if (entry->length == 0) return ENTRY_CANCELLED;
+        entry->length--;
+        showCharAt(1, entry->length, ' ');
+    }
+    else if (key >= '0' && key <= '9') {
+        entry->buffer[entry->length] = key;
+        showCharAt(1, entry->length, '*');
+        entry->length++;
+        if (entry->length == PASSWORD_LENGTH) {
+            entry->buffer[PASSWORD_LENGTH] = '\0';
+            return ENTRY_DONE;
         }
     }
-    buffer[PASSWORD_LENGTH] = '\0';
-    return true;
+    return ENTRY_BUSY;
 }
 
 bool stringsMatch(const char *s1, const char *s2, uint8_t len)
@@ -12,18 +12,40 @@
 
 #define PASSWORD_LENGTH 5
 
+/* Key code posted for a long press of '#' */
+#define KEY_CLEAR       '\b'
+
+/* Result of feeding a key to a password entry */
+typedef enum {
+    ENTRY_BUSY,         /* Still collecting digits */
+    ENTRY_DONE,         /* PASSWORD_LENGTH digits entered */
+    ENTRY_CANCELLED     /* '#' on an empty field */
+} Entry_Result_t;
+
+/* Password being typed, one key event at a time */
+typedef struct {
+    char   *buffer;     /* At least PASSWORD_LENGTH+1 bytes */
+    uint8_t length;
+} PasswordEntry_t;
+
 /**
- * @brief Wait for any key press (blocking)
- * @return The pressed key character
+ * @brief Show a prompt and start collecting a password
+ * @param entry Entry state
+ * @param buffer Buffer to store the password (must be at least PASSWORD_LENGTH+1)
+ * @param prompt First line text; digits are echoed as '*' on the second line
  */
-char waitForKey(void);
+void startPasswordEntry(PasswordEntry_t *entry, char *buffer, const char *prompt);
 
 /**
- * @brief Get a 5-digit password from keypad with LCD feedback
- * @param buffer Buffer to store the password (must be at least PASSWORD_LENGTH+1)
- * @return true if password entered successfully, false if cancelled
+ * @brief Handle one key for a password entry with LCD feedback
+ * @param entry Entry state
+ * @param key Pressed key: digits are added, '#' deletes the last one or
+ *        cancels an empty field, KEY_CLEAR empties the field, anything
+ *        else is ignored
+ * @return ENTRY_DONE once complete (buffer is NUL-terminated),
+ *         ENTRY_CANCELLED, otherwise ENTRY_BUSY
  */
-bool getPasswordFromKeypad(char *buffer);
+Entry_Result_t passwordEntryKey(PasswordEntry_t *entry, char key);
 
 /**
  * @brief Compare two strings for equality
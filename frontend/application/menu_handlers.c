@@ -8,117 +8,162 @@
 #include "ui_display.h"
 #include "input_handler.h"
 #include "uart_commands.h"
-#include "../HAL/lcd.h"
 #include "../HAL/led.h"
-#include "../HAL/keypad.h"
 #include "../HAL/potentiometer.h"
-#include "../MCAL/systick.h"
 #include <stdio.h>
 
+#define WELCOME_MS          2000
+#define SETTLE_MS           500     /* Keys ignored after the timeout screen opens */
+#define POT_POLL_MS         100
+#define MESSAGE_MS          1500
+#define CANCELLED_MS        1000
+
+/* Step within the set-timeout state */
+typedef enum {
+    STEP_SETTLE,
+    STEP_ADJUST,            /* Tracking the potentiometer */
+    STEP_PASSWORD,
+    STEP_VERIFY,            /* Waiting for the auth reply */
+    STEP_SAVE,              /* Waiting for the save reply */
+    STEP_DONE               /* Message up, then go to nextState */
+} Menu_Step_t;
+
 /* Local buffer for password entry */
 static char passwordBuffer[PASSWORD_LENGTH + 1];
+static PasswordEntry_t entry;
+
+/* Command in flight while the LCD shows progress */
+static UART_Pending_t pendingCmd;
 
-void handleWelcome(Frontend_State_t *currentState, bool *isFirstTime)
+static Menu_Step_t step;
+static Frontend_State_t nextState;
+static uint32_t newTimeout;
+
+void handleWelcome(const Event_t *event, Frontend_State_t *currentState, bool *isFirstTime)
 {
-    LED_Blue();
-    showMessage("Door Locker", "Security System");
-    DelayMs(2000);
-    LED_Off();
-    
-    if (*isFirstTime) {
-        *currentState = STATE_SIGNUP;
-    } else {
-        *currentState = STATE_MAIN_MENU;
+    if (event->type == EVENT_ENTRY) {
+        LED_Blue();
+        showMessage("Door Locker", "Security System");
+        Scheduler_StartTimer(TIMER_STATE, WELCOME_MS, 0);
+    }
+    else if (event->type == EVENT_TIMER) {
+        LED_Off();
+        
+        if (*isFirstTime) {
+            *currentState = STATE_SIGNUP;
+        } else {
+            *currentState = STATE_MAIN_MENU;
+        }
     }
 }
 
-void handleMainMenu(Frontend_State_t *currentState)
+void handleMainMenu(const Event_t *event, Frontend_State_t *currentState)
 {
-    char key;
-    showMessage("A:Sign *:ChgPwd", "C:Time #:Cancel");
+    if (event->type == EVENT_ENTRY) {
+        showMessage("A:Sign *:ChgPwd", "C:Time #:Cancel");
+        return;
+    }
+    if (event->type != EVENT_KEY) return;
     
-    while (1) {
-        key = waitForKey();
-        
-        switch (key) {
-            case 'A': *currentState = STATE_SIGNIN; return;
-            case '*': *currentState = STATE_CHANGE_PASSWORD; return;
-            case 'C': *currentState = STATE_SET_TIMEOUT; return;
-            case '#': showMessage("A:Sign *:ChgPwd", "C:Time #:Cancel"); break;
-            default: break;
-        }
+    switch ((char)event->arg) {
+        case 'A': *currentState = STATE_SIGNIN; break;
+        case '*': *currentState = STATE_CHANGE_PASSWORD; break;
+        case 'C': *currentState = STATE_SET_TIMEOUT; break;
+        case '#': showMessage("A:Sign *:ChgPwd", "C:Time #:Cancel"); break;
+        default: break;
     }
 }
 
-void handleSetTimeout(Frontend_State_t *currentState, uint8_t *attemptCount)
+static void Finish(const char *line1, const char *line2, Frontend_State_t state, uint32_t ms)
+{
+    showMessage(line1, line2);
+    nextState = state;
+    step = STEP_DONE;
+    Scheduler_StartTimer(TIMER_STATE, ms, 0);
+}
+
+void handleSetTimeout(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount)
 {
     char buffer[17];
-    char key = 0;
-    uint32_t newTimeout;
-    
-    showMessage("Adjust Timeout", "D:Save #:Cancel");
-    DelayMs(500);
-    
-    while (key != 'D' && key != '#') {
-        newTimeout = Potentiometer_GetTimeout();
-        LCD_SetCursor(1, 0);
-        snprintf(buffer, sizeof(buffer), "Time: %2lu sec   ", newTimeout);
-        LCD_WriteString(buffer);
-        key = Keypad_GetKey();
-        DelayMs(100);
-    }
+    Entry_Result_t result;
     
-    if (key == 'D') {
-        showMessage("Enter Password:", "");
-        LCD_SetCursor(1, 0);
+    switch (event->type) {
+        case EVENT_ENTRY:
+            showMessage("Adjust Timeout", "D:Save #:Cancel");
+            step = STEP_SETTLE;
+            Scheduler_StartTimer(TIMER_STATE, SETTLE_MS, 0);
+            break;
         
-        if (!getPasswordFromKeypad(passwordBuffer)) {
-            LED_Off();
-            *currentState = STATE_MAIN_MENU;
-            return;
-        }
-        
-        showMessage("Verifying...", "");
-        
-        uint8_t status = UART_Authenticate(passwordBuffer, AUTH_MODE_CHECK_ONLY, NULL);
+        case EVENT_TIMER:
+            if (step == STEP_SETTLE || step == STEP_ADJUST) {
+                if (step == STEP_SETTLE) {
+                    step = STEP_ADJUST;
+                    Scheduler_StartTimer(TIMER_STATE, POT_POLL_MS, POT_POLL_MS);
+                }
+                newTimeout = Potentiometer_GetTimeout();
+                snprintf(buffer, sizeof(buffer), "Time: %2lu sec", newTimeout);
+                showLine(1, buffer);
+            } else if (step == STEP_DONE) {
+                LED_Off();
+                *currentState = nextState;
+            }
+            break;
         
-        if (status == STATUS_UNKNOWN_CMD) {
-            showMessage("Comm Error!", "Try Again");
-            DelayMs(1500);
-            *currentState = STATE_MAIN_MENU;
-            return;
-        }
+        case EVENT_KEY:
+            if (step == STEP_ADJUST && (char)event->arg == 'D') {
+                Scheduler_StopTimer(TIMER_STATE);
+                step = STEP_PASSWORD;
+                startPasswordEntry(&entry, passwordBuffer, "Enter Password:");
+            }
+            else if (step == STEP_ADJUST && (char)event->arg == '#') {
+                LED_Off();
+                Finish("Cancelled", "", STATE_MAIN_MENU, CANCELLED_MS);
+            }
+            else if (step == STEP_PASSWORD) {
+                result = passwordEntryKey(&entry, (char)event->arg);
+                if (result == ENTRY_CANCELLED) {
+                    LED_Off();
+                    *currentState = STATE_MAIN_MENU;
+                } else if (result == ENTRY_DONE) {
+                    step = STEP_VERIFY;
+                    pendingCmd.req.onDone = Frontend_OnReply;
+                    showProgress("Verifying");
+                    UART_AuthenticateStart(&pendingCmd, passwordBuffer, AUTH_MODE_CHECK_ONLY);
+                }
+            }
+            break;
         
-        if (status == STATUS_OK) {
-            *attemptCount = 0;
-            status = UART_SetTimeout((uint8_t)newTimeout);
-            
-            if (status == STATUS_OK) {
-                LED_Green();
-                showMessage("Timeout Saved!", "");
-            } else {
-                LED_Red();
-                showMessage("Save Failed!", "Try Again");
+        case EVENT_UART_DONE:
+            if (step == STEP_SAVE) {
+                if (event->arg == STATUS_OK) {
+                    LED_Green();
+                    Finish("Timeout Saved!", "", STATE_MAIN_MENU, MESSAGE_MS);
+                } else {
+                    LED_Red();
+                    Finish("Save Failed!", "Try Again", STATE_MAIN_MENU, MESSAGE_MS);
+                }
             }
-            DelayMs(1500);
-            LED_Off();
-        }
-        else {
-            (*attemptCount)++;
-            LED_Red();
-            if (*attemptCount >= MAX_ATTEMPTS) {
-                *currentState = STATE_LOCKOUT;
-                return;
+            else if (event->arg == STATUS_UNKNOWN_CMD) {
+                Finish("Comm Error!", "Try Again", STATE_MAIN_MENU, MESSAGE_MS);
             }
-            showMessage("Wrong Password!", "Not Saved");
-            DelayMs(1500);
-            LED_Off();
-        }
-    } else {
-        LED_Off();
-        showMessage("Cancelled", "");
-        DelayMs(1000);
+            else if (event->arg == STATUS_OK) {
+                *attemptCount = 0;
+                step = STEP_SAVE;
+                showProgress("Saving");
+                UART_SetTimeoutStart(&pendingCmd, (uint8_t)newTimeout);
+            }
+            else {
+                (*attemptCount)++;
+                LED_Red();
+                if (*attemptCount >= MAX_ATTEMPTS) {
+                    *currentState = STATE_LOCKOUT;
+                    return;
+                }
+                Finish("Wrong Password!", "Not Saved", STATE_MAIN_MENU, MESSAGE_MS);
+            }
+            break;
+        
+        default:
+            break;
     }
-
-    *currentState = STATE_MAIN_MENU;
 }
@@ -10,18 +10,18 @@
 #include "application.h"
 
 /**
- * @brief Handle welcome screen state
+ * @brief Handle an event in the welcome screen state
  */
-void handleWelcome(Frontend_State_t *currentState, bool *isFirstTime);
+void handleWelcome(const Event_t *event, Frontend_State_t *currentState, bool *isFirstTime);
 
 /**
- * @brief Handle main menu state
+ * @brief Handle an event in the main menu state
  */
-void handleMainMenu(Frontend_State_t *currentState);
+void handleMainMenu(const Event_t *event, Frontend_State_t *currentState);
 
 /**
- * @brief Handle set timeout state
+ * @brief Handle an event in the set timeout state
  */
-void handleSetTimeout(Frontend_State_t *currentState, uint8_t *attemptCount);
+void handleSetTimeout(const Event_t *event, Frontend_State_t *currentState, uint8_t *attemptCount);
 
 #endif /* MENU_HANDLERS_H */
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * File: scheduler.c
+ * Module: Scheduler (Application Layer)
+ * Description: Event queue, state timers and polled tasks driving the
+ *              frontend state machine
+ ******************************************************************************/
+
+#include "scheduler.h"
+#include "../MCAL/systick.h"
+#include "../MCAL/soft_timer.h"
+#include <stddef.h>
+
+/* The soft timer only flags the expiry; the event goes out through
+ * DispatchNext so it is ordered after queued events and can be dropped
+ * by Scheduler_StopTimer */
+typedef struct {
+    SoftTimer_t timer;
+    uint32_t    periodMs;
+    bool        due;
+    uint32_t    dueMs;
+} Timer_t;
+
+typedef struct {
+    void   (*run)(void);
+    uint32_t periodMs;
+    uint32_t nextMs;
+} Task_t;
+
+static void (*dispatchFn)(const Event_t *event) = NULL;
+
+static Event_t queue[SCHEDULER_QUEUE_SIZE];
+static uint8_t queueHead = 0;
+static uint8_t queueCount = 0;
+
+static Timer_t timers[SCHEDULER_MAX_TIMERS];
+static Task_t tasks[SCHEDULER_MAX_TASKS];
+static uint8_t taskCount = 0;
+
+static Scheduler_Stats_t stats;
+
+/* Wrap-safe "a is at or after b" on the 32-bit millisecond clock */
+static bool Reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+static void OnTimer(void *arg)
+{
+    Timer_t *t = (Timer_t *)arg;
+    
+    /* First expiry of a periodic timer with a different initial delay */
+    if (t->periodMs > 0 && !SoftTimer_IsActive(&t->timer)) {
+        SoftTimer_StartPeriodic(&t->timer, t->periodMs, OnTimer, t);
+    }
+    if (!t->due) {
+        t->due = true;
+        t->dueMs = SysTick_GetMs();
+    }
+}
+
+static void Dispatch(const Event_t *event)
+{
+    uint32_t latency = SysTick_GetMs() - event->timeMs;
+    
+    if (latency > stats.maxLatencyMs) stats.maxLatencyMs = latency;
+    stats.events++;
+    dispatchFn(event);
+}
+
+/* Queued events first, in order; then the earliest due timer */
+static bool DispatchNext(void)
+{
+    Event_t event;
+    int8_t due = -1;
+    
+    if (queueCount > 0) {
+        event = queue[queueHead];
+        queueHead = (uint8_t)((queueHead + 1) % SCHEDULER_QUEUE_SIZE);
+        queueCount--;
+        Dispatch(&event);
+        return true;
+    }
+    
+    for (uint8_t i = 0; i < SCHEDULER_MAX_TIMERS; i++) {
+        if (timers[i].due &&
+            (due < 0 || Reached(timers[due].dueMs, timers[i].dueMs))) {
+            due = (int8_t)i;
+        }
+    }
+    if (due < 0) return false;
+    
+    event.type = EVENT_TIMER;
+    event.arg = (uint8_t)due;
+    event.timeMs = timers[due].dueMs;
+    timers[due].due = false;
+    Dispatch(&event);
+    return true;
+}
+
+void Scheduler_Init(void (*dispatch)(const Event_t *event))
+{
+    dispatchFn = dispatch;
+    queueHead = 0;
+    queueCount = 0;
+    taskCount = 0;
+    for (uint8_t i = 0; i < SCHEDULER_MAX_TIMERS; i++) {
+        Scheduler_StopTimer(i);
+    }
+    stats.events = 0;
+    stats.maxLatencyMs = 0;
+    stats.maxQueued = 0;
+    stats.dropped = 0;
+}
+
+bool Scheduler_Post(uint8_t type, uint8_t arg)
+{
+    Event_t *event;
+    
+    if (queueCount == SCHEDULER_QUEUE_SIZE) {
+        stats.dropped++;
+        return false;
+    }
+    event = &queue[(queueHead + queueCount) % SCHEDULER_QUEUE_SIZE];
+    event->type = type;
+    event->arg = arg;
+    event->timeMs = SysTick_GetMs();
+    queueCount++;
+    if (queueCount > stats.maxQueued) stats.maxQueued = queueCount;
+    return true;
+}
+
+void Scheduler_StartTimer(uint8_t id, uint32_t ms, uint32_t periodMs)
+{
+    if (id >= SCHEDULER_MAX_TIMERS) return;
+    timers[id].periodMs = periodMs;
+    timers[id].due = false;
+    if (periodMs > 0 && ms == periodMs) {
+        SoftTimer_StartPeriodic(&timers[id].timer, periodMs, OnTimer, &timers[id]);
+    } else {
+        SoftTimer_Start(&timers[id].timer, ms, OnTimer, &timers[id]);
+    }
+}
+
+void Scheduler_StopTimer(uint8_t id)
+{
+    if (id >= SCHEDULER_MAX_TIMERS) return;
+    SoftTimer_Cancel(&timers[id].timer);
+    timers[id].due = false;
+}
+
+bool Scheduler_AddTask(void (*task)(void), uint32_t periodMs)
+{
+    if (taskCount == SCHEDULER_MAX_TASKS) return false;
+    tasks[taskCount].run = task;
+    tasks[taskCount].periodMs = periodMs;
+    tasks[taskCount].nextMs = SysTick_GetMs();
+    taskCount++;
+    return true;
+}
+
+bool Scheduler_RunOnce(void)
+{
+    uint32_t now = SysTick_GetMs();
+    
+    SoftTimer_Process();
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (Reached(now, tasks[i].nextMs)) {
+            tasks[i].nextMs = now + tasks[i].periodMs;
+            tasks[i].run();
+        }
+    }
+    
+    if (DispatchNext()) return true;
+    
+    /* Nothing left to do this millisecond: sleep until the next tick */
+    DelayMs(1);
+    return false;
+}
+
+void Scheduler_Run(void)
+{
+    while (1) {
+        Scheduler_RunOnce();
+    }
+}
+
+void Scheduler_GetStats(Scheduler_Stats_t *out)
+{
+    *out = stats;
+}
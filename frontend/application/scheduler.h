@@ -0,0 +1,93 @@
+/******************************************************************************
+ * File: scheduler.h
+ * Module: Scheduler (Application Layer)
+ * Description: Event queue, state timers and polled tasks driving the
+ *              frontend state machine
+ ******************************************************************************/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHEDULER_QUEUE_SIZE    16      /* Pending events (power of two) */
+#define SCHEDULER_MAX_TIMERS    2
+#define SCHEDULER_MAX_TASKS     4
+
+/* Event types */
+typedef enum {
+    EVENT_ENTRY,            /* State entered (delivered directly, never queued) */
+    EVENT_KEY,              /* arg = key character */
+    EVENT_TIMER,            /* arg = timer id */
+    EVENT_UART_DONE         /* arg = status of the command in flight */
+} Event_Type_t;
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  arg;
+    uint32_t timeMs;        /* When it was posted (timers: when due) */
+} Event_t;
+
+/* Dispatch timing, for diagnostics */
+typedef struct {
+    uint32_t events;        /* Events dispatched */
+    uint32_t maxLatencyMs;  /* Longest wait between post and dispatch */
+    uint8_t  maxQueued;     /* Highest queue depth seen */
+    uint32_t dropped;       /* Posts refused because the queue was full */
+} Scheduler_Stats_t;
+
+/**
+ * @brief Reset the queue, timers and tasks
+ * @param dispatch Called once per event, in main loop context. Handlers
+ *        must run to completion: no DelayMs or waiting on input.
+ */
+void Scheduler_Init(void (*dispatch)(const Event_t *event));
+
+/**
+ * @brief Queue an event for dispatch
+ * @return false if the queue was full (the event is dropped and counted)
+ * @note Main loop context only (handlers, tasks, UART callbacks)
+ */
+bool Scheduler_Post(uint8_t type, uint8_t arg);
+
+/**
+ * @brief Arm a timer; it is dispatched as EVENT_TIMER with arg = id
+ * @param id Timer id (0..SCHEDULER_MAX_TIMERS-1)
+ * @param ms Delay until the first expiry
+ * @param periodMs Interval after that, 0 = one-shot
+ * @note Restarting an armed timer replaces it. Runs on a SoftTimer, so
+ *       SoftTimer_Init must have been called.
+ */
+void Scheduler_StartTimer(uint8_t id, uint32_t ms, uint32_t periodMs);
+
+/**
+ * @brief Disarm a timer; an expiry not yet dispatched is dropped
+ */
+void Scheduler_StopTimer(uint8_t id);
+
+/**
+ * @brief Run a function every periodMs (0 = every pass of the loop)
+ * @return false if the task table is full
+ */
+bool Scheduler_AddTask(void (*task)(void), uint32_t periodMs);
+
+/**
+ * @brief One pass: run expired soft timers and due tasks, then dispatch
+ *        one event (queued events before due timers), or sleep until the
+ *        next millisecond tick
+ * @return true if an event was dispatched
+ */
+bool Scheduler_RunOnce(void);
+
+/**
+ * @brief Run passes forever
+ */
+void Scheduler_Run(void);
+
+/**
+ * @brief Get dispatch counters; they restart at Scheduler_Init
+ */
+void Scheduler_GetStats(Scheduler_Stats_t *stats);
+
+#endif /* SCHEDULER_H */
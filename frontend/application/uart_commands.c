@@ -8,6 +8,93 @@
 #include "uart_protocol.h"
 #include <stddef.h>
 
+/* Upper bound for one sleep while a blocking call waits; Poll wakes
+ * earlier for bytes and resends */
+#define UART_WAIT_SLICE_MS     500
+
+/*===========================================================================
+ * Pending Commands
+ *===========================================================================*/
+
+static uint8_t Wait(UART_Pending_t *cmd)
+{
+    uint8_t status;
+    
+    do {
+        status = UART_Poll(cmd, UART_WAIT_SLICE_MS);
+    } while (status == STATUS_PENDING);
+    return status;
+}
+
+static void Start(UART_Pending_t *cmd, uint8_t cmdId, uint8_t payloadLen)
+{
+    /* The request is linked into the protocol queue until it completes */
+    if (cmd->req.status == STATUS_PENDING) Wait(cmd);
+    
+    cmd->req.cmd = cmdId;
+    cmd->req.payload = cmd->payload;
+    cmd->req.payloadLen = payloadLen;
+    cmd->req.outData = cmd->data;
+    UART_Protocol_Submit(&cmd->req);
+}
+
+static void CopyPassword(uint8_t *dest, const char *password)
+{
+    for (uint8_t i = 0; i < PASSWORD_LENGTH; i++) {
+        dest[i] = (uint8_t)password[i];
+    }
+}
+
+void UART_InitPasswordStart(UART_Pending_t *cmd, const char *password)
+{
+    CopyPassword(cmd->payload, password);
+    Start(cmd, CMD_INIT_PASSWORD, PASSWORD_LENGTH);
+}
+
+void UART_AuthenticateStart(UART_Pending_t *cmd, const char *password, uint8_t mode)
+{
+    cmd->payload[0] = mode;
+    CopyPassword(&cmd->payload[1], password);
+    Start(cmd, CMD_AUTH, 1 + PASSWORD_LENGTH);
+}
+
+void UART_SetTimeoutStart(UART_Pending_t *cmd, uint8_t seconds)
+{
+    if (seconds < 5) seconds = 5;
+    if (seconds > 30) seconds = 30;
+    cmd->payload[0] = seconds;
+    Start(cmd, CMD_SET_TIMEOUT, 1);
+}
+
+void UART_ChangePasswordStart(UART_Pending_t *cmd, const char *newPassword)
+{
+    CopyPassword(cmd->payload, newPassword);
+    Start(cmd, CMD_CHANGE_PASSWORD, PASSWORD_LENGTH);
+}
+
+void UART_GetTimeoutStart(UART_Pending_t *cmd)
+{
+    Start(cmd, CMD_GET_TIMEOUT, 0);
+}
+
+uint8_t UART_Poll(UART_Pending_t *cmd, uint32_t maxWaitMs)
+{
+    if (cmd->req.status == STATUS_PENDING) {
+        UART_Protocol_Poll(maxWaitMs);
+    }
+    return cmd->req.status;
+}
+
+uint8_t UART_GetReplyTimeout(const UART_Pending_t *cmd)
+{
+    if (cmd->req.status != STATUS_OK || cmd->req.outDataLen < 1) return 0;
+    return cmd->data[0];
+}
+
+/*===========================================================================
+ * Blocking Commands
+ *===========================================================================*/
+
 void UART_Init(void)
 {
     UART_Protocol_Init();
@@ -16,26 +103,21 @@ void UART_Init(void)
 /* CMD 0x01: Initialize Password (Signup) */
 uint8_t UART_InitPassword(const char *password)
 {
-    uint8_t payload[PASSWORD_LENGTH];
-    for (uint8_t i = 0; i < PASSWORD_LENGTH; i++) {
-        payload[i] = (uint8_t)password[i];
-    }
-    return UART_Protocol_SendCommand(CMD_INIT_PASSWORD, payload, PASSWORD_LENGTH, NULL, NULL);
+    UART_Pending_t cmd = {0};
+    
+    UART_InitPasswordStart(&cmd, password);
+    return Wait(&cmd);
 }
 
 /* CMD 0x02: Authenticate (mode: 0=check only, 1=open door) */
 uint8_t UART_Authenticate(const char *password, uint8_t mode, uint8_t *outTimeout)
 {
-    uint8_t payload[1 + PASSWORD_LENGTH];
-    payload[0] = mode;
-    for (uint8_t i = 0; i < PASSWORD_LENGTH; i++) {
-        payload[1 + i] = (uint8_t)password[i];
-    }
-    uint8_t data[4];
-    uint8_t dataLen = 0;
-    uint8_t status = UART_Protocol_SendCommand(CMD_AUTH, payload, 1 + PASSWORD_LENGTH, data, &dataLen);
-    if (status == STATUS_OK && dataLen >= 1 && outTimeout != NULL) {
-        *outTimeout = data[0];
+    UART_Pending_t cmd = {0};
+    
+    UART_AuthenticateStart(&cmd, password, mode);
+    uint8_t status = Wait(&cmd);
+    if (status == STATUS_OK && cmd.req.outDataLen >= 1 && outTimeout != NULL) {
+        *outTimeout = cmd.data[0];
     }
     return status;
 }
@@ -43,30 +125,30 @@ uint8_t UART_Authenticate(const char *password, uint8_t mode, uint8_t *outTimeou
 /* CMD 0x03: Set Timeout (5-30 seconds) */
 uint8_t UART_SetTimeout(uint8_t seconds)
 {
-    if (seconds < 5) seconds = 5;
-    if (seconds > 30) seconds = 30;
-    uint8_t payload[1] = {seconds};
-    return UART_Protocol_SendCommand(CMD_SET_TIMEOUT, payload, 1, NULL, NULL);
+    UART_Pending_t cmd = {0};
+    
+    UART_SetTimeoutStart(&cmd, seconds);
+    return Wait(&cmd);
 }
 
 /* CMD 0x04: Change Password */
 uint8_t UART_ChangePassword(const char *newPassword)
 {
-    uint8_t payload[PASSWORD_LENGTH];
-    for (uint8_t i = 0; i < PASSWORD_LENGTH; i++) {
-        payload[i] = (uint8_t)newPassword[i];
-    }
-    return UART_Protocol_SendCommand(CMD_CHANGE_PASSWORD, payload, PASSWORD_LENGTH, NULL, NULL);
+    UART_Pending_t cmd = {0};
+    
+    UART_ChangePasswordStart(&cmd, newPassword);
+    return Wait(&cmd);
 }
 
 /* CMD 0x05: Get Timeout */
 uint8_t UART_GetTimeout(uint8_t *outTimeout)
 {
-    uint8_t data[4];
-    uint8_t dataLen = 0;
-    uint8_t status = UART_Protocol_SendCommand(CMD_GET_TIMEOUT, NULL, 0, data, &dataLen);
-    if (status == STATUS_OK && dataLen >= 1 && outTimeout != NULL) {
-        *outTimeout = data[0];
+    UART_Pending_t cmd = {0};
+    
+    UART_GetTimeoutStart(&cmd);
+    uint8_t status = Wait(&cmd);
+    if (status == STATUS_OK && cmd.req.outDataLen >= 1 && outTimeout != NULL) {
+        *outTimeout = cmd.data[0];
     }
     return status;
 }
@@ -27,6 +27,17 @@
 /* Re-export status codes from protocol layer */
 #include "uart_protocol.h"
 
+/* A command started with one of the ..._Start functions. Holds the
+ * request, its payload and the reply until it completes, so it must stay
+ * in scope (static or in a frame that outlives the wait) until then.
+ * Zero it before first use; static storage already is. Set req.onDone
+ * beforehand to be called back on completion. */
+typedef struct {
+    UART_Request_t req;
+    uint8_t        payload[1 + PASSWORD_LENGTH];
+    uint8_t        data[16];
+} UART_Pending_t;
+
 /**
  * @brief Initialize UART communication
  */
@@ -69,4 +80,30 @@ uint8_t UART_ChangePassword(const char *newPassword);
  */
 uint8_t UART_GetTimeout(uint8_t *outTimeout);
 
+/*
+ * Non-blocking variants: start the command and return at once, then call
+ * UART_Poll until it stops returning STATUS_PENDING. Starting a handle
+ * that is still pending waits for its previous command first.
+ */
+void UART_InitPasswordStart(UART_Pending_t *cmd, const char *password);
+void UART_AuthenticateStart(UART_Pending_t *cmd, const char *password, uint8_t mode);
+void UART_SetTimeoutStart(UART_Pending_t *cmd, uint8_t seconds);
+void UART_ChangePasswordStart(UART_Pending_t *cmd, const char *newPassword);
+void UART_GetTimeoutStart(UART_Pending_t *cmd);
+
+/**
+ * @brief Drive the link and check on a started command
+ * @param cmd Handle passed to a ..._Start function
+ * @param maxWaitMs Longest to sleep if nothing happens (0 = don't wait)
+ * @return STATUS_PENDING while in flight, then the final status code
+ */
+uint8_t UART_Poll(UART_Pending_t *cmd, uint32_t maxWaitMs);
+
+/**
+ * @brief Timeout value from a completed Authenticate or GetTimeout reply
+ * @param cmd Completed handle
+ * @return Seconds, or 0 if the command failed or the reply had no data
+ */
+uint8_t UART_GetReplyTimeout(const UART_Pending_t *cmd);
+
 #endif /* UART_COMMANDS_H */
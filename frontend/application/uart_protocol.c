@@ -5,14 +5,160 @@
  ******************************************************************************/
 
 #include "uart_protocol.h"
+#include "crc16.h"
 #include "../MCAL/uart.h"
 #include "../MCAL/systick.h"
 #include <stddef.h>
 
 #define UART_MAX_RETRIES     3
 #define UART_SOF_SEARCH_MAX  100
+#define UART_MAX_LEN         32      /* Largest LEN the backend accepts */
+#define UART_MAX_OUT_DATA    16
+
+/* Response deadline (RTO) limits; it starts at the old fixed v2 timeout
+ * and tightens once responses have been timed */
+#define UART_RTO_INIT_MS       200
+#define UART_RTO_MIN_MS        20
+#define UART_RTO_MAX_MS        500
+#define UART_RTO_MAX_BACKOFF   3       /* Up to 8x after repeated timeouts */
 
 static uint8_t consecutiveFailures = 0;
+static uint8_t relinkPending = 0;
+static uint8_t protocolVersion = UART_PROTOCOL_VERSION;
+static uint8_t nextSeq = 0;
+
+/* Version negotiation runs as a queued HELLO; requests behind it wait */
+static UART_Request_t helloReq;
+static uint8_t helloData[UART_MAX_OUT_DATA];
+static uint8_t helloPrevious = UART_PROTOCOL_VERSION;
+static uint8_t negotiating = 0;
+
+/*===========================================================================
+ * Round-Trip Time Estimate (Jacobson/Karels, as in TCP)
+ *===========================================================================*/
+static int32_t srtt8 = 0;                   /* Smoothed RTT, ms x 8 */
+static int32_t rttVar4 = 0;                 /* RTT mean deviation, ms x 4 */
+static uint16_t rtoMs = UART_RTO_INIT_MS;
+static uint8_t rtoBackoff = 0;
+static uint32_t jitterState = 0x2545F491;
+static UART_LinkStats_t linkStats;
+
+static void ResetRtt(void)
+{
+    srtt8 = 0;
+    rttVar4 = 0;
+    rtoMs = UART_RTO_INIT_MS;
+    rtoBackoff = 0;
+    linkStats.samples = 0;
+    linkStats.retries = 0;
+    linkStats.timeouts = 0;
+}
+
+/* Only responses to first transmissions are timed (Karn): a reply to a
+ * resent request could belong to either copy */
+static void RttSample(uint32_t rtt)
+{
+    int32_t delta;
+    uint32_t rto;
+    
+    if (linkStats.samples == 0) {
+        srtt8 = (int32_t)rtt << 3;
+        rttVar4 = (int32_t)rtt << 1;
+    } else {
+        delta = (int32_t)rtt - (srtt8 >> 3);
+        srtt8 += delta;                     /* srtt += delta / 8 */
+        if (delta < 0) delta = -delta;
+        rttVar4 += delta - (rttVar4 >> 2);  /* rttvar += (|delta| - rttvar) / 4 */
+    }
+    linkStats.samples++;
+    
+    /* RTO = srtt + 4 * rttvar, at least one clock tick of variance */
+    rto = (uint32_t)(srtt8 >> 3) + (uint32_t)((rttVar4 > 1) ? rttVar4 : 1);
+    if (rto < UART_RTO_MIN_MS) rto = UART_RTO_MIN_MS;
+    if (rto > UART_RTO_MAX_MS) rto = UART_RTO_MAX_MS;
+    rtoMs = (uint16_t)rto;
+    rtoBackoff = 0;
+}
+
+static void RttTimeout(void)
+{
+    linkStats.timeouts++;
+    if (rtoBackoff < UART_RTO_MAX_BACKOFF) rtoBackoff++;
+}
+
+/* Random 0..maxMs, so retries don't stay in lockstep with the backend */
+static uint32_t Jitter(uint32_t maxMs)
+{
+    jitterState ^= jitterState << 13;
+    jitterState ^= jitterState >> 17;
+    jitterState ^= jitterState << 5;
+    return (jitterState + SysTick_GetMs()) % (maxMs + 1);
+}
+
+/* How long to wait for a response: RTO doubled per unanswered timeout */
+static uint32_t ResponseTimeout(void)
+{
+    uint32_t t = (uint32_t)rtoMs << rtoBackoff;
+    
+    if (t > UART_RTO_MAX_MS) t = UART_RTO_MAX_MS;
+    if (rtoBackoff > 0) t += Jitter(t / 4);
+    return t;
+}
+
+/* The backend hashes a PIN before answering this command */
+static uint8_t IsPinHashCmd(uint8_t cmd)
+{
+    return cmd < 32 && ((UART_PIN_HASH_CMDS >> cmd) & 1UL) != 0;
+}
+
+/*===========================================================================
+ * v2 In-Flight Window
+ *===========================================================================*/
+typedef struct {
+    UART_Request_t *req;        /* NULL when the slot is free */
+    uint8_t seq;
+    uint8_t tries;
+    uint32_t sentMs;            /* First transmission, for RTT */
+    uint8_t timed;              /* No PIN hash ahead of it: RTT is valid */
+} WindowSlot_t;
+
+static WindowSlot_t window[UART_WINDOW_SIZE];
+static uint8_t inFlight = 0;
+static uint32_t retryDeadline = 0;          /* Valid while inFlight > 0 */
+
+/* Submitted requests waiting for a window slot, oldest first */
+static UART_Request_t *queueHead = NULL;
+static UART_Request_t *queueTail = NULL;
+
+/* Incremental response parser, fed while sending and while waiting */
+#if UART_FRAMING_COBS
+#define RX_COBS_CODE     0
+#define RX_COBS_DATA     1
+#define RX_COBS_DISCARD  2
+#define RX_IDLE          RX_COBS_CODE
+#define COBS_DELIM       0x00
+#else
+#define RX_WAIT_SOF      0
+#define RX_READ_LEN      1
+#define RX_READ_BODY     2
+#define RX_IDLE          RX_WAIT_SOF
+#endif
+
+static uint8_t rxState = RX_IDLE;
+static uint8_t rxLen = 0;
+static uint8_t rxPos = 0;
+static uint8_t rxBuf[UART_MAX_LEN];
+static uint8_t v1PeerSeen = 0;
+#if UART_FRAMING_COBS
+static uint8_t rxBlock = 0;
+static uint8_t rxZeroPending = 0;
+#endif
+
+#if !UART_FRAMING_COBS
+
+/*===========================================================================
+ * Protocol v1 (stop-and-wait)
+ *===========================================================================*/
 
 /* Send a complete packet: [SOF=0x7E] [LEN] [CMD] [PAYLOAD...] */
 static uint8_t SendPacket(uint8_t cmd, const uint8_t *payload, uint8_t payloadLen)
@@ -31,74 +177,661 @@ static uint8_t SendPacket(uint8_t cmd, const uint8_t *payload, uint8_t payloadLe
     }
     
     UART_Driver_WaitTxComplete();
-    DelayMs(50);  /* Give backend time to process */
     
     return 1;
 }
 
-/* Receive response: [SOF=0xFE] [LEN] [CMD] [STATUS] [DATA...] */
-static uint8_t ReceiveResponse(uint8_t *outData, uint8_t *outDataLen)
+/* The one request v1 has in flight (stop-and-wait), counted in inFlight.
+ * retryDeadline is its response deadline once sent, else its resend time. */
+static UART_Request_t *v1Req = NULL;
+static uint8_t v1Tries = 0;
+static uint8_t v1Sent = 0;
+static uint32_t v1SentMs = 0;
+#endif /* !UART_FRAMING_COBS */
+
+/*===========================================================================
+ * Request Queue
+ *===========================================================================*/
+static void Enqueue(UART_Request_t *req)
 {
-    uint8_t byte, len, cmd, status, i;
-    uint8_t sofRetries = UART_SOF_SEARCH_MAX;
+    req->status = STATUS_PENDING;
+    req->outDataLen = 0;
+    req->next = NULL;
     
-    if (outDataLen != NULL) *outDataLen = 0;
-    
-    while (sofRetries > 0) {
-        if (!UART_Driver_ReceiveByte(&byte)) return STATUS_UNKNOWN_CMD;
-        if (byte == SOF_RESPONSE) break;
-        sofRetries--;
+    if (inFlight == 0 && queueHead == NULL) {
+        /* Idle link: drop leftovers of earlier timed-out exchanges */
+        UART_Driver_FlushRx();
+        rxState = RX_IDLE;
+        rxPos = 0;
     }
     
-    if (sofRetries == 0) return STATUS_UNKNOWN_CMD;
-    if (!UART_Driver_ReceiveByte(&len)) return STATUS_UNKNOWN_CMD;
-    if (len < 2 || len > 32) return STATUS_UNKNOWN_CMD;
-    if (!UART_Driver_ReceiveByte(&cmd)) return STATUS_UNKNOWN_CMD;
-    if (!UART_Driver_ReceiveByte(&status)) return STATUS_UNKNOWN_CMD;
+    if (queueTail != NULL) queueTail->next = req;
+    else queueHead = req;
+    queueTail = req;
+}
+
+static UART_Request_t *Dequeue(void)
+{
+    UART_Request_t *req = queueHead;
+    
+    if (req != NULL) {
+        queueHead = req->next;
+        if (queueHead == NULL) queueTail = NULL;
+    }
+    return req;
+}
+
+/* Hand a finished request back to its owner */
+static void Finish(UART_Request_t *req, uint8_t status)
+{
+    req->status = status;
     
-    uint8_t dataBytes = (len > 2) ? (len - 2) : 0;
-    for (i = 0; i < dataBytes; i++) {
-        if (!UART_Driver_ReceiveByte(&byte)) break;
-        if (outData != NULL && outDataLen != NULL && i < 16) {
-            outData[i] = byte;
-            (*outDataLen)++;
+    /* Two lost requests in a row: reset the link from the top level */
+    if (req->cmd != UART_CMD_HELLO) {
+        if (status != STATUS_UNKNOWN_CMD) {
+            consecutiveFailures = 0;
+        } else if (++consecutiveFailures >= 2) {
+            consecutiveFailures = 0;
+            relinkPending = 1;
         }
     }
     
-    return status;
+    if (req->onDone != NULL) req->onDone(req);
 }
 
-void UART_Protocol_Init(void)
+/*===========================================================================
+ * Protocol v2 (CRC, sequence numbers, sliding window)
+ *===========================================================================*/
+
+/* Complete the in-flight request a verified response belongs to */
+static void CompleteRequest(uint8_t seq, uint8_t cmd, uint8_t status, const uint8_t *data, uint8_t dataLen)
 {
-    UART_Driver_Init();
-    consecutiveFailures = 0;
+    uint8_t i, j;
+    
+    for (i = 0; i < UART_WINDOW_SIZE; i++) {
+        UART_Request_t *req = window[i].req;
+        if (req == NULL || window[i].seq != seq || req->cmd != cmd) continue;
+        
+        if (window[i].tries == 1 && window[i].timed) {
+            RttSample(SysTick_GetMs() - window[i].sentMs);
+        }
+        
+        req->outDataLen = 0;
+        if (req->outData != NULL) {
+            for (j = 0; j < dataLen && j < UART_MAX_OUT_DATA; j++) {
+                req->outData[j] = data[j];
+            }
+            req->outDataLen = j;
+        }
+        window[i].req = NULL;
+        inFlight--;
+        Finish(req, status);
+        return;
+    }
+    /* Late duplicate of something already completed - ignore */
 }
 
-uint8_t UART_Protocol_SendCommand(uint8_t cmd, const uint8_t *payload, uint8_t payloadLen, uint8_t *outData, uint8_t *outDataLen)
+#if !UART_FRAMING_COBS
+/* Body is [CMD][STATUS][DATA...] for v1. A reply to a timed-out try may
+ * still land while the resend waits; take it. */
+static void CompleteV1(void)
 {
-    uint8_t retry, status;
+    UART_Request_t *req = v1Req;
+    uint8_t j;
     
-    for (retry = 0; retry < UART_MAX_RETRIES; retry++) {
-        if (!SendPacket(cmd, payload, payloadLen)) {
-            DelayMs(50);
-            continue;
+    if (protocolVersion >= 2 || req == NULL || rxBuf[0] != req->cmd) return;
+    if (rxBuf[1] == STATUS_UNKNOWN_CMD) return;     /* Treated as no reply */
+    
+    if (v1Sent && v1Tries == 1 && !IsPinHashCmd(req->cmd)) {
+        RttSample(SysTick_GetMs() - v1SentMs);
+    }
+    
+    req->outDataLen = 0;
+    if (req->outData != NULL) {
+        for (j = 0; j + 2 < rxLen && j < UART_MAX_OUT_DATA; j++) {
+            req->outData[j] = rxBuf[j + 2];
+        }
+        req->outDataLen = j;
+    }
+    v1Req = NULL;
+    inFlight--;
+    Finish(req, rxBuf[1]);
+}
+#endif
+
+/* Body is [MARKER][SEQ][CMD][STATUS][DATA...][CRC_H][CRC_L] for v2 */
+static void HandleFrame(void)
+{
+    uint16_t crc;
+    
+    if (rxBuf[0] != UART_V2_MARKER) {
+#if !UART_FRAMING_COBS
+        CompleteV1();
+#endif
+        return;
+    }
+    
+    if (rxLen < 6) {
+#if !UART_FRAMING_COBS
+        /* [0xA5][ERROR] - a v1 backend rejecting the marker as a command */
+        v1PeerSeen = 1;
+#endif
+        return;
+    }
+    
+    crc = CRC16_Update(CRC16_INIT, &rxLen, 1);
+    crc = CRC16_Update(crc, rxBuf, rxLen - 2);
+    if (crc != (uint16_t)((rxBuf[rxLen - 2] << 8) | rxBuf[rxLen - 1])) return;
+    
+    CompleteRequest(rxBuf[1], rxBuf[2], rxBuf[3], &rxBuf[4], rxLen - 6);
+}
+
+#if UART_FRAMING_COBS
+/* COBS: [code][code-1 bytes] blocks, each implying a trailing zero except
+ * for 0xFF blocks and the last block; 0x00 ends the frame */
+static void RxFeed(uint8_t byte)
+{
+    if (byte == COBS_DELIM) {
+        if (rxState == RX_COBS_CODE && rxPos >= 2) {
+            rxLen = rxPos;
+            HandleFrame();
         }
+        rxState = RX_COBS_CODE;
+        rxPos = 0;
+        rxZeroPending = 0;
+        return;
+    }
+    
+    switch (rxState) {
+        case RX_COBS_CODE:
+            if (rxZeroPending) {
+                if (rxPos >= UART_MAX_LEN) {
+                    rxState = RX_COBS_DISCARD;
+                    break;
+                }
+                rxBuf[rxPos++] = 0x00;
+            }
+            rxBlock = byte - 1;
+            rxZeroPending = (byte != 0xFF);
+            rxState = (rxBlock > 0) ? RX_COBS_DATA : RX_COBS_CODE;
+            break;
         
-        status = ReceiveResponse(outData, outDataLen);
-        if (status != STATUS_UNKNOWN_CMD) {
-            consecutiveFailures = 0;
-            return status;
+        case RX_COBS_DATA:
+            if (rxPos >= UART_MAX_LEN) {
+                rxState = RX_COBS_DISCARD;
+                break;
+            }
+            rxBuf[rxPos++] = byte;
+            if (--rxBlock == 0) rxState = RX_COBS_CODE;
+            break;
+        
+        default:
+            break;
+    }
+}
+#else
+static void RxFeed(uint8_t byte)
+{
+    switch (rxState) {
+        case RX_WAIT_SOF:
+            if (byte == SOF_RESPONSE) rxState = RX_READ_LEN;
+            break;
+        
+        case RX_READ_LEN:
+            if (byte >= 2 && byte <= UART_MAX_LEN) {
+                rxLen = byte;
+                rxPos = 0;
+                rxState = RX_READ_BODY;
+            } else if (byte != SOF_RESPONSE) {
+                rxState = RX_WAIT_SOF;
+            }
+            break;
+        
+        default:
+            rxBuf[rxPos++] = byte;
+            if (rxPos >= rxLen) {
+                rxState = RX_WAIT_SOF;
+                HandleFrame();
+            }
+            break;
+    }
+}
+#endif
+
+/* Drain whatever the RX FIFO holds into the parser */
+static uint8_t PumpRx(void)
+{
+    uint8_t byte;
+    uint8_t got = 0;
+    
+    while (UART_Driver_TryReceiveByte(&byte)) {
+        RxFeed(byte);
+        got = 1;
+    }
+    return got;
+}
+
+static uint8_t SendByteAndPump(uint8_t byte)
+{
+    /* Keep draining RX while sending so earlier responses can't overrun
+     * the 16-byte FIFO */
+    if (!UART_Driver_SendByte(byte)) return 0;
+    PumpRx();
+    return 1;
+}
+
+/* Send body [0xA5][SEQ][CMD][PAYLOAD...][CRC_H][CRC_L] in the wire framing */
+static uint8_t SendFrameV2(uint8_t seq, const UART_Request_t *req)
+{
+    uint8_t body[UART_MAX_LEN];
+    uint8_t len = 0;
+    uint8_t i;
+    uint16_t crc;
+    
+    if (req->payloadLen > UART_MAX_LEN - 5) return 0;
+    
+    body[len++] = UART_V2_MARKER;
+    body[len++] = seq;
+    body[len++] = req->cmd;
+    for (i = 0; i < req->payloadLen; i++) {
+        body[len++] = req->payload[i];
+    }
+    i = len + 2;                    /* LEN as sent, incl. the CRC */
+    crc = CRC16_Update(CRC16_INIT, &i, 1);
+    crc = CRC16_Update(crc, body, len);
+    body[len++] = (uint8_t)(crc >> 8);
+    body[len++] = (uint8_t)(crc & 0xFF);
+
+#if UART_FRAMING_COBS
+    {
+        uint8_t start = 0;
+        uint8_t end;
+        for (;;) {
+            end = start;
+            while (end < len && body[end] != 0x00) end++;
+            if (!SendByteAndPump(end - start + 1)) return 0;
+            for (i = start; i < end; i++) {
+                if (!SendByteAndPump(body[i])) return 0;
+            }
+            if (end >= len) break;
+            start = end + 1;
+        }
+        return SendByteAndPump(COBS_DELIM);
+    }
+#else
+    if (!SendByteAndPump(SOF_REQUEST)) return 0;
+    if (!SendByteAndPump(len)) return 0;
+    for (i = 0; i < len; i++) {
+        if (!SendByteAndPump(body[i])) return 0;
+    }
+    return 1;
+#endif
+}
+
+/*
+ * A new SEQ may only go out while it is within UART_WINDOW_SIZE of the
+ * oldest outstanding one, so a retransmission always finds its response
+ * among the backend's last UART_WINDOW_SIZE cached responses.
+ */
+static uint8_t WindowHasRoom(void)
+{
+    uint8_t i;
+    
+    if (inFlight >= UART_WINDOW_SIZE) return 0;
+    for (i = 0; i < UART_WINDOW_SIZE; i++) {
+        if (window[i].req != NULL &&
+            (uint8_t)(nextSeq - window[i].seq) >= UART_WINDOW_SIZE) return 0;
+    }
+    return 1;
+}
+
+static uint8_t HashInFlight(void)
+{
+    uint8_t i;
+    
+    for (i = 0; i < UART_WINDOW_SIZE; i++) {
+        if (window[i].req != NULL && IsPinHashCmd(window[i].req->cmd)) return 1;
+    }
+    return 0;
+}
+
+/* One deadline covers the whole window; the backend answers in turn, so
+ * a hash anywhere in it delays every response behind it */
+static uint32_t WindowTimeout(void)
+{
+    return ResponseTimeout() + (HashInFlight() ? UART_PIN_HASH_ALLOW_MS : 0);
+}
+
+static void FailSlot(uint8_t i)
+{
+    UART_Request_t *req = window[i].req;
+    
+    window[i].req = NULL;
+    inFlight--;
+    Finish(req, STATUS_UNKNOWN_CMD);
+}
+
+static uint8_t DeadlinePassed(uint32_t deadlineMs)
+{
+    return (int32_t)(SysTick_GetMs() - deadlineMs) >= 0;
+}
+
+#if !UART_FRAMING_COBS
+/* The peer answered a v2 frame the v1 way: switch to v1 and put the
+ * in-flight requests back at the head of the queue, oldest first. HELLO
+ * has no v1 form and simply fails. */
+static void FallBackToV1(void)
+{
+    uint8_t i, newest;
+    UART_Request_t *req;
+    
+    v1PeerSeen = 0;
+    protocolVersion = 1;
+    
+    while (inFlight > 0) {
+        newest = UART_WINDOW_SIZE;
+        for (i = 0; i < UART_WINDOW_SIZE; i++) {
+            if (window[i].req == NULL) continue;
+            if (newest == UART_WINDOW_SIZE ||
+                (uint8_t)(nextSeq - window[i].seq) < (uint8_t)(nextSeq - window[newest].seq)) {
+                newest = i;
+            }
         }
+        req = window[newest].req;
+        window[newest].req = NULL;
+        inFlight--;
         
-        UART_Driver_FlushRx();
-        DelayMs(100);  /* Longer delay between retries */
+        if (req->cmd == UART_CMD_HELLO) {
+            Finish(req, STATUS_UNKNOWN_CMD);
+            continue;
+        }
+        req->next = queueHead;
+        queueHead = req;
+        if (queueTail == NULL) queueTail = req;
     }
+}
+
+/* v1 is stop-and-wait: one request goes out, and after a timeout it is
+ * resent once a random fraction of the RTO has passed, so a late reply
+ * can land first. Never waits; Service is called again. */
+static uint8_t ServiceV1(void)
+{
+    uint8_t progress = PumpRx();
+    UART_Request_t *req;
     
-    consecutiveFailures++;
-    if (consecutiveFailures >= 2) {
-        UART_Driver_Reinit();
-        consecutiveFailures = 0;
+    if (v1Req == NULL) {
+        v1Req = Dequeue();
+        if (v1Req == NULL) return progress;
+        inFlight++;
+        v1Tries = 0;
+        v1Sent = 0;
+        retryDeadline = SysTick_GetMs();
     }
+    if (!DeadlinePassed(retryDeadline)) return progress;
+    
+    if (v1Sent) {
+        /* No reply in time */
+        RttTimeout();
+        v1Sent = 0;
+        if (v1Tries >= UART_MAX_RETRIES) {
+            req = v1Req;
+            v1Req = NULL;
+            inFlight--;
+            Finish(req, STATUS_UNKNOWN_CMD);
+            return 1;
+        }
+        linkStats.retries++;
+        retryDeadline = SysTick_GetMs() + Jitter(rtoMs / 2);
+        return 1;
+    }
+    
+    v1Tries++;
+    v1Sent = 1;
+    rxState = RX_IDLE;                          /* SendPacket flushes RX */
+    v1SentMs = SysTick_GetMs();
+    retryDeadline = v1SentMs;                   /* Not sent: handled as a timeout */
+    if (SendPacket(v1Req->cmd, v1Req->payload, v1Req->payloadLen)) {
+        retryDeadline = SysTick_GetMs() + ResponseTimeout() +
+                        (IsPinHashCmd(v1Req->cmd) ? UART_PIN_HASH_ALLOW_MS : 0);
+    }
+    return 1;
+}
+#endif
+
+/*
+ * One non-blocking step: take in responses, fill free window slots from
+ * the queue, and back off and resend when the response deadline passes.
+ * Returns 1 if anything happened.
+ */
+static uint8_t Service(void)
+{
+    uint8_t progress = 0;
+    uint8_t sent = 0;
+    uint8_t i;
+
+#if !UART_FRAMING_COBS
+    if (protocolVersion < 2) return ServiceV1();
+#endif
+    
+    /* Any response restarts the timeout */
+    if (PumpRx()) {
+        retryDeadline = SysTick_GetMs() + WindowTimeout();
+        progress = 1;
+    }
+
+#if !UART_FRAMING_COBS
+    if (v1PeerSeen) {
+        FallBackToV1();
+        return 1;
+    }
+#endif
+    
+    /* Fill free slots; while negotiating only the HELLO goes out */
+    for (i = 0; i < UART_WINDOW_SIZE && queueHead != NULL && WindowHasRoom(); i++) {
+        if (window[i].req != NULL) continue;
+        if (negotiating && queueHead != &helloReq) break;
+        window[i].timed = !HashInFlight();
+        window[i].req = Dequeue();
+        window[i].seq = nextSeq++;
+        window[i].tries = 1;
+        window[i].sentMs = SysTick_GetMs();
+        if (IsPinHashCmd(window[i].req->cmd)) window[i].timed = 0;
+        inFlight++;
+        if (!SendFrameV2(window[i].seq, window[i].req)) {
+            FailSlot(i);
+        }
+        sent = 1;
+    }
+    if (sent) {
+        retryDeadline = SysTick_GetMs() + WindowTimeout();
+        progress = 1;
+    }
+    
+    if (inFlight > 0 && DeadlinePassed(retryDeadline)) {
+        /* Timed out: back off and resend everything still outstanding,
+         * same SEQ */
+        RttTimeout();
+        for (i = 0; i < UART_WINDOW_SIZE; i++) {
+            if (window[i].req == NULL) continue;
+            if (window[i].tries >= UART_MAX_RETRIES) {
+                FailSlot(i);
+                continue;
+            }
+            window[i].tries++;
+            linkStats.retries++;
+            SendFrameV2(window[i].seq, window[i].req);
+        }
+        retryDeadline = SysTick_GetMs() + WindowTimeout();
+        progress = 1;
+    }
+    
+    return progress;
+}
+
+/* Sleep until a byte arrives, the response deadline passes or maxMs */
+static void WaitForEvent(uint32_t maxMs)
+{
+    uint32_t deadline = SysTick_GetMs() + maxMs;
+    
+    if (inFlight > 0 && (int32_t)(retryDeadline - deadline) < 0) {
+        deadline = retryDeadline;
+    }
+    UART_Driver_WaitRx(deadline);
+}
+
+/* Blocking: queue the requests and run the link until all of them are
+ * done. Returns the number of requests that got no response. */
+static uint8_t RunWindow(UART_Request_t *reqs, uint8_t count)
+{
+    uint8_t first = 0;
+    uint8_t failed = 0;
+    uint8_t i;
+    
+    for (i = 0; i < count; i++) {
+        reqs[i].onDone = NULL;
+        Enqueue(&reqs[i]);
+    }
+    
+    for (;;) {
+        while (first < count && reqs[first].status != STATUS_PENDING) first++;
+        if (first == count) break;
+        if (!Service()) WaitForEvent(UART_RTO_MAX_MS);
+    }
+    
+    for (i = 0; i < count; i++) {
+        if (reqs[i].status == STATUS_UNKNOWN_CMD) failed++;
+    }
+    return failed;
+}
+
+static void HelloDone(UART_Request_t *req)
+{
+    negotiating = 0;
+    if (protocolVersion < UART_PROTOCOL_VERSION) return;    /* v1 peer replied */
+    
+    if (req->status != STATUS_OK || req->outDataLen < 1 ||
+        helloData[0] < UART_PROTOCOL_VERSION) {
+        protocolVersion = helloPrevious;
+    }
+}
+
+/*
+ * Ask the backend for v2: queue a HELLO ahead of everything else, and
+ * hold the rest of the queue until it completes. Only an explicit v1
+ * reply selects v1; if nothing comes back (backend still booting, line
+ * down) the current version is kept and a v1 peer is caught by its reply
+ * to the next v2 request.
+ */
+static void StartNegotiate(void)
+{
+    helloReq.cmd = UART_CMD_HELLO;
+    helloReq.payload = NULL;
+    helloReq.payloadLen = 0;
+    helloReq.outData = helloData;
+    helloReq.outDataLen = 0;
+    helloReq.status = STATUS_PENDING;
+    helloReq.onDone = HelloDone;
+    helloPrevious = protocolVersion;
+    v1PeerSeen = 0;
+    protocolVersion = UART_PROTOCOL_VERSION;    /* HELLO always goes out as v2 */
+    negotiating = 1;
+    
+    helloReq.next = queueHead;
+    queueHead = &helloReq;
+    if (queueTail == NULL) queueTail = &helloReq;
+}
+
+/* Blocking, for UART_Protocol_Init only */
+static void Negotiate(void)
+{
+    StartNegotiate();
+    while (negotiating) {
+        if (!Service()) WaitForEvent(UART_RTO_MAX_MS);
+    }
+}
+
+/* Reinit and renegotiate after repeated losses, once nothing is in
+ * flight. Only from the top level (never from inside Service), since it
+ * resets the driver under the parser. */
+static void Relink(void)
+{
+    if (!relinkPending || inFlight > 0 || negotiating) return;
+    relinkPending = 0;
+    UART_Driver_Reinit();
+    rxState = RX_IDLE;
+    rxPos = 0;
+    StartNegotiate();
+}
+
+/*===========================================================================
+ * Public API
+ *===========================================================================*/
+
+void UART_Protocol_Init(void)
+{
+    UART_Driver_Init();
+    consecutiveFailures = 0;
+    relinkPending = 0;
+    negotiating = 0;
+    queueHead = NULL;
+    queueTail = NULL;
+    inFlight = 0;
+#if !UART_FRAMING_COBS
+    v1Req = NULL;
+#endif
+    for (uint8_t i = 0; i < UART_WINDOW_SIZE; i++) {
+        window[i].req = NULL;
+    }
+    ResetRtt();
+    Negotiate();
+}
+
+uint8_t UART_Protocol_GetVersion(void)
+{
+    return protocolVersion;
+}
+
+uint8_t UART_Protocol_SendCommand(uint8_t cmd, const uint8_t *payload, uint8_t payloadLen, uint8_t *outData, uint8_t *outDataLen)
+{
+    UART_Request_t req = {cmd, payload, payloadLen, outData, 0, STATUS_UNKNOWN_CMD, NULL, NULL};
+    
+    RunWindow(&req, 1);
+    Relink();
+    if (outDataLen != NULL) *outDataLen = req.outDataLen;
+    return req.status;
+}
+
+void UART_Protocol_SendPipelined(UART_Request_t *reqs, uint8_t count)
+{
+    RunWindow(reqs, count);
+    Relink();
+}
+
+void UART_Protocol_Submit(UART_Request_t *req)
+{
+    Enqueue(req);
+}
+
+void UART_Protocol_Poll(uint32_t maxWaitMs)
+{
+    Relink();
+    if (Service() || maxWaitMs == 0) return;
+    if (inFlight == 0 && queueHead == NULL) return;     /* Nothing to wait for */
+    WaitForEvent(maxWaitMs);
+    Service();
+}
+
+uint8_t UART_Protocol_IsIdle(void)
+{
+    return inFlight == 0 && queueHead == NULL;
+}
+
+void UART_Protocol_GetLinkStats(UART_LinkStats_t *stats)
+{
+    uint32_t rto = (uint32_t)rtoMs << rtoBackoff;
     
-    return STATUS_UNKNOWN_CMD;
+    *stats = linkStats;
+    stats->srttMs = (uint16_t)((srtt8 + 4) >> 3);
+    stats->rttVarMs = (uint16_t)((rttVar4 + 2) >> 2);
+    stats->rtoMs = (uint16_t)((rto > UART_RTO_MAX_MS) ? UART_RTO_MAX_MS : rto);
 }
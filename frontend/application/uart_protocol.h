@@ -17,15 +17,87 @@
 #define STATUS_OK               0x00
 #define STATUS_ERROR            0x01
 #define STATUS_AUTH_FAIL        0x02
+#define STATUS_PENDING          0xFE    /* Submitted request still in flight */
 #define STATUS_UNKNOWN_CMD      0xFF
 
+/*
+ * Protocol v2 framing (falls back to v1 if the backend does not answer
+ * the v2 hello):
+ *   Request:  [0x7E][LEN][0xA5][SEQ][CMD][PAYLOAD...][CRC_H][CRC_L]
+ *   Response: [0xFE][LEN][0xA5][SEQ][CMD][STATUS][DATA...][CRC_H][CRC_L]
+ * LEN counts the bytes after itself; the CRC-16 covers LEN up to the byte
+ * before the CRC. Responses echo SEQ, so up to UART_WINDOW_SIZE requests
+ * can be in flight and be matched in any order. Retransmissions reuse the
+ * SEQ and the backend answers them from its cache without re-running the
+ * command.
+ */
+#define UART_PROTOCOL_VERSION   2
+#define UART_V2_MARKER          0xA5
+#define UART_CMD_HELLO          0x06
+#define UART_WINDOW_SIZE        4
+
+/*
+ * Commands the backend answers only after hashing a PIN (INIT_PASSWORD,
+ * AUTH, CHANGE_PASSWORD, ADD_USER), one bit per command ID. The hash
+ * holds the backend for its PIN_HASH_BUDGET_US, 100 ms by default, so
+ * their response deadline is the RTO plus UART_PIN_HASH_ALLOW_MS. Keep
+ * the allowance above the backend budget. Their round trips are not
+ * timed, nor those of requests queued behind them: the hash would push
+ * up the deadline of every other command.
+ */
+#define UART_PIN_HASH_CMDS      ((1UL << 0x01) | (1UL << 0x02) | (1UL << 0x04) | (1UL << 0x08))
+#define UART_PIN_HASH_ALLOW_MS  250
+
+/*
+ * Wire framing, must match the backend build (UART_FRAMING_COBS in its
+ * MCAL/uart.h):
+ *   0 - [SOF][LEN][body...] as above
+ *   1 - COBS-encoded body followed by a 0x00 delimiter, no SOF/LEN. A
+ *       receiver that loses sync recovers at the next delimiter whatever
+ *       the payload holds. Both ends are new firmware, so v2 is assumed
+ *       and there is no v1 fallback.
+ */
+#ifndef UART_FRAMING_COBS
+#define UART_FRAMING_COBS       0
+#endif
+
+/* One request for UART_Protocol_SendPipelined or UART_Protocol_Submit */
+typedef struct UART_Request {
+    uint8_t        cmd;
+    const uint8_t *payload;     /* Can be NULL */
+    uint8_t        payloadLen;
+    uint8_t       *outData;     /* Response data, up to 16 bytes (can be NULL) */
+    uint8_t        outDataLen;  /* Set on completion */
+    uint8_t        status;      /* STATUS_PENDING until done, STATUS_UNKNOWN_CMD if lost */
+    void         (*onDone)(struct UART_Request *req);  /* Submit only (can be NULL) */
+    struct UART_Request *next;  /* Internal: submit queue link */
+} UART_Request_t;
+
+/* Link timing, for diagnostics */
+typedef struct {
+    uint16_t srttMs;            /* Smoothed round-trip time */
+    uint16_t rttVarMs;          /* Round-trip time mean deviation */
+    uint16_t rtoMs;             /* Current response deadline (before jitter) */
+    uint32_t samples;           /* Round trips timed */
+    uint32_t retries;           /* Requests resent */
+    uint32_t timeouts;          /* Response deadlines that expired */
+} UART_LinkStats_t;
+
 /**
- * @brief Initialize the protocol layer (calls UART driver init)
+ * @brief Initialize the protocol layer (calls UART driver init) and
+ *        negotiate the protocol version with the backend
  */
 void UART_Protocol_Init(void);
 
 /**
- * @brief Send a command packet with automatic retry
+ * @brief Get the negotiated protocol version
+ * @return 2 if the backend speaks v2, otherwise 1
+ */
+uint8_t UART_Protocol_GetVersion(void);
+
+/**
+ * @brief Send a command packet with automatic retry (deadline and
+ *        backoff adapt to the measured round-trip time)
  * @param cmd Command ID
  * @param payload Payload data (can be NULL)
  * @param payloadLen Length of payload
@@ -37,4 +109,50 @@ uint8_t UART_Protocol_SendCommand(uint8_t cmd, const uint8_t *payload,
                                    uint8_t payloadLen, uint8_t *outData, 
                                    uint8_t *outDataLen);
 
+/**
+ * @brief Send several commands with up to UART_WINDOW_SIZE in flight
+ * @param reqs Requests; status/outData/outDataLen are filled in
+ * @param count Number of requests
+ * @note Under v1 the requests are sent one at a time
+ */
+void UART_Protocol_SendPipelined(UART_Request_t *reqs, uint8_t count);
+
+/**
+ * @brief Queue a request and return at once
+ * @param req Request; it must stay valid until it completes. status reads
+ *        STATUS_PENDING until then, and onDone (if set) is called on
+ *        completion from inside UART_Protocol_Poll or a blocking call
+ * @note Requests go out in submit order as the window has room. Under v1
+ *       they go out one at a time, still without blocking.
+ */
+void UART_Protocol_Submit(UART_Request_t *req);
+
+/**
+ * @brief Drive submitted requests: take in responses, send queued ones,
+ *        resend on timeout, run completion callbacks
+ * @param maxWaitMs If nothing happened, sleep up to this long (or until
+ *        a byte arrives or a resend is due) and check again; 0 = don't wait
+ * @note Never waits longer than maxWaitMs. After repeated failures the
+ *       link is reset and a HELLO is queued ahead of other requests,
+ *       which are held until it completes.
+ * @note Callbacks may submit new requests but must not call the blocking
+ *       API (SendCommand/SendPipelined)
+ */
+void UART_Protocol_Poll(uint32_t maxWaitMs);
+
+/**
+ * @brief Check whether all submitted requests have completed
+ * @return 1 if nothing is queued or in flight
+ */
+uint8_t UART_Protocol_IsIdle(void);
+
+/**
+ * @brief Get round-trip time estimate and retry counters
+ * @param stats Filled in; counters restart at UART_Protocol_Init
+ * @note The response deadline is derived from the estimate: srtt + 4 *
+ *       rttvar, clamped to 20..500 ms, doubled per timeout with jitter;
+ *       UART_PIN_HASH_CMDS wait UART_PIN_HASH_ALLOW_MS longer
+ */
+void UART_Protocol_GetLinkStats(UART_LinkStats_t *stats);
+
 #endif /* UART_PROTOCOL_H */
@@ -5,15 +5,99 @@
  ******************************************************************************/
 
 #include "ui_display.h"
+#include "application.h"
+#include "scheduler.h"
 #include "../HAL/lcd.h"
+#include "../HAL/led.h"
+
+#define PROGRESS_STEP_MS    250     /* Dot animation period */
+
+typedef enum {
+    ANIM_NONE,
+    ANIM_PROGRESS,
+    ANIM_BLINK
+} Anim_Mode_t;
+
+static Anim_Mode_t animMode = ANIM_NONE;
+static uint8_t progressCol = 0;
+static uint8_t progressDots = 0;
+static uint8_t blinkColor = LED_OFF;
+static uint8_t blinkSteps = 0;     /* On/off edges still to show */
 
 void showMessage(const char *line1, const char *line2)
 {
-    LCD_Clear();
-    LCD_SetCursor(0, 0);
-    if (line1) LCD_WriteString(line1);
-    if (line2) {
-        LCD_SetCursor(1, 0);
-        LCD_WriteString(line2);
+    LCD_BufferClear();
+    if (line1) LCD_BufferWrite(0, 0, line1);
+    if (line2) LCD_BufferWrite(1, 0, line2);
+    LCD_Flush();
+}
+
+void showLine(uint8_t row, const char *text)
+{
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+        LCD_BufferPutChar(row, col, *text ? *text++ : ' ');
+    }
+    LCD_Flush();
+}
+
+void showCharAt(uint8_t row, uint8_t col, char c)
+{
+    LCD_BufferPutChar(row, col, c);
+    LCD_Flush();
+}
+
+void showProgress(const char *label)
+{
+    progressCol = 0;
+    while (label[progressCol] != '\0' && progressCol < LCD_COLS - 3) progressCol++;
+    progressDots = 0;
+    showMessage(label, "");
+    
+    animMode = ANIM_PROGRESS;
+    Scheduler_StartTimer(TIMER_ANIM, PROGRESS_STEP_MS, PROGRESS_STEP_MS);
+}
+
+void blinkLed(uint8_t color, uint8_t times, uint16_t periodMs)
+{
+    if (times == 0) return;
+    blinkColor = color;
+    blinkSteps = (uint8_t)(times * 2 - 1);
+    LED_SetColor(color);
+    
+    animMode = ANIM_BLINK;
+    Scheduler_StartTimer(TIMER_ANIM, periodMs, periodMs);
+}
+
+void stepAnimation(void)
+{
+    switch (animMode) {
+        case ANIM_PROGRESS:
+            progressDots = (uint8_t)((progressDots + 1) % 4);
+            for (uint8_t i = 0; i < 3; i++) {
+                LCD_BufferPutChar(0, (uint8_t)(progressCol + i), i < progressDots ? '.' : ' ');
+            }
+            LCD_Flush();
+            break;
+        
+        case ANIM_BLINK:
+            blinkSteps--;
+            if (blinkSteps % 2 == 0) {
+                LED_Off();
+            } else {
+                LED_SetColor(blinkColor);
+            }
+            if (blinkSteps == 0) stopAnimation();
+            break;
+        
+        default:
+            Scheduler_StopTimer(TIMER_ANIM);
+            break;
     }
 }
+
+void stopAnimation(void)
+{
+    if (animMode == ANIM_BLINK) LED_Off();
+    animMode = ANIM_NONE;
+    Scheduler_StopTimer(TIMER_ANIM);
+}
@@ -13,7 +13,49 @@
  * @brief Display a message on the LCD (2 lines)
  * @param line1 First line text (or NULL)
  * @param line2 Second line text (or NULL)
+ * @note Only the characters that differ from the current screen are sent
  */
 void showMessage(const char *line1, const char *line2);
 
+/**
+ * @brief Replace one line of the current screen
+ * @param row 0 or 1
+ * @param text Line text; the rest of the row is blanked
+ */
+void showLine(uint8_t row, const char *text);
+
+/**
+ * @brief Change a single character of the current screen
+ * @param row 0 or 1
+ * @param col 0-15
+ * @param c Character to show
+ */
+void showCharAt(uint8_t row, uint8_t col, char c);
+
+/**
+ * @brief Show a label with animated dots while a command is in flight
+ * @param label First line text, e.g. "Verifying"; dots follow it
+ * @note Runs on TIMER_ANIM until stopAnimation (called by the dispatcher
+ *       when the reply arrives or the state changes)
+ */
+void showProgress(const char *label);
+
+/**
+ * @brief Blink the LED without blocking (same pattern as LED_Blink)
+ * @param color LED_xxx color
+ * @param times Number of flashes
+ * @param periodMs On and off time of each flash
+ */
+void blinkLed(uint8_t color, uint8_t times, uint16_t periodMs);
+
+/**
+ * @brief Advance the progress dots or LED blink (TIMER_ANIM expiry)
+ */
+void stepAnimation(void);
+
+/**
+ * @brief Stop the progress dots or LED blink, leaving the LED off if blinking
+ */
+void stopAnimation(void);
+
 #endif /* UI_DISPLAY_H */
@@ -44,6 +44,16 @@ static void NmiSR(void);
 static void FaultISR(void);
 static void IntDefaultHandler(void);
 extern void SystickHandler(void);
+extern void UART1Handler(void);
+extern void I2C0Handler(void);
+extern void GPIOPortAHandler(void);
+extern void GPIOPortBHandler(void);
+extern void GPIOPortCHandler(void);
+extern void GPIOPortDHandler(void);
+extern void GPIOPortEHandler(void);
+extern void GPIOPortFHandler(void);
+extern void Timer1AHandler(void);
+extern void ADC0SS3Handler(void);
 
 //*****************************************************************************
 //
@@ -98,15 +108,15 @@ __root const uVectorEntry __vector_table[] @ ".intvec" =
     0,                                      // Reserved
     IntDefaultHandler,                      // The PendSV handler
     SystickHandler,			      // The SysTick handler
-    IntDefaultHandler,                      // GPIO Port A
-    IntDefaultHandler,                      // GPIO Port B
-    IntDefaultHandler,                      // GPIO Port C
-    IntDefaultHandler,                      // GPIO Port D
-    IntDefaultHandler,                      // GPIO Port E
+    GPIOPortAHandler,                       // GPIO Port A
+    GPIOPortBHandler,                       // GPIO Port B
+    GPIOPortCHandler,                       // GPIO Port C
+    GPIOPortDHandler,                       // GPIO Port D
+    GPIOPortEHandler,                       // GPIO Port E
     IntDefaultHandler,                      // UART0 Rx and Tx
-    IntDefaultHandler,                      // UART1 Rx and Tx
+    UART1Handler,                           // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
-    IntDefaultHandler,                      // I2C0 Master and Slave
+    I2C0Handler,                            // I2C0 Master and Slave
     IntDefaultHandler,                      // PWM Fault
     IntDefaultHandler,                      // PWM Generator 0
     IntDefaultHandler,                      // PWM Generator 1
@@ -115,11 +125,11 @@ __root const uVectorEntry __vector_table[] @ ".intvec" =
     IntDefaultHandler,                      // ADC Sequence 0
     IntDefaultHandler,                      // ADC Sequence 1
     IntDefaultHandler,                      // ADC Sequence 2
-    IntDefaultHandler,                      // ADC Sequence 3
+    ADC0SS3Handler,                         // ADC Sequence 3
     IntDefaultHandler,                      // Watchdog timer
     IntDefaultHandler,                      // Timer 0 subtimer A
     IntDefaultHandler,                      // Timer 0 subtimer B
-    IntDefaultHandler,                      // Timer 1 subtimer A
+    Timer1AHandler,                         // Timer 1 subtimer A
     IntDefaultHandler,                      // Timer 1 subtimer B
     IntDefaultHandler,                      // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
@@ -128,7 +138,7 @@ __root const uVectorEntry __vector_table[] @ ".intvec" =
     IntDefaultHandler,                      // Analog Comparator 2
     IntDefaultHandler,                      // System Control (PLL, OSC, BO)
     IntDefaultHandler,                      // FLASH Control
-    IntDefaultHandler,                      // GPIO Port F
+    GPIOPortFHandler,                       // GPIO Port F
     IntDefaultHandler,                      // GPIO Port G
     IntDefaultHandler,                      // GPIO Port H
     IntDefaultHandler,                      // UART2 Rx and Tx
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include "driverlib/sysctl.h"
 #include "MCAL/systick.h"
+#include "MCAL/soft_timer.h"
 #include "application/application.h"
 
 int main(void)
@@ -25,8 +26,10 @@ int main(void)
         SYSCTL_XTAL_16MHZ
     );
 
-    /* Initialize SysTick for delays (16MHz / 16000 = 1ms tick) */
-    SysTick_Init(16000, SYSTICK_NOINT);
+    /* 1 ms SysTick interrupt (16MHz / 16000): millisecond clock for UART
+     * timeouts and software timers, and DelayMs sleeps between ticks */
+    SysTick_Init(16000, SYSTICK_INT);
+    SoftTimer_Init();
     
     /* Additional stabilization delay for I2C LCD */
     DelayMs(200);
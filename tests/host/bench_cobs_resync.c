@@ -0,0 +1,377 @@
+/*
+ * bench_cobs_resync.c - Host tests and resync benchmark for the backend
+ * UART1 wire framing (SOF/LEN or COBS, see UART_FRAMING_COBS)
+ *
+ * Checks that UART_Driver_SendFrame output decodes back through the RX
+ * interrupt for bodies full of 0x00, 0x7E and 0xFF bytes. Then streams
+ * frames into the ISR with a single bit error and measures how many
+ * frames the error costs and how many bytes pass before the first intact
+ * frame is delivered again, for random payloads and for payloads that
+ * are mostly 0x7E/0x00 (the worst case for SOF hunting).
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_cobs_resync.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/MCAL/uart.c backend/MCAL/gptm.c \
+ *       backend/MCAL/soft_timer.c -o bench_cobs_resync
+ *   ./bench_cobs_resync
+ *
+ * Rebuild with -DUART_FRAMING_COBS=1 for the COBS numbers.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "../../backend/MCAL/uart.h"
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SOF_REQUEST     0x7E
+#define SOF_RESPONSE    0xFE
+#define RX_TRIGGER      2       /* UART_FIFO_RX1_8 of a 16-byte FIFO */
+
+#define STREAM_FRAMES   24
+#define TRIALS          20000
+
+#if UART_FRAMING_COBS
+#define FRAMING_NAME    "COBS"
+#else
+#define FRAMING_NAME    "SOF/LEN"
+#endif
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+/* Encode one frame as a frontend request, same framing as SendFrame */
+static uint16_t encode(const uint8_t *body, uint8_t len, uint8_t *out)
+{
+    uint16_t n = 0;
+
+#if UART_FRAMING_COBS
+    uint16_t code_at = n++;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (body[i] == 0x00)
+        {
+            out[code_at] = (uint8_t)(n - code_at);
+            code_at = n++;
+        }
+        else
+        {
+            out[n++] = body[i];
+        }
+    }
+    out[code_at] = (uint8_t)(n - code_at);
+    out[n++] = 0x00;
+#else
+    out[n++] = SOF_REQUEST;
+    out[n++] = len;
+    memcpy(&out[n], body, len);
+    n += len;
+#endif
+    return n;
+}
+
+static void reset_driver(void)
+{
+    FakeUART_Reset();
+    UART_Driver_Init();
+}
+
+/* Push one byte onto the fake line, firing the ISR at the FIFO trigger */
+static void line_byte(uint8_t b)
+{
+    FakeUART_RxPush(b);
+    if (FakeUART_RxLevel() >= RX_TRIGGER)
+    {
+        FakeUART_RaiseRxInterrupt();
+    }
+}
+
+/* Let the TX interrupt drain the ring onto the line */
+static void drain_tx(void)
+{
+    while (!UART_Driver_IsTxIdle())
+    {
+        FakeCPU_Advance(FAKE_UART_BYTE_CYCLES);
+        if (FakeUART_TxInterruptPending())
+        {
+            FakeUART_RaiseTxInterrupt();
+        }
+    }
+}
+
+static void random_body(uint8_t *body, uint8_t len, int nasty)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (nasty)
+        {
+            /* Mostly SOF and delimiter look-alikes */
+            int r = rand() % 4;
+            body[i] = (r == 0) ? 0x00 : (r == 1) ? (uint8_t)rand() : SOF_REQUEST;
+        }
+        else
+        {
+            body[i] = (uint8_t)rand();
+        }
+    }
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_send_frame_format(void)
+{
+    const uint8_t body[] = {0xA5, 0x00, 0x7E, 0x00, 0x00, 0xFF, 0x11};
+    uint8_t expect[40];
+
+    reset_driver();
+    UART_Driver_SendFrame(body, sizeof(body));
+    drain_tx();
+
+#if UART_FRAMING_COBS
+    uint16_t n = encode(body, sizeof(body), expect);
+    TEST_ASSERT_EQUAL(n, FakeUART_TxLogLen());
+    TEST_ASSERT_EQUAL(0, memcmp(expect, FakeUART_TxLog(), n));
+    /* No zero anywhere but the trailing delimiter */
+    TEST_ASSERT(memchr(FakeUART_TxLog(), 0x00, n - 1) == NULL);
+#else
+    expect[0] = SOF_RESPONSE;
+    expect[1] = sizeof(body);
+    memcpy(&expect[2], body, sizeof(body));
+    TEST_ASSERT_EQUAL(sizeof(body) + 2, FakeUART_TxLogLen());
+    TEST_ASSERT_EQUAL(0, memcmp(expect, FakeUART_TxLog(), sizeof(body) + 2));
+#endif
+
+    TEST_PASS();
+}
+
+static TestResult test_round_trip(void)
+{
+    uint8_t body[UART_MAX_LEN];
+    uint8_t wire[64];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+
+    reset_driver();
+    srand(7);
+
+    for (uint32_t t = 0; t < 2000; t++)
+    {
+        uint8_t n = (uint8_t)(1 + rand() % UART_MAX_LEN);
+        random_body(body, n, (int)(t & 1));
+        if (t % 50 == 0)
+        {
+            memset(body, 0x00, n);      /* All-zero body */
+        }
+
+        uint16_t w = encode(body, n, wire);
+        for (uint16_t i = 0; i < w; i++)
+        {
+            line_byte(wire[i]);
+        }
+        FakeUART_RaiseRxInterrupt();
+
+        TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+        TEST_ASSERT_EQUAL(n, len);
+        TEST_ASSERT_EQUAL(0, memcmp(body, buf, n));
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_oversized_frame_discarded(void)
+{
+    uint8_t body[UART_MAX_LEN + 8];
+    uint8_t wire[64];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+    UART_RxStats_t stats;
+
+    reset_driver();
+    memset(body, 0x33, sizeof(body));
+
+#if UART_FRAMING_COBS
+    uint16_t w = encode(body, sizeof(body), wire);
+#else
+    /* A LEN the parser cannot accept */
+    uint16_t w = encode(body, UART_MAX_LEN, wire);
+    wire[1] = UART_MAX_LEN + 8;
+#endif
+    for (uint16_t i = 0; i < w; i++)
+    {
+        line_byte(wire[i]);
+    }
+
+    /* The next good frame still gets through */
+    w = encode(body, 4, wire);
+    for (uint16_t i = 0; i < w; i++)
+    {
+        line_byte(wire[i]);
+    }
+    FakeUART_RaiseRxInterrupt();
+
+    TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(4, len);
+    TEST_ASSERT(!UART_Driver_IsPacketReady());
+    UART_Driver_GetStats(&stats);
+    TEST_ASSERT(stats.frames_discarded >= 1);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Resync benchmark
+ *===========================================================================*/
+typedef struct {
+    uint32_t frames_lost;
+    uint32_t garbage;           /* Frames delivered that were never sent */
+    uint32_t recovery[TRIALS];  /* Bytes from the error to the next good frame */
+    uint32_t unrecovered;       /* Stream ended before resync */
+} resync_result_t;
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void run_resync(int nasty, resync_result_t *res, double *ns_per_byte)
+{
+    static uint8_t bodies[STREAM_FRAMES][UART_MAX_LEN];
+    static uint8_t lens[STREAM_FRAMES];
+    static uint16_t ends[STREAM_FRAMES];
+    static uint8_t wire[STREAM_FRAMES * 40];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len;
+    uint32_t recovered = 0;
+    uint64_t bytes_total = 0;
+    double t_isr = 0.0;
+
+    memset(res, 0, sizeof(*res));
+    srand(nasty ? 1234 : 4321);
+
+    for (uint32_t t = 0; t < TRIALS; t++)
+    {
+        uint16_t w = 0;
+
+        for (uint8_t f = 0; f < STREAM_FRAMES; f++)
+        {
+            /* v2-sized requests: marker, seq, cmd, payload, CRC */
+            lens[f] = (uint8_t)(5 + rand() % 12);
+            random_body(bodies[f], lens[f], nasty);
+            w += encode(bodies[f], lens[f], &wire[w]);
+            ends[f] = w;
+        }
+
+        /* One bit error somewhere in the first quarter of the stream */
+        uint16_t err_at = (uint16_t)(rand() % ends[STREAM_FRAMES / 4]);
+        wire[err_at] ^= (uint8_t)(1u << (rand() % 8));
+
+        uint8_t err_frame = 0;
+        while (ends[err_frame] <= err_at)
+        {
+            err_frame++;
+        }
+
+        reset_driver();
+
+        /* Feed the stream, matching delivered frames in order */
+        uint8_t next = 0;
+        uint32_t delivered = 0;
+        int32_t first_good_after = -1;
+        double t0 = now_sec();
+        for (uint16_t i = 0; i < w; i++)
+        {
+            line_byte(wire[i]);
+            if (i + 1 == w)
+            {
+                FakeUART_RaiseRxInterrupt();
+            }
+            while (UART_Driver_GetPacket(buf, &len))
+            {
+                uint8_t f = next;
+                while (f < STREAM_FRAMES &&
+                       !(lens[f] == len && memcmp(bodies[f], buf, len) == 0))
+                {
+                    f++;
+                }
+                if (f == STREAM_FRAMES)
+                {
+                    res->garbage++;
+                    continue;
+                }
+                delivered++;
+                next = (uint8_t)(f + 1);
+                if (f > err_frame && first_good_after < 0)
+                {
+                    first_good_after = f;
+                }
+            }
+        }
+        t_isr += now_sec() - t0;
+        bytes_total += w;
+
+        res->frames_lost += STREAM_FRAMES - delivered;
+        if (first_good_after < 0)
+        {
+            res->unrecovered++;
+        }
+        else
+        {
+            res->recovery[recovered++] = ends[first_good_after] - err_at;
+        }
+    }
+
+    qsort(res->recovery, recovered, sizeof(uint32_t), cmp_u32);
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < recovered; i++)
+    {
+        sum += res->recovery[i];
+    }
+
+    *ns_per_byte = t_isr * 1e9 / (double)bytes_total;
+    printf("    %-8s %-7s lost %.2f frames/error, garbage %u, "
+           "resync bytes mean %.1f p99 %u max %u, unrecovered %u\n",
+           nasty ? "0x7E/00" : "random", FRAMING_NAME,
+           (double)res->frames_lost / TRIALS, res->garbage,
+           recovered ? (double)sum / recovered : 0.0,
+           recovered ? res->recovery[recovered * 99 / 100] : 0,
+           recovered ? res->recovery[recovered - 1] : 0,
+           res->unrecovered);
+}
+
+static resync_result_t results[2];
+
+int main(void)
+{
+    double ns_random, ns_nasty;
+
+    test_init();
+
+    printf("\n--- UART Framing Tests (%s) ---\n", FRAMING_NAME);
+    run_test("SendFrame Format", test_send_frame_format);
+    run_test("Round Trip", test_round_trip);
+    run_test("Oversized Frame Discarded", test_oversized_frame_discarded);
+
+    printf("\n--- Resync After One Bit Error (%u trials, %u frames each) ---\n",
+           TRIALS, STREAM_FRAMES);
+    run_resync(0, &results[0], &ns_random);
+    run_resync(1, &results[1], &ns_nasty);
+    printf("    RX path incl. fake FIFO: %.1f / %.1f host ns per byte\n",
+           ns_random, ns_nasty);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
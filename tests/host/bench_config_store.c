@@ -0,0 +1,400 @@
+/*
+ * bench_config_store.c - Host test/simulator for the wear-leveled config
+ * store
+ *
+ * Checks the record log end to end on the fake EEPROM: newest record wins
+ * across blocks and reboots, torn records are skipped, a reset at any step
+ * of a compaction loses nothing, and background compaction keeps it off
+ * the write path. The simulator then drives millions of configuration
+ * updates and reports per-block erase counts, the hottest word against the
+ * old fixed layout, write latency and the boot index-build time.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_config_store.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/application/config_store.c \
+ *       backend/application/crc16.c -o bench_config_store
+ *   ./bench_config_store
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "driverlib/eeprom.h"
+#include "../../backend/application/config_store.h"
+#include <string.h>
+#include <time.h>
+
+#define KEY_PASSWORD        0
+#define KEY_TIMEOUT         1
+#define KEY_POTENTIOMETER   2
+
+#define LOG_BASE            (CONFIG_STORE_FIRST_BLOCK * FAKE_EEPROM_BLOCK_WORDS * 4)
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static uint32_t lcg_state = 1;
+
+static uint32_t lcg(void)
+{
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return (lcg_state >> 16) & 0x7FFF;
+}
+
+static void fresh_part(void)
+{
+    FakeEEPROM_Reset();
+    EEPROMInit();
+    ConfigStore_Init();
+}
+
+static void run_background(void)
+{
+    while (ConfigStore_Process())
+    {
+    }
+}
+
+static uint32_t read_key(uint8_t key)
+{
+    uint32_t value = 0;
+    if (ConfigStore_Read(key, &value, 1) != 1)
+    {
+        return 0xFFFFFFFF;
+    }
+    return value;
+}
+
+static int write_key(uint8_t key, uint32_t value)
+{
+    return ConfigStore_Write(key, &value, 1);
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_empty_part(void)
+{
+    ConfigStore_Info_t info;
+    uint32_t value;
+
+    fresh_part();
+    ConfigStore_GetInfo(&info);
+    TEST_ASSERT_EQUAL(0, info.used_blocks);
+    TEST_ASSERT_EQUAL(CONFIG_STORE_BLOCKS, info.free_blocks);
+    TEST_ASSERT_EQUAL(0, ConfigStore_Read(KEY_TIMEOUT, &value, 1));
+    TEST_ASSERT(!ConfigStore_Process());
+
+    /* Block 0 (old fixed layout) is never touched */
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 7));
+    TEST_ASSERT_EQUAL(0, FakeEEPROM_BlockWrites(0));
+
+    TEST_PASS();
+}
+
+static TestResult test_newest_record_wins(void)
+{
+    uint32_t value[CONFIG_STORE_MAX_WORDS];
+    uint32_t expect[CONFIG_STORE_MAX_WORDS];
+
+    fresh_part();
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, i));
+        TEST_ASSERT_EQUAL(i, read_key(KEY_TIMEOUT));
+        if (i % 50 == 0)
+        {
+            TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_PASSWORD, 10000 + i));
+        }
+        run_background();
+    }
+    for (uint8_t i = 0; i < CONFIG_STORE_MAX_WORDS; i++)
+    {
+        expect[i] = 0xA5000000u + i;
+    }
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, ConfigStore_Write(5, expect, CONFIG_STORE_MAX_WORDS));
+
+    ConfigStore_Init();
+    TEST_ASSERT_EQUAL(199, read_key(KEY_TIMEOUT));
+    TEST_ASSERT_EQUAL(10150, read_key(KEY_PASSWORD));
+    TEST_ASSERT_EQUAL(0xFFFFFFFF, read_key(KEY_POTENTIOMETER));
+    TEST_ASSERT_EQUAL(CONFIG_STORE_MAX_WORDS, ConfigStore_Read(5, value, CONFIG_STORE_MAX_WORDS));
+    TEST_ASSERT(memcmp(value, expect, sizeof(expect)) == 0);
+
+    /* Bad arguments */
+    TEST_ASSERT_EQUAL(CONFIG_STORE_ERROR, ConfigStore_Write(CONFIG_STORE_MAX_KEYS, expect, 1));
+    TEST_ASSERT_EQUAL(CONFIG_STORE_ERROR, ConfigStore_Write(1, expect, CONFIG_STORE_MAX_WORDS + 1));
+
+    TEST_PASS();
+}
+
+static TestResult test_torn_record_skipped(void)
+{
+    ConfigStore_Info_t info;
+
+    fresh_part();
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 10));
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 20));
+
+    /* Reset before the commit word of the second record landed */
+    ConfigStore_GetInfo(&info);
+    uint32_t commit = LOG_BASE + (info.head_block * FAKE_EEPROM_BLOCK_WORDS + info.head_pos - 1) * 4;
+    FakeEEPROM_Poke(commit, 0xFFFFFFFF);
+
+    ConfigStore_Init();
+    ConfigStore_GetInfo(&info);
+    TEST_ASSERT_EQUAL(1, info.torn_records);
+    TEST_ASSERT_EQUAL(10, read_key(KEY_TIMEOUT));
+
+    /* The next record goes after the torn one and is found on reboot */
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 30));
+    ConfigStore_Init();
+    TEST_ASSERT_EQUAL(30, read_key(KEY_TIMEOUT));
+
+    TEST_PASS();
+}
+
+static TestResult test_reset_during_compaction(void)
+{
+    ConfigStore_Info_t info;
+
+    /* Reset after every possible step of one compaction */
+    for (uint32_t cut = 0; cut < 40; cut++)
+    {
+        uint32_t steps = 0;
+
+        fresh_part();
+        write_key(KEY_PASSWORD, 4242);
+        for (uint32_t i = 0; ; i++)
+        {
+            write_key(KEY_TIMEOUT, i);
+            ConfigStore_GetInfo(&info);
+            if (info.free_blocks < CONFIG_STORE_SPARE_BLOCKS)
+            {
+                break;
+            }
+        }
+        uint32_t timeout = read_key(KEY_TIMEOUT);
+
+        while (steps < cut && ConfigStore_Process())
+        {
+            steps++;
+        }
+        ConfigStore_Init();
+        TEST_ASSERT_EQUAL(4242, read_key(KEY_PASSWORD));
+        TEST_ASSERT_EQUAL(timeout, read_key(KEY_TIMEOUT));
+
+        /* The interrupted compaction finishes after the reboot */
+        run_background();
+        ConfigStore_GetInfo(&info);
+        TEST_ASSERT(info.free_blocks >= CONFIG_STORE_SPARE_BLOCKS);
+        ConfigStore_Init();
+        TEST_ASSERT_EQUAL(4242, read_key(KEY_PASSWORD));
+        TEST_ASSERT_EQUAL(timeout, read_key(KEY_TIMEOUT));
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_foreground_compacts_when_needed(void)
+{
+    ConfigStore_Info_t info;
+
+    /* Never call ConfigStore_Process: writes must still succeed */
+    fresh_part();
+    write_key(KEY_PASSWORD, 777);
+    for (uint32_t i = 0; i < 5000; i++)
+    {
+        TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, i));
+    }
+    ConfigStore_GetInfo(&info);
+    TEST_ASSERT(info.free_blocks >= 1);
+    TEST_ASSERT(info.compactions > 0);
+
+    ConfigStore_Init();
+    TEST_ASSERT_EQUAL(777, read_key(KEY_PASSWORD));
+    TEST_ASSERT_EQUAL(4999, read_key(KEY_TIMEOUT));
+
+    TEST_PASS();
+}
+
+static TestResult test_failed_program_not_indexed(void)
+{
+    fresh_part();
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 12));
+
+    FakeEEPROM_FailNextProgram(EEPROM_RC_WRBUSY);
+    TEST_ASSERT_EQUAL(CONFIG_STORE_ERROR, write_key(KEY_TIMEOUT, 13));
+    TEST_ASSERT_EQUAL(12, read_key(KEY_TIMEOUT));
+
+    /* The failure retired the head block, so this corrupts the header of
+     * the next one */
+    FakeEEPROM_CorruptNextProgram(0x00010000);
+    TEST_ASSERT_EQUAL(CONFIG_STORE_ERROR, write_key(KEY_TIMEOUT, 14));
+    TEST_ASSERT_EQUAL(12, read_key(KEY_TIMEOUT));
+
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 14));
+    FakeEEPROM_CorruptNextProgram(0x00010000);
+    TEST_ASSERT_EQUAL(CONFIG_STORE_ERROR, write_key(KEY_TIMEOUT, 16));
+    TEST_ASSERT_EQUAL(14, read_key(KEY_TIMEOUT));
+
+    TEST_ASSERT_EQUAL(CONFIG_STORE_OK, write_key(KEY_TIMEOUT, 15));
+    ConfigStore_Init();
+    TEST_ASSERT_EQUAL(15, read_key(KEY_TIMEOUT));
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Simulator
+ *
+ * Reconfiguration traffic: the timeout changes most, the potentiometer
+ * setting often, the PIN now and then. The old fixed layout (one word per
+ * key, rewritten in place) is replayed on the same fake for comparison.
+ *===========================================================================*/
+#define SIM_UPDATES     2000000UL
+
+static uint8_t sim_key(void)
+{
+    uint32_t r = lcg() % 100;
+    return r < 60 ? KEY_TIMEOUT : (r < 90 ? KEY_POTENTIOMETER : KEY_PASSWORD);
+}
+
+static uint32_t max_word_writes(uint32_t first_block, uint32_t blocks)
+{
+    uint32_t max = 0;
+    for (uint32_t w = first_block * FAKE_EEPROM_BLOCK_WORDS;
+         w < (first_block + blocks) * FAKE_EEPROM_BLOCK_WORDS; w++)
+    {
+        uint32_t n = FakeEEPROM_WordWrites(w * 4);
+        max = n > max ? n : max;
+    }
+    return max;
+}
+
+static void bench_wear(void)
+{
+    uint64_t write_cycles = 0, write_max = 0;
+    ConfigStore_Info_t info;
+    clock_t t0;
+
+    /* Old layout: every update rewrites its key's word */
+    FakeEEPROM_Reset();
+    lcg_state = 7;
+    for (uint32_t i = 0; i < SIM_UPDATES; i++)
+    {
+        uint32_t v = i;
+        EEPROMProgram(&v, sim_key() * 4, 4);
+    }
+    uint32_t legacy_hot = max_word_writes(0, 1);
+    uint32_t legacy_block = FakeEEPROM_BlockWrites(0);
+
+    /* Log store, background compaction run between updates */
+    fresh_part();
+    lcg_state = 7;
+    t0 = clock();
+    for (uint32_t i = 0; i < SIM_UPDATES; i++)
+    {
+        uint64_t c0 = FakeCPU_Cycles();
+
+        if (write_key(sim_key(), i) != CONFIG_STORE_OK)
+        {
+            printf("    write %u failed\n", (unsigned)i);
+            return;
+        }
+        uint64_t c = FakeCPU_Cycles() - c0;
+        write_cycles += c;
+        write_max = c > write_max ? c : write_max;
+        run_background();
+    }
+    double host_s = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    ConfigStore_GetInfo(&info);
+
+    uint32_t emin = 0xFFFFFFFF, emax = 0;
+    uint64_t esum = 0;
+    for (uint32_t b = CONFIG_STORE_FIRST_BLOCK; b < CONFIG_STORE_FIRST_BLOCK + CONFIG_STORE_BLOCKS; b++)
+    {
+        uint32_t e = FakeEEPROM_BlockErases(b);
+        emin = e < emin ? e : emin;
+        emax = e > emax ? e : emax;
+        esum += e;
+    }
+    uint32_t log_hot = max_word_writes(CONFIG_STORE_FIRST_BLOCK, CONFIG_STORE_BLOCKS);
+
+    printf("    %lu updates (60%% timeout, 30%% potentiometer, 10%% PIN), %.1f s host time\n",
+           SIM_UPDATES, host_s);
+    printf("    block erases: min %u  max %u  mean %.1f over %u blocks (%u compactions, %u records copied)\n",
+           (unsigned)emin, (unsigned)emax, (double)esum / CONFIG_STORE_BLOCKS,
+           (unsigned)CONFIG_STORE_BLOCKS, (unsigned)info.compactions, (unsigned)info.copied_records);
+    printf("    per-block erase counts:");
+    for (uint32_t b = CONFIG_STORE_FIRST_BLOCK; b < CONFIG_STORE_FIRST_BLOCK + CONFIG_STORE_BLOCKS; b++)
+    {
+        printf("%s%u", (b - CONFIG_STORE_FIRST_BLOCK) % 8 == 0 ? "\n      " : " ",
+               (unsigned)FakeEEPROM_BlockErases(b));
+    }
+    printf("\n");
+    printf("    hottest word: old layout %u writes (block 0: %u), log %u writes (%.1fx less)\n",
+           (unsigned)legacy_hot, (unsigned)legacy_block, (unsigned)log_hot,
+           (double)legacy_hot / log_hot);
+    printf("    updates until a word reaches 500k writes: old layout %.2fM, log %.1fM\n",
+           500000.0 * SIM_UPDATES / legacy_hot / 1e6, 500000.0 * SIM_UPDATES / log_hot / 1e6);
+    printf("    write latency: mean %.0f us, max %.0f us (foreground never compacted)\n",
+           write_cycles * 1e6 / SIM_UPDATES / FAKE_SYSTEM_CLOCK, write_max * 1e6 / FAKE_SYSTEM_CLOCK);
+
+    /* Same traffic without the background task */
+    fresh_part();
+    lcg_state = 7;
+    write_cycles = 0;
+    write_max = 0;
+    for (uint32_t i = 0; i < SIM_UPDATES / 20; i++)
+    {
+        uint64_t c0 = FakeCPU_Cycles();
+        write_key(sim_key(), i);
+        uint64_t c = FakeCPU_Cycles() - c0;
+        write_cycles += c;
+        write_max = c > write_max ? c : write_max;
+    }
+    printf("    without ConfigStore_Process: mean %.0f us, max %.0f us (compaction inline)\n",
+           write_cycles * 20e6 / SIM_UPDATES / FAKE_SYSTEM_CLOCK, write_max * 1e6 / FAKE_SYSTEM_CLOCK);
+
+    /* Boot: rebuild the index from the log the simulation left behind */
+    FakeEEPROM_Stats_t st;
+    FakeEEPROM_ClearStats();
+    uint64_t c0 = FakeCPU_Cycles();
+    ConfigStore_Init();
+    uint64_t boot = FakeCPU_Cycles() - c0;
+    FakeEEPROM_GetStats(&st);
+    ConfigStore_GetInfo(&info);
+
+    t0 = clock();
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        ConfigStore_Init();
+    }
+    double host_us = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e6 / 10000;
+
+    printf("    boot index build: %u blocks in use, %u EEPROM reads (%u words), %.0f us of\n"
+           "      EEPROM/driverlib time at 16 MHz (host: %.2f us per scan incl. CRC checks)\n",
+           (unsigned)info.used_blocks, (unsigned)st.read_calls, (unsigned)st.read_words,
+           boot * 1e6 / FAKE_SYSTEM_CLOCK, host_us);
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Config Store Tests ---\n");
+    run_test("Empty Part", test_empty_part);
+    run_test("Newest Record Wins", test_newest_record_wins);
+    run_test("Torn Record Skipped", test_torn_record_skipped);
+    run_test("Reset During Compaction", test_reset_during_compaction);
+    run_test("Foreground Compacts When Needed", test_foreground_compacts_when_needed);
+    run_test("Failed Program Not Indexed", test_failed_program_not_indexed);
+
+    printf("\n--- Wear Simulation (%u blocks of %u words, 110 us/word program) ---\n",
+           (unsigned)CONFIG_STORE_BLOCKS, (unsigned)CONFIG_STORE_BLOCK_WORDS);
+    bench_wear();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,416 @@
+/*
+ * bench_credentials.c - Host test/benchmark for the multi-user credential
+ * table
+ *
+ * Built with the table scaled to 1,000 users on a larger fake EEPROM (the
+ * TM4C123's 2 KB holds 64). Checks add/replace/remove against a reference
+ * model, a full table, and power loss at every word of an add or a
+ * replacement. The benchmark fills 1,000 users and reports the RAM index
+ * size, boot index build, and lookup cost of Credentials_Authenticate
+ * against a scan of the EEPROM table.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -DCREDENTIALS_BLOCKS=250 -DFAKE_EEPROM_WORDS=4352 \
+ *       -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_credentials.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/application/credentials.c \
+ *       backend/application/crc16.c -o bench_credentials
+ *   ./bench_credentials
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "driverlib/eeprom.h"
+#include "../../backend/application/credentials.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include <string.h>
+#include <time.h>
+
+#define TABLE_BASE      (CREDENTIALS_FIRST_BLOCK * CREDENTIALS_BLOCK_WORDS * 4)
+
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t period_ms,
+                             SoftTimer_Callback_t callback, void *arg)
+{
+    (void)timer;
+    (void)period_ms;
+    (void)callback;
+    (void)arg;
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static uint32_t lcg_state = 1;
+
+static uint32_t lcg(void)
+{
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return (lcg_state >> 16) & 0x7FFF;
+}
+
+static void fresh_part(void)
+{
+    FakeEEPROM_Reset();
+    EEPROMInit();
+    Credentials_Init();
+}
+
+static void reboot(void)
+{
+    EEPROMInit();
+    Credentials_Init();
+}
+
+/* Stand-in for PinHash_Hash: as well spread, without the cost, which
+ * this benchmark leaves out (see bench_pin_hash.c) */
+static uint32_t hash_of(uint32_t pin)
+{
+    uint32_t h = pin ^ 0x9E3779B9UL;
+
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return h;
+}
+
+static int add(uint16_t id, uint32_t pin)
+{
+    Credentials_User_t user = {id, 0, 0, 0};
+    return Credentials_Add(&user, hash_of(pin));
+}
+
+static uint16_t who(uint32_t pin)
+{
+    uint16_t id = CREDENTIALS_NO_USER;
+    if (Credentials_Authenticate(hash_of(pin), &id, NULL) != CREDENTIALS_OK)
+    {
+        return CREDENTIALS_NO_USER;
+    }
+    return id;
+}
+
+/* Distinct 5-digit PIN for the n-th user */
+static uint32_t pin_of(uint32_t n)
+{
+    return 10000 + (n * 7919u) % 90000;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_add_and_authenticate(void)
+{
+    Credentials_Info_t info;
+
+    fresh_part();
+    TEST_ASSERT_EQUAL(CREDENTIALS_NOT_FOUND, Credentials_Authenticate(hash_of(12345), &(uint16_t){0}, NULL));
+    for (uint16_t i = 0; i < 50; i++)
+    {
+        TEST_ASSERT_EQUAL(CREDENTIALS_OK, add((uint16_t)(1000 + i), pin_of(i)));
+    }
+    for (uint16_t i = 0; i < 50; i++)
+    {
+        TEST_ASSERT_EQUAL(1000 + i, who(pin_of(i)));
+    }
+    TEST_ASSERT_EQUAL(CREDENTIALS_NO_USER, who(pin_of(50)));
+
+    reboot();
+    Credentials_GetInfo(&info);
+    TEST_ASSERT_EQUAL(50, info.users);
+    TEST_ASSERT_EQUAL(0, info.bad_slots);
+    TEST_ASSERT_EQUAL(1017, who(pin_of(17)));
+
+    TEST_PASS();
+}
+
+static TestResult test_replace_keeps_one_entry(void)
+{
+    Credentials_Info_t info;
+
+    fresh_part();
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(5, 11111));
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(6, 22222));
+    TEST_ASSERT_EQUAL(CREDENTIALS_PIN_IN_USE, add(6, 11111));
+
+    /* Same id, new PIN; re-adding the same PIN is allowed */
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(5, 33333));
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(5, 33333));
+    TEST_ASSERT_EQUAL(CREDENTIALS_NO_USER, who(11111));
+    TEST_ASSERT_EQUAL(5, who(33333));
+
+    reboot();
+    Credentials_GetInfo(&info);
+    TEST_ASSERT_EQUAL(2, info.users);
+    TEST_ASSERT_EQUAL(5, who(33333));
+
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, Credentials_Remove(5));
+    TEST_ASSERT_EQUAL(CREDENTIALS_NOT_FOUND, Credentials_Remove(5));
+    TEST_ASSERT_EQUAL(CREDENTIALS_NO_USER, who(33333));
+    TEST_ASSERT_EQUAL(6, who(22222));
+
+    TEST_PASS();
+}
+
+static TestResult test_table_full(void)
+{
+    fresh_part();
+    for (uint16_t i = 0; i < CREDENTIALS_MAX_USERS; i++)
+    {
+        TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(i, pin_of(i)));
+    }
+    TEST_ASSERT_EQUAL(CREDENTIALS_FULL, add(CREDENTIALS_MAX_USERS, 99999));
+
+    /* Replacing an existing user needs a spare slot too */
+    TEST_ASSERT_EQUAL(CREDENTIALS_FULL, add(3, 99999));
+    TEST_ASSERT_EQUAL(3, who(pin_of(3)));
+
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, Credentials_Remove(10));
+    TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(CREDENTIALS_MAX_USERS, 99999));
+    TEST_ASSERT_EQUAL(CREDENTIALS_MAX_USERS, who(99999));
+
+    TEST_PASS();
+}
+
+/* Cut the power at every word of an add, a replacement and a removal */
+static TestResult test_power_loss(void)
+{
+    uint32_t cuts = 0;
+
+    for (uint32_t op = 0; op < 3; op++)
+    {
+        for (uint32_t cut = 0; ; cut++)
+        {
+            fresh_part();
+            TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(1, 11111));
+            TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(2, 22222));
+
+            FakeEEPROM_PowerFailAfter(cut);
+            if (op == 0)
+            {
+                add(3, 33333);
+            }
+            else if (op == 1)
+            {
+                add(2, 44444);
+            }
+            else
+            {
+                Credentials_Remove(2);
+            }
+            bool lost = FakeEEPROM_PowerLost();
+            FakeEEPROM_PowerRestore();
+            reboot();
+
+            /* Untouched users survive; the changed one is old or new */
+            TEST_ASSERT_EQUAL(1, who(11111));
+            if (op == 0)
+            {
+                uint16_t u = who(33333);
+                TEST_ASSERT(u == 3 || u == CREDENTIALS_NO_USER);
+                TEST_ASSERT_EQUAL(2, who(22222));
+            }
+            else if (op == 1)
+            {
+                bool before = who(22222) == 2;
+                bool after = who(44444) == 2;
+                TEST_ASSERT(before != after);
+            }
+            else
+            {
+                uint16_t u = who(22222);
+                TEST_ASSERT(u == 2 || u == CREDENTIALS_NO_USER);
+            }
+
+            /* And the table still takes writes */
+            TEST_ASSERT_EQUAL(CREDENTIALS_OK, add(9, 99999));
+            TEST_ASSERT_EQUAL(9, who(99999));
+            if (!lost)
+            {
+                break;
+            }
+            cuts++;
+        }
+    }
+    TEST_ASSERT(cuts >= 8);
+
+    TEST_PASS();
+}
+
+/* Random adds, replacements and removals against a plain array */
+static TestResult test_index_matches_model(void)
+{
+    static uint32_t model[CREDENTIALS_MAX_USERS];    /* PIN by user id, 0 = none */
+    uint32_t users = 0;
+
+    fresh_part();
+    memset(model, 0, sizeof(model));
+    lcg_state = 11;
+    for (uint32_t op = 0; op < 5000; op++)
+    {
+        uint16_t id = (uint16_t)(lcg() % CREDENTIALS_MAX_USERS);
+        if (lcg() % 3 == 0)
+        {
+            TEST_ASSERT_EQUAL(model[id] ? CREDENTIALS_OK : CREDENTIALS_NOT_FOUND,
+                              Credentials_Remove(id));
+            users -= model[id] ? 1 : 0;
+            model[id] = 0;
+        }
+        else
+        {
+            uint32_t pin = 10000 + (lcg() * 32768u + lcg()) % 90000;
+            bool taken = false;
+            for (uint16_t j = 0; j < CREDENTIALS_MAX_USERS; j++)
+            {
+                taken |= (j != id && model[j] == pin);
+            }
+            int result = add(id, pin);
+            if (taken)
+            {
+                TEST_ASSERT_EQUAL(CREDENTIALS_PIN_IN_USE, result);
+                continue;
+            }
+            TEST_ASSERT_EQUAL(CREDENTIALS_OK, result);
+            users += model[id] ? 0 : 1;
+            model[id] = pin;
+        }
+    }
+
+    for (uint32_t pass = 0; pass < 2; pass++)
+    {
+        Credentials_Info_t info;
+        Credentials_GetInfo(&info);
+        TEST_ASSERT_EQUAL(users, info.users);
+        for (uint16_t id = 0; id < CREDENTIALS_MAX_USERS; id++)
+        {
+            if (model[id])
+            {
+                TEST_ASSERT_EQUAL(id, who(model[id]));
+            }
+        }
+        reboot();
+    }
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+#define LOOKUPS     200000
+
+/* What authenticate would cost without the index: read the table a block
+ * at a time and compare every slot's hash */
+static uint16_t scan_authenticate(uint32_t pin)
+{
+    uint32_t block[CREDENTIALS_BLOCK_WORDS];
+    uint32_t hash = hash_of(pin);
+
+    for (uint32_t b = 0; b < CREDENTIALS_BLOCKS; b++)
+    {
+        EEPROMRead(block, TABLE_BASE + b * CREDENTIALS_BLOCK_WORDS * 4, sizeof(block));
+        for (uint32_t i = 0; i < CREDENTIALS_BLOCK_WORDS; i += CREDENTIALS_SLOT_WORDS)
+        {
+            if (block[i] != 0xFFFFFFFF && block[i + 1] == hash)
+            {
+                return (uint16_t)(block[i] >> 16);
+            }
+        }
+    }
+    return CREDENTIALS_NO_USER;
+}
+
+static void bench_lookup(void)
+{
+    FakeEEPROM_Stats_t st;
+    Credentials_Info_t info;
+    volatile uint32_t sink = 0;
+    clock_t t0;
+
+    fresh_part();
+    for (uint16_t i = 0; i < CREDENTIALS_MAX_USERS; i++)
+    {
+        add((uint16_t)(i * 37 % 60000), pin_of(i));
+    }
+
+    FakeEEPROM_ClearStats();
+    t0 = clock();
+    reboot();
+    double boot_host = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    FakeEEPROM_GetStats(&st);
+    Credentials_GetInfo(&info);
+
+    printf("    %u users, index %u bytes (%u per user; %u bytes for the %u users of the target)\n",
+           (unsigned)info.users, (unsigned)info.index_bytes,
+           (unsigned)(info.index_bytes / info.capacity),
+           (unsigned)(info.index_bytes / info.capacity * 64), 64u);
+    printf("    boot index build: %u EEPROM reads, %.0f us of EEPROM time, %.2f ms host\n",
+           (unsigned)st.read_calls, st.cycles * 1e6 / FAKE_SYSTEM_CLOCK, boot_host * 1e3);
+
+    /* Enrolled PINs: bisection, then one 4-word read of the slot */
+    lcg_state = 3;
+    FakeEEPROM_ClearStats();
+    t0 = clock();
+    for (uint32_t n = 0; n < LOOKUPS; n++)
+    {
+        sink += who(pin_of(lcg() % CREDENTIALS_MAX_USERS));
+    }
+    double hit_ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / LOOKUPS;
+    FakeEEPROM_GetStats(&st);
+    double hit_cycles = (double)st.cycles / LOOKUPS;
+
+    /* Unknown PINs never touch the EEPROM */
+    FakeEEPROM_ClearStats();
+    t0 = clock();
+    for (uint32_t n = 0; n < LOOKUPS; n++)
+    {
+        sink += who(100000 + n);
+    }
+    double miss_ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / LOOKUPS;
+    FakeEEPROM_GetStats(&st);
+    double miss_cycles = (double)st.cycles / LOOKUPS;
+
+    /* Table scan for comparison */
+    lcg_state = 3;
+    FakeEEPROM_ClearStats();
+    t0 = clock();
+    for (uint32_t n = 0; n < LOOKUPS / 100; n++)
+    {
+        sink += scan_authenticate(pin_of(lcg() % CREDENTIALS_MAX_USERS));
+    }
+    double scan_ns = (double)(clock() - t0) / CLOCKS_PER_SEC * 1e9 / (LOOKUPS / 100);
+    FakeEEPROM_GetStats(&st);
+    double scan_cycles = (double)st.cycles / (LOOKUPS / 100);
+
+    uint32_t probes = 0;
+    while ((1u << probes) <= info.users)
+    {
+        probes++;
+    }
+    printf("    indexed hit:  %3u probes max, %6.1f EEPROM cycles (%5.1f us), %6.0f ns host\n",
+           (unsigned)probes, hit_cycles, hit_cycles * 1e6 / FAKE_SYSTEM_CLOCK, hit_ns);
+    printf("    indexed miss: %3u probes max, %6.1f EEPROM cycles (%5.1f us), %6.0f ns host\n",
+           (unsigned)probes, miss_cycles, miss_cycles * 1e6 / FAKE_SYSTEM_CLOCK, miss_ns);
+    printf("    table scan:   %8.1f EEPROM cycles (%7.1f us), %6.0f ns host (%.0fx the indexed hit)\n",
+           scan_cycles, scan_cycles * 1e6 / FAKE_SYSTEM_CLOCK, scan_ns, scan_cycles / hit_cycles);
+    (void)sink;
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Credential Table Tests (%u users) ---\n", CREDENTIALS_MAX_USERS);
+    run_test("Add And Authenticate", test_add_and_authenticate);
+    run_test("Replace Keeps One Entry", test_replace_keeps_one_entry);
+    run_test("Table Full", test_table_full);
+    run_test("Power Loss", test_power_loss);
+    run_test("Index Matches Model", test_index_matches_model);
+
+    printf("\n--- Lookup Cost (%u lookups) ---\n", LOOKUPS);
+    bench_lookup();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,486 @@
+/*
+ * bench_eeprom_commit.c - Host power-loss simulator and latency benchmark
+ * for the write-behind configuration commits
+ *
+ * Replays a scripted stream of configuration commands through the real
+ * command handlers, EEPROM handler and config store, cutting the power
+ * after every possible programmed word. After each cut the part reboots
+ * and must hold, for every key, either the last value whose response said
+ * "durable" or a value sent after it - never a torn or unknown value. The
+ * same sweep in "accepted" mode counts how often an acknowledged change is
+ * lost. The benchmark then measures response latency on the backend
+ * (arrival to response, virtual clock, wire time excluded) for the old
+ * synchronous commit, durable and accepted modes.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -DPIN_HASH_BUDGET_US=0 -DPIN_HASH_MIN_ITERATIONS=1 \
+ *       -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_eeprom_commit.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/application/eeprom_handler.c \
+ *       backend/application/config_store.c backend/application/crc16.c \
+ *       backend/application/credentials.c backend/application/pin_hash.c \
+ *       backend/application/sha256.c \
+ *       backend/application/uart_commands.c -o bench_eeprom_commit
+ *   ./bench_eeprom_commit
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "driverlib/eeprom.h"
+#include "../../backend/application/eeprom_handler.h"
+#include "../../backend/application/config_store.h"
+#include "../../backend/application/pin_hash.h"
+#include "../../backend/application/uart_protocol.h"
+#include "../../backend/application/uart_commands.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include <string.h>
+
+#define MAX_CMDS        2048
+
+/*===========================================================================
+ * Stand-ins for the services the command handlers call
+ *
+ * Requests are tagged with their index in the script + 1; every response
+ * is logged against that tag with the virtual time it was sent.
+ *===========================================================================*/
+static UART_ReqTag_t current_req;
+static uint8_t rsp_status[MAX_CMDS + 1];
+static bool rsp_sent[MAX_CMDS + 1];
+static uint64_t rsp_cycles[MAX_CMDS + 1];
+
+void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len)
+{
+    (void)cmd;
+    (void)data;
+    (void)data_len;
+    rsp_sent[current_req] = true;
+    rsp_status[current_req] = status;
+    rsp_cycles[current_req] = FakeCPU_Cycles();
+}
+
+UART_ReqTag_t UART_Protocol_CurrentRequest(void)
+{
+    return current_req;
+}
+
+void UART_Protocol_SendResponseTo(UART_ReqTag_t req, uint8_t cmd, uint8_t status,
+                                  uint8_t *data, uint8_t data_len)
+{
+    UART_ReqTag_t handling = current_req;
+
+    current_req = req;
+    UART_Protocol_SendResponse(cmd, status, data, data_len);
+    current_req = handling;
+}
+
+void DoorController_OpenDoor(uint32_t seconds) { (void)seconds; }
+void BuzzerService_Activate(uint32_t seconds) { (void)seconds; }
+
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t period_ms,
+                             SoftTimer_Callback_t callback, void *arg)
+{
+    (void)timer;
+    (void)period_ms;
+    (void)callback;
+    (void)arg;
+}
+
+/*===========================================================================
+ * Command script
+ *===========================================================================*/
+typedef struct
+{
+    uint8_t buf[7];
+    uint8_t len;
+    uint8_t key;            /* CONFIG_KEY_*, or 0xFF for CMD_AUTH */
+    uint32_t value;
+    uint64_t arrival;       /* Virtual time the packet is complete */
+} script_cmd_t;
+
+static script_cmd_t script[MAX_CMDS];
+static uint32_t script_len;
+
+#define INITIAL_PASSWORD    12345
+#define INITIAL_TIMEOUT     20
+#define NO_KEY              0xFF
+
+static uint8_t frame_pin(uint8_t *buf, uint8_t at, uint32_t pw)
+{
+    for (int8_t i = 4; i >= 0; i--)
+    {
+        buf[at + i] = (uint8_t)('0' + pw % 10);
+        pw /= 10;
+    }
+    return (uint8_t)(at + 5);
+}
+
+static void add_set_timeout(uint8_t seconds, uint64_t arrival)
+{
+    script_cmd_t *c = &script[script_len++];
+    c->buf[0] = CMD_SET_TIMEOUT;
+    c->buf[1] = seconds;
+    c->len = 2;
+    c->key = CONFIG_KEY_TIMEOUT;
+    c->value = seconds;
+    c->arrival = arrival;
+}
+
+static void add_change_password(uint32_t pw, uint64_t arrival)
+{
+    script_cmd_t *c = &script[script_len++];
+    c->buf[0] = CMD_CHANGE_PASSWORD;
+    c->len = frame_pin(c->buf, 1, pw);
+    c->key = CONFIG_KEY_PASSWORD_HASH;
+    c->value = pw;          /* The store holds PinHash_Hash(pw) */
+    c->arrival = arrival;
+}
+
+static void add_auth(uint32_t pw, uint64_t arrival)
+{
+    script_cmd_t *c = &script[script_len++];
+    c->buf[0] = CMD_AUTH;
+    c->buf[1] = 0x00;
+    c->len = frame_pin(c->buf, 2, pw);
+    c->key = NO_KEY;
+    c->value = pw;
+    c->arrival = arrival;
+}
+
+/*
+ * Menu traffic every `period` cycles: a pipelined burst of timeout,
+ * password and timeout writes, then a PIN check 0.2 ms later. Values never
+ * repeat back to back, so every write is a real change.
+ */
+static void build_script(uint32_t periods, uint64_t period)
+{
+    uint32_t pw = INITIAL_PASSWORD;
+
+    script_len = 0;
+    for (uint32_t p = 0; p < periods; p++)
+    {
+        uint64_t t = (p + 1) * period;
+        pw = 10000 + (pw * 7 + 13) % 90000;
+        add_set_timeout((uint8_t)(5 + (p * 2) % 26), t);
+        add_change_password(pw, t);
+        add_set_timeout((uint8_t)(5 + (p * 2 + 1) % 26), t);
+        add_auth(pw, t + FAKE_SYSTEM_CLOCK / 5000);
+    }
+}
+
+static void run_command(const script_cmd_t *c)
+{
+    uint8_t buf[7];
+
+    memcpy(buf, c->buf, sizeof(buf));
+    switch (buf[0])
+    {
+    case CMD_AUTH:            CMD_Auth(buf, c->len); break;
+    case CMD_SET_TIMEOUT:     CMD_SetTimeout(buf, c->len); break;
+    case CMD_CHANGE_PASSWORD: CMD_ChangePassword(buf, c->len); break;
+    default: break;
+    }
+}
+
+/*===========================================================================
+ * Main loop model
+ *===========================================================================*/
+#define MODE_SYNC       2   /* Commit inline before answering, as before */
+
+/* Boot sequence from main.c on the current contents */
+static void boot(void)
+{
+    EEPROMInit();
+    eeprom_handler_init();
+    set_default_auto_timeout();
+}
+
+/* Part left by the old firmware with the initial configuration */
+static void fresh_part(void)
+{
+    FakeEEPROM_Reset();
+    FakeEEPROM_Poke(PASSWORD_OFFSET, INITIAL_PASSWORD);
+    FakeEEPROM_Poke(TIMEOUT_OFFSET, INITIAL_TIMEOUT);
+}
+
+/*
+ * Run the script the way main() would: each pass handles every packet
+ * that has arrived, then one commit and one compaction step; an idle loop
+ * jumps the clock to the next arrival. Stops early if the power fails.
+ * Returns the number of commands handled.
+ */
+static uint32_t run_script(uint8_t mode)
+{
+    uint32_t next = 0;
+    uint64_t t0 = FakeCPU_Cycles();
+
+    memset(rsp_sent, 0, sizeof(rsp_sent));
+    CMD_SetCommitMode(mode == MODE_SYNC ? CMD_COMMIT_DURABLE : mode);
+    while (!FakeEEPROM_PowerLost())
+    {
+        bool busy = false;
+
+        while (next < script_len && t0 + script[next].arrival <= FakeCPU_Cycles())
+        {
+            current_req = (UART_ReqTag_t)(next + 1);
+            run_command(&script[next++]);
+            if (mode == MODE_SYNC)
+            {
+                eeprom_handler_flush();
+            }
+            busy = true;
+            if (FakeEEPROM_PowerLost())
+            {
+                break;
+            }
+        }
+        if (FakeEEPROM_PowerLost())
+        {
+            break;
+        }
+        busy |= eeprom_handler_process();
+        busy |= ConfigStore_Process();
+        if (!busy)
+        {
+            if (next == script_len)
+            {
+                break;
+            }
+            FakeCPU_Advance(t0 + script[next].arrival - FakeCPU_Cycles());
+        }
+    }
+    CMD_SetCommitMode(CMD_COMMIT_MODE_DEFAULT);
+    return next;
+}
+
+/*===========================================================================
+ * Power-loss sweep
+ *===========================================================================*/
+typedef struct
+{
+    uint32_t cuts;
+    uint32_t bad_values;        /* Neither a value sent nor the initial one */
+    uint32_t lost_acks;         /* An acknowledged change rolled back */
+    uint32_t torn_records;      /* Skipped by the store at the next boot */
+    uint32_t unusable;          /* Store could not take a write afterwards */
+} sweep_result_t;
+
+/* Current value of a key after a reboot, as the store holds it */
+static uint32_t stored_value(uint8_t key)
+{
+    uint32_t value = 0xFFFFFFFF;
+    ConfigStore_Read(key, &value, 1);
+    return value;
+}
+
+/* PIN whose hash the store holds after a reboot: the initial one or one
+ * the script sent, 0xFFFFFFFF if it is neither */
+static uint32_t stored_pin(uint32_t handled)
+{
+    uint32_t hash = stored_value(CONFIG_KEY_PASSWORD_HASH);
+
+    if (hash == PinHash_Hash(INITIAL_PASSWORD))
+    {
+        return INITIAL_PASSWORD;
+    }
+    for (uint32_t i = handled; i-- > 0;)
+    {
+        if (script[i].key == CONFIG_KEY_PASSWORD_HASH && PinHash_Hash(script[i].value) == hash)
+        {
+            return script[i].value;
+        }
+    }
+    return 0xFFFFFFFF;
+}
+
+/*
+ * Check one key against what was sent before the cut. Returns 0 if the
+ * value is the last acknowledged one or a later one, 1 if it is an older
+ * value the script sent (acknowledged change lost), 2 if it was never sent.
+ */
+static int check_key(uint8_t key, uint32_t initial, uint32_t handled, uint32_t value)
+{
+    int32_t acked = -1;
+    int result = (value == initial) ? 1 : 2;
+
+    for (uint32_t i = 0; i < handled; i++)
+    {
+        if (script[i].key == key && rsp_sent[i + 1] && rsp_status[i + 1] == UART_STATUS_OK)
+        {
+            acked = (int32_t)i;
+        }
+    }
+    if (acked < 0 && value == initial)
+    {
+        return 0;
+    }
+    for (uint32_t i = 0; i < handled; i++)
+    {
+        if (script[i].key == key && script[i].value == value)
+        {
+            if ((int32_t)i >= acked)
+            {
+                return 0;
+            }
+            result = 1;
+        }
+    }
+    return result;
+}
+
+static void sweep(uint8_t mode, sweep_result_t *r)
+{
+    FakeEEPROM_Stats_t st;
+    ConfigStore_Info_t info;
+
+    /* Clean run: how many words there are to cut after */
+    fresh_part();
+    boot();
+    run_script(mode);
+    FakeEEPROM_GetStats(&st);
+
+    memset(r, 0, sizeof(*r));
+    for (uint32_t cut = 0; cut < st.program_words; cut++)
+    {
+        fresh_part();
+        FakeEEPROM_PowerFailAfter(cut);
+        boot();
+        uint32_t handled = FakeEEPROM_PowerLost() ? 0 : run_script(mode);
+
+        FakeEEPROM_PowerRestore();
+        boot();
+        ConfigStore_GetInfo(&info);
+        r->cuts++;
+        r->torn_records += info.torn_records;
+
+        uint32_t pin = stored_pin(handled);
+        int pw = check_key(CONFIG_KEY_PASSWORD_HASH, INITIAL_PASSWORD, handled, pin);
+        int to = check_key(CONFIG_KEY_TIMEOUT, INITIAL_TIMEOUT, handled,
+                           stored_value(CONFIG_KEY_TIMEOUT));
+        r->bad_values += (pw == 2) + (to == 2);
+        r->lost_acks += (pw == 1) + (to == 1);
+
+        /* The RAM copy agrees with the part, and the part still takes writes */
+        uint32_t timeout;
+        get_auto_timeout(&timeout);
+        if (timeout != stored_value(CONFIG_KEY_TIMEOUT) ||
+            authenticate(pin, NULL) != STATUS_OK ||
+            change_auto_timeout(timeout == 6 ? 7 : 6) != STATUS_OK ||
+            eeprom_handler_flush() != STATUS_OK)
+        {
+            r->unusable++;
+        }
+    }
+}
+
+/* One pass per 2 ms is enough for the store to keep up between bursts */
+#define SWEEP_PERIODS   100
+#define SWEEP_PERIOD    (FAKE_SYSTEM_CLOCK / 500)
+
+static sweep_result_t durable_sweep;
+static sweep_result_t accepted_sweep;
+
+static TestResult test_power_loss_durable(void)
+{
+    sweep_result_t r;
+
+    build_script(SWEEP_PERIODS, SWEEP_PERIOD);
+    sweep(CMD_COMMIT_DURABLE, &r);
+    durable_sweep = r;
+    TEST_ASSERT(r.cuts > 0);
+    TEST_ASSERT(r.torn_records > 0);
+    TEST_ASSERT_EQUAL(0, r.bad_values);
+    TEST_ASSERT_EQUAL(0, r.lost_acks);
+    TEST_ASSERT_EQUAL(0, r.unusable);
+
+    TEST_PASS();
+}
+
+static TestResult test_power_loss_accepted(void)
+{
+    sweep_result_t r;
+
+    /* Acknowledged changes may be lost, but never half-written */
+    build_script(SWEEP_PERIODS, SWEEP_PERIOD);
+    sweep(CMD_COMMIT_ACCEPTED, &r);
+    accepted_sweep = r;
+    TEST_ASSERT(r.cuts > 0);
+    TEST_ASSERT_EQUAL(0, r.bad_values);
+    TEST_ASSERT_EQUAL(0, r.unusable);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Latency benchmark
+ *===========================================================================*/
+#define BENCH_PERIODS   500
+#define BENCH_PERIOD    (FAKE_SYSTEM_CLOCK / 50)
+
+static void print_sweep(const char *name, const sweep_result_t *r)
+{
+    printf("    %-9s %u cuts: %u torn records skipped at boot, %u acknowledged values lost,\n"
+           "              %u unknown values, %u stores left unwritable\n",
+           name, (unsigned)r->cuts, (unsigned)r->torn_records, (unsigned)r->lost_acks,
+           (unsigned)r->bad_values, (unsigned)r->unusable);
+}
+
+static void bench_latency(const char *name, uint8_t mode)
+{
+    FakeEEPROM_Stats_t st;
+    uint64_t write_sum = 0, write_max = 0, auth_sum = 0, auth_max = 0;
+    uint32_t writes = 0, auths = 0;
+
+    fresh_part();
+    boot();
+    while (eeprom_handler_process() || ConfigStore_Process())
+    {
+    }
+    FakeEEPROM_ClearStats();
+    uint64_t t0 = FakeCPU_Cycles();
+    run_script(mode);
+    FakeEEPROM_GetStats(&st);
+
+    for (uint32_t i = 0; i < script_len; i++)
+    {
+        uint64_t lat = rsp_cycles[i + 1] - (t0 + script[i].arrival);
+        if (script[i].key == NO_KEY)
+        {
+            auth_sum += lat;
+            auth_max = lat > auth_max ? lat : auth_max;
+            auths++;
+        }
+        else
+        {
+            write_sum += lat;
+            write_max = lat > write_max ? lat : write_max;
+            writes++;
+        }
+    }
+
+    printf("    %-9s write rsp mean %5.0f us max %5.0f us | auth rsp mean %5.0f us max %5.0f us | %.2f programs/write\n",
+           name,
+           write_sum * 1e6 / FAKE_SYSTEM_CLOCK / writes, write_max * 1e6 / FAKE_SYSTEM_CLOCK,
+           auth_sum * 1e6 / FAKE_SYSTEM_CLOCK / auths, auth_max * 1e6 / FAKE_SYSTEM_CLOCK,
+           (double)st.program_calls / writes);
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Write-Behind Commit, Power Loss After Every Programmed Word ---\n");
+    run_test("Power Loss, Durable Mode", test_power_loss_durable);
+    run_test("Power Loss, Accepted Mode", test_power_loss_accepted);
+    print_sweep("durable", &durable_sweep);
+    print_sweep("accepted", &accepted_sweep);
+
+    printf("\n--- Response Latency (%u bursts of 3 writes + 1 auth, every %u ms) ---\n",
+           BENCH_PERIODS, (unsigned)(BENCH_PERIOD * 1000 / FAKE_SYSTEM_CLOCK));
+    build_script(BENCH_PERIODS, BENCH_PERIOD);
+    bench_latency("sync", MODE_SYNC);
+    bench_latency("durable", CMD_COMMIT_DURABLE);
+    bench_latency("accepted", CMD_COMMIT_ACCEPTED);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
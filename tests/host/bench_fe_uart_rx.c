@@ -0,0 +1,322 @@
+/*
+ * bench_fe_uart_rx.c - Host tests and latency benchmark for the frontend
+ * UART1 RX path (interrupt-fed ring, millisecond deadlines, WFI waits)
+ *
+ * Runs the real frontend UART driver, SysTick clock and protocol against
+ * a register-level model of UART1/SysTick (fake_tm4c123), with the real
+ * backend protocol answering on the far end of a 115200 baud line.
+ * Measures the time from the last response byte arriving to
+ * UART_Protocol_SendCommand returning and how much of the wait the CPU
+ * spends asleep, and checks that a dead line times out after the same
+ * number of milliseconds however slow the code is. For comparison it
+ * reruns the old loop-counted polled receive.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -include tests/host/fake_tm4c123.h -I tests/host/iar \
+ *       tests/host/bench_fe_uart_rx.c tests/host/fake_tm4c123.c \
+ *       tests/test_common.c frontend/MCAL/uart.c frontend/MCAL/systick.c \
+ *       frontend/application/uart_protocol.c frontend/application/crc16.c \
+ *       backend/application/uart_protocol.c -o bench_fe_uart_rx
+ *   ./bench_fe_uart_rx
+ */
+
+#include "../test_common.h"
+#include "../../frontend/MCAL/uart.h"
+#include "../../frontend/MCAL/systick.h"
+#include "../../frontend/application/uart_protocol.h"
+#include <intrinsics.h>
+#include <string.h>
+
+/* Backend protocol entry points (its header shares the frontend's guard) */
+void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len);
+void UART_Protocol_HandlePacket(uint8_t *buf, uint8_t len);
+
+#define CYCLES_PER_US       (FAKE_TM4C_CLOCK / 1000000)
+#define BACKEND_CYCLES      (300 * CYCLES_PER_US)   /* Handling time per request */
+#define LEGACY_TIMEOUT_LOOPS 2000000                /* Old UART_TIMEOUT_LOOPS */
+
+/*===========================================================================
+ * Backend on the far end of the line
+ *===========================================================================*/
+static int backend_mute = 0;
+static uint8_t bk_state = 0, bk_len = 0, bk_pos = 0, bk_body[32];
+static uint64_t bk_reply_at = 0;
+
+void UART_Driver_SendFrame(const uint8_t *body, uint8_t len)
+{
+    uint64_t t = bk_reply_at;
+
+    FakeTM4C_Uart1Schedule(SOF_RESPONSE, t += FAKE_TM4C_BYTE_CYCLES);
+    FakeTM4C_Uart1Schedule(len, t += FAKE_TM4C_BYTE_CYCLES);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        FakeTM4C_Uart1Schedule(body[i], t += FAKE_TM4C_BYTE_CYCLES);
+    }
+    bk_reply_at = t;
+}
+
+/* Frontend TX byte reached the backend */
+static void backend_rx(uint8_t b, uint64_t cycle)
+{
+    if (backend_mute) return;
+
+    switch (bk_state)
+    {
+        case 0:
+            if (b == SOF_REQUEST) bk_state = 1;
+            break;
+        case 1:
+            if (b >= 1 && b <= 32) { bk_len = b; bk_pos = 0; bk_state = 2; }
+            else bk_state = 0;
+            break;
+        default:
+            bk_body[bk_pos++] = b;
+            if (bk_pos == bk_len)
+            {
+                bk_state = 0;
+                if (bk_reply_at < cycle + BACKEND_CYCLES)
+                {
+                    bk_reply_at = cycle + BACKEND_CYCLES;
+                }
+                UART_Protocol_HandlePacket(bk_body, bk_len);
+            }
+            break;
+    }
+}
+
+void LED_GreenOn(void) {}
+void LED_BlinkGreen(uint8_t times) { (void)times; }
+void LED_BlinkRed(uint8_t times) { (void)times; }
+bool LED_IsPatternActive(void) { return false; }
+
+static void echo_handler(uint8_t *buf, uint8_t len)
+{
+    UART_Protocol_SendResponse(buf[0], STATUS_OK, &buf[1], (uint8_t)(len - 1));
+}
+
+void CMD_InitPassword(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_Auth(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_SetTimeout(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_ChangePassword(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_GetTimeout(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_SetClock(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_AddUser(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_RemoveUser(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_ListUsers(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_CommitMode(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static void reset_world(void)
+{
+    FakeTM4C_Init();
+    FakeTM4C_Uart1SetSink(backend_rx);
+    backend_mute = 0;
+    bk_state = 0;
+    bk_reply_at = 0;
+    SysTick_Init(16000, SYSTICK_INT);
+    UART_Protocol_Init();
+}
+
+static double cycles_to_us(uint64_t c)
+{
+    return (double)c / CYCLES_PER_US;
+}
+
+/* Old UART_Driver_ReceiveByte: FR polled a fixed number of times */
+static uint8_t legacy_receive_byte(uint8_t *data)
+{
+    uint32_t timeout = LEGACY_TIMEOUT_LOOPS;
+
+    while ((UART1_FR_R & 0x10) != 0)
+    {
+        timeout--;
+        if (timeout == 0) return 0;
+    }
+    *data = (uint8_t)(UART1_DR_R & 0xFF);
+    return 1;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_negotiates_over_model(void)
+{
+    uint8_t payload[2] = {0x12, 0x34};
+    uint8_t out[16], outLen = 0;
+
+    reset_world();
+    TEST_ASSERT_EQUAL(2, UART_Protocol_GetVersion());
+    TEST_ASSERT_EQUAL(STATUS_OK, UART_Protocol_SendCommand(0x05, payload, 2, out, &outLen));
+    TEST_ASSERT_EQUAL(2, outLen);
+    TEST_ASSERT_EQUAL(0x34, out[1]);
+
+    TEST_PASS();
+}
+
+static TestResult test_burst_while_busy(void)
+{
+    uint8_t b;
+
+    reset_world();
+    FakeTM4C_Uart1SetSink(NULL);
+
+    /* 48 back-to-back bytes (three FIFOs' worth) while the main loop is
+     * busy elsewhere for 10 ms: the ISR keeps up */
+    for (uint32_t i = 0; i < 48; i++)
+    {
+        FakeTM4C_Uart1Schedule((uint8_t)(i * 7), FakeTM4C_Cycles() + (i + 1) * FAKE_TM4C_BYTE_CYCLES);
+    }
+    FakeTM4C_Run(10 * (FAKE_TM4C_CLOCK / 1000));
+
+    for (uint32_t i = 0; i < 48; i++)
+    {
+        TEST_ASSERT(UART_Driver_TryReceiveByte(&b));
+        TEST_ASSERT_EQUAL((uint8_t)(i * 7), b);
+    }
+    TEST_ASSERT(!UART_Driver_TryReceiveByte(&b));
+    TEST_ASSERT_EQUAL(0, FakeTM4C_Uart1Overruns());
+
+    /* Neither unmasks a caller that has interrupts masked */
+    __disable_interrupt();
+    TEST_ASSERT(!UART_Driver_TryReceiveByte(&b));
+    UART_Driver_FlushRx();
+    TEST_ASSERT_EQUAL(1, __get_interrupt_state());
+    __enable_interrupt();
+
+    TEST_PASS();
+}
+
+static TestResult test_deadline_is_wall_clock(void)
+{
+    uint8_t b;
+    uint64_t t0, ms_fast, ms_slow;
+
+    /* Same deadline with code 10x slower per register access */
+    reset_world();
+    t0 = FakeTM4C_Cycles();
+    TEST_ASSERT(!UART_Driver_ReceiveByteUntil(&b, SysTick_GetMs() + 100));
+    ms_fast = (FakeTM4C_Cycles() - t0) / (FAKE_TM4C_CLOCK / 1000);
+
+    reset_world();
+    FakeTM4C_AccessCycles = 40;
+    t0 = FakeTM4C_Cycles();
+    TEST_ASSERT(!UART_Driver_ReceiveByteUntil(&b, SysTick_GetMs() + 100));
+    ms_slow = (FakeTM4C_Cycles() - t0) / (FAKE_TM4C_CLOCK / 1000);
+
+    TEST_ASSERT(ms_fast >= 99 && ms_fast <= 101);
+    TEST_ASSERT(ms_slow >= 99 && ms_slow <= 101);
+
+    TEST_PASS();
+}
+
+static TestResult test_return_latency(void)
+{
+    uint8_t payload[3] = {0x01, 0x02, 0x03};
+    uint8_t out[16], outLen;
+
+    reset_world();
+
+    /* Odd and even response lengths: the tail below the FIFO trigger
+     * waits for the receive timeout (32 bit times, ~278 us) at worst */
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, UART_Protocol_SendCommand(0x05, payload, (uint8_t)(1 + i % 3), out, &outLen));
+        uint64_t lat = FakeTM4C_Cycles() - FakeTM4C_Uart1LastArrival();
+        TEST_ASSERT(lat < 350 * CYCLES_PER_US);
+        FakeTM4C_Run(FAKE_TM4C_CLOCK / 1000);
+    }
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static void bench_latency(void)
+{
+    enum { N = 200 };
+    uint8_t payload[4];
+    uint8_t out[16], outLen;
+    double sum = 0.0, worst = 0.0;
+    uint64_t busy = 0, total = 0;
+
+    reset_world();
+    for (uint32_t i = 0; i < N; i++)
+    {
+        payload[0] = (uint8_t)i;
+        payload[1] = (uint8_t)(i >> 8);
+        payload[2] = 0x5A;
+        payload[3] = (uint8_t)(i * 3);
+
+        uint64_t t0 = FakeTM4C_Cycles();
+        uint64_t s0 = FakeTM4C_SleepCycles();
+        UART_Protocol_SendCommand(0x05, payload, (uint8_t)(1 + i % 4), out, &outLen);
+        uint64_t t1 = FakeTM4C_Cycles();
+
+        double lat = cycles_to_us(t1 - FakeTM4C_Uart1LastArrival());
+        sum += lat;
+        if (lat > worst) worst = lat;
+        total += t1 - t0;
+        busy += (t1 - t0) - (FakeTM4C_SleepCycles() - s0);
+
+        /* Main loop does other work between commands */
+        FakeTM4C_Run(FAKE_TM4C_CLOCK / 1000);
+    }
+
+    printf("    SendCommand: %.3f ms each, last byte -> return mean %.1f us, "
+           "max %.1f us, CPU awake %.1f%%\n",
+           cycles_to_us(total) / 1000.0 / N, sum / N, worst,
+           100.0 * (double)busy / (double)total);
+}
+
+static void bench_dead_line(void)
+{
+    uint8_t b;
+    uint8_t out[16], outLen;
+    uint64_t t0, s0;
+
+    for (uint32_t cost = 4; cost <= 40; cost *= 10)
+    {
+        reset_world();
+        backend_mute = 1;
+        FakeTM4C_AccessCycles = cost;
+
+        t0 = FakeTM4C_Cycles();
+        s0 = FakeTM4C_SleepCycles();
+        UART_Protocol_SendCommand(0x05, NULL, 0, out, &outLen);
+        uint64_t spent = FakeTM4C_Cycles() - t0;
+        uint64_t slept = FakeTM4C_SleepCycles() - s0;
+
+        /* Old driver: one polled byte with the interrupt path switched off */
+        NVIC_DIS0_R = 1UL << 6;
+        uint64_t l0 = FakeTM4C_Cycles();
+        legacy_receive_byte(&b);
+        uint64_t legacy = FakeTM4C_Cycles() - l0;
+
+        printf("    %2u cycles/access: dead-line SendCommand %.1f ms (awake %.1f%%); "
+               "old ReceiveByte timeout %.1f ms (awake 100%%)\n",
+               cost, cycles_to_us(spent) / 1000.0,
+               100.0 * (double)(spent - slept) / (double)spent,
+               cycles_to_us(legacy) / 1000.0);
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend UART RX Tests ---\n");
+    run_test("Negotiates Over Model", test_negotiates_over_model);
+    run_test("Burst While Busy", test_burst_while_busy);
+    run_test("Deadline Is Wall Clock", test_deadline_is_wall_clock);
+    run_test("Return Latency", test_return_latency);
+
+    printf("\n--- Response Latency (virtual 16 MHz, 115200 baud) ---\n");
+    bench_latency();
+    bench_dead_line();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,705 @@
+/*
+ * bench_lcd_i2c.c - Host tests and I2C trace benchmark for the frontend
+ * LCD driver (PCF8574 backpack + HD44780)
+ *
+ * Runs the real frontend/HAL/lcd.c on the API-level I2C master in
+ * fake_i2c.c and the virtual clock in fake_systick.c, with every byte the
+ * backpack receives decoded by the PCF8574 + HD44780 model in
+ * fake_hd44780.c (nibbles latched on EN falling edges, busy time at the
+ * slowest 190 kHz oscillator).
+ *
+ * Checks that LCD_Init finds the backpack at 0x27 or 0x3F and only uses
+ * fast mode when it answers there and echoes a test pattern, then that
+ * init, single writes, burst writes and shadow buffer flushes leave the
+ * right text with no instruction started while the controller is busy,
+ * with the backpack on a 100 kHz-only bus and again in fast mode.
+ * Reports bus time, wall time, transfers and bytes on the bus per
+ * full-screen update (clear + 2 x 16 characters) at both speeds for the
+ * old millisecond-delay driver, datasheet timing with one I2C transfer
+ * per EN edge, the burst driver and a shadow buffer flush over a
+ * different screen. Last, the same figures for typical UI screen
+ * transitions done the old way (clear and rewrite, or rewrite the whole
+ * line) and through the shadow buffer.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host tests/host/bench_lcd_i2c.c \
+ *       tests/host/fake_i2c.c tests/host/fake_hd44780.c \
+ *       tests/host/fake_systick.c tests/test_common.c \
+ *       frontend/HAL/lcd.c -o bench_lcd_i2c
+ *   ./bench_lcd_i2c
+ */
+
+#include "../test_common.h"
+#include "fake_systick.h"
+#include "fake_i2c.h"
+#include "fake_hd44780.h"
+#include "../../frontend/HAL/lcd.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PCF_RS          0x01
+#define PCF_EN          0x04
+#define PCF_BL          0x08
+
+static const char LINE1[] = "Enter Password: ";
+static const char LINE2[] = "*****     #=Back";
+static const char BLANK[] = "                ";
+
+/*===========================================================================
+ * Earlier drivers, for comparison
+ *===========================================================================*/
+
+/* Original: DelayMs(1) after each EN edge, DelayMs(2) twice on clear */
+static void legacy_nibble(uint8_t nibble, uint8_t rs)
+{
+    uint8_t data = (nibble & 0xF0) | PCF_BL;
+    if (rs) data |= PCF_RS;
+
+    I2C_WriteByte(I2C_MODULE_0, 0x27, data | PCF_EN);
+    DelayMs(1);
+    I2C_WriteByte(I2C_MODULE_0, 0x27, data);
+    DelayMs(1);
+}
+
+static void legacy_byte(uint8_t data, uint8_t rs)
+{
+    legacy_nibble(data & 0xF0, rs);
+    legacy_nibble((data << 4) & 0xF0, rs);
+}
+
+static void legacy_command(uint8_t cmd)
+{
+    legacy_byte(cmd, 0);
+    if (cmd == LCD_CMD_CLEAR || cmd == LCD_CMD_HOME) DelayMs(2);
+}
+
+static void legacy_show(const char *l1, const char *l2)
+{
+    legacy_command(LCD_CMD_CLEAR);
+    DelayMs(2);
+    legacy_command(LCD_CMD_SET_DDRAM | 0x00);
+    while (*l1) legacy_byte((uint8_t)*l1++, 1);
+    legacy_command(LCD_CMD_SET_DDRAM | 0x40);
+    while (*l2) legacy_byte((uint8_t)*l2++, 1);
+}
+
+/* Datasheet timing, but one single-byte I2C transfer per EN edge */
+static uint64_t edge_ready_us;
+
+static void edge_byte(uint8_t data, uint8_t rs, uint32_t exec_us)
+{
+    uint8_t pins = rs ? (PCF_BL | PCF_RS) : PCF_BL;
+    uint8_t high = (data & 0xF0) | pins;
+    uint8_t low = (uint8_t)(data << 4) | pins;
+
+    if (SysTick_GetUs() < edge_ready_us) DelayUs((uint32_t)(edge_ready_us - SysTick_GetUs()));
+    I2C_WriteByte(I2C_MODULE_0, 0x27, high | PCF_EN);
+    I2C_WriteByte(I2C_MODULE_0, 0x27, high);
+    I2C_WriteByte(I2C_MODULE_0, 0x27, low | PCF_EN);
+    I2C_WriteByte(I2C_MODULE_0, 0x27, low);
+    edge_ready_us = SysTick_GetUs() + exec_us;
+}
+
+static void edge_show(const char *l1, const char *l2)
+{
+    edge_ready_us = 0;
+    edge_byte(LCD_CMD_CLEAR, 0, 2160);
+    edge_byte(LCD_CMD_SET_DDRAM | 0x00, 0, 53);
+    while (*l1) edge_byte((uint8_t)*l1++, 1, 53);
+    edge_byte(LCD_CMD_SET_DDRAM | 0x40, 0, 53);
+    while (*l2) edge_byte((uint8_t)*l2++, 1, 53);
+}
+
+/*===========================================================================
+ * Current driver
+ *===========================================================================*/
+static void driver_show(const char *l1, const char *l2)
+{
+    LCD_Clear();
+    LCD_SetCursor(0, 0);
+    LCD_WriteString(l1);
+    LCD_SetCursor(1, 0);
+    LCD_WriteString(l2);
+}
+
+/* As ui_display.c does it now */
+static void fb_show(const char *l1, const char *l2)
+{
+    LCD_BufferClear();
+    LCD_BufferWrite(0, 0, l1);
+    LCD_BufferWrite(1, 0, l2);
+    LCD_Flush();
+}
+
+static void fb_line(uint8_t row, const char *text)
+{
+    for (uint8_t col = 0; col < LCD_COLS; col++)
+    {
+        LCD_BufferPutChar(row, col, *text ? *text++ : ' ');
+    }
+    LCD_Flush();
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+/* Fastest SCL the backpack answers at */
+static uint32_t bus_limit = I2C_SPEED_100K;
+
+static void reset_world(void)
+{
+    SysTick_Init(16000, SYSTICK_INT);
+    FakeI2C_Reset();
+    FakeI2C_SetMaxSpeed(bus_limit);
+    FakeI2C_SetSink(FakeHD44780_Pins);
+    FakeHD44780_Reset();
+    LCD_Init();
+}
+
+static FakeHD44780_Stats_t lcd_stats(void)
+{
+    FakeHD44780_Stats_t s;
+    FakeHD44780_GetStats(&s);
+    return s;
+}
+
+typedef struct {
+    double   wall_ms;
+    double   bus_ms;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t violations;
+} update_cost_t;
+
+/* Blank-padded to the 16 columns FakeHD44780_Shows compares */
+static const char *pad(const char *text)
+{
+    static char buf[2][LCD_COLS + 1];
+    static int which = 0;
+    char *p = buf[which ^= 1];
+
+    memset(p, ' ', LCD_COLS);
+    p[LCD_COLS] = '\0';
+    memcpy(p, text, strlen(text) < LCD_COLS ? strlen(text) : LCD_COLS);
+    return p;
+}
+
+/* Bytes on the bus for one burst of LCD writes: the address, 4 pin
+ * writes each and, in fast mode, an idle byte between writes to cover
+ * the 53 us execution time */
+static uint32_t burst_bytes(uint32_t writes)
+{
+    uint32_t pad = (FakeI2C_GetSpeed() > I2C_SPEED_100K) ? 1 : 0;
+    return 1 + 4 * writes + pad * (writes - 1);
+}
+
+static update_cost_t measure_update(void (*update)(void))
+{
+    FakeI2C_Stats_t s0, s1;
+    update_cost_t cost;
+    uint32_t v0;
+    uint64_t t0;
+
+    /* Let the previous screen's instructions finish first */
+    DelayMs(5);
+    v0 = lcd_stats().violations;
+    FakeI2C_GetStats(&s0);
+    t0 = FakeSysTick_GetNs();
+    update();
+    FakeI2C_GetStats(&s1);
+
+    cost.wall_ms = (double)(FakeSysTick_GetNs() - t0) / 1e6;
+    cost.bus_ms = (double)(s1.bus_ns - s0.bus_ns) / 1e6;
+    cost.transactions = s1.transactions - s0.transactions;
+    cost.bytes = s1.bytes - s0.bytes;
+    cost.violations = lcd_stats().violations - v0;
+    return cost;
+}
+
+static void (*full_show)(const char *, const char *);
+
+static void show_test_lines(void)
+{
+    full_show(LINE1, LINE2);
+}
+
+static update_cost_t measure(void (*show)(const char *, const char *))
+{
+    full_show = show;
+    return measure_update(show_test_lines);
+}
+
+/*===========================================================================
+ * Screen transitions
+ *===========================================================================*/
+typedef struct {
+    const char *name;
+    const char *from[2];
+    const char *to[2];
+    void (*old_update)(void);   /* What the UI used to send */
+    void (*new_update)(void);   /* Through the shadow buffer */
+} transition_t;
+
+static const transition_t *cur;
+
+static void old_message(void) { driver_show(cur->to[0], cur->to[1]); }
+static void new_message(void) { fb_show(cur->to[0], cur->to[1]); }
+
+static void old_line(void)
+{
+    LCD_SetCursor(1, 0);
+    LCD_WriteString(cur->to[1]);
+}
+
+static void new_line(void) { fb_line(1, cur->to[1]); }
+
+/* Password entry: the cursor already sits after the last '*' */
+static void old_star(void) { LCD_WriteChar('*'); }
+
+static void new_star(void)
+{
+    LCD_BufferPutChar(1, (uint8_t)strlen(cur->from[1]), '*');
+    LCD_Flush();
+}
+
+/* Progress label: three dot cells rewritten every step */
+static void old_dots(void)
+{
+    size_t n = strlen(cur->to[0]);
+    LCD_SetCursor(0, 9);
+    for (size_t i = 9; i < 12; i++) LCD_WriteChar(i < n ? '.' : ' ');
+}
+
+static void new_dots(void)
+{
+    size_t n = strlen(cur->to[0]);
+    for (size_t i = 9; i < 12; i++) LCD_BufferPutChar(0, (uint8_t)i, i < n ? '.' : ' ');
+    LCD_Flush();
+}
+
+static const transition_t transitions[] = {
+    {"menu -> password prompt", {"A:Sign *:ChgPwd", "C:Time #:Cancel"},
+     {"Enter Password:", ""}, old_message, new_message},
+    {"keystroke '*'", {"Enter Password:", "**"},
+     {"Enter Password:", "***"}, old_star, new_star},
+    {"prompt -> verifying", {"Enter Password:", "*****"},
+     {"Verifying", ""}, old_message, new_message},
+    {"progress dot", {"Verifying.", ""},
+     {"Verifying..", ""}, old_dots, new_dots},
+    {"door countdown tick", {"Door Open", "Closing in: 10 s"},
+     {"Door Open", "Closing in:  9 s"}, old_line, new_line},
+    {"lockout countdown tick", {"!! LOCKED OUT !!", "Wait: 12 seconds"},
+     {"!! LOCKED OUT !!", "Wait: 11 seconds"}, old_line, new_line},
+    {"lockout -> menu", {"!! LOCKED OUT !!", "Wait:  1 seconds"},
+     {"A:Sign *:ChgPwd", "C:Time #:Cancel"}, old_message, new_message},
+    {"same message again", {"Door Locker", "Security System"},
+     {"Door Locker", "Security System"}, old_message, new_message},
+};
+
+#define NUM_TRANSITIONS (sizeof(transitions) / sizeof(transitions[0]))
+
+/* Returns 1 if the update left the target screen with no violations */
+static int run_transition(const transition_t *t, int use_new, update_cost_t *cost)
+{
+    cur = t;
+    reset_world();
+    fb_show(t->from[0], t->from[1]);
+    LCD_SetCursor(1, (uint8_t)strlen(t->from[1]));
+
+    *cost = measure_update(use_new ? t->new_update : t->old_update);
+    return FakeHD44780_Shows(pad(t->to[0]), pad(t->to[1])) && cost->violations == 0;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_probe_finds_backpack(void)
+{
+    /* PCF8574A backpack */
+    bus_limit = I2C_SPEED_400K;
+    SysTick_Init(16000, SYSTICK_INT);
+    FakeI2C_Reset();
+    FakeI2C_SetDevice(0x3F);
+    FakeI2C_SetSink(FakeHD44780_Pins);
+    FakeHD44780_Reset();
+    LCD_Init();
+    TEST_ASSERT_EQUAL(I2C_SPEED_400K, FakeI2C_GetSpeed());
+    driver_show(LINE1, LINE2);
+    TEST_ASSERT(FakeHD44780_Shows(LINE1, LINE2));
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+
+    /* Backpack that drops fast-mode bytes: back to standard mode */
+    bus_limit = I2C_SPEED_100K;
+    reset_world();
+    TEST_ASSERT_EQUAL(I2C_SPEED_100K, FakeI2C_GetSpeed());
+    driver_show(LINE1, LINE2);
+    TEST_ASSERT(FakeHD44780_Shows(LINE1, LINE2));
+
+    /* ACKs its address in fast mode but corrupts data: standard mode */
+    bus_limit = I2C_SPEED_400K;
+    SysTick_Init(16000, SYSTICK_INT);
+    FakeI2C_Reset();
+    FakeI2C_SetCleanSpeed(I2C_SPEED_100K);
+    FakeI2C_SetSink(FakeHD44780_Pins);
+    FakeHD44780_Reset();
+    LCD_Init();
+    TEST_ASSERT_EQUAL(I2C_SPEED_100K, FakeI2C_GetSpeed());
+    driver_show(LINE1, LINE2);
+    TEST_ASSERT(FakeHD44780_Shows(LINE1, LINE2));
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+
+    /* Nobody there: Init and writes still return */
+    FakeI2C_Reset();
+    FakeI2C_SetDevice(0x00);
+    LCD_Init();
+    TEST_ASSERT_EQUAL(I2C_SPEED_100K, FakeI2C_GetSpeed());
+    driver_show(LINE1, LINE2);
+    fb_show(LINE2, LINE1);
+
+    TEST_PASS();
+}
+
+static TestResult test_init_reaches_4bit_mode(void)
+{
+    reset_world();
+
+    FakeHD44780_Stats_t s = lcd_stats();
+    TEST_ASSERT(s.four_bit);
+    TEST_ASSERT_EQUAL(0, s.violations);
+    TEST_ASSERT_EQUAL(0, s.short_pulses);
+    TEST_ASSERT(FakeHD44780_Shows(BLANK, BLANK));
+    /* 4 function sets, function set, display on, clear, entry mode */
+    TEST_ASSERT_EQUAL(8, s.instructions);
+    printf("    init %.2f ms including the 50 ms power-up wait\n",
+           (double)FakeSysTick_GetNs() / 1e6);
+
+    TEST_PASS();
+}
+
+static TestResult test_full_screen_update(void)
+{
+    reset_world();
+    driver_show(LINE1, LINE2);
+
+    FakeHD44780_Stats_t s = lcd_stats();
+    TEST_ASSERT(FakeHD44780_Shows(LINE1, LINE2));
+    TEST_ASSERT_EQUAL(0, s.violations);
+    TEST_ASSERT_EQUAL(0, s.short_pulses);
+
+    TEST_PASS();
+}
+
+static TestResult test_string_is_one_burst(void)
+{
+    FakeI2C_Stats_t s0, s1;
+
+    reset_world();
+    LCD_SetCursor(1, 0);
+    FakeI2C_GetStats(&s0);
+    LCD_WriteString(LINE2);
+    FakeI2C_GetStats(&s1);
+
+    /* One START/address/STOP for the row, 4 pin writes per character */
+    TEST_ASSERT_EQUAL(1, s1.transactions - s0.transactions);
+    TEST_ASSERT_EQUAL(burst_bytes(16), s1.bytes - s0.bytes);
+    TEST_ASSERT(FakeHD44780_Shows(BLANK, LINE2));
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+
+    TEST_PASS();
+}
+
+static TestResult test_long_string_splits(void)
+{
+    static const char text[] = "0123456789abcdefghijklmnopqrstuv";   /* 32 */
+    FakeI2C_Stats_t s0, s1;
+
+    reset_world();
+    FakeI2C_GetStats(&s0);
+    LCD_WriteString(text);
+    FakeI2C_GetStats(&s1);
+
+    /* DDRAM fills linearly past the visible 16 columns of row 0 */
+    TEST_ASSERT_EQUAL(2, s1.transactions - s0.transactions);
+    for (uint8_t i = 0; i < 32; i++)
+    {
+        TEST_ASSERT_EQUAL(text[i], FakeHD44780_Ddram(i));
+    }
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+
+    TEST_PASS();
+}
+
+static TestResult test_clear_is_waited_out(void)
+{
+    reset_world();
+
+    /* Back-to-back clears and a write straight after: each must wait the
+     * full clear time */
+    for (int i = 0; i < 5; i++)
+    {
+        LCD_Clear();
+        LCD_WriteString("xy");
+    }
+    LCD_Command(LCD_CMD_HOME);
+    LCD_WriteChar('z');
+
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+    TEST_ASSERT_EQUAL('z', FakeHD44780_Ddram(0));
+    TEST_ASSERT_EQUAL('y', FakeHD44780_Ddram(1));
+
+    TEST_PASS();
+}
+
+static TestResult test_model_catches_early_write(void)
+{
+    reset_world();
+
+    /* Clear, then a data nibble with no wait: the model must object */
+    LCD_Clear();
+    legacy_nibble(0x40, 1);
+    TEST_ASSERT_EQUAL(1, lcd_stats().violations);
+
+    TEST_PASS();
+}
+
+static TestResult test_earlier_drivers_match_screen(void)
+{
+    reset_world();
+    legacy_show(LINE1, LINE2);
+    TEST_ASSERT(FakeHD44780_Shows(LINE1, LINE2));
+
+    DelayMs(5);
+    edge_show(LINE2, LINE1);
+    TEST_ASSERT(FakeHD44780_Shows(LINE2, LINE1));
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+
+    TEST_PASS();
+}
+
+static TestResult test_flush_sends_only_changes(void)
+{
+    FakeI2C_Stats_t s0, s1;
+
+    reset_world();
+    fb_show("Door Open", "Closing in: 10 s");
+    TEST_ASSERT(FakeHD44780_Shows(pad("Door Open"), "Closing in: 10 s"));
+
+    /* Two digits: one transfer with the address and two characters */
+    FakeI2C_GetStats(&s0);
+    LCD_BufferWrite(1, 12, " 9");
+    LCD_Flush();
+    FakeI2C_GetStats(&s1);
+    TEST_ASSERT_EQUAL(1, s1.transactions - s0.transactions);
+    TEST_ASSERT_EQUAL(burst_bytes(3), s1.bytes - s0.bytes);
+    TEST_ASSERT(FakeHD44780_Shows(pad("Door Open"), "Closing in:  9 s"));
+
+    /* Nothing changed, nothing sent */
+    FakeI2C_GetStats(&s0);
+    fb_show("Door Open", "Closing in:  9 s");
+    FakeI2C_GetStats(&s1);
+    TEST_ASSERT_EQUAL(0, s1.bytes - s0.bytes);
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+
+    TEST_PASS();
+}
+
+static TestResult test_flush_bridges_single_gap(void)
+{
+    FakeI2C_Stats_t s0, s1;
+
+    reset_world();
+    fb_show("abcdefgh", "");
+
+    /* Cells 1 and 3 change: resending cell 2 is as cheap as an address */
+    FakeI2C_GetStats(&s0);
+    LCD_BufferPutChar(0, 1, 'B');
+    LCD_BufferPutChar(0, 3, 'D');
+    LCD_Flush();
+    FakeI2C_GetStats(&s1);
+    TEST_ASSERT_EQUAL(1, s1.transactions - s0.transactions);
+    TEST_ASSERT_EQUAL(burst_bytes(4), s1.bytes - s0.bytes);
+
+    /* Cells 0 and 7 change: two runs, one address each */
+    FakeI2C_GetStats(&s0);
+    LCD_BufferPutChar(0, 0, 'A');
+    LCD_BufferPutChar(0, 7, 'H');
+    LCD_Flush();
+    FakeI2C_GetStats(&s1);
+    TEST_ASSERT_EQUAL(burst_bytes(4), s1.bytes - s0.bytes);
+    TEST_ASSERT(FakeHD44780_Shows(pad("ABcDefgH"), pad("")));
+
+    TEST_PASS();
+}
+
+static TestResult test_flush_matches_random_updates(void)
+{
+    static const char charset[] = " .*:0123456789ABCDEFabcdef";
+    char model[LCD_ROWS][LCD_COLS + 1];
+    char text[24];
+    uint32_t flushes = 0;
+
+    reset_world();
+    srand(1234);
+    memset(model, ' ', sizeof(model));
+    model[0][LCD_COLS] = model[1][LCD_COLS] = '\0';
+
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        uint8_t row = (uint8_t)(rand() % LCD_ROWS);
+        uint8_t col = (uint8_t)(rand() % LCD_COLS);
+        size_t n = 1 + (size_t)(rand() % 20);
+
+        for (size_t k = 0; k < n; k++) text[k] = charset[rand() % (sizeof(charset) - 1)];
+        text[n] = '\0';
+
+        switch (rand() % 8)
+        {
+            case 0:
+                LCD_BufferClear();
+                memset(model[0], ' ', LCD_COLS);
+                memset(model[1], ' ', LCD_COLS);
+                break;
+            case 1:
+            case 2:
+                LCD_BufferPutChar(row, col, text[0]);
+                model[row][col] = text[0];
+                break;
+            case 3:
+            case 4:
+                LCD_BufferWrite(row, col, text);
+                for (size_t k = 0; k < n && col + k < LCD_COLS; k++) model[row][col + k] = text[k];
+                break;
+            case 5:
+                /* Direct writes go around the buffer, even past the row
+                 * and across the DDRAM wrap; the next flush undoes them */
+                LCD_SetCursor(row, (uint8_t)(col + (rand() % 2) * 28));
+                LCD_WriteString(text);
+                if (rand() % 2) LCD_Command(LCD_CMD_HOME);
+                break;
+            default:
+                LCD_Flush();
+                flushes++;
+                TEST_ASSERT(FakeHD44780_Shows(model[0], model[1]));
+                break;
+        }
+    }
+    TEST_ASSERT_EQUAL(0, lcd_stats().violations);
+    printf("    %u flushes checked\n", flushes);
+
+    TEST_PASS();
+}
+
+static TestResult test_transitions_reach_target(void)
+{
+    update_cost_t cost;
+
+    for (size_t i = 0; i < NUM_TRANSITIONS; i++)
+    {
+        TEST_ASSERT(run_transition(&transitions[i], 0, &cost));
+        TEST_ASSERT(run_transition(&transitions[i], 1, &cost));
+    }
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static void report(const char *name, update_cost_t c)
+{
+    printf("    %-28s wall %7.2f ms, bus %6.2f ms, %3u transfers, "
+           "%3u bytes, %u violations\n",
+           name, c.wall_ms, c.bus_ms, c.transactions, c.bytes, c.violations);
+}
+
+static void bench_transitions(void)
+{
+    update_cost_t o, n;
+    uint32_t old_bytes = 0, new_bytes = 0;
+    double old_ms = 0, new_ms = 0;
+
+    printf("    %-24s %22s   %22s\n", "", "clear/rewrite", "shadow buffer");
+    printf("    %-24s %6s %7s %7s   %6s %7s %7s\n", "transition",
+           "bytes", "bus ms", "wall ms", "bytes", "bus ms", "wall ms");
+    for (size_t i = 0; i < NUM_TRANSITIONS; i++)
+    {
+        run_transition(&transitions[i], 0, &o);
+        run_transition(&transitions[i], 1, &n);
+        printf("    %-24s %6u %7.2f %7.2f   %6u %7.2f %7.2f\n", transitions[i].name,
+               o.bytes, o.bus_ms, o.wall_ms, n.bytes, n.bus_ms, n.wall_ms);
+        old_bytes += o.bytes;
+        new_bytes += n.bytes;
+        old_ms += o.wall_ms;
+        new_ms += n.wall_ms;
+    }
+    printf("    %-24s %6u %15.2f   %6u %15.2f\n", "total", old_bytes, old_ms, new_bytes, new_ms);
+}
+
+static void run_driver_tests(uint32_t speed)
+{
+    bus_limit = speed;
+    printf("\n--- LCD Driver Tests (%lu kHz) ---\n", (unsigned long)(speed / 1000));
+    run_test("Init Reaches 4-bit Mode", test_init_reaches_4bit_mode);
+    run_test("Full Screen Update", test_full_screen_update);
+    run_test("String Is One Burst", test_string_is_one_burst);
+    run_test("Long String Splits", test_long_string_splits);
+    run_test("Clear Is Waited Out", test_clear_is_waited_out);
+    run_test("Model Catches Early Write", test_model_catches_early_write);
+    run_test("Earlier Drivers Match Screen", test_earlier_drivers_match_screen);
+    run_test("Flush Sends Only Changes", test_flush_sends_only_changes);
+    run_test("Flush Bridges Single Gap", test_flush_bridges_single_gap);
+    run_test("Flush Matches Random Updates", test_flush_matches_random_updates);
+    run_test("Transitions Reach Target", test_transitions_reach_target);
+}
+
+/* Full-screen redraw at one bus speed; returns the burst driver's cost */
+static update_cost_t bench_full_screen(uint32_t speed, update_cost_t *flush)
+{
+    update_cost_t legacy, edge, burst;
+
+    bus_limit = speed;
+    printf("\n--- Full-Screen Update (clear + 32 chars, %lu kHz, virtual time) ---\n",
+           (unsigned long)(speed / 1000));
+    reset_world();
+    legacy = measure(legacy_show);
+    report("DelayMs per EN edge", legacy);
+    edge = measure(edge_show);
+    report("datasheet, transfer per edge", edge);
+    burst = measure(driver_show);
+    report("datasheet, burst per string", burst);
+    fb_show(LINE2, LINE1);
+    *flush = measure(fb_show);
+    report("shadow buffer, new screen", *flush);
+    printf("    bytes on bus: %.0f%% fewer than one transfer per edge; "
+           "wall time %.1fx faster than DelayMs\n",
+           100.0 * (1.0 - (double)burst.bytes / edge.bytes),
+           legacy.wall_ms / burst.wall_ms);
+    return burst;
+}
+
+int main(void)
+{
+    update_cost_t std, fast, std_flush, fast_flush;
+
+    test_init();
+
+    printf("\n--- LCD Probe ---\n");
+    run_test("Probe Finds Backpack", test_probe_finds_backpack);
+    run_driver_tests(I2C_SPEED_100K);
+    run_driver_tests(I2C_SPEED_400K);
+
+    std = bench_full_screen(I2C_SPEED_100K, &std_flush);
+    fast = bench_full_screen(I2C_SPEED_400K, &fast_flush);
+    printf("\n    400 vs 100 kHz: burst redraw %.2f -> %.2f ms (%.1fx), "
+           "flush %.2f -> %.2f ms (%.1fx)\n",
+           std.wall_ms, fast.wall_ms, std.wall_ms / fast.wall_ms,
+           std_flush.wall_ms, fast_flush.wall_ms, std_flush.wall_ms / fast_flush.wall_ms);
+
+    bus_limit = I2C_SPEED_100K;
+    printf("\n--- Screen Transitions (100 kHz, virtual time) ---\n");
+    bench_transitions();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
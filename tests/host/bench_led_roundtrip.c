@@ -0,0 +1,264 @@
+/*
+ * bench_led_roundtrip.c - Host test/benchmark for the status LED pattern
+ * player and its effect on backend command round-trip time
+ *
+ * Checks that blink requests are queued and stepped by a periodic soft
+ * timer,
+ * then measures virtual CPU cycles from a request frame landing in the RX
+ * queue to the last response byte leaving the pin. The legacy figure swaps
+ * in the cost of the old busy-wait blink (reproduced below).
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_led_roundtrip.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/MCAL/uart.c backend/MCAL/gptm.c \
+ *       backend/MCAL/soft_timer.c backend/HAL/status_led.c \
+ *       backend/application/uart_protocol.c backend/application/crc16.c \
+ *       backend/application/uart_handler.c -o bench_led_roundtrip
+ *   ./bench_led_roundtrip
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "../../backend/MCAL/uart.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include "../../backend/HAL/status_led.h"
+#include "../../backend/application/uart_protocol.h"
+#include "../../backend/application/uart_handler.h"
+#include "../../backend/application/uart_commands.h"
+#include <stddef.h>
+
+#define PF_RED      GPIO_PIN_1
+#define PF_GREEN    GPIO_PIN_3
+
+/*===========================================================================
+ * Command handler stand-ins (same responses as the real ones, no EEPROM)
+ *===========================================================================*/
+void CMD_InitPassword(uint8_t *buf, uint8_t len) { (void)buf; (void)len; UART_Protocol_SendResponse(CMD_INIT_PASSWORD, UART_STATUS_OK, NULL, 0); }
+void CMD_Auth(uint8_t *buf, uint8_t len) { (void)buf; (void)len; UART_Protocol_SendResponse(CMD_AUTH, UART_STATUS_AUTH_FAIL, NULL, 0); }
+void CMD_SetTimeout(uint8_t *buf, uint8_t len) { (void)buf; (void)len; UART_Protocol_SendResponse(CMD_SET_TIMEOUT, UART_STATUS_OK, NULL, 0); }
+void CMD_ChangePassword(uint8_t *buf, uint8_t len) { (void)buf; (void)len; UART_Protocol_SendResponse(CMD_CHANGE_PASSWORD, UART_STATUS_OK, NULL, 0); }
+void CMD_GetTimeout(uint8_t *buf, uint8_t len) { uint8_t t = 11; (void)buf; (void)len; UART_Protocol_SendResponse(CMD_GET_TIMEOUT, UART_STATUS_OK, &t, 1); }
+void CMD_SetClock(uint8_t *buf, uint8_t len) { (void)len; UART_Protocol_SendResponse(buf[0], UART_STATUS_OK, NULL, 0); }
+void CMD_AddUser(uint8_t *buf, uint8_t len) { (void)len; UART_Protocol_SendResponse(buf[0], UART_STATUS_OK, NULL, 0); }
+void CMD_RemoveUser(uint8_t *buf, uint8_t len) { (void)len; UART_Protocol_SendResponse(buf[0], UART_STATUS_OK, NULL, 0); }
+void CMD_ListUsers(uint8_t *buf, uint8_t len) { (void)len; UART_Protocol_SendResponse(buf[0], UART_STATUS_OK, NULL, 0); }
+void CMD_CommitMode(uint8_t *buf, uint8_t len) { (void)len; UART_Protocol_SendResponse(buf[0], UART_STATUS_OK, NULL, 0); }
+
+/*===========================================================================
+ * Legacy blocking blink (as shipped before the pattern player)
+ *===========================================================================*/
+static void legacy_blink(uint8_t pin, uint8_t times)
+{
+    for (uint8_t i = 0; i < times; i++)
+    {
+        GPIOPinWrite(GPIO_PORTF_BASE, PF_RED | PF_GREEN, pin);
+        SysCtlDelay(SysCtlClockGet() / 20);
+        GPIOPinWrite(GPIO_PORTF_BASE, PF_RED | PF_GREEN, 0);
+        if (i < times - 1)
+        {
+            SysCtlDelay(SysCtlClockGet() / 20);
+        }
+    }
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+/* Let one LED step (50 ms of Timer0 ticks) elapse and run the main loop */
+static void led_step(void)
+{
+    for (uint8_t i = 0; i < 50; i++)
+    {
+        Timer0A_Handler();
+    }
+    SoftTimer_Process();
+}
+
+static void drain_patterns(void)
+{
+    while (LED_IsPatternActive())
+    {
+        led_step();
+    }
+}
+
+static uint64_t service_tx_until_idle(void)
+{
+    uint64_t isr = 0;
+    while (!UART_Driver_IsTxIdle())
+    {
+        if (FakeUART_TxInterruptPending())
+        {
+            uint64_t t0 = FakeCPU_Cycles();
+            FakeUART_RaiseTxInterrupt();
+            isr += FakeCPU_Cycles() - t0;
+        }
+        FakeCPU_Advance(16);
+    }
+    return isr;
+}
+
+static void inject_request(const uint8_t *body, uint8_t len)
+{
+    FakeUART_RxPush(UART_SOF_RX);
+    FakeUART_RxPush(len);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        FakeUART_RxPush(body[i]);
+    }
+    FakeUART_RaiseRxInterrupt();
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_blink_returns_immediately(void)
+{
+    drain_patterns();
+
+    uint64_t t0 = FakeCPU_Cycles();
+    LED_BlinkGreen(2);
+    uint64_t cost = FakeCPU_Cycles() - t0;
+
+    /* No busy-wait: well under 1 ms of CPU at 16 MHz */
+    TEST_ASSERT(cost < 16000);
+    TEST_ASSERT(LED_IsPatternActive());
+    TEST_ASSERT(FakeTimer_IsEnabled(TIMER0_BASE));
+    TEST_ASSERT_EQUAL(FAKE_SYSTEM_CLOCK / 1000 - 1, FakeTimer_Load(TIMER0_BASE));
+    TEST_ASSERT_EQUAL(PF_GREEN, FakeGPIO_PortF());
+
+    TEST_PASS();
+}
+
+static TestResult test_pattern_sequence(void)
+{
+    const uint8_t expected[] = {0, PF_GREEN, 0};
+
+    drain_patterns();
+    LED_BlinkGreen(2);
+    TEST_ASSERT_EQUAL(PF_GREEN, FakeGPIO_PortF());
+
+    for (uint8_t i = 0; i < sizeof(expected); i++)
+    {
+        led_step();
+        TEST_ASSERT_EQUAL(expected[i], FakeGPIO_PortF());
+    }
+
+    /* Next step finds the queue empty and cancels the soft timer */
+    led_step();
+    TEST_ASSERT(!LED_IsPatternActive());
+    TEST_ASSERT_EQUAL(0, FakeGPIO_PortF());
+
+    TEST_PASS();
+}
+
+static TestResult test_patterns_queue_back_to_back(void)
+{
+    const uint8_t expected[] = {PF_GREEN, 0, PF_RED, 0, PF_RED, 0};
+    uint8_t i = 0;
+
+    drain_patterns();
+    LED_BlinkGreen(1);
+    LED_BlinkRed(2);
+
+    TEST_ASSERT_EQUAL(expected[i++], FakeGPIO_PortF());
+    while (i < sizeof(expected))
+    {
+        led_step();
+        TEST_ASSERT_EQUAL(expected[i++], FakeGPIO_PortF());
+    }
+    led_step();
+    TEST_ASSERT(!LED_IsPatternActive());
+
+    TEST_PASS();
+}
+
+static TestResult test_packet_does_not_block_on_led(void)
+{
+    const uint8_t req[] = {CMD_GET_TIMEOUT};
+
+    drain_patterns();
+    inject_request(req, sizeof(req));
+
+    uint64_t t0 = FakeCPU_Cycles();
+    UART_ProcessPending();
+    uint64_t cost = FakeCPU_Cycles() - t0;
+
+    TEST_ASSERT(cost < 16000);
+    TEST_ASSERT(LED_IsPatternActive());
+    service_tx_until_idle();
+    drain_patterns();
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static void bench_round_trip(void)
+{
+    const uint8_t req[] = {CMD_GET_TIMEOUT};
+    const uint32_t runs = 100;
+    uint64_t cpu = 0, wire = 0;
+
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        drain_patterns();
+        FakeUART_Reset();
+        inject_request(req, sizeof(req));
+
+        uint64_t t0 = FakeCPU_Cycles();
+        UART_ProcessPending();
+        uint64_t main_cycles = FakeCPU_Cycles() - t0;
+        uint64_t isr_cycles = service_tx_until_idle();
+        wire += FakeCPU_Cycles() - t0;
+        cpu += main_cycles + isr_cycles;
+    }
+    cpu /= runs;
+    wire /= runs;
+
+    /* Cost of the blink call on its own, new vs legacy */
+    drain_patterns();
+    uint64_t t0 = FakeCPU_Cycles();
+    LED_BlinkGreen(2);
+    uint64_t new_blink = FakeCPU_Cycles() - t0;
+    drain_patterns();
+
+    t0 = FakeCPU_Cycles();
+    legacy_blink(PF_GREEN, 2);
+    uint64_t old_blink = FakeCPU_Cycles() - t0;
+
+    uint64_t legacy_cpu = cpu - new_blink + old_blink;
+    uint64_t legacy_rtt = (wire > new_blink ? wire - new_blink : 0) + old_blink;
+
+    printf("    blink x2 call:      legacy %8llu cycles, pattern player %5llu cycles\n",
+           (unsigned long long)old_blink, (unsigned long long)new_blink);
+    printf("    CPU per command:    legacy %8llu cycles, pattern player %5llu cycles\n",
+           (unsigned long long)legacy_cpu, (unsigned long long)cpu);
+    printf("    round trip (RX->last TX byte): legacy %.2f ms, pattern player %.3f ms\n",
+           legacy_rtt * 1000.0 / FAKE_SYSTEM_CLOCK, wire * 1000.0 / FAKE_SYSTEM_CLOCK);
+    printf("    max command rate:   legacy %.1f cmd/s, pattern player %.0f cmd/s (CPU bound)\n",
+           (double)FAKE_SYSTEM_CLOCK / legacy_cpu, (double)FAKE_SYSTEM_CLOCK / cpu);
+}
+
+int main(void)
+{
+    test_init();
+    SoftTimer_Init();
+    UART_Handler_Init();
+    drain_patterns();
+
+    printf("\n--- Status LED Pattern Player Tests ---\n");
+    run_test("Blink Returns Immediately", test_blink_returns_immediately);
+    run_test("Pattern Sequence", test_pattern_sequence);
+    run_test("Patterns Queue Back To Back", test_patterns_queue_back_to_back);
+    run_test("Packet Does Not Block On LED", test_packet_does_not_block_on_led);
+
+    printf("\n--- Command Round Trip (CMD_GET_TIMEOUT, 16 MHz) ---\n");
+    bench_round_trip();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+/*
+ * bench_pin_hash.c - Host test/benchmark for the salted PIN hash
+ *
+ * Checks SHA-256 and PBKDF2-HMAC-SHA256 against published vectors, that
+ * PinHash_Hash depends on salt and cost, the branch-free compare, and that
+ * PinHash_Calibrate lands a hash near its time budget. The benchmark times
+ * the kernel (one SHA-256 compression, one PBKDF2 iteration) and
+ * authenticate() for matching and wrong PINs at several iteration counts.
+ * Host times only: the target's own count comes from the boot calibration.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_pin_hash.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/application/pin_hash.c \
+ *       backend/application/sha256.c backend/application/eeprom_handler.c \
+ *       backend/application/config_store.c backend/application/credentials.c \
+ *       backend/application/crc16.c -o bench_pin_hash
+ *   ./bench_pin_hash
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "driverlib/eeprom.h"
+#include "../../backend/application/pin_hash.h"
+#include "../../backend/application/eeprom_handler.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include <string.h>
+#include <time.h>
+
+/* Only Credentials_Today reads the clock; ticks are not needed */
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t period_ms,
+                             SoftTimer_Callback_t callback, void *arg)
+{
+    (void)timer;
+    (void)period_ms;
+    (void)callback;
+    (void)arg;
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static volatile uint32_t sink;
+
+static double host_seconds(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static bool digest_is(const uint32_t digest[SHA256_STATE_WORDS], const char *hex)
+{
+    char buf[SHA256_STATE_WORDS * 8 + 1];
+
+    for (uint8_t i = 0; i < SHA256_STATE_WORDS; i++)
+    {
+        snprintf(&buf[i * 8], 9, "%08x", (unsigned)digest[i]);
+    }
+    return strcmp(buf, hex) == 0;
+}
+
+static void use_params(uint32_t salt0, uint32_t salt1, uint32_t iterations)
+{
+    PinHash_Params_t params = {{salt0, salt1}, iterations};
+    PinHash_Setup(&params);
+}
+
+/* Mean host time of one authenticate(pin), in microseconds */
+static double time_authenticate(uint32_t pin, uint32_t runs)
+{
+    double t0 = host_seconds();
+
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        sink += (uint32_t)authenticate(pin, NULL);
+    }
+    return (host_seconds() - t0) * 1e6 / runs;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_sha256_known_answer(void)
+{
+    uint32_t state[SHA256_STATE_WORDS];
+    uint32_t block[SHA256_BLOCK_WORDS] = {0};
+
+    /* "abc", padded by hand */
+    block[0] = 0x61626380;
+    block[15] = 24;
+    SHA256_Init(state);
+    SHA256_Compress(state, block);
+    TEST_ASSERT(digest_is(state, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    TEST_PASS();
+}
+
+static TestResult test_pbkdf2_known_answer(void)
+{
+    uint32_t digest[SHA256_STATE_WORDS];
+
+    /* RFC 7914, section 11 (first 32 bytes of each) */
+    PinHash_Pbkdf2((const uint8_t *)"passwd", 6, (const uint8_t *)"salt", 4, 1, digest);
+    TEST_ASSERT(digest_is(digest, "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"));
+    PinHash_Pbkdf2((const uint8_t *)"Password", 8, (const uint8_t *)"NaCl", 4, 80000, digest);
+    TEST_ASSERT(digest_is(digest, "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"));
+
+    TEST_PASS();
+}
+
+static TestResult test_hash_depends_on_salt_and_cost(void)
+{
+    uint32_t a;
+
+    /* PIN 12345 as 4 bytes, 8 zero bytes of salt, 64 iterations */
+    use_params(0, 0, 64);
+    a = PinHash_Hash(12345);
+    TEST_ASSERT_EQUAL(0x96EA4B44UL, a);
+    TEST_ASSERT_EQUAL(a, PinHash_Hash(12345));
+    TEST_ASSERT(a != PinHash_Hash(12346));
+
+    use_params(1, 0, 64);
+    TEST_ASSERT(a != PinHash_Hash(12345));
+    use_params(0, 0, 65);
+    TEST_ASSERT(a != PinHash_Hash(12345));
+
+    /* Never the erased value, over the whole 5-digit PIN space */
+    use_params(0x01234567, 0x89ABCDEF, 1);
+    for (uint32_t pin = 0; pin < 100000; pin++)
+    {
+        TEST_ASSERT(PinHash_Hash(pin) != 0xFFFFFFFF);
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_equal_compare(void)
+{
+    static const uint32_t values[] = {0, 1, 0x80000000UL, 0x96EA4B44UL, 0xFFFFFFFEUL};
+
+    for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        TEST_ASSERT(PinHash_Equal(values[i], values[i]));
+        for (uint8_t bit = 0; bit < 32; bit++)
+        {
+            TEST_ASSERT(!PinHash_Equal(values[i], values[i] ^ (1UL << bit)));
+        }
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_calibration_meets_budget(void)
+{
+    static const uint32_t budgets_us[] = {5000, 20000};
+
+    TEST_ASSERT_EQUAL(PIN_HASH_MIN_ITERATIONS, PinHash_Calibrate(0));
+    TEST_ASSERT_EQUAL(PIN_HASH_MAX_ITERATIONS, PinHash_Calibrate(100000000UL));
+
+    /* Best of three, so a preempted run does not fail the test */
+    for (uint8_t b = 0; b < 2; b++)
+    {
+        double best = 1e9;
+        use_params(1, 2, PinHash_Calibrate(budgets_us[b]));
+        for (uint8_t run = 0; run < 3; run++)
+        {
+            double t0 = host_seconds();
+            sink += PinHash_Hash(12345);
+            double us = (host_seconds() - t0) * 1e6;
+            best = us < best ? us : best;
+        }
+        TEST_ASSERT(best > budgets_us[b] * 0.5 && best < budgets_us[b] * 2.0);
+    }
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+#define KERNEL_BLOCKS   2000000
+
+static void bench_kernel(void)
+{
+    uint32_t state[SHA256_STATE_WORDS];
+    uint32_t block[SHA256_BLOCK_WORDS] = {0};
+    uint32_t digest[SHA256_STATE_WORDS];
+    double t0;
+
+    SHA256_Init(state);
+    t0 = host_seconds();
+    for (uint32_t i = 0; i < KERNEL_BLOCKS; i++)
+    {
+        block[0] = i;
+        SHA256_Compress(state, block);
+    }
+    double compress_ns = (host_seconds() - t0) * 1e9 / KERNEL_BLOCKS;
+    sink += state[0];
+
+    t0 = host_seconds();
+    PinHash_Pbkdf2((const uint8_t *)"1234", 4, (const uint8_t *)"saltsalt", 8,
+                   KERNEL_BLOCKS / 2, digest);
+    double iteration_ns = (host_seconds() - t0) * 1e9 / (KERNEL_BLOCKS / 2);
+    sink += digest[0];
+
+    printf("    SHA-256 compression %6.1f ns, PBKDF2 iteration (2 compressions) %6.1f ns\n",
+           compress_ns, iteration_ns);
+}
+
+static void bench_authenticate(void)
+{
+    static const uint32_t costs[] = {64, 256, 1024, 4096, 16384, 65536};
+
+    /* Blank part: the boot picks a salt; the costs are then forced */
+    FakeEEPROM_Reset();
+    EEPROMInit();
+    eeprom_handler_init();
+
+    printf("    %10s %12s %12s %14s\n", "iterations", "match (us)", "wrong (us)", "guesses/s");
+    for (uint8_t c = 0; c < sizeof(costs) / sizeof(costs[0]); c++)
+    {
+        uint32_t runs = 200000 / costs[c] + 1;
+        PinHash_Params_t params;
+
+        PinHash_GetParams(&params);
+        params.iterations = costs[c];
+        PinHash_Setup(&params);
+        initialize_password(12345);
+        eeprom_handler_flush();
+
+        double hit = time_authenticate(12345, runs);
+        double miss = time_authenticate(54321, runs);
+        printf("    %10u %12.1f %12.1f %14.0f\n",
+               (unsigned)costs[c], hit, miss, 1e6 / miss);
+    }
+}
+
+static void bench_calibration(void)
+{
+    static const uint32_t budgets_ms[] = {25, 50, 100, 250};
+
+    printf("    %10s %12s %14s\n", "budget", "iterations", "measured (ms)");
+    for (uint8_t b = 0; b < sizeof(budgets_ms) / sizeof(budgets_ms[0]); b++)
+    {
+        uint32_t iterations = PinHash_Calibrate(budgets_ms[b] * 1000);
+
+        use_params(1, 2, iterations);
+        double t0 = host_seconds();
+        sink += PinHash_Hash(12345);
+        printf("    %7u ms %12u %14.1f\n", (unsigned)budgets_ms[b], (unsigned)iterations,
+               (host_seconds() - t0) * 1e3);
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- PIN Hash Tests ---\n");
+    run_test("SHA-256 Known Answer", test_sha256_known_answer);
+    run_test("PBKDF2 Known Answer", test_pbkdf2_known_answer);
+    run_test("Hash Depends On Salt And Cost", test_hash_depends_on_salt_and_cost);
+    run_test("Equal Compare", test_equal_compare);
+    run_test("Calibration Meets Budget", test_calibration_meets_budget);
+
+    printf("\n--- Hash Kernel (host) ---\n");
+    bench_kernel();
+
+    printf("\n--- authenticate() Latency By Cost (host) ---\n");
+    bench_authenticate();
+
+    printf("\n--- Boot Calibration (host clock as SysTick) ---\n");
+    bench_calibration();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/*
+ * bench_uart_tx.c - Host benchmark for the backend UART1 TX path
+ *
+ * Counts virtual CPU cycles spent sending one response frame with the
+ * legacy byte-at-a-time busy-wait (reproduced below) versus the
+ * interrupt-driven TX ring behind UART_Protocol_SendResponse. LED feedback
+ * is stubbed out here so only the UART cost is measured.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/bench_uart_tx.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/MCAL/uart.c backend/MCAL/gptm.c \
+ *       backend/MCAL/soft_timer.c \
+ *       backend/application/uart_protocol.c backend/application/crc16.c \
+ *       -o bench_uart_tx
+ *   ./bench_uart_tx
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "../../backend/MCAL/uart.h"
+#include "../../backend/application/uart_protocol.h"
+#include <string.h>
+
+/*===========================================================================
+ * Stubs for modules uart_protocol.c links against
+ *===========================================================================*/
+void LED_GreenOn(void) {}
+void LED_Off(void) {}
+void LED_BlinkGreen(uint8_t times) { (void)times; }
+void LED_BlinkRed(uint8_t times) { (void)times; }
+bool LED_IsPatternActive(void) { return false; }
+void CMD_InitPassword(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_Auth(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_SetTimeout(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_ChangePassword(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_GetTimeout(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_SetClock(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_AddUser(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_RemoveUser(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_ListUsers(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+void CMD_CommitMode(uint8_t *buf, uint8_t len) { (void)buf; (void)len; }
+
+/*===========================================================================
+ * Legacy TX path (as shipped before the TX ring)
+ *===========================================================================*/
+static void legacy_send_byte(uint8_t b)
+{
+    while (UARTBusy(UART1_BASE)) {}
+    UARTCharPut(UART1_BASE, b);
+}
+
+static void legacy_send_response(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len)
+{
+    legacy_send_byte(UART_SOF_TX);
+    legacy_send_byte(2 + data_len);
+    legacy_send_byte(cmd);
+    legacy_send_byte(status);
+    for (uint8_t i = 0; i < data_len; i++)
+    {
+        legacy_send_byte(data[i]);
+    }
+    while (UARTBusy(UART1_BASE)) {}
+    SysCtlDelay(1000);
+}
+
+/*===========================================================================
+ * Measurement helpers
+ *===========================================================================*/
+typedef struct {
+    uint64_t caller;    /* Cycles until the send call returned */
+    uint64_t isr;       /* Cycles spent inside the TX interrupt */
+    uint64_t on_wire;   /* Cycles until the last bit left the pin */
+} TxCost_t;
+
+/* Let virtual time pass, servicing TX interrupts, until the line is idle */
+static uint64_t run_until_idle(void)
+{
+    uint64_t isr = 0;
+    while (!UART_Driver_IsTxIdle())
+    {
+        if (FakeUART_TxInterruptPending())
+        {
+            uint64_t t0 = FakeCPU_Cycles();
+            FakeUART_RaiseTxInterrupt();
+            isr += FakeCPU_Cycles() - t0;
+        }
+        FakeCPU_Advance(16);
+    }
+    return isr;
+}
+
+static TxCost_t measure_legacy(uint8_t data_len)
+{
+    uint8_t data[UART_MAX_LEN] = {0};
+    TxCost_t c = {0, 0, 0};
+
+    FakeUART_Reset();
+    uint64_t t0 = FakeCPU_Cycles();
+    legacy_send_response(0x05, UART_STATUS_OK, data, data_len);
+    c.caller = FakeCPU_Cycles() - t0;
+    c.on_wire = c.caller;
+    return c;
+}
+
+static TxCost_t measure_ring(uint8_t data_len)
+{
+    uint8_t data[UART_MAX_LEN] = {0};
+    TxCost_t c = {0, 0, 0};
+
+    FakeUART_Reset();
+    uint64_t t0 = FakeCPU_Cycles();
+    UART_Protocol_SendResponse(0x05, UART_STATUS_OK, data, data_len);
+    c.caller = FakeCPU_Cycles() - t0;
+    c.isr = run_until_idle();
+    c.on_wire = FakeCPU_Cycles() - t0;
+    return c;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_short_frame_on_wire(void)
+{
+    uint8_t data[1] = {11};
+    const uint8_t expected[] = {0xFE, 0x03, 0x05, 0x00, 11};
+
+    FakeUART_Reset();
+    UART_Protocol_SendResponse(0x05, UART_STATUS_OK, data, 1);
+    run_until_idle();
+
+    TEST_ASSERT_EQUAL(sizeof(expected), FakeUART_TxLogLen());
+    TEST_ASSERT(memcmp(expected, FakeUART_TxLog(), sizeof(expected)) == 0);
+    TEST_PASS();
+}
+
+static TestResult test_long_frame_needs_isr(void)
+{
+    uint8_t data[UART_MAX_LEN - 2];
+    for (uint8_t i = 0; i < sizeof(data); i++) data[i] = i;
+
+    FakeUART_Reset();
+    UART_Protocol_SendResponse(0x02, UART_STATUS_OK, data, sizeof(data));
+
+    /* More than one FIFO's worth: the rest must be left for the ISR */
+    TEST_ASSERT(!UART_Driver_IsTxIdle());
+    run_until_idle();
+
+    TEST_ASSERT_EQUAL(4 + sizeof(data), FakeUART_TxLogLen());
+    TEST_ASSERT_EQUAL(0xFE, FakeUART_TxLog()[0]);
+    TEST_ASSERT(memcmp(data, FakeUART_TxLog() + 4, sizeof(data)) == 0);
+    TEST_PASS();
+}
+
+static TestResult test_back_to_back_frames(void)
+{
+    uint8_t data[UART_MAX_LEN - 2] = {0};
+
+    FakeUART_Reset();
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        /* Queue while the previous frame is still on the wire */
+        UART_Protocol_SendResponse(i, UART_STATUS_OK, data, 12);
+    }
+    run_until_idle();
+
+    TEST_ASSERT_EQUAL(3 * 16, FakeUART_TxLogLen());
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL(0xFE, FakeUART_TxLog()[i * 16]);
+        TEST_ASSERT_EQUAL(i, FakeUART_TxLog()[i * 16 + 2]);
+    }
+    TEST_PASS();
+}
+
+static TestResult test_send_longer_than_ring(void)
+{
+    uint8_t data[UART_TX_BUF_SIZE * 3];
+    for (uint16_t i = 0; i < sizeof(data); i++) data[i] = (uint8_t)i;
+
+    /* No interrupt is serviced while queueing: the caller must drain the
+     * ring itself once it fills, or this never returns */
+    FakeUART_Reset();
+    UART_Driver_Send(data, sizeof(data));
+    run_until_idle();
+
+    TEST_ASSERT_EQUAL(sizeof(data), FakeUART_TxLogLen());
+    TEST_ASSERT(memcmp(data, FakeUART_TxLog(), sizeof(data)) == 0);
+    TEST_PASS();
+}
+
+static void report(uint8_t data_len)
+{
+    TxCost_t a = measure_legacy(data_len);
+    TxCost_t b = measure_ring(data_len);
+    uint64_t cpu_b = b.caller + b.isr;
+
+    printf("    %2u-byte frame: legacy %6llu cycles | ring: caller %4llu + isr %4llu"
+           " = %4llu cycles (%.1fx less CPU), on wire %llu\n",
+           4 + data_len,
+           (unsigned long long)a.caller,
+           (unsigned long long)b.caller, (unsigned long long)b.isr,
+           (unsigned long long)cpu_b, (double)a.caller / (double)cpu_b,
+           (unsigned long long)b.on_wire);
+}
+
+int main(void)
+{
+    test_init();
+    UART_Driver_Init();
+
+    printf("\n--- UART TX Ring Tests ---\n");
+    run_test("Short Frame On Wire", test_short_frame_on_wire);
+    run_test("Long Frame Needs ISR", test_long_frame_needs_isr);
+    run_test("Back To Back Frames", test_back_to_back_frames);
+    run_test("Send Longer Than Ring", test_send_longer_than_ring);
+
+    printf("\n--- CPU Cycles Per Response (16 MHz, 115200 baud) ---\n");
+    report(0);
+    report(1);
+    report(12);
+    report(UART_MAX_LEN - 2);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/*
+ * fake_hd44780.c - Host-side model of a PCF8574 backpack + HD44780 LCD
+ *
+ * See fake_hd44780.h.
+ */
+
+#include "fake_hd44780.h"
+#include <string.h>
+
+#define PCF_RS          0x01
+#define PCF_EN          0x04
+#define MIN_PULSE_NS    450
+#define COLS            16
+
+static struct {
+    uint8_t  pins;              /* Last PCF8574 output byte */
+    uint64_t en_rise_ns;
+    int      have_high;
+    uint8_t  high;
+    int      init_step;
+    uint64_t busy_until_ns;
+    uint8_t  addr;
+    char     ddram[0x80];
+    FakeHD44780_Stats_t stats;
+} hd;
+
+static void execute(uint8_t instr, int rs, uint64_t ns)
+{
+    uint64_t exec = FAKE_HD44780_EXEC_NS;
+
+    hd.stats.instructions++;
+    if (rs)
+    {
+        hd.stats.data_writes++;
+        hd.ddram[hd.addr & 0x7F] = (char)instr;
+        /* 2-line mode: row 0 is 0x00-0x27, row 1 is 0x40-0x67 */
+        hd.addr = (uint8_t)((hd.addr + 1) & 0x7F);
+        if (hd.addr == 0x28) hd.addr = 0x40;
+        else if (hd.addr == 0x68) hd.addr = 0x00;
+    }
+    else if (!hd.stats.four_bit)
+    {
+        /* Power-on function sets: 4.1 ms, then 100 us, then normal */
+        hd.init_step++;
+        if (hd.init_step == 1) exec = 4100000ULL;
+        else if (hd.init_step == 2) exec = 100000ULL;
+        if ((instr & 0xF0) == 0x20) hd.stats.four_bit = 1;
+    }
+    else if (instr & 0x80)
+    {
+        hd.addr = instr & 0x7F;
+    }
+    else if (instr == 0x01)
+    {
+        memset(hd.ddram, ' ', sizeof(hd.ddram));
+        hd.addr = 0;
+        exec = FAKE_HD44780_CLEAR_NS;
+    }
+    else if ((instr & 0xFE) == 0x02)
+    {
+        hd.addr = 0;
+        exec = FAKE_HD44780_CLEAR_NS;
+    }
+    hd.busy_until_ns = ns + exec;
+}
+
+void FakeHD44780_Reset(void)
+{
+    memset(&hd, 0, sizeof(hd));
+    memset(hd.ddram, ' ', sizeof(hd.ddram));
+}
+
+void FakeHD44780_Pins(uint8_t pins, uint64_t ns)
+{
+    if ((pins & PCF_EN) && !(hd.pins & PCF_EN))
+    {
+        hd.en_rise_ns = ns;
+    }
+    else if (!(pins & PCF_EN) && (hd.pins & PCF_EN))
+    {
+        uint8_t nibble = hd.pins & 0xF0;
+        int rs = (hd.pins & PCF_RS) != 0;
+
+        if (ns - hd.en_rise_ns < MIN_PULSE_NS) hd.stats.short_pulses++;
+        if (!hd.have_high && ns < hd.busy_until_ns) hd.stats.violations++;
+
+        if (!hd.stats.four_bit)
+        {
+            execute(nibble, rs, ns);
+        }
+        else if (!hd.have_high)
+        {
+            hd.high = nibble;
+            hd.have_high = 1;
+        }
+        else
+        {
+            hd.have_high = 0;
+            execute((uint8_t)(hd.high | (nibble >> 4)), rs, ns);
+        }
+    }
+    hd.pins = pins;
+}
+
+void FakeHD44780_GetStats(FakeHD44780_Stats_t *stats)
+{
+    *stats = hd.stats;
+}
+
+int FakeHD44780_Shows(const char *row0, const char *row1)
+{
+    return memcmp(&hd.ddram[0x00], row0, COLS) == 0 &&
+           memcmp(&hd.ddram[0x40], row1, COLS) == 0;
+}
+
+char FakeHD44780_Ddram(uint8_t addr)
+{
+    return hd.ddram[addr & 0x7F];
+}
@@ -0,0 +1,39 @@
+/*
+ * fake_hd44780.h - Host-side model of a PCF8574 I2C backpack driving an
+ * HD44780 character LCD
+ *
+ * Register FakeHD44780_Pins as the fake_i2c.c sink: each byte written to
+ * the backpack becomes its output pins at the end of the byte's ACK, so
+ * single-byte transfers and bursts are decoded alike. Nibbles are latched
+ * on the falling edge of EN (P2) with RS on P0 and data on P7-P4. The model
+ * follows the power-on 8-bit function sets into 4-bit mode, keeps DDRAM
+ * and the address counter, and counts instructions started while the
+ * controller is still executing the previous one (datasheet times at the
+ * slowest 190 kHz oscillator) and EN pulses shorter than 450 ns.
+ */
+
+#ifndef FAKE_HD44780_H_
+#define FAKE_HD44780_H_
+
+#include <stdint.h>
+
+#define FAKE_HD44780_EXEC_NS    53000ULL    /* 37 us at 270 kHz */
+#define FAKE_HD44780_CLEAR_NS   2160000ULL  /* 1.52 ms at 270 kHz */
+
+typedef struct {
+    uint32_t instructions;      /* Instructions and data writes executed */
+    uint32_t data_writes;
+    uint32_t violations;        /* Started while busy */
+    uint32_t short_pulses;      /* EN high < 450 ns */
+    int      four_bit;
+} FakeHD44780_Stats_t;
+
+void FakeHD44780_Reset(void);
+void FakeHD44780_Pins(uint8_t pins, uint64_t ns);
+void FakeHD44780_GetStats(FakeHD44780_Stats_t *stats);
+
+/* true if the 16 visible columns of both rows hold exactly this text */
+int FakeHD44780_Shows(const char *row0, const char *row1);
+char FakeHD44780_Ddram(uint8_t addr);
+
+#endif /* FAKE_HD44780_H_ */
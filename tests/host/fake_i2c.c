@@ -0,0 +1,201 @@
+/*
+ * fake_i2c.c - Host-side I2C master implementing the frontend I2C API
+ *
+ * See fake_i2c.h.
+ */
+
+#include "fake_i2c.h"
+#include "fake_systick.h"
+#include <stddef.h>
+
+static uint32_t speed_hz = I2C_SPEED_100K;
+static uint8_t device = 0x27;
+static uint32_t max_speed_hz = I2C_SPEED_400K;
+static uint32_t clean_speed_hz = I2C_SPEED_400K;
+static uint8_t port = 0xFF;
+static void (*sink)(uint8_t byte, uint64_t ns) = NULL;
+static FakeI2C_Stats_t stats;
+
+static uint64_t bit_ns(void)
+{
+    return 1000000000ULL / speed_hz;
+}
+
+/* START and address byte; false if the device did not ACK */
+static int begin(uint8_t addr)
+{
+    stats.transactions++;
+    stats.bytes++;
+    FakeSysTick_AdvanceNs(10 * bit_ns());
+    stats.bus_ns += 10 * bit_ns();
+    return addr == device && speed_hz <= max_speed_hz;
+}
+
+static void byte_out(uint8_t byte)
+{
+    stats.bytes++;
+    FakeSysTick_AdvanceNs(9 * bit_ns());
+    stats.bus_ns += 9 * bit_ns();
+    if (speed_hz > clean_speed_hz) byte ^= 0x10;
+    port = byte;
+    if (sink != NULL) sink(byte, FakeSysTick_GetNs());
+}
+
+static void byte_in(uint8_t *byte)
+{
+    stats.bytes++;
+    FakeSysTick_AdvanceNs(9 * bit_ns());
+    stats.bus_ns += 9 * bit_ns();
+    *byte = port;
+}
+
+static void stop(void)
+{
+    FakeSysTick_AdvanceNs(bit_ns());
+    stats.bus_ns += bit_ns();
+}
+
+/*===========================================================================
+ * frontend/MCAL/i2c.h
+ *===========================================================================*/
+void I2C_Init(uint8_t module, uint32_t speed)
+{
+    (void)module;
+    speed_hz = speed;
+}
+
+uint8_t I2C_WriteByte(uint8_t module, uint8_t slaveAddr, uint8_t data)
+{
+    return I2C_WriteMultipleBytes(module, slaveAddr, &data, 1);
+}
+
+uint8_t I2C_WriteMultipleBytes(uint8_t module, uint8_t slaveAddr,
+                               const uint8_t *data, uint8_t length)
+{
+    (void)module;
+    if (length == 0) return I2C_ERROR;
+    if (!begin(slaveAddr))
+    {
+        stop();
+        return I2C_ERROR;
+    }
+    for (uint8_t i = 0; i < length; i++)
+    {
+        byte_out(data[i]);
+    }
+    stop();
+    return I2C_SUCCESS;
+}
+
+uint8_t I2C_ReadByte(uint8_t module, uint8_t slaveAddr, uint8_t *data)
+{
+    return I2C_ReadMultipleBytes(module, slaveAddr, data, 1);
+}
+
+uint8_t I2C_ReadMultipleBytes(uint8_t module, uint8_t slaveAddr,
+                              uint8_t *data, uint8_t length)
+{
+    (void)module;
+    if (length == 0) return I2C_ERROR;
+    if (!begin(slaveAddr))
+    {
+        stop();
+        return I2C_ERROR;
+    }
+    for (uint8_t i = 0; i < length; i++)
+    {
+        byte_in(&data[i]);
+    }
+    stop();
+    return I2C_SUCCESS;
+}
+
+uint8_t I2C_IsBusy(uint8_t module)
+{
+    (void)module;
+    return 0;
+}
+
+/* Runs the whole transfer at once, as if the queue were empty and the
+ * caller slept until it finished */
+uint8_t I2C_Submit(I2C_Transfer_t *xfer)
+{
+    uint8_t status = I2C_SUCCESS;
+
+    if (xfer->txLength == 0 && xfer->rxLength == 0)
+    {
+        xfer->status = I2C_ERROR;
+        return I2C_ERROR;
+    }
+
+    xfer->error = 0;
+    if (xfer->txLength > 0)
+    {
+        status = I2C_WriteMultipleBytes(I2C_MODULE_0, xfer->slaveAddr, xfer->txData, xfer->txLength);
+    }
+    if (status == I2C_SUCCESS && xfer->rxLength > 0)
+    {
+        status = I2C_ReadMultipleBytes(I2C_MODULE_0, xfer->slaveAddr, xfer->rxData, xfer->rxLength);
+    }
+    if (status != I2C_SUCCESS) xfer->error = I2C_ERR_ADDR_NACK;
+
+    xfer->status = status;
+    if (xfer->callback != NULL) xfer->callback(xfer);
+    return I2C_SUCCESS;
+}
+
+uint8_t I2C_Wait(I2C_Transfer_t *xfer)
+{
+    return xfer->status;
+}
+
+/*===========================================================================
+ * Test control
+ *===========================================================================*/
+void FakeI2C_Reset(void)
+{
+    speed_hz = I2C_SPEED_100K;
+    device = 0x27;
+    max_speed_hz = I2C_SPEED_400K;
+    clean_speed_hz = I2C_SPEED_400K;
+    port = 0xFF;
+    sink = NULL;
+    stats.transactions = 0;
+    stats.bytes = 0;
+    stats.bus_ns = 0;
+}
+
+void FakeI2C_SetDevice(uint8_t addr)
+{
+    device = addr;
+}
+
+void FakeI2C_SetMaxSpeed(uint32_t hz)
+{
+    max_speed_hz = hz;
+}
+
+void FakeI2C_SetCleanSpeed(uint32_t hz)
+{
+    clean_speed_hz = hz;
+}
+
+uint32_t FakeI2C_GetSpeed(void)
+{
+    return speed_hz;
+}
+
+void FakeI2C_SetSink(void (*fn)(uint8_t byte, uint64_t ns))
+{
+    sink = fn;
+}
+
+void FakeI2C_SetReadData(uint8_t byte)
+{
+    port = byte;
+}
+
+void FakeI2C_GetStats(FakeI2C_Stats_t *out)
+{
+    *out = stats;
+}
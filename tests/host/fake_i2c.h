@@ -0,0 +1,47 @@
+/*
+ * fake_i2c.h - Host-side I2C master implementing the frontend I2C API
+ * (frontend/MCAL/i2c.h) on the virtual clock of fake_systick.c
+ *
+ * Link tests/host/fake_i2c.c instead of frontend/MCAL/i2c.c. Every call
+ * advances the clock by the time the transfer takes on the wire at the
+ * speed given to I2C_Init (START, 9 bits per byte including ACK, STOP)
+ * and hands each written byte to the sink with the time its ACK ends,
+ * which is when a PCF8574 updates its outputs. Only the device address
+ * set with FakeI2C_SetDevice ACKs, and only at speeds up to the one set
+ * with FakeI2C_SetMaxSpeed; others fail after the address byte. Reads
+ * return the last byte written, as a PCF8574 returns its pin levels.
+ * I2C_Submit runs the transfer to completion before it returns.
+ */
+
+#ifndef FAKE_I2C_H_
+#define FAKE_I2C_H_
+
+#include <stdint.h>
+#include "../../frontend/MCAL/i2c.h"
+
+typedef struct {
+    uint32_t transactions;      /* START..STOP sequences */
+    uint32_t bytes;             /* Address and data bytes on the wire */
+    uint64_t bus_ns;            /* Time the bus was busy */
+} FakeI2C_Stats_t;
+
+/* Forget the sink and statistics; device address back to 0x27, any
+ * speed accepted and clean, port high */
+void FakeI2C_Reset(void);
+void FakeI2C_SetDevice(uint8_t addr);
+void FakeI2C_SetMaxSpeed(uint32_t hz);
+
+/* Above this speed the address is still ACKed but every data byte
+ * arrives with bit 4 flipped (a marginal backpack) */
+void FakeI2C_SetCleanSpeed(uint32_t hz);
+
+/* Speed given to the last I2C_Init */
+uint32_t FakeI2C_GetSpeed(void);
+void FakeI2C_SetSink(void (*sink)(uint8_t byte, uint64_t ns));
+
+/* Value returned by reads until the next write */
+void FakeI2C_SetReadData(uint8_t byte);
+
+void FakeI2C_GetStats(FakeI2C_Stats_t *stats);
+
+#endif /* FAKE_I2C_H_ */
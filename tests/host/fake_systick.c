@@ -0,0 +1,75 @@
+/*
+ * fake_systick.c - Host-side virtual clock implementing the frontend
+ * SysTick API
+ *
+ * See fake_systick.h.
+ */
+
+#include "fake_systick.h"
+
+static uint64_t now_ns = 0;
+static uint64_t slept_ms = 0;
+
+void SysTick_Init(uint32_t reload, uint8_t mode)
+{
+    (void)reload;
+    (void)mode;
+    now_ns = 0;
+    slept_ms = 0;
+}
+
+void DelayMs(uint32_t ms)
+{
+    now_ns += (uint64_t)ms * 1000000;
+    slept_ms += ms;
+}
+
+void DelayUs(uint32_t us)
+{
+    now_ns += (uint64_t)us * 1000;
+}
+
+uint32_t SysTick_GetMs(void)
+{
+    return (uint32_t)(now_ns / 1000000);
+}
+
+uint64_t SysTick_GetMs64(void)
+{
+    return now_ns / 1000000;
+}
+
+uint64_t SysTick_GetUs(void)
+{
+    return now_ns / 1000;
+}
+
+void FakeSysTick_AdvanceNs(uint64_t ns)
+{
+    now_ns += ns;
+}
+
+void FakeSysTick_AdvanceUs(uint64_t us)
+{
+    now_ns += us * 1000;
+}
+
+void FakeSysTick_AdvanceMs(uint64_t ms)
+{
+    now_ns += ms * 1000000;
+}
+
+void FakeSysTick_SetMs(uint64_t ms)
+{
+    now_ns = ms * 1000000;
+}
+
+uint64_t FakeSysTick_GetNs(void)
+{
+    return now_ns;
+}
+
+uint64_t FakeSysTick_SleptMs(void)
+{
+    return slept_ms;
+}
@@ -0,0 +1,29 @@
+/*
+ * fake_systick.h - Host-side virtual clock implementing the frontend
+ * SysTick API (frontend/MCAL/systick.h)
+ *
+ * Link tests/host/fake_systick.c instead of frontend/MCAL/systick.c when
+ * a test wants time to pass only when it says so. The clock counts
+ * nanoseconds; DelayMs and DelayUs advance it by exactly the requested
+ * amount and return at once, so code that waits runs in virtual time.
+ */
+
+#ifndef FAKE_SYSTICK_H_
+#define FAKE_SYSTICK_H_
+
+#include <stdint.h>
+#include "../../frontend/MCAL/systick.h"
+
+void FakeSysTick_AdvanceNs(uint64_t ns);
+void FakeSysTick_AdvanceUs(uint64_t us);
+void FakeSysTick_AdvanceMs(uint64_t ms);
+
+/* Jump to an absolute time, e.g. just short of the 32-bit ms wrap */
+void FakeSysTick_SetMs(uint64_t ms);
+
+uint64_t FakeSysTick_GetNs(void);
+
+/* Total virtual time spent in DelayMs since SysTick_Init */
+uint64_t FakeSysTick_SleptMs(void);
+
+#endif /* FAKE_SYSTICK_H_ */
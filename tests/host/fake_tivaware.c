@@ -0,0 +1,514 @@
+/*
+ * fake_tivaware.c - Host-side stand-in for the TivaWare driverlib
+ *
+ * See fake_tivaware.h. Peripheral enables and pin muxing are no-ops;
+ * UART1 is backed by a small FIFO model the tests can drive.
+ */
+
+#define _POSIX_C_SOURCE 199309L    /* clock_gettime */
+
+#include "fake_tivaware.h"
+#include <string.h>
+#include <time.h>
+
+/*===========================================================================
+ * Fake UART1 state
+ *===========================================================================*/
+static uint8_t rx_fifo[FAKE_UART_FIFO_SIZE];
+static uint8_t rx_rd = 0;
+static uint8_t rx_count = 0;
+static uint32_t rx_errors = 0;
+static uint32_t int_status = 0;
+static uint32_t int_mask = 0;
+static void (*uart_handler)(void) = 0;
+
+static uint8_t tx_fifo[FAKE_UART_FIFO_SIZE];
+static uint8_t tx_rd = 0;
+static uint8_t tx_count = 0;
+static uint64_t tx_shift_end = 0;   /* Cycle at which the shifter is free */
+
+static uint8_t tx_log[FAKE_UART_TX_LOG_SIZE];
+static uint32_t tx_log_len = 0;
+
+static uint64_t cpu_cycles = 0;
+
+static uint8_t gpio_f_state = 0;
+
+typedef struct {
+    uint32_t config;
+    uint32_t load;
+    bool enabled;
+} fake_timer_t;
+
+static fake_timer_t timers[3];
+
+static uint32_t systick_period = 1;
+static uint32_t adc_noise = 1;
+
+/*===========================================================================
+ * Fake EEPROM state
+ *===========================================================================*/
+static uint32_t eeprom_words[FAKE_EEPROM_WORDS];
+static uint32_t eeprom_block_writes[FAKE_EEPROM_BLOCKS];
+static uint32_t eeprom_block_erases[FAKE_EEPROM_BLOCKS];
+static uint32_t eeprom_word_writes[FAKE_EEPROM_WORDS];
+static FakeEEPROM_Stats_t eeprom_stats;
+static uint32_t eeprom_program_cycles = FAKE_EEPROM_PROGRAM_CYCLES;
+static uint32_t eeprom_fail_status = 0;
+static uint32_t eeprom_corrupt_mask = 0;
+static bool eeprom_erased = false;
+static bool eeprom_power_armed = false;
+static uint32_t eeprom_power_words = 0;    /* Words left before the cut */
+static bool eeprom_power_lost = false;
+
+/*===========================================================================
+ * Virtual clock
+ *===========================================================================*/
+
+/* Shift queued TX bytes out onto the line up to the current cycle */
+static void tx_update(void)
+{
+    while (tx_count > 0 && tx_shift_end <= cpu_cycles)
+    {
+        uint64_t start = tx_shift_end;
+        uint8_t b = tx_fifo[tx_rd];
+        tx_rd = (uint8_t)((tx_rd + 1) % FAKE_UART_FIFO_SIZE);
+        tx_count--;
+        if (tx_log_len < FAKE_UART_TX_LOG_SIZE)
+        {
+            tx_log[tx_log_len++] = b;
+        }
+        tx_shift_end = start + FAKE_UART_BYTE_CYCLES;
+    }
+}
+
+uint64_t FakeCPU_Cycles(void)
+{
+    return cpu_cycles;
+}
+
+void FakeCPU_Advance(uint64_t cycles)
+{
+    cpu_cycles += cycles;
+    tx_update();
+}
+
+static void call_cost(void)
+{
+    FakeCPU_Advance(FAKE_CALL_CYCLES);
+}
+
+/*===========================================================================
+ * sysctl
+ *===========================================================================*/
+void SysCtlPeripheralEnable(uint32_t periph) { (void)periph; }
+bool SysCtlPeripheralReady(uint32_t periph) { (void)periph; return true; }
+uint32_t SysCtlClockGet(void) { call_cost(); return FAKE_SYSTEM_CLOCK; }
+void SysCtlDelay(uint32_t count) { FakeCPU_Advance(3ULL * count); }
+
+/*===========================================================================
+ * gpio
+ *===========================================================================*/
+void GPIOPinConfigure(uint32_t config) { (void)config; }
+void GPIOPinTypeUART(uint32_t port, uint8_t pins) { (void)port; (void)pins; }
+void GPIOPinTypeGPIOOutput(uint32_t port, uint8_t pins) { (void)port; (void)pins; }
+
+void GPIOPinWrite(uint32_t port, uint8_t pins, uint8_t val)
+{
+    call_cost();
+    if (port == GPIO_PORTF_BASE)
+    {
+        gpio_f_state = (uint8_t)((gpio_f_state & ~pins) | (val & pins));
+    }
+}
+
+int32_t GPIOPinRead(uint32_t port, uint8_t pins)
+{
+    return (port == GPIO_PORTF_BASE) ? (gpio_f_state & pins) : 0;
+}
+
+/*===========================================================================
+ * uart
+ *===========================================================================*/
+void UARTConfigSetExpClk(uint32_t base, uint32_t clk, uint32_t baud, uint32_t config)
+{
+    (void)base; (void)clk; (void)baud; (void)config;
+}
+void UARTFIFOEnable(uint32_t base) { (void)base; }
+void UARTFIFOLevelSet(uint32_t base, uint32_t tx_level, uint32_t rx_level)
+{
+    (void)base; (void)tx_level; (void)rx_level;
+}
+void UARTTxIntModeSet(uint32_t base, uint32_t mode) { (void)base; (void)mode; }
+void UARTEnable(uint32_t base) { (void)base; }
+void UARTDisable(uint32_t base) { (void)base; }
+void UARTIntRegister(uint32_t base, void (*handler)(void)) { (void)base; uart_handler = handler; }
+void UARTIntEnable(uint32_t base, uint32_t flags) { (void)base; call_cost(); int_mask |= flags; }
+void UARTIntDisable(uint32_t base, uint32_t flags) { (void)base; call_cost(); int_mask &= ~flags; }
+void UARTIntClear(uint32_t base, uint32_t flags) { (void)base; call_cost(); int_status &= ~flags; }
+
+uint32_t UARTIntStatus(uint32_t base, bool masked)
+{
+    (void)base;
+    call_cost();
+    return masked ? (int_status & int_mask) : int_status;
+}
+
+uint32_t UARTRxErrorGet(uint32_t base) { (void)base; return rx_errors; }
+void UARTRxErrorClear(uint32_t base) { (void)base; rx_errors = 0; }
+
+bool UARTCharsAvail(uint32_t base) { (void)base; return rx_count > 0; }
+
+int32_t UARTCharGetNonBlocking(uint32_t base)
+{
+    (void)base;
+    if (rx_count == 0) return -1;
+    uint8_t b = rx_fifo[rx_rd];
+    rx_rd = (uint8_t)((rx_rd + 1) % FAKE_UART_FIFO_SIZE);
+    rx_count--;
+    return b;
+}
+
+bool UARTSpaceAvail(uint32_t base)
+{
+    (void)base;
+    call_cost();
+    return tx_count < FAKE_UART_FIFO_SIZE;
+}
+
+bool UARTCharPutNonBlocking(uint32_t base, unsigned char data)
+{
+    (void)base;
+    call_cost();
+    if (tx_count >= FAKE_UART_FIFO_SIZE) return false;
+    if (tx_count == 0 && tx_shift_end < cpu_cycles)
+    {
+        tx_shift_end = cpu_cycles;  /* Line was idle - start shifting now */
+    }
+    tx_fifo[(tx_rd + tx_count) % FAKE_UART_FIFO_SIZE] = data;
+    tx_count++;
+    return true;
+}
+
+void UARTCharPut(uint32_t base, unsigned char data)
+{
+    while (!UARTCharPutNonBlocking(base, data)) {}
+}
+
+bool UARTBusy(uint32_t base)
+{
+    (void)base;
+    call_cost();
+    return tx_count > 0 || tx_shift_end > cpu_cycles;
+}
+
+/*===========================================================================
+ * timer
+ *===========================================================================*/
+static fake_timer_t *timer_for(uint32_t base)
+{
+    uint32_t idx = (base - TIMER0_BASE) >> 12;
+    return (idx < 3) ? &timers[idx] : &timers[0];
+}
+
+void TimerConfigure(uint32_t base, uint32_t config) { call_cost(); timer_for(base)->config = config; }
+void TimerIntEnable(uint32_t base, uint32_t flags) { (void)base; (void)flags; call_cost(); }
+void TimerIntDisable(uint32_t base, uint32_t flags) { (void)base; (void)flags; call_cost(); }
+void TimerIntClear(uint32_t base, uint32_t flags) { (void)base; (void)flags; call_cost(); }
+void TimerLoadSet(uint32_t base, uint32_t timer, uint32_t value) { (void)timer; call_cost(); timer_for(base)->load = value; }
+void TimerEnable(uint32_t base, uint32_t timer) { (void)timer; call_cost(); timer_for(base)->enabled = true; }
+void TimerDisable(uint32_t base, uint32_t timer) { (void)timer; call_cost(); timer_for(base)->enabled = false; }
+
+bool FakeTimer_IsEnabled(uint32_t base) { return timer_for(base)->enabled; }
+uint32_t FakeTimer_Load(uint32_t base) { return timer_for(base)->load; }
+uint32_t FakeTimer_Config(uint32_t base) { return timer_for(base)->config; }
+
+/*===========================================================================
+ * interrupt
+ *===========================================================================*/
+void IntEnable(uint32_t interrupt) { (void)interrupt; }
+void IntDisable(uint32_t interrupt) { (void)interrupt; }
+bool IntMasterEnable(void) { return false; }
+bool IntMasterDisable(void) { return false; }
+
+/*===========================================================================
+ * systick
+ *===========================================================================*/
+void SysTickPeriodSet(uint32_t period) { call_cost(); systick_period = period; }
+void SysTickEnable(void) { call_cost(); }
+void SysTickDisable(void) { call_cost(); }
+
+uint32_t SysTickValueGet(void)
+{
+    struct timespec ts;
+    uint64_t ticks;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ticks = (uint64_t)ts.tv_sec * FAKE_SYSTEM_CLOCK +
+            (uint64_t)ts.tv_nsec * (FAKE_SYSTEM_CLOCK / 1000000) / 1000;
+    return systick_period - 1 - (uint32_t)(ticks % systick_period);
+}
+
+/*===========================================================================
+ * adc
+ *===========================================================================*/
+void ADCSequenceConfigure(uint32_t base, uint32_t seq, uint32_t trigger, uint32_t priority)
+{
+    (void)base; (void)seq; (void)trigger; (void)priority; call_cost();
+}
+void ADCSequenceStepConfigure(uint32_t base, uint32_t seq, uint32_t step, uint32_t config)
+{
+    (void)base; (void)seq; (void)step; (void)config; call_cost();
+}
+void ADCSequenceEnable(uint32_t base, uint32_t seq) { (void)base; (void)seq; call_cost(); }
+void ADCSequenceDisable(uint32_t base, uint32_t seq) { (void)base; (void)seq; call_cost(); }
+void ADCProcessorTrigger(uint32_t base, uint32_t seq) { (void)base; (void)seq; call_cost(); }
+uint32_t ADCIntStatus(uint32_t base, uint32_t seq, bool masked)
+{
+    (void)base; (void)seq; (void)masked; call_cost(); return 1;
+}
+void ADCIntClear(uint32_t base, uint32_t seq) { (void)base; (void)seq; call_cost(); }
+
+int32_t ADCSequenceDataGet(uint32_t base, uint32_t seq, uint32_t *buffer)
+{
+    (void)base;
+    (void)seq;
+    call_cost();
+    adc_noise = adc_noise * 1103515245u + 12345u;
+    *buffer = 2048 + ((adc_noise >> 16) & 0x7);
+    return 1;
+}
+
+/*===========================================================================
+ * Test control
+ *===========================================================================*/
+void FakeUART_Reset(void)
+{
+    rx_rd = 0;
+    rx_count = 0;
+    rx_errors = 0;
+    int_status = 0;
+    tx_rd = 0;
+    tx_count = 0;
+    tx_shift_end = cpu_cycles;
+    tx_log_len = 0;
+    memset(tx_log, 0, sizeof(tx_log));
+}
+
+bool FakeUART_RxPush(uint8_t byte)
+{
+    if (rx_count >= FAKE_UART_FIFO_SIZE)
+    {
+        rx_errors |= 0x8;  /* UART_RXERROR_OVERRUN */
+        int_status |= UART_INT_OE;
+        return false;
+    }
+    rx_fifo[(rx_rd + rx_count) % FAKE_UART_FIFO_SIZE] = byte;
+    rx_count++;
+    int_status |= UART_INT_RX;
+    return true;
+}
+
+uint8_t FakeUART_RxLevel(void)
+{
+    return rx_count;
+}
+
+void FakeUART_RaiseRxInterrupt(void)
+{
+    int_status |= UART_INT_RT;
+    if (uart_handler != 0)
+    {
+        uart_handler();
+    }
+}
+
+bool FakeUART_TxInterruptPending(void)
+{
+    return (int_mask & UART_INT_TX) && tx_count <= 2;
+}
+
+void FakeUART_RaiseTxInterrupt(void)
+{
+    int_status |= UART_INT_TX;
+    if (uart_handler != 0)
+    {
+        uart_handler();
+    }
+}
+
+uint8_t FakeGPIO_PortF(void)
+{
+    return gpio_f_state;
+}
+
+uint32_t FakeUART_TxLogLen(void)
+{
+    return tx_log_len;
+}
+
+const uint8_t *FakeUART_TxLog(void)
+{
+    return tx_log;
+}
+
+/*===========================================================================
+ * eeprom
+ *===========================================================================*/
+
+static bool eeprom_block_erased(uint32_t block)
+{
+    for (uint32_t i = 0; i < FAKE_EEPROM_BLOCK_WORDS; i++)
+    {
+        if (eeprom_words[block * FAKE_EEPROM_BLOCK_WORDS + i] != 0xFFFFFFFF)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The part ships erased; static storage starts at zero */
+static void eeprom_power_on(void)
+{
+    if (!eeprom_erased)
+    {
+        FakeEEPROM_Reset();
+    }
+}
+
+uint32_t EEPROMInit(void)
+{
+    call_cost();
+    eeprom_power_on();
+    return EEPROM_INIT_OK;
+}
+
+uint32_t EEPROMSizeGet(void) { call_cost(); return FAKE_EEPROM_WORDS * 4; }
+uint32_t EEPROMBlockCountGet(void) { call_cost(); return FAKE_EEPROM_BLOCKS; }
+
+void EEPROMRead(uint32_t *data, uint32_t address, uint32_t count)
+{
+    uint64_t t0 = cpu_cycles;
+    uint32_t words = count / 4;
+
+    eeprom_power_on();
+    call_cost();
+    for (uint32_t i = 0; i < words; i++)
+    {
+        data[i] = eeprom_words[(address / 4 + i) % FAKE_EEPROM_WORDS];
+    }
+    FakeCPU_Advance((uint64_t)words * FAKE_EEPROM_READ_CYCLES);
+
+    eeprom_stats.read_calls++;
+    eeprom_stats.read_words += words;
+    eeprom_stats.cycles += cpu_cycles - t0;
+}
+
+uint32_t EEPROMProgram(uint32_t *data, uint32_t address, uint32_t count)
+{
+    uint64_t t0 = cpu_cycles;
+    uint32_t words = count / 4;
+    uint32_t status = eeprom_fail_status;
+
+    eeprom_power_on();
+    call_cost();
+    eeprom_stats.program_calls++;
+    eeprom_fail_status = 0;
+    if (eeprom_power_lost)
+    {
+        status = EEPROM_RC_WRBUSY;
+    }
+    if (status == 0)
+    {
+        for (uint32_t i = 0; i < words; i++)
+        {
+            uint32_t w = (address / 4 + i) % FAKE_EEPROM_WORDS;
+            if (eeprom_power_armed && eeprom_power_words-- == 0)
+            {
+                eeprom_power_armed = false;
+                eeprom_power_lost = true;
+                status = EEPROM_RC_WRBUSY;
+                words = i;
+                break;
+            }
+            uint32_t block = w / FAKE_EEPROM_BLOCK_WORDS;
+            bool was_erased = eeprom_words[w] == 0xFFFFFFFF;
+            eeprom_words[w] = data[i] ^ eeprom_corrupt_mask;
+            eeprom_word_writes[w]++;
+            eeprom_block_writes[block]++;
+            if (!was_erased && eeprom_words[w] == 0xFFFFFFFF && eeprom_block_erased(block))
+            {
+                eeprom_block_erases[block]++;
+            }
+        }
+        FakeCPU_Advance((uint64_t)words * eeprom_program_cycles);
+        eeprom_stats.program_words += words;
+    }
+    eeprom_corrupt_mask = 0;
+    eeprom_stats.cycles += cpu_cycles - t0;
+    return status;
+}
+
+void FakeEEPROM_Reset(void)
+{
+    memset(eeprom_words, 0xFF, sizeof(eeprom_words));
+    memset(eeprom_block_writes, 0, sizeof(eeprom_block_writes));
+    memset(eeprom_block_erases, 0, sizeof(eeprom_block_erases));
+    memset(eeprom_word_writes, 0, sizeof(eeprom_word_writes));
+    memset(&eeprom_stats, 0, sizeof(eeprom_stats));
+    eeprom_program_cycles = FAKE_EEPROM_PROGRAM_CYCLES;
+    eeprom_fail_status = 0;
+    eeprom_corrupt_mask = 0;
+    eeprom_power_armed = false;
+    eeprom_power_lost = false;
+    eeprom_erased = true;
+}
+
+void FakeEEPROM_GetStats(FakeEEPROM_Stats_t *stats) { *stats = eeprom_stats; }
+void FakeEEPROM_ClearStats(void) { memset(&eeprom_stats, 0, sizeof(eeprom_stats)); }
+
+uint32_t FakeEEPROM_Peek(uint32_t address)
+{
+    eeprom_power_on();
+    return eeprom_words[(address / 4) % FAKE_EEPROM_WORDS];
+}
+
+void FakeEEPROM_Poke(uint32_t address, uint32_t value)
+{
+    eeprom_power_on();
+    eeprom_words[(address / 4) % FAKE_EEPROM_WORDS] = value;
+}
+
+uint32_t FakeEEPROM_BlockWrites(uint32_t block)
+{
+    return block < FAKE_EEPROM_BLOCKS ? eeprom_block_writes[block] : 0;
+}
+
+uint32_t FakeEEPROM_BlockErases(uint32_t block)
+{
+    return block < FAKE_EEPROM_BLOCKS ? eeprom_block_erases[block] : 0;
+}
+
+uint32_t FakeEEPROM_WordWrites(uint32_t address)
+{
+    return eeprom_word_writes[(address / 4) % FAKE_EEPROM_WORDS];
+}
+
+void FakeEEPROM_SetProgramCycles(uint32_t cycles_per_word) { eeprom_program_cycles = cycles_per_word; }
+void FakeEEPROM_FailNextProgram(uint32_t status) { eeprom_fail_status = status; }
+void FakeEEPROM_CorruptNextProgram(uint32_t mask) { eeprom_corrupt_mask = mask; }
+
+void FakeEEPROM_PowerFailAfter(uint32_t words)
+{
+    eeprom_power_armed = true;
+    eeprom_power_words = words;
+}
+
+bool FakeEEPROM_PowerLost(void) { return eeprom_power_lost; }
+
+void FakeEEPROM_PowerRestore(void)
+{
+    eeprom_power_armed = false;
+    eeprom_power_lost = false;
+}
@@ -0,0 +1,297 @@
+/*
+ * fake_tivaware.h - Host-side stand-in for the TivaWare driverlib
+ *
+ * Lets backend sources that include "driverlib/..." and "inc/..." compile
+ * and run on a PC. Only the calls the backend actually uses are modelled.
+ * The headers under tivaware/ simply include this file, so add
+ * "-I tests/host -I tests/host/tivaware" to the host compile line.
+ */
+
+#ifndef FAKE_TIVAWARE_H_
+#define FAKE_TIVAWARE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*===========================================================================
+ * inc/hw_memmap.h, inc/hw_ints.h, inc/hw_types.h
+ *===========================================================================*/
+#define UART0_BASE              0x4000C000
+#define UART1_BASE              0x4000D000
+#define GPIO_PORTA_BASE         0x40004000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTF_BASE         0x40025000
+#define TIMER0_BASE             0x40030000
+#define TIMER1_BASE             0x40031000
+#define TIMER2_BASE             0x40032000
+#define ADC0_BASE               0x40038000
+
+#define INT_UART1               22
+#define INT_TIMER0A             35
+#define INT_TIMER1A             37
+#define INT_TIMER2A             39
+
+#define HWREG(x)                (*((volatile uint32_t *)(x)))
+
+/*===========================================================================
+ * driverlib/sysctl.h
+ *===========================================================================*/
+#define SYSCTL_PERIPH_ADC0      0xf0003800
+#define SYSCTL_PERIPH_EEPROM0   0xf0005800
+#define SYSCTL_PERIPH_GPIOA     0xf0000800
+#define SYSCTL_PERIPH_GPIOB     0xf0000801
+#define SYSCTL_PERIPH_GPIOF     0xf0000805
+#define SYSCTL_PERIPH_TIMER0    0xf0000400
+#define SYSCTL_PERIPH_TIMER1    0xf0000401
+#define SYSCTL_PERIPH_TIMER2    0xf0000402
+#define SYSCTL_PERIPH_UART0     0xf0001800
+#define SYSCTL_PERIPH_UART1     0xf0001801
+
+#define FAKE_SYSTEM_CLOCK       16000000UL
+
+void SysCtlPeripheralEnable(uint32_t periph);
+bool SysCtlPeripheralReady(uint32_t periph);
+uint32_t SysCtlClockGet(void);
+void SysCtlDelay(uint32_t count);
+
+/*===========================================================================
+ * driverlib/gpio.h, driverlib/pin_map.h
+ *===========================================================================*/
+#define GPIO_PIN_0              0x01
+#define GPIO_PIN_1              0x02
+#define GPIO_PIN_2              0x04
+#define GPIO_PIN_3              0x08
+#define GPIO_PIN_4              0x10
+#define GPIO_PIN_5              0x20
+#define GPIO_PIN_6              0x40
+#define GPIO_PIN_7              0x80
+
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PB0_U1RX           0x00010001
+#define GPIO_PB1_U1TX           0x00010401
+
+void GPIOPinConfigure(uint32_t config);
+void GPIOPinTypeUART(uint32_t port, uint8_t pins);
+void GPIOPinTypeGPIOOutput(uint32_t port, uint8_t pins);
+void GPIOPinWrite(uint32_t port, uint8_t pins, uint8_t val);
+int32_t GPIOPinRead(uint32_t port, uint8_t pins);
+
+/*===========================================================================
+ * driverlib/uart.h
+ *===========================================================================*/
+#define UART_INT_OE             0x400
+#define UART_INT_BE             0x200
+#define UART_INT_PE             0x100
+#define UART_INT_FE             0x080
+#define UART_INT_RT             0x040
+#define UART_INT_TX             0x020
+#define UART_INT_RX             0x010
+
+#define UART_CONFIG_WLEN_8      0x00000060
+#define UART_CONFIG_STOP_ONE    0x00000000
+#define UART_CONFIG_PAR_NONE    0x00000000
+
+#define UART_FIFO_TX1_8         0x00000000
+#define UART_FIFO_TX2_8         0x00000001
+#define UART_FIFO_TX4_8         0x00000002
+#define UART_FIFO_RX1_8         0x00000000
+#define UART_FIFO_RX4_8         0x00000010
+
+#define UART_TXINT_MODE_FIFO    0x00000000
+#define UART_TXINT_MODE_EOT     0x00000010
+
+void UARTConfigSetExpClk(uint32_t base, uint32_t clk, uint32_t baud, uint32_t config);
+void UARTFIFOEnable(uint32_t base);
+void UARTFIFOLevelSet(uint32_t base, uint32_t tx_level, uint32_t rx_level);
+void UARTTxIntModeSet(uint32_t base, uint32_t mode);
+void UARTEnable(uint32_t base);
+void UARTDisable(uint32_t base);
+void UARTIntRegister(uint32_t base, void (*handler)(void));
+void UARTIntEnable(uint32_t base, uint32_t flags);
+void UARTIntDisable(uint32_t base, uint32_t flags);
+void UARTIntClear(uint32_t base, uint32_t flags);
+uint32_t UARTIntStatus(uint32_t base, bool masked);
+uint32_t UARTRxErrorGet(uint32_t base);
+void UARTRxErrorClear(uint32_t base);
+bool UARTCharsAvail(uint32_t base);
+int32_t UARTCharGetNonBlocking(uint32_t base);
+bool UARTSpaceAvail(uint32_t base);
+bool UARTCharPutNonBlocking(uint32_t base, unsigned char data);
+void UARTCharPut(uint32_t base, unsigned char data);
+bool UARTBusy(uint32_t base);
+
+/*===========================================================================
+ * driverlib/timer.h
+ *===========================================================================*/
+#define TIMER_CFG_ONE_SHOT      0x00000021
+#define TIMER_CFG_PERIODIC      0x00000022
+#define TIMER_TIMA_TIMEOUT      0x00000001
+#define TIMER_TIMB_TIMEOUT      0x00000100
+#define TIMER_A                 0x000000ff
+#define TIMER_B                 0x0000ff00
+#define TIMER_BOTH              0x0000ffff
+
+void TimerConfigure(uint32_t base, uint32_t config);
+void TimerIntEnable(uint32_t base, uint32_t flags);
+void TimerIntDisable(uint32_t base, uint32_t flags);
+void TimerIntClear(uint32_t base, uint32_t flags);
+void TimerLoadSet(uint32_t base, uint32_t timer, uint32_t value);
+void TimerEnable(uint32_t base, uint32_t timer);
+void TimerDisable(uint32_t base, uint32_t timer);
+
+/*===========================================================================
+ * driverlib/interrupt.h
+ *===========================================================================*/
+void IntEnable(uint32_t interrupt);
+void IntDisable(uint32_t interrupt);
+bool IntMasterEnable(void);
+bool IntMasterDisable(void);
+
+/*===========================================================================
+ * driverlib/systick.h
+ *
+ * SysTick counts down at FAKE_SYSTEM_CLOCK against the host's monotonic
+ * clock, not the virtual one, so code timed with it (the PIN hash
+ * calibration) sees the real cost of pure computation on the host.
+ *===========================================================================*/
+void SysTickPeriodSet(uint32_t period);
+void SysTickEnable(void);
+void SysTickDisable(void);
+uint32_t SysTickValueGet(void);
+
+/*===========================================================================
+ * driverlib/adc.h
+ *
+ * Processor-triggered conversions complete at once; every sample reads
+ * mid-scale plus a few LSBs of pseudo-random noise.
+ *===========================================================================*/
+#define ADC_TRIGGER_PROCESSOR   0x00000000
+#define ADC_CTL_TS              0x00000080
+#define ADC_CTL_IE              0x00000040
+#define ADC_CTL_END             0x00000020
+
+void ADCSequenceConfigure(uint32_t base, uint32_t seq, uint32_t trigger, uint32_t priority);
+void ADCSequenceStepConfigure(uint32_t base, uint32_t seq, uint32_t step, uint32_t config);
+void ADCSequenceEnable(uint32_t base, uint32_t seq);
+void ADCSequenceDisable(uint32_t base, uint32_t seq);
+void ADCProcessorTrigger(uint32_t base, uint32_t seq);
+uint32_t ADCIntStatus(uint32_t base, uint32_t seq, bool masked);
+void ADCIntClear(uint32_t base, uint32_t seq);
+int32_t ADCSequenceDataGet(uint32_t base, uint32_t seq, uint32_t *buffer);
+
+/*===========================================================================
+ * driverlib/eeprom.h
+ *===========================================================================*/
+#define EEPROM_INIT_OK          0
+#define EEPROM_INIT_ERROR       2
+#define EEPROM_RC_WRBUSY        0x00000020
+#define EEPROM_RC_NOPERM        0x00000010
+#define EEPROM_RC_WKCOPY        0x00000008
+#define EEPROM_RC_WKERASE       0x00000004
+#define EEPROM_RC_WORKING       0x00000001
+
+uint32_t EEPROMInit(void);
+uint32_t EEPROMSizeGet(void);
+uint32_t EEPROMBlockCountGet(void);
+void EEPROMRead(uint32_t *data, uint32_t address, uint32_t count);
+uint32_t EEPROMProgram(uint32_t *data, uint32_t address, uint32_t count);
+
+/*===========================================================================
+ * Virtual CPU clock
+ *
+ * Every fake driverlib call costs FAKE_CALL_CYCLES, SysCtlDelay(n) costs
+ * 3*n as on the real part. Peripherals advance against this clock.
+ *===========================================================================*/
+#define FAKE_CALL_CYCLES        12
+
+uint64_t FakeCPU_Cycles(void);
+void FakeCPU_Advance(uint64_t cycles);
+
+/*===========================================================================
+ * Fake UART1 model (test control)
+ *
+ * RX: a 16-byte hardware FIFO. FakeUART_RxPush() stands in for the line;
+ * a push into a full FIFO is an overrun and sets the OE error flag.
+ * TX: a 16-byte FIFO shifted out at 115200 baud against the virtual clock.
+ * Every byte that reaches the line is appended to a capture log. The TX
+ * interrupt is raised while the FIFO is at or below 2 bytes (TX1_8).
+ *===========================================================================*/
+#define FAKE_UART_FIFO_SIZE     16
+#define FAKE_UART_TX_LOG_SIZE   4096
+#define FAKE_UART_BYTE_CYCLES   (FAKE_SYSTEM_CLOCK / 11520)  /* 10 bits @115200 */
+
+void FakeUART_Reset(void);
+bool FakeUART_RxPush(uint8_t byte);
+uint8_t FakeUART_RxLevel(void);
+void FakeUART_RaiseRxInterrupt(void);
+bool FakeUART_TxInterruptPending(void);
+void FakeUART_RaiseTxInterrupt(void);
+uint32_t FakeUART_TxLogLen(void);
+const uint8_t *FakeUART_TxLog(void);
+
+/*===========================================================================
+ * Fake GPTM model (test control)
+ *
+ * Timers do not count on their own; tests read back the programmed load
+ * value and call the matching TimerNA_Handler to simulate a timeout.
+ *===========================================================================*/
+bool FakeTimer_IsEnabled(uint32_t base);
+uint32_t FakeTimer_Load(uint32_t base);
+uint32_t FakeTimer_Config(uint32_t base);
+
+/*===========================================================================
+ * Fake EEPROM model (test control)
+ *
+ * 2 KB in 32 blocks of 16 words (FAKE_EEPROM_WORDS), erased to 0xFFFFFFFF. Reads cost
+ * FAKE_EEPROM_READ_CYCLES per word; each programmed word costs the
+ * program time (default FAKE_EEPROM_PROGRAM_CYCLES, about 110 us - an
+ * assumption, the datasheet only gives a maximum). Every call and word
+ * is counted. For wear, programmed words are tallied per word and per
+ * block, and a block counts one erase each time programming returns all
+ * of its words to 0xFFFFFFFF.
+ *===========================================================================*/
+#ifndef FAKE_EEPROM_WORDS
+#define FAKE_EEPROM_WORDS           512     /* Override to model a larger part */
+#endif
+#define FAKE_EEPROM_BLOCK_WORDS     16
+#define FAKE_EEPROM_BLOCKS          (FAKE_EEPROM_WORDS / FAKE_EEPROM_BLOCK_WORDS)
+#define FAKE_EEPROM_READ_CYCLES     4
+#define FAKE_EEPROM_PROGRAM_CYCLES  1760
+
+typedef struct
+{
+    uint32_t read_calls;
+    uint32_t read_words;
+    uint32_t program_calls;
+    uint32_t program_words;
+    uint64_t cycles;            /* Virtual clock spent inside the calls */
+} FakeEEPROM_Stats_t;
+
+void FakeEEPROM_Reset(void);                /* Erase all, clear stats */
+void FakeEEPROM_GetStats(FakeEEPROM_Stats_t *stats);
+void FakeEEPROM_ClearStats(void);
+uint32_t FakeEEPROM_Peek(uint32_t address);
+void FakeEEPROM_Poke(uint32_t address, uint32_t value);
+uint32_t FakeEEPROM_BlockWrites(uint32_t block);
+uint32_t FakeEEPROM_BlockErases(uint32_t block);
+uint32_t FakeEEPROM_WordWrites(uint32_t address);
+void FakeEEPROM_SetProgramCycles(uint32_t cycles_per_word);
+/* Next EEPROMProgram returns status without writing anything */
+void FakeEEPROM_FailNextProgram(uint32_t status);
+/* Next EEPROMProgram reports success but stores each word XOR mask */
+void FakeEEPROM_CorruptNextProgram(uint32_t mask);
+/* Power fails after this many more words are programmed. Words are
+ * programmed atomically, so the interrupted call leaves a prefix of its
+ * words written and returns EEPROM_RC_WRBUSY; every later program fails
+ * the same way, writing nothing, until PowerRestore (or Reset). */
+void FakeEEPROM_PowerFailAfter(uint32_t words);
+bool FakeEEPROM_PowerLost(void);
+void FakeEEPROM_PowerRestore(void);
+
+/*===========================================================================
+ * Fake GPIO port F (status LEDs)
+ *===========================================================================*/
+uint8_t FakeGPIO_PortF(void);
+
+#endif /* FAKE_TIVAWARE_H_ */
@@ -0,0 +1,1264 @@
+/*
+ * fake_tm4c123.c - Host-side stand-in for the frontend's register-level
+ * hardware access
+ *
+ * See fake_tm4c123.h. Build with -include tests/host/fake_tm4c123.h like
+ * the frontend sources it serves.
+ */
+
+#include "fake_tm4c123.h"
+#include <intrinsics.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE     MAP_FIXED
+#endif
+
+#define PERIPH_BASE             0x40000000UL
+#define PERIPH_SIZE             0x00100000UL
+#define SCS_BASE                0xE000E000UL
+#define SCS_SIZE                0x00001000UL
+
+#define RX_SCHEDULE_SIZE        4096
+#define RT_CYCLES               (32 * FAKE_TM4C_BIT_CYCLES)
+#define DR_PEEK_MARK            0x80000000UL    /* Never set by a write */
+#define UART1_IRQ_BIT           (1UL << 6)
+#define I2C0_IRQ_BIT            (1UL << 8)
+#define MCS_PEEK_MARK           0x80000000UL    /* Never set by a command */
+#define PB_PEEK_MARK            0x80000000UL    /* Never set by a write */
+#define PB_SCL                  (1UL << 2)
+#define PB_SDA                  (1UL << 3)
+#define GPIO_PEEK_MARK          0x80000000UL    /* Never set by a write */
+#define PORTC_IRQ_BIT           (1UL << 2)
+#define KP_ROWS                 0xF0UL          /* PC4-PC7 */
+#define TIMER1A_IRQ_BIT         (1UL << 21)
+#define TCTL_PEEK_MARK          0x80000000UL    /* Never set by a write */
+#define KP_SCRIPT_SIZE          256
+#define NVIC_PEEK_MARK          0x80000000UL    /* IRQ 31 is never used */
+#define ADC0SS3_IRQ_BIT         (1UL << 17)
+#define ADC_PEEK_MARK           0x80000000UL    /* Never set by a write */
+#define WFI_MAX_CYCLES          (FAKE_TM4C_CLOCK * 10)
+
+/* Handlers live in the frontend sources a test links, if any */
+extern void SystickHandler(void) __attribute__((weak));
+extern void UART1Handler(void) __attribute__((weak));
+extern void I2C0Handler(void) __attribute__((weak));
+extern void GPIOPortCHandler(void) __attribute__((weak));
+extern void Timer1AHandler(void) __attribute__((weak));
+extern void ADC0SS3Handler(void) __attribute__((weak));
+
+uint32_t FakeTM4C_AccessCycles = 4;
+
+static uint64_t cycles = 0;
+static uint64_t sleep_cycles = 0;
+static bool primask = false;
+static bool in_isr = false;
+
+static uint64_t systick_next = 0;       /* 0 = not running */
+
+/* Interrupt enables; EN0 writes set bits, DIS0 writes clear them */
+static uint32_t nvic_en = 0;
+static volatile uint32_t en0_cell, dis0_cell;
+static bool en0_pending = false, dis0_pending = false;
+
+/*===========================================================================
+ * UART1 state
+ *===========================================================================*/
+static struct { uint8_t byte; uint64_t at; } rx_sched[RX_SCHEDULE_SIZE];
+static uint32_t rx_sched_rd = 0, rx_sched_wr = 0;
+
+static uint8_t rx_fifo[FAKE_TM4C_UART_FIFO];
+static uint8_t rx_rd = 0, rx_level = 0;
+static uint64_t rx_last_arrival = 0;
+static uint32_t rx_overruns = 0;
+
+static uint8_t tx_fifo[FAKE_TM4C_UART_FIFO];
+static uint8_t tx_rd = 0, tx_level = 0;
+static uint64_t tx_done = 0;            /* Cycle the byte in the shifter ends */
+static void (*tx_sink)(uint8_t byte, uint64_t cycle) = NULL;
+
+static volatile uint32_t dr_cell;
+static volatile uint32_t fr_cell;
+static volatile uint32_t st_current_cell;
+static uint32_t dr_peeked;
+static bool dr_pending = false;
+
+/*===========================================================================
+ * I2C0 state
+ *===========================================================================*/
+static struct {
+    uint8_t device;
+    void (*sink)(uint8_t byte, uint64_t cycle);
+    const uint8_t *read_data;
+    uint32_t read_len, read_pos;
+    uint32_t nack_in;           /* 0 = never */
+
+    bool held;                  /* START sent, no STOP yet */
+    bool reading;               /* Direction of the current transaction */
+    bool addr_ok;
+    bool busy;
+    uint64_t done;              /* Cycle the command ends */
+    uint64_t latch;             /* Cycle the written byte's ACK ends */
+    uint32_t status;            /* Status bits once done */
+    bool has_out;
+    uint8_t out;
+    bool has_in;
+    uint8_t in;
+    FakeTM4C_I2CStats_t stats;
+} i2c;
+
+static volatile uint32_t mcs_cell;
+static uint32_t mcs_peeked;
+static bool mcs_pending = false;
+
+/* PB2 (SCL) / PB3 (SDA) lines */
+static struct {
+    uint32_t latch;             /* Last value written to DATA */
+    uint32_t levels;            /* PB_SCL / PB_SDA high on the wire */
+    uint32_t sda_hold;          /* SCL clocks until the slave lets go of SDA */
+    bool scl_hold;
+} pb;
+
+static volatile uint32_t pb_cell;
+static uint32_t pb_peeked;
+static bool pb_pending = false;
+
+/*===========================================================================
+ * Keypad matrix and Timer1A state
+ *===========================================================================*/
+
+/* DATA of ports A (columns PA2-PA4) and C (rows PC4-PC7) */
+typedef struct {
+    volatile uint32_t cell;
+    uint32_t peeked;
+    bool pending;
+    uint32_t latch;             /* Last value written to DATA */
+} gpio_data_t;
+
+static gpio_data_t pa, pc;
+
+static struct {
+    uint16_t down;              /* Bit row * 4 + col */
+    uint32_t rows;              /* KP_ROWS bits high on the wire */
+    uint32_t edges;
+} kp;
+
+static struct { uint16_t bit; bool down; uint64_t at; } kp_script[KP_SCRIPT_SIZE];
+static uint32_t kp_script_rd = 0, kp_script_wr = 0;
+
+static struct {
+    volatile uint32_t cell;
+    uint32_t peeked;
+    bool pending;
+    uint32_t ctl;
+    bool running;
+    uint64_t next;              /* Cycle of the next time-out */
+    uint32_t timeouts;
+} t1;
+
+/*===========================================================================
+ * ADC0 SS3 and Timer0A state
+ *===========================================================================*/
+static struct {
+    volatile uint32_t cell;
+    uint32_t peeked;
+    bool pending;
+    uint32_t ctl;
+    bool running;
+    uint64_t next;              /* Cycle of the next time-out */
+} t0;
+
+static struct {
+    FakeTM4C_AdcSource_t source;
+    bool busy;
+    uint64_t done;              /* Cycle the sample being converted ends */
+    uint16_t result;
+    bool fifo_full;
+    uint16_t fifo;
+    uint32_t ris;
+    FakeTM4C_AdcStats_t stats;
+} adc;
+
+static volatile uint32_t adc_ris_cell, adc_fifo_cell, adc_fstat_cell;
+static volatile uint32_t pssi_cell;
+static bool pssi_pending = false;
+
+/*===========================================================================
+ * Peripheral models
+ *===========================================================================*/
+static void uart_update(void)
+{
+    while (rx_sched_rd != rx_sched_wr && rx_sched[rx_sched_rd % RX_SCHEDULE_SIZE].at <= cycles)
+    {
+        uint8_t b = rx_sched[rx_sched_rd % RX_SCHEDULE_SIZE].byte;
+        rx_last_arrival = rx_sched[rx_sched_rd % RX_SCHEDULE_SIZE].at;
+        rx_sched_rd++;
+        if (rx_level == FAKE_TM4C_UART_FIFO)
+        {
+            rx_overruns++;
+            continue;
+        }
+        rx_fifo[(rx_rd + rx_level) % FAKE_TM4C_UART_FIFO] = b;
+        rx_level++;
+    }
+
+    while (tx_level > 0 && tx_done <= cycles)
+    {
+        uint8_t b = tx_fifo[tx_rd];
+        uint64_t done = tx_done;
+        tx_rd = (uint8_t)((tx_rd + 1) % FAKE_TM4C_UART_FIFO);
+        tx_level--;
+        if (tx_level > 0)
+        {
+            tx_done += FAKE_TM4C_BYTE_CYCLES;
+        }
+        if (tx_sink != NULL)
+        {
+            tx_sink(b, done);
+        }
+    }
+}
+
+/* A GPIO output pin driving its line low */
+static bool pb_drives_low(uint32_t pin)
+{
+    return (GPIO_PORTB_AFSEL_R & pin) == 0 && (GPIO_PORTB_DIR_R & pin) != 0 &&
+           (pb.latch & pin) == 0;
+}
+
+static uint32_t pb_wire(void)
+{
+    uint32_t levels = PB_SCL | PB_SDA;
+
+    if (pb.scl_hold || pb_drives_low(PB_SCL)) levels &= ~PB_SCL;
+    if (pb.sda_hold > 0 || pb_drives_low(PB_SDA)) levels &= ~PB_SDA;
+    return levels;
+}
+
+/* Follow the lines after a pin change, counting GPIO clocks and STOPs */
+static void pb_update(void)
+{
+    uint32_t before = pb.levels;
+    uint32_t now = pb_wire();
+    bool gpio = (GPIO_PORTB_AFSEL_R & (PB_SCL | PB_SDA)) == 0;
+
+    if (gpio && !(before & PB_SCL) && (now & PB_SCL))
+    {
+        i2c.stats.gpio_clocks++;
+        if (pb.sda_hold > 0 && --pb.sda_hold == 0) now = pb_wire();
+    }
+    else if (gpio && (before & now & PB_SCL) && !(before & PB_SDA) && (now & PB_SDA))
+    {
+        i2c.stats.gpio_stops++;
+    }
+    pb.levels = now;
+}
+
+/* SYSCTL_SRI2C bit 0 holds the module in reset */
+static void i2c_reset(void)
+{
+    i2c.held = false;
+    i2c.busy = false;
+    i2c.status = 0;
+    i2c.has_out = i2c.has_in = false;
+    I2C0_MCR_R = 0;
+    I2C0_MTPR_R = 1;
+    I2C0_MIMR_R = 0;
+    I2C0_MRIS_R = 0;
+}
+
+static void i2c_update(void)
+{
+    if (SYSCTL_SRI2C_R & 1)
+    {
+        i2c_reset();
+    }
+    if (I2C0_MICR_R & 1)
+    {
+        I2C0_MRIS_R &= ~1UL;
+        I2C0_MICR_R = 0;
+    }
+    if (i2c.busy && i2c.done <= cycles)
+    {
+        i2c.busy = false;
+        if (i2c.has_out && i2c.sink != NULL) i2c.sink(i2c.out, i2c.latch);
+        if (i2c.has_in) I2C0_MDR_R = i2c.in;
+        I2C0_MRIS_R |= 1;
+    }
+    I2C0_MMIS_R = I2C0_MRIS_R & I2C0_MIMR_R;
+}
+
+static bool i2c_irq_pending(void)
+{
+    return (nvic_en & I2C0_IRQ_BIT) && (I2C0_MRIS_R & I2C0_MIMR_R & 1);
+}
+
+/* A command written to MCS */
+static void i2c_command(uint32_t cmd)
+{
+    uint64_t bit = 20ULL * ((I2C0_MTPR_R & 0x7F) + 1);
+    uint32_t bits = 0;
+
+    i2c.status = 0;
+    i2c.has_out = i2c.has_in = false;
+
+    if (cmd & I2C_MCS_RUN)
+    {
+        if (cmd & I2C_MCS_START)
+        {
+            i2c.stats.starts++;
+            i2c.stats.bytes++;
+            i2c.held = true;
+            i2c.reading = (I2C0_MSA_R & 1) != 0;
+            i2c.addr_ok = ((I2C0_MSA_R >> 1) & 0x7F) == i2c.device;
+            bits += 10;
+            if (pb.scl_hold)
+            {
+                /* Waits for SCL for ever */
+                i2c.stats.busy_cycles += bit;
+                i2c.busy = true;
+                i2c.done = UINT64_MAX;
+                I2C0_MRIS_R &= ~1UL;
+                return;
+            }
+            if (pb.sda_hold > 0)
+            {
+                /* SDA never rises: gives up after the first bit */
+                i2c.held = false;
+                i2c.status = I2C_MCS_ERROR | I2C_MCS_ARBLST;
+                bits = 1;
+            }
+            else if (!i2c.addr_ok)
+            {
+                i2c.status = I2C_MCS_ERROR | I2C_MCS_ADRACK;
+            }
+        }
+        else if (!i2c.held)
+        {
+            i2c.status = I2C_MCS_ERROR;     /* No transaction to continue */
+        }
+
+        if (i2c.status == 0)
+        {
+            bits += 9;
+            i2c.stats.bytes++;
+            if (i2c.reading)
+            {
+                i2c.has_in = true;
+                i2c.in = i2c.read_len ? i2c.read_data[i2c.read_pos++ % i2c.read_len] : 0xFF;
+            }
+            else
+            {
+                i2c.has_out = true;
+                i2c.out = (uint8_t)I2C0_MDR_R;
+                i2c.latch = cycles + bits * bit;
+                if (i2c.nack_in > 0 && --i2c.nack_in == 0)
+                {
+                    i2c.status = I2C_MCS_ERROR | I2C_MCS_DATACK;
+                }
+            }
+        }
+    }
+
+    /* STOP goes out if asked for, even after an error */
+    if ((cmd & I2C_MCS_STOP) && i2c.held)
+    {
+        bits += 1;
+        i2c.held = false;
+    }
+    if (bits == 0) bits = 1;
+
+    i2c.busy = true;
+    i2c.done = cycles + bits * bit;
+    i2c.stats.busy_cycles += bits * bit;
+    I2C0_MRIS_R &= ~1UL;
+}
+
+/* A column driven low as a GPIO output: col 0 = PB6, 1-3 = PA4, PA3, PA2 */
+static bool kp_col_low(uint8_t col)
+{
+    static const uint8_t pins[4] = {6, 4, 3, 2};
+    uint32_t pin = 1UL << pins[col];
+
+    if (col == 0)
+    {
+        return (GPIO_PORTB_AFSEL_R & pin) == 0 && (GPIO_PORTB_DIR_R & pin) != 0 &&
+               (pb.latch & pin) == 0;
+    }
+    return (GPIO_PORTA_AFSEL_R & pin) == 0 && (GPIO_PORTA_DIR_R & pin) != 0 &&
+           (pa.latch & pin) == 0;
+}
+
+/* Keys join rows and columns into nets; with no diodes a row reads low
+ * if its net reaches a column driven low, so three keys on the corners of
+ * a rectangle make the fourth look pressed (low wins a fight with a
+ * column driven high) */
+static uint32_t kp_wire(void)
+{
+    uint32_t rows = KP_ROWS;
+    uint8_t net[4];
+    uint8_t low = 0;
+    bool merged;
+
+    for (uint8_t r = 0; r < 4; r++) net[r] = (uint8_t)((kp.down >> (r * 4)) & 0x0F);
+    do
+    {
+        merged = false;
+        for (uint8_t a = 0; a < 4; a++)
+        {
+            for (uint8_t b = 0; b < 4; b++)
+            {
+                if (a != b && (net[a] & net[b]) && net[a] != (net[a] | net[b]))
+                {
+                    net[a] |= net[b];
+                    merged = true;
+                }
+            }
+        }
+    } while (merged);
+
+    for (uint8_t c = 0; c < 4; c++)
+    {
+        if (kp_col_low(c)) low |= (uint8_t)(1U << c);
+    }
+    for (uint8_t r = 0; r < 4; r++)
+    {
+        if (net[r] & low) rows &= ~(1UL << (4 + r));
+    }
+    return rows;
+}
+
+/* Follow the rows after a pin or key change, latching the edges port C
+ * is configured for */
+static void kp_update(void)
+{
+    uint32_t now = kp_wire();
+    uint32_t fell = kp.rows & ~now;
+    uint32_t rose = ~kp.rows & now & KP_ROWS;
+    uint32_t ibe = GPIO_PORTC_IBE_R, iev = GPIO_PORTC_IEV_R;
+    uint32_t detect = (ibe & (fell | rose)) | (~ibe & iev & rose) | (~ibe & ~iev & fell);
+
+    detect &= ~GPIO_PORTC_IS_R & KP_ROWS;
+    if (detect)
+    {
+        GPIO_PORTC_RIS_R |= detect;
+        kp.edges += (uint32_t)__builtin_popcount(detect);
+    }
+    kp.rows = now;
+}
+
+static void gpio_update(void)
+{
+    while (kp_script_rd != kp_script_wr && kp_script[kp_script_rd % KP_SCRIPT_SIZE].at <= cycles)
+    {
+        uint16_t bit = kp_script[kp_script_rd % KP_SCRIPT_SIZE].bit;
+        if (kp_script[kp_script_rd % KP_SCRIPT_SIZE].down) kp.down |= bit;
+        else kp.down &= (uint16_t)~bit;
+        kp_script_rd++;
+        kp_update();
+    }
+    kp_update();
+    if (GPIO_PORTC_ICR_R)
+    {
+        GPIO_PORTC_RIS_R &= ~GPIO_PORTC_ICR_R;
+        GPIO_PORTC_ICR_R = 0;
+    }
+    GPIO_PORTC_MIS_R = GPIO_PORTC_RIS_R & GPIO_PORTC_IM_R;
+}
+
+static bool portc_irq_pending(void)
+{
+    return (nvic_en & PORTC_IRQ_BIT) && (GPIO_PORTC_RIS_R & GPIO_PORTC_IM_R & 0xFF);
+}
+
+static void timer1_update(void)
+{
+    uint64_t period = (uint64_t)TIMER1_TAILR_R + 1;
+
+    while (t1.running && t1.next <= cycles)
+    {
+        TIMER1_RIS_R |= TIMER_RIS_TATORIS;
+        t1.timeouts++;
+        t1.next += period;
+    }
+    if (TIMER1_ICR_R & TIMER_ICR_TATOCINT)
+    {
+        TIMER1_RIS_R &= ~(uint32_t)TIMER_RIS_TATORIS;
+        TIMER1_ICR_R = 0;
+    }
+    TIMER1_MIS_R = TIMER1_RIS_R & TIMER1_IMR_R;
+}
+
+static bool timer1_irq_pending(void)
+{
+    return (nvic_en & TIMER1A_IRQ_BIT) && (TIMER1_RIS_R & TIMER1_IMR_R & TIMER_RIS_TATORIS);
+}
+
+/* Cycles per conversion at the PC sample rate */
+static uint64_t adc_conversion_cycles(void)
+{
+    switch (ADC0_PC_R & ADC_PC_SR_M)
+    {
+        case ADC_PC_SR_125K: return FAKE_TM4C_CLOCK / 125000;
+        case ADC_PC_SR_250K: return FAKE_TM4C_CLOCK / 250000;
+        case ADC_PC_SR_500K: return FAKE_TM4C_CLOCK / 500000;
+        default:             return FAKE_TM4C_CLOCK / 1000000;
+    }
+}
+
+/* A trigger from the source EMUX must select for SS3 */
+static void adc_trigger(uint32_t emux, uint64_t at)
+{
+    uint64_t conv = adc_conversion_cycles();
+    uint32_t n = 1UL << (ADC0_SAC_R & ADC_SAC_AVG_M);
+    uint8_t channel = (uint8_t)(ADC0_SSMUX3_R & 0x0F);
+    uint32_t sum = 0;
+
+    if ((ADC0_ACTSS_R & ADC_ACTSS_ASEN3) == 0 || (ADC0_EMUX_R & ADC_EMUX_EM3_M) != emux) return;
+    if (adc.busy)
+    {
+        adc.stats.lost_triggers++;
+        return;
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint16_t v = adc.source ? adc.source(channel, at + i * conv) : 0;
+        sum += (v > 4095) ? 4095 : v;
+    }
+    adc.result = (uint16_t)(sum / n);
+    adc.busy = true;
+    adc.done = at + n * conv;
+    adc.stats.conversions += n;
+}
+
+/* The sample being converted, if it has ended by cycle now */
+static void adc_finish(uint64_t now)
+{
+    if (adc.busy && adc.done <= now)
+    {
+        adc.busy = false;
+        adc.stats.samples++;
+        if (adc.fifo_full)
+        {
+            adc.stats.overflows++;
+        }
+        else
+        {
+            adc.fifo = adc.result;
+            adc.fifo_full = true;
+        }
+        if (ADC0_SSCTL3_R & ADC_SSCTL3_IE0) adc.ris |= ADC_RIS_INR3;
+    }
+}
+
+static void adc_update(void)
+{
+    uint64_t period = (uint64_t)TIMER0_TAILR_R + 1;
+
+    while (t0.running && t0.next <= cycles)
+    {
+        uint64_t at = t0.next;
+        TIMER0_RIS_R |= TIMER_RIS_TATORIS;
+        t0.next += period;
+        adc_finish(at);
+        if (t0.ctl & TIMER_CTL_TAOTE) adc_trigger(ADC_EMUX_EM3_TIMER, at);
+    }
+    if (TIMER0_ICR_R & TIMER_ICR_TATOCINT)
+    {
+        TIMER0_RIS_R &= ~(uint32_t)TIMER_RIS_TATORIS;
+        TIMER0_ICR_R = 0;
+    }
+    adc_finish(cycles);
+    if (ADC0_ISC_R & ADC_ISC_IN3)
+    {
+        adc.ris &= ~(uint32_t)ADC_RIS_INR3;
+        ADC0_ISC_R = 0;
+    }
+}
+
+static bool adc_irq_pending(void)
+{
+    return (nvic_en & ADC0SS3_IRQ_BIT) && (adc.ris & ADC0_IM_R & ADC_IM_MASK3);
+}
+
+static bool uart_irq_pending(void)
+{
+    if ((nvic_en & UART1_IRQ_BIT) == 0 || rx_level == 0) return false;
+    if ((UART1_IM_R & UART_IM_RXIM) && rx_level >= 2) return true;
+    return (UART1_IM_R & UART_IM_RTIM) && cycles >= rx_last_arrival + RT_CYCLES;
+}
+
+static bool systick_running(void)
+{
+    return (NVIC_ST_CTRL_R & 0x07) == 0x07;
+}
+
+static bool systick_pending(void)
+{
+    if (!systick_running())
+    {
+        systick_next = 0;
+        return false;
+    }
+    if (systick_next == 0)
+    {
+        systick_next = cycles + NVIC_ST_RELOAD_R + 1;
+    }
+    return cycles >= systick_next;
+}
+
+/* Take every interrupt that is due, as the NVIC would between instructions */
+static void settle(void);
+
+static void service(void)
+{
+    uart_update();
+    i2c_update();
+    timer1_update();
+    adc_update();
+    gpio_update();
+    if (primask || in_isr) return;
+
+    in_isr = true;
+    for (;;)
+    {
+        if (systick_pending())
+        {
+            systick_next += NVIC_ST_RELOAD_R + 1;
+            if (SystickHandler) SystickHandler();
+        }
+        else if (uart_irq_pending() && UART1Handler)
+        {
+            UART1Handler();
+            uart_update();
+            if (uart_irq_pending()) break;  /* Handler left data; avoid spinning */
+        }
+        else if (i2c_irq_pending() && I2C0Handler)
+        {
+            uint64_t c0 = cycles;
+            I2C0Handler();
+            settle();
+            i2c_update();
+            i2c.stats.isr_cycles += cycles - c0 + 12;
+            if (i2c_irq_pending()) break;   /* Not acknowledged; avoid spinning */
+        }
+        else if (timer1_irq_pending() && Timer1AHandler)
+        {
+            Timer1AHandler();
+            settle();
+            timer1_update();
+            if (timer1_irq_pending()) break;
+        }
+        else if (portc_irq_pending() && GPIOPortCHandler)
+        {
+            GPIOPortCHandler();
+            settle();
+            if (portc_irq_pending()) break;
+        }
+        else if (adc_irq_pending() && ADC0SS3Handler)
+        {
+            uint64_t c0 = cycles;
+            ADC0SS3Handler();
+            settle();
+            adc_update();
+            adc.stats.isr_calls++;
+            adc.stats.isr_cycles += cycles - c0 + 12;
+            if (adc_irq_pending()) break;
+        }
+        else
+        {
+            break;
+        }
+        cycles += 12;                       /* Exception entry/exit */
+        uart_update();
+        i2c_update();
+        timer1_update();
+        adc_update();
+        gpio_update();
+    }
+    in_isr = false;
+}
+
+/* Earliest future cycle at which something can change */
+static uint64_t next_event(void)
+{
+    uint64_t next = UINT64_MAX;
+    uint64_t rt = rx_last_arrival + RT_CYCLES;
+
+    if (systick_running() && systick_next > cycles) next = systick_next;
+    if (rx_sched_rd != rx_sched_wr && rx_sched[rx_sched_rd % RX_SCHEDULE_SIZE].at < next)
+    {
+        next = rx_sched[rx_sched_rd % RX_SCHEDULE_SIZE].at;
+    }
+    if (rx_level > 0 && rt > cycles && rt < next) next = rt;
+    if (tx_level > 0 && tx_done < next) next = tx_done;
+    if (i2c.busy && i2c.done < next) next = i2c.done;     /* UINT64_MAX: stalled */
+    if (t1.running && t1.next < next) next = t1.next;
+    if (t0.running && t0.next < next) next = t0.next;
+    if (adc.busy && adc.done < next) next = adc.done;
+    if (kp_script_rd != kp_script_wr && kp_script[kp_script_rd % KP_SCRIPT_SIZE].at < next)
+    {
+        next = kp_script[kp_script_rd % KP_SCRIPT_SIZE].at;
+    }
+    return next;
+}
+
+static void access(void)
+{
+    cycles += FakeTM4C_AccessCycles;
+    service();
+}
+
+/* Classify the previous MCS access the same way: anything but the peeked
+ * status was a command */
+static void settle_mcs(void)
+{
+    if (!mcs_pending) return;
+    mcs_pending = false;
+    if (mcs_cell != mcs_peeked) i2c_command(mcs_cell);
+}
+
+/* Classify the previous DR access: still holding the peeked value means
+ * it was read (pop), anything else was written (transmit) */
+static void settle_dr(void)
+{
+    if (!dr_pending) return;
+    dr_pending = false;
+
+    if (dr_cell == dr_peeked)
+    {
+        if (rx_level > 0)
+        {
+            rx_rd = (uint8_t)((rx_rd + 1) % FAKE_TM4C_UART_FIFO);
+            rx_level--;
+        }
+    }
+    else if (tx_level < FAKE_TM4C_UART_FIFO)
+    {
+        if (tx_level == 0)
+        {
+            tx_done = cycles + FAKE_TM4C_BYTE_CYCLES;
+        }
+        tx_fifo[(tx_rd + tx_level) % FAKE_TM4C_UART_FIFO] = (uint8_t)dr_cell;
+        tx_level++;
+    }
+}
+
+/* Classify the previous port B DATA access: anything but the peeked
+ * value was a write */
+static void settle_pb(void)
+{
+    if (!pb_pending) return;
+    pb_pending = false;
+    if (pb_cell != pb_peeked)
+    {
+        pb.latch = pb_cell & 0xFF;
+        pb_update();
+        kp_update();
+    }
+}
+
+static void settle_gpio(gpio_data_t *port)
+{
+    if (!port->pending) return;
+    port->pending = false;
+    if (port->cell != port->peeked)
+    {
+        port->latch = port->cell & 0xFF;
+        kp_update();
+    }
+}
+
+/* TAEN going from clear to set (re)starts the count from TAILR */
+static void settle_t1(void)
+{
+    if (!t1.pending) return;
+    t1.pending = false;
+    if (t1.cell == t1.peeked) return;
+
+    t1.ctl = t1.cell;
+    if ((t1.ctl & TIMER_CTL_TAEN) && !t1.running)
+    {
+        t1.running = true;
+        t1.next = cycles + (uint64_t)TIMER1_TAILR_R + 1;
+    }
+    else if (!(t1.ctl & TIMER_CTL_TAEN))
+    {
+        t1.running = false;
+    }
+}
+
+/* TAEN going from clear to set (re)starts the count from TAILR */
+static void settle_t0(void)
+{
+    if (!t0.pending) return;
+    t0.pending = false;
+    if (t0.cell == t0.peeked) return;
+
+    t0.ctl = t0.cell;
+    if ((t0.ctl & TIMER_CTL_TAEN) && !t0.running)
+    {
+        t0.running = true;
+        t0.next = cycles + (uint64_t)TIMER0_TAILR_R + 1;
+    }
+    else if (!(t0.ctl & TIMER_CTL_TAEN))
+    {
+        t0.running = false;
+    }
+}
+
+/* PSSI is only ever written */
+static void settle_pssi(void)
+{
+    if (!pssi_pending) return;
+    pssi_pending = false;
+    if (pssi_cell != ADC_PEEK_MARK && (pssi_cell & 0x08)) adc_trigger(ADC_EMUX_EM3_PROCESSOR, cycles);
+}
+
+/* Only ever written: whatever the cell holds afterwards is the write */
+static void settle_nvic(void)
+{
+    if (en0_pending && en0_cell != (NVIC_PEEK_MARK | nvic_en)) nvic_en |= en0_cell;
+    if (dis0_pending && dis0_cell != (NVIC_PEEK_MARK | nvic_en)) nvic_en &= ~dis0_cell;
+    en0_pending = dis0_pending = false;
+}
+
+/* Pending writes first: the ICR writes gpio_update applies came after them */
+static void settle(void)
+{
+    settle_nvic();
+    settle_dr();
+    settle_mcs();
+    settle_pb();
+    settle_gpio(&pa);
+    settle_gpio(&pc);
+    settle_t1();
+    settle_t0();
+    settle_pssi();
+    gpio_update();
+}
+
+/*===========================================================================
+ * Register hooks
+ *===========================================================================*/
+volatile uint32_t *FakeTM4C_Uart1DR(void)
+{
+    settle();
+    access();
+    dr_peeked = DR_PEEK_MARK | (rx_level > 0 ? rx_fifo[rx_rd] : 0);
+    dr_cell = dr_peeked;
+    dr_pending = true;
+    return &dr_cell;
+}
+
+volatile uint32_t *FakeTM4C_Uart1FR(void)
+{
+    uint32_t fr = 0;
+
+    settle();
+    access();
+    if (rx_level == 0) fr |= UART_FR_RXFE;
+    if (rx_level == FAKE_TM4C_UART_FIFO) fr |= UART_FR_RXFF;
+    if (tx_level == FAKE_TM4C_UART_FIFO) fr |= UART_FR_TXFF;
+    if (tx_level == 0) fr |= UART_FR_TXFE;
+    if (tx_level > 0) fr |= UART_FR_BUSY;
+    fr_cell = fr;
+    return &fr_cell;
+}
+
+/* Counts down from RELOAD to 0 in step with the virtual CPU; writes are
+ * ignored (they only ever clear it before the counter is started) */
+volatile uint32_t *FakeTM4C_SysTickCurrent(void)
+{
+    uint64_t period = (uint64_t)NVIC_ST_RELOAD_R + 1;
+    uint64_t left;
+
+    settle();
+    access();
+    if (!systick_pending() && systick_next > cycles)
+    {
+        left = systick_next - cycles;
+    }
+    else if (systick_running())
+    {
+        /* Tick pending but masked: the counter has already reloaded */
+        left = period - (cycles - systick_next) % period;
+    }
+    else
+    {
+        left = 1;
+    }
+    st_current_cell = (uint32_t)(left - 1);
+    return &st_current_cell;
+}
+
+volatile uint32_t *FakeTM4C_I2C0MCS(void)
+{
+    uint32_t status;
+
+    settle();
+    access();
+    if (i2c.busy)
+    {
+        status = I2C_MCS_BUSY | I2C_MCS_BUSBSY;
+    }
+    else
+    {
+        status = i2c.status | (i2c.held ? I2C_MCS_BUSBSY : I2C_MCS_IDLE);
+    }
+    mcs_peeked = MCS_PEEK_MARK | status;
+    mcs_cell = mcs_peeked;
+    mcs_pending = true;
+    return &mcs_cell;
+}
+
+/* Outputs (DIR set) read back what was written, inputs the line */
+volatile uint32_t *FakeTM4C_PortBData(void)
+{
+    uint32_t outputs = GPIO_PORTB_DIR_R & 0xFF;
+    uint32_t lines = PB_SCL | PB_SDA;
+
+    settle();
+    access();
+    pb_update();
+    pb_peeked = PB_PEEK_MARK | (pb.latch & (outputs | ~lines) & 0xFF) |
+                (pb.levels & ~outputs & lines);
+    pb_cell = pb_peeked;
+    pb_pending = true;
+    return &pb_cell;
+}
+
+/* Columns: outputs read back what was written */
+volatile uint32_t *FakeTM4C_PortAData(void)
+{
+    settle();
+    access();
+    pa.peeked = GPIO_PEEK_MARK | (pa.latch & 0xFF);
+    pa.cell = pa.peeked;
+    pa.pending = true;
+    return &pa.cell;
+}
+
+/* Rows: inputs read the matrix */
+volatile uint32_t *FakeTM4C_PortCData(void)
+{
+    uint32_t outputs = GPIO_PORTC_DIR_R & 0xFF;
+
+    settle();
+    access();
+    pc.peeked = GPIO_PEEK_MARK | (pc.latch & outputs) | (kp.rows & ~outputs);
+    pc.cell = pc.peeked;
+    pc.pending = true;
+    return &pc.cell;
+}
+
+volatile uint32_t *FakeTM4C_Timer1CTL(void)
+{
+    settle();
+    access();
+    t1.peeked = TCTL_PEEK_MARK | t1.ctl;
+    t1.cell = t1.peeked;
+    t1.pending = true;
+    return &t1.cell;
+}
+
+volatile uint32_t *FakeTM4C_Timer0CTL(void)
+{
+    settle();
+    access();
+    t0.peeked = TCTL_PEEK_MARK | t0.ctl;
+    t0.cell = t0.peeked;
+    t0.pending = true;
+    return &t0.cell;
+}
+
+volatile uint32_t *FakeTM4C_Adc0RIS(void)
+{
+    settle();
+    access();
+    adc_ris_cell = adc.ris;
+    return &adc_ris_cell;
+}
+
+volatile uint32_t *FakeTM4C_Adc0PSSI(void)
+{
+    settle();
+    access();
+    pssi_cell = ADC_PEEK_MARK;
+    pssi_pending = true;
+    return &pssi_cell;
+}
+
+/* Only ever read: the access pops the FIFO */
+volatile uint32_t *FakeTM4C_Adc0SSFIFO3(void)
+{
+    settle();
+    access();
+    adc_fifo_cell = adc.fifo;
+    adc.fifo_full = false;
+    return &adc_fifo_cell;
+}
+
+volatile uint32_t *FakeTM4C_Adc0SSFSTAT3(void)
+{
+    settle();
+    access();
+    adc_fstat_cell = adc.fifo_full ? ADC_SSFSTAT3_FULL : ADC_SSFSTAT3_EMPTY;
+    return &adc_fstat_cell;
+}
+
+volatile uint32_t *FakeTM4C_NvicEn0(void)
+{
+    settle();
+    en0_cell = NVIC_PEEK_MARK | nvic_en;
+    en0_pending = true;
+    return &en0_cell;
+}
+
+volatile uint32_t *FakeTM4C_NvicDis0(void)
+{
+    settle();
+    dis0_cell = NVIC_PEEK_MARK | nvic_en;
+    dis0_pending = true;
+    return &dis0_cell;
+}
+
+/*===========================================================================
+ * intrinsics.h
+ *===========================================================================*/
+void __disable_interrupt(void)
+{
+    settle();
+    primask = true;
+}
+
+void __enable_interrupt(void)
+{
+    settle();
+    primask = false;
+    service();
+}
+
+__istate_t __get_interrupt_state(void)
+{
+    return primask ? 1 : 0;
+}
+
+void __set_interrupt_state(__istate_t state)
+{
+    settle();
+    primask = (state & 1) != 0;
+    if (!primask) service();
+}
+
+void __WFI(void)
+{
+    uint64_t limit = cycles + WFI_MAX_CYCLES;
+
+    settle();
+    for (;;)
+    {
+        uart_update();
+        i2c_update();
+        timer1_update();
+        adc_update();
+        gpio_update();
+        if (systick_pending() || uart_irq_pending() || i2c_irq_pending() ||
+            timer1_irq_pending() || portc_irq_pending() || adc_irq_pending()) break;
+
+        uint64_t next = next_event();
+        if (next > limit)
+        {
+            fprintf(stderr, "fake_tm4c123: WFI with nothing to wake it\n");
+            abort();
+        }
+        sleep_cycles += next - cycles;
+        cycles = next;
+    }
+    if (!primask) service();
+}
+
+/*===========================================================================
+ * Test control
+ *===========================================================================*/
+static void map_fixed(uintptr_t base, size_t size)
+{
+    void *p = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (p == MAP_FAILED || p != (void *)base)
+    {
+        /* Already mapped by an earlier FakeTM4C_Init: just clear it */
+        memset((void *)base, 0, size);
+    }
+}
+
+void FakeTM4C_Init(void)
+{
+    map_fixed(PERIPH_BASE, PERIPH_SIZE);
+    map_fixed(SCS_BASE, SCS_SIZE);
+
+    /* Every peripheral reports ready as soon as it is clocked */
+    memset((void *)0x400FEA00UL, 0xFF, 0x400FEA9C - 0x400FEA00 + 4);
+
+    cycles = 0;
+    sleep_cycles = 0;
+    primask = false;
+    in_isr = false;
+    systick_next = 0;
+    nvic_en = 0;
+    en0_pending = dis0_pending = false;
+    FakeTM4C_AccessCycles = 4;
+
+    rx_sched_rd = rx_sched_wr = 0;
+    rx_rd = rx_level = 0;
+    rx_last_arrival = 0;
+    rx_overruns = 0;
+    tx_rd = tx_level = 0;
+    tx_done = 0;
+    tx_sink = NULL;
+    dr_pending = false;
+
+    memset(&i2c, 0, sizeof(i2c));
+    i2c.device = 0x27;
+    mcs_pending = false;
+
+    memset(&pb, 0, sizeof(pb));
+    pb.levels = PB_SCL | PB_SDA;
+    pb_pending = false;
+
+    memset(&pa, 0, sizeof(pa));
+    memset(&pc, 0, sizeof(pc));
+    memset(&kp, 0, sizeof(kp));
+    kp_script_rd = kp_script_wr = 0;
+    kp.rows = KP_ROWS;
+    memset(&t1, 0, sizeof(t1));
+    memset(&t0, 0, sizeof(t0));
+    memset(&adc, 0, sizeof(adc));
+    pssi_pending = false;
+}
+
+uint64_t FakeTM4C_Cycles(void)
+{
+    return cycles;
+}
+
+uint64_t FakeTM4C_SleepCycles(void)
+{
+    return sleep_cycles;
+}
+
+void FakeTM4C_Run(uint64_t n)
+{
+    uint64_t target = cycles + n;
+
+    settle();
+    while (cycles < target)
+    {
+        uint64_t next = next_event();
+        cycles = (next < target) ? next : target;
+        service();
+    }
+}
+
+void FakeTM4C_Uart1Schedule(uint8_t byte, uint64_t arrival)
+{
+    rx_sched[rx_sched_wr % RX_SCHEDULE_SIZE].byte = byte;
+    rx_sched[rx_sched_wr % RX_SCHEDULE_SIZE].at = arrival;
+    rx_sched_wr++;
+}
+
+void FakeTM4C_Uart1SetSink(void (*sink)(uint8_t byte, uint64_t cycle))
+{
+    tx_sink = sink;
+}
+
+uint64_t FakeTM4C_Uart1LastArrival(void)
+{
+    return rx_last_arrival;
+}
+
+uint32_t FakeTM4C_Uart1Overruns(void)
+{
+    return rx_overruns;
+}
+
+void FakeTM4C_I2C0SetDevice(uint8_t addr)
+{
+    i2c.device = addr;
+}
+
+void FakeTM4C_I2C0SetSink(void (*sink)(uint8_t byte, uint64_t cycle))
+{
+    i2c.sink = sink;
+}
+
+void FakeTM4C_I2C0SetReadData(const uint8_t *data, uint32_t length)
+{
+    i2c.read_data = data;
+    i2c.read_len = length;
+    i2c.read_pos = 0;
+}
+
+void FakeTM4C_I2C0NackByte(uint32_t n)
+{
+    i2c.nack_in = n;
+}
+
+void FakeTM4C_I2C0HoldSda(uint32_t clocks)
+{
+    settle();
+    pb.sda_hold = clocks;
+    pb.levels = pb_wire();
+}
+
+void FakeTM4C_I2C0HoldScl(bool hold)
+{
+    settle();
+    pb.scl_hold = hold;
+    pb.levels = pb_wire();
+}
+
+void FakeTM4C_I2C0GetStats(FakeTM4C_I2CStats_t *stats)
+{
+    *stats = i2c.stats;
+}
+
+void FakeTM4C_KeypadSet(uint8_t row, uint8_t col, bool down)
+{
+    uint16_t bit = (uint16_t)(1U << (row * 4 + col));
+
+    settle();
+    kp.down = down ? (uint16_t)(kp.down | bit) : (uint16_t)(kp.down & ~bit);
+    gpio_update();
+}
+
+void FakeTM4C_KeypadSchedule(uint8_t row, uint8_t col, bool down, uint64_t at)
+{
+    kp_script[kp_script_wr % KP_SCRIPT_SIZE].bit = (uint16_t)(1U << (row * 4 + col));
+    kp_script[kp_script_wr % KP_SCRIPT_SIZE].down = down;
+    kp_script[kp_script_wr % KP_SCRIPT_SIZE].at = at;
+    kp_script_wr++;
+}
+
+uint32_t FakeTM4C_KeypadEdges(void)
+{
+    return kp.edges;
+}
+
+uint32_t FakeTM4C_Timer1Timeouts(void)
+{
+    return t1.timeouts;
+}
+
+void FakeTM4C_AdcSetSource(FakeTM4C_AdcSource_t source)
+{
+    adc.source = source;
+}
+
+void FakeTM4C_AdcGetStats(FakeTM4C_AdcStats_t *stats)
+{
+    *stats = adc.stats;
+}
@@ -0,0 +1,553 @@
+/*
+ * fake_tm4c123.h - Host-side stand-in for the frontend's register-level
+ * hardware access (frontend/lib/tm4c123gh6pm.h)
+ *
+ * Force-included into every frontend source with
+ *   -include tests/host/fake_tm4c123.h -I tests/host/iar
+ * It pulls in the real register header; FakeTM4C_Init() maps host memory
+ * at the peripheral and NVIC addresses, so plain registers simply read
+ * back what was written. "unsigned long" is 64 bits on the host, so the
+ * registers the tested modules use are redefined as 32-bit cells (add
+ * more as tests reach new modules). Registers with side effects are
+ * redirected to the models below.
+ */
+
+#ifndef FAKE_TM4C123_H_
+#define FAKE_TM4C123_H_
+
+/* Force-included first, so this decides the libc feature set (mmap) */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../../frontend/lib/tm4c123gh6pm.h"
+
+/*===========================================================================
+ * 32-bit plain registers
+ *===========================================================================*/
+#define FAKE_TM4C_REG(addr)     (*((volatile uint32_t *)(addr)))
+
+#undef SYSCTL_RCGCGPIO_R
+#define SYSCTL_RCGCGPIO_R       FAKE_TM4C_REG(0x400FE608)
+#undef SYSCTL_RCGCUART_R
+#define SYSCTL_RCGCUART_R       FAKE_TM4C_REG(0x400FE618)
+#undef SYSCTL_PRGPIO_R
+#define SYSCTL_PRGPIO_R         FAKE_TM4C_REG(0x400FEA08)
+#undef SYSCTL_PRUART_R
+#define SYSCTL_PRUART_R         FAKE_TM4C_REG(0x400FEA18)
+#undef SYSCTL_RCGCI2C_R
+#define SYSCTL_RCGCI2C_R        FAKE_TM4C_REG(0x400FE620)
+#undef SYSCTL_SRI2C_R
+#define SYSCTL_SRI2C_R          FAKE_TM4C_REG(0x400FE520)
+#undef SYSCTL_PRI2C_R
+#define SYSCTL_PRI2C_R          FAKE_TM4C_REG(0x400FEA20)
+#undef SYSCTL_RCGCTIMER_R
+#define SYSCTL_RCGCTIMER_R      FAKE_TM4C_REG(0x400FE604)
+#undef SYSCTL_PRTIMER_R
+#define SYSCTL_PRTIMER_R        FAKE_TM4C_REG(0x400FEA04)
+#undef SYSCTL_RCGCADC_R
+#define SYSCTL_RCGCADC_R        FAKE_TM4C_REG(0x400FE638)
+#undef SYSCTL_PRADC_R
+#define SYSCTL_PRADC_R          FAKE_TM4C_REG(0x400FEA38)
+
+/* GPIO ports A-F (dio.c takes every port's addresses); DATA of A-C is
+ * modelled below */
+#undef GPIO_PORTA_DIR_R
+#define GPIO_PORTA_DIR_R        FAKE_TM4C_REG(0x40004400)
+#undef GPIO_PORTA_IS_R
+#define GPIO_PORTA_IS_R         FAKE_TM4C_REG(0x40004404)
+#undef GPIO_PORTA_IBE_R
+#define GPIO_PORTA_IBE_R        FAKE_TM4C_REG(0x40004408)
+#undef GPIO_PORTA_IEV_R
+#define GPIO_PORTA_IEV_R        FAKE_TM4C_REG(0x4000440C)
+#undef GPIO_PORTA_IM_R
+#define GPIO_PORTA_IM_R         FAKE_TM4C_REG(0x40004410)
+#undef GPIO_PORTA_RIS_R
+#define GPIO_PORTA_RIS_R        FAKE_TM4C_REG(0x40004414)
+#undef GPIO_PORTA_MIS_R
+#define GPIO_PORTA_MIS_R        FAKE_TM4C_REG(0x40004418)
+#undef GPIO_PORTA_ICR_R
+#define GPIO_PORTA_ICR_R        FAKE_TM4C_REG(0x4000441C)
+#undef GPIO_PORTA_AFSEL_R
+#define GPIO_PORTA_AFSEL_R      FAKE_TM4C_REG(0x40004420)
+#undef GPIO_PORTA_ODR_R
+#define GPIO_PORTA_ODR_R        FAKE_TM4C_REG(0x4000450C)
+#undef GPIO_PORTA_PUR_R
+#define GPIO_PORTA_PUR_R        FAKE_TM4C_REG(0x40004510)
+#undef GPIO_PORTA_PDR_R
+#define GPIO_PORTA_PDR_R        FAKE_TM4C_REG(0x40004514)
+#undef GPIO_PORTA_DEN_R
+#define GPIO_PORTA_DEN_R        FAKE_TM4C_REG(0x4000451C)
+#undef GPIO_PORTA_LOCK_R
+#define GPIO_PORTA_LOCK_R       FAKE_TM4C_REG(0x40004520)
+#undef GPIO_PORTA_CR_R
+#define GPIO_PORTA_CR_R         FAKE_TM4C_REG(0x40004524)
+#undef GPIO_PORTA_PCTL_R
+#define GPIO_PORTA_PCTL_R       FAKE_TM4C_REG(0x4000452C)
+
+#undef GPIO_PORTB_DIR_R
+#define GPIO_PORTB_DIR_R        FAKE_TM4C_REG(0x40005400)
+#undef GPIO_PORTB_IS_R
+#define GPIO_PORTB_IS_R         FAKE_TM4C_REG(0x40005404)
+#undef GPIO_PORTB_IBE_R
+#define GPIO_PORTB_IBE_R        FAKE_TM4C_REG(0x40005408)
+#undef GPIO_PORTB_IEV_R
+#define GPIO_PORTB_IEV_R        FAKE_TM4C_REG(0x4000540C)
+#undef GPIO_PORTB_IM_R
+#define GPIO_PORTB_IM_R         FAKE_TM4C_REG(0x40005410)
+#undef GPIO_PORTB_RIS_R
+#define GPIO_PORTB_RIS_R        FAKE_TM4C_REG(0x40005414)
+#undef GPIO_PORTB_MIS_R
+#define GPIO_PORTB_MIS_R        FAKE_TM4C_REG(0x40005418)
+#undef GPIO_PORTB_ICR_R
+#define GPIO_PORTB_ICR_R        FAKE_TM4C_REG(0x4000541C)
+#undef GPIO_PORTB_AFSEL_R
+#define GPIO_PORTB_AFSEL_R      FAKE_TM4C_REG(0x40005420)
+#undef GPIO_PORTB_ODR_R
+#define GPIO_PORTB_ODR_R        FAKE_TM4C_REG(0x4000550C)
+#undef GPIO_PORTB_PUR_R
+#define GPIO_PORTB_PUR_R        FAKE_TM4C_REG(0x40005510)
+#undef GPIO_PORTB_PDR_R
+#define GPIO_PORTB_PDR_R        FAKE_TM4C_REG(0x40005514)
+#undef GPIO_PORTB_DEN_R
+#define GPIO_PORTB_DEN_R        FAKE_TM4C_REG(0x4000551C)
+#undef GPIO_PORTB_LOCK_R
+#define GPIO_PORTB_LOCK_R       FAKE_TM4C_REG(0x40005520)
+#undef GPIO_PORTB_CR_R
+#define GPIO_PORTB_CR_R         FAKE_TM4C_REG(0x40005524)
+#undef GPIO_PORTB_AMSEL_R
+#define GPIO_PORTB_AMSEL_R      FAKE_TM4C_REG(0x40005528)
+#undef GPIO_PORTB_PCTL_R
+#define GPIO_PORTB_PCTL_R       FAKE_TM4C_REG(0x4000552C)
+
+#undef GPIO_PORTC_DIR_R
+#define GPIO_PORTC_DIR_R        FAKE_TM4C_REG(0x40006400)
+#undef GPIO_PORTC_IS_R
+#define GPIO_PORTC_IS_R         FAKE_TM4C_REG(0x40006404)
+#undef GPIO_PORTC_IBE_R
+#define GPIO_PORTC_IBE_R        FAKE_TM4C_REG(0x40006408)
+#undef GPIO_PORTC_IEV_R
+#define GPIO_PORTC_IEV_R        FAKE_TM4C_REG(0x4000640C)
+#undef GPIO_PORTC_IM_R
+#define GPIO_PORTC_IM_R         FAKE_TM4C_REG(0x40006410)
+#undef GPIO_PORTC_RIS_R
+#define GPIO_PORTC_RIS_R        FAKE_TM4C_REG(0x40006414)
+#undef GPIO_PORTC_MIS_R
+#define GPIO_PORTC_MIS_R        FAKE_TM4C_REG(0x40006418)
+#undef GPIO_PORTC_ICR_R
+#define GPIO_PORTC_ICR_R        FAKE_TM4C_REG(0x4000641C)
+#undef GPIO_PORTC_AFSEL_R
+#define GPIO_PORTC_AFSEL_R      FAKE_TM4C_REG(0x40006420)
+#undef GPIO_PORTC_ODR_R
+#define GPIO_PORTC_ODR_R        FAKE_TM4C_REG(0x4000650C)
+#undef GPIO_PORTC_PUR_R
+#define GPIO_PORTC_PUR_R        FAKE_TM4C_REG(0x40006510)
+#undef GPIO_PORTC_PDR_R
+#define GPIO_PORTC_PDR_R        FAKE_TM4C_REG(0x40006514)
+#undef GPIO_PORTC_DEN_R
+#define GPIO_PORTC_DEN_R        FAKE_TM4C_REG(0x4000651C)
+#undef GPIO_PORTC_LOCK_R
+#define GPIO_PORTC_LOCK_R       FAKE_TM4C_REG(0x40006520)
+#undef GPIO_PORTC_CR_R
+#define GPIO_PORTC_CR_R         FAKE_TM4C_REG(0x40006524)
+#undef GPIO_PORTC_PCTL_R
+#define GPIO_PORTC_PCTL_R       FAKE_TM4C_REG(0x4000652C)
+
+#undef GPIO_PORTD_DATA_R
+#define GPIO_PORTD_DATA_R       FAKE_TM4C_REG(0x400073FC)
+#undef GPIO_PORTD_DIR_R
+#define GPIO_PORTD_DIR_R        FAKE_TM4C_REG(0x40007400)
+#undef GPIO_PORTD_IS_R
+#define GPIO_PORTD_IS_R         FAKE_TM4C_REG(0x40007404)
+#undef GPIO_PORTD_IBE_R
+#define GPIO_PORTD_IBE_R        FAKE_TM4C_REG(0x40007408)
+#undef GPIO_PORTD_IEV_R
+#define GPIO_PORTD_IEV_R        FAKE_TM4C_REG(0x4000740C)
+#undef GPIO_PORTD_IM_R
+#define GPIO_PORTD_IM_R         FAKE_TM4C_REG(0x40007410)
+#undef GPIO_PORTD_RIS_R
+#define GPIO_PORTD_RIS_R        FAKE_TM4C_REG(0x40007414)
+#undef GPIO_PORTD_MIS_R
+#define GPIO_PORTD_MIS_R        FAKE_TM4C_REG(0x40007418)
+#undef GPIO_PORTD_ICR_R
+#define GPIO_PORTD_ICR_R        FAKE_TM4C_REG(0x4000741C)
+#undef GPIO_PORTD_AFSEL_R
+#define GPIO_PORTD_AFSEL_R      FAKE_TM4C_REG(0x40007420)
+#undef GPIO_PORTD_ODR_R
+#define GPIO_PORTD_ODR_R        FAKE_TM4C_REG(0x4000750C)
+#undef GPIO_PORTD_PUR_R
+#define GPIO_PORTD_PUR_R        FAKE_TM4C_REG(0x40007510)
+#undef GPIO_PORTD_PDR_R
+#define GPIO_PORTD_PDR_R        FAKE_TM4C_REG(0x40007514)
+#undef GPIO_PORTD_DEN_R
+#define GPIO_PORTD_DEN_R        FAKE_TM4C_REG(0x4000751C)
+#undef GPIO_PORTD_LOCK_R
+#define GPIO_PORTD_LOCK_R       FAKE_TM4C_REG(0x40007520)
+#undef GPIO_PORTD_CR_R
+#define GPIO_PORTD_CR_R         FAKE_TM4C_REG(0x40007524)
+#undef GPIO_PORTD_AMSEL_R
+#define GPIO_PORTD_AMSEL_R      FAKE_TM4C_REG(0x40007528)
+#undef GPIO_PORTD_PCTL_R
+#define GPIO_PORTD_PCTL_R       FAKE_TM4C_REG(0x4000752C)
+
+#undef GPIO_PORTE_DATA_R
+#define GPIO_PORTE_DATA_R       FAKE_TM4C_REG(0x400243FC)
+#undef GPIO_PORTE_DIR_R
+#define GPIO_PORTE_DIR_R        FAKE_TM4C_REG(0x40024400)
+#undef GPIO_PORTE_IS_R
+#define GPIO_PORTE_IS_R         FAKE_TM4C_REG(0x40024404)
+#undef GPIO_PORTE_IBE_R
+#define GPIO_PORTE_IBE_R        FAKE_TM4C_REG(0x40024408)
+#undef GPIO_PORTE_IEV_R
+#define GPIO_PORTE_IEV_R        FAKE_TM4C_REG(0x4002440C)
+#undef GPIO_PORTE_IM_R
+#define GPIO_PORTE_IM_R         FAKE_TM4C_REG(0x40024410)
+#undef GPIO_PORTE_RIS_R
+#define GPIO_PORTE_RIS_R        FAKE_TM4C_REG(0x40024414)
+#undef GPIO_PORTE_MIS_R
+#define GPIO_PORTE_MIS_R        FAKE_TM4C_REG(0x40024418)
+#undef GPIO_PORTE_ICR_R
+#define GPIO_PORTE_ICR_R        FAKE_TM4C_REG(0x4002441C)
+#undef GPIO_PORTE_AFSEL_R
+#define GPIO_PORTE_AFSEL_R      FAKE_TM4C_REG(0x40024420)
+#undef GPIO_PORTE_ODR_R
+#define GPIO_PORTE_ODR_R        FAKE_TM4C_REG(0x4002450C)
+#undef GPIO_PORTE_PUR_R
+#define GPIO_PORTE_PUR_R        FAKE_TM4C_REG(0x40024510)
+#undef GPIO_PORTE_PDR_R
+#define GPIO_PORTE_PDR_R        FAKE_TM4C_REG(0x40024514)
+#undef GPIO_PORTE_DEN_R
+#define GPIO_PORTE_DEN_R        FAKE_TM4C_REG(0x4002451C)
+#undef GPIO_PORTE_LOCK_R
+#define GPIO_PORTE_LOCK_R       FAKE_TM4C_REG(0x40024520)
+#undef GPIO_PORTE_CR_R
+#define GPIO_PORTE_CR_R         FAKE_TM4C_REG(0x40024524)
+#undef GPIO_PORTE_AMSEL_R
+#define GPIO_PORTE_AMSEL_R      FAKE_TM4C_REG(0x40024528)
+#undef GPIO_PORTE_PCTL_R
+#define GPIO_PORTE_PCTL_R       FAKE_TM4C_REG(0x4002452C)
+
+#undef GPIO_PORTF_DATA_R
+#define GPIO_PORTF_DATA_R       FAKE_TM4C_REG(0x400253FC)
+#undef GPIO_PORTF_DIR_R
+#define GPIO_PORTF_DIR_R        FAKE_TM4C_REG(0x40025400)
+#undef GPIO_PORTF_IS_R
+#define GPIO_PORTF_IS_R         FAKE_TM4C_REG(0x40025404)
+#undef GPIO_PORTF_IBE_R
+#define GPIO_PORTF_IBE_R        FAKE_TM4C_REG(0x40025408)
+#undef GPIO_PORTF_IEV_R
+#define GPIO_PORTF_IEV_R        FAKE_TM4C_REG(0x4002540C)
+#undef GPIO_PORTF_IM_R
+#define GPIO_PORTF_IM_R         FAKE_TM4C_REG(0x40025410)
+#undef GPIO_PORTF_RIS_R
+#define GPIO_PORTF_RIS_R        FAKE_TM4C_REG(0x40025414)
+#undef GPIO_PORTF_MIS_R
+#define GPIO_PORTF_MIS_R        FAKE_TM4C_REG(0x40025418)
+#undef GPIO_PORTF_ICR_R
+#define GPIO_PORTF_ICR_R        FAKE_TM4C_REG(0x4002541C)
+#undef GPIO_PORTF_AFSEL_R
+#define GPIO_PORTF_AFSEL_R      FAKE_TM4C_REG(0x40025420)
+#undef GPIO_PORTF_ODR_R
+#define GPIO_PORTF_ODR_R        FAKE_TM4C_REG(0x4002550C)
+#undef GPIO_PORTF_PUR_R
+#define GPIO_PORTF_PUR_R        FAKE_TM4C_REG(0x40025510)
+#undef GPIO_PORTF_PDR_R
+#define GPIO_PORTF_PDR_R        FAKE_TM4C_REG(0x40025514)
+#undef GPIO_PORTF_DEN_R
+#define GPIO_PORTF_DEN_R        FAKE_TM4C_REG(0x4002551C)
+#undef GPIO_PORTF_LOCK_R
+#define GPIO_PORTF_LOCK_R       FAKE_TM4C_REG(0x40025520)
+#undef GPIO_PORTF_CR_R
+#define GPIO_PORTF_CR_R         FAKE_TM4C_REG(0x40025524)
+#undef GPIO_PORTF_PCTL_R
+#define GPIO_PORTF_PCTL_R       FAKE_TM4C_REG(0x4002552C)
+
+#undef UART1_ECR_R
+#define UART1_ECR_R             FAKE_TM4C_REG(0x4000D004)
+#undef UART1_IBRD_R
+#define UART1_IBRD_R            FAKE_TM4C_REG(0x4000D024)
+#undef UART1_FBRD_R
+#define UART1_FBRD_R            FAKE_TM4C_REG(0x4000D028)
+#undef UART1_LCRH_R
+#define UART1_LCRH_R            FAKE_TM4C_REG(0x4000D02C)
+#undef UART1_CTL_R
+#define UART1_CTL_R             FAKE_TM4C_REG(0x4000D030)
+#undef UART1_IFLS_R
+#define UART1_IFLS_R            FAKE_TM4C_REG(0x4000D034)
+#undef UART1_IM_R
+#define UART1_IM_R              FAKE_TM4C_REG(0x4000D038)
+#undef UART1_ICR_R
+#define UART1_ICR_R             FAKE_TM4C_REG(0x4000D044)
+
+#undef I2C0_MSA_R
+#define I2C0_MSA_R              FAKE_TM4C_REG(0x40020000)
+#undef I2C0_MDR_R
+#define I2C0_MDR_R              FAKE_TM4C_REG(0x40020008)
+#undef I2C0_MTPR_R
+#define I2C0_MTPR_R             FAKE_TM4C_REG(0x4002000C)
+#undef I2C0_MIMR_R
+#define I2C0_MIMR_R             FAKE_TM4C_REG(0x40020010)
+#undef I2C0_MRIS_R
+#define I2C0_MRIS_R             FAKE_TM4C_REG(0x40020014)
+#undef I2C0_MMIS_R
+#define I2C0_MMIS_R             FAKE_TM4C_REG(0x40020018)
+#undef I2C0_MICR_R
+#define I2C0_MICR_R             FAKE_TM4C_REG(0x4002001C)
+#undef I2C0_MCR_R
+#define I2C0_MCR_R              FAKE_TM4C_REG(0x40020020)
+
+/* I2C1-3 are only compiled (i2c.c takes their addresses), never run */
+#undef I2C1_MSA_R
+#define I2C1_MSA_R              FAKE_TM4C_REG(0x40021000)
+#undef I2C1_MCS_R
+#define I2C1_MCS_R              FAKE_TM4C_REG(0x40021004)
+#undef I2C1_MDR_R
+#define I2C1_MDR_R              FAKE_TM4C_REG(0x40021008)
+#undef I2C1_MTPR_R
+#define I2C1_MTPR_R             FAKE_TM4C_REG(0x4002100C)
+#undef I2C1_MCR_R
+#define I2C1_MCR_R              FAKE_TM4C_REG(0x40021020)
+#undef I2C2_MSA_R
+#define I2C2_MSA_R              FAKE_TM4C_REG(0x40022000)
+#undef I2C2_MCS_R
+#define I2C2_MCS_R              FAKE_TM4C_REG(0x40022004)
+#undef I2C2_MDR_R
+#define I2C2_MDR_R              FAKE_TM4C_REG(0x40022008)
+#undef I2C2_MTPR_R
+#define I2C2_MTPR_R             FAKE_TM4C_REG(0x4002200C)
+#undef I2C2_MCR_R
+#define I2C2_MCR_R              FAKE_TM4C_REG(0x40022020)
+#undef I2C3_MSA_R
+#define I2C3_MSA_R              FAKE_TM4C_REG(0x40023000)
+#undef I2C3_MCS_R
+#define I2C3_MCS_R              FAKE_TM4C_REG(0x40023004)
+#undef I2C3_MDR_R
+#define I2C3_MDR_R              FAKE_TM4C_REG(0x40023008)
+#undef I2C3_MTPR_R
+#define I2C3_MTPR_R             FAKE_TM4C_REG(0x4002300C)
+#undef I2C3_MCR_R
+#define I2C3_MCR_R              FAKE_TM4C_REG(0x40023020)
+
+#undef TIMER0_CFG_R
+#define TIMER0_CFG_R            FAKE_TM4C_REG(0x40030000)
+#undef TIMER0_TAMR_R
+#define TIMER0_TAMR_R           FAKE_TM4C_REG(0x40030004)
+#undef TIMER0_IMR_R
+#define TIMER0_IMR_R            FAKE_TM4C_REG(0x40030018)
+#undef TIMER0_RIS_R
+#define TIMER0_RIS_R            FAKE_TM4C_REG(0x4003001C)
+#undef TIMER0_ICR_R
+#define TIMER0_ICR_R            FAKE_TM4C_REG(0x40030024)
+#undef TIMER0_TAILR_R
+#define TIMER0_TAILR_R          FAKE_TM4C_REG(0x40030028)
+
+#undef TIMER1_CFG_R
+#define TIMER1_CFG_R            FAKE_TM4C_REG(0x40031000)
+#undef TIMER1_TAMR_R
+#define TIMER1_TAMR_R           FAKE_TM4C_REG(0x40031004)
+#undef TIMER1_IMR_R
+#define TIMER1_IMR_R            FAKE_TM4C_REG(0x40031018)
+#undef TIMER1_RIS_R
+#define TIMER1_RIS_R            FAKE_TM4C_REG(0x4003101C)
+#undef TIMER1_MIS_R
+#define TIMER1_MIS_R            FAKE_TM4C_REG(0x40031020)
+#undef TIMER1_ICR_R
+#define TIMER1_ICR_R            FAKE_TM4C_REG(0x40031024)
+#undef TIMER1_TAILR_R
+#define TIMER1_TAILR_R          FAKE_TM4C_REG(0x40031028)
+
+#undef ADC0_ACTSS_R
+#define ADC0_ACTSS_R            FAKE_TM4C_REG(0x40038000)
+#undef ADC0_IM_R
+#define ADC0_IM_R               FAKE_TM4C_REG(0x40038008)
+#undef ADC0_ISC_R
+#define ADC0_ISC_R              FAKE_TM4C_REG(0x4003800C)
+#undef ADC0_EMUX_R
+#define ADC0_EMUX_R             FAKE_TM4C_REG(0x40038014)
+#undef ADC0_SAC_R
+#define ADC0_SAC_R              FAKE_TM4C_REG(0x40038030)
+#undef ADC0_CTL_R
+#define ADC0_CTL_R              FAKE_TM4C_REG(0x40038038)
+#undef ADC0_SSMUX3_R
+#define ADC0_SSMUX3_R           FAKE_TM4C_REG(0x400380A0)
+#undef ADC0_SSCTL3_R
+#define ADC0_SSCTL3_R           FAKE_TM4C_REG(0x400380A4)
+#undef ADC0_PC_R
+#define ADC0_PC_R               FAKE_TM4C_REG(0x40038FC4)
+
+#undef NVIC_ST_CTRL_R
+#define NVIC_ST_CTRL_R          FAKE_TM4C_REG(0xE000E010)
+#undef NVIC_ST_RELOAD_R
+#define NVIC_ST_RELOAD_R        FAKE_TM4C_REG(0xE000E014)
+
+/*===========================================================================
+ * Modelled registers
+ *
+ * NVIC_EN0 and NVIC_DIS0 set and clear interrupt enables bit by bit, as
+ * on the chip, so drivers enabling their own lines do not undo others.
+ *===========================================================================*/
+volatile uint32_t *FakeTM4C_Uart1DR(void);
+volatile uint32_t *FakeTM4C_Uart1FR(void);
+volatile uint32_t *FakeTM4C_SysTickCurrent(void);
+volatile uint32_t *FakeTM4C_I2C0MCS(void);
+volatile uint32_t *FakeTM4C_PortAData(void);
+volatile uint32_t *FakeTM4C_PortBData(void);
+volatile uint32_t *FakeTM4C_PortCData(void);
+volatile uint32_t *FakeTM4C_Timer1CTL(void);
+volatile uint32_t *FakeTM4C_Timer0CTL(void);
+volatile uint32_t *FakeTM4C_Adc0RIS(void);
+volatile uint32_t *FakeTM4C_Adc0PSSI(void);
+volatile uint32_t *FakeTM4C_Adc0SSFIFO3(void);
+volatile uint32_t *FakeTM4C_Adc0SSFSTAT3(void);
+volatile uint32_t *FakeTM4C_NvicEn0(void);
+volatile uint32_t *FakeTM4C_NvicDis0(void);
+
+#undef UART1_DR_R
+#define UART1_DR_R              (*FakeTM4C_Uart1DR())
+#undef UART1_FR_R
+#define UART1_FR_R              (*FakeTM4C_Uart1FR())
+#undef NVIC_ST_CURRENT_R
+#define NVIC_ST_CURRENT_R       (*FakeTM4C_SysTickCurrent())
+#undef I2C0_MCS_R
+#define I2C0_MCS_R              (*FakeTM4C_I2C0MCS())
+#undef GPIO_PORTA_DATA_R
+#define GPIO_PORTA_DATA_R       (*FakeTM4C_PortAData())
+#undef GPIO_PORTB_DATA_R
+#define GPIO_PORTB_DATA_R       (*FakeTM4C_PortBData())
+#undef GPIO_PORTC_DATA_R
+#define GPIO_PORTC_DATA_R       (*FakeTM4C_PortCData())
+#undef TIMER1_CTL_R
+#define TIMER1_CTL_R            (*FakeTM4C_Timer1CTL())
+#undef TIMER0_CTL_R
+#define TIMER0_CTL_R            (*FakeTM4C_Timer0CTL())
+#undef ADC0_RIS_R
+#define ADC0_RIS_R              (*FakeTM4C_Adc0RIS())
+#undef ADC0_PSSI_R
+#define ADC0_PSSI_R             (*FakeTM4C_Adc0PSSI())
+#undef ADC0_SSFIFO3_R
+#define ADC0_SSFIFO3_R          (*FakeTM4C_Adc0SSFIFO3())
+#undef ADC0_SSFSTAT3_R
+#define ADC0_SSFSTAT3_R         (*FakeTM4C_Adc0SSFSTAT3())
+#undef NVIC_EN0_R
+#define NVIC_EN0_R              (*FakeTM4C_NvicEn0())
+#undef NVIC_DIS0_R
+#define NVIC_DIS0_R             (*FakeTM4C_NvicDis0())
+
+/*===========================================================================
+ * Virtual CPU (16 MHz)
+ *
+ * Every modelled register access costs FAKE_TM4C_ACCESS_CYCLES (tests may
+ * change it to mimic slower code). Interrupts are taken at those accesses
+ * and whenever PRIMASK is cleared. __WFI() skips ahead to the next
+ * interrupt and counts the skipped cycles as sleep.
+ *===========================================================================*/
+#define FAKE_TM4C_CLOCK         16000000UL
+#define FAKE_TM4C_BIT_CYCLES    139                             /* 115200 baud */
+#define FAKE_TM4C_BYTE_CYCLES   (FAKE_TM4C_BIT_CYCLES * 10)
+
+extern uint32_t FakeTM4C_AccessCycles;
+
+void FakeTM4C_Init(void);
+uint64_t FakeTM4C_Cycles(void);
+uint64_t FakeTM4C_SleepCycles(void);
+void FakeTM4C_Run(uint64_t cycles);     /* Busy CPU, interrupts still taken */
+
+/*===========================================================================
+ * UART1 model
+ *
+ * 16-byte RX and TX FIFOs. RX bytes are scheduled onto the line with an
+ * arrival cycle; the RX interrupt follows IFLS (1/8 = 2 bytes) and the
+ * receive timeout fires after 32 idle bit times. TX bytes leave one per
+ * byte time and are handed to the sink, which may schedule a reply.
+ *===========================================================================*/
+#define FAKE_TM4C_UART_FIFO     16
+
+void FakeTM4C_Uart1Schedule(uint8_t byte, uint64_t arrival);
+void FakeTM4C_Uart1SetSink(void (*sink)(uint8_t byte, uint64_t cycle));
+uint64_t FakeTM4C_Uart1LastArrival(void);
+uint32_t FakeTM4C_Uart1Overruns(void);
+
+/*===========================================================================
+ * I2C0 master model
+ *
+ * Every MCS command moves one byte: START adds 10 bit times (START and
+ * address with its ACK), the byte takes 9, STOP 1, at the SCL rate MTPR
+ * gives. The status bits (BUSY, ERROR, ADRACK, DATACK, IDLE, BUSBSY) and
+ * the master interrupt follow when the command ends; a STOP on its own
+ * after an error counts as a command too. Only the device address ACKs.
+ * Written bytes go to the sink with the cycle their ACK ends.
+ *
+ * PB2 (SCL) and PB3 (SDA) are open-drain lines, high unless a GPIO
+ * output (AFSEL clear) drives one low or a slave holds it.
+ * GPIO_PORTB_DATA_R reads back the written value for outputs (DIR set)
+ * and the line for inputs. A slave holding SDA makes START lose arbitration
+ * and lets go after the SCL clocks it was given; one holding SCL stalls
+ * the master for good. Setting SYSCTL_SRI2C bit 0 resets the master and
+ * its registers.
+ *===========================================================================*/
+typedef struct {
+    uint32_t starts;            /* START and repeated START conditions */
+    uint32_t bytes;             /* Address and data bytes on the wire */
+    uint64_t busy_cycles;       /* Time the bus was driven */
+    uint64_t isr_cycles;        /* CPU time in I2C0Handler, entry/exit included */
+    uint32_t gpio_clocks;       /* SCL rising edges driven as GPIO */
+    uint32_t gpio_stops;        /* STOPs driven as GPIO (SDA rising, SCL high) */
+} FakeTM4C_I2CStats_t;
+
+void FakeTM4C_I2C0SetDevice(uint8_t addr);          /* 0x27 after Init */
+void FakeTM4C_I2C0SetSink(void (*sink)(uint8_t byte, uint64_t cycle));
+void FakeTM4C_I2C0SetReadData(const uint8_t *data, uint32_t length);
+void FakeTM4C_I2C0NackByte(uint32_t n);             /* NACK the n-th written data byte from now (1 = next) */
+void FakeTM4C_I2C0HoldSda(uint32_t clocks);         /* Slave holds SDA low for this many SCL clocks */
+void FakeTM4C_I2C0HoldScl(bool hold);               /* Slave holds SCL low until released */
+void FakeTM4C_I2C0GetStats(FakeTM4C_I2CStats_t *stats);
+
+/*===========================================================================
+ * Keypad matrix and Timer1A model
+ *
+ * A 4x4 switch matrix between the rows on PC4-PC7 (pulled up) and the
+ * columns on PB6, PA4, PA3, PA2, without diodes: a row reads low while
+ * pressed keys connect it, directly or through other rows and columns, to
+ * a column driven low as a GPIO output (so ghost keys appear). Port C latches
+ * edges on those rows into RIS as IS/IBE/IEV ask (edges only); MIS is
+ * RIS & IM and the port C interrupt runs GPIOPortCHandler. Timer1A counts
+ * TAILR + 1 cycles from the TIMER1_CTL write that sets TAEN, periodically,
+ * raising RIS and Timer1AHandler while IMR allows. Key changes can be
+ * made now or scheduled at a cycle (in time order, like UART RX bytes).
+ *===========================================================================*/
+void FakeTM4C_KeypadSet(uint8_t row, uint8_t col, bool down);
+void FakeTM4C_KeypadSchedule(uint8_t row, uint8_t col, bool down, uint64_t at);
+uint32_t FakeTM4C_KeypadEdges(void);                /* Row edges latched so far */
+uint32_t FakeTM4C_Timer1Timeouts(void);             /* Timer1A time-outs so far */
+
+/*===========================================================================
+ * ADC0 Sequencer 3 and Timer0A model
+ *
+ * SS3 (one step, one-deep FIFO) starts on a PSSI write while EMUX selects
+ * the processor, or on a Timer0A time-out while EMUX selects the timer and
+ * TIMER0_CTL has TAOTE set; either way only while ACTSS enables it. Each
+ * sample averages 2^SAC conversions of the input SSMUX3 selects, one per
+ * sample period of the PC rate (125 ksps = 128 cycles), asking the source
+ * for the input at the cycle each conversion starts. The result lands in
+ * the FIFO unless an unread one is still there (then it is dropped and
+ * counted, like OSTAT overflow), RIS follows SSCTL3 IE0, ISC clears it and ADC0SS3Handler runs while IM allows. A trigger
+ * that comes while a sample is still converting is lost.
+ *===========================================================================*/
+typedef uint16_t (*FakeTM4C_AdcSource_t)(uint8_t channel, uint64_t cycle);
+
+typedef struct {
+    uint32_t samples;           /* Samples finished */
+    uint32_t conversions;       /* Conversions, 2^SAC per sample */
+    uint32_t overflows;         /* Samples dropped on a full FIFO */
+    uint32_t lost_triggers;     /* Triggers while converting */
+    uint32_t isr_calls;
+    uint64_t isr_cycles;        /* CPU time in ADC0SS3Handler, entry/exit included */
+} FakeTM4C_AdcStats_t;
+
+void FakeTM4C_AdcSetSource(FakeTM4C_AdcSource_t source);   /* NULL reads 0 */
+void FakeTM4C_AdcGetStats(FakeTM4C_AdcStats_t *stats);
+
+#endif /* FAKE_TM4C123_H_ */
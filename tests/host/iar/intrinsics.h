@@ -0,0 +1,21 @@
+/*
+ * intrinsics.h - Host stand-in for the IAR intrinsics the frontend uses
+ *
+ * Implemented by fake_tm4c123.c: PRIMASK gates the fake interrupts and
+ * __WFI() sleeps the virtual CPU until the next one is due.
+ */
+
+#ifndef FAKE_IAR_INTRINSICS_H_
+#define FAKE_IAR_INTRINSICS_H_
+
+#include <stdint.h>
+
+typedef uint32_t __istate_t;        /* PRIMASK: 1 = masked */
+
+void __disable_interrupt(void);
+void __enable_interrupt(void);
+__istate_t __get_interrupt_state(void);
+void __set_interrupt_state(__istate_t state);
+void __WFI(void);
+
+#endif /* FAKE_IAR_INTRINSICS_H_ */
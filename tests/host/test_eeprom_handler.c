@@ -0,0 +1,1082 @@
+/*
+ * test_eeprom_handler.c - Host test/benchmark for the EEPROM configuration
+ * mirror
+ *
+ * Checks that the configuration is loaded once at boot (migrating the old
+ * fixed layout into the config store), that reads are then served from
+ * RAM, that writes of an unchanged value never reach the EEPROM, that
+ * changes are committed from the main loop (retried, or dropped and rolled
+ * back if the EEPROM keeps failing), that durable-mode responses wait
+ * for the commit, and that the password is only ever stored hashed. The
+ * benchmark replays a day-like command mix through the real command
+ * handlers and counts EEPROM operations against the legacy handler
+ * (reproduced below).
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -DPIN_HASH_BUDGET_US=0 -I tests/host -I tests/host/tivaware \
+ *       tests/host/test_eeprom_handler.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/application/eeprom_handler.c \
+ *       backend/application/config_store.c backend/application/crc16.c \
+ *       backend/application/credentials.c backend/application/pin_hash.c \
+ *       backend/application/sha256.c \
+ *       backend/application/uart_commands.c -o test_eeprom_handler
+ *   ./test_eeprom_handler
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "driverlib/eeprom.h"
+#include "../../backend/application/eeprom_handler.h"
+#include "../../backend/application/config_store.h"
+#include "../../backend/application/credentials.h"
+#include "../../backend/application/pin_hash.h"
+#include "../../backend/application/uart_protocol.h"
+#include "../../backend/application/uart_commands.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include <string.h>
+
+/*===========================================================================
+ * Stand-ins for the services the command handlers call
+ *===========================================================================*/
+static uint8_t last_cmd;
+static uint8_t last_status;
+static uint32_t responses;
+static UART_ReqTag_t current_req;
+static UART_ReqTag_t last_req;
+static uint32_t door_opens;
+static uint32_t door_seconds;
+static uint32_t buzzer_seconds;
+static uint8_t last_data[32];
+static uint8_t last_len;
+
+void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len)
+{
+    if (data_len > 0)
+    {
+        memcpy(last_data, data, data_len);
+    }
+    last_len = data_len;
+    last_cmd = cmd;
+    last_status = status;
+    last_req = current_req;
+    responses++;
+}
+
+UART_ReqTag_t UART_Protocol_CurrentRequest(void)
+{
+    return current_req;
+}
+
+void UART_Protocol_SendResponseTo(UART_ReqTag_t req, uint8_t cmd, uint8_t status,
+                                  uint8_t *data, uint8_t data_len)
+{
+    UART_ReqTag_t handling = current_req;
+
+    current_req = req;
+    UART_Protocol_SendResponse(cmd, status, data, data_len);
+    current_req = handling;
+}
+
+void DoorController_OpenDoor(uint32_t seconds)
+{
+    door_opens++;
+    door_seconds = seconds;
+}
+
+void BuzzerService_Activate(uint32_t seconds)
+{
+    buzzer_seconds = seconds;
+}
+
+/* The clock is only read through Credentials_Today; ticks are not needed */
+void SoftTimer_StartPeriodic(SoftTimer_t *timer, uint32_t period_ms,
+                             SoftTimer_Callback_t callback, void *arg)
+{
+    (void)timer;
+    (void)period_ms;
+    (void)callback;
+    (void)arg;
+}
+
+/*===========================================================================
+ * Legacy handler (as shipped before the RAM mirror): one EEPROM access per
+ * call, every write programmed
+ *===========================================================================*/
+static int legacy_program(uint32_t offset, uint32_t value)
+{
+    uint32_t data[1];
+    data[0] = value;
+    if (EEPROMProgram(data, offset, sizeof(data)) != 0)
+    {
+        return STATUS_ERROR;
+    }
+    return STATUS_OK;
+}
+
+static int legacy_authenticate(uint32_t candidate_password)
+{
+    uint32_t stored_password[1];
+    EEPROMRead(stored_password, PASSWORD_OFFSET, sizeof(stored_password));
+    return stored_password[0] == candidate_password ? STATUS_OK : STATUS_AUTH_FAIL;
+}
+
+static int legacy_get_auto_timeout(uint32_t *timeout)
+{
+    uint32_t data[1];
+    EEPROMRead(data, TIMEOUT_OFFSET, sizeof(data));
+    *timeout = data[0];
+    return STATUS_OK;
+}
+
+/* The EEPROM calls each command makes in uart_commands.c, legacy handler */
+static void legacy_command(const uint8_t *buf, uint32_t pw)
+{
+    uint32_t timeout;
+
+    switch (buf[0])
+    {
+    case CMD_AUTH:
+        if (legacy_authenticate(pw) == STATUS_OK && buf[1] == 0x01)
+        {
+            legacy_get_auto_timeout(&timeout);
+        }
+        break;
+    case CMD_SET_TIMEOUT:
+        legacy_program(TIMEOUT_OFFSET, buf[1]);
+        break;
+    case CMD_CHANGE_PASSWORD:
+        legacy_program(PASSWORD_OFFSET, pw);
+        break;
+    case CMD_GET_TIMEOUT:
+        legacy_get_auto_timeout(&timeout);
+        break;
+    default:
+        break;
+    }
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+/* Main loop passes until pending commits are done */
+static void settle(void)
+{
+    while (eeprom_handler_process() || ConfigStore_Process())
+    {
+    }
+}
+
+/* Power cycle: the boot sequence from main.c on the current contents,
+ * then the main loop until idle */
+static void reboot(void)
+{
+    EEPROMInit();
+    eeprom_handler_init();
+    set_default_auto_timeout();
+    settle();
+}
+
+/* Part left by the old firmware with the given configuration */
+static void boot(uint32_t password, uint32_t timeout)
+{
+    FakeEEPROM_Reset();
+    FakeEEPROM_Poke(PASSWORD_OFFSET, password);
+    FakeEEPROM_Poke(TIMEOUT_OFFSET, timeout);
+    reboot();
+}
+
+static uint8_t frame_pin(uint8_t *buf, uint8_t at, uint32_t pw)
+{
+    for (int8_t i = 4; i >= 0; i--)
+    {
+        buf[at + i] = (uint8_t)('0' + pw % 10);
+        pw /= 10;
+    }
+    return (uint8_t)(at + 5);
+}
+
+static void send_auth(uint8_t mode, uint32_t pw)
+{
+    uint8_t buf[7] = {CMD_AUTH, mode};
+    CMD_Auth(buf, frame_pin(buf, 2, pw));
+}
+
+static void send_set_timeout(uint8_t seconds)
+{
+    uint8_t buf[2] = {CMD_SET_TIMEOUT, seconds};
+    CMD_SetTimeout(buf, 2);
+}
+
+/* CMD_ADD_USER with an optional validity window (days) */
+static void send_add_user(uint16_t id, uint8_t flags, uint32_t pin, uint16_t from, uint16_t until)
+{
+    uint8_t buf[13] = {CMD_ADD_USER, (uint8_t)(id >> 8), (uint8_t)id, flags};
+    uint8_t len = frame_pin(buf, 4, pin);
+
+    if (from != 0 || until != 0)
+    {
+        buf[len++] = (uint8_t)(from >> 8);
+        buf[len++] = (uint8_t)from;
+        buf[len++] = (uint8_t)(until >> 8);
+        buf[len++] = (uint8_t)until;
+    }
+    CMD_AddUser(buf, len);
+}
+
+static void send_user_cmd(uint8_t cmd, uint16_t id)
+{
+    uint8_t buf[3] = {cmd, (uint8_t)(id >> 8), (uint8_t)id};
+
+    if (cmd == CMD_REMOVE_USER)
+    {
+        CMD_RemoveUser(buf, 3);
+    }
+    else
+    {
+        CMD_ListUsers(buf, 3);
+    }
+}
+
+/* Number of EEPROM words holding this value, anywhere in the part */
+static uint32_t words_equal(uint32_t value)
+{
+    uint32_t n = 0;
+
+    for (uint32_t a = 0; a < FAKE_EEPROM_WORDS * 4; a += 4)
+    {
+        n += (FakeEEPROM_Peek(a) == value) ? 1 : 0;
+    }
+    return n;
+}
+
+static int commit_status;
+static uint32_t commit_tag;
+static uint32_t commit_calls;
+
+static void on_commit(int status, uint32_t tag)
+{
+    commit_status = status;
+    commit_tag = tag;
+    commit_calls++;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_boot_loads_config_once(void)
+{
+    FakeEEPROM_Stats_t st;
+    ConfigStore_Info_t info;
+    uint32_t timeout;
+
+    /* First boot moves the old words into the store: the timeout, the
+     * password as its hash, and the hash salt and cost */
+    boot(12345, 20);
+    ConfigStore_GetInfo(&info);
+    TEST_ASSERT_EQUAL(3, info.live_keys);
+
+    /* Later boots only scan the store */
+    FakeEEPROM_ClearStats();
+    reboot();
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+    TEST_ASSERT(st.read_calls <= 2 * CONFIG_STORE_BLOCKS + CONFIG_WORDS + 2 + CREDENTIALS_BLOCKS);
+
+    FakeEEPROM_ClearStats();
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, authenticate(12345, NULL));
+        TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(54321, NULL));
+        TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+        TEST_ASSERT_EQUAL(20, timeout);
+    }
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.read_calls);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+
+    TEST_PASS();
+}
+
+static TestResult test_default_timeout_on_blank_part(void)
+{
+    FakeEEPROM_Stats_t st;
+    uint32_t timeout;
+
+    /* Erased part: the default is written once... */
+    FakeEEPROM_Reset();
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(DEFAULT_TIMEOUT, timeout);
+
+    /* ...and found on the next boot */
+    FakeEEPROM_ClearStats();
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(DEFAULT_TIMEOUT, timeout);
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+
+    TEST_PASS();
+}
+
+static TestResult test_unchanged_write_skipped(void)
+{
+    FakeEEPROM_Stats_t st;
+    uint32_t timeout;
+
+    boot(12345, 20);
+    FakeEEPROM_ClearStats();
+    TEST_ASSERT_EQUAL(STATUS_OK, change_auto_timeout(20));
+    TEST_ASSERT_EQUAL(STATUS_OK, change_password(12345));
+    TEST_ASSERT_EQUAL(STATUS_OK, initialize_password(12345));
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+    TEST_ASSERT_EQUAL(0, st.read_calls);
+
+    /* A real change is accepted into RAM at once... */
+    TEST_ASSERT_EQUAL(STATUS_OK, change_auto_timeout(25));
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(25, timeout);
+
+    /* ...and the main loop appends one record and reads it back */
+    TEST_ASSERT(eeprom_handler_process());
+    TEST_ASSERT(!eeprom_handler_process());
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(1, st.program_calls);
+    TEST_ASSERT_EQUAL(1, st.read_calls);
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(25, timeout);
+
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(25, timeout);
+
+    TEST_PASS();
+}
+
+static TestResult test_failed_commit_retried(void)
+{
+    uint32_t timeout;
+
+    boot(12345, 20);
+    TEST_ASSERT_EQUAL(STATUS_OK, change_auto_timeout(9));
+    TEST_ASSERT_EQUAL(STATUS_PENDING, notify_when_durable(CONFIG_KEY_TIMEOUT, on_commit, 7));
+    commit_calls = 0;
+
+    /* One failure leaves the key pending; the next pass commits it */
+    FakeEEPROM_FailNextProgram(EEPROM_RC_WRBUSY);
+    TEST_ASSERT(eeprom_handler_process());
+    TEST_ASSERT_EQUAL(0, commit_calls);
+    TEST_ASSERT(eeprom_handler_process());
+    TEST_ASSERT_EQUAL(1, commit_calls);
+    TEST_ASSERT_EQUAL(STATUS_OK, commit_status);
+    TEST_ASSERT_EQUAL(7, commit_tag);
+
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(9, timeout);
+
+    TEST_PASS();
+}
+
+static TestResult test_failed_commit_rolls_back(void)
+{
+    uint32_t timeout;
+
+    boot(12345, 20);
+    TEST_ASSERT_EQUAL(STATUS_OK, change_auto_timeout(9));
+    TEST_ASSERT_EQUAL(STATUS_PENDING, notify_when_durable(CONFIG_KEY_TIMEOUT, on_commit, 0));
+    commit_calls = 0;
+    for (uint32_t i = 0; i < COMMIT_RETRIES; i++)
+    {
+        FakeEEPROM_FailNextProgram(EEPROM_RC_WRBUSY);
+        TEST_ASSERT(eeprom_handler_process());
+    }
+    TEST_ASSERT(!eeprom_handler_process());
+    TEST_ASSERT_EQUAL(1, commit_calls);
+    TEST_ASSERT_EQUAL(STATUS_ERROR, commit_status);
+
+    /* RAM agrees with the EEPROM again */
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(20, timeout);
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(20, timeout);
+
+    /* Not cached as written, so a retry really programs */
+    TEST_ASSERT_EQUAL(STATUS_OK, change_auto_timeout(9));
+    TEST_ASSERT_EQUAL(STATUS_OK, eeprom_handler_flush());
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(9, timeout);
+
+    TEST_PASS();
+}
+
+static TestResult test_verify_catches_bad_write(void)
+{
+    boot(12345, 20);
+    TEST_ASSERT_EQUAL(STATUS_OK, change_password(11111));
+    for (uint32_t i = 0; i < COMMIT_RETRIES; i++)
+    {
+        FakeEEPROM_CorruptNextProgram(0x00000100);
+        TEST_ASSERT(eeprom_handler_process());
+    }
+
+    /* The bad record never becomes current, before or after a reboot */
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(11111, NULL));
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(12345, NULL));
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(11111, NULL));
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(12345, NULL));
+
+    TEST_ASSERT_EQUAL(STATUS_OK, change_password(11111));
+    settle();
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(11111, NULL));
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(12345, NULL));
+
+    TEST_PASS();
+}
+
+static TestResult test_changes_coalesced(void)
+{
+    FakeEEPROM_Stats_t st;
+    uint32_t timeout;
+
+    boot(12345, 20);
+    FakeEEPROM_ClearStats();
+    for (uint8_t s = 5; s <= 30; s++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, change_auto_timeout(s));
+    }
+    settle();
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(1, st.program_calls);
+
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, get_auto_timeout(&timeout));
+    TEST_ASSERT_EQUAL(30, timeout);
+
+    TEST_PASS();
+}
+
+static TestResult test_accepted_mode_answers_at_once(void)
+{
+    FakeEEPROM_Stats_t st;
+
+    boot(12345, 20);
+    CMD_SetCommitMode(CMD_COMMIT_ACCEPTED);
+    FakeEEPROM_ClearStats();
+    responses = 0;
+
+    send_set_timeout(12);
+    TEST_ASSERT_EQUAL(1, responses);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+
+    settle();
+    TEST_ASSERT_EQUAL(1, responses);
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(1, st.program_calls);
+
+    TEST_PASS();
+}
+
+static TestResult test_durable_mode_waits_for_commit(void)
+{
+    boot(12345, 20);
+    CMD_SetCommitMode(CMD_COMMIT_DURABLE);
+    responses = 0;
+
+    /* Held until the main loop commits, then sent for that request */
+    current_req = 0x0211;
+    send_set_timeout(12);
+    current_req = 0x0212;
+    send_auth(0x00, 12345);
+    TEST_ASSERT_EQUAL(1, responses);
+    TEST_ASSERT_EQUAL(CMD_AUTH, last_cmd);
+
+    settle();
+    TEST_ASSERT_EQUAL(2, responses);
+    TEST_ASSERT_EQUAL(CMD_SET_TIMEOUT, last_cmd);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(0x0211, last_req);
+
+    /* Unchanged value: nothing to wait for */
+    send_set_timeout(12);
+    TEST_ASSERT_EQUAL(3, responses);
+
+    /* Invalid value: answered at once */
+    send_set_timeout(99);
+    TEST_ASSERT_EQUAL(4, responses);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR, last_status);
+
+    /* A dropped change is reported as an error */
+    send_set_timeout(13);
+    for (uint32_t i = 0; i < COMMIT_RETRIES; i++)
+    {
+        FakeEEPROM_FailNextProgram(EEPROM_RC_WRBUSY);
+        eeprom_handler_process();
+    }
+    TEST_ASSERT_EQUAL(5, responses);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR, last_status);
+
+    CMD_SetCommitMode(CMD_COMMIT_MODE_DEFAULT);
+    TEST_PASS();
+}
+
+static TestResult test_commit_mode_command(void)
+{
+    uint8_t durable[2] = {CMD_COMMIT_MODE, CMD_COMMIT_DURABLE};
+    uint8_t accepted[2] = {CMD_COMMIT_MODE, CMD_COMMIT_ACCEPTED};
+    uint8_t bad[2] = {CMD_COMMIT_MODE, 7};
+
+    boot(12345, 20);
+    responses = 0;
+
+    CMD_CommitMode(durable, 2);
+    TEST_ASSERT_EQUAL(CMD_COMMIT_MODE, last_cmd);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    send_set_timeout(12);
+    TEST_ASSERT_EQUAL(1, responses);
+    settle();
+    TEST_ASSERT_EQUAL(2, responses);
+
+    /* A bad mode is refused and leaves the mode as it was */
+    CMD_CommitMode(bad, 2);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR, last_status);
+    send_set_timeout(13);
+    TEST_ASSERT_EQUAL(3, responses);
+
+    settle();
+    CMD_CommitMode(accepted, 2);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    send_set_timeout(14);
+    TEST_ASSERT_EQUAL(6, responses);
+
+    CMD_SetCommitMode(CMD_COMMIT_MODE_DEFAULT);
+    TEST_PASS();
+}
+
+static TestResult test_durable_mode_waiters_full(void)
+{
+    FakeEEPROM_Stats_t st;
+
+    boot(12345, 20);
+    CMD_SetCommitMode(CMD_COMMIT_DURABLE);
+    FakeEEPROM_ClearStats();
+    responses = 0;
+
+    /* A full waiter pool makes the next write commit inline; that also
+     * answers everyone already waiting */
+    for (uint8_t i = 0; i < COMMIT_WAITERS; i++)
+    {
+        send_set_timeout((uint8_t)(5 + i));
+    }
+    TEST_ASSERT_EQUAL(0, responses);
+    send_set_timeout(25);
+    TEST_ASSERT_EQUAL(COMMIT_WAITERS + 1, responses);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(1, st.program_calls);
+    TEST_ASSERT(!eeprom_handler_process());
+
+    CMD_SetCommitMode(CMD_COMMIT_MODE_DEFAULT);
+    TEST_PASS();
+}
+
+static TestResult test_auth_command_served_from_ram(void)
+{
+    FakeEEPROM_Stats_t st;
+
+    boot(12345, 17);
+    FakeEEPROM_ClearStats();
+    door_opens = 0;
+
+    send_auth(0x01, 12345);
+    TEST_ASSERT_EQUAL(CMD_AUTH, last_cmd);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(1, door_opens);
+    TEST_ASSERT_EQUAL(17, door_seconds);
+
+    send_auth(0x01, 12346);
+    TEST_ASSERT_EQUAL(UART_STATUS_AUTH_FAIL, last_status);
+    TEST_ASSERT_EQUAL(1, door_opens);
+
+    uint8_t get[1] = {CMD_GET_TIMEOUT};
+    CMD_GetTimeout(get, 1);
+    TEST_ASSERT_EQUAL(17, buzzer_seconds);
+
+    FakeEEPROM_GetStats(&st);
+    TEST_ASSERT_EQUAL(0, st.read_calls);
+    TEST_ASSERT_EQUAL(0, st.program_calls);
+
+    TEST_PASS();
+}
+
+static TestResult test_user_pin_opens_door(void)
+{
+    boot(12345, 17);
+    door_opens = 0;
+
+    send_add_user(7, 0, 24680, 0, 0);
+    TEST_ASSERT_EQUAL(CMD_ADD_USER, last_cmd);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    send_auth(0x01, 24680);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(1, door_opens);
+
+    /* The PIN is taken; the master password still works */
+    send_add_user(8, 0, 24680, 0, 0);
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR, last_status);
+    TEST_ASSERT_EQUAL(1, last_len);
+    TEST_ASSERT_EQUAL(CREDENTIALS_PIN_IN_USE, last_data[0]);
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(12345, NULL));
+
+    /* Kept across a reboot, gone once removed */
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(24680, NULL));
+    send_user_cmd(CMD_REMOVE_USER, 7);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    send_auth(0x01, 24680);
+    TEST_ASSERT_EQUAL(UART_STATUS_AUTH_FAIL, last_status);
+    send_user_cmd(CMD_REMOVE_USER, 7);
+    TEST_ASSERT_EQUAL(CREDENTIALS_NOT_FOUND, last_data[0]);
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(24680, NULL));
+
+    TEST_PASS();
+}
+
+static TestResult test_user_window_and_flags(void)
+{
+    uint8_t clock[5] = {CMD_SET_CLOCK, 0, 0, 0, 0};
+    uint32_t now = 20000UL * 86400 + 3600;     /* Day 20000 */
+
+    boot(12345, 17);
+    send_add_user(1, 0, 11111, 19990, 20010);
+    send_add_user(2, 0, 22222, 20001, 0);
+    send_add_user(3, CREDENTIALS_FLAG_DISABLED, 33333, 0, 0);
+
+    /* No clock yet: windowed users are refused */
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(11111, NULL));
+
+    clock[1] = (uint8_t)(now >> 24);
+    clock[2] = (uint8_t)(now >> 16);
+    clock[3] = (uint8_t)(now >> 8);
+    clock[4] = (uint8_t)now;
+    CMD_SetClock(clock, sizeof(clock));
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(20000, Credentials_Today());
+
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(11111, NULL));
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(22222, NULL));    /* Not yet */
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(33333, NULL));    /* Disabled */
+
+    TEST_PASS();
+}
+
+static TestResult test_add_user_rejects_non_digits(void)
+{
+    uint8_t buf[9] = {CMD_ADD_USER, 0, 9, 0, '1', '2', 'x', '4', '5'};
+
+    boot(12345, 17);
+    CMD_AddUser(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(UART_STATUS_ERROR, last_status);
+    TEST_ASSERT_EQUAL(1, last_len);
+    TEST_ASSERT_EQUAL(CREDENTIALS_ERROR, last_data[0]);
+
+    /* Nothing enrolled, in particular not PIN 00000 */
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(0, NULL));
+    send_user_cmd(CMD_REMOVE_USER, 9);
+    TEST_ASSERT_EQUAL(CREDENTIALS_NOT_FOUND, last_data[0]);
+
+    TEST_PASS();
+}
+
+static TestResult test_menu_gate_needs_admin(void)
+{
+    uint8_t flags = 0xFF;
+
+    boot(12345, 17);
+    door_opens = 0;
+    send_add_user(4, 0, 24680, 0, 0);
+    send_add_user(5, CREDENTIALS_FLAG_ADMIN, 13579, 0, 0);
+
+    /* Any user opens the door */
+    send_auth(0x01, 24680);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(1, door_opens);
+
+    /* Only the master password and admins pass the menu check */
+    send_auth(0x00, 24680);
+    TEST_ASSERT_EQUAL(UART_STATUS_AUTH_FAIL, last_status);
+    send_auth(0x00, 13579);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    send_auth(0x00, 12345);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(1, door_opens);
+
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(24680, &flags));
+    TEST_ASSERT_EQUAL(0, flags);
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(12345, &flags));
+    TEST_ASSERT_EQUAL(CREDENTIALS_FLAG_ADMIN, flags);
+
+    TEST_PASS();
+}
+
+static TestResult test_list_users_pages(void)
+{
+    static const uint16_t ids[] = {40, 3, 500, 12, 7};
+
+    boot(12345, 17);
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        send_add_user(ids[i], (uint8_t)i, 10000 + ids[i], 0, (uint16_t)(100 + i));
+    }
+
+    /* Three entries fit one frame, in id order */
+    send_user_cmd(CMD_LIST_USERS, 0);
+    TEST_ASSERT_EQUAL(UART_STATUS_OK, last_status);
+    TEST_ASSERT_EQUAL(3 * CMD_LIST_ENTRY_LEN, last_len);
+    TEST_ASSERT_EQUAL(3, last_data[1]);
+    TEST_ASSERT_EQUAL(7, last_data[CMD_LIST_ENTRY_LEN + 1]);
+    TEST_ASSERT_EQUAL(12, last_data[2 * CMD_LIST_ENTRY_LEN + 1]);
+    TEST_ASSERT_EQUAL(1, last_data[2]);                 /* Flags of id 3 */
+    TEST_ASSERT_EQUAL(101, last_data[6]);               /* Until of id 3 */
+
+    send_user_cmd(CMD_LIST_USERS, 13);
+    TEST_ASSERT_EQUAL(2 * CMD_LIST_ENTRY_LEN, last_len);
+    TEST_ASSERT_EQUAL(40, last_data[1]);
+    TEST_ASSERT_EQUAL(500 >> 8, last_data[CMD_LIST_ENTRY_LEN]);
+    TEST_ASSERT_EQUAL(500 & 0xFF, last_data[CMD_LIST_ENTRY_LEN + 1]);
+
+    send_user_cmd(CMD_LIST_USERS, 501);
+    TEST_ASSERT_EQUAL(0, last_len);
+
+    TEST_PASS();
+}
+
+static TestResult test_password_stored_hashed(void)
+{
+    uint32_t word;
+
+    /* The old cleartext word and the store record are both gone */
+    boot(12345, 20);
+    TEST_ASSERT_EQUAL(0, words_equal(12345));
+    TEST_ASSERT_EQUAL(0, ConfigStore_Read(CONFIG_KEY_PASSWORD, &word, 1));
+    TEST_ASSERT_EQUAL(1, ConfigStore_Read(CONFIG_KEY_PASSWORD_HASH, &word, 1));
+    TEST_ASSERT_EQUAL(PinHash_Hash(12345), word);
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(12345, NULL));
+
+    /* Changes and user PINs are hashed too */
+    TEST_ASSERT_EQUAL(STATUS_OK, change_password(11111));
+    send_add_user(4, 0, 24680, 0, 0);
+    settle();
+    reboot();
+    TEST_ASSERT_EQUAL(0, words_equal(11111));
+    TEST_ASSERT_EQUAL(0, words_equal(24680));
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(11111, NULL));
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(24680, NULL));
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(12345, NULL));
+
+    TEST_PASS();
+}
+
+/* Firmware before the hash left the cleartext in a store record, and the
+ * old fixed word still held it as well */
+static void boot_with_cleartext_record(uint32_t password)
+{
+    FakeEEPROM_Reset();
+    FakeEEPROM_Poke(PASSWORD_OFFSET, password);
+    EEPROMInit();
+    ConfigStore_Init();
+    ConfigStore_Write(CONFIG_KEY_PASSWORD, &password, 1);
+    password += 1111;
+    ConfigStore_Write(CONFIG_KEY_PASSWORD, &password, 1);
+}
+
+static TestResult test_cleartext_wiped_after_reset(void)
+{
+    uint32_t cuts = 0;
+
+    /* Cut the power at every programmed word of the first boot */
+    for (uint32_t cut = 0; ; cut++)
+    {
+        boot_with_cleartext_record(12345);
+        FakeEEPROM_PowerFailAfter(cut);
+        reboot();
+        bool lost = FakeEEPROM_PowerLost();
+        FakeEEPROM_PowerRestore();
+        reboot();
+
+        /* The newest password works and no copy of either is left */
+        TEST_ASSERT_EQUAL(STATUS_OK, authenticate(13456, NULL));
+        TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(12345, NULL));
+        TEST_ASSERT_EQUAL(0, words_equal(12345));
+        TEST_ASSERT_EQUAL(0, words_equal(13456));
+        if (!lost)
+        {
+            break;
+        }
+        cuts++;
+    }
+    TEST_ASSERT(cuts >= 5);
+
+    TEST_PASS();
+}
+
+static TestResult test_zero_cleartext_wiped(void)
+{
+    uint32_t password = 0;
+
+    /* PIN 00000: a zeroed value is still a valid record of 0 */
+    FakeEEPROM_Reset();
+    FakeEEPROM_Poke(PASSWORD_OFFSET, password);
+    EEPROMInit();
+    ConfigStore_Init();
+    ConfigStore_Write(CONFIG_KEY_PASSWORD, &password, 1);
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(0, NULL));
+
+    /* Rescan the log as the next boot would */
+    ConfigStore_Init();
+    TEST_ASSERT_EQUAL(0, ConfigStore_Read(CONFIG_KEY_PASSWORD, &password, 1));
+    reboot();
+    TEST_ASSERT_EQUAL(STATUS_OK, authenticate(0, NULL));
+    TEST_ASSERT_EQUAL(STATUS_AUTH_FAIL, authenticate(1, NULL));
+
+    TEST_PASS();
+}
+
+static TestResult test_hash_cost_kept_once_used(void)
+{
+    PinHash_Params_t params;
+    uint32_t stored[3];
+
+    /* First boot stores the calibrated cost with a fresh salt */
+    boot(12345, 20);
+    PinHash_GetParams(&params);
+    TEST_ASSERT_EQUAL(PIN_HASH_MIN_ITERATIONS, params.iterations);
+    TEST_ASSERT_EQUAL(3, ConfigStore_Read(CONFIG_KEY_PIN_HASH, stored, 3));
+    TEST_ASSERT_EQUAL(params.salt[0], stored[0]);
+    TEST_ASSERT_EQUAL(params.salt[1], stored[1]);
+    TEST_ASSERT_EQUAL(params.iterations, stored[2]);
+
+    /* With a hash stored, a cost far from the calibration is kept... */
+    stored[2] = 1000;
+    ConfigStore_Write(CONFIG_KEY_PIN_HASH, stored, 3);
+    reboot();
+    PinHash_GetParams(&params);
+    TEST_ASSERT_EQUAL(1000, params.iterations);
+    TEST_ASSERT_EQUAL(stored[0], params.salt[0]);
+
+    /* ...and retuned once nothing depends on it */
+    FakeEEPROM_Reset();
+    EEPROMInit();
+    ConfigStore_Init();
+    ConfigStore_Write(CONFIG_KEY_PIN_HASH, stored, 3);
+    reboot();
+    PinHash_GetParams(&params);
+    TEST_ASSERT_EQUAL(PIN_HASH_MIN_ITERATIONS, params.iterations);
+    TEST_ASSERT_EQUAL(stored[0], params.salt[0]);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *
+ * A command mix shaped like the frontend's traffic: most sessions unlock
+ * the door (CMD_AUTH mode 1), some mistype and three misses in a row lock
+ * the keypad out (CMD_GET_TIMEOUT). Menu sessions check the PIN (mode 0)
+ * and then set the timeout - often to the value it already has, since
+ * the potentiometer page sends whatever is on screen - or change the PIN.
+ *===========================================================================*/
+#define BENCH_SESSIONS  10000
+
+typedef struct
+{
+    uint8_t buf[7];
+    uint8_t len;
+    uint32_t pw;
+} bench_cmd_t;
+
+static bench_cmd_t mix[BENCH_SESSIONS * 3];
+static uint32_t mix_len;
+
+static uint32_t lcg_state = 1;
+
+static uint32_t lcg(void)
+{
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return (lcg_state >> 16) & 0x7FFF;
+}
+
+static void mix_auth(uint8_t mode, uint32_t pw)
+{
+    bench_cmd_t *c = &mix[mix_len++];
+    c->buf[0] = CMD_AUTH;
+    c->buf[1] = mode;
+    c->len = frame_pin(c->buf, 2, pw);
+    c->pw = pw;
+}
+
+static void build_mix(uint32_t password, uint8_t timeout)
+{
+    uint32_t misses = 0;
+
+    mix_len = 0;
+    lcg_state = 1;
+    for (uint32_t s = 0; s < BENCH_SESSIONS; s++)
+    {
+        uint32_t r = lcg() % 100;
+        if (r < 80)
+        {
+            /* Unlock: 1 in 10 mistyped */
+            bool wrong = (lcg() % 10) == 0;
+            mix_auth(0x01, wrong ? password + 1 : password);
+            misses = wrong ? misses + 1 : 0;
+            if (misses == 3)
+            {
+                bench_cmd_t *c = &mix[mix_len++];
+                c->buf[0] = CMD_GET_TIMEOUT;
+                c->len = 1;
+                misses = 0;
+            }
+        }
+        else if (r < 97)
+        {
+            /* Timeout menu: half the time the value is unchanged */
+            mix_auth(0x00, password);
+            if (lcg() % 2)
+            {
+                timeout = (uint8_t)(5 + lcg() % 26);
+            }
+            bench_cmd_t *c = &mix[mix_len++];
+            c->buf[0] = CMD_SET_TIMEOUT;
+            c->buf[1] = timeout;
+            c->len = 2;
+        }
+        else
+        {
+            /* Change PIN: 1 in 5 re-enters the same one */
+            mix_auth(0x00, password);
+            if (lcg() % 5)
+            {
+                password = 10000 + lcg() % 90000;
+            }
+            bench_cmd_t *c = &mix[mix_len++];
+            c->buf[0] = CMD_CHANGE_PASSWORD;
+            c->len = frame_pin(c->buf, 1, password);
+            c->pw = password;
+        }
+    }
+}
+
+static void run_command(bench_cmd_t *c)
+{
+    switch (c->buf[0])
+    {
+    case CMD_AUTH:            CMD_Auth(c->buf, c->len); break;
+    case CMD_SET_TIMEOUT:     CMD_SetTimeout(c->buf, c->len); break;
+    case CMD_CHANGE_PASSWORD: CMD_ChangePassword(c->buf, c->len); break;
+    case CMD_GET_TIMEOUT:     CMD_GetTimeout(c->buf, c->len); break;
+    default: break;
+    }
+}
+
+static void print_stats(const char *name, const FakeEEPROM_Stats_t *st)
+{
+    printf("    %-8s reads %6u (%6u words)  programs %5u  EEPROM time %8.1f ms\n",
+           name, (unsigned)st->read_calls, (unsigned)st->read_words,
+           (unsigned)st->program_calls, st->cycles * 1000.0 / FAKE_SYSTEM_CLOCK);
+}
+
+static void bench_command_mix(void)
+{
+    FakeEEPROM_Stats_t legacy, mirror;
+    uint32_t counts[6] = {0};
+
+    build_mix(12345, 15);
+    for (uint32_t i = 0; i < mix_len; i++)
+    {
+        counts[mix[i].buf[0]]++;
+    }
+    printf("    %u commands: %u AUTH, %u SET_TIMEOUT, %u CHANGE_PASSWORD, %u GET_TIMEOUT\n",
+           (unsigned)mix_len, (unsigned)counts[CMD_AUTH], (unsigned)counts[CMD_SET_TIMEOUT],
+           (unsigned)counts[CMD_CHANGE_PASSWORD], (unsigned)counts[CMD_GET_TIMEOUT]);
+
+    /* Both runs include the boot sequence */
+    FakeEEPROM_Reset();
+    FakeEEPROM_Poke(PASSWORD_OFFSET, 12345);
+    FakeEEPROM_Poke(TIMEOUT_OFFSET, 15);
+    uint32_t timeout;
+    legacy_get_auto_timeout(&timeout);
+    for (uint32_t i = 0; i < mix_len; i++)
+    {
+        legacy_command(mix[i].buf, mix[i].pw);
+    }
+    FakeEEPROM_GetStats(&legacy);
+    uint32_t legacy_pw = FakeEEPROM_Peek(PASSWORD_OFFSET);
+    uint32_t legacy_to = FakeEEPROM_Peek(TIMEOUT_OFFSET);
+
+    boot(12345, 15);
+    for (uint32_t i = 0; i < mix_len; i++)
+    {
+        run_command(&mix[i]);
+        settle();
+    }
+    FakeEEPROM_GetStats(&mirror);
+    reboot();
+
+    print_stats("legacy", &legacy);
+    print_stats("mirror", &mirror);
+    printf("    EEPROM accesses %u -> %u (%.1fx fewer)\n",
+           (unsigned)(legacy.read_calls + legacy.program_calls),
+           (unsigned)(mirror.read_calls + mirror.program_calls),
+           (double)(legacy.read_calls + legacy.program_calls) /
+               (mirror.read_calls + mirror.program_calls));
+    get_auto_timeout(&timeout);
+    printf("    contents after reboot match: %s\n",
+           (authenticate(legacy_pw, NULL) == STATUS_OK && legacy_to == timeout) ? "yes" : "NO");
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- EEPROM Configuration Mirror Tests ---\n");
+    run_test("Boot Loads Config Once", test_boot_loads_config_once);
+    run_test("Default Timeout On Blank Part", test_default_timeout_on_blank_part);
+    run_test("Unchanged Write Skipped", test_unchanged_write_skipped);
+    run_test("Failed Commit Retried", test_failed_commit_retried);
+    run_test("Failed Commit Rolls Back", test_failed_commit_rolls_back);
+    run_test("Verify Catches Bad Write", test_verify_catches_bad_write);
+    run_test("Changes Coalesced", test_changes_coalesced);
+    run_test("Accepted Mode Answers At Once", test_accepted_mode_answers_at_once);
+    run_test("Durable Mode Waits For Commit", test_durable_mode_waits_for_commit);
+    run_test("Durable Mode Waiters Full", test_durable_mode_waiters_full);
+    run_test("Commit Mode Command", test_commit_mode_command);
+    run_test("Auth Command Served From RAM", test_auth_command_served_from_ram);
+    run_test("User PIN Opens Door", test_user_pin_opens_door);
+    run_test("User Window And Flags", test_user_window_and_flags);
+    run_test("Menu Gate Needs Admin", test_menu_gate_needs_admin);
+    run_test("Add User Rejects Non-Digits", test_add_user_rejects_non_digits);
+    run_test("List Users Pages", test_list_users_pages);
+    run_test("Password Stored Hashed", test_password_stored_hashed);
+    run_test("Cleartext Wiped After Reset", test_cleartext_wiped_after_reset);
+    run_test("Zero Cleartext Wiped", test_zero_cleartext_wiped);
+    run_test("Hash Cost Kept Once Used", test_hash_cost_kept_once_used);
+
+    printf("\n--- EEPROM Operations, Command Mix (%u sessions) ---\n", BENCH_SESSIONS);
+    bench_command_mix();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
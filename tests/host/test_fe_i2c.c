@@ -0,0 +1,593 @@
+/*
+ * test_fe_i2c.c - Host tests for the frontend's interrupt-driven I2C0
+ * master and the LCD flushing through it
+ *
+ * Runs the real frontend/MCAL/i2c.c against the I2C0 master register
+ * model in fake_tm4c123 (one byte per MCS command, status bits and master
+ * interrupt at the end of each, timing from MTPR). Checks that queued
+ * transfers reach the device in order with their callbacks, that address
+ * and data NACKs fail only their own transfer and release the bus, that
+ * write-then-read turns the bus around with a repeated START, and that
+ * callbacks can queue more work, and that a bus held by a slave is freed
+ * instead of hanging the caller: SDA held low is clocked out (at init or
+ * when a START loses arbitration) and ended with a STOP, SCL held low
+ * times the transfer out and resets the module. A submit from a masked
+ * section, or from a callback the reset runs, leaves interrupts masked.
+ * Then runs the LCD driver
+ * and HD44780 model on top, checking that LCD_Init finds the backpack at
+ * either address and in fast mode, that LCD_Flush returns at once and the
+ * screen is right once the background transfers end.
+ *
+ * Ends with throughput: back-to-back LCD-sized bursts, reporting bus
+ * utilisation, ISR time per byte and how much CPU is left to the caller
+ * (the polled driver spun on MCS BUSY for the whole transfer).
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -include tests/host/fake_tm4c123.h -I tests/host/iar \
+ *       -I tests/host tests/host/test_fe_i2c.c tests/host/fake_tm4c123.c \
+ *       tests/host/fake_hd44780.c tests/test_common.c \
+ *       frontend/MCAL/i2c.c frontend/MCAL/systick.c frontend/HAL/lcd.c \
+ *       -o test_fe_i2c
+ *   ./test_fe_i2c
+ */
+
+#include "../test_common.h"
+#include "fake_hd44780.h"
+#include "../../frontend/MCAL/i2c.h"
+#include "../../frontend/MCAL/systick.h"
+#include "../../frontend/HAL/lcd.h"
+#include <intrinsics.h>
+#include <string.h>
+
+#define CYCLES_PER_MS       (FAKE_TM4C_CLOCK / 1000)
+#define BIT_CYCLES_100K     (FAKE_TM4C_CLOCK / I2C_SPEED_100K)
+#define TPR_400K            (FAKE_TM4C_CLOCK / (20 * I2C_SPEED_400K) - 1)
+#define MAX_SEEN            1024
+
+/*===========================================================================
+ * Device side
+ *===========================================================================*/
+static uint8_t seen[MAX_SEEN];
+static uint64_t seen_at[MAX_SEEN];
+static uint32_t seen_count;
+
+static void record(uint8_t byte, uint64_t cycle)
+{
+    if (seen_count < MAX_SEEN)
+    {
+        seen[seen_count] = byte;
+        seen_at[seen_count] = cycle;
+    }
+    seen_count++;
+}
+
+/* HD44780 model times in ns; 16 MHz = 62.5 ns per cycle. Reads return
+ * the last byte written, as a PCF8574 returns its pin levels. */
+static uint8_t lcd_port = 0xFF;
+
+static void lcd_pins(uint8_t byte, uint64_t cycle)
+{
+    lcd_port = byte;
+    FakeHD44780_Pins(byte, cycle * 125 / 2);
+}
+
+/* Completion order */
+static I2C_Transfer_t *done_order[16];
+static uint32_t done_count;
+
+static void on_done(I2C_Transfer_t *xfer)
+{
+    if (done_count < 16) done_order[done_count] = xfer;
+    done_count++;
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static void reset_bus(void)
+{
+    FakeTM4C_Init();
+    SysTick_Init(CYCLES_PER_MS, SYSTICK_INT);
+    I2C_Init(I2C_MODULE_0, I2C_SPEED_100K);
+    FakeTM4C_I2C0SetSink(record);
+    seen_count = 0;
+    done_count = 0;
+}
+
+static void fill(I2C_Transfer_t *xfer, uint8_t addr, const uint8_t *tx, uint8_t txLen,
+                 uint8_t *rx, uint8_t rxLen)
+{
+    memset(xfer, 0, sizeof(*xfer));
+    xfer->slaveAddr = addr;
+    xfer->txData = tx;
+    xfer->txLength = txLen;
+    xfer->rxData = rx;
+    xfer->rxLength = rxLen;
+    xfer->callback = on_done;
+}
+
+static FakeTM4C_I2CStats_t bus_stats(void)
+{
+    FakeTM4C_I2CStats_t s;
+    FakeTM4C_I2C0GetStats(&s);
+    return s;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_blocking_write(void)
+{
+    static const uint8_t data[5] = {0x11, 0x22, 0x33, 0x44, 0x55};
+    uint64_t c0, s0;
+
+    reset_bus();
+    c0 = FakeTM4C_Cycles();
+    s0 = FakeTM4C_SleepCycles();
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_WriteMultipleBytes(I2C_MODULE_0, 0x27, data, 5));
+    uint64_t took = FakeTM4C_Cycles() - c0;
+
+    TEST_ASSERT_EQUAL(5, seen_count);
+    TEST_ASSERT(memcmp(seen, data, 5) == 0);
+    /* START + address, 5 bytes, STOP = 56 bit times, plus interrupt
+     * latency; the caller sleeps meanwhile */
+    TEST_ASSERT(took >= 56 * BIT_CYCLES_100K && took <= 56 * BIT_CYCLES_100K + 600);
+    TEST_ASSERT(FakeTM4C_SleepCycles() - s0 > took * 8 / 10);
+    TEST_ASSERT_EQUAL(0, I2C_IsBusy(I2C_MODULE_0));
+
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_WriteByte(I2C_MODULE_0, 0x27, 0x66));
+    TEST_ASSERT_EQUAL(6, seen_count);
+    TEST_ASSERT_EQUAL(0x66, seen[5]);
+
+    TEST_PASS();
+}
+
+static TestResult test_queue_runs_in_order(void)
+{
+    static uint8_t data[5][8];
+    I2C_Transfer_t xfer[5];
+    uint64_t c0;
+
+    reset_bus();
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        for (uint8_t k = 0; k < 8; k++) data[i][k] = (uint8_t)(i * 16 + k);
+        fill(&xfer[i], 0x27, data[i], (uint8_t)(1 + i), NULL, 0);
+    }
+
+    /* Queuing returns at once */
+    c0 = FakeTM4C_Cycles();
+    for (uint8_t i = 0; i < 5; i++) TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_Submit(&xfer[i]));
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 < BIT_CYCLES_100K);
+    TEST_ASSERT_EQUAL(I2C_BUSY, xfer[4].status);
+    TEST_ASSERT_EQUAL(1, I2C_IsBusy(I2C_MODULE_0));
+
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_Wait(&xfer[4]));
+    TEST_ASSERT_EQUAL(5, done_count);
+    TEST_ASSERT_EQUAL(1 + 2 + 3 + 4 + 5, seen_count);
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT(done_order[i] == &xfer[i]);
+        TEST_ASSERT_EQUAL(I2C_SUCCESS, xfer[i].status);
+        for (uint8_t k = 0; k <= i; k++) TEST_ASSERT_EQUAL(data[i][k], seen[n++]);
+    }
+    TEST_ASSERT_EQUAL(5, bus_stats().starts);
+
+    TEST_PASS();
+}
+
+static TestResult test_address_nack(void)
+{
+    static const uint8_t data[4] = {1, 2, 3, 4};
+    I2C_Transfer_t bad, good;
+
+    reset_bus();
+    FakeTM4C_I2C0SetDevice(0x3F);
+
+    /* Blocking call reports it */
+    TEST_ASSERT_EQUAL(I2C_ERROR, I2C_WriteMultipleBytes(I2C_MODULE_0, 0x27, data, 4));
+    TEST_ASSERT_EQUAL(0, seen_count);
+
+    /* Queued: only the failing transfer fails, the next one still runs */
+    fill(&bad, 0x27, data, 4, NULL, 0);
+    fill(&good, 0x3F, data, 4, NULL, 0);
+    I2C_Submit(&bad);
+    I2C_Submit(&good);
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_Wait(&good));
+    TEST_ASSERT_EQUAL(I2C_ERROR, bad.status);
+    TEST_ASSERT_EQUAL(I2C_ERR_ADDR_NACK, bad.error);
+    TEST_ASSERT_EQUAL(0, good.error);
+    TEST_ASSERT_EQUAL(2, done_count);
+    TEST_ASSERT_EQUAL(4, seen_count);
+    TEST_ASSERT_EQUAL(0, I2C_IsBusy(I2C_MODULE_0));
+
+    TEST_PASS();
+}
+
+static TestResult test_data_nack(void)
+{
+    static const uint8_t data[6] = {10, 11, 12, 13, 14, 15};
+    I2C_Transfer_t first, second;
+
+    reset_bus();
+    FakeTM4C_I2C0NackByte(3);
+
+    fill(&first, 0x27, data, 6, NULL, 0);
+    fill(&second, 0x27, data, 2, NULL, 0);
+    I2C_Submit(&first);
+    I2C_Submit(&second);
+    I2C_Wait(&second);
+
+    /* Stops at the refused byte, sends STOP, then the next transfer runs */
+    TEST_ASSERT_EQUAL(I2C_ERROR, first.status);
+    TEST_ASSERT_EQUAL(I2C_ERR_DATA_NACK, first.error);
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, second.status);
+    TEST_ASSERT_EQUAL(3 + 2, seen_count);
+    TEST_ASSERT_EQUAL(12, seen[2]);
+    TEST_ASSERT_EQUAL(10, seen[3]);
+    TEST_ASSERT_EQUAL(2, bus_stats().starts);
+
+    TEST_PASS();
+}
+
+static TestResult test_write_then_read(void)
+{
+    static const uint8_t reply[3] = {0xA1, 0xB2, 0xC3};
+    static const uint8_t reg = 0x05;
+    uint8_t rx[3] = {0};
+    uint8_t one = 0;
+    I2C_Transfer_t xfer;
+
+    reset_bus();
+    FakeTM4C_I2C0SetReadData(reply, 3);
+
+    fill(&xfer, 0x27, &reg, 1, rx, 3);
+    I2C_Submit(&xfer);
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_Wait(&xfer));
+    TEST_ASSERT_EQUAL(1, seen_count);
+    TEST_ASSERT_EQUAL(reg, seen[0]);
+    TEST_ASSERT(memcmp(rx, reply, 3) == 0);
+    TEST_ASSERT_EQUAL(2, bus_stats().starts);     /* START + repeated START */
+
+    /* Blocking single read */
+    FakeTM4C_I2C0SetReadData(&reply[1], 1);
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_ReadByte(I2C_MODULE_0, 0x27, &one));
+    TEST_ASSERT_EQUAL(0xB2, one);
+
+    /* Nothing to do is refused */
+    fill(&xfer, 0x27, NULL, 0, NULL, 0);
+    TEST_ASSERT_EQUAL(I2C_ERROR, I2C_Submit(&xfer));
+
+    TEST_PASS();
+}
+
+static I2C_Transfer_t chain[3];
+static const uint8_t chain_data[3] = {0xC0, 0xC1, 0xC2};
+
+static void chain_next(I2C_Transfer_t *xfer)
+{
+    on_done(xfer);
+    if (xfer < &chain[2])
+    {
+        I2C_Transfer_t *next = xfer + 1;
+        fill(next, 0x27, &chain_data[next - chain], 1, NULL, 0);
+        next->callback = chain_next;
+        I2C_Submit(next);
+    }
+}
+
+static TestResult test_callback_chains(void)
+{
+    reset_bus();
+
+    fill(&chain[0], 0x27, &chain_data[0], 1, NULL, 0);
+    chain[0].callback = chain_next;
+    I2C_Submit(&chain[0]);
+    while (done_count < 3) FakeTM4C_Run(BIT_CYCLES_100K);
+
+    TEST_ASSERT_EQUAL(3, seen_count);
+    TEST_ASSERT(memcmp(seen, chain_data, 3) == 0);
+    TEST_ASSERT(done_order[2] == &chain[2]);
+
+    TEST_PASS();
+}
+
+/* Resubmits from the callback and notes whether that unmasked interrupts */
+static I2C_Transfer_t resubmit;
+static __istate_t state_after_resubmit;
+
+static void resubmit_on_done(I2C_Transfer_t *xfer)
+{
+    static const uint8_t data = 0xC3;
+
+    on_done(xfer);
+    fill(&resubmit, 0x27, &data, 1, NULL, 0);
+    I2C_Submit(&resubmit);
+    state_after_resubmit = __get_interrupt_state();
+}
+
+static TestResult test_submit_keeps_interrupt_state(void)
+{
+    static const uint8_t data[2] = {0xA5, 0x5A};
+    I2C_Transfer_t a;
+
+    /* From a masked section: still masked on return */
+    reset_bus();
+    __disable_interrupt();
+    fill(&a, 0x27, data, 2, NULL, 0);
+    I2C_Submit(&a);
+    TEST_ASSERT_EQUAL(1, __get_interrupt_state());
+    __enable_interrupt();
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_Wait(&a));
+
+    /* Callback run by the stall reset, inside I2C_Wait's masked check */
+    reset_bus();
+    FakeTM4C_I2C0HoldScl(true);
+    fill(&a, 0x27, data, 2, NULL, 0);
+    a.callback = resubmit_on_done;
+    I2C_Submit(&a);
+    TEST_ASSERT_EQUAL(I2C_ERROR, I2C_Wait(&a));
+    TEST_ASSERT_EQUAL(1, done_count);
+    TEST_ASSERT_EQUAL(1, state_after_resubmit);
+
+    FakeTM4C_I2C0HoldScl(false);
+    I2C_Wait(&resubmit);
+    TEST_ASSERT_EQUAL(0, __get_interrupt_state());
+
+    TEST_PASS();
+}
+
+static TestResult test_lcd_flush_in_background(void)
+{
+    FakeHD44780_Stats_t s;
+    uint64_t c0, took, scans = 0;
+
+    reset_bus();
+    FakeTM4C_I2C0SetSink(lcd_pins);
+    FakeTM4C_I2C0SetReadData(&lcd_port, 1);
+    FakeHD44780_Reset();
+    LCD_Init();
+
+    LCD_BufferWrite(0, 0, "Enter Password: ");
+    LCD_BufferWrite(1, 0, "*****     #=Back");
+    c0 = FakeTM4C_Cycles();
+    LCD_Flush();
+    took = FakeTM4C_Cycles() - c0;
+
+    /* Queued, not sent: the caller gets the CPU back straight away */
+    TEST_ASSERT(took < 2 * BIT_CYCLES_100K * 9);
+    TEST_ASSERT_EQUAL(1, I2C_IsBusy(I2C_MODULE_0));
+
+    /* Scan the "keypad" every 100 us while it goes out */
+    while (I2C_IsBusy(I2C_MODULE_0))
+    {
+        FakeTM4C_Run(FAKE_TM4C_CLOCK / 10000);
+        scans++;
+    }
+    FakeHD44780_GetStats(&s);
+    TEST_ASSERT(FakeHD44780_Shows("Enter Password: ", "*****     #=Back"));
+    TEST_ASSERT_EQUAL(0, s.violations);
+    TEST_ASSERT(scans > 10);
+
+    /* A direct write right after a flush waits for it */
+    LCD_BufferWrite(1, 0, "1234            ");
+    LCD_Flush();
+    LCD_SetCursor(1, 4);
+    LCD_WriteChar('5');
+    FakeHD44780_GetStats(&s);
+    TEST_ASSERT(FakeHD44780_Shows("Enter Password: ", "12345           "));
+    TEST_ASSERT_EQUAL(0, s.violations);
+    printf("    flush queued in %llu cycles, %llu keypad scans while it ran\n",
+           (unsigned long long)took, (unsigned long long)scans);
+
+    TEST_PASS();
+}
+
+static TestResult test_lcd_recovers_after_nack(void)
+{
+    reset_bus();
+    FakeTM4C_I2C0SetSink(lcd_pins);
+    FakeTM4C_I2C0SetReadData(&lcd_port, 1);
+    FakeHD44780_Reset();
+    LCD_Init();
+
+    /* The backpack drops off the bus for one flush */
+    FakeTM4C_I2C0SetDevice(0x00);
+    LCD_BufferWrite(0, 0, "Door Open");
+    LCD_Flush();
+    while (I2C_IsBusy(I2C_MODULE_0)) FakeTM4C_Run(BIT_CYCLES_100K);
+    FakeTM4C_I2C0SetDevice(0x27);
+
+    /* The next flush redraws everything, not just the newest change */
+    LCD_BufferWrite(1, 0, "Closing in: 10 s");
+    LCD_Flush();
+    while (I2C_IsBusy(I2C_MODULE_0)) FakeTM4C_Run(BIT_CYCLES_100K);
+    TEST_ASSERT(FakeHD44780_Shows("Door Open       ", "Closing in: 10 s"));
+
+    TEST_PASS();
+}
+
+static TestResult test_stuck_sda_freed_at_init(void)
+{
+    FakeTM4C_I2CStats_t st;
+
+    /* Reset while a slave was sending a 0 bit: it holds SDA until it has
+     * clocked out the rest of its byte */
+    FakeTM4C_Init();
+    SysTick_Init(CYCLES_PER_MS, SYSTICK_INT);
+    FakeTM4C_I2C0HoldSda(6);
+    I2C_Init(I2C_MODULE_0, I2C_SPEED_100K);
+    FakeTM4C_I2C0SetSink(record);
+    seen_count = 0;
+
+    st = bus_stats();
+    TEST_ASSERT_EQUAL(6 + 1, st.gpio_clocks);      /* Plus the STOP's */
+    TEST_ASSERT_EQUAL(1, st.gpio_stops);
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_WriteByte(I2C_MODULE_0, 0x27, 0x5A));
+    TEST_ASSERT_EQUAL(1, seen_count);
+
+    /* A free bus is left alone */
+    reset_bus();
+    st = bus_stats();
+    TEST_ASSERT_EQUAL(0, st.gpio_clocks);
+    TEST_ASSERT_EQUAL(0, st.gpio_stops);
+
+    TEST_PASS();
+}
+
+static TestResult test_stuck_sda_mid_run(void)
+{
+    static const uint8_t data[3] = {1, 2, 3};
+    I2C_Transfer_t a, b;
+
+    reset_bus();
+    FakeTM4C_I2C0HoldSda(3);
+    fill(&a, 0x27, data, 3, NULL, 0);
+    fill(&b, 0x27, data, 3, NULL, 0);
+    I2C_Submit(&a);
+    I2C_Submit(&b);
+
+    /* The first START loses arbitration; the bus is freed for the next */
+    TEST_ASSERT_EQUAL(I2C_ERROR, I2C_Wait(&a));
+    TEST_ASSERT_EQUAL(I2C_ERR_ARB_LOST, a.error);
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_Wait(&b));
+    TEST_ASSERT_EQUAL(3, seen_count);
+    TEST_ASSERT_EQUAL(1, bus_stats().gpio_stops);
+
+    TEST_PASS();
+}
+
+static TestResult test_stuck_scl_times_out(void)
+{
+    static const uint8_t data[2] = {0xA5, 0x5A};
+    I2C_Transfer_t a, b;
+    uint64_t c0, took;
+
+    reset_bus();
+    FakeTM4C_I2C0HoldScl(true);
+    fill(&a, 0x27, data, 2, NULL, 0);
+    fill(&b, 0x27, data, 2, NULL, 0);
+    I2C_Submit(&a);
+    I2C_Submit(&b);
+
+    c0 = FakeTM4C_Cycles();
+    TEST_ASSERT_EQUAL(I2C_ERROR, I2C_Wait(&a));
+    took = FakeTM4C_Cycles() - c0;
+    TEST_ASSERT_EQUAL(I2C_ERR_TIMEOUT, a.error);
+    TEST_ASSERT(took >= 9 * CYCLES_PER_MS && took <= 11 * CYCLES_PER_MS);
+
+    /* Still held: the next one times out as well, without hanging */
+    TEST_ASSERT_EQUAL(I2C_ERROR, I2C_Wait(&b));
+    TEST_ASSERT_EQUAL(I2C_ERR_TIMEOUT, b.error);
+    TEST_ASSERT_EQUAL(0, I2C_IsBusy(I2C_MODULE_0));
+
+    /* Once released, the reset module runs at the speed it had */
+    FakeTM4C_I2C0HoldScl(false);
+    c0 = FakeTM4C_Cycles();
+    TEST_ASSERT_EQUAL(I2C_SUCCESS, I2C_WriteMultipleBytes(I2C_MODULE_0, 0x27, data, 2));
+    took = FakeTM4C_Cycles() - c0;
+    TEST_ASSERT_EQUAL(2, seen_count);
+    TEST_ASSERT(took >= 29 * BIT_CYCLES_100K && took <= 29 * BIT_CYCLES_100K + 400);
+
+    TEST_PASS();
+}
+
+static TestResult test_lcd_probe(void)
+{
+    static const uint8_t stuck = 0xFF;
+
+    /* A PCF8574A backpack answers at 0x3F */
+    reset_bus();
+    FakeTM4C_I2C0SetDevice(0x3F);
+    FakeTM4C_I2C0SetSink(lcd_pins);
+    FakeTM4C_I2C0SetReadData(&lcd_port, 1);
+    FakeHD44780_Reset();
+    LCD_Init();
+    TEST_ASSERT_EQUAL(TPR_400K, I2C0_MTPR_R);
+
+    LCD_BufferWrite(0, 0, "Door Locker");
+    LCD_Flush();
+    while (I2C_IsBusy(I2C_MODULE_0)) FakeTM4C_Run(BIT_CYCLES_100K);
+    TEST_ASSERT(FakeHD44780_Shows("Door Locker     ", "                "));
+
+    /* ACKs but the port does not read back what was written */
+    reset_bus();
+    FakeTM4C_I2C0SetReadData(&stuck, 1);
+    LCD_Init();
+    TEST_ASSERT_EQUAL(FAKE_TM4C_CLOCK / (20 * I2C_SPEED_100K) - 1, I2C0_MTPR_R);
+
+    /* Nothing on the bus: Init still returns, at standard mode */
+    reset_bus();
+    FakeTM4C_I2C0SetDevice(0x00);
+    LCD_Init();
+    TEST_ASSERT_EQUAL(FAKE_TM4C_CLOCK / (20 * I2C_SPEED_100K) - 1, I2C0_MTPR_R);
+    LCD_BufferWrite(0, 0, "Door Locker");
+    LCD_Flush();
+    LCD_Clear();
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static void bench_throughput(void)
+{
+    enum { BURSTS = 20, LENGTH = 64 };
+    static uint8_t data[LENGTH];
+    I2C_Transfer_t xfer[BURSTS];
+    FakeTM4C_I2CStats_t st;
+    uint64_t c0, s0;
+
+    reset_bus();
+    for (uint32_t i = 0; i < LENGTH; i++) data[i] = (uint8_t)i;
+
+    c0 = FakeTM4C_Cycles();
+    s0 = FakeTM4C_SleepCycles();
+    for (uint32_t i = 0; i < BURSTS; i++)
+    {
+        fill(&xfer[i], 0x27, data, LENGTH, NULL, 0);
+        I2C_Submit(&xfer[i]);
+    }
+    I2C_Wait(&xfer[BURSTS - 1]);
+
+    uint64_t elapsed = FakeTM4C_Cycles() - c0;
+    uint64_t slept = FakeTM4C_SleepCycles() - s0;
+    FakeTM4C_I2C0GetStats(&st);
+
+    printf("    %u x %u-byte bursts at 100 kHz: %.2f ms, bus busy %.1f%%, "
+           "%.1f kB/s\n", BURSTS, LENGTH, elapsed / (double)CYCLES_PER_MS,
+           100.0 * st.busy_cycles / elapsed,
+           BURSTS * LENGTH / (elapsed / (double)FAKE_TM4C_CLOCK) / 1000.0);
+    printf("    ISR %.1f cycles per byte (%.2f%% of the CPU); caller slept "
+           "%.1f%% of the time (polled driver: 0%%)\n",
+           (double)st.isr_cycles / st.bytes, 100.0 * st.isr_cycles / elapsed,
+           100.0 * slept / elapsed);
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend I2C0 Driver Tests ---\n");
+    run_test("Blocking Write", test_blocking_write);
+    run_test("Queue Runs In Order", test_queue_runs_in_order);
+    run_test("Address NACK", test_address_nack);
+    run_test("Data NACK", test_data_nack);
+    run_test("Write Then Read", test_write_then_read);
+    run_test("Callback Chains", test_callback_chains);
+    run_test("Stuck SDA Freed At Init", test_stuck_sda_freed_at_init);
+    run_test("Stuck SDA Mid-Run", test_stuck_sda_mid_run);
+    run_test("Stuck SCL Times Out", test_stuck_scl_times_out);
+    run_test("Submit Keeps Interrupt State", test_submit_keeps_interrupt_state);
+    run_test("LCD Probe", test_lcd_probe);
+    run_test("LCD Flush In Background", test_lcd_flush_in_background);
+    run_test("LCD Recovers After NACK", test_lcd_recovers_after_nack);
+
+    printf("\n--- Throughput ---\n");
+    bench_throughput();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,791 @@
+/*
+ * test_fe_keypad.c - Host tests for the frontend's interrupt-driven keypad
+ *
+ * Runs the real frontend/HAL/keypad.c, with the DIO and Timer1A drivers
+ * under it, against the switch matrix, port C edge interrupt and Timer1A
+ * models in fake_tm4c123. Checks that an idle keypad costs nothing (no
+ * timer, rows armed), that presses and releases are queued with their
+ * timestamps once the debounce time has passed, that every key maps to
+ * its code, that overlapping keys give one event each in order, that a
+ * full queue drops the newest events only, and that a key pressed while
+ * the driver goes back to idle is not lost. Then feeds synthetic bouncing
+ * contacts and glitches (one press and one release each, or nothing),
+ * holds keys for long-press and auto-repeat, changes the timing, and
+ * presses three keys on a rectangle so the matrix shows a ghost fourth.
+ *
+ * Ends with debounce acceptance latency against double entries per debounce
+ * time, and key-to-event latency and CPU duty against the polled scan
+ * this driver replaced (copied below): every 20 ms from the main loop,
+ * spinning until the key is let go.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -include tests/host/fake_tm4c123.h -I tests/host/iar \
+ *       tests/host/test_fe_keypad.c tests/host/fake_tm4c123.c \
+ *       tests/test_common.c frontend/HAL/keypad.c frontend/MCAL/dio.c \
+ *       frontend/MCAL/gptimer.c frontend/MCAL/systick.c -o test_fe_keypad
+ *   ./test_fe_keypad
+ */
+
+#include "../test_common.h"
+#include "../../frontend/HAL/keypad.h"
+#include "../../frontend/MCAL/dio.h"
+#include "../../frontend/MCAL/gptimer.h"
+#include "../../frontend/MCAL/systick.h"
+#include <intrinsics.h>
+#include <stdlib.h>
+
+#define CYCLES_PER_US       (FAKE_TM4C_CLOCK / 1000000)
+#define CYCLES_PER_MS       (FAKE_TM4C_CLOCK / 1000)
+#define LEGACY_POLL_MS      20
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static void reset_keypad(void)
+{
+    FakeTM4C_Init();
+    SysTick_Init(CYCLES_PER_MS, SYSTICK_INT);
+    Keypad_Init();
+}
+
+static void find_key(char key, uint8_t *row, uint8_t *col)
+{
+    for (uint8_t r = 0; r < 4; r++)
+    {
+        for (uint8_t c = 0; c < 4; c++)
+        {
+            if (keypad_codes[r][c] == key)
+            {
+                *row = r;
+                *col = c;
+                return;
+            }
+        }
+    }
+}
+
+static void set_key(char key, bool down)
+{
+    uint8_t row = 0, col = 0;
+
+    find_key(key, &row, &col);
+    FakeTM4C_KeypadSet(row, col, down);
+}
+
+static void schedule_key(char key, bool down, uint64_t at)
+{
+    uint8_t row = 0, col = 0;
+
+    find_key(key, &row, &col);
+    FakeTM4C_KeypadSchedule(row, col, down, at);
+}
+
+/* Sleep until an event is queued or ms pass */
+static bool wait_event(Keypad_Event_t *event, uint32_t ms)
+{
+    uint32_t start = SysTick_GetMs();
+
+    while (!Keypad_GetEvent(event))
+    {
+        if (SysTick_GetMs() - start >= ms) return false;
+        __WFI();
+    }
+    return true;
+}
+
+static void run_ms(uint32_t ms)
+{
+    FakeTM4C_Run((uint64_t)ms * CYCLES_PER_MS);
+}
+
+/* A contact that bounces before settling: toggles of 20-800 us ending in
+ * the new state; returns the cycle of the last edge */
+static uint64_t schedule_bounce(uint8_t row, uint8_t col, bool down, uint64_t at)
+{
+    uint32_t toggles = 2 * (uint32_t)(rand() % 5);
+
+    for (uint32_t i = 0; i < toggles; i++)
+    {
+        FakeTM4C_KeypadSchedule(row, col, (i % 2 == 0) ? down : !down, at);
+        at += (uint64_t)(20 + rand() % 780) * CYCLES_PER_US;
+    }
+    FakeTM4C_KeypadSchedule(row, col, down, at);
+    return at;
+}
+
+/* Rows armed and nothing scanning */
+static bool idle(void)
+{
+    return !GPTimer_IsRunning() && (GPIO_PORTC_IM_R & 0xF0) == 0xF0;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+
+static TestResult test_idle_armed(void)
+{
+    Keypad_Event_t event;
+
+    reset_keypad();
+    TEST_ASSERT(idle());
+
+    run_ms(200);
+    TEST_ASSERT(idle());
+    TEST_ASSERT_EQUAL(0, FakeTM4C_Timer1Timeouts());
+    TEST_ASSERT_EQUAL(0, FakeTM4C_KeypadEdges());
+    TEST_ASSERT(!Keypad_GetEvent(&event));
+    TEST_ASSERT_EQUAL(0, Keypad_GetKey());
+
+    TEST_PASS();
+}
+
+static TestResult test_press_release(void)
+{
+    Keypad_Event_t event;
+    uint64_t c0;
+
+    reset_keypad();
+    run_ms(10);
+    FakeTM4C_Run(CYCLES_PER_MS / 3);
+
+    /* The row interrupt takes the first sample; accepted once it has read
+     * down for the debounce time */
+    c0 = FakeTM4C_Cycles();
+    set_key('5', true);
+    TEST_ASSERT(wait_event(&event, 50));
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 >= KEYPAD_DEBOUNCE_MS * CYCLES_PER_MS);
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 < KEYPAD_DEBOUNCE_MS * CYCLES_PER_MS + 100 * CYCLES_PER_US);
+    TEST_ASSERT_EQUAL('5', event.key);
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_PRESS, event.type);
+    TEST_ASSERT_EQUAL(SysTick_GetMs(), event.timeMs);
+    TEST_ASSERT(GPTimer_IsRunning());
+
+    /* Held: scanned on the timer, nothing new */
+    uint32_t t0 = FakeTM4C_Timer1Timeouts();
+    run_ms(100);
+    TEST_ASSERT(!Keypad_GetEvent(&event));
+    TEST_ASSERT_EQUAL(100000 / KEYPAD_SCAN_US, FakeTM4C_Timer1Timeouts() - t0);
+
+    /* Released: debounced the same way, then back to idle */
+    c0 = FakeTM4C_Cycles();
+    set_key('5', false);
+    TEST_ASSERT(wait_event(&event, 50));
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 >= KEYPAD_DEBOUNCE_MS * CYCLES_PER_MS);
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 <= (KEYPAD_DEBOUNCE_MS * 1000 + KEYPAD_SCAN_US + 100) * CYCLES_PER_US);
+    TEST_ASSERT_EQUAL('5', event.key);
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_RELEASE, event.type);
+    TEST_ASSERT(idle());
+
+    t0 = FakeTM4C_Timer1Timeouts();
+    run_ms(100);
+    TEST_ASSERT_EQUAL(t0, FakeTM4C_Timer1Timeouts());
+
+    TEST_PASS();
+}
+
+static TestResult test_every_key(void)
+{
+    Keypad_Event_t event;
+
+    reset_keypad();
+    for (uint8_t r = 0; r < 4; r++)
+    {
+        for (uint8_t c = 0; c < 4; c++)
+        {
+            FakeTM4C_KeypadSet(r, c, true);
+            run_ms(30);
+            FakeTM4C_KeypadSet(r, c, false);
+            run_ms(30);
+
+            TEST_ASSERT(Keypad_GetEvent(&event));
+            TEST_ASSERT_EQUAL(keypad_codes[r][c], event.key);
+            TEST_ASSERT_EQUAL(KEYPAD_EVENT_PRESS, event.type);
+            TEST_ASSERT(Keypad_GetEvent(&event));
+            TEST_ASSERT_EQUAL(keypad_codes[r][c], event.key);
+            TEST_ASSERT_EQUAL(KEYPAD_EVENT_RELEASE, event.type);
+            TEST_ASSERT(!Keypad_GetEvent(&event));
+            TEST_ASSERT(idle());
+        }
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_overlapping_keys(void)
+{
+    static const struct { char key; uint8_t type; } expect[4] = {
+        {'1', KEYPAD_EVENT_PRESS}, {'9', KEYPAD_EVENT_PRESS},
+        {'1', KEYPAD_EVENT_RELEASE}, {'9', KEYPAD_EVENT_RELEASE}
+    };
+    Keypad_Event_t event;
+    uint32_t last = 0;
+
+    reset_keypad();
+    set_key('1', true);
+    run_ms(20);
+    set_key('9', true);
+    run_ms(20);
+    set_key('1', false);
+    run_ms(20);
+    TEST_ASSERT(!idle());           /* '9' still down */
+    set_key('9', false);
+    run_ms(20);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        TEST_ASSERT(Keypad_GetEvent(&event));
+        TEST_ASSERT_EQUAL(expect[i].key, event.key);
+        TEST_ASSERT_EQUAL(expect[i].type, event.type);
+        TEST_ASSERT(event.timeMs >= last + (i > 0 ? 15 : 0));
+        last = event.timeMs;
+    }
+    TEST_ASSERT(!Keypad_GetEvent(&event));
+    TEST_ASSERT(idle());
+
+    TEST_PASS();
+}
+
+static TestResult test_queue_full(void)
+{
+    static const char keys[] = "1234567890";
+    Keypad_Event_t event;
+    uint32_t count = 0;
+
+    /* 20 events unread: the oldest 15 are kept */
+    reset_keypad();
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        set_key(keys[i], true);
+        run_ms(20);
+        set_key(keys[i], false);
+        run_ms(20);
+    }
+    while (Keypad_GetEvent(&event))
+    {
+        TEST_ASSERT_EQUAL(keys[count / 2], event.key);
+        TEST_ASSERT_EQUAL(count % 2 ? KEYPAD_EVENT_RELEASE : KEYPAD_EVENT_PRESS, event.type);
+        count++;
+    }
+    TEST_ASSERT_EQUAL(KEYPAD_QUEUE_SIZE - 1, count);
+
+    /* Room again */
+    set_key('#', true);
+    run_ms(20);
+    TEST_ASSERT_EQUAL('#', Keypad_GetKey());
+    TEST_ASSERT_EQUAL(0, Keypad_GetKey());
+    set_key('#', false);
+    run_ms(20);
+    TEST_ASSERT_EQUAL(0, Keypad_GetKey());      /* Release skipped */
+
+    TEST_PASS();
+}
+
+/* The next key goes down anywhere around the scan that accepts the first
+ * one's release, including between that scan and the rows being armed */
+static TestResult test_press_while_rearming(void)
+{
+    Keypad_Event_t event;
+    uint32_t lost = 0;
+
+    reset_keypad();
+    srand(18);
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        uint64_t release = FakeTM4C_Cycles() + 30 * CYCLES_PER_MS;
+        bool pressed = false;
+
+        uint64_t press = release + (uint64_t)(KEYPAD_DEBOUNCE_MS * 1000 - 500 +
+                                              rand() % (2 * KEYPAD_SCAN_US + 1000)) * CYCLES_PER_US;
+
+        set_key('1', true);
+        schedule_key('1', false, release);
+        schedule_key('2', true, press);
+        schedule_key('2', false, press + 30 * CYCLES_PER_MS);
+        run_ms(100);
+
+        while (Keypad_GetEvent(&event))
+        {
+            if (event.key == '2' && event.type == KEYPAD_EVENT_PRESS) pressed = true;
+        }
+        if (!pressed) lost++;
+        TEST_ASSERT(idle());
+    }
+    TEST_ASSERT_EQUAL(0, lost);
+
+    TEST_PASS();
+}
+
+static TestResult test_bounce_filtered(void)
+{
+    Keypad_Event_t event;
+    uint64_t worst = 0;
+
+    reset_keypad();
+    srand(19);
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        uint8_t row = (uint8_t)(rand() % 4), col = (uint8_t)(rand() % 4);
+        uint64_t settled = schedule_bounce(row, col, true, FakeTM4C_Cycles() + CYCLES_PER_MS);
+
+        TEST_ASSERT(wait_event(&event, 100));
+        TEST_ASSERT_EQUAL(keypad_codes[row][col], event.key);
+        TEST_ASSERT_EQUAL(KEYPAD_EVENT_PRESS, event.type);
+        TEST_ASSERT(FakeTM4C_Cycles() >= settled);
+        if (FakeTM4C_Cycles() - settled > worst) worst = FakeTM4C_Cycles() - settled;
+
+        settled = schedule_bounce(row, col, false, FakeTM4C_Cycles() + 50 * CYCLES_PER_MS);
+        TEST_ASSERT(wait_event(&event, 100));
+        TEST_ASSERT_EQUAL(keypad_codes[row][col], event.key);
+        TEST_ASSERT_EQUAL(KEYPAD_EVENT_RELEASE, event.type);
+        TEST_ASSERT(FakeTM4C_Cycles() >= settled);
+        if (FakeTM4C_Cycles() - settled > worst) worst = FakeTM4C_Cycles() - settled;
+
+        run_ms(20);
+        TEST_ASSERT(!Keypad_GetEvent(&event));
+        TEST_ASSERT(idle());
+    }
+    /* Stable for the debounce time, sampled on the scan tick */
+    TEST_ASSERT(worst <= (KEYPAD_DEBOUNCE_MS * 1000 + KEYPAD_SCAN_US + 100) * CYCLES_PER_US);
+
+    TEST_PASS();
+}
+
+static TestResult test_glitch_rejected(void)
+{
+    Keypad_Event_t event;
+
+    reset_keypad();
+    for (uint32_t width_us = 50; width_us < KEYPAD_DEBOUNCE_MS * 1000 - KEYPAD_SCAN_US; width_us += 450)
+    {
+        uint64_t at = FakeTM4C_Cycles() + CYCLES_PER_MS;
+
+        schedule_key('7', true, at);
+        schedule_key('7', false, at + (uint64_t)width_us * CYCLES_PER_US);
+        run_ms(40);
+        TEST_ASSERT(!Keypad_GetEvent(&event));
+        TEST_ASSERT(idle());
+    }
+    TEST_ASSERT(FakeTM4C_KeypadEdges() > 0);
+
+    TEST_PASS();
+}
+
+static TestResult test_long_press_and_repeat(void)
+{
+    Keypad_Event_t event;
+    uint32_t pressed_at = 0, long_at = 0, last_repeat = 0;
+    uint32_t longs = 0, repeats = 0;
+
+    Keypad_Event_t seen[32];
+    uint32_t count = 0, i = 0;
+
+    /* Read as the application would, so the queue never fills */
+    reset_keypad();
+    set_key('#', true);
+    for (uint32_t ms = 0; ms < 2030; ms += 10)
+    {
+        if (ms == 2000) set_key('#', false);
+        run_ms(10);
+        while (count < 32 && Keypad_GetEvent(&seen[count])) count++;
+    }
+
+    TEST_ASSERT(count > 2);
+    event = seen[i++];
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_PRESS, event.type);
+    pressed_at = event.timeMs;
+    while (i < count && (event = seen[i++]).type != KEYPAD_EVENT_RELEASE)
+    {
+        TEST_ASSERT_EQUAL('#', event.key);
+        if (event.type == KEYPAD_EVENT_LONG_PRESS)
+        {
+            longs++;
+            long_at = event.timeMs;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(KEYPAD_EVENT_REPEAT, event.type);
+            if (repeats == 0)
+            {
+                TEST_ASSERT(event.timeMs - pressed_at >= KEYPAD_REPEAT_DELAY_MS);
+                TEST_ASSERT(event.timeMs - pressed_at <= KEYPAD_REPEAT_DELAY_MS + 3);
+            }
+            else
+            {
+                TEST_ASSERT(event.timeMs - last_repeat >= KEYPAD_REPEAT_MS - 1);
+                TEST_ASSERT(event.timeMs - last_repeat <= KEYPAD_REPEAT_MS + 1);
+            }
+            last_repeat = event.timeMs;
+            repeats++;
+        }
+    }
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_RELEASE, event.type);
+    TEST_ASSERT_EQUAL(1, longs);
+    TEST_ASSERT(long_at - pressed_at >= KEYPAD_LONG_PRESS_MS &&
+                long_at - pressed_at <= KEYPAD_LONG_PRESS_MS + 3);
+    /* Held about 1990 ms after the press: repeats at 500, 600, ... 1900 */
+    TEST_ASSERT_EQUAL((2000 - KEYPAD_DEBOUNCE_MS - KEYPAD_REPEAT_DELAY_MS) / KEYPAD_REPEAT_MS + 1, repeats);
+    TEST_ASSERT(idle());
+
+    TEST_PASS();
+}
+
+static TestResult test_timing_configurable(void)
+{
+    static const Keypad_Timing_t slow = {20, 0, 0, 0};
+    static const Keypad_Timing_t raw = {0, 300, 0, 0};
+    Keypad_Event_t event;
+    uint64_t c0;
+
+    /* Longer debounce, no long-press or repeat; a masked caller stays
+     * masked */
+    reset_keypad();
+    __disable_interrupt();
+    Keypad_SetTiming(&slow);
+    TEST_ASSERT_EQUAL(1, __get_interrupt_state());
+    __enable_interrupt();
+    c0 = FakeTM4C_Cycles();
+    set_key('0', true);
+    TEST_ASSERT(wait_event(&event, 50));
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 >= 20 * CYCLES_PER_MS);
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 < 21 * CYCLES_PER_MS);
+    run_ms(1500);
+    TEST_ASSERT(!Keypad_GetEvent(&event));
+    set_key('0', false);
+    run_ms(30);
+    TEST_ASSERT(Keypad_GetEvent(&event));
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_RELEASE, event.type);
+
+    /* No debounce: the edge scan is taken as it reads */
+    Keypad_SetTiming(&raw);
+    c0 = FakeTM4C_Cycles();
+    set_key('0', true);
+    TEST_ASSERT(wait_event(&event, 5));
+    TEST_ASSERT(FakeTM4C_Cycles() - c0 < 100 * CYCLES_PER_US);
+    run_ms(400);
+    TEST_ASSERT(Keypad_GetEvent(&event));
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_LONG_PRESS, event.type);
+    set_key('0', false);
+    run_ms(5);
+    TEST_ASSERT(Keypad_GetEvent(&event));
+    TEST_ASSERT_EQUAL(KEYPAD_EVENT_RELEASE, event.type);
+
+    TEST_PASS();
+}
+
+/* '1' '2' '4' down: with '2' driven, '1' and '4' join it to row 1 and
+ * '5' reads as pressed */
+static TestResult test_ghost_blocked(void)
+{
+    Keypad_Event_t event;
+    uint32_t rollovers = 0;
+    bool four = false, five = false;
+
+    reset_keypad();
+    set_key('1', true);
+    run_ms(30);
+    set_key('2', true);
+    run_ms(30);
+    set_key('4', true);
+    run_ms(100);
+    while (Keypad_GetEvent(&event))
+    {
+        if (event.type == KEYPAD_EVENT_ROLLOVER) rollovers++;
+        if (event.type == KEYPAD_EVENT_PRESS && event.key == '4') four = true;
+        if (event.type == KEYPAD_EVENT_PRESS && event.key == '5') five = true;
+    }
+    TEST_ASSERT_EQUAL(1, rollovers);
+    TEST_ASSERT(!four && !five);
+
+    /* '2' up: the matrix can be read again and '4' is taken */
+    set_key('2', false);
+    run_ms(30);
+    while (Keypad_GetEvent(&event))
+    {
+        if (event.type == KEYPAD_EVENT_PRESS && event.key == '4') four = true;
+        if (event.type == KEYPAD_EVENT_PRESS && event.key == '5') five = true;
+    }
+    TEST_ASSERT(four && !five);
+
+    set_key('1', false);
+    set_key('4', false);
+    run_ms(30);
+    TEST_ASSERT(idle());
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Legacy polled scan (the driver before the row interrupts)
+ *===========================================================================*/
+static const struct { uint8_t port; uint8_t pin; } legacy_cols[4] = {
+    {PORTB, PIN6}, {PORTA, PIN4}, {PORTA, PIN3}, {PORTA, PIN2}
+};
+
+static void legacy_init(void)
+{
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        DIO_Init(PORTC, (uint8_t)(PIN4 + i), INPUT);
+        DIO_SetPUR(PORTC, (uint8_t)(PIN4 + i), ENABLE);
+    }
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        DIO_Init(legacy_cols[i].port, legacy_cols[i].pin, OUTPUT);
+        DIO_WritePin(legacy_cols[i].port, legacy_cols[i].pin, HIGH);
+    }
+}
+
+static char legacy_get_key(void)
+{
+    for (uint8_t col = 0; col < 4; col++)
+    {
+        for (uint8_t c = 0; c < 4; c++)
+        {
+            DIO_WritePin(legacy_cols[c].port, legacy_cols[c].pin, HIGH);
+        }
+        DIO_WritePin(legacy_cols[col].port, legacy_cols[col].pin, LOW);
+
+        for (uint8_t row = 0; row < 4; row++)
+        {
+            if (DIO_ReadPin(PORTC, (uint8_t)(PIN4 + row)) == LOW)
+            {
+                while (DIO_ReadPin(PORTC, (uint8_t)(PIN4 + row)) == LOW);
+                return keypad_codes[row][col];
+            }
+        }
+    }
+    return 0;
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+typedef struct {
+    uint64_t lat_sum, lat_max;
+    uint32_t lat_n;
+    uint64_t idle_busy, idle_cycles;
+    uint64_t held_busy, held_cycles;
+} Bench_t;
+
+static uint64_t busy_since(uint64_t c0, uint64_t s0)
+{
+    return (FakeTM4C_Cycles() - c0) - (FakeTM4C_SleepCycles() - s0);
+}
+
+/* Key down for 80 ms at a random point; the main loop polls on its period
+ * and the latency is press to key handed to the application */
+static void bench_driver(bool legacy, Bench_t *b)
+{
+    enum { PRESSES = 200, HOLD_MS = 80 };
+    uint64_t c0, s0;
+
+    FakeTM4C_Init();
+    SysTick_Init(CYCLES_PER_MS, SYSTICK_INT);
+    if (legacy) legacy_init(); else Keypad_Init();
+    srand(1800);
+
+    for (uint32_t i = 0; i < PRESSES; i++)
+    {
+        uint8_t row = (uint8_t)(rand() % 4), col = (uint8_t)(rand() % 4);
+        uint64_t at = FakeTM4C_Cycles() + (uint64_t)(rand() % (50 * CYCLES_PER_MS));
+        char key = 0;
+
+        FakeTM4C_KeypadSchedule(row, col, true, at);
+        FakeTM4C_KeypadSchedule(row, col, false, at + HOLD_MS * CYCLES_PER_MS);
+        while (key == 0)
+        {
+            if (legacy)
+            {
+                key = legacy_get_key();
+                if (key == 0) DelayMs(LEGACY_POLL_MS);
+            }
+            else
+            {
+                key = Keypad_GetKey();
+                if (key == 0) DelayMs(1);
+            }
+        }
+        uint64_t lat = FakeTM4C_Cycles() - at;
+        b->lat_sum += lat;
+        if (lat > b->lat_max) b->lat_max = lat;
+        b->lat_n++;
+        run_ms(HOLD_MS + 20);
+        while (Keypad_GetKey() != 0);
+    }
+
+    /* A second of nothing pressed */
+    c0 = FakeTM4C_Cycles();
+    s0 = FakeTM4C_SleepCycles();
+    for (uint32_t ms = 0; ms < 1000; ms += legacy ? LEGACY_POLL_MS : 1)
+    {
+        if (legacy)
+        {
+            (void)legacy_get_key();
+            DelayMs(LEGACY_POLL_MS);
+        }
+        else
+        {
+            (void)Keypad_GetKey();
+            DelayMs(1);
+        }
+    }
+    b->idle_cycles = FakeTM4C_Cycles() - c0;
+    b->idle_busy = busy_since(c0, s0);
+
+    /* A key held for a second (the polled scan spins until release) */
+    c0 = FakeTM4C_Cycles();
+    s0 = FakeTM4C_SleepCycles();
+    FakeTM4C_KeypadSet(0, 0, true);
+    FakeTM4C_KeypadSchedule(0, 0, false, c0 + 1000ULL * CYCLES_PER_MS);
+    while (FakeTM4C_Cycles() < c0 + 1000ULL * CYCLES_PER_MS)
+    {
+        if (legacy)
+        {
+            (void)legacy_get_key();
+            DelayMs(LEGACY_POLL_MS);
+        }
+        else
+        {
+            (void)Keypad_GetKey();
+            DelayMs(1);
+        }
+    }
+    b->held_cycles = FakeTM4C_Cycles() - c0;
+    b->held_busy = busy_since(c0, s0);
+}
+
+/* Press to event in the queue, read by a consumer sleeping in WFI */
+static void bench_event_latency(uint64_t *mean, uint64_t *max)
+{
+    enum { PRESSES = 200 };
+    Keypad_Event_t event;
+    uint64_t sum = 0;
+
+    *max = 0;
+    reset_keypad();
+    srand(1801);
+    for (uint32_t i = 0; i < PRESSES; i++)
+    {
+        uint8_t row = (uint8_t)(rand() % 4), col = (uint8_t)(rand() % 4);
+        uint64_t at = FakeTM4C_Cycles() + (uint64_t)(rand() % (50 * CYCLES_PER_MS));
+
+        FakeTM4C_KeypadSchedule(row, col, true, at);
+        FakeTM4C_KeypadSchedule(row, col, false, at + 40 * CYCLES_PER_MS);
+        while (!Keypad_GetEvent(&event)) __WFI();
+
+        uint64_t lat = FakeTM4C_Cycles() - at;
+        sum += lat;
+        if (lat > *max) *max = lat;
+        run_ms(60);
+        while (Keypad_GetEvent(&event));
+    }
+    *mean = sum / PRESSES;
+}
+
+static void bench_latency_and_duty(void)
+{
+    Bench_t polled = {0}, irq = {0};
+    uint64_t q_mean, q_max;
+
+    bench_driver(true, &polled);
+    bench_driver(false, &irq);
+    bench_event_latency(&q_mean, &q_max);
+
+    printf("    key -> event queued: %.1f us mean, %.1f us max (%u ms debounce)\n",
+           q_mean / (double)CYCLES_PER_US, q_max / (double)CYCLES_PER_US, KEYPAD_DEBOUNCE_MS);
+    printf("    key -> main loop: polled every %u ms %.2f ms mean, %.2f ms max "
+           "(returns on release); queue drained every 1 ms %.1f us mean, "
+           "%.1f us max\n",
+           LEGACY_POLL_MS,
+           polled.lat_sum / (double)polled.lat_n / CYCLES_PER_MS,
+           polled.lat_max / (double)CYCLES_PER_MS,
+           irq.lat_sum / (double)irq.lat_n / CYCLES_PER_US,
+           irq.lat_max / (double)CYCLES_PER_US);
+    printf("    CPU busy idle: polled %.3f%%, interrupt %.3f%% (main loop and "
+           "SysTick included)\n",
+           100.0 * polled.idle_busy / polled.idle_cycles,
+           100.0 * irq.idle_busy / irq.idle_cycles);
+    printf("    CPU busy key held: polled %.1f%%, interrupt %.3f%% "
+           "(scan every %u us)\n",
+           100.0 * polled.held_busy / polled.held_cycles,
+           100.0 * irq.held_busy / irq.held_cycles, KEYPAD_SCAN_US);
+}
+
+/* Bouncing presses at each debounce time: entries per press and latency
+ * from the contact settling to the press being queued */
+static void bench_debounce(void)
+{
+    static const uint16_t debounce[] = {0, 5, 10, 20};
+    enum { PRESSES = 300 };
+
+    for (uint32_t d = 0; d < sizeof(debounce) / sizeof(debounce[0]); d++)
+    {
+        Keypad_Timing_t timing = {debounce[d], 0, 0, 0};
+        Keypad_Event_t event;
+        uint32_t entries = 0, doubled = 0;
+        uint64_t sum = 0, max = 0;
+
+        reset_keypad();
+        Keypad_SetTiming(&timing);
+        srand(1900);
+        for (uint32_t i = 0; i < PRESSES; i++)
+        {
+            uint8_t row = (uint8_t)(rand() % 4), col = (uint8_t)(rand() % 4);
+            uint64_t start = FakeTM4C_Cycles() + CYCLES_PER_MS;
+            uint64_t settled = schedule_bounce(row, col, true, start);
+            uint64_t first = 0;
+            uint32_t n = 0;
+
+            schedule_bounce(row, col, false, settled + 80 * CYCLES_PER_MS);
+            while (FakeTM4C_Cycles() < settled + 150 * CYCLES_PER_MS)
+            {
+                while (Keypad_GetEvent(&event))
+                {
+                    if (event.type != KEYPAD_EVENT_PRESS) continue;
+                    if (n++ == 0) first = FakeTM4C_Cycles();
+                }
+                __WFI();
+            }
+            entries += n;
+            if (n > 1) doubled++;
+            if (n > 0)
+            {
+                uint64_t lat = first > settled ? first - settled : 0;
+                sum += lat;
+                if (lat > max) max = lat;
+            }
+        }
+        printf("    debounce %2u ms: %u entries for %u presses (%u doubled); "
+               "settle -> press %.2f ms mean, %.2f ms max\n",
+               debounce[d], entries, PRESSES, doubled,
+               sum / (double)PRESSES / CYCLES_PER_MS, max / (double)CYCLES_PER_MS);
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend Keypad Tests ---\n");
+    run_test("Idle Armed", test_idle_armed);
+    run_test("Press And Release", test_press_release);
+    run_test("Every Key", test_every_key);
+    run_test("Overlapping Keys", test_overlapping_keys);
+    run_test("Queue Full", test_queue_full);
+    run_test("Press While Re-arming", test_press_while_rearming);
+    run_test("Bounce Filtered", test_bounce_filtered);
+    run_test("Glitch Rejected", test_glitch_rejected);
+    run_test("Long Press And Repeat", test_long_press_and_repeat);
+    run_test("Timing Configurable", test_timing_configurable);
+    run_test("Ghost Blocked", test_ghost_blocked);
+
+    printf("\n--- Debounce ---\n");
+    bench_debounce();
+
+    printf("\n--- Latency And CPU Duty ---\n");
+    bench_latency_and_duty();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,542 @@
+/*
+ * test_fe_potentiometer.c - Host tests for the frontend's potentiometer
+ * sampling pipeline
+ *
+ * Runs the real frontend/HAL/potentiometer.c and frontend/MCAL/adc.c
+ * against the ADC0 sequencer 3 and Timer0A models in fake_tm4c123.
+ * Checks that each channel sets up its own pin (the pot is on PB5/AIN11,
+ * not PE3), that Timer0A paces 64x hardware-averaged samples into the
+ * queue with one interrupt per sample, that a queue left unread for a
+ * while is dropped instead of being averaged in, that the software read
+ * still works, and that the displayed timeout only moves once the reading
+ * is past a step edge by the hysteresis margin.
+ *
+ * Then replays noisy wiper traces, polled every 100 ms like the set-timeout
+ * screen: the knob at rest at 17.0 s and at 17.5 s of the scale (a step
+ * edge of the old truncating scale and of the new rounding one), with and
+ * without wiper drop-outs, a slow sweep and a fast turn. The traces are generated
+ * from a noise model (white noise per conversion, mains hum, drop-outs to
+ * 0 V) seeded for repeatability. Prints display changes and reading
+ * spread at rest and settle time against the code this replaced (one unaveraged software
+ * conversion per poll, copied below), and sweeps the filter weight and
+ * hysteresis to show how the defaults were picked.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -include tests/host/fake_tm4c123.h -I tests/host/iar \
+ *       tests/host/test_fe_potentiometer.c tests/host/fake_tm4c123.c \
+ *       tests/test_common.c frontend/HAL/potentiometer.c \
+ *       frontend/MCAL/adc.c -lm -o test_fe_potentiometer
+ *   ./test_fe_potentiometer
+ */
+
+#include "../test_common.h"
+#include "../../frontend/HAL/potentiometer.h"
+#include "../../frontend/MCAL/adc.h"
+#include <intrinsics.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define CYCLES_PER_US       (FAKE_TM4C_CLOCK / 1000000)
+#define CYCLES_PER_MS       (FAKE_TM4C_CLOCK / 1000)
+#define POLL_MS             100     /* menu_handlers.c POT_POLL_MS */
+#define PI                  3.14159265358979
+
+/*===========================================================================
+ * Analog input
+ *===========================================================================*/
+
+/* Wiper position in ADC counts, as a function of time */
+typedef enum { KNOB_HOLD, KNOB_SWEEP, KNOB_STEP } Knob_t;
+
+typedef struct {
+    const char *name;
+    Knob_t knob;
+    double from, to;            /* Counts; HOLD uses from */
+    uint32_t move_ms;           /* SWEEP: duration, STEP: when */
+    double noise;               /* White noise per conversion, counts RMS */
+    double hum;                 /* 60 Hz amplitude, counts */
+    uint32_t dropout_ms;        /* Mean gap between 2 ms drop-outs, 0 = none */
+    uint32_t length_ms;
+} Trace_t;
+
+static const Trace_t *trace = NULL;
+static uint64_t trace_start = 0;
+static double fixed_input = 0;
+
+#define MAX_DROPOUTS        256
+static uint64_t dropouts[MAX_DROPOUTS];
+static uint32_t dropout_count = 0;
+
+static double gaussian(void)
+{
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+}
+
+static double knob_at(uint64_t cycle)
+{
+    double ms = (cycle - trace_start) / (double)CYCLES_PER_MS;
+
+    switch (trace->knob)
+    {
+        case KNOB_SWEEP:
+            if (ms >= trace->move_ms) return trace->to;
+            return trace->from + (trace->to - trace->from) * ms / trace->move_ms;
+        case KNOB_STEP:
+            return ms < trace->move_ms ? trace->from : trace->to;
+        default:
+            return trace->from;
+    }
+}
+
+static bool in_dropout(uint64_t cycle)
+{
+    for (uint32_t i = 0; i < dropout_count; i++)
+    {
+        if (cycle >= dropouts[i] && cycle < dropouts[i] + 2 * CYCLES_PER_MS) return true;
+    }
+    return false;
+}
+
+static uint16_t trace_source(uint8_t channel, uint64_t cycle)
+{
+    double v;
+
+    (void)channel;
+    if (in_dropout(cycle)) return 0;
+    v = knob_at(cycle) + trace->noise * gaussian() +
+        trace->hum * sin(2.0 * PI * 60.0 * cycle / FAKE_TM4C_CLOCK);
+    if (v < 0) v = 0;
+    if (v > ADC_MAX_VALUE) v = ADC_MAX_VALUE;
+    return (uint16_t)(v + 0.5);
+}
+
+static uint16_t fixed_source(uint8_t channel, uint64_t cycle)
+{
+    (void)channel;
+    (void)cycle;
+    return (uint16_t)fixed_input;
+}
+
+static void start_trace(const Trace_t *t, unsigned seed)
+{
+    uint64_t at;
+
+    trace = t;
+    trace_start = FakeTM4C_Cycles();
+    srand(seed);
+    dropout_count = 0;
+    if (t->dropout_ms > 0)
+    {
+        at = trace_start;
+        for (;;)
+        {
+            at += (uint64_t)(rand() % (2 * t->dropout_ms) + 1) * CYCLES_PER_MS;
+            if (at >= trace_start + (uint64_t)t->length_ms * CYCLES_PER_MS) break;
+            if (dropout_count == MAX_DROPOUTS) break;
+            dropouts[dropout_count++] = at;
+        }
+    }
+    FakeTM4C_AdcSetSource(trace_source);
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static void run_ms(uint32_t ms)
+{
+    FakeTM4C_Run((uint64_t)ms * CYCLES_PER_MS);
+}
+
+/* Sleep in WFI, woken by the ADC interrupt, like the scheduler loop */
+static void sleep_ms(uint32_t ms)
+{
+    uint64_t until = FakeTM4C_Cycles() + (uint64_t)ms * CYCLES_PER_MS;
+
+    while (FakeTM4C_Cycles() < until) __WFI();
+}
+
+static void reset_pot(void)
+{
+    FakeTM4C_Init();
+    FakeTM4C_AdcSetSource(fixed_source);
+    fixed_input = 0;
+    Potentiometer_Init();
+}
+
+/* Counts at the middle of a timeout step, and on the edge above it */
+static double step_mid(uint32_t sec)
+{
+    return (sec - POTENTIOMETER_TIMEOUT_MIN_SEC) * ADC_MAX_VALUE /
+           (double)(POTENTIOMETER_TIMEOUT_MAX_SEC - POTENTIOMETER_TIMEOUT_MIN_SEC);
+}
+
+static double step_edge(uint32_t sec)
+{
+    return step_mid(sec) + step_mid(POTENTIOMETER_TIMEOUT_MIN_SEC + 1) / 2;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_pin_setup(void)
+{
+    FakeTM4C_Init();
+    ADC_Init(ADC_CHANNEL_11);
+
+    TEST_ASSERT(SYSCTL_RCGCADC_R & 0x01);
+    TEST_ASSERT(SYSCTL_RCGCGPIO_R & 0x02);
+    TEST_ASSERT(GPIO_PORTB_AMSEL_R & 0x20);
+    TEST_ASSERT(GPIO_PORTB_AFSEL_R & 0x20);
+    TEST_ASSERT_EQUAL(0, GPIO_PORTB_DEN_R & 0x20);
+    TEST_ASSERT_EQUAL(0, GPIO_PORTB_DIR_R & 0x20);
+    TEST_ASSERT_EQUAL(0, GPIO_PORTE_AMSEL_R);
+    TEST_ASSERT_EQUAL(11, ADC0_SSMUX3_R);
+
+    FakeTM4C_Init();
+    ADC_Init(ADC_CHANNEL_0);
+    TEST_ASSERT(GPIO_PORTE_AMSEL_R & 0x08);
+    TEST_ASSERT_EQUAL(0, GPIO_PORTB_AMSEL_R);
+
+    FakeTM4C_Init();
+    ADC_Init(ADC_CHANNEL_4);
+    TEST_ASSERT(GPIO_PORTD_AMSEL_R & 0x08);
+    TEST_ASSERT_EQUAL(4, ADC0_SSMUX3_R);
+
+    FakeTM4C_Init();
+    ADC_Init(ADC_CHANNEL_9);
+    TEST_ASSERT(GPIO_PORTE_AMSEL_R & 0x10);
+
+    TEST_PASS();
+}
+
+static TestResult test_timer_triggered(void)
+{
+    FakeTM4C_AdcStats_t stats;
+    uint16_t sample;
+    uint32_t n = 0;
+
+    reset_pot();
+    fixed_input = 1234;
+    TEST_ASSERT_EQUAL(ADC_EMUX_EM3_TIMER, ADC0_EMUX_R & ADC_EMUX_EM3_M);
+    TEST_ASSERT_EQUAL(ADC_SAC_AVG_64X, ADC0_SAC_R);
+    TEST_ASSERT_EQUAL(10000 * CYCLES_PER_US - 1, TIMER0_TAILR_R);
+
+    /* 100 samples/s without the CPU asking */
+    sleep_ms(100);
+    FakeTM4C_AdcGetStats(&stats);
+    TEST_ASSERT(stats.samples >= 9 && stats.samples <= 10);
+    TEST_ASSERT_EQUAL(stats.samples * 64, stats.conversions);
+    TEST_ASSERT_EQUAL(stats.samples, stats.isr_calls);
+    TEST_ASSERT_EQUAL(0, stats.overflows);
+    TEST_ASSERT_EQUAL(1234, ADC_LastSample());
+
+    while (ADC_GetSample(&sample))
+    {
+        TEST_ASSERT_EQUAL(1234, sample);
+        n++;
+    }
+    TEST_ASSERT_EQUAL(stats.samples, n);
+    TEST_ASSERT_EQUAL(0, ADC_Overruns());
+
+    fixed_input = 1300;
+    sleep_ms(50);
+    TEST_ASSERT_EQUAL(1300, Potentiometer_Read());
+
+    TEST_PASS();
+}
+
+static TestResult test_stale_queue_dropped(void)
+{
+    reset_pot();
+    fixed_input = 500;
+    run_ms(50);
+    TEST_ASSERT_EQUAL(5 + (500 * 25 + 2047) / 4095, Potentiometer_GetTimeout());
+
+    /* Nobody reads for a second: the queue fills with 500s */
+    run_ms(1000);
+    TEST_ASSERT(ADC_Overruns() > 0);
+
+    /* The knob moved meanwhile; the first read must not average old data */
+    fixed_input = 3000;
+    run_ms(25);
+    TEST_ASSERT_EQUAL(3000, Potentiometer_Read());
+    TEST_ASSERT_EQUAL(5 + (3000 * 25 + 2047) / 4095, Potentiometer_GetTimeout());
+
+    TEST_PASS();
+}
+
+static TestResult test_software_read(void)
+{
+    FakeTM4C_Init();
+    FakeTM4C_AdcSetSource(fixed_source);
+    fixed_input = 2500;
+    ADC_Init(ADC_CHANNEL_11);
+    TEST_ASSERT_EQUAL(2500, ADC_Read());
+    fixed_input = 7;
+    TEST_ASSERT_EQUAL(7, ADC_Read());
+
+    TEST_PASS();
+}
+
+static TestResult test_hysteresis(void)
+{
+    double edge = step_edge(17);                /* 17 s below, 18 s above */
+    int32_t h = POTENTIOMETER_HYSTERESIS;
+
+    reset_pot();
+    fixed_input = edge - 100;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(17, Potentiometer_GetTimeout());
+
+    /* Just past the edge: held */
+    fixed_input = edge + h / 2;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(17, Potentiometer_GetTimeout());
+
+    /* Past it by more than the margin: moves */
+    fixed_input = edge + h + 10;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(18, Potentiometer_GetTimeout());
+
+    /* And back: held until clearly below */
+    fixed_input = edge - h / 2;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(18, Potentiometer_GetTimeout());
+    fixed_input = edge - h - 10;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(17, Potentiometer_GetTimeout());
+
+    /* Full scale still reaches both ends */
+    fixed_input = 0;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(POTENTIOMETER_TIMEOUT_MIN_SEC, Potentiometer_GetTimeout());
+    fixed_input = ADC_MAX_VALUE;
+    run_ms(200);
+    TEST_ASSERT_EQUAL(POTENTIOMETER_TIMEOUT_MAX_SEC, Potentiometer_GetTimeout());
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Legacy read (the driver before the sampling pipeline)
+ *===========================================================================*/
+static uint32_t legacy_raw = 0;
+
+static uint32_t legacy_get_timeout(void)
+{
+    uint32_t rawValue = ADC_Read();
+
+    legacy_raw = rawValue;
+
+    return (rawValue * (POTENTIOMETER_TIMEOUT_MAX_SEC - POTENTIOMETER_TIMEOUT_MIN_SEC)
+            / ADC_MAX_VALUE) + POTENTIOMETER_TIMEOUT_MIN_SEC;
+}
+
+/*===========================================================================
+ * Trace replay
+ *===========================================================================*/
+#define TRACE_COUNT         6
+
+static Trace_t traces[TRACE_COUNT];
+
+static void build_traces(void)
+{
+    double mid = step_mid(17), edge = step_edge(17);
+    uint32_t i = 0;
+
+    traces[i++] = (Trace_t){"at 17.0 s", KNOB_HOLD, mid, 0, 0, 8, 12, 0, 10000};
+    traces[i++] = (Trace_t){"at 17.5 s", KNOB_HOLD, edge, 0, 0, 8, 12, 0, 10000};
+    traces[i++] = (Trace_t){"at 17.5 s, drops", KNOB_HOLD, edge, 0, 0, 8, 12, 300, 10000};
+    traces[i++] = (Trace_t){"at 17.0 s, drops", KNOB_HOLD, mid, 0, 0, 8, 12, 300, 10000};
+    traces[i++] = (Trace_t){"slow sweep", KNOB_SWEEP, 0, ADC_MAX_VALUE, 5000, 8, 12, 0, 7000};
+    traces[i++] = (Trace_t){"fast turn", KNOB_STEP, step_mid(10), step_mid(25), 1000, 8, 12, 0, 3000};
+}
+
+typedef struct {
+    uint32_t changes;           /* Display changes after the first second */
+    uint32_t spread;            /* Reading max - min after the first second */
+    uint32_t reversals;         /* Sweep: display went back down */
+    uint32_t settle_ms;         /* Turn: knob moved to display final for good */
+    uint32_t final;
+    uint64_t busy, cycles;
+} Replay_t;
+
+/* Poll every POLL_MS like the set-timeout screen and note what the
+ * display would have shown */
+static void replay(const Trace_t *t, bool legacy, const Potentiometer_Filter_t *config,
+                   Replay_t *r)
+{
+    uint32_t shown = 0, target = 0;
+    uint32_t lo = UINT32_MAX, hi = 0;
+    uint32_t last_change_ms = 0;
+    uint64_t c0, s0;
+
+    FakeTM4C_Init();
+    start_trace(t, 2000);
+    if (legacy)
+    {
+        ADC_Init(ADC_CHANNEL_11);
+    }
+    else
+    {
+        Potentiometer_Init();
+        if (config != NULL) Potentiometer_SetFilter(config);
+    }
+    *r = (Replay_t){0};
+    c0 = FakeTM4C_Cycles();
+    s0 = FakeTM4C_SleepCycles();
+
+    for (uint32_t ms = POLL_MS; ms <= t->length_ms; ms += POLL_MS)
+    {
+        uint32_t value;
+
+        if (legacy) run_ms(POLL_MS); else sleep_ms(POLL_MS);
+        value = legacy ? legacy_get_timeout() : Potentiometer_GetTimeout();
+        if (ms > 1000)
+        {
+            uint32_t reading = legacy ? legacy_raw : Potentiometer_Read();
+            if (reading < lo) lo = reading;
+            if (reading > hi) hi = reading;
+        }
+
+        if (shown != 0 && value != shown)
+        {
+            if (ms > 1000 && t->knob == KNOB_HOLD) r->changes++;
+            if (t->knob == KNOB_SWEEP && value < shown) r->reversals++;
+            last_change_ms = ms;
+        }
+        shown = value;
+    }
+    r->final = shown;
+    r->spread = hi - lo;
+    r->cycles = FakeTM4C_Cycles() - c0;
+    r->busy = r->cycles - (FakeTM4C_SleepCycles() - s0);
+
+    if (t->knob == KNOB_STEP)
+    {
+        target = POTENTIOMETER_TIMEOUT_MIN_SEC +
+                 (uint32_t)(t->to * 25 / ADC_MAX_VALUE + 0.5);
+        r->settle_ms = (shown == target && last_change_ms >= t->move_ms) ?
+                       last_change_ms - t->move_ms : UINT32_MAX;
+    }
+}
+
+static TestResult test_noisy_traces(void)
+{
+    Replay_t r;
+
+    build_traces();
+    for (uint32_t i = 0; i < TRACE_COUNT; i++)
+    {
+        replay(&traces[i], false, NULL, &r);
+        if (traces[i].knob == KNOB_HOLD)
+        {
+            TEST_ASSERT_EQUAL(0, r.changes);
+            TEST_ASSERT(r.final == 17 || r.final == 18);
+        }
+        else if (traces[i].knob == KNOB_SWEEP)
+        {
+            TEST_ASSERT_EQUAL(0, r.reversals);
+            TEST_ASSERT_EQUAL(POTENTIOMETER_TIMEOUT_MAX_SEC, r.final);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(25, r.final);
+            TEST_ASSERT(r.settle_ms <= 300);
+        }
+    }
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static void print_replay(const Trace_t *t, const Replay_t *r)
+{
+    if (t->knob == KNOB_HOLD)
+    {
+        printf("%3u changes, spread %3u, shows %2u s", r->changes, r->spread, r->final);
+    }
+    else if (t->knob == KNOB_SWEEP)
+    {
+        printf("%3u reversals, ends %2u s", r->reversals, r->final);
+    }
+    else if (r->settle_ms == UINT32_MAX)
+    {
+        printf("never settles, ends %2u s", r->final);
+    }
+    else
+    {
+        printf("settles in %3u ms", r->settle_ms);
+    }
+}
+
+static void bench_traces(void)
+{
+    Replay_t legacy, piped;
+
+    for (uint32_t i = 0; i < TRACE_COUNT; i++)
+    {
+        replay(&traces[i], true, NULL, &legacy);
+        replay(&traces[i], false, NULL, &piped);
+        printf("    %-17s legacy: ", traces[i].name);
+        print_replay(&traces[i], &legacy);
+        printf(" | pipeline: ");
+        print_replay(&traces[i], &piped);
+        printf("\n");
+    }
+    printf("    CPU busy, pipeline: %.3f%% (one SS3 interrupt per 10 ms)\n",
+           100.0 * piped.busy / piped.cycles);
+}
+
+/* Filter weight and hysteresis against flicker and settle time */
+static void bench_tuning(void)
+{
+    static const uint8_t shifts[] = {0, 1, 2, 3, 4};
+    static const uint16_t margins[] = {0, 20, 40, 60};
+
+    printf("    shift hyst | spread  edge changes  edge+drop changes  turn settle ms\n");
+    for (uint32_t s = 0; s < sizeof(shifts); s++)
+    {
+        for (uint32_t m = 0; m < sizeof(margins) / sizeof(margins[0]); m++)
+        {
+            Potentiometer_Filter_t config = {shifts[s], margins[m]};
+            Replay_t edge, drops, turn;
+
+            replay(&traces[1], false, &config, &edge);
+            replay(&traces[2], false, &config, &drops);
+            replay(&traces[5], false, &config, &turn);
+            printf("    %5u %4u | %6u  %12u  %17u  %14d%s\n", shifts[s], margins[m],
+                   drops.spread, edge.changes, drops.changes,
+                   turn.settle_ms == UINT32_MAX ? -1 : (int)turn.settle_ms,
+                   (shifts[s] == POTENTIOMETER_FILTER_SHIFT &&
+                    margins[m] == POTENTIOMETER_HYSTERESIS) ? "  <- default" : "");
+        }
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend Potentiometer Tests ---\n");
+    run_test("Pin Setup", test_pin_setup);
+    run_test("Timer Triggered", test_timer_triggered);
+    run_test("Stale Queue Dropped", test_stale_queue_dropped);
+    run_test("Software Read", test_software_read);
+    run_test("Hysteresis", test_hysteresis);
+    run_test("Noisy Traces", test_noisy_traces);
+
+    printf("\n--- Noisy Traces, Polled Every %u ms ---\n", POLL_MS);
+    bench_traces();
+
+    printf("\n--- Filter Tuning ---\n");
+    bench_tuning();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
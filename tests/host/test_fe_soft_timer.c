@@ -0,0 +1,437 @@
+/*
+ * test_fe_soft_timer.c - Host tests for the frontend software timers
+ *
+ * Runs frontend/MCAL/soft_timer.c on the virtual SysTick clock from
+ * fake_systick.c, advancing it one millisecond at a time and calling
+ * SoftTimer_Process() like the scheduler does. Checks one-shot, periodic,
+ * cancel and re-arm-from-callback behaviour, same-millisecond ordering, a
+ * stalled main loop, and timers spanning the 32-bit millisecond wrap, then
+ * fires a few hundred random timers and verifies each expires exactly on
+ * its millisecond. Ends with a benchmark of start/cancel/expire cost at
+ * frontend-sized timer counts.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host tests/host/test_fe_soft_timer.c \
+ *       tests/host/fake_systick.c tests/test_common.c \
+ *       frontend/MCAL/soft_timer.c -o test_fe_soft_timer
+ *   ./test_fe_soft_timer
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../test_common.h"
+#include "fake_systick.h"
+#include "../../frontend/MCAL/soft_timer.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define MANY_TIMERS     300
+#define MAX_DELAY_MS    3000
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+typedef struct {
+    SoftTimer_t timer;
+    uint64_t    due;            /* Expected ms of (next) expiry */
+    uint32_t    period;
+    uint32_t    fired;
+    uint32_t    late;           /* Fired on the wrong millisecond */
+    uint32_t    fired_at_cancel;
+    uint32_t    order;          /* Global sequence number of last expiry */
+} probe_t;
+
+static probe_t probes[MANY_TIMERS];
+static uint32_t sequence = 0;
+
+/* Advance the virtual clock by one millisecond and run the main loop once */
+static void tick(void)
+{
+    FakeSysTick_AdvanceMs(1);
+    SoftTimer_Process();
+}
+
+static void run_ms(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        tick();
+    }
+}
+
+static void probe_cb(void *arg)
+{
+    probe_t *p = (probe_t *)arg;
+
+    if (SysTick_GetMs64() != p->due)
+    {
+        p->late++;
+    }
+    p->fired++;
+    p->order = ++sequence;
+    p->due += p->period;
+}
+
+static void reset_timers(void)
+{
+    SysTick_Init(16000, SYSTICK_INT);
+    SoftTimer_Init();
+    sequence = 0;
+    for (uint32_t i = 0; i < MANY_TIMERS; i++)
+    {
+        probes[i].due = 0;
+        probes[i].period = 0;
+        probes[i].fired = 0;
+        probes[i].late = 0;
+        probes[i].fired_at_cancel = 0;
+        probes[i].order = 0;
+    }
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+
+static TestResult test_one_shot(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_timers();
+    p->due = 25;
+    SoftTimer_Start(&p->timer, 25, probe_cb, p);
+    TEST_ASSERT(SoftTimer_IsActive(&p->timer));
+    TEST_ASSERT_EQUAL(25, SoftTimer_MsUntilNext());
+
+    run_ms(24);
+    TEST_ASSERT_EQUAL(0, p->fired);
+    run_ms(100);
+    TEST_ASSERT_EQUAL(1, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+    TEST_ASSERT(!SoftTimer_IsActive(&p->timer));
+    TEST_ASSERT_EQUAL(UINT32_MAX, SoftTimer_MsUntilNext());
+
+    TEST_PASS();
+}
+
+static TestResult test_zero_delay_rounds_up(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_timers();
+    p->due = 1;
+    SoftTimer_Start(&p->timer, 0, probe_cb, p);
+
+    /* Not due in the pass that armed it */
+    SoftTimer_Process();
+    TEST_ASSERT_EQUAL(0, p->fired);
+    tick();
+    TEST_ASSERT_EQUAL(1, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+
+    TEST_PASS();
+}
+
+static TestResult test_cancel_and_restart(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_timers();
+    SoftTimer_Start(&p->timer, 10, probe_cb, p);
+    run_ms(5);
+    SoftTimer_Cancel(&p->timer);
+    SoftTimer_Cancel(&p->timer);        /* Second cancel is harmless */
+    TEST_ASSERT(!SoftTimer_IsActive(&p->timer));
+    run_ms(20);
+    TEST_ASSERT_EQUAL(0, p->fired);
+
+    /* Restarting an armed timer replaces its deadline */
+    SoftTimer_Start(&p->timer, 10, probe_cb, p);
+    run_ms(5);
+    p->due = SysTick_GetMs64() + 30;
+    SoftTimer_Start(&p->timer, 30, probe_cb, p);
+    run_ms(100);
+    TEST_ASSERT_EQUAL(1, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+
+    TEST_PASS();
+}
+
+static TestResult test_periodic_no_drift(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_timers();
+    p->due = 7;
+    p->period = 7;
+    SoftTimer_StartPeriodic(&p->timer, 7, probe_cb, p);
+
+    run_ms(700);
+    TEST_ASSERT_EQUAL(100, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+    TEST_ASSERT(SoftTimer_IsActive(&p->timer));
+
+    SoftTimer_Cancel(&p->timer);
+    run_ms(100);
+    TEST_ASSERT_EQUAL(100, p->fired);
+
+    TEST_PASS();
+}
+
+static TestResult test_same_ms_in_start_order(void)
+{
+    reset_timers();
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        probes[i].due = 10;
+        SoftTimer_Start(&probes[i].timer, 10, probe_cb, &probes[i]);
+    }
+    /* An earlier deadline armed last still goes first */
+    probes[5].due = 9;
+    SoftTimer_Start(&probes[5].timer, 9, probe_cb, &probes[5]);
+
+    run_ms(20);
+    TEST_ASSERT_EQUAL(1, probes[5].order);
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        TEST_ASSERT_EQUAL(i + 2, probes[i].order);
+        TEST_ASSERT_EQUAL(0, probes[i].late);
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_stalled_main_loop(void)
+{
+    probe_t *a = &probes[0];
+    probe_t *b = &probes[1];
+
+    reset_timers();
+    SoftTimer_Start(&a->timer, 20, probe_cb, a);
+    SoftTimer_StartPeriodic(&b->timer, 10, probe_cb, b);
+
+    /* Main loop busy for 100 ms (e.g. LCD init), then one pass */
+    FakeSysTick_AdvanceMs(100);
+    SoftTimer_Process();
+
+    /* Everything due is delivered in that pass, periodic ones included */
+    TEST_ASSERT_EQUAL(1, a->fired);
+    TEST_ASSERT_EQUAL(10, b->fired);
+    TEST_ASSERT_EQUAL(10, SoftTimer_MsUntilNext());
+
+    TEST_PASS();
+}
+
+/* Callback that cancels a sibling due on the same ms and re-arms itself */
+static SoftTimer_t self_timer;
+static SoftTimer_t sibling_timer;
+static uint32_t self_runs = 0;
+static uint32_t sibling_runs = 0;
+
+static void sibling_cb(void *arg)
+{
+    (void)arg;
+    sibling_runs++;
+}
+
+static void self_cb(void *arg)
+{
+    (void)arg;
+    self_runs++;
+    SoftTimer_Cancel(&sibling_timer);
+    if (self_runs < 3)
+    {
+        SoftTimer_Start(&self_timer, 4, self_cb, NULL);
+    }
+}
+
+static TestResult test_callback_modifies_timers(void)
+{
+    reset_timers();
+    self_runs = 0;
+    sibling_runs = 0;
+
+    /* Self was armed first, so it runs first and the sibling never does */
+    SoftTimer_Start(&self_timer, 4, self_cb, NULL);
+    SoftTimer_Start(&sibling_timer, 4, sibling_cb, NULL);
+    run_ms(100);
+
+    TEST_ASSERT_EQUAL(0, sibling_runs);
+    TEST_ASSERT_EQUAL(3, self_runs);
+    TEST_ASSERT(!SoftTimer_IsActive(&self_timer));
+
+    TEST_PASS();
+}
+
+static TestResult test_across_32bit_wrap(void)
+{
+    probe_t *a = &probes[0];
+    probe_t *b = &probes[1];
+
+    reset_timers();
+    FakeSysTick_SetMs(0xFFFFFFFFULL - 50);
+
+    a->due = SysTick_GetMs64() + 100;
+    SoftTimer_Start(&a->timer, 100, probe_cb, a);
+    b->due = SysTick_GetMs64() + 20;
+    b->period = 20;
+    SoftTimer_StartPeriodic(&b->timer, 20, probe_cb, b);
+
+    run_ms(200);
+
+    /* The 32-bit view wrapped; the timers, on the 64-bit clock, did not */
+    TEST_ASSERT(SysTick_GetMs() < 200);
+    TEST_ASSERT_EQUAL(1, a->fired);
+    TEST_ASSERT_EQUAL(10, b->fired);
+    TEST_ASSERT_EQUAL(0, a->late + b->late);
+
+    TEST_PASS();
+}
+
+static TestResult test_many_random_timers(void)
+{
+    uint32_t cancelled = 0;
+    uint32_t fired = 0;
+    uint32_t late = 0;
+
+    reset_timers();
+    srand(4321);
+
+    /* Arm timers gradually over the first few hundred ms, a mix of
+     * one-shot and periodic, then cancel every seventh one */
+    for (uint32_t i = 0; i < MANY_TIMERS; i++)
+    {
+        probe_t *p = &probes[i];
+        uint32_t ms = 1 + (uint32_t)(rand() % MAX_DELAY_MS);
+
+        if ((i % 5) == 0)
+        {
+            tick();
+        }
+        p->due = SysTick_GetMs64() + ms;
+        if ((i % 10) == 0)
+        {
+            p->period = ms;
+            SoftTimer_StartPeriodic(&p->timer, ms, probe_cb, p);
+        }
+        else
+        {
+            SoftTimer_Start(&p->timer, ms, probe_cb, p);
+        }
+    }
+    for (uint32_t i = 0; i < MANY_TIMERS; i += 7)
+    {
+        SoftTimer_Cancel(&probes[i].timer);
+        probes[i].fired_at_cancel = probes[i].fired;
+        cancelled++;
+    }
+
+    run_ms(MAX_DELAY_MS + 200);
+
+    for (uint32_t i = 0; i < MANY_TIMERS; i++)
+    {
+        probe_t *p = &probes[i];
+        late += p->late;
+        if ((i % 7) == 0)
+        {
+            TEST_ASSERT_EQUAL(p->fired_at_cancel, p->fired);
+        }
+        else if (p->period == 0)
+        {
+            TEST_ASSERT_EQUAL(1, p->fired);
+            TEST_ASSERT(!SoftTimer_IsActive(&p->timer));
+            fired++;
+        }
+        else
+        {
+            TEST_ASSERT(p->fired >= 1);
+            fired += p->fired;
+            SoftTimer_Cancel(&p->timer);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, late);
+
+    printf("    %u timers, %u cancelled, %u expiries, 0 late\n",
+           MANY_TIMERS, cancelled, fired);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench(uint32_t active)
+{
+    const uint32_t rounds = 200;
+    double t_start = 0.0, t_cancel = 0.0, t_expire = 0.0, t_idle = 0.0;
+
+    srand(99);
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        reset_timers();
+
+        double t0 = now_sec();
+        for (uint32_t i = 0; i < active; i++)
+        {
+            SoftTimer_Start(&probes[i].timer,
+                            1 + (uint32_t)(rand() % MAX_DELAY_MS),
+                            probe_cb, &probes[i]);
+        }
+        t_start += now_sec() - t0;
+
+        /* A pass with nothing due only looks at the head of the list */
+        t0 = now_sec();
+        SoftTimer_Process();
+        t_idle += now_sec() - t0;
+
+        t0 = now_sec();
+        for (uint32_t i = 0; i < active; i += 2)
+        {
+            SoftTimer_Cancel(&probes[i].timer);
+        }
+        t_cancel += now_sec() - t0;
+
+        t0 = now_sec();
+        run_ms(MAX_DELAY_MS);
+        t_expire += now_sec() - t0;
+    }
+
+    printf("    %3u active: start %5.1f ns, cancel %5.1f ns per timer; "
+           "idle pass %5.1f ns, 1 ms pass while expiring %5.1f ns\n",
+           active,
+           t_start * 1e9 / (rounds * active),
+           t_cancel * 1e9 / (rounds * ((active + 1) / 2)),
+           t_idle * 1e9 / rounds,
+           t_expire * 1e9 / (rounds * MAX_DELAY_MS));
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend Soft Timer Tests ---\n");
+    run_test("One Shot", test_one_shot);
+    run_test("Zero Delay Rounds Up", test_zero_delay_rounds_up);
+    run_test("Cancel And Restart", test_cancel_and_restart);
+    run_test("Periodic No Drift", test_periodic_no_drift);
+    run_test("Same Millisecond In Start Order", test_same_ms_in_start_order);
+    run_test("Stalled Main Loop", test_stalled_main_loop);
+    run_test("Callback Modifies Timers", test_callback_modifies_timers);
+    run_test("Across 32-bit Wrap", test_across_32bit_wrap);
+    run_test("Many Random Timers", test_many_random_timers);
+
+    printf("\n--- Soft Timer Cost (sorted list, host ns) ---\n");
+    bench(4);
+    bench(16);
+    bench(64);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
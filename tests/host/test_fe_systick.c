@@ -0,0 +1,168 @@
+/*
+ * test_fe_systick.c - Host tests for the frontend SysTick clock
+ *
+ * Runs the real frontend/MCAL/systick.c against the register-level SysTick
+ * model in fake_tm4c123 (down-counter and tick interrupt in step with a
+ * virtual 16 MHz CPU). Checks that the microsecond clock tracks CPU cycles,
+ * never goes backwards when read on either side of a tick, agrees with the
+ * millisecond clock, that DelayMs sleeps for the time asked and that
+ * DelayUs busy-waits it, across reloads and with interrupts masked.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -include tests/host/fake_tm4c123.h -I tests/host/iar \
+ *       tests/host/test_fe_systick.c tests/host/fake_tm4c123.c \
+ *       tests/test_common.c frontend/MCAL/systick.c -o test_fe_systick
+ *   ./test_fe_systick
+ */
+
+#include "../test_common.h"
+#include "../../frontend/MCAL/systick.h"
+#include <intrinsics.h>
+#include <stdlib.h>
+
+#define CYCLES_PER_US       (FAKE_TM4C_CLOCK / 1000000)
+#define CYCLES_PER_MS       (FAKE_TM4C_CLOCK / 1000)
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static uint64_t start_cycles;
+
+static void reset_clock(void)
+{
+    FakeTM4C_Init();
+    SysTick_Init(CYCLES_PER_MS, SYSTICK_INT);
+    (void)SysTick_GetUs();      /* First access starts the modelled counter */
+    start_cycles = FakeTM4C_Cycles();
+}
+
+static uint64_t elapsed_us(void)
+{
+    return (FakeTM4C_Cycles() - start_cycles) / CYCLES_PER_US;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+
+static TestResult test_us_tracks_cycles(void)
+{
+    reset_clock();
+    srand(77);
+
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        FakeTM4C_Run(1 + (uint64_t)(rand() % (3 * CYCLES_PER_MS)));
+        uint64_t expect = elapsed_us();
+        uint64_t us = SysTick_GetUs();
+
+        /* Register reads cost a few cycles; allow a microsecond each side */
+        TEST_ASSERT(us + 1 >= expect && us <= expect + 1);
+    }
+    printf("    %.1f virtual ms covered\n", (double)elapsed_us() / 1000.0);
+
+    TEST_PASS();
+}
+
+static TestResult test_monotonic_across_ticks(void)
+{
+    uint64_t last;
+    uint32_t backwards = 0;
+
+    reset_clock();
+    last = SysTick_GetUs();
+
+    /* Step through tick boundaries a few cycles at a time, so reads land
+     * just before, on and just after the reload */
+    for (uint32_t i = 0; i < 50000; i++)
+    {
+        FakeTM4C_Run(1 + (i % 7));
+        uint64_t us = SysTick_GetUs();
+        if (us < last) backwards++;
+        last = us;
+    }
+    TEST_ASSERT_EQUAL(0, backwards);
+    TEST_ASSERT(SysTick_GetMs64() >= 20);
+
+    TEST_PASS();
+}
+
+static TestResult test_ms_agrees_with_us(void)
+{
+    reset_clock();
+
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        FakeTM4C_Run(CYCLES_PER_MS / 3);
+        uint64_t ms = SysTick_GetMs64();
+        uint64_t us = SysTick_GetUs();
+
+        TEST_ASSERT(us / 1000 == ms || us / 1000 == ms + 1);
+        TEST_ASSERT_EQUAL((uint32_t)ms, SysTick_GetMs());
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_delay_ms_sleeps(void)
+{
+    uint64_t c0, slept0;
+
+    reset_clock();
+    FakeTM4C_Run(CYCLES_PER_MS / 2);    /* Start mid-tick */
+
+    c0 = FakeTM4C_Cycles();
+    slept0 = FakeTM4C_SleepCycles();
+    DelayMs(10);
+
+    /* Whole ticks, so 9.5..10 ms depending on where we started */
+    uint64_t took = FakeTM4C_Cycles() - c0;
+    TEST_ASSERT(took >= 9 * CYCLES_PER_MS && took <= 10 * CYCLES_PER_MS + 100);
+    TEST_ASSERT(FakeTM4C_SleepCycles() - slept0 > took * 9 / 10);
+
+    TEST_PASS();
+}
+
+static TestResult test_delay_us(void)
+{
+    static const uint32_t waits[] = {1, 37, 53, 100, 999, 1000, 4100};
+
+    reset_clock();
+    for (uint32_t i = 0; i < sizeof(waits) / sizeof(waits[0]); i++)
+    {
+        /* Start at different points of the tick, so some waits span the
+         * reload */
+        FakeTM4C_Run(1 + (uint64_t)i * 2333);
+        uint64_t c0 = FakeTM4C_Cycles();
+        DelayUs(waits[i]);
+        uint64_t took = FakeTM4C_Cycles() - c0;
+
+        TEST_ASSERT(took >= (uint64_t)waits[i] * CYCLES_PER_US);
+        TEST_ASSERT(took <= (uint64_t)waits[i] * CYCLES_PER_US + 64);
+    }
+
+    /* Interrupts masked: the tick cannot run, the delay still ends */
+    __disable_interrupt();
+    uint64_t c0 = FakeTM4C_Cycles();
+    DelayUs(2500);
+    uint64_t took = FakeTM4C_Cycles() - c0;
+    __enable_interrupt();
+    TEST_ASSERT(took >= 2500 * CYCLES_PER_US && took <= 2500 * CYCLES_PER_US + 64);
+
+    TEST_PASS();
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend SysTick Clock Tests ---\n");
+    run_test("Microseconds Track Cycles", test_us_tracks_cycles);
+    run_test("Monotonic Across Ticks", test_monotonic_across_ticks);
+    run_test("Milliseconds Agree With Microseconds", test_ms_agrees_with_us);
+    run_test("DelayMs Sleeps", test_delay_ms_sleeps);
+    run_test("DelayUs", test_delay_us);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
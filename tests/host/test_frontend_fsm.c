@@ -0,0 +1,845 @@
+/*
+ * test_frontend_fsm.c - Host tests for the event-driven frontend state
+ * machine and its cooperative scheduler
+ *
+ * Links the real application layer (scheduler, state handlers, password
+ * entry, UI helpers, command handles) against fakes for the HAL: a 2x16
+ * LCD model, a scripted keypad, the potentiometer and the LED. The real
+ * UART protocol runs over a fake UART driver wired to a simulated backend
+ * that answers v2 frames after a configurable delay, and SysTick is the
+ * virtual clock in fake_systick.c, which advances only when the scheduler
+ * or the driver sleeps. Timers run on the real frontend soft timer
+ * service.
+ *
+ * Walks signup, sign-in with the door countdown, wrong passwords into
+ * lockout, change password, set timeout and a dead link, and checks that
+ * keys are still scanned and the LCD still animates while a command is in
+ * flight or the link is being renegotiated. Ends with a scripted session reporting per-event handling cost
+ * and key-to-screen latency.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I frontend/application -I tests/host \
+ *       tests/host/test_frontend_fsm.c tests/host/fake_systick.c \
+ *       tests/test_common.c frontend/MCAL/soft_timer.c \
+ *       frontend/application/application.c \
+ *       frontend/application/scheduler.c frontend/application/ui_display.c \
+ *       frontend/application/input_handler.c \
+ *       frontend/application/auth_handlers.c \
+ *       frontend/application/menu_handlers.c \
+ *       frontend/application/uart_commands.c \
+ *       frontend/application/uart_protocol.c \
+ *       frontend/application/crc16.c -o test_frontend_fsm
+ *   ./test_frontend_fsm
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../test_common.h"
+#include "application.h"
+#include "scheduler.h"
+#include "uart_commands.h"
+#include "crc16.h"
+#include "fake_systick.h"
+#include "../../frontend/MCAL/soft_timer.h"
+#include "../../frontend/MCAL/uart.h"
+#include "../../frontend/HAL/lcd.h"
+#include "../../frontend/HAL/keypad.h"
+#include "../../frontend/HAL/potentiometer.h"
+#include "../../frontend/HAL/led.h"
+#include <string.h>
+#include <time.h>
+
+#define KEY_GAP_MS      150     /* Typing speed in scripts */
+#define KEY_TAP_MS      80      /* Press to release of a tap */
+#define MAX_KEYS        256
+#define DEAD_LINK_MS    3000    /* AUTH resent with backoff, then failed */
+
+/*===========================================================================
+ * LCD model
+ *===========================================================================*/
+static char screen[LCD_ROWS][LCD_COLS + 1];
+static char shadow[LCD_ROWS][LCD_COLS];
+static uint8_t cur_row = 0, cur_col = 0;
+static uint32_t lcd_writes = 0;         /* Characters changed on screen */
+static uint32_t lcd_last_write = 0;
+
+static void put(uint8_t row, uint8_t col, char c)
+{
+    if (row < LCD_ROWS && col < LCD_COLS && screen[row][col] != c)
+    {
+        screen[row][col] = c;
+        lcd_writes++;
+        lcd_last_write = SysTick_GetMs();
+    }
+}
+
+void LCD_Init(void) {}
+void LCD_Command(uint8_t cmd) { (void)cmd; }
+
+void LCD_Clear(void)
+{
+    for (uint8_t r = 0; r < LCD_ROWS; r++)
+    {
+        for (uint8_t c = 0; c < LCD_COLS; c++) put(r, c, ' ');
+        screen[r][LCD_COLS] = '\0';
+    }
+    cur_row = cur_col = 0;
+}
+
+void LCD_SetCursor(uint8_t row, uint8_t col)
+{
+    cur_row = row;
+    cur_col = col;
+}
+
+void LCD_WriteChar(char c)
+{
+    put(cur_row, cur_col++, c);
+}
+
+void LCD_WriteString(const char *str)
+{
+    while (*str) LCD_WriteChar(*str++);
+}
+
+void LCD_BufferClear(void)
+{
+    memset(shadow, ' ', sizeof(shadow));
+}
+
+void LCD_BufferPutChar(uint8_t row, uint8_t col, char c)
+{
+    if (row < LCD_ROWS && col < LCD_COLS) shadow[row][col] = c;
+}
+
+void LCD_BufferWrite(uint8_t row, uint8_t col, const char *str)
+{
+    while (*str) LCD_BufferPutChar(row, col++, *str++);
+}
+
+void LCD_Flush(void)
+{
+    for (uint8_t r = 0; r < LCD_ROWS; r++)
+    {
+        for (uint8_t c = 0; c < LCD_COLS; c++) put(r, c, shadow[r][c]);
+    }
+}
+
+/* Line text with trailing blanks removed */
+static const char *line(uint8_t row)
+{
+    static char buf[LCD_COLS + 1];
+    int n = LCD_COLS;
+
+    memcpy(buf, screen[row], LCD_COLS + 1);
+    while (n > 0 && buf[n - 1] == ' ') buf[--n] = '\0';
+    return buf;
+}
+
+static int shows(uint8_t row, const char *text)
+{
+    return strcmp(line(row), text) == 0;
+}
+
+/*===========================================================================
+ * Keypad, potentiometer and LED fakes
+ *===========================================================================*/
+static struct { char key; uint8_t type; uint32_t at; } keys[MAX_KEYS];
+static uint32_t key_rd = 0, key_wr = 0;
+static uint32_t key_scans = 0;
+static uint32_t key_last_scan = 0;
+static uint32_t key_scan_gap = 0;       /* Longest time between scans */
+static uint32_t pot_seconds = 10;
+static uint8_t led_color = LED_OFF;
+static uint32_t led_changes = 0;
+
+void Keypad_Init(void) {}
+
+bool Keypad_GetEvent(Keypad_Event_t *event)
+{
+    key_scans++;
+    if (SysTick_GetMs() - key_last_scan > key_scan_gap) key_scan_gap = SysTick_GetMs() - key_last_scan;
+    key_last_scan = SysTick_GetMs();
+    if (key_rd != key_wr && keys[key_rd % MAX_KEYS].at <= SysTick_GetMs())
+    {
+        event->key = keys[key_rd % MAX_KEYS].key;
+        event->type = keys[key_rd % MAX_KEYS].type;
+        event->timeMs = keys[key_rd % MAX_KEYS].at;
+        key_rd++;
+        return true;
+    }
+    return false;
+}
+
+void Potentiometer_Init(void) {}
+uint32_t Potentiometer_Read(void) { return pot_seconds * 4095 / 30; }
+uint32_t Potentiometer_GetTimeout(void) { return pot_seconds; }
+
+void LED_Init(void) {}
+void LED_SetColor(uint8_t color) { if (color != led_color) led_changes++; led_color = color; }
+void LED_Off(void) { LED_SetColor(LED_OFF); }
+void LED_Red(void) { LED_SetColor(LED_RED); }
+void LED_Green(void) { LED_SetColor(LED_GREEN); }
+void LED_Blue(void) { LED_SetColor(LED_BLUE); }
+void LED_Yellow(void) { LED_SetColor(LED_YELLOW); }
+void LED_Cyan(void) { LED_SetColor(LED_CYAN); }
+void LED_Blink(uint8_t color, uint8_t times, uint16_t delayMs)
+{
+    (void)color; (void)times; (void)delayMs;
+}
+
+/*===========================================================================
+ * Simulated backend behind the real protocol (frontend/MCAL/uart.h)
+ *===========================================================================*/
+#define MAX_REPLIES     8
+
+/* Responses on their way back, due in order */
+static struct { uint32_t due; uint8_t seq; uint8_t len; uint8_t bytes[40]; } replies[MAX_REPLIES];
+static uint8_t reply_count = 0;
+static uint8_t reply_pos = 0;           /* Bytes of replies[0] already read */
+/* Last response per SEQ, resent for a retransmission */
+static struct { uint8_t valid; uint8_t len; uint8_t bytes[40]; } sent[256];
+static uint8_t tx_frame[40];
+static uint8_t tx_pos = 0;
+static uint32_t backend_ms = 30;        /* Reply delay */
+static int link_dead = 0;
+static uint32_t reinit_count = 0;
+static char stored_pw[PASSWORD_LENGTH];
+static uint8_t stored_timeout = 10;
+static uint32_t commands = 0;
+
+static uint8_t execute(uint8_t cmd, const uint8_t *p, uint8_t *out, uint8_t *outLen)
+{
+    *outLen = 0;
+    switch (cmd)
+    {
+        case UART_CMD_HELLO:
+            out[0] = UART_PROTOCOL_VERSION;
+            *outLen = 1;
+            return STATUS_OK;
+        case CMD_INIT_PASSWORD:
+        case CMD_CHANGE_PASSWORD:
+            memcpy(stored_pw, p, PASSWORD_LENGTH);
+            return STATUS_OK;
+        case CMD_AUTH:
+            if (memcmp(stored_pw, &p[1], PASSWORD_LENGTH) != 0) return STATUS_AUTH_FAIL;
+            if (p[0] == AUTH_MODE_OPEN_DOOR)
+            {
+                out[0] = stored_timeout;
+                *outLen = 1;
+            }
+            return STATUS_OK;
+        case CMD_SET_TIMEOUT:
+            stored_timeout = p[0];
+            return STATUS_OK;
+        case CMD_GET_TIMEOUT:
+            out[0] = stored_timeout;
+            *outLen = 1;
+            return STATUS_OK;
+        default:
+            return STATUS_UNKNOWN_CMD;
+    }
+}
+
+static void queue_reply(uint8_t seq, const uint8_t *bytes, uint8_t len, uint32_t due)
+{
+    uint8_t at = reply_count;
+
+    if (reply_count == MAX_REPLIES) return;
+    while (at > (reply_pos > 0 ? 1 : 0) && replies[at - 1].due > due) at--;
+    memmove(&replies[at + 1], &replies[at], (reply_count - at) * sizeof(replies[0]));
+    replies[at].due = due;
+    replies[at].seq = seq;
+    replies[at].len = len;
+    memcpy(replies[at].bytes, bytes, len);
+    reply_count++;
+}
+
+/* Request body is [0xA5][SEQ][CMD][PAYLOAD...][CRC_H][CRC_L] */
+static void backend_receive(const uint8_t *body, uint8_t len)
+{
+    uint8_t rsp[40];
+    uint8_t dataLen, n = 0;
+    uint8_t lenByte = len;
+    uint16_t crc;
+
+    if (link_dead || len < 5 || body[0] != UART_V2_MARKER) return;
+    crc = CRC16_Update(CRC16_INIT, &lenByte, 1);
+    crc = CRC16_Update(crc, body, (uint8_t)(len - 2));
+    if (crc != (uint16_t)((body[len - 2] << 8) | body[len - 1])) return;
+
+    /* Still working on it, or answer the retransmission from the cache */
+    for (uint8_t i = 0; i < reply_count; i++)
+    {
+        if (replies[i].seq == body[1]) return;
+    }
+    if (body[2] == UART_CMD_HELLO)
+    {
+        memset(sent, 0, sizeof(sent));
+    }
+    else if (sent[body[1]].valid)
+    {
+        queue_reply(body[1], sent[body[1]].bytes, sent[body[1]].len, SysTick_GetMs() + 1);
+        return;
+    }
+    else
+    {
+        commands++;
+    }
+
+    rsp[n++] = SOF_RESPONSE;
+    n++;                                /* LEN */
+    rsp[n++] = UART_V2_MARKER;
+    rsp[n++] = body[1];
+    rsp[n++] = body[2];
+    rsp[n] = execute(body[2], &body[3], &rsp[n + 1], &dataLen);
+    n = (uint8_t)(n + 1 + dataLen);
+    rsp[1] = (uint8_t)(n);              /* Body plus CRC, less SOF and LEN */
+    crc = CRC16_Update(CRC16_INIT, &rsp[1], 1);
+    crc = CRC16_Update(crc, &rsp[2], (uint8_t)(n - 2));
+    rsp[n++] = (uint8_t)(crc >> 8);
+    rsp[n++] = (uint8_t)(crc & 0xFF);
+
+    sent[body[1]].valid = 1;
+    sent[body[1]].len = n;
+    memcpy(sent[body[1]].bytes, rsp, n);
+    queue_reply(body[1], rsp, n, SysTick_GetMs() + backend_ms);
+}
+
+static void link_reset(void)
+{
+    reply_count = 0;
+    reply_pos = 0;
+    tx_pos = 0;
+    memset(sent, 0, sizeof(sent));
+}
+
+void UART_Driver_Init(void) { link_reset(); }
+void UART_Driver_Reinit(void) { tx_pos = 0; reinit_count++; }
+void UART_Driver_WaitTxComplete(void) {}
+
+/* Bytes leave at once; the backend sees a frame when its last byte is sent */
+uint8_t UART_Driver_SendByte(uint8_t data)
+{
+    if (tx_pos == 0 && data != SOF_REQUEST) return 1;
+    if (tx_pos == 1 && data > sizeof(tx_frame) - 2) { tx_pos = 0; return 1; }
+    tx_frame[tx_pos++] = data;
+    if (tx_pos > 1 && tx_pos == tx_frame[1] + 2)
+    {
+        backend_receive(&tx_frame[2], tx_frame[1]);
+        tx_pos = 0;
+    }
+    return 1;
+}
+
+static int reply_ready(void)
+{
+    return reply_count > 0 && replies[0].due <= SysTick_GetMs();
+}
+
+uint8_t UART_Driver_TryReceiveByte(uint8_t *data)
+{
+    if (!reply_ready()) return 0;
+    *data = replies[0].bytes[reply_pos++];
+    if (reply_pos == replies[0].len)
+    {
+        memmove(&replies[0], &replies[1], (reply_count - 1) * sizeof(replies[0]));
+        reply_count--;
+        reply_pos = 0;
+    }
+    return 1;
+}
+
+void UART_Driver_FlushRx(void)
+{
+    uint8_t byte;
+
+    while (UART_Driver_TryReceiveByte(&byte)) {}
+}
+
+uint8_t UART_Driver_WaitRx(uint32_t deadlineMs)
+{
+    while (!reply_ready())
+    {
+        uint32_t now = SysTick_GetMs();
+        uint32_t until = deadlineMs;
+
+        if ((int32_t)(deadlineMs - now) <= 0) return 0;
+        if (reply_count > 0 && replies[0].due < until) until = replies[0].due;
+        DelayMs(until - now);
+    }
+    return 1;
+}
+
+uint8_t UART_Driver_ReceiveByteUntil(uint8_t *data, uint32_t deadlineMs)
+{
+    return UART_Driver_WaitRx(deadlineMs) && UART_Driver_TryReceiveByte(data);
+}
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static void run_ms(uint32_t ms)
+{
+    uint32_t end = SysTick_GetMs() + ms;
+
+    while (SysTick_GetMs() < end) Scheduler_RunOnce();
+}
+
+/* Run until the row reads text, at most maxMs */
+static int run_until_shows(uint8_t row, const char *text, uint32_t maxMs)
+{
+    uint32_t end = SysTick_GetMs() + maxMs;
+
+    while (!shows(row, text) && SysTick_GetMs() < end) Scheduler_RunOnce();
+    return shows(row, text);
+}
+
+static void queue_key(char key, uint8_t type, uint32_t at)
+{
+    keys[key_wr % MAX_KEYS].key = key;
+    keys[key_wr % MAX_KEYS].type = type;
+    keys[key_wr % MAX_KEYS].at = at;
+    key_wr++;
+}
+
+static void press(char key)
+{
+    uint32_t now = SysTick_GetMs();
+
+    queue_key(key, KEYPAD_EVENT_PRESS, now);
+    queue_key(key, KEYPAD_EVENT_RELEASE, now + KEY_TAP_MS);
+    run_ms(KEY_GAP_MS);
+}
+
+/* Held past the long-press time */
+static void hold(char key)
+{
+    uint32_t now = SysTick_GetMs();
+
+    queue_key(key, KEYPAD_EVENT_PRESS, now);
+    queue_key(key, KEYPAD_EVENT_LONG_PRESS, now + KEYPAD_LONG_PRESS_MS);
+    queue_key(key, KEYPAD_EVENT_RELEASE, now + KEYPAD_LONG_PRESS_MS + 200);
+    run_ms(KEYPAD_LONG_PRESS_MS + 200 + KEY_GAP_MS);
+}
+
+static void type(const char *s)
+{
+    while (*s) press(*s++);
+}
+
+static void reset_world(void)
+{
+    SysTick_Init(16000, SYSTICK_INT);
+    SoftTimer_Init();
+    key_rd = key_wr = 0;
+    key_scans = 0;
+    key_last_scan = 0;
+    key_scan_gap = 0;
+    pot_seconds = 10;
+    led_color = LED_OFF;
+    led_changes = 0;
+    backend_ms = 30;
+    link_dead = 0;
+    reinit_count = 0;
+    memset(stored_pw, 0, sizeof(stored_pw));
+    stored_timeout = 10;
+    commands = 0;
+    LCD_Clear();
+    LCD_BufferClear();
+    Frontend_Init();
+}
+
+/* Boot and sign up with 12345, ending on the main menu */
+static int boot_and_signup(void)
+{
+    reset_world();
+    run_ms(2100);
+    if (!shows(0, "Create Password:")) return 0;
+    type("12345");
+    run_ms(400);
+    type("12345");
+    run_ms(200);
+    if (!shows(0, "Password Saved!")) return 0;
+    run_ms(1600);
+    return Frontend_GetState() == STATE_MAIN_MENU;
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_boot_to_signup(void)
+{
+    reset_world();
+    TEST_ASSERT_EQUAL(STATE_WELCOME, Frontend_GetState());
+    TEST_ASSERT(shows(0, "Door Locker"));
+    TEST_ASSERT_EQUAL(LED_BLUE, led_color);
+
+    run_ms(1900);
+    TEST_ASSERT_EQUAL(STATE_WELCOME, Frontend_GetState());
+    run_ms(200);
+    TEST_ASSERT_EQUAL(STATE_SIGNUP, Frontend_GetState());
+    TEST_ASSERT(shows(0, "Create Password:"));
+    TEST_ASSERT_EQUAL(LED_OFF, led_color);
+
+    /* Waiting for input nothing is dispatched; keys are scanned on the
+     * poll period */
+    Scheduler_Stats_t st;
+    Scheduler_GetStats(&st);
+    uint32_t events = st.events, scans = key_scans;
+    run_ms(1000);
+    Scheduler_GetStats(&st);
+    TEST_ASSERT_EQUAL(events, st.events);
+    TEST_ASSERT_EQUAL(1000 / KEY_POLL_MS, key_scans - scans);
+
+    TEST_PASS();
+}
+
+static TestResult test_entry_backspace_and_cancel(void)
+{
+    reset_world();
+    run_ms(2100);
+
+    type("12#");
+    TEST_ASSERT(shows(1, "*"));
+
+    /* Holding '#' clears the field without cancelling */
+    type("23");
+    TEST_ASSERT(shows(1, "***"));
+    hold('#');
+    TEST_ASSERT(shows(1, ""));
+    TEST_ASSERT(shows(0, "Create Password:"));
+    type("12345");
+    run_ms(400);
+    TEST_ASSERT(shows(0, "Confirm Password"));
+
+    /* Even on an empty field, and the clear does not leak into the next
+     * entry */
+    hold('#');
+    TEST_ASSERT(shows(0, "Confirm Password"));
+    type("1");
+    TEST_ASSERT(shows(1, "*"));
+    press('#');
+    TEST_ASSERT(shows(1, ""));
+    TEST_ASSERT(shows(0, "Confirm Password"));
+
+    /* '#' on an empty field starts signup over */
+    press('#');
+    TEST_ASSERT(shows(0, "Create Password:"));
+    TEST_ASSERT_EQUAL(0, commands);
+
+    /* Mismatch shows an error, then asks again */
+    type("11111");
+    run_ms(400);
+    type("22222");
+    TEST_ASSERT(shows(0, "Mismatch!"));
+    TEST_ASSERT_EQUAL(LED_RED, led_color);
+    run_ms(1600);
+    TEST_ASSERT(shows(0, "Create Password:"));
+    TEST_ASSERT_EQUAL(0, commands);
+
+    TEST_PASS();
+}
+
+static TestResult test_signin_opens_door(void)
+{
+    TEST_ASSERT(boot_and_signup());
+    TEST_ASSERT(shows(0, "A:Sign *:ChgPwd"));
+
+    stored_timeout = 5;
+    press('A');
+    TEST_ASSERT(shows(0, "Enter Password:"));
+    type("12345");
+    TEST_ASSERT(shows(0, "Door Open"));
+    TEST_ASSERT(shows(1, "Closing in:  5 s") || shows(1, "Closing in:  4 s"));
+    TEST_ASSERT_EQUAL(LED_GREEN, led_color);
+
+    run_ms(5000);
+    TEST_ASSERT(shows(0, "Door Closing..."));
+    TEST_ASSERT_EQUAL(LED_OFF, led_color);
+    run_ms(2000);
+    TEST_ASSERT(shows(0, "Door Locked"));
+    run_ms(1500);
+    TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+    TEST_ASSERT(shows(0, "A:Sign *:ChgPwd"));
+
+    TEST_PASS();
+}
+
+static TestResult test_ui_alive_during_round_trip(void)
+{
+    uint32_t scans, writes;
+
+    TEST_ASSERT(boot_and_signup());
+    backend_ms = 1200;
+
+    press('A');
+    type("1234");
+    press('5');
+    TEST_ASSERT(strncmp(line(0), "Verifying", 9) == 0);
+
+    /* While the reply is outstanding the keypad is scanned every poll
+     * period and the dots keep moving */
+    scans = key_scans;
+    writes = lcd_writes;
+    run_ms(800);
+    TEST_ASSERT(key_scans - scans >= 800 / KEY_POLL_MS - 1);
+    TEST_ASSERT(lcd_writes - writes >= 800 / 250);   /* One dot per step */
+    TEST_ASSERT_EQUAL(STATE_SIGNIN, Frontend_GetState());
+
+    /* Keys typed meanwhile are taken but do not disturb the request */
+    press('9');
+    run_ms(400);
+    TEST_ASSERT(shows(0, "Door Open"));
+
+    TEST_PASS();
+}
+
+static TestResult test_wrong_passwords_lock_out(void)
+{
+    TEST_ASSERT(boot_and_signup());
+    stored_timeout = 5;
+
+    for (int i = 0; i < 2; i++)
+    {
+        press('A');
+        type("99999");
+        TEST_ASSERT(shows(0, "Wrong Password!"));
+        TEST_ASSERT(shows(1, i == 0 ? "2 tries left" : "1 tries left"));
+        run_ms(1600);
+        TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+    }
+
+    press('A');
+    type("99999");
+    TEST_ASSERT(shows(0, "Too many tries!"));
+    run_ms(1600);
+    TEST_ASSERT_EQUAL(STATE_LOCKOUT, Frontend_GetState());
+    TEST_ASSERT(shows(0, "!! LOCKED OUT !!"));
+
+    /* Time fetched from the backend, then a blinking countdown */
+    run_ms(400);
+    TEST_ASSERT(shows(1, "Wait:  5 seconds"));
+    led_changes = 0;
+    run_ms(4000);
+    TEST_ASSERT(led_changes >= 7);
+    run_ms(1100);
+    TEST_ASSERT(shows(0, "Lockout Over"));
+    TEST_ASSERT_EQUAL(LED_GREEN, led_color);
+    run_ms(1600);
+    TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+
+    /* Attempts were reset: one more wrong password is not a lockout */
+    press('A');
+    type("99999");
+    TEST_ASSERT(shows(1, "2 tries left"));
+
+    TEST_PASS();
+}
+
+static TestResult test_change_password(void)
+{
+    TEST_ASSERT(boot_and_signup());
+
+    press('*');
+    TEST_ASSERT(shows(0, "Old Password:"));
+    type("12345");
+    run_ms(400);
+    TEST_ASSERT(shows(0, "New Password:"));
+    type("24680");
+    run_ms(400);
+    TEST_ASSERT(shows(0, "Confirm New Pwd:"));
+    type("24680");
+    TEST_ASSERT(shows(0, "Password Changed"));
+    TEST_ASSERT(memcmp(stored_pw, "24680", PASSWORD_LENGTH) == 0);
+    run_ms(1600);
+    TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+
+    TEST_PASS();
+}
+
+static TestResult test_set_timeout(void)
+{
+    TEST_ASSERT(boot_and_signup());
+
+    press('C');
+    TEST_ASSERT(shows(0, "Adjust Timeout"));
+    pot_seconds = 17;
+    run_ms(600);
+    TEST_ASSERT(shows(1, "Time: 17 sec"));
+    pot_seconds = 23;
+    run_ms(200);
+    TEST_ASSERT(shows(1, "Time: 23 sec"));
+
+    press('D');
+    type("12345");
+    run_ms(200);
+    TEST_ASSERT(shows(0, "Timeout Saved!"));
+    TEST_ASSERT_EQUAL(23, stored_timeout);
+    run_ms(1600);
+    TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+
+    /* '#' cancels without a command */
+    commands = 0;
+    press('C');
+    run_ms(600);
+    press('#');
+    TEST_ASSERT(shows(0, "Cancelled"));
+    run_ms(1100);
+    TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+    TEST_ASSERT_EQUAL(0, commands);
+
+    TEST_PASS();
+}
+
+static TestResult test_dead_link(void)
+{
+    TEST_ASSERT(boot_and_signup());
+    link_dead = 1;
+
+    press('A');
+    type("12345");
+    TEST_ASSERT(run_until_shows(0, "Comm Error!", DEAD_LINK_MS));
+    run_ms(1600);
+    TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+    TEST_ASSERT_EQUAL(LED_OFF, led_color);
+
+    TEST_PASS();
+}
+
+static TestResult test_relink_keeps_ui_live(void)
+{
+    Scheduler_Stats_t st;
+
+    TEST_ASSERT(boot_and_signup());
+    link_dead = 1;
+    key_scan_gap = 0;
+
+    /* The second failure in a row resets the link; the HELLO that follows
+     * retries from the UART task while keys and timers keep running */
+    for (int i = 0; i < 2; i++)
+    {
+        press('A');
+        type("12345");
+        TEST_ASSERT(run_until_shows(0, "Comm Error!", DEAD_LINK_MS));
+        run_ms(1600);
+        TEST_ASSERT_EQUAL(STATE_MAIN_MENU, Frontend_GetState());
+    }
+    TEST_ASSERT_EQUAL(1, reinit_count);
+    TEST_ASSERT(key_scan_gap <= KEY_POLL_MS + 1);
+    Scheduler_GetStats(&st);
+    TEST_ASSERT(st.maxLatencyMs <= KEY_POLL_MS + 1);
+
+    /* Back up: the next sign-in goes through */
+    link_dead = 0;
+    press('A');
+    type("12345");
+    run_ms(200);
+    TEST_ASSERT(shows(0, "Door Open"));
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static uint64_t host_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_session(void)
+{
+    enum { ROUNDS = 50 };
+    /* ' ' = no key for 500 ms (prompt gaps and settle times drop keys) */
+    static const char *script[] = {"A12345", "C D12345", "C #", "*12345 12345 12345", "A99999"};
+    uint64_t ns_total = 0, ns_max = 0;
+    uint32_t events = 0;
+    uint32_t lat_sum = 0, lat_max = 0, lat_n = 0;
+    Scheduler_Stats_t st;
+
+    if (!boot_and_signup()) return;
+    backend_ms = 40;
+    stored_timeout = 5;
+    uint32_t t0 = SysTick_GetMs();
+
+    for (uint32_t r = 0; r < ROUNDS; r++)
+    {
+        const char *s = script[r % 5];
+        for (; *s; s++)
+        {
+            if (*s == ' ')
+            {
+                run_ms(500);
+                continue;
+            }
+
+            uint32_t at = SysTick_GetMs();
+            uint32_t writes = lcd_writes;
+
+            queue_key(*s, KEYPAD_EVENT_PRESS, at);
+            queue_key(*s, KEYPAD_EVENT_RELEASE, at + KEY_TAP_MS);
+
+            uint32_t end = SysTick_GetMs() + KEY_GAP_MS;
+            while (SysTick_GetMs() < end)
+            {
+                uint64_t h0 = host_ns();
+                bool dispatched = Scheduler_RunOnce();
+                uint64_t h1 = host_ns();
+                if (dispatched)
+                {
+                    events++;
+                    ns_total += h1 - h0;
+                    if (h1 - h0 > ns_max) ns_max = h1 - h0;
+                }
+                if (writes != 0 && lcd_writes != writes)
+                {
+                    /* First screen reaction to this key */
+                    uint32_t lat = lcd_last_write - at;
+                    lat_sum += lat;
+                    if (lat > lat_max) lat_max = lat;
+                    lat_n++;
+                    writes = 0;
+                }
+            }
+        }
+        /* Let door/lockout/message sequences finish */
+        run_ms(2000);
+        while (Frontend_GetState() != STATE_MAIN_MENU) run_ms(100);
+    }
+
+    Scheduler_GetStats(&st);
+    printf("    %u events: handling %.2f us mean, %.2f us max (host); "
+           "queue depth max %u, post->dispatch max %u ms\n",
+           events, events ? ns_total / 1000.0 / events : 0.0, ns_max / 1000.0,
+           st.maxQueued, st.maxLatencyMs);
+    printf("    key -> screen: mean %.1f ms, max %u ms over %u keys (scan every %u ms), "
+           "%.0f s virtual\n",
+           lat_n ? (double)lat_sum / lat_n : 0.0, lat_max, lat_n, KEY_POLL_MS,
+           (SysTick_GetMs() - t0) / 1000.0);
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Frontend State Machine Tests ---\n");
+    run_test("Boot To Signup", test_boot_to_signup);
+    run_test("Entry Backspace And Cancel", test_entry_backspace_and_cancel);
+    run_test("Signin Opens Door", test_signin_opens_door);
+    run_test("UI Alive During Round Trip", test_ui_alive_during_round_trip);
+    run_test("Wrong Passwords Lock Out", test_wrong_passwords_lock_out);
+    run_test("Change Password", test_change_password);
+    run_test("Set Timeout", test_set_timeout);
+    run_test("Dead Link", test_dead_link);
+    run_test("Relink Keeps UI Live", test_relink_keeps_ui_live);
+
+    printf("\n--- Scripted Session (virtual time) ---\n");
+    bench_session();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
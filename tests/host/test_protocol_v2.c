@@ -0,0 +1,1261 @@
+/*
+ * test_protocol_v2.c - Host tests for UART protocol v2 (CRC-16, sequence
+ * numbers, sliding window) between frontend and backend
+ *
+ * Links the real frontend protocol (frontend/application/uart_protocol.c)
+ * and the real backend protocol (backend/application/uart_protocol.c)
+ * through a simulated 115200 baud wire with a virtual microsecond clock.
+ * The wire can drop or corrupt bytes, delay the backend, service requests
+ * out of order, or emulate a v1-only backend.
+ *
+ * Checks version negotiation and v1 fallback, CRC rejection, exactly-once
+ * execution of retransmitted requests, out-of-order matching, a lossy
+ * stress run, the RTT-derived response deadline and its PIN-hash
+ * allowance, and the non-blocking submit/poll API (completion order,
+ * callbacks, timeouts, relink without blocking, command handles). Ends
+ * with a command throughput comparison.
+ *
+ * Add -DUART_FRAMING_COBS=1 to run the same tests over COBS framing (the
+ * v1 fallback cases are skipped, COBS builds are v2 only).
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I frontend/application tests/host/test_protocol_v2.c \
+ *       tests/test_common.c frontend/application/uart_protocol.c \
+ *       frontend/application/uart_commands.c frontend/application/crc16.c \
+ *       backend/application/uart_protocol.c \
+ *       -o test_protocol_v2
+ *   ./test_protocol_v2
+ */
+
+#include "../test_common.h"
+#include "uart_protocol.h"
+#include "uart_commands.h"
+#include "crc16.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Backend protocol entry points (its header shares the frontend's guard) */
+void UART_Protocol_SendResponse(uint8_t cmd, uint8_t status, uint8_t *data, uint8_t data_len);
+void UART_Protocol_HandlePacket(uint8_t *buf, uint8_t len);
+uint16_t UART_Protocol_CurrentRequest(void);
+void UART_Protocol_SendResponseTo(uint16_t req, uint8_t cmd, uint8_t status,
+                                  uint8_t *data, uint8_t data_len);
+
+#define BYTE_US         87      /* 10 bits at 115200 baud */
+#define POLL_US         1       /* One RX status poll */
+#define BACKEND_US      300     /* Backend handling time per request */
+#define MAX_IDS         4096
+
+/*===========================================================================
+ * Simulated Wire
+ *===========================================================================*/
+static uint64_t now_us = 0;
+
+/* Frontend -> backend: parsed into frames as the bytes arrive */
+#define BK_QUEUE 8
+static struct { uint8_t len; uint8_t body[32]; uint64_t ready; } bk_queue[BK_QUEUE];
+static uint8_t bk_count = 0;
+static uint8_t bk_state = 0, bk_len = 0, bk_pos = 0, bk_body[32];
+
+/* Backend -> frontend: bytes with arrival times */
+#define FE_RX_SIZE 4096
+static uint8_t  fe_rx[FE_RX_SIZE];
+static uint64_t fe_rx_time[FE_RX_SIZE];
+static uint32_t fe_rx_head = 0, fe_rx_tail = 0;
+static uint64_t line_free = 0;
+
+/* Fault injection */
+static uint32_t drop_per_10k = 0;       /* Per byte, both directions */
+static uint32_t flip_per_10k = 0;
+static int v1_backend = 0;
+static uint32_t corrupt_requests = 0;   /* Whole frames to damage */
+static uint32_t drop_responses = 0;     /* Whole frames to lose */
+static int lifo_backend = 0;            /* Serve newest request first */
+static int defer_backend = 0;           /* Hold responses, send in reverse */
+static int hold_backend = 0;            /* Hold responses until released */
+static uint64_t backend_us = BACKEND_US;
+static uint64_t hash_us = 0;            /* PIN hash time, backend serialized */
+static uint64_t bk_busy_until = 0;
+
+static int fault(uint32_t per_10k)
+{
+    return per_10k != 0 && (uint32_t)(rand() % 10000) < per_10k;
+}
+
+static uint8_t corrupt(uint8_t b)
+{
+    return fault(flip_per_10k) ? (uint8_t)(b ^ (1u << (rand() % 8))) : b;
+}
+
+static void backend_frame(void)
+{
+    if (corrupt_requests > 0)
+    {
+        corrupt_requests--;
+        bk_body[bk_len - 1] ^= 0x01;
+    }
+    if (bk_count < BK_QUEUE)
+    {
+        uint8_t cmd = (bk_body[0] == UART_V2_MARKER) ? bk_body[2] : bk_body[0];
+        bk_queue[bk_count].len = bk_len;
+        memcpy(bk_queue[bk_count].body, bk_body, bk_len);
+        bk_queue[bk_count].ready = now_us + backend_us;
+        if (hash_us != 0)
+        {
+            /* One main loop: requests wait for the hash ahead of them */
+            uint64_t start = (bk_busy_until > now_us) ? bk_busy_until : now_us;
+            bool hashed = cmd == CMD_INIT_PASSWORD || cmd == CMD_AUTH ||
+                          cmd == CMD_CHANGE_PASSWORD;
+            bk_queue[bk_count].ready = start + backend_us + (hashed ? hash_us : 0);
+            bk_busy_until = bk_queue[bk_count].ready;
+        }
+        bk_count++;
+    }
+}
+
+/* Backend RX state machine (same rules as UART1IntHandler) */
+#if UART_FRAMING_COBS
+static uint8_t bk_block = 0, bk_zero = 0;
+
+static void backend_rx(uint8_t b)
+{
+    if (b == 0x00)
+    {
+        if (bk_state == 0 && bk_pos > 0)
+        {
+            bk_len = bk_pos;
+            backend_frame();
+        }
+        bk_state = 0;
+        bk_pos = 0;
+        bk_zero = 0;
+        return;
+    }
+    switch (bk_state)
+    {
+        case 0:
+            if (bk_zero)
+            {
+                if (bk_pos >= 32) { bk_state = 2; break; }
+                bk_body[bk_pos++] = 0x00;
+            }
+            bk_block = (uint8_t)(b - 1);
+            bk_zero = (b != 0xFF);
+            bk_state = bk_block ? 1 : 0;
+            break;
+        case 1:
+            if (bk_pos >= 32) { bk_state = 2; break; }
+            bk_body[bk_pos++] = b;
+            if (--bk_block == 0) bk_state = 0;
+            break;
+        default:
+            break;
+    }
+}
+#else
+static void backend_rx(uint8_t b)
+{
+    switch (bk_state)
+    {
+        case 0:
+            if (b == SOF_REQUEST) bk_state = 1;
+            break;
+        case 1:
+            if (b >= 1 && b <= 32) { bk_len = b; bk_pos = 0; bk_state = 2; }
+            else bk_state = 0;
+            break;
+        default:
+            bk_body[bk_pos++] = b;
+            if (bk_pos == bk_len)
+            {
+                bk_state = 0;
+                backend_frame();
+            }
+            break;
+    }
+}
+#endif
+
+/* Backend TX: bytes leave back to back once the line is free */
+static void wire_send(const uint8_t *data, uint8_t len)
+{
+    uint64_t t = (line_free > now_us) ? line_free : now_us;
+
+    if (drop_responses > 0)
+    {
+        drop_responses--;
+        return;
+    }
+
+    for (uint8_t i = 0; i < len; i++)
+    {
+        t += BYTE_US;
+        if (fault(drop_per_10k)) continue;
+        fe_rx[fe_rx_head % FE_RX_SIZE] = corrupt(data[i]);
+        fe_rx_time[fe_rx_head % FE_RX_SIZE] = t;
+        fe_rx_head++;
+    }
+    line_free = t;
+}
+
+static uint32_t bk_responses = 0;
+
+/* Backend UART_Driver_SendFrame with the same framing as backend/MCAL/uart.c */
+void UART_Driver_SendFrame(const uint8_t *body, uint8_t len)
+{
+    uint8_t frame[40];
+    uint8_t n = 0;
+
+    bk_responses++;
+#if UART_FRAMING_COBS
+    uint8_t code_at = n++;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (body[i] == 0x00)
+        {
+            frame[code_at] = (uint8_t)(n - code_at);
+            code_at = n++;
+        }
+        else
+        {
+            frame[n++] = body[i];
+        }
+    }
+    frame[code_at] = (uint8_t)(n - code_at);
+    frame[n++] = 0x00;
+#else
+    frame[n++] = SOF_RESPONSE;
+    frame[n++] = len;
+    memcpy(&frame[n], body, len);
+    n += len;
+#endif
+    wire_send(frame, n);
+}
+
+static void echo_handler(uint8_t *buf, uint8_t len);
+
+/* Run any backend work that is due by now */
+static void backend_service(void)
+{
+    while (bk_count > 0)
+    {
+        uint8_t idx = lifo_backend ? (uint8_t)(bk_count - 1) : 0;
+        if (bk_queue[idx].ready > now_us) return;
+
+        uint8_t len = bk_queue[idx].len;
+        uint8_t body[32];
+        memcpy(body, bk_queue[idx].body, len);
+        memmove(&bk_queue[idx], &bk_queue[idx + 1], (bk_count - idx - 1) * sizeof(bk_queue[0]));
+        bk_count--;
+
+        if (v1_backend && body[0] == UART_V2_MARKER)
+        {
+            /* What a v1 backend does with the marker: unknown command */
+            const uint8_t rsp[] = {UART_V2_MARKER, STATUS_ERROR};
+            UART_Driver_SendFrame(rsp, sizeof(rsp));
+        }
+        else if (v1_backend)
+        {
+            /* v1 dispatch straight to the handler (answered in v1 framing) */
+            echo_handler(body, len);
+        }
+        else
+        {
+            UART_Protocol_HandlePacket(body, len);
+        }
+    }
+}
+
+/*===========================================================================
+ * Frontend MCAL fakes (frontend/MCAL/uart.h, systick.h)
+ *===========================================================================*/
+static uint32_t reinit_count = 0;
+
+void UART_Driver_Init(void) {}
+void UART_Driver_Reinit(void) { reinit_count++; }
+void UART_Driver_WaitTxComplete(void) {}
+
+void DelayMs(uint32_t ms)
+{
+    now_us += (uint64_t)ms * 1000;
+    backend_service();
+}
+
+void UART_Driver_FlushRx(void)
+{
+    backend_service();
+    while (fe_rx_tail != fe_rx_head && fe_rx_time[fe_rx_tail % FE_RX_SIZE] <= now_us)
+    {
+        fe_rx_tail++;
+    }
+}
+
+uint8_t UART_Driver_SendByte(uint8_t data)
+{
+    now_us += BYTE_US;
+    if (!fault(drop_per_10k))
+    {
+        backend_rx(corrupt(data));
+    }
+    backend_service();
+    return 1;
+}
+
+uint8_t UART_Driver_TryReceiveByte(uint8_t *data)
+{
+    now_us += POLL_US;
+    backend_service();
+    if (fe_rx_tail != fe_rx_head && fe_rx_time[fe_rx_tail % FE_RX_SIZE] <= now_us)
+    {
+        *data = fe_rx[fe_rx_tail % FE_RX_SIZE];
+        fe_rx_tail++;
+        return 1;
+    }
+    return 0;
+}
+
+uint32_t SysTick_GetMs(void)
+{
+    return (uint32_t)(now_us / 1000);
+}
+
+/* Sleep: jump straight to the next byte arrival, backend event or deadline */
+uint8_t UART_Driver_WaitRx(uint32_t deadlineMs)
+{
+    uint64_t deadline = (uint64_t)deadlineMs * 1000;
+
+    for (;;)
+    {
+        backend_service();
+        if (fe_rx_tail != fe_rx_head && fe_rx_time[fe_rx_tail % FE_RX_SIZE] <= now_us)
+        {
+            return 1;
+        }
+        if (now_us >= deadline)
+        {
+            return 0;
+        }
+
+        uint64_t next = deadline;
+        if (fe_rx_tail != fe_rx_head && fe_rx_time[fe_rx_tail % FE_RX_SIZE] < next)
+        {
+            next = fe_rx_time[fe_rx_tail % FE_RX_SIZE];
+        }
+        for (uint8_t i = 0; i < bk_count; i++)
+        {
+            if (bk_queue[i].ready < next) next = bk_queue[i].ready;
+        }
+        now_us = (next > now_us) ? next : now_us + 1;
+    }
+}
+
+uint8_t UART_Driver_ReceiveByteUntil(uint8_t *data, uint32_t deadlineMs)
+{
+    return UART_Driver_WaitRx(deadlineMs) && UART_Driver_TryReceiveByte(data);
+}
+
+/*===========================================================================
+ * Backend stand-ins (status LED, command handlers)
+ *===========================================================================*/
+void LED_GreenOn(void) {}
+void LED_BlinkGreen(uint8_t times) { (void)times; }
+void LED_BlinkRed(uint8_t times) { (void)times; }
+bool LED_IsPatternActive(void) { return false; }
+
+/* Executions per request id (payload [id_hi][id_lo]) */
+static uint16_t exec_count[MAX_IDS];
+
+/* Responses held back by defer_backend, as a durable-mode write would */
+typedef struct {
+    uint16_t req;
+    uint8_t cmd;
+    uint8_t rsp[3];
+} deferred_t;
+
+static deferred_t deferred[UART_WINDOW_SIZE];
+static uint8_t deferred_count = 0;
+
+static void echo_handler(uint8_t *buf, uint8_t len)
+{
+    if (len < 3)
+    {
+        UART_Protocol_SendResponse(buf[0], STATUS_ERROR, NULL, 0);
+        return;
+    }
+    uint16_t id = (uint16_t)((buf[1] << 8) | buf[2]);
+    exec_count[id % MAX_IDS]++;
+    uint8_t rsp[3] = {buf[1], buf[2], (uint8_t)(buf[0] ^ buf[1] ^ buf[2])};
+    if (!defer_backend && !hold_backend)
+    {
+        UART_Protocol_SendResponse(buf[0], STATUS_OK, rsp, sizeof(rsp));
+        return;
+    }
+
+    /* Once the window is full, answer all of it newest first from inside
+     * this handler, so each response needs its own request's SEQ */
+    deferred_t *d = &deferred[deferred_count++];
+    d->req = UART_Protocol_CurrentRequest();
+    d->cmd = buf[0];
+    memcpy(d->rsp, rsp, sizeof(rsp));
+    if (defer_backend && deferred_count == UART_WINDOW_SIZE)
+    {
+        while (deferred_count > 0)
+        {
+            d = &deferred[--deferred_count];
+            UART_Protocol_SendResponseTo(d->req, d->cmd, STATUS_OK, d->rsp, sizeof(d->rsp));
+        }
+    }
+}
+
+void CMD_InitPassword(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_Auth(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_SetTimeout(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_ChangePassword(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_GetTimeout(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_SetClock(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_AddUser(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_RemoveUser(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_ListUsers(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+void CMD_CommitMode(uint8_t *buf, uint8_t len) { echo_handler(buf, len); }
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+static void reset_world(void)
+{
+    now_us = 0;
+    line_free = 0;
+    bk_count = 0;
+    bk_state = 0;
+    bk_pos = 0;
+    fe_rx_head = fe_rx_tail = 0;
+    drop_per_10k = 0;
+    flip_per_10k = 0;
+    v1_backend = 0;
+    lifo_backend = 0;
+    defer_backend = 0;
+    hold_backend = 0;
+    deferred_count = 0;
+    backend_us = BACKEND_US;
+    hash_us = 0;
+    bk_busy_until = 0;
+    corrupt_requests = 0;
+    drop_responses = 0;
+    reinit_count = 0;
+    memset(exec_count, 0, sizeof(exec_count));
+    srand(2024);
+    UART_Protocol_Init();
+}
+
+typedef struct {
+    uint8_t payload[2];
+    uint8_t out[16];
+} req_buf_t;
+
+static void make_req(UART_Request_t *r, req_buf_t *b, uint16_t id)
+{
+    static const uint8_t cmds[] = {CMD_INIT_PASSWORD, CMD_AUTH, CMD_SET_TIMEOUT,
+                                   CMD_CHANGE_PASSWORD, CMD_GET_TIMEOUT};
+    b->payload[0] = (uint8_t)(id >> 8);
+    b->payload[1] = (uint8_t)id;
+    r->cmd = cmds[id % sizeof(cmds)];
+    r->payload = b->payload;
+    r->payloadLen = 2;
+    r->outData = b->out;
+    r->outDataLen = 0;
+    r->status = 0xEE;
+    r->onDone = NULL;
+}
+
+/* Completion log for submitted requests */
+static UART_Request_t *done_order[64];
+static uint32_t done_count = 0;
+
+static void record_done(UART_Request_t *req)
+{
+    if (done_count < 64) done_order[done_count] = req;
+    done_count++;
+}
+
+/* Poll until every submitted request has completed (bounded) */
+static int poll_until_idle(uint32_t maxPolls)
+{
+    uint32_t polls = 0;
+
+    while (!UART_Protocol_IsIdle())
+    {
+        if (++polls > maxPolls) return 0;
+        UART_Protocol_Poll(10);
+    }
+    return 1;
+}
+
+/* Response must be the echo of this exact request */
+static int req_ok(const UART_Request_t *r)
+{
+    return r->status == STATUS_OK && r->outDataLen == 3 &&
+           r->outData[0] == r->payload[0] && r->outData[1] == r->payload[1] &&
+           r->outData[2] == (uint8_t)(r->cmd ^ r->payload[0] ^ r->payload[1]);
+}
+
+static uint8_t send_one(uint16_t id, uint8_t *out, uint8_t *outLen)
+{
+    uint8_t payload[2] = {(uint8_t)(id >> 8), (uint8_t)id};
+    return UART_Protocol_SendCommand(CMD_SET_TIMEOUT, payload, 2, out, outLen);
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_negotiates_v2(void)
+{
+    uint8_t out[16], outLen = 0;
+
+    reset_world();
+    TEST_ASSERT_EQUAL(2, UART_Protocol_GetVersion());
+
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(7, out, &outLen));
+    TEST_ASSERT_EQUAL(3, outLen);
+    TEST_ASSERT_EQUAL(7, out[1]);
+    TEST_ASSERT_EQUAL(1, exec_count[7]);
+
+    TEST_PASS();
+}
+
+#if !UART_FRAMING_COBS
+static TestResult test_falls_back_to_v1(void)
+{
+    uint8_t out[16], outLen = 0;
+
+    now_us = 0;
+    v1_backend = 1;
+    UART_Protocol_Init();
+    TEST_ASSERT_EQUAL(1, UART_Protocol_GetVersion());
+    /* Fallback is decided by the v1 reply, not by waiting out a timeout */
+    TEST_ASSERT(now_us < 10000);
+
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(9, out, &outLen));
+    TEST_ASSERT_EQUAL(3, outLen);
+    TEST_ASSERT_EQUAL(9, out[1]);
+
+    v1_backend = 0;
+    TEST_PASS();
+}
+#endif
+
+static TestResult test_corrupt_request_retried(void)
+{
+    uint8_t out[16], outLen = 0;
+
+    reset_world();
+    corrupt_requests = 1;
+
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(21, out, &outLen));
+    TEST_ASSERT_EQUAL(21, out[1]);
+    TEST_ASSERT_EQUAL(1, exec_count[21]);
+    TEST_ASSERT_EQUAL(0, corrupt_requests);
+
+    TEST_PASS();
+}
+
+static TestResult test_lost_response_not_reexecuted(void)
+{
+    uint8_t out[16], outLen = 0;
+
+    reset_world();
+    drop_responses = 2;
+
+    /* Third attempt gets the cached reply; the command ran only once */
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(34, out, &outLen));
+    TEST_ASSERT_EQUAL(34, out[1]);
+    TEST_ASSERT_EQUAL(1, exec_count[34]);
+    TEST_ASSERT_EQUAL(0, drop_responses);
+
+    /* A v2 hello (frontend restart) clears the cache */
+    UART_Protocol_Init();
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(35, out, &outLen));
+    TEST_ASSERT_EQUAL(1, exec_count[35]);
+
+    TEST_PASS();
+}
+
+/* v2 request as it reaches UART_Protocol_HandlePacket */
+static uint8_t v2_frame(uint8_t *frame, uint8_t seq, uint8_t cmd, uint16_t id)
+{
+    uint8_t len = 7;
+    uint16_t crc;
+
+    frame[0] = UART_V2_MARKER;
+    frame[1] = seq;
+    frame[2] = cmd;
+    frame[3] = (uint8_t)(id >> 8);
+    frame[4] = (uint8_t)id;
+    crc = CRC16_Update(CRC16_INIT, &len, 1);
+    crc = CRC16_Update(crc, frame, 5);
+    frame[5] = (uint8_t)(crc >> 8);
+    frame[6] = (uint8_t)crc;
+    return len;
+}
+
+static TestResult test_retransmit_while_response_held(void)
+{
+    uint8_t frame[7];
+    uint8_t len;
+    uint32_t sent;
+
+    reset_world();
+    hold_backend = 1;
+    len = v2_frame(frame, 0x42, CMD_SET_TIMEOUT, 36);
+
+    /* Response held (a durable-mode write): retransmissions are dropped,
+     * not run again */
+    sent = bk_responses;
+    UART_Protocol_HandlePacket(frame, len);
+    UART_Protocol_HandlePacket(frame, len);
+    UART_Protocol_HandlePacket(frame, len);
+    TEST_ASSERT_EQUAL(1, exec_count[36]);
+    TEST_ASSERT_EQUAL(sent, bk_responses);
+
+    /* Answered once when released, then replayed from the cache */
+    UART_Protocol_SendResponseTo(deferred[0].req, deferred[0].cmd, STATUS_OK,
+                                 deferred[0].rsp, sizeof(deferred[0].rsp));
+    TEST_ASSERT_EQUAL(sent + 1, bk_responses);
+    UART_Protocol_HandlePacket(frame, len);
+    TEST_ASSERT_EQUAL(sent + 2, bk_responses);
+    TEST_ASSERT_EQUAL(1, exec_count[36]);
+
+    TEST_PASS();
+}
+
+static TestResult test_pipelined_out_of_order(void)
+{
+    UART_Request_t r[UART_WINDOW_SIZE];
+    req_buf_t b[UART_WINDOW_SIZE];
+
+    reset_world();
+    lifo_backend = 1;
+    for (uint16_t i = 0; i < UART_WINDOW_SIZE; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(100 + i));
+    }
+    UART_Protocol_SendPipelined(r, UART_WINDOW_SIZE);
+
+    for (uint16_t i = 0; i < UART_WINDOW_SIZE; i++)
+    {
+        TEST_ASSERT(req_ok(&r[i]));
+        TEST_ASSERT_EQUAL(1, exec_count[100 + i]);
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_deferred_responses_matched(void)
+{
+    UART_Request_t r[UART_WINDOW_SIZE];
+    req_buf_t b[UART_WINDOW_SIZE];
+
+    reset_world();
+    defer_backend = 1;
+    for (uint16_t i = 0; i < UART_WINDOW_SIZE; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(150 + i));
+    }
+    UART_Protocol_SendPipelined(r, UART_WINDOW_SIZE);
+
+    for (uint16_t i = 0; i < UART_WINDOW_SIZE; i++)
+    {
+        TEST_ASSERT(req_ok(&r[i]));
+        TEST_ASSERT_EQUAL(1, exec_count[150 + i]);
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_lossy_stress(void)
+{
+    enum { N = 2000, BATCH = 8 };
+    UART_Request_t r[BATCH];
+    req_buf_t b[BATCH];
+    uint32_t lost = 0, wrong = 0, twice = 0;
+
+    reset_world();
+    drop_per_10k = 20;          /* 0.2% of bytes lost */
+    flip_per_10k = 20;          /* 0.2% of bytes with a bit error */
+
+    for (uint16_t base = 1; base <= N; base += BATCH)
+    {
+        for (uint16_t i = 0; i < BATCH; i++)
+        {
+            make_req(&r[i], &b[i], (uint16_t)(base + i));
+        }
+        UART_Protocol_SendPipelined(r, BATCH);
+        for (uint16_t i = 0; i < BATCH; i++)
+        {
+            if (r[i].status == STATUS_UNKNOWN_CMD) lost++;
+            else if (!req_ok(&r[i])) wrong++;
+        }
+    }
+    for (uint32_t id = 1; id <= N; id++)
+    {
+        if (exec_count[id] > 1) twice++;
+    }
+
+    printf("    %u requests at 0.2%% drop + 0.2%% bit flips: %u lost, "
+           "%u wrong, %u executed twice, %.1f ms virtual\n",
+           N, lost, wrong, twice, now_us / 1000.0);
+
+    /* CRC + SEQ: never a wrong answer, never a double execution */
+    TEST_ASSERT_EQUAL(0, wrong);
+    TEST_ASSERT_EQUAL(0, twice);
+    TEST_ASSERT(lost < N / 100);
+
+    TEST_PASS();
+}
+
+static TestResult test_rtt_estimate(void)
+{
+    uint8_t out[16], outLen = 0;
+    UART_LinkStats_t st;
+
+    reset_world();
+    for (uint16_t i = 0; i < 50; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, send_one(i, out, &outLen));
+    }
+
+    /* ~2 ms round trips: the deadline settles at the 20 ms floor */
+    UART_Protocol_GetLinkStats(&st);
+    TEST_ASSERT(st.samples >= 50);
+    TEST_ASSERT(st.srttMs >= 1 && st.srttMs <= 4);
+    TEST_ASSERT_EQUAL(20, st.rtoMs);
+    TEST_ASSERT_EQUAL(0, st.retries);
+    TEST_ASSERT_EQUAL(0, st.timeouts);
+
+    TEST_PASS();
+}
+
+static TestResult test_loss_recovered_within_rto(void)
+{
+    uint8_t out[16], outLen = 0;
+    UART_LinkStats_t st;
+    uint64_t t0;
+
+    reset_world();
+    for (uint16_t i = 0; i < 20; i++) send_one(i, out, &outLen);
+
+    /* One lost response costs one RTO (20 ms), not the old fixed 200 ms */
+    drop_responses = 1;
+    t0 = now_us;
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(40, out, &outLen));
+    TEST_ASSERT(now_us - t0 < 40000);
+    TEST_ASSERT_EQUAL(1, exec_count[40]);
+
+    UART_Protocol_GetLinkStats(&st);
+    TEST_ASSERT_EQUAL(1, st.retries);
+    TEST_ASSERT_EQUAL(1, st.timeouts);
+
+    TEST_PASS();
+}
+
+static TestResult test_adapts_to_slower_backend(void)
+{
+    uint8_t out[16], outLen = 0;
+    UART_LinkStats_t st;
+    uint32_t retries;
+
+    reset_world();
+    for (uint16_t i = 0; i < 20; i++) send_one(i, out, &outLen);
+
+    /* Backend suddenly needs 60 ms: the first commands time out and back
+     * off, then the estimate follows and retries stop */
+    backend_us = 60000;
+    for (uint16_t i = 100; i < 110; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, send_one(i, out, &outLen));
+        TEST_ASSERT_EQUAL(1, exec_count[i]);
+    }
+    UART_Protocol_GetLinkStats(&st);
+    retries = st.retries;
+    TEST_ASSERT(retries > 0);
+    TEST_ASSERT(st.rtoMs >= 60);
+
+    for (uint16_t i = 110; i < 130; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, send_one(i, out, &outLen));
+    }
+    UART_Protocol_GetLinkStats(&st);
+    TEST_ASSERT_EQUAL(retries, st.retries);
+
+    TEST_PASS();
+}
+
+static uint8_t send_auth(uint16_t id)
+{
+    uint8_t payload[2] = {(uint8_t)(id >> 8), (uint8_t)id};
+    uint8_t out[16], outLen = 0;
+    return UART_Protocol_SendCommand(CMD_AUTH, payload, 2, out, &outLen);
+}
+
+static TestResult test_pin_hash_commands_wait(void)
+{
+    static const uint32_t hash_ms[] = {100, 150, 200, 250};
+    uint8_t out[16], outLen = 0;
+    UART_Request_t r[UART_WINDOW_SIZE];
+    req_buf_t b[UART_WINDOW_SIZE];
+    UART_LinkStats_t st;
+
+    reset_world();
+    for (uint16_t i = 0; i < 20; i++) send_one(i, out, &outLen);
+    UART_Protocol_GetLinkStats(&st);
+    TEST_ASSERT_EQUAL(20, st.rtoMs);
+
+    /* A backend hashing for 100-250 ms, well past the 20 ms RTO: AUTH is
+     * answered on the first try and fast commands keep their deadline */
+    for (uint8_t h = 0; h < 4; h++)
+    {
+        hash_us = hash_ms[h] * 1000;
+        for (uint16_t i = 0; i < 3; i++)
+        {
+            uint16_t id = (uint16_t)(200 + h * 10 + i);
+            TEST_ASSERT_EQUAL(STATUS_OK, send_auth(id));
+            TEST_ASSERT_EQUAL(1, exec_count[id]);
+            TEST_ASSERT_EQUAL(STATUS_OK, send_one((uint16_t)(id + 100), out, &outLen));
+        }
+    }
+
+    /* Fast commands queued behind two hashes in one window */
+    for (uint16_t i = 0; i < UART_WINDOW_SIZE; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(400 + i));
+        r[i].cmd = (i % 2) ? CMD_AUTH : CMD_SET_TIMEOUT;
+    }
+    UART_Protocol_SendPipelined(r, UART_WINDOW_SIZE);
+    for (uint16_t i = 0; i < UART_WINDOW_SIZE; i++)
+    {
+        TEST_ASSERT(req_ok(&r[i]));
+        TEST_ASSERT_EQUAL(1, exec_count[400 + i]);
+    }
+
+    UART_Protocol_GetLinkStats(&st);
+    TEST_ASSERT_EQUAL(0, st.retries);
+    TEST_ASSERT_EQUAL(0, st.timeouts);
+    TEST_ASSERT_EQUAL(20, st.rtoMs);
+
+    TEST_PASS();
+}
+
+#if !UART_FRAMING_COBS
+static TestResult test_v1_pin_hash_not_rerun(void)
+{
+    uint8_t out[16], outLen = 0;
+    UART_LinkStats_t st;
+
+    reset_world();
+    v1_backend = 1;
+    UART_Protocol_Init();
+    for (uint16_t i = 0; i < 20; i++) send_one(i, out, &outLen);
+
+    /* v1 has no response cache: a resend would hash and run again */
+    hash_us = 250000;
+    for (uint16_t i = 500; i < 505; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, send_auth(i));
+        TEST_ASSERT_EQUAL(1, exec_count[i]);
+    }
+    UART_Protocol_GetLinkStats(&st);
+    TEST_ASSERT_EQUAL(0, st.retries);
+
+    v1_backend = 0;
+    TEST_PASS();
+}
+
+static TestResult test_v1_no_fixed_delay(void)
+{
+    uint8_t out[16], outLen = 0;
+    uint64_t t0;
+
+    reset_world();
+    v1_backend = 1;
+    UART_Protocol_Init();
+
+    /* The reply is parsed as it arrives instead of after a 50 ms sleep */
+    t0 = now_us;
+    for (uint16_t i = 0; i < 20; i++)
+    {
+        TEST_ASSERT_EQUAL(STATUS_OK, send_one(i, out, &outLen));
+    }
+    TEST_ASSERT(now_us - t0 < 20 * 5000);
+
+    v1_backend = 0;
+    TEST_PASS();
+}
+#endif
+
+static TestResult test_submit_returns_at_once(void)
+{
+    UART_Request_t r[3];
+    req_buf_t b[3];
+    uint64_t t0;
+
+    reset_world();
+    t0 = now_us;
+    for (uint16_t i = 0; i < 3; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(200 + i));
+        UART_Protocol_Submit(&r[i]);
+        TEST_ASSERT_EQUAL(STATUS_PENDING, r[i].status);
+    }
+    /* Nothing goes on the wire until the caller polls */
+    TEST_ASSERT_EQUAL(t0, now_us);
+    TEST_ASSERT(!UART_Protocol_IsIdle());
+
+    /* A poll without waiting only does what is ready now */
+    UART_Protocol_Poll(0);
+    TEST_ASSERT(now_us - t0 < 10000);
+    TEST_ASSERT_EQUAL(STATUS_PENDING, r[2].status);
+
+    TEST_ASSERT(poll_until_idle(100));
+    for (uint16_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT(req_ok(&r[i]));
+        TEST_ASSERT_EQUAL(1, exec_count[200 + i]);
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_async_completion_order(void)
+{
+    enum { N = UART_WINDOW_SIZE };
+    UART_Request_t r[N];
+    req_buf_t b[N];
+
+    reset_world();
+    lifo_backend = 1;
+    backend_us = 5000;          /* All four queued before the first is served */
+    done_count = 0;
+    for (uint16_t i = 0; i < N; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(300 + i));
+        r[i].onDone = record_done;
+        UART_Protocol_Submit(&r[i]);
+    }
+    TEST_ASSERT(poll_until_idle(100));
+
+    /* Callbacks run as each reply lands: newest first from this backend */
+    TEST_ASSERT_EQUAL(N, done_count);
+    for (uint16_t i = 0; i < N; i++)
+    {
+        TEST_ASSERT(done_order[i] == &r[N - 1 - i]);
+        TEST_ASSERT(req_ok(&r[i]));
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_async_timeout(void)
+{
+    UART_Request_t r;
+    req_buf_t b;
+    uint64_t t0;
+
+    reset_world();
+    done_count = 0;
+    drop_per_10k = 10000;       /* Dead line */
+    make_req(&r, &b, 400);
+    r.onDone = record_done;
+    t0 = now_us;
+    UART_Protocol_Submit(&r);
+    TEST_ASSERT(poll_until_idle(1000));
+
+    /* Given up after the retries, reported once, within the backed-off
+     * deadlines (at most 3 x 8 x 500 ms plus jitter) */
+    TEST_ASSERT_EQUAL(STATUS_UNKNOWN_CMD, r.status);
+    TEST_ASSERT_EQUAL(1, done_count);
+    TEST_ASSERT(now_us - t0 < 15000000);
+
+    /* The link is re-established on the next poll once it is back */
+    drop_per_10k = 0;
+    make_req(&r, &b, 401);
+    UART_Protocol_Submit(&r);
+    TEST_ASSERT(poll_until_idle(1000));
+    TEST_ASSERT(req_ok(&r));
+
+    TEST_PASS();
+}
+
+/* Poll(0) once per virtual ms until two lost requests have set off a
+ * relink and its HELLO has given up too; returns the longest call */
+static uint64_t poll_through_relink(UART_Request_t *r, req_buf_t *b)
+{
+    uint64_t t0, worst = 0;
+
+    done_count = 0;
+    drop_per_10k = 10000;
+    for (uint16_t i = 0; i < 2; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(700 + i));
+        r[i].onDone = record_done;
+        UART_Protocol_Submit(&r[i]);
+    }
+    for (uint32_t ms = 0; ms < 30000; ms++)
+    {
+        t0 = now_us;
+        UART_Protocol_Poll(0);
+        if (now_us - t0 > worst) worst = now_us - t0;
+        if (done_count == 2 && reinit_count > 0 && UART_Protocol_IsIdle()) break;
+        DelayMs(1);
+    }
+    drop_per_10k = 0;
+    return worst;
+}
+
+static TestResult test_relink_never_blocks(void)
+{
+    UART_Request_t r[3];
+    req_buf_t b[3];
+
+    /* A relink queues the HELLO; no call waits for it */
+    reset_world();
+    TEST_ASSERT(poll_through_relink(r, b) < 3000);
+    TEST_ASSERT_EQUAL(2, done_count);
+    TEST_ASSERT_EQUAL(1, reinit_count);
+    TEST_ASSERT(UART_Protocol_IsIdle());
+    TEST_ASSERT_EQUAL(2, UART_Protocol_GetVersion());
+
+    make_req(&r[2], &b[2], 702);
+    UART_Protocol_Submit(&r[2]);
+    TEST_ASSERT(poll_until_idle(1000));
+    TEST_ASSERT(req_ok(&r[2]));
+
+#if !UART_FRAMING_COBS
+    /* v1 stop-and-wait runs from Poll the same way; no answer to the
+     * HELLO keeps v1 */
+    reset_world();
+    v1_backend = 1;
+    UART_Protocol_Init();
+    reinit_count = 0;
+    TEST_ASSERT(poll_through_relink(r, b) < 3000);
+    TEST_ASSERT_EQUAL(2, done_count);
+    TEST_ASSERT_EQUAL(1, reinit_count);
+    TEST_ASSERT_EQUAL(1, UART_Protocol_GetVersion());
+
+    make_req(&r[2], &b[2], 703);
+    UART_Protocol_Submit(&r[2]);
+    TEST_ASSERT(poll_until_idle(1000));
+    TEST_ASSERT(req_ok(&r[2]));
+    v1_backend = 0;
+#endif
+
+    TEST_PASS();
+}
+
+static void submit_next(UART_Request_t *req)
+{
+    static req_buf_t b;
+    static UART_Request_t next;
+
+    record_done(req);
+    if (req->payload[1] < 4)
+    {
+        make_req(&next, &b, (uint16_t)(req->payload[1] + 1));
+        next.onDone = submit_next;
+        UART_Protocol_Submit(&next);
+    }
+}
+
+static TestResult test_callback_submits_follow_up(void)
+{
+    static req_buf_t b;
+    static UART_Request_t r;
+
+    reset_world();
+    done_count = 0;
+    make_req(&r, &b, 0);
+    r.onDone = submit_next;
+    UART_Protocol_Submit(&r);
+    TEST_ASSERT(poll_until_idle(100));
+
+    TEST_ASSERT_EQUAL(5, done_count);
+    for (uint16_t id = 0; id < 5; id++)
+    {
+        TEST_ASSERT_EQUAL(1, exec_count[id]);
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_blocking_drains_submitted(void)
+{
+    UART_Request_t r[2];
+    req_buf_t b[2];
+    uint8_t out[16], outLen = 0;
+
+    reset_world();
+    done_count = 0;
+    for (uint16_t i = 0; i < 2; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(500 + i));
+        r[i].onDone = record_done;
+        UART_Protocol_Submit(&r[i]);
+    }
+
+    /* A blocking call shares the window with the submitted requests */
+    TEST_ASSERT_EQUAL(STATUS_OK, send_one(510, out, &outLen));
+    TEST_ASSERT_EQUAL(510, (out[0] << 8) | out[1]);
+    TEST_ASSERT(UART_Protocol_IsIdle());
+    TEST_ASSERT_EQUAL(2, done_count);
+    TEST_ASSERT(req_ok(&r[0]) && req_ok(&r[1]));
+
+    TEST_PASS();
+}
+
+static TestResult test_command_handle(void)
+{
+    static UART_Pending_t cmd;
+    uint32_t polls = 0;
+    uint8_t status;
+
+    reset_world();
+    backend_us = 5000;
+
+    /* The caller keeps running while the command is in flight */
+    UART_AuthenticateStart(&cmd, "12345", AUTH_MODE_OPEN_DOOR);
+    while ((status = UART_Poll(&cmd, 1)) == STATUS_PENDING)
+    {
+        polls++;
+        TEST_ASSERT(polls < 1000);
+    }
+    TEST_ASSERT_EQUAL(STATUS_OK, status);
+    TEST_ASSERT(polls >= 4);
+    /* Echo backend: first reply byte is the mode */
+    TEST_ASSERT_EQUAL(AUTH_MODE_OPEN_DOOR, UART_GetReplyTimeout(&cmd));
+
+    /* Restarting the handle reuses it; the blocking wrapper still works */
+    UART_SetTimeoutStart(&cmd, 99);
+    TEST_ASSERT_EQUAL(STATUS_PENDING, cmd.req.status);
+    TEST_ASSERT_EQUAL(30, cmd.payload[0]);
+    TEST_ASSERT_EQUAL(STATUS_OK, UART_ChangePassword("54321"));
+    /* Completed alongside (the echo backend rejects 1-byte payloads) */
+    TEST_ASSERT_EQUAL(STATUS_ERROR, UART_Poll(&cmd, 0));
+
+    TEST_PASS();
+}
+
+#if !UART_FRAMING_COBS
+static TestResult test_async_over_v1(void)
+{
+    UART_Request_t r[3];
+    req_buf_t b[3];
+
+    reset_world();
+    v1_backend = 1;
+    UART_Protocol_Init();
+    done_count = 0;
+
+    for (uint16_t i = 0; i < 3; i++)
+    {
+        make_req(&r[i], &b[i], (uint16_t)(600 + i));
+        r[i].onDone = record_done;
+        UART_Protocol_Submit(&r[i]);
+    }
+    TEST_ASSERT(poll_until_idle(100));
+    for (uint16_t i = 0; i < 3; i++)
+    {
+        TEST_ASSERT(done_order[i] == &r[i]);
+        TEST_ASSERT(req_ok(&r[i]));
+    }
+
+    v1_backend = 0;
+    TEST_PASS();
+}
+#endif
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static void bench_throughput(void)
+{
+    enum { N = 200 };
+    UART_Request_t r[N];
+    req_buf_t b[N];
+    uint8_t out[16], outLen;
+    double v1_ms = 0.0, v2_ms, pipe_ms;
+    uint64_t t0;
+    UART_LinkStats_t st;
+
+#if !UART_FRAMING_COBS
+    reset_world();
+    v1_backend = 1;
+    UART_Protocol_Init();
+    t0 = now_us;
+    for (uint16_t i = 0; i < N; i++) send_one(i, out, &outLen);
+    v1_ms = (now_us - t0) / 1000.0 / N;
+#endif
+
+    reset_world();
+    t0 = now_us;
+    for (uint16_t i = 0; i < N; i++) send_one(i, out, &outLen);
+    v2_ms = (now_us - t0) / 1000.0 / N;
+    UART_Protocol_GetLinkStats(&st);
+
+    reset_world();
+    for (uint16_t i = 0; i < N; i++) make_req(&r[i], &b[i], i);
+    t0 = now_us;
+    UART_Protocol_SendPipelined(r, N);
+    pipe_ms = (now_us - t0) / 1000.0 / N;
+
+    if (v1_ms > 0.0)
+    {
+        printf("    v1 stop-and-wait:     %7.3f ms/command\n", v1_ms);
+    }
+    printf("    v2 one at a time:     %7.3f ms/command (srtt %u ms, rttvar %u ms, "
+           "rto %u ms)\n", v2_ms, st.srttMs, st.rttVarMs, st.rtoMs);
+    printf("    v2 pipelined (win %u): %7.3f ms/command", UART_WINDOW_SIZE, pipe_ms);
+    if (v1_ms > 0.0)
+    {
+        printf(" (%.0fx v1)", v1_ms / pipe_ms);
+    }
+    printf("\n");
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- UART Protocol v2 Tests ---\n");
+    run_test("Negotiates v2", test_negotiates_v2);
+#if !UART_FRAMING_COBS
+    run_test("Falls Back To v1", test_falls_back_to_v1);
+#endif
+    run_test("Corrupt Request Retried", test_corrupt_request_retried);
+    run_test("Lost Response Not Re-executed", test_lost_response_not_reexecuted);
+    run_test("Retransmit While Response Held", test_retransmit_while_response_held);
+    run_test("Pipelined Out Of Order", test_pipelined_out_of_order);
+    run_test("Deferred Responses Matched", test_deferred_responses_matched);
+    run_test("Lossy Stress", test_lossy_stress);
+    run_test("RTT Estimate", test_rtt_estimate);
+    run_test("Loss Recovered Within RTO", test_loss_recovered_within_rto);
+    run_test("Adapts To Slower Backend", test_adapts_to_slower_backend);
+    run_test("PIN Hash Commands Wait", test_pin_hash_commands_wait);
+#if !UART_FRAMING_COBS
+    run_test("v1 No Fixed Delay", test_v1_no_fixed_delay);
+    run_test("v1 PIN Hash Not Rerun", test_v1_pin_hash_not_rerun);
+#endif
+    run_test("Submit Returns At Once", test_submit_returns_at_once);
+    run_test("Async Completion Order", test_async_completion_order);
+    run_test("Async Timeout", test_async_timeout);
+    run_test("Relink Never Blocks", test_relink_never_blocks);
+    run_test("Callback Submits Follow-up", test_callback_submits_follow_up);
+    run_test("Blocking Drains Submitted", test_blocking_drains_submitted);
+    run_test("Command Handle", test_command_handle);
+#if !UART_FRAMING_COBS
+    run_test("Async Over v1", test_async_over_v1);
+#endif
+
+    printf("\n--- Command Throughput (virtual time, 115200 baud) ---\n");
+    bench_throughput();
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
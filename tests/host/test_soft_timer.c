@@ -0,0 +1,387 @@
+/*
+ * test_soft_timer.c - Host tests for the backend software timer wheel
+ *
+ * Drives Timer0A_Handler as a virtual 1 ms clock and calls
+ * SoftTimer_Process() like the main loop does. Checks one-shot, periodic,
+ * cancel and re-arm-from-callback behaviour, then fires thousands of
+ * random timers and verifies each one expires exactly on its tick. Ends
+ * with a benchmark of start/cancel/expire cost per timer.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/test_soft_timer.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/MCAL/gptm.c backend/MCAL/soft_timer.c \
+ *       -o test_soft_timer
+ *   ./test_soft_timer
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MANY_TIMERS     5000
+#define MAX_DELAY_MS    3000        /* > wheel size, so timers wrap */
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+typedef struct {
+    SoftTimer_t timer;
+    uint32_t    due;            /* Expected tick of (next) expiry */
+    uint32_t    period;
+    uint32_t    fired;
+    uint32_t    late;           /* Fired on the wrong tick */
+    uint32_t    fired_at_cancel;
+} probe_t;
+
+static probe_t probes[MANY_TIMERS];
+
+/* Advance the virtual clock by one tick and run the main loop once */
+static void tick(void)
+{
+    Timer0A_Handler();
+    SoftTimer_Process();
+}
+
+static void run_ticks(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        tick();
+    }
+}
+
+static void probe_cb(void *arg)
+{
+    probe_t *p = (probe_t *)arg;
+
+    if (SoftTimer_GetTicks() != p->due)
+    {
+        p->late++;
+    }
+    p->fired++;
+    p->due += p->period;
+}
+
+static void reset_wheel(void)
+{
+    memset(probes, 0, sizeof(probes));
+    SoftTimer_Init();
+}
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_init_starts_timer0(void)
+{
+    reset_wheel();
+
+    TEST_ASSERT(FakeTimer_IsEnabled(TIMER0_BASE));
+    TEST_ASSERT_EQUAL(FAKE_SYSTEM_CLOCK / 1000 - 1, FakeTimer_Load(TIMER0_BASE));
+    TEST_ASSERT_EQUAL(0, SoftTimer_GetTicks());
+
+    TEST_PASS();
+}
+
+static TestResult test_one_shot(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_wheel();
+    p->due = 10;
+    SoftTimer_Start(&p->timer, 10, probe_cb, p);
+    TEST_ASSERT(SoftTimer_IsActive(&p->timer));
+
+    run_ticks(9);
+    TEST_ASSERT_EQUAL(0, p->fired);
+    tick();
+    TEST_ASSERT_EQUAL(1, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+    TEST_ASSERT(!SoftTimer_IsActive(&p->timer));
+
+    run_ticks(1000);
+    TEST_ASSERT_EQUAL(1, p->fired);
+
+    TEST_PASS();
+}
+
+static TestResult test_zero_delay_rounds_up(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_wheel();
+    p->due = 1;
+    SoftTimer_Start(&p->timer, 0, probe_cb, p);
+    SoftTimer_Process();
+    TEST_ASSERT_EQUAL(0, p->fired);
+    tick();
+    TEST_ASSERT_EQUAL(1, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+
+    TEST_PASS();
+}
+
+static TestResult test_cancel_and_restart(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_wheel();
+    SoftTimer_Start(&p->timer, 5, probe_cb, p);
+    run_ticks(3);
+    SoftTimer_Cancel(&p->timer);
+    TEST_ASSERT(!SoftTimer_IsActive(&p->timer));
+    run_ticks(10);
+    TEST_ASSERT_EQUAL(0, p->fired);
+
+    /* Cancel twice is harmless; restart moves the deadline */
+    SoftTimer_Cancel(&p->timer);
+    SoftTimer_Start(&p->timer, 5, probe_cb, p);
+    run_ticks(2);
+    p->due = SoftTimer_GetTicks() + 7;
+    SoftTimer_Start(&p->timer, 7, probe_cb, p);
+    run_ticks(20);
+    TEST_ASSERT_EQUAL(1, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+
+    TEST_PASS();
+}
+
+static TestResult test_periodic_no_drift(void)
+{
+    probe_t *p = &probes[0];
+
+    reset_wheel();
+    p->due = 50;
+    p->period = 50;
+    SoftTimer_StartPeriodic(&p->timer, 50, probe_cb, p);
+
+    run_ticks(50 * 100);
+    TEST_ASSERT_EQUAL(100, p->fired);
+    TEST_ASSERT_EQUAL(0, p->late);
+    TEST_ASSERT(SoftTimer_IsActive(&p->timer));
+
+    SoftTimer_Cancel(&p->timer);
+    run_ticks(200);
+    TEST_ASSERT_EQUAL(100, p->fired);
+
+    TEST_PASS();
+}
+
+static TestResult test_lagging_main_loop(void)
+{
+    probe_t *a = &probes[0];
+    probe_t *b = &probes[1];
+
+    reset_wheel();
+    SoftTimer_Start(&a->timer, 20, probe_cb, a);
+    SoftTimer_Start(&b->timer, 30, probe_cb, b);
+
+    /* ISR keeps ticking while the main loop is busy for 100 ms */
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        Timer0A_Handler();
+    }
+    SoftTimer_Process();
+
+    /* Both are caught up in a single pass, nothing lost */
+    TEST_ASSERT_EQUAL(1, a->fired);
+    TEST_ASSERT_EQUAL(1, b->fired);
+
+    TEST_PASS();
+}
+
+/* Callback that cancels a sibling due on the same tick and re-arms itself */
+static SoftTimer_t self_timer;
+static SoftTimer_t sibling_timer;
+static uint32_t self_runs = 0;
+static uint32_t sibling_runs = 0;
+
+static void sibling_cb(void *arg)
+{
+    (void)arg;
+    sibling_runs++;
+}
+
+static void self_cb(void *arg)
+{
+    (void)arg;
+    self_runs++;
+    SoftTimer_Cancel(&sibling_timer);
+    if (self_runs < 3)
+    {
+        SoftTimer_Start(&self_timer, 4, self_cb, NULL);
+    }
+}
+
+static TestResult test_callback_modifies_timers(void)
+{
+    reset_wheel();
+    self_runs = 0;
+    sibling_runs = 0;
+
+    SoftTimer_Start(&sibling_timer, 4, sibling_cb, NULL);
+    SoftTimer_Start(&self_timer, 4, self_cb, NULL);
+    run_ticks(100);
+
+    /* Sibling may run first on the shared tick; either way it runs once at
+     * most and self re-arms exactly twice */
+    TEST_ASSERT(sibling_runs <= 1);
+    TEST_ASSERT_EQUAL(3, self_runs);
+    TEST_ASSERT(!SoftTimer_IsActive(&self_timer));
+
+    TEST_PASS();
+}
+
+static TestResult test_many_random_timers(void)
+{
+    uint32_t cancelled = 0;
+    uint32_t fired = 0;
+    uint32_t late = 0;
+
+    reset_wheel();
+    srand(4321);
+
+    /* Arm timers gradually over the first second, with a mix of one-shot
+     * and periodic timers, then cancel every seventh one */
+    for (uint32_t i = 0; i < MANY_TIMERS; i++)
+    {
+        probe_t *p = &probes[i];
+        uint32_t ms = 1 + (uint32_t)(rand() % MAX_DELAY_MS);
+
+        if ((i % 50) == 0)
+        {
+            tick();
+        }
+        p->due = SoftTimer_GetTicks() + ms;
+        if ((i % 10) == 0)
+        {
+            p->period = ms;
+            SoftTimer_StartPeriodic(&p->timer, ms, probe_cb, p);
+        }
+        else
+        {
+            SoftTimer_Start(&p->timer, ms, probe_cb, p);
+        }
+    }
+    for (uint32_t i = 0; i < MANY_TIMERS; i += 7)
+    {
+        SoftTimer_Cancel(&probes[i].timer);
+        probes[i].fired_at_cancel = probes[i].fired;
+        cancelled++;
+    }
+
+    run_ticks(MAX_DELAY_MS + 200);
+
+    for (uint32_t i = 0; i < MANY_TIMERS; i++)
+    {
+        probe_t *p = &probes[i];
+        late += p->late;
+        if ((i % 7) == 0)
+        {
+            TEST_ASSERT_EQUAL(p->fired_at_cancel, p->fired);
+        }
+        else if (p->period == 0)
+        {
+            TEST_ASSERT_EQUAL(1, p->fired);
+            TEST_ASSERT(!SoftTimer_IsActive(&p->timer));
+            fired++;
+        }
+        else
+        {
+            TEST_ASSERT(p->fired >= 1);
+            fired += p->fired;
+            SoftTimer_Cancel(&p->timer);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, late);
+
+    printf("    %u timers, %u cancelled, %u expiries, 0 late\n",
+           MANY_TIMERS, cancelled, fired);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Benchmark
+ *===========================================================================*/
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench(uint32_t active)
+{
+    const uint32_t rounds = 200;
+    double t_start = 0.0, t_cancel = 0.0, t_expire = 0.0, t_idle = 0.0;
+
+    srand(99);
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        reset_wheel();
+
+        double t0 = now_sec();
+        for (uint32_t i = 0; i < active; i++)
+        {
+            SoftTimer_Start(&probes[i].timer,
+                            1 + (uint32_t)(rand() % MAX_DELAY_MS),
+                            probe_cb, &probes[i]);
+        }
+        t_start += now_sec() - t0;
+
+        /* Ticks with nothing due still pay for the slot scan */
+        t0 = now_sec();
+        tick();
+        t_idle += now_sec() - t0;
+
+        t0 = now_sec();
+        for (uint32_t i = 0; i < active; i += 2)
+        {
+            SoftTimer_Cancel(&probes[i].timer);
+        }
+        t_cancel += now_sec() - t0;
+
+        t0 = now_sec();
+        run_ticks(MAX_DELAY_MS);
+        t_expire += now_sec() - t0;
+    }
+
+    printf("    %5u active: start %5.1f ns, cancel %5.1f ns, "
+           "expire+dispatch %6.1f ns per timer, tick %6.1f ns\n",
+           active,
+           t_start * 1e9 / (rounds * active),
+           t_cancel * 1e9 / (rounds * ((active + 1) / 2)),
+           t_expire * 1e9 / (rounds * (active / 2)),
+           t_idle * 1e9 / rounds);
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- Soft Timer Wheel Tests ---\n");
+    run_test("Init Starts Timer0", test_init_starts_timer0);
+    run_test("One Shot", test_one_shot);
+    run_test("Zero Delay Rounds Up", test_zero_delay_rounds_up);
+    run_test("Cancel And Restart", test_cancel_and_restart);
+    run_test("Periodic No Drift", test_periodic_no_drift);
+    run_test("Lagging Main Loop", test_lagging_main_loop);
+    run_test("Callback Modifies Timers", test_callback_modifies_timers);
+    run_test("Many Random Timers", test_many_random_timers);
+
+    printf("\n--- Soft Timer Cost (wheel %u slots, host ns) ---\n",
+           SOFT_TIMER_WHEEL_SIZE);
+    bench(100);
+    bench(1000);
+    bench(MANY_TIMERS);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+/*
+ * test_uart_rx_queue.c - Host tests for the backend UART1 RX frame queue
+ *
+ * Feeds UART1IntHandler from a fake 16-byte RX FIFO and checks that bursts
+ * of frames are queued instead of dropped. Ends with a stress run that
+ * reports frames/sec and drop rate for several main-loop service rates.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/test_uart_rx_queue.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/MCAL/uart.c backend/MCAL/gptm.c \
+ *       backend/MCAL/soft_timer.c -o test_uart_rx_queue
+ *   ./test_uart_rx_queue
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "../../backend/MCAL/uart.h"
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SOF_REQUEST     0x7E
+#define RX_TRIGGER      2       /* UART_FIFO_RX1_8 of a 16-byte FIFO */
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+/* Push one byte onto the fake line, firing the ISR at the FIFO trigger */
+static void line_byte(uint8_t b)
+{
+    FakeUART_RxPush(b);
+    if (FakeUART_RxLevel() >= RX_TRIGGER)
+    {
+        FakeUART_RaiseRxInterrupt();
+    }
+}
+
+/* Send a frame [SOF][LEN][body...]; line goes idle afterwards (RT int) */
+static void line_frame(const uint8_t *body, uint8_t len)
+{
+    line_byte(SOF_REQUEST);
+    line_byte(len);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        line_byte(body[i]);
+    }
+}
+
+static void line_idle(void)
+{
+    FakeUART_RaiseRxInterrupt();
+}
+
+static void reset_driver(void)
+{
+    FakeUART_Reset();
+    UART_Driver_Init();
+}
+
+/*===========================================================================
+ * Test: single frame round trip
+ *===========================================================================*/
+static TestResult test_single_frame(void)
+{
+    uint8_t body[] = {0x02, 0x01, '1', '2', '3', '4', '5'};
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+
+    reset_driver();
+    TEST_ASSERT(!UART_Driver_IsPacketReady());
+
+    line_frame(body, sizeof(body));
+    line_idle();
+
+    TEST_ASSERT(UART_Driver_IsPacketReady());
+    TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(sizeof(body), len);
+    TEST_ASSERT(memcmp(body, buf, len) == 0);
+    TEST_ASSERT(!UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(0, len);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Test: a burst up to queue capacity is kept in order
+ *===========================================================================*/
+static TestResult test_burst_queued_in_order(void)
+{
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len;
+    UART_RxStats_t stats;
+
+    reset_driver();
+
+    for (uint8_t i = 0; i < UART_RX_QUEUE_DEPTH - 1; i++)
+    {
+        uint8_t body[2] = {0x05, i};
+        line_frame(body, sizeof(body));
+    }
+    line_idle();
+
+    for (uint8_t i = 0; i < UART_RX_QUEUE_DEPTH - 1; i++)
+    {
+        TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+        TEST_ASSERT_EQUAL(2, len);
+        TEST_ASSERT_EQUAL(i, buf[1]);
+    }
+    TEST_ASSERT(!UART_Driver_IsPacketReady());
+
+    UART_Driver_GetStats(&stats);
+    TEST_ASSERT_EQUAL(UART_RX_QUEUE_DEPTH - 1, stats.frames_received);
+    TEST_ASSERT_EQUAL(0, stats.frames_dropped);
+    TEST_ASSERT_EQUAL(UART_RX_QUEUE_DEPTH - 1, stats.queue_high_water);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Test: overflow drops newest frames and counts them
+ *===========================================================================*/
+static TestResult test_overflow_counted(void)
+{
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len;
+    UART_RxStats_t stats;
+
+    reset_driver();
+
+    for (uint8_t i = 0; i < UART_RX_QUEUE_DEPTH + 2; i++)
+    {
+        uint8_t body[1] = {i};
+        line_frame(body, sizeof(body));
+    }
+    line_idle();
+
+    UART_Driver_GetStats(&stats);
+    TEST_ASSERT_EQUAL(UART_RX_QUEUE_DEPTH - 1, stats.frames_received);
+    TEST_ASSERT_EQUAL(3, stats.frames_dropped);
+
+    /* Oldest frames survive intact */
+    TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(0, buf[0]);
+
+    /* Freed slot is usable again */
+    uint8_t body[1] = {0xAA};
+    line_frame(body, sizeof(body));
+    line_idle();
+    for (uint8_t i = 1; i < UART_RX_QUEUE_DEPTH - 1; i++)
+    {
+        TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+        TEST_ASSERT_EQUAL(i, buf[0]);
+    }
+    TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(0xAA, buf[0]);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Test: FIFO overrun is counted and the parser resynchronises
+ *===========================================================================*/
+static TestResult test_line_error_resync(void)
+{
+    uint8_t body[3] = {0x03, 0x0A, 0x0B};
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len;
+    UART_RxStats_t stats;
+
+    reset_driver();
+
+    /* Overrun the FIFO without servicing it */
+    for (uint8_t i = 0; i < FAKE_UART_FIFO_SIZE + 4; i++)
+    {
+        FakeUART_RxPush(0x55);
+    }
+    line_idle();
+
+    line_frame(body, sizeof(body));
+    line_idle();
+
+    UART_Driver_GetStats(&stats);
+    TEST_ASSERT_EQUAL(1, stats.line_errors);
+    TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(3, len);
+    TEST_ASSERT(memcmp(body, buf, len) == 0);
+
+    TEST_PASS();
+}
+
+/*===========================================================================
+ * Stress: random frames, consumer serviced every N frames
+ *===========================================================================*/
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void stress_run(uint32_t frames, uint32_t service_every)
+{
+    uint8_t body[UART_MAX_LEN];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len;
+    uint32_t consumed = 0;
+    uint32_t corrupt = 0;
+    UART_RxStats_t stats;
+
+    reset_driver();
+    srand(1234);
+
+    double t0 = now_sec();
+    for (uint32_t f = 0; f < frames; f++)
+    {
+        uint8_t n = (uint8_t)(1 + rand() % UART_MAX_LEN);
+        body[0] = (uint8_t)(f & 0xFF);
+        for (uint8_t i = 1; i < n; i++)
+        {
+            body[i] = (uint8_t)(body[0] + i);
+        }
+        line_frame(body, n);
+        line_idle();
+
+        if ((f % service_every) == service_every - 1)
+        {
+            while (UART_Driver_GetPacket(buf, &len))
+            {
+                for (uint8_t i = 1; i < len; i++)
+                {
+                    if (buf[i] != (uint8_t)(buf[0] + i)) { corrupt++; break; }
+                }
+                consumed++;
+            }
+        }
+    }
+    while (UART_Driver_GetPacket(buf, &len)) { consumed++; }
+    double dt = now_sec() - t0;
+
+    UART_Driver_GetStats(&stats);
+    printf("    service every %2u frames: %8.0f frames/s, received %u, "
+           "dropped %u (%.2f%%), corrupt %u, high water %u\n",
+           service_every, frames / dt, stats.frames_received,
+           stats.frames_dropped, 100.0 * stats.frames_dropped / frames,
+           corrupt, stats.queue_high_water);
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- UART RX Queue Tests ---\n");
+    run_test("Single Frame", test_single_frame);
+    run_test("Burst Queued In Order", test_burst_queued_in_order);
+    run_test("Overflow Counted", test_overflow_counted);
+    run_test("Line Error Resync", test_line_error_resync);
+
+    printf("\n--- UART RX Queue Stress (depth %u) ---\n", UART_RX_QUEUE_DEPTH);
+    stress_run(1000000, 1);
+    stress_run(1000000, 4);
+    stress_run(1000000, 7);
+    stress_run(1000000, 8);
+    stress_run(1000000, 16);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+/*
+ * test_uart_rx_timeout.c - Host tests for the backend UART1 inter-byte
+ * timeout
+ *
+ * Injects frames cut short at every possible byte, lets the line go quiet
+ * by ticking the soft timer clock (Timer0A_Handler), and checks that the
+ * next valid frame is accepted at once and the abort is counted. Also
+ * checks that short pauses inside a frame and idle time between frames
+ * abort nothing.
+ *
+ * Build & run (from repo root):
+ *   gcc -std=c99 -O2 -I tests/host -I tests/host/tivaware \
+ *       tests/host/test_uart_rx_timeout.c tests/host/fake_tivaware.c \
+ *       tests/test_common.c backend/MCAL/uart.c backend/MCAL/soft_timer.c \
+ *       backend/MCAL/gptm.c -o test_uart_rx_timeout
+ *   ./test_uart_rx_timeout
+ *
+ * Add -DUART_FRAMING_COBS=1 to run the same checks over COBS framing.
+ */
+
+#include "../test_common.h"
+#include "fake_tivaware.h"
+#include "../../backend/MCAL/uart.h"
+#include "../../backend/MCAL/soft_timer.h"
+#include <string.h>
+
+#define SOF_REQUEST     0x7E
+#define RX_TRIGGER      2       /* UART_FIFO_RX1_8 of a 16-byte FIFO */
+
+/*===========================================================================
+ * Helpers
+ *===========================================================================*/
+
+/* Encode one request in the configured wire framing */
+static uint8_t encode(const uint8_t *body, uint8_t len, uint8_t *out)
+{
+    uint8_t n = 0;
+
+#if UART_FRAMING_COBS
+    uint8_t code_at = n++;
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (body[i] == 0x00)
+        {
+            out[code_at] = (uint8_t)(n - code_at);
+            code_at = n++;
+        }
+        else
+        {
+            out[n++] = body[i];
+        }
+    }
+    out[code_at] = (uint8_t)(n - code_at);
+    out[n++] = 0x00;
+#else
+    out[n++] = SOF_REQUEST;
+    out[n++] = len;
+    memcpy(&out[n], body, len);
+    n += len;
+#endif
+    return n;
+}
+
+/* Push bytes onto the fake line; the RT interrupt flushes the FIFO tail */
+static void line_bytes(const uint8_t *data, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+    {
+        FakeUART_RxPush(data[i]);
+        if (FakeUART_RxLevel() >= RX_TRIGGER)
+        {
+            FakeUART_RaiseRxInterrupt();
+        }
+    }
+    FakeUART_RaiseRxInterrupt();
+}
+
+/* Let the line stay silent for some 1 ms ticks */
+static void line_quiet(uint32_t ticks)
+{
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        Timer0A_Handler();
+    }
+}
+
+static void reset_driver(void)
+{
+    FakeUART_Reset();
+    SoftTimer_Init();
+    UART_Driver_Init();
+    UART_Driver_ResetStats();
+}
+
+static uint32_t aborted(void)
+{
+    UART_RxStats_t stats;
+    UART_Driver_GetStats(&stats);
+    return stats.frames_aborted;
+}
+
+/* Test bodies contain a 0x7E and a 0x00 so both framings have work to do */
+static const uint8_t body_a[] = {0xA5, 0x01, 0x03, 0x7E, 0x00, 0x42, 0x99};
+static const uint8_t body_b[] = {0xA5, 0x02, 0x05, 0x00, 0x7E, 0x10};
+
+/*===========================================================================
+ * Tests
+ *===========================================================================*/
+static TestResult test_truncated_then_valid(void)
+{
+    uint8_t wire_a[32], wire_b[32];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+    uint8_t na = encode(body_a, sizeof(body_a), wire_a);
+    uint8_t nb = encode(body_b, sizeof(body_b), wire_b);
+
+    /* Cut frame A after every possible byte count */
+    for (uint8_t cut = 1; cut < na; cut++)
+    {
+        reset_driver();
+
+        line_bytes(wire_a, cut);
+        line_quiet(UART_RX_GAP_TICKS);
+        line_bytes(wire_b, nb);
+
+        TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+        TEST_ASSERT_EQUAL(sizeof(body_b), len);
+        TEST_ASSERT_EQUAL(0, memcmp(body_b, buf, len));
+        TEST_ASSERT(!UART_Driver_IsPacketReady());
+        /* Even a lone SOF or COBS code byte is a frame in progress */
+        TEST_ASSERT_EQUAL(1, aborted());
+    }
+
+    TEST_PASS();
+}
+
+static TestResult test_without_gap_next_frame_is_lost(void)
+{
+    uint8_t wire_a[32], wire_b[32];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+    uint8_t na = encode(body_a, sizeof(body_a), wire_a);
+    uint8_t nb = encode(body_b, sizeof(body_b), wire_b);
+    uint32_t good = 0;
+
+    /* The same glitch with no pause: nothing to time out, so the next
+     * frame is damaged too. This is what the timeout is for. */
+    reset_driver();
+    line_bytes(wire_a, (uint8_t)(na - 3));
+    line_bytes(wire_b, nb);
+    while (UART_Driver_GetPacket(buf, &len))
+    {
+        if (len == sizeof(body_b) && memcmp(body_b, buf, len) == 0)
+        {
+            good++;
+        }
+    }
+    TEST_ASSERT_EQUAL(0, good);
+    TEST_ASSERT_EQUAL(0, aborted());
+
+    TEST_PASS();
+}
+
+static TestResult test_short_pause_inside_frame(void)
+{
+    uint8_t wire[32];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+    uint8_t n = encode(body_a, sizeof(body_a), wire);
+
+    reset_driver();
+
+    /* One tick between bytes is below the gap threshold */
+    for (uint8_t i = 0; i < n; i++)
+    {
+        line_bytes(&wire[i], 1);
+        line_quiet(UART_RX_GAP_TICKS - 1);
+    }
+
+    TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+    TEST_ASSERT_EQUAL(sizeof(body_a), len);
+    TEST_ASSERT_EQUAL(0, memcmp(body_a, buf, len));
+    TEST_ASSERT_EQUAL(0, aborted());
+
+    TEST_PASS();
+}
+
+static TestResult test_idle_between_frames(void)
+{
+    uint8_t wire[32];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+    uint8_t n = encode(body_a, sizeof(body_a), wire);
+
+    reset_driver();
+
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        line_quiet(1 + i * 37);
+        line_bytes(wire, n);
+        TEST_ASSERT(UART_Driver_GetPacket(buf, &len));
+        TEST_ASSERT_EQUAL(sizeof(body_a), len);
+    }
+    TEST_ASSERT_EQUAL(0, aborted());
+
+    TEST_PASS();
+}
+
+static TestResult test_repeated_glitches(void)
+{
+    uint8_t wire_a[32], wire_b[32];
+    uint8_t buf[UART_MAX_LEN];
+    uint8_t len = 0;
+    uint8_t na = encode(body_a, sizeof(body_a), wire_a);
+    uint8_t nb = encode(body_b, sizeof(body_b), wire_b);
+    uint32_t good = 0;
+
+    reset_driver();
+
+    /* Every other frame is cut short; every complete one must survive */
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        line_bytes(wire_a, (uint8_t)(2 + i % (na - 3)));
+        line_quiet(UART_RX_GAP_TICKS + i % 3);
+        line_bytes(wire_b, nb);
+        line_quiet(1);
+        while (UART_Driver_GetPacket(buf, &len))
+        {
+            if (len == sizeof(body_b) && memcmp(body_b, buf, len) == 0)
+            {
+                good++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(100, good);
+    TEST_ASSERT_EQUAL(100, aborted());
+
+    TEST_PASS();
+}
+
+int main(void)
+{
+    test_init();
+
+    printf("\n--- UART RX Inter-byte Timeout Tests ---\n");
+    run_test("Truncated Then Valid", test_truncated_then_valid);
+    run_test("Without Gap Next Frame Is Lost", test_without_gap_next_frame_is_lost);
+    run_test("Short Pause Inside Frame", test_short_pause_inside_frame);
+    run_test("Idle Between Frames", test_idle_between_frames);
+    run_test("Repeated Glitches", test_repeated_glitches);
+
+    print_test_summary();
+    return get_tests_failed() == 0 ? 0 : 1;
+}
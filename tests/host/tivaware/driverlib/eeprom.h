@@ -0,0 +1,2 @@
+/* Host stub - see tests/host/fake_tivaware.h */
+#include "fake_tivaware.h"